@@ -0,0 +1,156 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: Argon2Benchmarks.cs 
+*
+* Argon2Benchmarks.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System.Runtime.InteropServices;
+
+using VNLib.Utils.Memory;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Benchmarks
+{
+    /// <summary>
+    /// Sweeps Argon2id cost parameters across the reference argon2 library and 
+    /// the monocypher implementation, with and without a work area pool
+    /// </summary>
+    internal static class Argon2Benchmarks
+    {
+        public const string Suite = "argon2";
+
+        /*
+         * Argon2 cases take tens to hundreds of milliseconds per hash so they
+         * are capped to a handful of samples to keep the run time reasonable
+         */
+        const int MaxSamples = 5;
+
+        private static readonly (uint t, uint m, uint p)[] FullCosts =
+        [
+            (1, 19456, 1),     //OWASP minimum
+            (2, 19456, 1),
+            (2, 65535, 1),
+            (2, 65535, 4),     //Library default
+            (3, 65536, 4),
+            (1, 262144, 4),
+        ];
+
+        private static readonly (uint t, uint m, uint p)[] QuickCosts =
+        [
+            (1, 19456, 1),
+            (2, 65535, 4),
+        ];
+
+        public static void Run(BenchmarkRunner runner, bool quick)
+        {
+            List<(string name, IArgon2Library lib)> backends = [];
+            List<IDisposable> owned = [];
+
+            string? refPath = Environment.GetEnvironmentVariable(VnArgon2.ARGON2_LIB_ENVIRONMENT_VAR_NAME);
+
+            if (!string.IsNullOrWhiteSpace(refPath))
+            {
+                SafeArgon2Library refLib = VnArgon2.LoadCustomLibrary(refPath, DllImportSearchPath.SafeDirectories);
+                owned.Add(refLib);
+                backends.Add(("ref-argon2", refLib));
+            }
+            else
+            {
+                Console.WriteLine("{0} is not set, skipping reference argon2 cases", VnArgon2.ARGON2_LIB_ENVIRONMENT_VAR_NAME);
+            }
+
+            if (MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Argon2WorkAreaPool pool = new(512 * 1024 * 1024, useHugePages: true);
+                owned.Add(pool);
+
+                backends.Add(("mc-argon2-heap", MonoCypherLibrary.Shared.Argon2CreateLibrary(MemoryUtil.Shared)));
+                backends.Add(("mc-argon2-pool", MonoCypherLibrary.Shared.Argon2CreateLibrary(pool)));
+            }
+            else
+            {
+                Console.WriteLine("{0} is not set, skipping monocypher argon2 cases", MonoCypherLibrary.MONOCYPHER_LIB_ENVIRONMENT_VAR_NAME);
+            }
+
+            byte[] password = RandomHash.GetRandomBytes(24);
+            byte[] salt = RandomHash.GetRandomBytes(16);
+            byte[] hash = new byte[32];
+
+            try
+            {
+                foreach ((uint t, uint m, uint p) in quick ? QuickCosts : FullCosts)
+                {
+                    string param = $"t{t}-m{m}-p{p}";
+
+                    foreach ((string name, IArgon2Library lib) in backends)
+                    {
+                        runner.Run(
+                            Suite, 
+                            name, 
+                            param, 
+                            0, 
+                            () =>
+                            {
+                                Argon2CostParams costParams = new() { TimeCost = t, MemoryCost = m, Parallelism = p };
+                                lib.Hash2id(password, salt, default, hash, in costParams);
+                            },
+                            MaxSamples
+                        );
+                    }
+                }
+            }
+            finally
+            {
+                owned.ForEach(static o => o.Dispose());
+            }
+        }
+
+        /// <summary>
+        /// Calibrates cost parameters with the shared <see cref="VnArgon2"/> library and prints the configuration block
+        /// </summary>
+        /// <param name="options">The calibration target and search bounds</param>
+        public static void Calibrate(Argon2CalibrationOptions options)
+        {
+            Console.WriteLine(
+                "Calibrating for p95 <= {0:N0}ms at concurrency {1} within {2:N0}MB, this may take a while...",
+                options.TargetLatency.TotalMilliseconds, 
+                options.Concurrency, 
+                options.MaxMemoryBytes / (1024 * 1024)
+            );
+
+            Argon2CalibrationResult result = VnArgon2.GetOrLoadSharedLib().Calibrate2id(options);
+
+            Console.WriteLine(
+                "t={0} m={1}KiB p={2}: p95 {3:N1}ms, median {4:N1}ms, peak memory {5:N0}MB{6}",
+                result.TimeCost,
+                result.MemoryCost,
+                result.Parallelism,
+                result.P95Latency.TotalMilliseconds,
+                result.MedianLatency.TotalMilliseconds,
+                result.PeakMemoryBytes / (1024 * 1024),
+                result.TargetMet ? string.Empty : " (target NOT met, cheapest parameters shown)"
+            );
+
+            Console.WriteLine();
+            Console.WriteLine(result.ToConfigBlock());
+        }
+    }
+}
@@ -0,0 +1,120 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: BenchmarkBaseline.cs 
+*
+* BenchmarkBaseline.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+namespace VNLib.Hashing.Benchmarks
+{
+    /// <summary>
+    /// Reads and writes benchmark csv files and compares a run against a 
+    /// previously recorded regression baseline
+    /// </summary>
+    internal static class BenchmarkBaseline
+    {
+        /// <summary>
+        /// Writes the results to a csv file, overwriting the file if it exists
+        /// </summary>
+        /// <param name="path">The path of the csv file</param>
+        /// <param name="results">The results to write</param>
+        public static void WriteCsv(string path, IEnumerable<BenchmarkResult> results)
+        {
+            using StreamWriter writer = new(path, append: false);
+
+            writer.WriteLine(BenchmarkResult.CsvHeader);
+
+            foreach (BenchmarkResult result in results)
+            {
+                writer.WriteLine(result.ToCsv());
+            }
+        }
+
+        /// <summary>
+        /// Reads results from a csv file written by <see cref="WriteCsv"/>
+        /// </summary>
+        /// <param name="path">The path of the csv file</param>
+        /// <returns>The results keyed by <see cref="BenchmarkResult.Key"/></returns>
+        /// <exception cref="FormatException"></exception>
+        public static Dictionary<string, BenchmarkResult> ReadCsv(string path)
+        {
+            Dictionary<string, BenchmarkResult> results = new(StringComparer.Ordinal);
+
+            foreach (string line in File.ReadLines(path).Skip(1))
+            {
+                if (string.IsNullOrWhiteSpace(line))
+                {
+                    continue;
+                }
+
+                BenchmarkResult result = BenchmarkResult.FromCsv(line);
+                results[result.Key] = result;
+            }
+
+            return results;
+        }
+
+        /// <summary>
+        /// Compares the current results against the baseline and prints every case
+        /// that is slower than the baseline by more than the tolerance
+        /// </summary>
+        /// <param name="baseline">The baseline results</param>
+        /// <param name="current">The results of the current run</param>
+        /// <param name="tolerance">The allowed relative slowdown, 0.1 allows 10%</param>
+        /// <returns>The number of regressed cases</returns>
+        public static int Compare(IReadOnlyDictionary<string, BenchmarkResult> baseline, IEnumerable<BenchmarkResult> current, double tolerance)
+        {
+            int regressions = 0;
+
+            Console.WriteLine();
+            Console.WriteLine("Comparing against baseline, tolerance {0:P0}", tolerance);
+
+            foreach (BenchmarkResult result in current)
+            {
+                //New cases have nothing to compare against
+                if (!baseline.TryGetValue(result.Key, out BenchmarkResult? previous) || previous.NsPerOp <= 0)
+                {
+                    continue;
+                }
+
+                double ratio = result.NsPerOp / previous.NsPerOp;
+
+                if (ratio > 1 + tolerance)
+                {
+                    regressions++;
+                    Console.WriteLine(
+                        "REGRESSION {0,-70} {1,14:N1} -> {2,14:N1} ns/op ({3:+0.0%})",
+                        result.Key, previous.NsPerOp, result.NsPerOp, ratio - 1
+                    );
+                }
+                else if (ratio < 1 - tolerance)
+                {
+                    Console.WriteLine(
+                        "improved   {0,-70} {1,14:N1} -> {2,14:N1} ns/op ({3:+0.0%;-0.0%})",
+                        result.Key, previous.NsPerOp, result.NsPerOp, ratio - 1
+                    );
+                }
+            }
+
+            Console.WriteLine("{0} regression(s) found", regressions);
+            return regressions;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: BenchmarkResult.cs 
+*
+* BenchmarkResult.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System.Globalization;
+
+namespace VNLib.Hashing.Benchmarks
+{
+    /// <summary>
+    /// A single measured benchmark case
+    /// </summary>
+    /// <param name="Suite">The suite the case belongs to, hash, argon2 or jwt</param>
+    /// <param name="Name">The operation and backend that was measured</param>
+    /// <param name="Parameter">The swept parameter, a message size or cost parameters</param>
+    /// <param name="NsPerOp">The median time of a single operation in nanoseconds</param>
+    /// <param name="MbPerSecond">The throughput in MiB/s, or 0 when the case has no message size</param>
+    /// <param name="AllocatedPerOp">The number of managed bytes allocated per operation</param>
+    internal sealed record class BenchmarkResult(
+        string Suite, 
+        string Name, 
+        string Parameter, 
+        double NsPerOp, 
+        double MbPerSecond, 
+        long AllocatedPerOp
+    )
+    {
+        public const string CsvHeader = "suite,name,parameter,ns_per_op,mb_per_sec,allocated_per_op";
+
+        /// <summary>
+        /// The key used to match the case against a baseline
+        /// </summary>
+        public string Key => $"{Suite}/{Name}/{Parameter}";
+
+        public string ToCsv() => string.Join(',',
+            Suite, 
+            Name, 
+            Parameter,
+            NsPerOp.ToString("F1", CultureInfo.InvariantCulture),
+            MbPerSecond.ToString("F2", CultureInfo.InvariantCulture),
+            AllocatedPerOp.ToString(CultureInfo.InvariantCulture)
+        );
+
+        /// <summary>
+        /// Parses a result from a csv line written by <see cref="ToCsv"/>
+        /// </summary>
+        /// <param name="line">The csv line to parse</param>
+        /// <returns>The parsed result</returns>
+        /// <exception cref="FormatException"></exception>
+        public static BenchmarkResult FromCsv(string line)
+        {
+            string[] cols = line.Split(',');
+
+            if (cols.Length != 6)
+            {
+                throw new FormatException($"Expected 6 columns in benchmark csv line '{line}'");
+            }
+
+            return new(
+                cols[0],
+                cols[1],
+                cols[2],
+                double.Parse(cols[3], CultureInfo.InvariantCulture),
+                double.Parse(cols[4], CultureInfo.InvariantCulture),
+                long.Parse(cols[5], CultureInfo.InvariantCulture)
+            );
+        }
+    }
+}
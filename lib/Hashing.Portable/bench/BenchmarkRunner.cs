@@ -0,0 +1,134 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: BenchmarkRunner.cs 
+*
+* BenchmarkRunner.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System.Diagnostics;
+
+namespace VNLib.Hashing.Benchmarks
+{
+    /// <summary>
+    /// Options that control how long every benchmark case is measured
+    /// </summary>
+    /// <param name="SampleTime">The target wall time of a single sample</param>
+    /// <param name="Samples">The number of samples to take, the median is reported</param>
+    /// <param name="Filter">An optional case-insensitive substring a case key must contain to run</param>
+    internal sealed record class BenchmarkOptions(TimeSpan SampleTime, int Samples, string? Filter);
+
+    /// <summary>
+    /// A minimal stopwatch based benchmark runner. Every case is warmed up and calibrated
+    /// so a single sample runs for roughly <see cref="BenchmarkOptions.SampleTime"/>, then
+    /// the median time per operation of all samples is reported.
+    /// </summary>
+    internal sealed class BenchmarkRunner(BenchmarkOptions options)
+    {
+        private readonly List<BenchmarkResult> _results = [];
+
+        /// <summary>
+        /// The results of all cases that have been run
+        /// </summary>
+        public IReadOnlyList<BenchmarkResult> Results => _results;
+
+        /// <summary>
+        /// Measures a single benchmark case
+        /// </summary>
+        /// <param name="suite">The suite name</param>
+        /// <param name="name">The operation and backend name</param>
+        /// <param name="parameter">The swept parameter value</param>
+        /// <param name="bytesPerOp">The number of message bytes processed per operation, 0 to skip throughput</param>
+        /// <param name="operation">The operation to measure</param>
+        /// <param name="maxSamples">An optional upper bound on the number of samples for very slow cases</param>
+        public void Run(string suite, string name, string parameter, long bytesPerOp, Action operation, int maxSamples = int.MaxValue)
+        {
+            string key = $"{suite}/{name}/{parameter}";
+
+            if (options.Filter != null && !key.Contains(options.Filter, StringComparison.OrdinalIgnoreCase))
+            {
+                return;
+            }
+
+            long iterations = Calibrate(operation);
+            int samples = Math.Min(options.Samples, maxSamples);
+            double[] nsPerOp = new double[samples];
+
+            long allocStart = GC.GetAllocatedBytesForCurrentThread();
+
+            for (int s = 0; s < samples; s++)
+            {
+                long start = Stopwatch.GetTimestamp();
+
+                for (long i = 0; i < iterations; i++)
+                {
+                    operation();
+                }
+
+                TimeSpan elapsed = Stopwatch.GetElapsedTime(start);
+                nsPerOp[s] = elapsed.TotalNanoseconds / iterations;
+            }
+
+            long allocated = (GC.GetAllocatedBytesForCurrentThread() - allocStart) / (iterations * samples);
+
+            Array.Sort(nsPerOp);
+            double median = nsPerOp[samples / 2];
+            double mbps = bytesPerOp > 0 ? bytesPerOp / (median / 1e9) / (1024 * 1024) : 0;
+
+            BenchmarkResult result = new(suite, name, parameter, median, mbps, allocated);
+            _results.Add(result);
+
+            Console.WriteLine(
+                "{0,-8} {1,-34} {2,-22} {3,14:N1} ns/op {4,10:N2} MiB/s {5,8} B/op",
+                suite, name, parameter, median, mbps, allocated
+            );
+        }
+
+        /*
+         * Runs the operation with a doubling iteration count until a batch takes
+         * at least a quarter of the sample time. This also serves as the warmup
+         * so the measured code has been tiered up before sampling begins.
+         */
+        private long Calibrate(Action operation)
+        {
+            long sampleTicks = (long)(options.SampleTime.TotalSeconds * Stopwatch.Frequency);
+            long iterations = 1;
+
+            while (true)
+            {
+                long start = Stopwatch.GetTimestamp();
+
+                for (long i = 0; i < iterations; i++)
+                {
+                    operation();
+                }
+
+                long elapsed = Stopwatch.GetTimestamp() - start;
+
+                if (elapsed >= sampleTicks / 4)
+                {
+                    //Scale the batch so a sample runs for about the sample time
+                    return Math.Max(1, iterations * sampleTicks / Math.Max(1, elapsed));
+                }
+
+                iterations *= 2;
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: HashingBenchmarks.cs 
+*
+* HashingBenchmarks.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System.Security.Cryptography;
+
+using VNLib.Hashing.Checksums;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Benchmarks
+{
+    /// <summary>
+    /// Sweeps message sizes across the managed hash algorithms, the checksum
+    /// functions and the native monocypher blake2b and blake3 implementations
+    /// </summary>
+    internal static class HashingBenchmarks
+    {
+        public const string Suite = "hash";
+
+        /// <summary>
+        /// The number of messages hashed per call in the batch cases
+        /// </summary>
+        const int BatchCount = 64;
+
+        private static readonly int[] FullSizes = [16, 64, 256, 1024, 4096, 16384, 65536, 1024 * 1024];
+        private static readonly int[] QuickSizes = [64, 1024, 65536];
+
+        private static readonly HashAlg[] ManagedAlgs = [HashAlg.SHA256, HashAlg.SHA512, HashAlg.BlAKE2B, HashAlg.BLAKE3];
+
+        public static void Run(BenchmarkRunner runner, bool quick)
+        {
+            int[] sizes = quick ? QuickSizes : FullSizes;
+
+            byte[] key = RandomHash.GetRandomBytes(32);
+            byte[] output = new byte[64];
+
+            MonoCypherLibrary? mc = MonoCypherLibrary.CanLoadDefaultLibrary() ? MonoCypherLibrary.Shared : null;
+
+            if (mc == null)
+            {
+                Console.WriteLine("{0} is not set, skipping native monocypher hash cases", MonoCypherLibrary.MONOCYPHER_LIB_ENVIRONMENT_VAR_NAME);
+            }
+
+            foreach (int size in sizes)
+            {
+                byte[] data = RandomHash.GetRandomBytes(size);
+                string param = $"{size}B";
+
+                foreach (HashAlg alg in ManagedAlgs)
+                {
+                    if (!ManagedHash.IsAlgSupported(alg))
+                    {
+                        continue;
+                    }
+
+                    runner.Run(Suite, $"managed-{alg}", param, size, () => ManagedHash.ComputeHash(data, output, alg));
+                    runner.Run(Suite, $"managed-hmac-{alg}", param, size, () => ManagedHash.ComputeHmac(key, data, output, alg));
+                }
+
+                //Non-cryptographic checksums
+                runner.Run(Suite, "managed-fnv1a64", param, size, () => FNV1a.Compute64(data));
+                runner.Run(Suite, "managed-xxh3-64", param, size, () => XxHash3.Compute64(data));
+                runner.Run(Suite, "managed-xxh3-128", param, size, () => XxHash3.Compute128(data));
+
+                if (mc == null)
+                {
+                    continue;
+                }
+
+                runner.Run(Suite, "mc-blake2b", param, size, () => mc.Blake2ComputeHash(data, output));
+                runner.Run(Suite, "mc-blake2b-hmac", param, size, () => mc.Blake2ComputeHmac(key, data, output));
+                runner.Run(Suite, "mc-blake3", param, size, () => mc.Blake3ComputeHash(data, output.AsSpan(0, MCBlake3Module.DefaultHashSize)));
+
+                if (size >= 128 * 1024)
+                {
+                    runner.Run(
+                        Suite, 
+                        "mc-blake3-parallel", 
+                        param, 
+                        size, 
+                        () => mc.Blake3ComputeHashParallel(data, output.AsSpan(0, MCBlake3Module.DefaultHashSize), Environment.ProcessorCount)
+                    );
+                }
+
+                RunBatch(runner, mc, size, param);
+            }
+
+            RunRandom(runner);
+        }
+
+        /*
+         * Token sized random requests, the system generator against the 
+         * per-thread ChaCha20 generator used by RandomHash
+         */
+        private static void RunRandom(BenchmarkRunner runner)
+        {
+            byte[] buffer = new byte[32];
+            char[] chars = new char[64];
+
+            runner.Run(Suite, "os-random", "32B", buffer.Length, () => RandomNumberGenerator.Fill(buffer));
+            runner.Run(Suite, "drbg-random", "32B", buffer.Length, () => RandomHash.GetRandomBytes(buffer.AsSpan()));
+            runner.Run(Suite, "drbg-random-base64", "32B", buffer.Length, () => RandomHash.GetRandomBase64(chars, buffer.Length));
+            runner.Run(Suite, "drbg-random-base64-string", "32B", buffer.Length, () => RandomHash.GetRandomBase64(buffer.Length));
+        }
+
+        private static void RunBatch(BenchmarkRunner runner, MonoCypherLibrary mc, int size, string param)
+        {
+            //Large messages gain nothing from batching and only waste memory
+            if (size > 65536)
+            {
+                return;
+            }
+
+            byte[] messages = RandomHash.GetRandomBytes(size * BatchCount);
+            byte[] hashes = new byte[MCBlake2Module.MinSuggestedKDFHashSize * BatchCount];
+            int[] sizes = Enumerable.Repeat(size, BatchCount).ToArray();
+
+            runner.Run(
+                Suite, 
+                $"mc-blake2b-batch{BatchCount}", 
+                param, 
+                (long)size * BatchCount, 
+                () => mc.Blake2ComputeHashBatch(messages, sizes, hashes, MCBlake2Module.MinSuggestedKDFHashSize)
+            );
+
+            //Single-shot baseline over the same packed buffer for a direct comparison
+            runner.Run(
+                Suite, 
+                $"mc-blake2b-loop{BatchCount}", 
+                param, 
+                (long)size * BatchCount, 
+                () =>
+                {
+                    for (int i = 0; i < BatchCount; i++)
+                    {
+                        mc.Blake2ComputeHash(
+                            messages.AsSpan(i * size, size), 
+                            hashes.AsSpan(i * MCBlake2Module.MinSuggestedKDFHashSize, MCBlake2Module.MinSuggestedKDFHashSize)
+                        );
+                    }
+                }
+            );
+        }
+    }
+}
@@ -0,0 +1,203 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: JwtBenchmarks.cs 
+*
+* JwtBenchmarks.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System.Text;
+using System.Collections.Frozen;
+using System.Security.Cryptography;
+
+using VNLib.Utils;
+
+using VNLib.Hashing.IdentityUtility;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Benchmarks
+{
+    /// <summary>
+    /// Measures signing and verifying a typical JWT with every commonly used JWS algorithm, 
+    /// and verifying from a Json Web Key with and without the <see cref="JwkSignatureCache"/>
+    /// </summary>
+    internal static class JwtBenchmarks
+    {
+        public const string Suite = "jwt";
+
+        const string Payload = "{\"sub\":\"3f2b1c9a-6d1e-4f7a-9c2b-1a2b3c4d5e6f\",\"iss\":\"https://auth.example.com\",\"aud\":\"api\",\"iat\":1700000000,\"exp\":1700003600,\"scope\":\"openid profile email\"}";
+
+        public static void Run(BenchmarkRunner runner)
+        {
+            byte[] hmacKey = RandomHash.GetRandomBytes(64);
+
+            RunAlg(runner, "HS256", jwt => jwt.Sign(hmacKey, HashAlg.SHA256), jwt => jwt.Verify(hmacKey, HashAlg.SHA256));
+            RunAlg(runner, "HS512", jwt => jwt.Sign(hmacKey, HashAlg.SHA512), jwt => jwt.Verify(hmacKey, HashAlg.SHA512));
+
+            RunView(
+                runner, 
+                "HS256", 
+                jwt => jwt.Sign(hmacKey, HashAlg.SHA256), 
+                raw => JwtView.TryParse(raw, out JwtView view) && view.Verify(hmacKey, HashAlg.SHA256)
+            );
+
+            using JwkSignatureCache cache = new();
+
+            using (ECDsa ec = ECDsa.Create(ECCurve.NamedCurves.nistP256))
+            {
+                RunAlg(runner, "ES256", jwt => jwt.Sign(ec, HashAlg.SHA256), jwt => jwt.Verify(ec, HashAlg.SHA256));
+                RunView(runner, "ES256", jwt => jwt.Sign(ec, HashAlg.SHA256), raw => JwtView.TryParse(raw, out JwtView view) && view.Verify(ec, HashAlg.SHA256));
+
+                ReadOnlyJsonWebKey jwk = CreateJwk(ec.ExportParameters(false));
+                RunAlg(runner, "jwk-ES256", jwt => jwt.Sign(ec, HashAlg.SHA256), jwt => jwt.VerifyFromJwk(jwk), "ES256");
+                RunAlg(runner, "jwk-cached-ES256", jwt => jwt.Sign(ec, HashAlg.SHA256), jwt => jwt.VerifyFromJwk(jwk, cache), "ES256");
+            }
+
+            using (ECDsa ec = ECDsa.Create(ECCurve.NamedCurves.nistP384))
+            {
+                RunAlg(runner, "ES384", jwt => jwt.Sign(ec, HashAlg.SHA384), jwt => jwt.Verify(ec, HashAlg.SHA384));
+            }
+
+            using (RSA rsa = RSA.Create(2048))
+            {
+                RunAlg(
+                    runner, 
+                    "RS256", 
+                    jwt => jwt.Sign(rsa, HashAlg.SHA256, RSASignaturePadding.Pkcs1), 
+                    jwt => jwt.Verify(rsa, HashAlg.SHA256, RSASignaturePadding.Pkcs1)
+                );
+
+                ReadOnlyJsonWebKey jwk = CreateJwk(rsa.ExportParameters(false));
+
+                RunAlg(
+                    runner, 
+                    "jwk-RS256", 
+                    jwt => jwt.Sign(rsa, HashAlg.SHA256, RSASignaturePadding.Pkcs1), 
+                    jwt => jwt.VerifyFromJwk(jwk), 
+                    "RS256"
+                );
+
+                RunAlg(
+                    runner, 
+                    "jwk-cached-RS256", 
+                    jwt => jwt.Sign(rsa, HashAlg.SHA256, RSASignaturePadding.Pkcs1), 
+                    jwt => jwt.VerifyFromJwk(jwk, cache), 
+                    "RS256"
+                );
+
+                RunAlg(
+                    runner, 
+                    "PS256", 
+                    jwt => jwt.Sign(rsa, HashAlg.SHA256, RSASignaturePadding.Pss), 
+                    jwt => jwt.Verify(rsa, HashAlg.SHA256, RSASignaturePadding.Pss)
+                );
+            }
+
+            if (MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                byte[] secretKey = new byte[MCCurve25519Module.Ed25519SecretKeySize];
+                byte[] publicKey = new byte[MCCurve25519Module.Ed25519PublicKeySize];
+                MonoCypherLibrary.Shared.Ed25519CreateKeyPair(RandomHash.GetRandomBytes(MCCurve25519Module.Ed25519SeedSize), secretKey, publicKey);
+
+                MCEd25519SignatureProvider signer = new(MonoCypherLibrary.Shared, secretKey);
+                MCEd25519SignatureVerifier verifier = new(MonoCypherLibrary.Shared, publicKey);
+
+                RunAlg(runner, "EdDSA", jwt => jwt.SignEdDSA(in signer), jwt => jwt.VerifyEdDSA(in verifier));
+                RunView(runner, "EdDSA", jwt => jwt.SignEdDSA(in signer), raw => JwtView.TryParse(raw, out JwtView view) && view.VerifyEdDSA(in verifier));
+            }
+            else
+            {
+                Console.WriteLine("{0} is not set, skipping EdDSA cases", MonoCypherLibrary.MONOCYPHER_LIB_ENVIRONMENT_VAR_NAME);
+            }
+        }
+
+        private static void RunAlg(BenchmarkRunner runner, string alg, Action<JsonWebToken> sign, Func<JsonWebToken, bool> verify, string? headerAlg = null)
+        {
+            using JsonWebToken jwt = new();
+            jwt.WriteHeader(Encoding.UTF8.GetBytes($"{{\"alg\":\"{headerAlg ?? alg}\",\"typ\":\"JWT\"}}"));
+            jwt.WritePayload(Encoding.UTF8.GetBytes(Payload));
+
+            //Signing overwrites the previous signature so the same token can be reused
+            runner.Run(Suite, $"sign-{alg}", "default", 0, () => sign(jwt));
+
+            //The sign case may have been filtered out, the token must always be signed before verifying
+            sign(jwt);
+
+            if (!verify(jwt))
+            {
+                throw new InvalidOperationException($"The {alg} signature failed to verify, the benchmark is broken");
+            }
+
+            runner.Run(Suite, $"verify-{alg}", "default", 0, () => verify(jwt));
+        }
+
+        /*
+         * Verifies the raw token bytes with a JwtView, the way a bearer token is 
+         * verified straight from the request headers
+         */
+        private static void RunView(BenchmarkRunner runner, string alg, Action<JsonWebToken> sign, Func<byte[], bool> verify)
+        {
+            byte[] raw;
+
+            using (JsonWebToken jwt = new())
+            {
+                jwt.WriteHeader(Encoding.UTF8.GetBytes($"{{\"alg\":\"{alg}\",\"typ\":\"JWT\"}}"));
+                jwt.WritePayload(Encoding.UTF8.GetBytes(Payload));
+                sign(jwt);
+                raw = jwt.DataBuffer.ToArray();
+            }
+
+            if (!verify(raw))
+            {
+                throw new InvalidOperationException($"The {alg} signature failed to verify, the benchmark is broken");
+            }
+
+            runner.Run(Suite, $"verify-view-{alg}", "default", 0, () => verify(raw));
+        }
+
+        private static ReadOnlyJsonWebKey CreateJwk(ECParameters ec)
+        {
+            return CreateSigJwk(new()
+            {
+                ["kty"] = "EC",
+                ["alg"] = "ES256",
+                ["crv"] = "P-256",
+                ["x"] = VnEncoding.ToBase64UrlSafeString(ec.Q.X, false),
+                ["y"] = VnEncoding.ToBase64UrlSafeString(ec.Q.Y, false),
+            });
+        }
+
+        private static ReadOnlyJsonWebKey CreateJwk(RSAParameters rsa)
+        {
+            return CreateSigJwk(new()
+            {
+                ["kty"] = "RSA",
+                ["alg"] = "RS256",
+                ["e"] = VnEncoding.ToBase64UrlSafeString(rsa.Exponent, false),
+                ["n"] = VnEncoding.ToBase64UrlSafeString(rsa.Modulus, false),
+            });
+        }
+
+        private static ReadOnlyJsonWebKey CreateSigJwk(Dictionary<string, string?> props)
+        {
+            props["use"] = "sig";
+            return new(props.ToFrozenDictionary(StringComparer.OrdinalIgnoreCase));
+        }
+    }
+}
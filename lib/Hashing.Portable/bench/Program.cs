@@ -0,0 +1,176 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: Program.cs 
+*
+* Program.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System.Globalization;
+using System.Runtime.Intrinsics.X86;
+
+namespace VNLib.Hashing.Benchmarks
+{
+    /*
+     * Usage: 
+     *  VNLib.Hashing.Portable.Benchmarks [--suite hash|argon2|jwt]... [--quick] [--filter <text>]
+     *      [--samples <n>] [--sample-ms <ms>] [--out <results.csv>] 
+     *      [--baseline <baseline.csv>] [--tolerance <fraction>]
+     *      
+     *  VNLib.Hashing.Portable.Benchmarks --calibrate [--target-ms <ms>] [--concurrency <n>] [--max-memory-mb <mb>]
+     *  
+     * Calibrate mode searches for the strongest Argon2id cost parameters that meet the latency 
+     * target with the shared VnArgon2 library and prints a configuration block.
+     * 
+     * Native backends are loaded from the same environment variables the library 
+     * uses at runtime, VNLIB_ARGON2_DLL_PATH and VNLIB_MONOCYPHER_DLL_PATH. Cases for 
+     * a backend that is not configured are skipped.
+     * 
+     * Exit codes: 0 success, 1 regressions found against the baseline, 2 invalid arguments
+     */
+
+    internal static class Program
+    {
+        static int Main(string[] args)
+        {
+            HashSet<string> suites = new(StringComparer.OrdinalIgnoreCase);
+            bool quick = false;
+            string? filter = null, outPath = null, baselinePath = null;
+            int samples = 0;
+            double sampleMs = 0;
+            double tolerance = 0.10;
+            bool calibrate = false;
+            Argon2CalibrationOptions calibration = new();
+
+            try
+            {
+                for (int i = 0; i < args.Length; i++)
+                {
+                    switch (args[i])
+                    {
+                        case "--suite":
+                            suites.Add(args[++i]);
+                            break;
+                        case "--quick":
+                            quick = true;
+                            break;
+                        case "--filter":
+                            filter = args[++i];
+                            break;
+                        case "--samples":
+                            samples = int.Parse(args[++i], CultureInfo.InvariantCulture);
+                            break;
+                        case "--sample-ms":
+                            sampleMs = double.Parse(args[++i], CultureInfo.InvariantCulture);
+                            break;
+                        case "--out":
+                            outPath = args[++i];
+                            break;
+                        case "--baseline":
+                            baselinePath = args[++i];
+                            break;
+                        case "--tolerance":
+                            tolerance = double.Parse(args[++i], CultureInfo.InvariantCulture);
+                            break;
+                        case "--calibrate":
+                            calibrate = true;
+                            break;
+                        case "--target-ms":
+                            calibration = calibration with { TargetLatency = TimeSpan.FromMilliseconds(double.Parse(args[++i], CultureInfo.InvariantCulture)) };
+                            break;
+                        case "--concurrency":
+                            calibration = calibration with { Concurrency = int.Parse(args[++i], CultureInfo.InvariantCulture) };
+                            break;
+                        case "--max-memory-mb":
+                            calibration = calibration with { MaxMemoryBytes = long.Parse(args[++i], CultureInfo.InvariantCulture) * 1024 * 1024 };
+                            break;
+                        default:
+                            Console.Error.WriteLine("Unknown argument '{0}'", args[i]);
+                            return 2;
+                    }
+                }
+            }
+            catch (Exception ex) when (ex is IndexOutOfRangeException or FormatException)
+            {
+                Console.Error.WriteLine("Invalid arguments: {0}", ex.Message);
+                return 2;
+            }
+
+            if (suites.Count == 0)
+            {
+                suites.UnionWith([HashingBenchmarks.Suite, Argon2Benchmarks.Suite, JwtBenchmarks.Suite]);
+            }
+
+            BenchmarkOptions options = new(
+                SampleTime: TimeSpan.FromMilliseconds(sampleMs > 0 ? sampleMs : quick ? 50 : 250),
+                Samples: samples > 0 ? samples : quick ? 3 : 9,
+                Filter: filter
+            );
+
+            PrintEnvironment();
+
+            if (calibrate)
+            {
+                Argon2Benchmarks.Calibrate(calibration);
+                return 0;
+            }
+
+            BenchmarkRunner runner = new(options);
+
+            if (suites.Contains(HashingBenchmarks.Suite))
+            {
+                HashingBenchmarks.Run(runner, quick);
+            }
+
+            if (suites.Contains(Argon2Benchmarks.Suite))
+            {
+                Argon2Benchmarks.Run(runner, quick);
+            }
+
+            if (suites.Contains(JwtBenchmarks.Suite))
+            {
+                JwtBenchmarks.Run(runner);
+            }
+
+            if (outPath != null)
+            {
+                BenchmarkBaseline.WriteCsv(outPath, runner.Results);
+                Console.WriteLine("Wrote {0} results to {1}", runner.Results.Count, outPath);
+            }
+
+            if (baselinePath != null)
+            {
+                Dictionary<string, BenchmarkResult> baseline = BenchmarkBaseline.ReadCsv(baselinePath);
+                return BenchmarkBaseline.Compare(baseline, runner.Results, tolerance) > 0 ? 1 : 0;
+            }
+
+            return 0;
+        }
+
+        private static void PrintEnvironment()
+        {
+            Console.WriteLine("Runtime:     {0}", System.Runtime.InteropServices.RuntimeInformation.FrameworkDescription);
+            Console.WriteLine("OS:          {0}", System.Runtime.InteropServices.RuntimeInformation.OSDescription);
+            Console.WriteLine("Processors:  {0}, AVX2: {1}", Environment.ProcessorCount, Avx2.IsSupported);
+            Console.WriteLine("Argon2:      {0}", Environment.GetEnvironmentVariable(VnArgon2.ARGON2_LIB_ENVIRONMENT_VAR_NAME) ?? "<not set>");
+            Console.WriteLine("MonoCypher:  {0}", Environment.GetEnvironmentVariable(Native.MonoCypher.MonoCypherLibrary.MONOCYPHER_LIB_ENVIRONMENT_VAR_NAME) ?? "<not set>");
+            Console.WriteLine();
+        }
+    }
+}
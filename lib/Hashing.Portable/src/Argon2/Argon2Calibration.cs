@@ -0,0 +1,294 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: Argon2Calibration.cs 
+*
+* Argon2Calibration.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Threading;
+using System.Diagnostics;
+using System.Runtime.ExceptionServices;
+
+namespace VNLib.Hashing
+{
+    public static partial class VnArgon2
+    {
+        /*
+         * Memory costs are searched in whole MiB steps, finer steps cost
+         * more trials than the measurement noise is worth
+         */
+        const uint CALIBRATION_MEMORY_STEP_KB = 1024;
+
+        /// <summary>
+        /// Finds the strongest Argon2id cost parameters that meet a latency target while 
+        /// the expected number of hashes run concurrently on this host. Every time cost and 
+        /// lane count in the search bounds is evaluated, and the memory cost is binary searched
+        /// between the minimum and the per-hash memory ceiling. The parameters with the highest
+        /// memory * time product are returned.
+        /// </summary>
+        /// <param name="lib"></param>
+        /// <param name="options">The latency target and search bounds</param>
+        /// <returns>The calibrated cost parameters and the latency measured with them</returns>
+        /// <exception cref="ArgumentException"></exception>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        /// <exception cref="VnArgon2Exception"></exception>
+        /// <remarks>
+        /// Calibration runs many trial hashes on dedicated threads and may take from several 
+        /// seconds to minutes. Run it once while the host is otherwise idle and store the 
+        /// resulting configuration.
+        /// </remarks>
+        public static Argon2CalibrationResult Calibrate2id(this IArgon2Library lib, Argon2CalibrationOptions options)
+        {
+            ArgumentNullException.ThrowIfNull(lib);
+            ArgumentNullException.ThrowIfNull(options);
+            ArgumentNullException.ThrowIfNull(options.Parallelism);
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(options.Concurrency);
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(options.TrialsPerWorker);
+            ArgumentOutOfRangeException.ThrowIfZero(options.MaxTimeCost);
+            ArgumentOutOfRangeException.ThrowIfLessThanOrEqual(options.TargetLatency, TimeSpan.Zero);
+
+            if (options.Parallelism.Length == 0)
+            {
+                throw new ArgumentException("At least one parallelism value must be specified", nameof(options));
+            }
+
+            //The memory cost of a single hash is bounded by the total ceiling shared by all concurrent hashes
+            long ceilingKb = Math.Min(options.MaxMemoryBytes / 1024 / options.Concurrency, uint.MaxValue);
+
+            if (ceilingKb < options.MinMemoryCost)
+            {
+                throw new ArgumentException("The memory ceiling is too small for the minimum memory cost at the requested concurrency", nameof(options));
+            }
+
+            //Prime the work area pool and native library so the first trial is not penalized
+            _ = RunTrial(lib, 1, options.MinMemoryCost, options.Parallelism[0], 1, 1);
+
+            Argon2CalibrationResult? best = null;
+
+            foreach (uint lanes in options.Parallelism)
+            {
+                ArgumentOutOfRangeException.ThrowIfZero(lanes);
+
+                //Argon2 requires at least 8 blocks per lane
+                uint floor = Math.Max(options.MinMemoryCost, 8 * lanes);
+
+                //A higher time cost can never afford more memory than a lower one
+                uint ceiling = (uint)ceilingKb;
+
+                for (uint t = 1; t <= options.MaxTimeCost && floor <= ceiling; t++)
+                {
+                    Argon2CalibrationResult? fit = FindMaxMemory(lib, options, t, lanes, floor, ceiling);
+
+                    //If the floor does not fit, higher time costs will not either
+                    if (fit == null)
+                    {
+                        break;
+                    }
+
+                    if (best == null || IsStronger(fit, best))
+                    {
+                        best = fit;
+                    }
+
+                    ceiling = fit.MemoryCost;
+                }
+            }
+
+            if (best != null)
+            {
+                return best;
+            }
+
+            //Nothing met the target, report the cheapest parameters so the caller can decide
+            uint minLanes = options.Parallelism[0];
+            uint minMemory = Math.Max(options.MinMemoryCost, 8 * minLanes);
+
+            TrialResult cheapest = RunTrial(lib, 1, minMemory, minLanes, options.Concurrency, options.TrialsPerWorker);
+
+            return CreateResult(options, 1, minMemory, minLanes, in cheapest, targetMet: false);
+        }
+
+        private static Argon2CalibrationResult? FindMaxMemory(
+            IArgon2Library lib,
+            Argon2CalibrationOptions options,
+            uint timeCost,
+            uint lanes,
+            uint floor,
+            uint ceiling
+        )
+        {
+            TrialResult trial = RunTrial(lib, timeCost, floor, lanes, options.Concurrency, options.TrialsPerWorker);
+
+            if (trial.P95 > options.TargetLatency)
+            {
+                return null;
+            }
+
+            uint good = floor;
+            TrialResult goodTrial = trial;
+
+            //Check the ceiling first, a generous latency budget often affords all of it
+            trial = RunTrial(lib, timeCost, ceiling, lanes, options.Concurrency, options.TrialsPerWorker);
+
+            if (trial.P95 <= options.TargetLatency)
+            {
+                return CreateResult(options, timeCost, ceiling, lanes, in trial, targetMet: true);
+            }
+
+            uint low = floor, high = ceiling;
+
+            while (high - low > CALIBRATION_MEMORY_STEP_KB)
+            {
+                //Keep the memory cost on whole steps above the floor
+                uint mid = low + Math.Max(CALIBRATION_MEMORY_STEP_KB, (high - low) / 2 / CALIBRATION_MEMORY_STEP_KB * CALIBRATION_MEMORY_STEP_KB);
+
+                trial = RunTrial(lib, timeCost, mid, lanes, options.Concurrency, options.TrialsPerWorker);
+
+                if (trial.P95 <= options.TargetLatency)
+                {
+                    low = good = mid;
+                    goodTrial = trial;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+
+            return CreateResult(options, timeCost, good, lanes, in goodTrial, targetMet: true);
+        }
+
+        private static bool IsStronger(Argon2CalibrationResult candidate, Argon2CalibrationResult current)
+        {
+            ulong candidateCost = (ulong)candidate.MemoryCost * candidate.TimeCost;
+            ulong currentCost = (ulong)current.MemoryCost * current.TimeCost;
+
+            //Prefer the faster parameters when both are equally strong
+            return candidateCost > currentCost 
+                || (candidateCost == currentCost && candidate.P95Latency < current.P95Latency);
+        }
+
+        private static Argon2CalibrationResult CreateResult(
+            Argon2CalibrationOptions options, 
+            uint timeCost, 
+            uint memoryCost, 
+            uint lanes, 
+            ref readonly TrialResult trial, 
+            bool targetMet
+        )
+        {
+            return new()
+            {
+                TimeCost = timeCost,
+                MemoryCost = memoryCost,
+                Parallelism = lanes,
+                Concurrency = options.Concurrency,
+                P95Latency = trial.P95,
+                MedianLatency = trial.Median,
+                TargetMet = targetMet
+            };
+        }
+
+        /*
+         * Runs the trial hashes on dedicated threads instead of the thread pool so 
+         * the measurement does not depend on the pool's thread injection, and 
+         * releases all workers at once so the hashes actually overlap.
+         */
+        private static TrialResult RunTrial(IArgon2Library lib, uint timeCost, uint memoryCost, uint lanes, int concurrency, int trialsPerWorker)
+        {
+            long[] latencies = new long[concurrency * trialsPerWorker];
+            Thread[] workers = new Thread[concurrency];
+            Exception? error = null;
+
+            using Barrier start = new(concurrency);
+
+            for (int w = 0; w < concurrency; w++)
+            {
+                int worker = w;
+
+                workers[w] = new Thread(() =>
+                {
+                    Span<byte> password = stackalloc byte[16];
+                    Span<byte> salt = stackalloc byte[16];
+                    Span<byte> hash = stackalloc byte[32];
+
+                    RandomHash.GetRandomBytes(password);
+                    RandomHash.GetRandomBytes(salt);
+
+                    Argon2CostParams costParams = new()
+                    {
+                        TimeCost = timeCost,
+                        MemoryCost = memoryCost,
+                        Parallelism = lanes
+                    };
+
+                    start.SignalAndWait();
+
+                    try
+                    {
+                        for (int i = 0; i < trialsPerWorker; i++)
+                        {
+                            long ts = Stopwatch.GetTimestamp();
+
+                            Hash2id(lib, password, salt, default, hash, in costParams);
+
+                            latencies[worker * trialsPerWorker + i] = Stopwatch.GetTimestamp() - ts;
+                        }
+                    }
+                    catch (Exception ex)
+                    {
+                        Interlocked.CompareExchange(ref error, ex, null);
+                    }
+                })
+                {
+                    IsBackground = true,
+                    Name = "Argon2 calibration worker"
+                };
+
+                workers[w].Start();
+            }
+
+            foreach (Thread worker in workers)
+            {
+                worker.Join();
+            }
+
+            if (error != null)
+            {
+                ExceptionDispatchInfo.Throw(error);
+            }
+
+            Array.Sort(latencies);
+
+            //Nearest rank percentiles
+            long p95 = latencies[(int)Math.Ceiling(latencies.Length * 0.95) - 1];
+            long median = latencies[latencies.Length / 2];
+
+            return new TrialResult(
+                TimeSpan.FromSeconds((double)p95 / Stopwatch.Frequency),
+                TimeSpan.FromSeconds((double)median / Stopwatch.Frequency)
+            );
+        }
+
+        private readonly record struct TrialResult(TimeSpan P95, TimeSpan Median);
+    }
+}
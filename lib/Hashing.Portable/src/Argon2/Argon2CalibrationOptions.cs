@@ -0,0 +1,76 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: Argon2CalibrationOptions.cs 
+*
+* Argon2CalibrationOptions.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+
+namespace VNLib.Hashing
+{
+    /// <summary>
+    /// The targets and search bounds used by <see cref="VnArgon2.Calibrate2id(IArgon2Library, Argon2CalibrationOptions)"/>
+    /// to choose Argon2id cost parameters for the current host.
+    /// </summary>
+    public sealed record class Argon2CalibrationOptions
+    {
+        /// <summary>
+        /// The highest acceptable 95th percentile latency of a single hash while 
+        /// <see cref="Concurrency"/> hashes are running at the same time (defaults to 250ms)
+        /// </summary>
+        public TimeSpan TargetLatency { get; init; } = TimeSpan.FromMilliseconds(250);
+
+        /// <summary>
+        /// The number of hashes expected to run at the same time, such as concurrent
+        /// logins during peak load (defaults to the number of logical processors)
+        /// </summary>
+        public int Concurrency { get; init; } = Environment.ProcessorCount;
+
+        /// <summary>
+        /// The maximum number of bytes all concurrent hashes may use together. The 
+        /// memory cost of a single hash is bounded by this value divided by 
+        /// <see cref="Concurrency"/> (defaults to 1GB)
+        /// </summary>
+        public long MaxMemoryBytes { get; init; } = 1024L * 1024 * 1024;
+
+        /// <summary>
+        /// The lowest memory cost in KiB that will be considered (defaults to 19456, 
+        /// the OWASP recommended minimum for Argon2id)
+        /// </summary>
+        public uint MinMemoryCost { get; init; } = 19456;
+
+        /// <summary>
+        /// The highest time cost that will be considered (defaults to 4)
+        /// </summary>
+        public uint MaxTimeCost { get; init; } = 4;
+
+        /// <summary>
+        /// The lane counts to evaluate (defaults to 1, 2 and 4)
+        /// </summary>
+        public uint[] Parallelism { get; init; } = [1, 2, 4];
+
+        /// <summary>
+        /// The number of hashes every concurrent worker computes during a single trial, 
+        /// more samples give a more stable p95 at the cost of a longer calibration (defaults to 4)
+        /// </summary>
+        public int TrialsPerWorker { get; init; } = 4;
+    }
+}
@@ -0,0 +1,113 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: Argon2CalibrationResult.cs 
+*
+* Argon2CalibrationResult.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.IO;
+using System.Text;
+using System.Text.Json;
+
+namespace VNLib.Hashing
+{
+    /// <summary>
+    /// The cost parameters chosen by <see cref="VnArgon2.Calibrate2id(IArgon2Library, Argon2CalibrationOptions)"/> 
+    /// and the latency that was measured with them
+    /// </summary>
+    public sealed record class Argon2CalibrationResult
+    {
+        /// <summary>
+        /// The calibrated Argon2 time cost
+        /// </summary>
+        public required uint TimeCost { get; init; }
+
+        /// <summary>
+        /// The calibrated Argon2 memory cost in KiB
+        /// </summary>
+        public required uint MemoryCost { get; init; }
+
+        /// <summary>
+        /// The calibrated Argon2 parallelism (lanes)
+        /// </summary>
+        public required uint Parallelism { get; init; }
+
+        /// <summary>
+        /// The number of hashes that were run at the same time when measuring
+        /// </summary>
+        public required int Concurrency { get; init; }
+
+        /// <summary>
+        /// The measured 95th percentile latency of a single hash under <see cref="Concurrency"/>
+        /// </summary>
+        public required TimeSpan P95Latency { get; init; }
+
+        /// <summary>
+        /// The measured median latency of a single hash under <see cref="Concurrency"/>
+        /// </summary>
+        public required TimeSpan MedianLatency { get; init; }
+
+        /// <summary>
+        /// True if the parameters met the latency target. When false, even the 
+        /// cheapest parameters in the search bounds were too slow and the cheapest
+        /// parameters are returned.
+        /// </summary>
+        public required bool TargetMet { get; init; }
+
+        /// <summary>
+        /// The number of bytes of work area memory all concurrent hashes use together
+        /// </summary>
+        public long PeakMemoryBytes => (long)MemoryCost * 1024 * Concurrency;
+
+        /// <summary>
+        /// Gets the calibrated parameters as <see cref="Argon2CostParams"/>
+        /// </summary>
+        /// <returns>The cost parameters</returns>
+        public Argon2CostParams GetCostParams() => new()
+        {
+            TimeCost = TimeCost,
+            MemoryCost = MemoryCost,
+            Parallelism = Parallelism
+        };
+
+        /// <summary>
+        /// Writes the calibrated parameters as an indented json configuration block
+        /// </summary>
+        /// <returns>The json configuration block</returns>
+        public string ToConfigBlock()
+        {
+            using MemoryStream ms = new();
+
+            using (Utf8JsonWriter writer = new(ms, new JsonWriterOptions { Indented = true }))
+            {
+                writer.WriteStartObject();
+                writer.WriteStartObject("argon2");
+                writer.WriteNumber("time_cost", TimeCost);
+                writer.WriteNumber("memory_cost", MemoryCost);
+                writer.WriteNumber("parallelism", Parallelism);
+                writer.WriteEndObject();
+                writer.WriteEndObject();
+            }
+
+            return Encoding.UTF8.GetString(ms.ToArray());
+        }
+    }
+}
@@ -0,0 +1,270 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: Argon2WorkAreaPool.cs 
+*
+* Argon2WorkAreaPool.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Diagnostics;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
+namespace VNLib.Hashing
+{
+    /// <summary>
+    /// A bounded pool of Argon2 memory work areas keyed by size. Work areas are
+    /// page aligned and pre-faulted when they are first allocated, and wiped
+    /// before they are reused or freed, so repeated hashes with the same cost
+    /// parameters do not pay for a large allocation and page faults every time.
+    /// </summary>
+    /// <remarks>
+    /// The limit only covers idle work areas held by the pool, rented work areas
+    /// are not counted and the number that may be rented at the same time is not
+    /// limited. Work areas are counted at the size of their allocation, which is
+    /// rounded up to whole pages, or whole 2mb huge pages when huge pages are used.
+    /// Blocks returned when the pool is full are freed.
+    /// </remarks>
+    public sealed unsafe partial class Argon2WorkAreaPool : IDisposable
+    {
+        const int MADV_HUGEPAGE = 14;
+        const nuint HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+        [LibraryImport("libc", EntryPoint = "madvise")]
+        private static partial int MAdvise(void* addr, nuint length, int advice);
+
+        private readonly Dictionary<nuint, Stack<IntPtr>> _pool = [];
+        private readonly nuint _pageSize = (nuint)Environment.SystemPageSize;
+        private nuint _pooledBytes;
+        private bool _disposed;
+
+        /// <summary>
+        /// The maximum number of bytes of idle work areas that will be retained, 
+        /// counted at their page rounded allocation size
+        /// </summary>
+        public nuint MaxPooledBytes { get; }
+
+        /// <summary>
+        /// Advises the kernel to back large work areas with transparent huge pages.
+        /// Only supported on Linux, it is ignored on other platforms.
+        /// </summary>
+        public bool UseHugePages { get; }
+
+        /// <summary>
+        /// The number of bytes of idle work areas currently held by the pool, counted 
+        /// at their page rounded allocation size. Rented work areas are not included.
+        /// </summary>
+        public nuint PooledBytes
+        {
+            get
+            {
+                lock (_pool)
+                {
+                    return _pooledBytes;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Creates a new work area pool
+        /// </summary>
+        /// <param name="maxPooledBytes">The maximum number of bytes of idle work areas to retain, 0 disables pooling</param>
+        /// <param name="useHugePages">Advise the kernel to back large work areas with huge pages</param>
+        public Argon2WorkAreaPool(nuint maxPooledBytes, bool useHugePages)
+        {
+            MaxPooledBytes = maxPooledBytes;
+            UseHugePages = useHugePages && OperatingSystem.IsLinux();
+        }
+
+        /// <summary>
+        /// Gets a zeroed work area of the exact size from the pool or allocates a new one
+        /// </summary>
+        /// <param name="size">The size in bytes of the work area</param>
+        /// <returns>A pointer to the work area that must be passed to <see cref="Return(IntPtr, nuint)"/></returns>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        /// <exception cref="OutOfMemoryException"></exception>
+        public IntPtr Rent(nuint size)
+        {
+            ArgumentOutOfRangeException.ThrowIfZero(size);
+
+            lock (_pool)
+            {
+                if (_pool.TryGetValue(size, out Stack<IntPtr>? blocks) && blocks.TryPop(out IntPtr block))
+                {
+                    _pooledBytes -= GetAllocationSize(size);
+                    return block;
+                }
+            }
+
+            return Allocate(size);
+        }
+
+        /// <summary>
+        /// Wipes the work area and returns it to the pool. If the pool is full,
+        /// idle work areas of other sizes are evicted first, otherwise the
+        /// block is freed.
+        /// </summary>
+        /// <param name="workArea">The work area returned from <see cref="Rent(nuint)"/></param>
+        /// <param name="size">The size of the work area that was rented</param>
+        public void Return(IntPtr workArea, nuint size) => Return(workArea, size, false);
+
+        /// <summary>
+        /// Returns a work area to the pool. If the pool is full, idle work areas of 
+        /// other sizes are evicted first, otherwise the block is freed.
+        /// </summary>
+        /// <param name="workArea">The work area returned from <see cref="Rent(nuint)"/></param>
+        /// <param name="size">The size of the work area that was rented</param>
+        /// <param name="isCleared">
+        /// True if the caller has already wiped the entire work area, such as the reference 
+        /// argon2 library which clears its memory before freeing it
+        /// </param>
+        public void Return(IntPtr workArea, nuint size, bool isCleared)
+        {
+            if (workArea == IntPtr.Zero)
+            {
+                return;
+            }
+
+            //Work areas hold password derived data, they must be wiped before reuse or free
+            if (!isCleared)
+            {
+                NativeMemory.Clear(workArea.ToPointer(), size);
+            }
+
+            nuint allocSize = GetAllocationSize(size);
+
+            lock (_pool)
+            {
+                if (!_disposed && allocSize <= MaxPooledBytes)
+                {
+                    EvictForSize(size, allocSize);
+
+                    if (_pooledBytes + allocSize <= MaxPooledBytes)
+                    {
+                        if (!_pool.TryGetValue(size, out Stack<IntPtr>? blocks))
+                        {
+                            blocks = new();
+                            _pool[size] = blocks;
+                        }
+
+                        blocks.Push(workArea);
+                        _pooledBytes += allocSize;
+                        return;
+                    }
+                }
+            }
+
+            NativeMemory.AlignedFree(workArea.ToPointer());
+        }
+
+        /// <summary>
+        /// Frees all idle work areas held by the pool
+        /// </summary>
+        public void Trim()
+        {
+            lock (_pool)
+            {
+                foreach (Stack<IntPtr> blocks in _pool.Values)
+                {
+                    while (blocks.TryPop(out IntPtr block))
+                    {
+                        NativeMemory.AlignedFree(block.ToPointer());
+                    }
+                }
+
+                _pool.Clear();
+                _pooledBytes = 0;
+            }
+        }
+
+        /*
+         * Cost parameters rarely change, so when the pool is full make room by
+         * freeing blocks of other sizes, they are unlikely to be requested again
+         */
+        private void EvictForSize(nuint size, nuint allocSize)
+        {
+            foreach (KeyValuePair<nuint, Stack<IntPtr>> kv in _pool)
+            {
+                if (kv.Key == size)
+                {
+                    continue;
+                }
+
+                while (_pooledBytes + allocSize > MaxPooledBytes && kv.Value.TryPop(out IntPtr block))
+                {
+                    NativeMemory.AlignedFree(block.ToPointer());
+                    _pooledBytes -= GetAllocationSize(kv.Key);
+                }
+
+                if (_pooledBytes + allocSize <= MaxPooledBytes)
+                {
+                    return;
+                }
+            }
+        }
+
+        /*
+         * The number of bytes actually mapped for a work area of the given size, 
+         * this is what the pool limit is charged for an idle block
+         */
+        private nuint GetAllocationSize(nuint size)
+        {
+            //Huge pages are only used for whole, aligned 2mb regions
+            nuint alignment = UseHugePages && size >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : _pageSize;
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+
+        private IntPtr Allocate(nuint size)
+        {
+            void* block;
+            nuint allocSize = GetAllocationSize(size);
+
+            if (UseHugePages && size >= HUGE_PAGE_SIZE)
+            {
+                block = NativeMemory.AlignedAlloc(allocSize, HUGE_PAGE_SIZE);
+
+                //Only a hint, failure just means regular pages are used
+                _ = MAdvise(block, allocSize, MADV_HUGEPAGE);
+            }
+            else
+            {
+                block = NativeMemory.AlignedAlloc(allocSize, _pageSize);
+            }
+
+            Debug.Assert(block != null, "AlignedAlloc returned null without throwing");
+
+            //Pre-fault the work area now so the hash does not take the page faults
+            NativeMemory.Clear(block, size);
+
+            return (IntPtr)block;
+        }
+
+        ///<inheritdoc/>
+        public void Dispose()
+        {
+            lock (_pool)
+            {
+                _disposed = true;
+            }
+
+            Trim();
+        }
+    }
+}
@@ -28,6 +28,7 @@ using System.Diagnostics;
 using System.Buffers.Text;
 using System.Security.Cryptography;
 using System.Runtime.InteropServices;
+using System.Runtime.CompilerServices;
 
 using VNLib.Utils.Memory;
 using VNLib.Utils.Native;
@@ -50,7 +51,7 @@ namespace VNLib.Hashing
     /// Implements the Argon2 data hashing library in .NET for cross platform use.
     /// </summary>
     /// <remarks>Buffers are allocted on a private <see cref="IUnmangedHeap"/> instance.</remarks>
-    public static unsafe class VnArgon2
+    public static unsafe partial class VnArgon2
     {
         public const uint ARGON2_DEFAULT_FLAGS = 0U;
         public const uint HASH_SIZE = 128;
@@ -59,9 +60,23 @@ namespace VNLib.Hashing
         public const string ARGON2_DEFUALT_LIB_NAME = "argon2";
         public const string ARGON2_LIB_ENVIRONMENT_VAR_NAME = "VNLIB_ARGON2_DLL_PATH";
 
+        /// <summary>
+        /// The environment variable that sets the maximum amount of idle work area memory, 
+        /// in megabytes, retained by the <see cref="WorkAreaPool"/>
+        /// </summary>
+        public const string ARGON2_POOL_SIZE_ENVIRONMENT_VAR_NAME = "VNLIB_ARGON2_POOL_SIZE_MB";
+
+        /// <summary>
+        /// The maximum amount of idle work area memory, in megabytes, retained by the 
+        /// <see cref="WorkAreaPool"/> when the <see cref="ARGON2_POOL_SIZE_ENVIRONMENT_VAR_NAME"/>
+        /// environment variable is not set
+        /// </summary>
+        public const int ARGON2_DEFAULT_POOL_SIZE_MB = 256;
+
         private static readonly Encoding LocEncoding = Encoding.Unicode;
         private static readonly LazyInitializer<IUnmangedHeap> _heap = new (static () => MemoryUtil.InitializeNewHeapForProcess(true));
         private static readonly LazyInitializer<IArgon2Library> _nativeLibrary = new(LoadSharedLibInternal);
+        private static readonly LazyInitializer<Argon2WorkAreaPool> _workAreaPool = new(CreateSharedPool);
 
 
         //Private heap initialized to 10k size, and all allocated buffers will be zeroed when allocated
@@ -78,7 +93,7 @@ namespace VNLib.Hashing
                 Trace.WriteLine("Using the native MonoCypher library for Argon2 password hashing", "VnArgon2");
 
                 //Load shared monocyphter argon2 library
-                return MonoCypherLibrary.Shared.Argon2CreateLibrary(_heap.Instance);
+                return MonoCypherLibrary.Shared.Argon2CreateLibrary(_workAreaPool.Instance);
             }
             else
             {
@@ -92,6 +107,49 @@ namespace VNLib.Hashing
         }
 
 
+        private static Argon2WorkAreaPool CreateSharedPool()
+        {
+            string? poolSizeMb = Environment.GetEnvironmentVariable(ARGON2_POOL_SIZE_ENVIRONMENT_VAR_NAME);
+
+            if (!uint.TryParse(poolSizeMb, out uint sizeMb))
+            {
+                sizeMb = ARGON2_DEFAULT_POOL_SIZE_MB;
+            }
+
+            return new Argon2WorkAreaPool((nuint)sizeMb * 1024 * 1024, useHugePages: true);
+        }
+
+        /*
+         * The reference argon2 library allocates its work area through the context
+         * callbacks, so both library types can share the work area pool
+         */
+
+        [UnmanagedCallersOnly(CallConvs = [typeof(CallConvCdecl)])]
+        private static int RentWorkArea(byte** memory, nuint size)
+        {
+            try
+            {
+                *memory = (byte*)_workAreaPool.Instance.Rent(size);
+            }
+            catch
+            {
+                //Exceptions cannot cross into native code, a null pointer is reported as an allocation error
+                *memory = null;
+            }
+            return 0;
+        }
+
+        //The reference library wipes its memory before calling the free callback
+        [UnmanagedCallersOnly(CallConvs = [typeof(CallConvCdecl)])]
+        private static void ReturnWorkArea(byte* memory, nuint size) => _workAreaPool.Instance.Return((IntPtr)memory, size, isCleared: true);
+
+        /// <summary>
+        /// Gets the shared pool of argon2 work areas used by the shared library. The 
+        /// amount of idle memory retained may be set with the <see cref="ARGON2_POOL_SIZE_ENVIRONMENT_VAR_NAME"/>
+        /// environment variable in megabytes.
+        /// </summary>
+        public static Argon2WorkAreaPool WorkAreaPool => _workAreaPool.Instance;
+
         /// <summary>
         /// Gets the sahred native library instance for the current process.
         /// </summary>
@@ -292,8 +350,8 @@ namespace VNLib.Hashing
                 threads = costParams.Parallelism,
                 lanes = costParams.Parallelism,
                 flags = ARGON2_DEFAULT_FLAGS,
-                allocate_cbk = null,
-                free_cbk = null,
+                allocate_cbk = (delegate* unmanaged[Cdecl]<byte**, nuint, int>)&RentWorkArea,
+                free_cbk = (delegate* unmanaged[Cdecl]<byte*, nuint, void>)&ReturnWorkArea,
             };
 
             fixed (byte* pSecret = secret, pPass = password, pSalt = salt, pRawHash = rawHashOutput)
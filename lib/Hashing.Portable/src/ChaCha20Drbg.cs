@@ -0,0 +1,265 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: ChaCha20Drbg.cs 
+*
+* ChaCha20Drbg.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Buffers.Binary;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Security.Cryptography;
+
+namespace VNLib.Hashing
+{
+    /// <summary>
+    /// A ChaCha20 based deterministic random bit generator that serves small random
+    /// requests from a keystream buffer, so generating many short tokens does not
+    /// need a system call per token. Uses fast key erasure, every refill replaces the
+    /// key with the first block of its own output, and consumed output is wiped from
+    /// the buffer so earlier results cannot be recovered from the generator state.
+    /// </summary>
+    /// <remarks>
+    /// Instances are not thread safe, use one instance per thread. Generators seeded
+    /// from the operating system mix in fresh system entropy every 
+    /// <see cref="ReseedInterval"/> bytes and at least once a minute.
+    /// </remarks>
+    public sealed class ChaCha20Drbg : IDisposable
+    {
+        /// <summary>
+        /// The size in bytes of the seed/key
+        /// </summary>
+        public const int SeedSize = 32;
+
+        /// <summary>
+        /// The default number of output bytes between reseeds from the operating system
+        /// </summary>
+        public const long DefaultReseedInterval = 1024 * 1024;
+
+        private const int BLOCK_SIZE = 64;
+        private const int BUFFER_BLOCKS = 16;
+        private const int BUFFER_SIZE = BLOCK_SIZE * BUFFER_BLOCKS;
+        private const long RESEED_PERIOD_MS = 60 * 1000;
+
+        //"expand 32-byte k"
+        private const uint SIGMA0 = 0x61707865;
+        private const uint SIGMA1 = 0x3320646e;
+        private const uint SIGMA2 = 0x79622d32;
+        private const uint SIGMA3 = 0x6b206574;
+
+        private readonly byte[] _buffer = new byte[BUFFER_SIZE];
+        private readonly uint[] _key = new uint[SeedSize / sizeof(uint)];
+        private int _position;
+        private long _sinceReseed;
+        private long _reseedAt;
+        private bool _disposed;
+
+        /// <summary>
+        /// The number of output bytes between reseeds from the operating system, 0 if
+        /// the generator was created from a fixed seed and never reseeds automatically
+        /// </summary>
+        public long ReseedInterval { get; }
+
+        /// <summary>
+        /// Creates a new generator seeded from the operating system that reseeds
+        /// every <see cref="DefaultReseedInterval"/> bytes
+        /// </summary>
+        public ChaCha20Drbg() : this(DefaultReseedInterval)
+        { }
+
+        /// <summary>
+        /// Creates a new generator seeded from the operating system
+        /// </summary>
+        /// <param name="reseedInterval">The number of output bytes between reseeds from the operating system</param>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public ChaCha20Drbg(long reseedInterval)
+        {
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(reseedInterval);
+
+            ReseedInterval = reseedInterval;
+            Reseed();
+        }
+
+        /// <summary>
+        /// Creates a deterministic generator from a fixed seed that never reseeds 
+        /// automatically. Intended for testing and reproducible streams, the output
+        /// is only as secret as the seed.
+        /// </summary>
+        /// <param name="seed">The <see cref="SeedSize"/> byte seed</param>
+        /// <exception cref="ArgumentException"></exception>
+        public ChaCha20Drbg(ReadOnlySpan<byte> seed)
+        {
+            if (seed.Length != SeedSize)
+            {
+                throw new ArgumentException($"The seed must be exactly {SeedSize} bytes", nameof(seed));
+            }
+
+            for (int i = 0; i < _key.Length; i++)
+            {
+                _key[i] = BinaryPrimitives.ReadUInt32LittleEndian(seed[(i * sizeof(uint))..]);
+            }
+
+            _position = BUFFER_SIZE;
+        }
+
+        /// <summary>
+        /// Fills the buffer with random bytes
+        /// </summary>
+        /// <param name="output">The buffer to fill</param>
+        /// <exception cref="ObjectDisposedException"></exception>
+        public void Fill(Span<byte> output)
+        {
+            ObjectDisposedException.ThrowIf(_disposed, this);
+
+            while (output.Length > 0)
+            {
+                if (_position == BUFFER_SIZE)
+                {
+                    Refill();
+                }
+
+                int count = Math.Min(output.Length, BUFFER_SIZE - _position);
+                Span<byte> available = _buffer.AsSpan(_position, count);
+
+                available.CopyTo(output);
+
+                //Output is never handed out twice or left in memory after use
+                CryptographicOperations.ZeroMemory(available);
+
+                _position += count;
+                output = output[count..];
+            }
+        }
+
+        /// <summary>
+        /// Mixes fresh operating system entropy into the key and discards any 
+        /// buffered output
+        /// </summary>
+        /// <exception cref="ObjectDisposedException"></exception>
+        public void Reseed()
+        {
+            ObjectDisposedException.ThrowIf(_disposed, this);
+
+            Span<byte> entropy = stackalloc byte[SeedSize];
+            RandomNumberGenerator.Fill(entropy);
+
+            for (int i = 0; i < _key.Length; i++)
+            {
+                _key[i] ^= BinaryPrimitives.ReadUInt32LittleEndian(entropy[(i * sizeof(uint))..]);
+            }
+
+            CryptographicOperations.ZeroMemory(entropy);
+            CryptographicOperations.ZeroMemory(_buffer);
+
+            _position = BUFFER_SIZE;
+            _sinceReseed = 0;
+            _reseedAt = Environment.TickCount64 + RESEED_PERIOD_MS;
+        }
+
+        private void Refill()
+        {
+            if (ReseedInterval > 0 && (_sinceReseed >= ReseedInterval || Environment.TickCount64 >= _reseedAt))
+            {
+                Reseed();
+            }
+
+            for (int i = 0; i < BUFFER_BLOCKS; i++)
+            {
+                Block(_key, (uint)i, _buffer.AsSpan(i * BLOCK_SIZE, BLOCK_SIZE));
+            }
+
+            //Fast key erasure, the first 32 bytes of output become the next key
+            for (int i = 0; i < _key.Length; i++)
+            {
+                _key[i] = BinaryPrimitives.ReadUInt32LittleEndian(_buffer.AsSpan(i * sizeof(uint)));
+            }
+
+            CryptographicOperations.ZeroMemory(_buffer.AsSpan(0, SeedSize));
+
+            _position = SeedSize;
+            _sinceReseed += BUFFER_SIZE - SeedSize;
+        }
+
+        /*
+         * RFC 8439 block function with a zero nonce. The key changes on every
+         * refill so the counter never needs more than the block index.
+         */
+        private static void Block(ReadOnlySpan<uint> key, uint counter, Span<byte> output)
+        {
+            uint x0 = SIGMA0, x1 = SIGMA1, x2 = SIGMA2, x3 = SIGMA3;
+            uint x4 = key[0], x5 = key[1], x6 = key[2], x7 = key[3];
+            uint x8 = key[4], x9 = key[5], x10 = key[6], x11 = key[7];
+            uint x12 = counter, x13 = 0, x14 = 0, x15 = 0;
+
+            for (int i = 0; i < 10; i++)
+            {
+                //Column rounds
+                QuarterRound(ref x0, ref x4, ref x8, ref x12);
+                QuarterRound(ref x1, ref x5, ref x9, ref x13);
+                QuarterRound(ref x2, ref x6, ref x10, ref x14);
+                QuarterRound(ref x3, ref x7, ref x11, ref x15);
+
+                //Diagonal rounds
+                QuarterRound(ref x0, ref x5, ref x10, ref x15);
+                QuarterRound(ref x1, ref x6, ref x11, ref x12);
+                QuarterRound(ref x2, ref x7, ref x8, ref x13);
+                QuarterRound(ref x3, ref x4, ref x9, ref x14);
+            }
+
+            BinaryPrimitives.WriteUInt32LittleEndian(output, x0 + SIGMA0);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[4..], x1 + SIGMA1);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[8..], x2 + SIGMA2);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[12..], x3 + SIGMA3);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[16..], x4 + key[0]);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[20..], x5 + key[1]);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[24..], x6 + key[2]);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[28..], x7 + key[3]);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[32..], x8 + key[4]);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[36..], x9 + key[5]);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[40..], x10 + key[6]);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[44..], x11 + key[7]);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[48..], x12 + counter);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[52..], x13);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[56..], x14);
+            BinaryPrimitives.WriteUInt32LittleEndian(output[60..], x15);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static void QuarterRound(ref uint a, ref uint b, ref uint c, ref uint d)
+        {
+            a += b; d = BitOperations.RotateLeft(d ^ a, 16);
+            c += d; b = BitOperations.RotateLeft(b ^ c, 12);
+            a += b; d = BitOperations.RotateLeft(d ^ a, 8);
+            c += d; b = BitOperations.RotateLeft(b ^ c, 7);
+        }
+
+        ///<inheritdoc/>
+        public void Dispose()
+        {
+            if (!_disposed)
+            {
+                CryptographicOperations.ZeroMemory(_buffer);
+                Array.Clear(_key);
+                _disposed = true;
+            }
+        }
+    }
+}
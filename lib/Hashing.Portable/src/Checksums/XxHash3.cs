@@ -0,0 +1,713 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: XxHash3.cs 
+*
+* XxHash3.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Numerics;
+using System.Buffers.Binary;
+using System.Runtime.Intrinsics;
+using System.Runtime.Intrinsics.X86;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace VNLib.Hashing.Checksums
+{
+    /// <summary>
+    /// A managed implementation of the XXH3 64-bit and 128-bit non cryptographic hash 
+    /// algorithms. Long inputs are processed with AVX2 or SSE2 when the hardware supports it.
+    /// </summary>
+    /// <remarks>
+    /// Produces the same digests as the reference xxHash library version 0.8. See 
+    /// <see cref="XxHash3State"/> for hashing data that arrives in segments.
+    /// </remarks>
+    public static class XxHash3
+    {
+        /*
+         * Constants and algorithm taken from the reference implementation
+         * https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+         */
+
+        internal const uint PRIME32_1 = 0x9E3779B1U;
+        internal const uint PRIME32_2 = 0x85EBCA77U;
+        internal const uint PRIME32_3 = 0xC2B2AE3DU;
+        internal const ulong PRIME64_1 = 0x9E3779B185EBCA87UL;
+        internal const ulong PRIME64_2 = 0xC2B2AE3D27D4EB4FUL;
+        internal const ulong PRIME64_3 = 0x165667B19E3779F9UL;
+        internal const ulong PRIME64_4 = 0x85EBCA77C2B2AE63UL;
+        internal const ulong PRIME64_5 = 0x27D4EB2F165667C5UL;
+        internal const ulong PRIME_MX1 = 0x165667919E3779F9UL;
+        internal const ulong PRIME_MX2 = 0x9FB21C651E98DF25UL;
+
+        internal const int STRIPE_LEN = 64;
+        internal const int SECRET_CONSUME_RATE = 8;
+        internal const int ACC_NB = 8;
+        internal const int SECRET_SIZE = 192;
+        internal const int STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+        internal const int BLOCK_LEN = STRIPE_LEN * STRIPES_PER_BLOCK;
+        internal const int MIDSIZE_MAX = 240;
+
+        const int SECRET_SIZE_MIN = 136;
+        const int MIDSIZE_STARTOFFSET = 3;
+        const int MIDSIZE_LASTOFFSET = 17;
+        const int SECRET_LASTACC_START = 7;
+        const int SECRET_MERGEACCS_START = 11;
+
+        internal static ReadOnlySpan<byte> DefaultSecret =>
+        [
+            0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+            0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+            0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+            0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+            0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+            0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+            0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+            0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+            0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+            0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+            0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+            0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+        ];
+
+        /// <summary>
+        /// Computes the XXH3 64-bit hash of the input data
+        /// </summary>
+        /// <param name="data">A managed pointer to the first byte of the sequence to compute</param>
+        /// <param name="length">A platform specific integer representing the length of the input data</param>
+        /// <param name="seed">An optional seed value, 0 is the default</param>
+        /// <returns>The 64bit unsigned integer representing the message digest</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <remarks>
+        /// WARNING: This function produces a non-cryptographic hash and should not be used for
+        /// security or cryptographic purposes. It is intended for fast data integrity checks
+        /// </remarks>
+        public static ulong Compute64(ref byte data, nuint length, ulong seed = 0)
+        {
+            if (Unsafe.IsNullRef(ref data) && length > 0)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+
+            ref byte secret = ref MemoryMarshal.GetReference(DefaultSecret);
+
+            if (length <= MIDSIZE_MAX)
+            {
+                return Short64(ref data, length, ref secret, seed);
+            }
+
+            Span<ulong> acc = stackalloc ulong[ACC_NB];
+
+            if (seed != 0)
+            {
+                //Long inputs mix the seed into a derived secret instead of the input
+                Span<byte> customSecret = stackalloc byte[SECRET_SIZE];
+                InitCustomSecret(customSecret, seed);
+
+                ref byte cs = ref MemoryMarshal.GetReference(customSecret);
+                HashLong(ref MemoryMarshal.GetReference(acc), ref data, length, ref cs);
+                return MergeAccs(ref MemoryMarshal.GetReference(acc), ref Unsafe.Add(ref cs, SECRET_MERGEACCS_START), length * PRIME64_1);
+            }
+
+            HashLong(ref MemoryMarshal.GetReference(acc), ref data, length, ref secret);
+            return MergeAccs(ref MemoryMarshal.GetReference(acc), ref Unsafe.Add(ref secret, SECRET_MERGEACCS_START), length * PRIME64_1);
+        }
+
+        /// <summary>
+        /// Computes the XXH3 64-bit hash of the input data
+        /// </summary>
+        /// <param name="data">A span structure pointing to the memory block to compute the digest of</param>
+        /// <param name="seed">An optional seed value, 0 is the default</param>
+        /// <returns>The 64bit unsigned integer representing the message digest</returns>
+        /// <remarks>
+        /// WARNING: This function produces a non-cryptographic hash and should not be used for
+        /// security or cryptographic purposes. It is intended for fast data integrity checks
+        /// </remarks>
+        public static ulong Compute64(ReadOnlySpan<byte> data, ulong seed = 0)
+        {
+            //Empty spans may have a null reference, so point at the secret instead, it is never read
+            ref byte r0 = ref data.IsEmpty 
+                ? ref MemoryMarshal.GetReference(DefaultSecret) 
+                : ref MemoryMarshal.GetReference(data);
+
+            return Compute64(ref r0, (nuint)data.Length, seed);
+        }
+
+        /// <summary>
+        /// Computes the XXH3 128-bit hash of the input data
+        /// </summary>
+        /// <param name="data">A managed pointer to the first byte of the sequence to compute</param>
+        /// <param name="length">A platform specific integer representing the length of the input data</param>
+        /// <param name="seed">An optional seed value, 0 is the default</param>
+        /// <returns>The 128bit unsigned integer representing the message digest</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <remarks>
+        /// WARNING: This function produces a non-cryptographic hash and should not be used for
+        /// security or cryptographic purposes. It is intended for fast data integrity checks
+        /// </remarks>
+        public static UInt128 Compute128(ref byte data, nuint length, ulong seed = 0)
+        {
+            if (Unsafe.IsNullRef(ref data) && length > 0)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+
+            ref byte secret = ref MemoryMarshal.GetReference(DefaultSecret);
+
+            if (length <= MIDSIZE_MAX)
+            {
+                return Short128(ref data, length, ref secret, seed);
+            }
+
+            Span<ulong> acc = stackalloc ulong[ACC_NB];
+
+            if (seed != 0)
+            {
+                Span<byte> customSecret = stackalloc byte[SECRET_SIZE];
+                InitCustomSecret(customSecret, seed);
+
+                ref byte cs = ref MemoryMarshal.GetReference(customSecret);
+                HashLong(ref MemoryMarshal.GetReference(acc), ref data, length, ref cs);
+                return Long128Merge(ref MemoryMarshal.GetReference(acc), ref cs, length);
+            }
+
+            HashLong(ref MemoryMarshal.GetReference(acc), ref data, length, ref secret);
+            return Long128Merge(ref MemoryMarshal.GetReference(acc), ref secret, length);
+        }
+
+        /// <summary>
+        /// Computes the XXH3 128-bit hash of the input data
+        /// </summary>
+        /// <param name="data">A span structure pointing to the memory block to compute the digest of</param>
+        /// <param name="seed">An optional seed value, 0 is the default</param>
+        /// <returns>The 128bit unsigned integer representing the message digest</returns>
+        /// <remarks>
+        /// WARNING: This function produces a non-cryptographic hash and should not be used for
+        /// security or cryptographic purposes. It is intended for fast data integrity checks
+        /// </remarks>
+        public static UInt128 Compute128(ReadOnlySpan<byte> data, ulong seed = 0)
+        {
+            ref byte r0 = ref data.IsEmpty
+                ? ref MemoryMarshal.GetReference(DefaultSecret)
+                : ref MemoryMarshal.GetReference(data);
+
+            return Compute128(ref r0, (nuint)data.Length, seed);
+        }
+
+        #region Short inputs
+
+        internal static ulong Short64(ref byte input, nuint len, ref byte secret, ulong seed)
+        {
+            if (len <= 16)
+            {
+                return Len0To16_64(ref input, len, ref secret, seed);
+            }
+
+            if (len <= 128)
+            {
+                ulong acc = len * PRIME64_1;
+
+                if (len > 32)
+                {
+                    if (len > 64)
+                    {
+                        if (len > 96)
+                        {
+                            acc += Mix16B(ref Unsafe.Add(ref input, 48), ref Unsafe.Add(ref secret, 96), seed);
+                            acc += Mix16B(ref Unsafe.Add(ref input, len - 64), ref Unsafe.Add(ref secret, 112), seed);
+                        }
+
+                        acc += Mix16B(ref Unsafe.Add(ref input, 32), ref Unsafe.Add(ref secret, 64), seed);
+                        acc += Mix16B(ref Unsafe.Add(ref input, len - 48), ref Unsafe.Add(ref secret, 80), seed);
+                    }
+
+                    acc += Mix16B(ref Unsafe.Add(ref input, 16), ref Unsafe.Add(ref secret, 32), seed);
+                    acc += Mix16B(ref Unsafe.Add(ref input, len - 32), ref Unsafe.Add(ref secret, 48), seed);
+                }
+
+                acc += Mix16B(ref input, ref secret, seed);
+                acc += Mix16B(ref Unsafe.Add(ref input, len - 16), ref Unsafe.Add(ref secret, 16), seed);
+
+                return Avalanche(acc);
+            }
+            else
+            {
+                ulong acc = len * PRIME64_1;
+                nuint nbRounds = len / 16;
+
+                for (nuint i = 0; i < 8; i++)
+                {
+                    acc += Mix16B(ref Unsafe.Add(ref input, 16 * i), ref Unsafe.Add(ref secret, 16 * i), seed);
+                }
+
+                //The last 16 bytes are mixed separately so the rounds are independent
+                ulong accEnd = Mix16B(ref Unsafe.Add(ref input, len - 16), ref Unsafe.Add(ref secret, SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET), seed);
+                acc = Avalanche(acc);
+
+                for (nuint i = 8; i < nbRounds; i++)
+                {
+                    accEnd += Mix16B(ref Unsafe.Add(ref input, 16 * i), ref Unsafe.Add(ref secret, 16 * (i - 8) + MIDSIZE_STARTOFFSET), seed);
+                }
+
+                return Avalanche(acc + accEnd);
+            }
+        }
+
+        private static ulong Len0To16_64(ref byte input, nuint len, ref byte secret, ulong seed)
+        {
+            if (len > 8)
+            {
+                ulong bitflip1 = (ReadLE64(ref secret, 24) ^ ReadLE64(ref secret, 32)) + seed;
+                ulong bitflip2 = (ReadLE64(ref secret, 40) ^ ReadLE64(ref secret, 48)) - seed;
+                ulong inputLo = ReadLE64(ref input, 0) ^ bitflip1;
+                ulong inputHi = ReadLE64(ref input, len - 8) ^ bitflip2;
+                ulong acc = len + BinaryPrimitives.ReverseEndianness(inputLo) + inputHi + Mul128Fold64(inputLo, inputHi);
+                return Avalanche(acc);
+            }
+
+            if (len >= 4)
+            {
+                seed ^= (ulong)BinaryPrimitives.ReverseEndianness((uint)seed) << 32;
+                ulong input1 = ReadLE32(ref input, 0);
+                ulong input2 = ReadLE32(ref input, len - 4);
+                ulong bitflip = (ReadLE64(ref secret, 8) ^ ReadLE64(ref secret, 16)) - seed;
+                ulong keyed = (input2 + (input1 << 32)) ^ bitflip;
+                return RrMxMx(keyed, len);
+            }
+
+            if (len > 0)
+            {
+                uint c1 = input;
+                uint c2 = Unsafe.Add(ref input, len >> 1);
+                uint c3 = Unsafe.Add(ref input, len - 1);
+                uint combined = (c1 << 16) | (c2 << 24) | c3 | ((uint)len << 8);
+                ulong bitflip = (ReadLE32(ref secret, 0) ^ ReadLE32(ref secret, 4)) + seed;
+                return XXH64Avalanche(combined ^ bitflip);
+            }
+
+            return XXH64Avalanche(seed ^ ReadLE64(ref secret, 56) ^ ReadLE64(ref secret, 64));
+        }
+
+        internal static UInt128 Short128(ref byte input, nuint len, ref byte secret, ulong seed)
+        {
+            if (len <= 16)
+            {
+                return Len0To16_128(ref input, len, ref secret, seed);
+            }
+
+            ulong accLo = len * PRIME64_1, accHi = 0;
+
+            if (len <= 128)
+            {
+                if (len > 32)
+                {
+                    if (len > 64)
+                    {
+                        if (len > 96)
+                        {
+                            Mix32B(ref accLo, ref accHi, ref Unsafe.Add(ref input, 48), ref Unsafe.Add(ref input, len - 64), ref Unsafe.Add(ref secret, 96), seed);
+                        }
+
+                        Mix32B(ref accLo, ref accHi, ref Unsafe.Add(ref input, 32), ref Unsafe.Add(ref input, len - 48), ref Unsafe.Add(ref secret, 64), seed);
+                    }
+
+                    Mix32B(ref accLo, ref accHi, ref Unsafe.Add(ref input, 16), ref Unsafe.Add(ref input, len - 32), ref Unsafe.Add(ref secret, 32), seed);
+                }
+
+                Mix32B(ref accLo, ref accHi, ref input, ref Unsafe.Add(ref input, len - 16), ref secret, seed);
+            }
+            else
+            {
+                nuint nbRounds = len / 32;
+
+                for (nuint i = 0; i < 4; i++)
+                {
+                    Mix32B(ref accLo, ref accHi, ref Unsafe.Add(ref input, 32 * i), ref Unsafe.Add(ref input, 32 * i + 16), ref Unsafe.Add(ref secret, 32 * i), seed);
+                }
+
+                accLo = Avalanche(accLo);
+                accHi = Avalanche(accHi);
+
+                for (nuint i = 4; i < nbRounds; i++)
+                {
+                    Mix32B(
+                        ref accLo, 
+                        ref accHi, 
+                        ref Unsafe.Add(ref input, 32 * i), 
+                        ref Unsafe.Add(ref input, 32 * i + 16), 
+                        ref Unsafe.Add(ref secret, MIDSIZE_STARTOFFSET + 32 * (i - 4)), 
+                        seed
+                    );
+                }
+
+                //Last 32 bytes
+                Mix32B(
+                    ref accLo, 
+                    ref accHi, 
+                    ref Unsafe.Add(ref input, len - 16), 
+                    ref Unsafe.Add(ref input, len - 32), 
+                    ref Unsafe.Add(ref secret, SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET - 16), 
+                    0UL - seed
+                );
+            }
+
+            ulong low = accLo + accHi;
+            ulong high = (accLo * PRIME64_1) + (accHi * PRIME64_4) + ((len - seed) * PRIME64_2);
+
+            return new UInt128(0UL - Avalanche(high), Avalanche(low));
+        }
+
+        private static UInt128 Len0To16_128(ref byte input, nuint len, ref byte secret, ulong seed)
+        {
+            if (len > 8)
+            {
+                ulong bitflipl = (ReadLE64(ref secret, 32) ^ ReadLE64(ref secret, 40)) - seed;
+                ulong bitfliph = (ReadLE64(ref secret, 48) ^ ReadLE64(ref secret, 56)) + seed;
+                ulong inputLo = ReadLE64(ref input, 0);
+                ulong inputHi = ReadLE64(ref input, len - 8);
+
+                ulong mHi = Math.BigMul(inputLo ^ inputHi ^ bitflipl, PRIME64_1, out ulong mLo);
+
+                mLo += (ulong)(len - 1) << 54;
+                inputHi ^= bitfliph;
+                mHi += inputHi + ((ulong)(uint)inputHi * (PRIME32_2 - 1));
+                mLo ^= BinaryPrimitives.ReverseEndianness(mHi);
+
+                ulong hHi = Math.BigMul(mLo, PRIME64_2, out ulong hLo);
+                hHi += mHi * PRIME64_2;
+
+                return new UInt128(Avalanche(hHi), Avalanche(hLo));
+            }
+
+            if (len >= 4)
+            {
+                seed ^= (ulong)BinaryPrimitives.ReverseEndianness((uint)seed) << 32;
+                ulong inputLo = ReadLE32(ref input, 0);
+                ulong inputHi = ReadLE32(ref input, len - 4);
+                ulong bitflip = (ReadLE64(ref secret, 16) ^ ReadLE64(ref secret, 24)) + seed;
+                ulong keyed = (inputLo + (inputHi << 32)) ^ bitflip;
+
+                ulong mHi = Math.BigMul(keyed, PRIME64_1 + ((ulong)len << 2), out ulong mLo);
+
+                mHi += mLo << 1;
+                mLo ^= mHi >> 3;
+                mLo ^= mLo >> 35;
+                mLo *= PRIME_MX2;
+                mLo ^= mLo >> 28;
+
+                return new UInt128(Avalanche(mHi), mLo);
+            }
+
+            if (len > 0)
+            {
+                uint c1 = input;
+                uint c2 = Unsafe.Add(ref input, len >> 1);
+                uint c3 = Unsafe.Add(ref input, len - 1);
+                uint combinedl = (c1 << 16) | (c2 << 24) | c3 | ((uint)len << 8);
+                uint combinedh = BitOperations.RotateLeft(BinaryPrimitives.ReverseEndianness(combinedl), 13);
+                ulong bitflipl = (ReadLE32(ref secret, 0) ^ ReadLE32(ref secret, 4)) + seed;
+                ulong bitfliph = (ReadLE32(ref secret, 8) ^ ReadLE32(ref secret, 12)) - seed;
+
+                return new UInt128(XXH64Avalanche(combinedh ^ bitfliph), XXH64Avalanche(combinedl ^ bitflipl));
+            }
+
+            return new UInt128(
+                XXH64Avalanche(seed ^ ReadLE64(ref secret, 80) ^ ReadLE64(ref secret, 88)),
+                XXH64Avalanche(seed ^ ReadLE64(ref secret, 64) ^ ReadLE64(ref secret, 72))
+            );
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static ulong Mix16B(ref byte input, ref byte secret, ulong seed)
+        {
+            return Mul128Fold64(
+                ReadLE64(ref input, 0) ^ (ReadLE64(ref secret, 0) + seed),
+                ReadLE64(ref input, 8) ^ (ReadLE64(ref secret, 8) - seed)
+            );
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static void Mix32B(ref ulong accLo, ref ulong accHi, ref byte input1, ref byte input2, ref byte secret, ulong seed)
+        {
+            accLo += Mix16B(ref input1, ref secret, seed);
+            accLo ^= ReadLE64(ref input2, 0) + ReadLE64(ref input2, 8);
+            accHi += Mix16B(ref input2, ref Unsafe.Add(ref secret, 16), seed);
+            accHi ^= ReadLE64(ref input1, 0) + ReadLE64(ref input1, 8);
+        }
+
+        #endregion
+
+        #region Long inputs
+
+        internal static void InitCustomSecret(Span<byte> customSecret, ulong seed)
+        {
+            ReadOnlySpan<byte> secret = DefaultSecret;
+
+            for (int i = 0; i < SECRET_SIZE; i += 16)
+            {
+                BinaryPrimitives.WriteUInt64LittleEndian(customSecret[i..], BinaryPrimitives.ReadUInt64LittleEndian(secret[i..]) + seed);
+                BinaryPrimitives.WriteUInt64LittleEndian(customSecret[(i + 8)..], BinaryPrimitives.ReadUInt64LittleEndian(secret[(i + 8)..]) - seed);
+            }
+        }
+
+        internal static void InitAcc(ref ulong acc)
+        {
+            Unsafe.Add(ref acc, 0) = PRIME32_3;
+            Unsafe.Add(ref acc, 1) = PRIME64_1;
+            Unsafe.Add(ref acc, 2) = PRIME64_2;
+            Unsafe.Add(ref acc, 3) = PRIME64_3;
+            Unsafe.Add(ref acc, 4) = PRIME64_4;
+            Unsafe.Add(ref acc, 5) = PRIME32_2;
+            Unsafe.Add(ref acc, 6) = PRIME64_5;
+            Unsafe.Add(ref acc, 7) = PRIME32_1;
+        }
+
+        private static void HashLong(ref ulong acc, ref byte input, nuint len, ref byte secret)
+        {
+            InitAcc(ref acc);
+
+            nuint nbBlocks = (len - 1) / BLOCK_LEN;
+
+            for (nuint n = 0; n < nbBlocks; n++)
+            {
+                Accumulate(ref acc, ref Unsafe.Add(ref input, n * BLOCK_LEN), ref secret, STRIPES_PER_BLOCK);
+                ScrambleAcc(ref acc, ref Unsafe.Add(ref secret, SECRET_SIZE - STRIPE_LEN));
+            }
+
+            //Partial last block, always leaves at least one byte for the last stripe
+            nuint nbStripes = ((len - 1) - (BLOCK_LEN * nbBlocks)) / STRIPE_LEN;
+            Accumulate(ref acc, ref Unsafe.Add(ref input, nbBlocks * BLOCK_LEN), ref secret, nbStripes);
+
+            AccumulateLastStripe(ref acc, ref Unsafe.Add(ref input, len - STRIPE_LEN), ref secret);
+        }
+
+        internal static void AccumulateLastStripe(ref ulong acc, ref byte lastStripe, ref byte secret) 
+            => Accumulate(ref acc, ref lastStripe, ref Unsafe.Add(ref secret, SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START), 1);
+
+        internal static ulong MergeAccs(ref ulong acc, ref byte secret, ulong start)
+        {
+            ulong result = start;
+
+            for (int i = 0; i < 4; i++)
+            {
+                result += Mul128Fold64(
+                    Unsafe.Add(ref acc, 2 * i) ^ ReadLE64(ref secret, (nuint)(16 * i)),
+                    Unsafe.Add(ref acc, 2 * i + 1) ^ ReadLE64(ref secret, (nuint)(16 * i + 8))
+                );
+            }
+
+            return Avalanche(result);
+        }
+
+        internal static UInt128 Long128Merge(ref ulong acc, ref byte secret, nuint len)
+        {
+            ulong low = MergeAccs(ref acc, ref Unsafe.Add(ref secret, SECRET_MERGEACCS_START), len * PRIME64_1);
+            ulong high = MergeAccs(ref acc, ref Unsafe.Add(ref secret, SECRET_SIZE - STRIPE_LEN - SECRET_MERGEACCS_START), ~(len * PRIME64_2));
+            return new UInt128(high, low);
+        }
+
+        /*
+         * The accumulator loop is where long inputs spend nearly all of their time. 
+         * The accumulators are held in vector registers for all stripes, the 32x32->64
+         * multiply maps directly to pmuludq on x86. Other platforms use the scalar loop.
+         */
+        internal static void Accumulate(ref ulong acc, ref byte input, ref byte secret, nuint nbStripes)
+        {
+            if (Avx2.IsSupported)
+            {
+                Vector256<ulong> a0 = Vector256.LoadUnsafe(ref acc);
+                Vector256<ulong> a1 = Vector256.LoadUnsafe(ref acc, 4);
+
+                for (nuint n = 0; n < nbStripes; n++)
+                {
+                    ref byte inp = ref Unsafe.Add(ref input, n * STRIPE_LEN);
+                    ref byte sec = ref Unsafe.Add(ref secret, n * SECRET_CONSUME_RATE);
+
+                    a0 = Accumulate256(a0, Vector256.LoadUnsafe(ref inp).AsUInt64(), Vector256.LoadUnsafe(ref sec).AsUInt64());
+                    a1 = Accumulate256(a1, Vector256.LoadUnsafe(ref inp, 32).AsUInt64(), Vector256.LoadUnsafe(ref sec, 32).AsUInt64());
+                }
+
+                a0.StoreUnsafe(ref acc);
+                a1.StoreUnsafe(ref acc, 4);
+            }
+            else if (Sse2.IsSupported)
+            {
+                Vector128<ulong> a0 = Vector128.LoadUnsafe(ref acc);
+                Vector128<ulong> a1 = Vector128.LoadUnsafe(ref acc, 2);
+                Vector128<ulong> a2 = Vector128.LoadUnsafe(ref acc, 4);
+                Vector128<ulong> a3 = Vector128.LoadUnsafe(ref acc, 6);
+
+                for (nuint n = 0; n < nbStripes; n++)
+                {
+                    ref byte inp = ref Unsafe.Add(ref input, n * STRIPE_LEN);
+                    ref byte sec = ref Unsafe.Add(ref secret, n * SECRET_CONSUME_RATE);
+
+                    a0 = Accumulate128(a0, Vector128.LoadUnsafe(ref inp).AsUInt64(), Vector128.LoadUnsafe(ref sec).AsUInt64());
+                    a1 = Accumulate128(a1, Vector128.LoadUnsafe(ref inp, 16).AsUInt64(), Vector128.LoadUnsafe(ref sec, 16).AsUInt64());
+                    a2 = Accumulate128(a2, Vector128.LoadUnsafe(ref inp, 32).AsUInt64(), Vector128.LoadUnsafe(ref sec, 32).AsUInt64());
+                    a3 = Accumulate128(a3, Vector128.LoadUnsafe(ref inp, 48).AsUInt64(), Vector128.LoadUnsafe(ref sec, 48).AsUInt64());
+                }
+
+                a0.StoreUnsafe(ref acc);
+                a1.StoreUnsafe(ref acc, 2);
+                a2.StoreUnsafe(ref acc, 4);
+                a3.StoreUnsafe(ref acc, 6);
+            }
+            else
+            {
+                for (nuint n = 0; n < nbStripes; n++)
+                {
+                    ref byte inp = ref Unsafe.Add(ref input, n * STRIPE_LEN);
+                    ref byte sec = ref Unsafe.Add(ref secret, n * SECRET_CONSUME_RATE);
+
+                    for (nuint i = 0; i < ACC_NB; i++)
+                    {
+                        ulong dataVal = ReadLE64(ref inp, 8 * i);
+                        ulong dataKey = dataVal ^ ReadLE64(ref sec, 8 * i);
+
+                        Unsafe.Add(ref acc, i ^ 1) += dataVal;
+                        Unsafe.Add(ref acc, i) += (uint)dataKey * (dataKey >> 32);
+                    }
+                }
+            }
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static Vector256<ulong> Accumulate256(Vector256<ulong> acc, Vector256<ulong> data, Vector256<ulong> key)
+        {
+            Vector256<ulong> dataKey = data ^ key;
+            Vector256<ulong> product = Avx2.Multiply(dataKey.AsUInt32(), Avx2.ShiftRightLogical(dataKey, 32).AsUInt32());
+
+            //Swap the 64bit halves of each 128bit lane, data is added to the neighbouring accumulator
+            Vector256<ulong> swapped = Avx2.Shuffle(data.AsUInt32(), 0b_01_00_11_10).AsUInt64();
+
+            return acc + product + swapped;
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static Vector128<ulong> Accumulate128(Vector128<ulong> acc, Vector128<ulong> data, Vector128<ulong> key)
+        {
+            Vector128<ulong> dataKey = data ^ key;
+            Vector128<ulong> product = Sse2.Multiply(dataKey.AsUInt32(), Sse2.ShiftRightLogical(dataKey, 32).AsUInt32());
+            Vector128<ulong> swapped = Sse2.Shuffle(data.AsUInt32(), 0b_01_00_11_10).AsUInt64();
+
+            return acc + product + swapped;
+        }
+
+        internal static void ScrambleAcc(ref ulong acc, ref byte secret)
+        {
+            if (Avx2.IsSupported)
+            {
+                Vector256<uint> prime = Vector256.Create(PRIME32_1);
+
+                for (nuint i = 0; i < ACC_NB; i += 4)
+                {
+                    Vector256<ulong> a = Vector256.LoadUnsafe(ref acc, i);
+                    a ^= Avx2.ShiftRightLogical(a, 47);
+                    a ^= Vector256.LoadUnsafe(ref secret, i * 8).AsUInt64();
+
+                    //64x32 multiply from two 32x32->64 products
+                    Vector256<ulong> lo = Avx2.Multiply(a.AsUInt32(), prime);
+                    Vector256<ulong> hi = Avx2.Multiply(Avx2.ShiftRightLogical(a, 32).AsUInt32(), prime);
+
+                    (lo + Avx2.ShiftLeftLogical(hi, 32)).StoreUnsafe(ref acc, i);
+                }
+            }
+            else if (Sse2.IsSupported)
+            {
+                Vector128<uint> prime = Vector128.Create(PRIME32_1);
+
+                for (nuint i = 0; i < ACC_NB; i += 2)
+                {
+                    Vector128<ulong> a = Vector128.LoadUnsafe(ref acc, i);
+                    a ^= Sse2.ShiftRightLogical(a, 47);
+                    a ^= Vector128.LoadUnsafe(ref secret, i * 8).AsUInt64();
+
+                    Vector128<ulong> lo = Sse2.Multiply(a.AsUInt32(), prime);
+                    Vector128<ulong> hi = Sse2.Multiply(Sse2.ShiftRightLogical(a, 32).AsUInt32(), prime);
+
+                    (lo + Sse2.ShiftLeftLogical(hi, 32)).StoreUnsafe(ref acc, i);
+                }
+            }
+            else
+            {
+                for (nuint i = 0; i < ACC_NB; i++)
+                {
+                    ulong a = Unsafe.Add(ref acc, i);
+                    a ^= a >> 47;
+                    a ^= ReadLE64(ref secret, 8 * i);
+                    Unsafe.Add(ref acc, i) = a * PRIME32_1;
+                }
+            }
+        }
+
+        #endregion
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static ulong ReadLE64(ref byte p, nuint offset)
+        {
+            ulong v = Unsafe.ReadUnaligned<ulong>(ref Unsafe.Add(ref p, offset));
+            return BitConverter.IsLittleEndian ? v : BinaryPrimitives.ReverseEndianness(v);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static uint ReadLE32(ref byte p, nuint offset)
+        {
+            uint v = Unsafe.ReadUnaligned<uint>(ref Unsafe.Add(ref p, offset));
+            return BitConverter.IsLittleEndian ? v : BinaryPrimitives.ReverseEndianness(v);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static ulong Mul128Fold64(ulong lhs, ulong rhs)
+        {
+            ulong high = Math.BigMul(lhs, rhs, out ulong low);
+            return low ^ high;
+        }
+
+        private static ulong XXH64Avalanche(ulong h)
+        {
+            h ^= h >> 33;
+            h *= PRIME64_2;
+            h ^= h >> 29;
+            h *= PRIME64_3;
+            h ^= h >> 32;
+            return h;
+        }
+
+        private static ulong Avalanche(ulong h)
+        {
+            h ^= h >> 37;
+            h *= PRIME_MX1;
+            h ^= h >> 32;
+            return h;
+        }
+
+        private static ulong RrMxMx(ulong h, nuint len)
+        {
+            h ^= BitOperations.RotateLeft(h, 49) ^ BitOperations.RotateLeft(h, 24);
+            h *= PRIME_MX2;
+            h ^= (h >> 35) + len;
+            h *= PRIME_MX2;
+            h ^= h >> 28;
+            return h;
+        }
+    }
+}
@@ -0,0 +1,282 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: XxHash3State.cs 
+*
+* XxHash3State.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Diagnostics.CodeAnalysis;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+using static VNLib.Hashing.Checksums.XxHash3;
+
+namespace VNLib.Hashing.Checksums
+{
+    /// <summary>
+    /// Holds the state of an incremental XXH3 hash computation. Data may be added
+    /// in segments of any size and the digest will match <see cref="XxHash3.Compute64(ReadOnlySpan{byte}, ulong)"/>
+    /// or <see cref="XxHash3.Compute128(ReadOnlySpan{byte}, ulong)"/> over the same data.
+    /// </summary>
+    /// <remarks>
+    /// The state is a mutable value type that lives inline, it must be passed by reference. 
+    /// A default instance is a valid state with a seed of 0.
+    /// </remarks>
+    public struct XxHash3State
+    {
+        const int BUFFER_SIZE = 256;
+        const int BUFFER_STRIPES = BUFFER_SIZE / STRIPE_LEN;
+
+        private AccBuffer _acc;
+        private InputBuffer _buffer;
+        private SecretBuffer _customSecret;
+        private ulong _seed;
+        private ulong _totalLength;
+        private int _bufferedSize;
+        private int _stripesSoFar;
+        private bool _accInitialized;
+
+        /// <summary>
+        /// The total number of bytes that have been added to the state
+        /// </summary>
+        public readonly ulong TotalLength => _totalLength;
+
+        /// <summary>
+        /// Creates a new state initialized with the given seed
+        /// </summary>
+        /// <param name="seed">The seed value, 0 is the default</param>
+        /// <returns>The initialized hash state</returns>
+        public static XxHash3State Create(ulong seed = 0)
+        {
+            XxHash3State state = default;
+            state.Reset(seed);
+            return state;
+        }
+
+        /// <summary>
+        /// Resets the state so a new hash may be computed with the given seed
+        /// </summary>
+        /// <param name="seed">The seed value, 0 is the default</param>
+        public void Reset(ulong seed = 0)
+        {
+            _seed = seed;
+            _totalLength = 0;
+            _bufferedSize = 0;
+            _stripesSoFar = 0;
+            _accInitialized = false;
+
+            if (seed != 0)
+            {
+                InitCustomSecret(_customSecret, seed);
+            }
+        }
+
+        /// <summary>
+        /// Adds the data to the hash state
+        /// </summary>
+        /// <param name="data">The data to add</param>
+        public void Update(ReadOnlySpan<byte> data)
+        {
+            _totalLength += (ulong)data.Length;
+
+            Span<byte> buffer = _buffer;
+
+            //Buffer small inputs, they may end up hashed by the short input functions
+            if (data.Length <= BUFFER_SIZE - _bufferedSize)
+            {
+                data.CopyTo(buffer[_bufferedSize..]);
+                _bufferedSize += data.Length;
+                return;
+            }
+
+            EnsureAccInitialized();
+
+            ref ulong acc = ref MemoryMarshal.GetReference((Span<ulong>)_acc);
+            ref byte secret = ref GetSecret();
+
+            if (_bufferedSize > 0)
+            {
+                int loadSize = BUFFER_SIZE - _bufferedSize;
+                data[..loadSize].CopyTo(buffer[_bufferedSize..]);
+                data = data[loadSize..];
+
+                ConsumeStripes(ref acc, ref _stripesSoFar, ref MemoryMarshal.GetReference(buffer), BUFFER_STRIPES, ref secret);
+                _bufferedSize = 0;
+            }
+
+            //Hash directly from the input, the last stripe is always kept for the digest
+            if (data.Length > BUFFER_SIZE)
+            {
+                int nbStripes = (data.Length - 1) / STRIPE_LEN;
+
+                ConsumeStripes(ref acc, ref _stripesSoFar, ref MemoryMarshal.GetReference(data), (nuint)nbStripes, ref secret);
+
+                int consumed = nbStripes * STRIPE_LEN;
+                data.Slice(consumed - STRIPE_LEN, STRIPE_LEN).CopyTo(buffer[(BUFFER_SIZE - STRIPE_LEN)..]);
+                data = data[consumed..];
+            }
+
+            data.CopyTo(buffer);
+            _bufferedSize = data.Length;
+        }
+
+        /// <summary>
+        /// Computes the 64-bit digest of all data added so far. The state is not 
+        /// modified and more data may be added afterwards.
+        /// </summary>
+        /// <returns>The 64bit unsigned integer representing the message digest</returns>
+        public ulong Digest64()
+        {
+            Span<byte> buffer = _buffer;
+
+            if (_totalLength <= MIDSIZE_MAX)
+            {
+                return Short64(ref MemoryMarshal.GetReference(buffer), (nuint)_totalLength, ref MemoryMarshal.GetReference(DefaultSecret), _seed);
+            }
+
+            Span<ulong> acc = stackalloc ulong[ACC_NB];
+            DigestLong(acc);
+
+            return MergeAccs(
+                ref MemoryMarshal.GetReference(acc), 
+                ref Unsafe.Add(ref GetSecret(), 11), 
+                _totalLength * PRIME64_1
+            );
+        }
+
+        /// <summary>
+        /// Computes the 128-bit digest of all data added so far. The state is not 
+        /// modified and more data may be added afterwards.
+        /// </summary>
+        /// <returns>The 128bit unsigned integer representing the message digest</returns>
+        public UInt128 Digest128()
+        {
+            Span<byte> buffer = _buffer;
+
+            if (_totalLength <= MIDSIZE_MAX)
+            {
+                return Short128(ref MemoryMarshal.GetReference(buffer), (nuint)_totalLength, ref MemoryMarshal.GetReference(DefaultSecret), _seed);
+            }
+
+            Span<ulong> acc = stackalloc ulong[ACC_NB];
+            DigestLong(acc);
+
+            return Long128Merge(ref MemoryMarshal.GetReference(acc), ref GetSecret(), (nuint)_totalLength);
+        }
+
+        private void DigestLong(Span<ulong> acc)
+        {
+            ref ulong accRef = ref MemoryMarshal.GetReference(acc);
+
+            //Work on a copy so the state can continue to be updated
+            if (_accInitialized)
+            {
+                ((Span<ulong>)_acc).CopyTo(acc);
+            }
+            else
+            {
+                //All input still fits in the buffer, no stripes have been consumed yet
+                InitAcc(ref accRef);
+            }
+
+            ref byte secret = ref GetSecret();
+            Span<byte> buffer = _buffer;
+
+            if (_bufferedSize >= STRIPE_LEN)
+            {
+                int stripesSoFar = _stripesSoFar;
+                nuint nbStripes = (nuint)((_bufferedSize - 1) / STRIPE_LEN);
+
+                ConsumeStripes(ref accRef, ref stripesSoFar, ref MemoryMarshal.GetReference(buffer), nbStripes, ref secret);
+                AccumulateLastStripe(ref accRef, ref buffer[_bufferedSize - STRIPE_LEN], ref secret);
+            }
+            else
+            {
+                //The last stripe overlaps the previously consumed stripe saved at the end of the buffer
+                Span<byte> lastStripe = stackalloc byte[STRIPE_LEN];
+                int catchupSize = STRIPE_LEN - _bufferedSize;
+
+                buffer[(BUFFER_SIZE - catchupSize)..].CopyTo(lastStripe);
+                buffer[.._bufferedSize].CopyTo(lastStripe[catchupSize..]);
+
+                AccumulateLastStripe(ref accRef, ref MemoryMarshal.GetReference(lastStripe), ref secret);
+            }
+        }
+
+        private static void ConsumeStripes(ref ulong acc, ref int stripesSoFar, ref byte input, nuint nbStripes, ref byte secret)
+        {
+            nuint thisIter = (nuint)(STRIPES_PER_BLOCK - stripesSoFar);
+
+            //Scramble each time a full block of stripes has been accumulated
+            while (nbStripes >= thisIter)
+            {
+                Accumulate(ref acc, ref input, ref Unsafe.Add(ref secret, stripesSoFar * SECRET_CONSUME_RATE), thisIter);
+                ScrambleAcc(ref acc, ref Unsafe.Add(ref secret, SECRET_SIZE - STRIPE_LEN));
+
+                input = ref Unsafe.Add(ref input, thisIter * STRIPE_LEN);
+                nbStripes -= thisIter;
+                thisIter = STRIPES_PER_BLOCK;
+                stripesSoFar = 0;
+            }
+
+            if (nbStripes > 0)
+            {
+                Accumulate(ref acc, ref input, ref Unsafe.Add(ref secret, stripesSoFar * SECRET_CONSUME_RATE), nbStripes);
+                stripesSoFar += (int)nbStripes;
+            }
+        }
+
+        private void EnsureAccInitialized()
+        {
+            if (!_accInitialized)
+            {
+                InitAcc(ref MemoryMarshal.GetReference((Span<ulong>)_acc));
+                _accInitialized = true;
+            }
+        }
+
+        [UnscopedRef]
+        private ref byte GetSecret()
+        {
+            return ref _seed == 0
+                ? ref MemoryMarshal.GetReference(DefaultSecret)
+                : ref MemoryMarshal.GetReference((Span<byte>)_customSecret);
+        }
+
+        [InlineArray(ACC_NB)]
+        private struct AccBuffer
+        {
+            private ulong _element0;
+        }
+
+        [InlineArray(BUFFER_SIZE)]
+        private struct InputBuffer
+        {
+            private byte _element0;
+        }
+
+        [InlineArray(SECRET_SIZE)]
+        private struct SecretBuffer
+        {
+            private byte _element0;
+        }
+    }
+}
@@ -88,5 +88,16 @@ namespace VNLib.Hashing
         /// Inspect the value of <see cref="ManagedHash.SupportsBlake2b"/>
         /// </summary>
         BlAKE2B = -MCBlake2Module.MaxHashSize,
+
+        /*
+         * Blake3 is an XOF so the hash size is also variable, the default size is used
+         */
+        /// <summary>
+        /// Defines the BLAKE3 hashing algorithm with a 32 byte output. Keyed hashes (HMAC) 
+        /// require an exactly 32 byte key.
+        /// NOTE: This hashing method may not be supported on all platforms, you should check for support before using it.
+        /// Inspect the value of <see cref="ManagedHash.SupportsBlake3"/>
+        /// </summary>
+        BLAKE3 = -MCBlake3Module.DefaultHashSize,
     }
 }
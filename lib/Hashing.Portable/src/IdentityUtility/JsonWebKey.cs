@@ -29,6 +29,7 @@ using System.Security.Cryptography;
 using VNLib.Utils;
 using VNLib.Utils.Memory;
 using VNLib.Utils.Extensions;
+using VNLib.Hashing.Native.MonoCypher;
 
 namespace VNLib.Hashing.IdentityUtility
 {
@@ -44,6 +45,12 @@ namespace VNLib.Hashing.IdentityUtility
         public const string ES384 = "ES384";
         public const string ES512 = "ES512";
         public const string ES256K = "ES256K";
+
+        /// <summary>
+        /// Edwards-curve signatures over Ed25519 keys (RFC 8037), requires the native 
+        /// MonoCypher library
+        /// </summary>
+        public const string EdDSA = "EdDSA";
     }
     
     public class EncryptionTypeNotSupportedException : NotSupportedException
@@ -98,24 +105,11 @@ namespace VNLib.Hashing.IdentityUtility
         {            
             ArgumentNullException.ThrowIfNull(token);
 
-            //Use and alg are required here
-            if(jwk.KeyUse != JwkKeyUsage.Signature || jwk.Algorithm == null)
+            if (!CanVerify(token, in jwk))
             {
                 return false;
             }
 
-            //Get the jwt header to confirm its the same algorithm as the jwk
-            using (JsonDocument jwtHeader = token.GetHeader())
-            {
-                string? jwtAlg = jwtHeader.RootElement.GetPropString("alg");
-                
-                //Make sure the jwt was signed with the same algorithm type
-                if (!jwk.Algorithm.Equals(jwtAlg, StringComparison.OrdinalIgnoreCase))
-                {
-                    return false;
-                }
-            }
-
             switch (jwk.Algorithm.ToUpper(null))
             {
                 //Rsa witj pkcs and pss
@@ -170,12 +164,72 @@ namespace VNLib.Hashing.IdentityUtility
                         using ECDsa? eCDsa = GetECDsaPublicKey(jwk);
                         return eCDsa != null && token.Verify(eCDsa, HashAlg.SHA256);
                     }
+                //Edwards curves, alg is compared in upper case
+                case "EDDSA":
+                    {
+                        byte[]? publicKey = GetEd25519PublicKey(jwk);
+
+                        if (publicKey == null)
+                        {
+                            return false;
+                        }
+
+                        MCEd25519SignatureVerifier verifier = new(GetEdDSALibrary(), publicKey);
+                        return token.VerifyEdDSA(in verifier);
+                    }
                 default:
                     throw new EncryptionTypeNotSupportedException();
             }
 
         }
         
+        /// <summary>
+        /// Verifies the <see cref="JsonWebToken"/> against the supplied Json Web Key, using 
+        /// the key cache so the key is only imported the first time it is used
+        /// </summary>
+        /// <param name="token"></param>
+        /// <param name="jwk">The supplied single Json Web Key</param>
+        /// <param name="cache">The key cache to rent the verifier from</param>
+        /// <returns>True if required JWK data exists, ciphers were created, and data is verified, false otherwise</returns>
+        /// <exception cref="FormatException"></exception>
+        /// <exception cref="OutOfMemoryException"></exception>
+        /// <exception cref="EncryptionTypeNotSupportedException"></exception>
+        /// <exception cref="ObjectDisposedException"></exception>
+        public static bool VerifyFromJwk<TKey>(this JsonWebToken token, in TKey jwk, JwkSignatureCache cache) where TKey : notnull, IJsonWebKey
+        {
+            ArgumentNullException.ThrowIfNull(token);
+            ArgumentNullException.ThrowIfNull(cache);
+
+            if (!CanVerify(token, in jwk) || !cache.TryRentVerifier(in jwk, out JwkSignatureLease verifier))
+            {
+                return false;
+            }
+
+            using (verifier)
+            {
+                return verifier.HashAlg == HashAlg.None 
+                    ? token.VerifyEdDSA(in verifier) 
+                    : token.Verify(in verifier, verifier.HashAlg);
+            }
+        }
+
+        private static bool CanVerify<TKey>(JsonWebToken token, in TKey jwk) where TKey : notnull, IJsonWebKey
+        {
+            //Use and alg are required here
+            if (jwk.KeyUse != JwkKeyUsage.Signature || jwk.Algorithm == null)
+            {
+                return false;
+            }
+
+            //Get the jwt header to confirm its the same algorithm as the jwk
+            using JsonDocument jwtHeader = token.GetHeader();
+
+            string? jwtAlg = jwtHeader.RootElement.GetPropString("alg");
+
+            //Make sure the jwt was signed with the same algorithm type
+            return jwk.Algorithm.Equals(jwtAlg, StringComparison.OrdinalIgnoreCase);
+        }
+
         /// <summary>
         /// Signs the <see cref="JsonWebToken"/> with the supplied JWK json element
         /// </summary>
@@ -274,11 +328,118 @@ namespace VNLib.Hashing.IdentityUtility
                         token.Sign(eCDsa, HashAlg.SHA256);
                         return;
                     }
+                //Edwards curves, alg is compared in upper case
+                case "EDDSA":
+                    {
+                        byte[]? seed = GetEd25519PrivateKey(jwk);
+                        _ = seed ?? throw new InvalidOperationException("JWK Does not contain an Ed25519 private key");
+
+                        MonoCypherLibrary library = GetEdDSALibrary();
+
+                        byte[] secretKey = new byte[MCCurve25519Module.Ed25519SecretKeySize];
+                        Span<byte> publicKey = stackalloc byte[MCCurve25519Module.Ed25519PublicKeySize];
+
+                        try
+                        {
+                            //The jwk only stores the seed, the signing key must be expanded from it
+                            library.Ed25519CreateKeyPair(seed, secretKey, publicKey);
+
+                            MCEd25519SignatureProvider provider = new(library, secretKey);
+                            token.SignEdDSA(in provider);
+                        }
+                        finally
+                        {
+                            CryptographicOperations.ZeroMemory(secretKey);
+                            CryptographicOperations.ZeroMemory(seed);
+                        }
+                        return;
+                    }
                 default:
                     throw new EncryptionTypeNotSupportedException();
             }
         }
 
+        /// <summary>
+        /// Signs the <see cref="JsonWebToken"/> with the supplied Json Web Key, using the key 
+        /// cache so the key is only imported the first time it is used
+        /// </summary>
+        /// <param name="token"></param>
+        /// <param name="jwk">The JWK that contains the private key</param>
+        /// <param name="cache">The key cache to rent the signer from</param>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="InvalidOperationException"></exception>
+        /// <exception cref="EncryptionTypeNotSupportedException"></exception>
+        /// <exception cref="ObjectDisposedException"></exception>
+        public static void SignFromJwk<T>(this JsonWebToken token, in T jwk, JwkSignatureCache cache) where T : notnull, IJsonWebKey
+        {
+            ArgumentNullException.ThrowIfNull(token);
+            ArgumentNullException.ThrowIfNull(cache);
+
+            if (!cache.TryRentSigner(in jwk, out JwkSignatureLease signer))
+            {
+                throw new InvalidOperationException("The JWK cannot be used for signing or does not contain a private key");
+            }
+
+            using (signer)
+            {
+                if (signer.HashAlg == HashAlg.None)
+                {
+                    token.SignEdDSA(in signer);
+                }
+                else
+                {
+                    token.Sign(in signer, signer.HashAlg);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Computes the RFC 7638 thumbprint of the Json Web Key, the base64url encoded SHA-256 
+        /// hash of its required public members. Public and private keys of the same key pair 
+        /// have the same thumbprint.
+        /// </summary>
+        /// <param name="jwk"></param>
+        /// <returns>The thumbprint of the key, or null if the key type is not supported or required members are missing</returns>
+        public static string? GetThumbprint<TKey>(this TKey jwk) where TKey : IJsonWebKey
+        {
+            //Readonly keys cannot change so they store their thumbprint
+            return jwk is ReadOnlyJsonWebKey rk ? rk.Thumbprint : ComputeThumbprint(in jwk);
+        }
+
+        internal static string? ComputeThumbprint<TKey>(in TKey jwk) where TKey : IJsonWebKey
+        {
+            string? kty = jwk.GetKeyProperty("kty");
+
+            //Required members in lexicographic order, the values never need json escaping
+            string? canonical = kty switch
+            {
+                "RSA" => Canonicalize("{\"e\":\"", jwk.GetKeyProperty("e"), "\",\"kty\":\"RSA\",\"n\":\"", jwk.GetKeyProperty("n"), "\"}"),
+                "EC" => Canonicalize(
+                    "{\"crv\":\"", 
+                    jwk.GetKeyProperty("crv"), 
+                    "\",\"kty\":\"EC\",\"x\":\"", 
+                    jwk.GetKeyProperty("x"), 
+                    "\",\"y\":\"", 
+                    jwk.GetKeyProperty("y"),
+                    "\"}"
+                ),
+                "OKP" => Canonicalize("{\"crv\":\"", jwk.GetKeyProperty("crv"), "\",\"kty\":\"OKP\",\"x\":\"", jwk.GetKeyProperty("x"), "\"}"),
+                _ => null
+            };
+
+            if (canonical == null)
+            {
+                return null;
+            }
+
+            Span<byte> hash = stackalloc byte[HashAlg.SHA256.HashSize()];
+
+            ERRNO count = ManagedHash.ComputeHash(canonical, hash, HashAlg.SHA256);
+            return count ? VnEncoding.ToBase64UrlSafeString(hash[..(int)count], false) : null;
+
+            static string? Canonicalize(params string?[] parts) => Array.IndexOf(parts, null) < 0 ? string.Concat(parts) : null;
+        }
+
         /// <summary>
         /// Gets the RSA public key algorithm from the supplied Json Web Key <see cref="JsonElement"/>
         /// </summary>
@@ -334,10 +495,11 @@ namespace VNLib.Hashing.IdentityUtility
             {
                 //Get optional private key params
                 ReadOnlySpan<char> d = jwk.GetKeyProperty("d");
-                ReadOnlySpan<char> dp = jwk.GetKeyProperty("dq");
-                ReadOnlySpan<char> dq = jwk.GetKeyProperty("dp");
+                ReadOnlySpan<char> dp = jwk.GetKeyProperty("dp");
+                ReadOnlySpan<char> dq = jwk.GetKeyProperty("dq");
                 ReadOnlySpan<char> p = jwk.GetKeyProperty("p");
                 ReadOnlySpan<char> q = jwk.GetKeyProperty("q");
+                ReadOnlySpan<char> qi = jwk.GetKeyProperty("qi");
 
                 //Create params from exponent, moduls and private key components
                 return new()
@@ -349,6 +511,7 @@ namespace VNLib.Hashing.IdentityUtility
                     DQ = FromBase64UrlChars(dq),
                     P = FromBase64UrlChars(p),
                     Q = FromBase64UrlChars(q),
+                    InverseQ = FromBase64UrlChars(qi),
                 };
             }
             else
@@ -452,6 +615,57 @@ namespace VNLib.Hashing.IdentityUtility
             };
         }
         
+        /// <summary>
+        /// Gets the Ed25519 public key from the supplied Json Web Key. The key must be an 
+        /// octet key pair (OKP) on the Ed25519 curve.
+        /// </summary>
+        /// <param name="jwk">The key that contains the public key data</param>
+        /// <returns>The raw public key if found, or null if the key does not contain an Ed25519 public key</returns>
+        public static byte[]? GetEd25519PublicKey<TKey>(this TKey jwk) where TKey : IJsonWebKey
+        {
+            if (!IsEd25519Key(in jwk))
+            {
+                return null;
+            }
+
+            byte[]? x = FromBase64UrlChars(jwk.GetKeyProperty("x"));
+            return x?.Length == MCCurve25519Module.Ed25519PublicKeySize ? x : null;
+        }
+
+        /// <summary>
+        /// Gets the Ed25519 private key seed from the supplied Json Web Key. The key must be an 
+        /// octet key pair (OKP) on the Ed25519 curve.
+        /// </summary>
+        /// <param name="jwk">The key that contains the private key data</param>
+        /// <returns>The raw private key seed if found, or null if the key does not contain an Ed25519 private key</returns>
+        public static byte[]? GetEd25519PrivateKey<TKey>(this TKey jwk) where TKey : IJsonWebKey
+        {
+            if (!IsEd25519Key(in jwk))
+            {
+                return null;
+            }
+
+            byte[]? d = FromBase64UrlChars(jwk.GetKeyProperty("d"));
+            return d?.Length == MCCurve25519Module.Ed25519SeedSize ? d : null;
+        }
+
+        private static bool IsEd25519Key<TKey>(in TKey jwk) where TKey : IJsonWebKey
+        {
+            return string.Equals(jwk.GetKeyProperty("kty"), "OKP", StringComparison.Ordinal)
+                && string.Equals(jwk.GetKeyProperty("crv"), "Ed25519", StringComparison.Ordinal);
+        }
+
+        internal static MonoCypherLibrary GetEdDSALibrary()
+        {
+            //EdDSA is not supported by the .NET crypto apis, it requires the native monocypher library
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                throw new EncryptionTypeNotSupportedException("EdDSA signatures require the native MonoCypher library");
+            }
+
+            return MonoCypherLibrary.Shared;
+        }
+
         private static byte[]? FromBase64UrlChars(ReadOnlySpan<char> base64)
         {
             if (base64.IsEmpty)
@@ -0,0 +1,529 @@
+﻿/*
+* Copyright (c) 2023 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: JwkSignatureCache.cs 
+*
+* JwkSignatureCache.cs is part of VNLib.Hashing.Portable which is 
+* part of the larger VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Threading;
+using System.Collections.Generic;
+using System.Collections.Concurrent;
+using System.Security.Cryptography;
+
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.IdentityUtility
+{
+    /// <summary>
+    /// A bounded, thread-safe cache of imported Json Web Keys keyed by their RFC 7638 
+    /// thumbprint. Importing RSA and ECDsa keys is far more expensive than checking a 
+    /// signature, so the imported algorithm instances are kept and lent out as 
+    /// <see cref="JwkSignatureLease"/>s for repeated signing and verification.
+    /// </summary>
+    /// <remarks>
+    /// Algorithm instances are not shared between threads, each concurrent rental gets its 
+    /// own instance and up to <see cref="MaxInstancesPerKey"/> idle instances are kept per key. 
+    /// When more than <see cref="MaxKeys"/> keys are cached the least recently used key is 
+    /// evicted. Call <see cref="Evict(string)"/> or <see cref="EvictExcept(IEnumerable{string})"/> 
+    /// when keys are rotated out of a key set.
+    /// </remarks>
+    public sealed class JwkSignatureCache : IDisposable
+    {
+        private readonly Dictionary<CacheKey, KeyEntry> _entries = [];
+        private long _clock;
+        private bool _disposed;
+
+        /// <summary>
+        /// The maximum number of keys held in the cache
+        /// </summary>
+        public int MaxKeys { get; }
+
+        /// <summary>
+        /// The maximum number of idle algorithm instances kept for each key
+        /// </summary>
+        public int MaxInstancesPerKey { get; }
+
+        /// <summary>
+        /// The number of keys currently held in the cache
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                lock (_entries)
+                {
+                    return _entries.Count;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Creates a new key cache
+        /// </summary>
+        /// <param name="maxKeys">The maximum number of keys to cache</param>
+        /// <param name="maxInstancesPerKey">The maximum number of idle algorithm instances kept for each key</param>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public JwkSignatureCache(int maxKeys = 64, int maxInstancesPerKey = 0)
+        {
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(maxKeys);
+            ArgumentOutOfRangeException.ThrowIfNegative(maxInstancesPerKey);
+
+            MaxKeys = maxKeys;
+            //Default to one instance per core, enough for every thread to verify at once
+            MaxInstancesPerKey = maxInstancesPerKey > 0 ? maxInstancesPerKey : Environment.ProcessorCount;
+        }
+
+        /// <summary>
+        /// Rents a verifier for the public key of the supplied JWK, importing and caching 
+        /// the key if it is not already cached. The lease must be disposed to return it.
+        /// </summary>
+        /// <param name="jwk">The key to get the verifier for</param>
+        /// <param name="lease">The verifier lease</param>
+        /// <returns>True if the key is a signature key that contains the required public key parameters, false otherwise</returns>
+        /// <exception cref="ObjectDisposedException"></exception>
+        /// <exception cref="EncryptionTypeNotSupportedException"></exception>
+        public bool TryRentVerifier<TKey>(in TKey jwk, out JwkSignatureLease lease) where TKey : notnull, IJsonWebKey
+            => TryRent(in jwk, false, out lease);
+
+        /// <summary>
+        /// Rents a signer for the private key of the supplied JWK, importing and caching 
+        /// the key if it is not already cached. The lease must be disposed to return it.
+        /// </summary>
+        /// <param name="jwk">The key to get the signer for</param>
+        /// <param name="lease">The signer lease</param>
+        /// <returns>True if the key is a signature key that contains the required private key parameters, false otherwise</returns>
+        /// <exception cref="ObjectDisposedException"></exception>
+        /// <exception cref="EncryptionTypeNotSupportedException"></exception>
+        public bool TryRentSigner<TKey>(in TKey jwk, out JwkSignatureLease lease) where TKey : notnull, IJsonWebKey
+            => TryRent(in jwk, true, out lease);
+
+        /// <summary>
+        /// Removes all cached keys that have the supplied thumbprint. Leases that are 
+        /// still outstanding remain valid until they are disposed.
+        /// </summary>
+        /// <param name="thumbprint">The RFC 7638 thumbprint of the key to remove</param>
+        /// <returns>True if any keys were removed, false otherwise</returns>
+        public bool Evict(string thumbprint)
+        {
+            ArgumentNullException.ThrowIfNull(thumbprint);
+            return RemoveWhere(e => string.Equals(e.Thumbprint, thumbprint, StringComparison.Ordinal)) > 0;
+        }
+
+        /// <summary>
+        /// Removes all cached keys whose thumbprint is not in the supplied set, used 
+        /// when a key set is refreshed to drop rotated keys
+        /// </summary>
+        /// <param name="thumbprints">The thumbprints of the keys that are still valid</param>
+        /// <returns>The number of keys that were removed</returns>
+        public int EvictExcept(IEnumerable<string> thumbprints)
+        {
+            ArgumentNullException.ThrowIfNull(thumbprints);
+
+            HashSet<string> current = new(thumbprints, StringComparer.Ordinal);
+            return RemoveWhere(e => !current.Contains(e.Thumbprint));
+        }
+
+        /// <summary>
+        /// Removes all keys from the cache
+        /// </summary>
+        public void Clear() => RemoveWhere(static _ => true);
+
+        ///<inheritdoc/>
+        public void Dispose()
+        {
+            lock (_entries)
+            {
+                _disposed = true;
+            }
+
+            Clear();
+        }
+
+        private bool TryRent<TKey>(in TKey jwk, bool privateKey, out JwkSignatureLease lease) where TKey : notnull, IJsonWebKey
+        {
+            lease = default;
+
+            if (jwk.KeyUse != JwkKeyUsage.Signature || jwk.Algorithm == null)
+            {
+                return false;
+            }
+
+            string? thumbprint = jwk.GetThumbprint();
+
+            if (thumbprint == null)
+            {
+                return false;
+            }
+
+            CacheKey key = new(thumbprint, jwk.Algorithm.ToUpper(null), privateKey);
+            KeyEntry? entry = null;
+
+            lock (_entries)
+            {
+                ObjectDisposedException.ThrowIf(_disposed, this);
+
+                if (_entries.TryGetValue(key, out KeyEntry? cached))
+                {
+                    cached.LastUsed = ++_clock;
+                    cached.AddRef();
+                    entry = cached;
+                }
+            }
+
+            if (entry != null)
+            {
+                lease = entry.Rent();
+                return true;
+            }
+
+            //Import outside the lock, it is the expensive part
+            entry = KeyEntry.Create(in jwk, key, MaxInstancesPerKey);
+
+            if (entry == null)
+            {
+                return false;
+            }
+
+            KeyEntry? evicted = null;
+
+            lock (_entries)
+            {
+                if (_disposed)
+                {
+                    entry.Evict();
+                    throw new ObjectDisposedException(nameof(JwkSignatureCache));
+                }
+
+                //Another thread may have imported the same key while this one was
+                if (_entries.TryGetValue(key, out KeyEntry? existing))
+                {
+                    evicted = entry;
+                    entry = existing;
+                }
+                else
+                {
+                    if (_entries.Count >= MaxKeys)
+                    {
+                        evicted = RemoveLeastRecentlyUsed();
+                    }
+
+                    _entries.Add(key, entry);
+                }
+
+                entry.LastUsed = ++_clock;
+                entry.AddRef();
+            }
+
+            evicted?.Evict();
+
+            lease = entry.Rent();
+            return true;
+        }
+
+        private KeyEntry? RemoveLeastRecentlyUsed()
+        {
+            KeyValuePair<CacheKey, KeyEntry>? oldest = null;
+
+            foreach (KeyValuePair<CacheKey, KeyEntry> kv in _entries)
+            {
+                if (oldest == null || kv.Value.LastUsed < oldest.Value.Value.LastUsed)
+                {
+                    oldest = kv;
+                }
+            }
+
+            if (oldest == null)
+            {
+                return null;
+            }
+
+            _entries.Remove(oldest.Value.Key);
+            return oldest.Value.Value;
+        }
+
+        private int RemoveWhere(Func<KeyEntry, bool> predicate)
+        {
+            List<KeyEntry> removed = [];
+
+            lock (_entries)
+            {
+                foreach (KeyValuePair<CacheKey, KeyEntry> kv in _entries)
+                {
+                    if (predicate(kv.Value))
+                    {
+                        removed.Add(kv.Value);
+                    }
+                }
+
+                foreach (KeyEntry entry in removed)
+                {
+                    _entries.Remove(entry.Key);
+                }
+            }
+
+            //Release key material outside the lock
+            removed.ForEach(static e => e.Evict());
+            return removed.Count;
+        }
+
+        internal readonly record struct CacheKey(string Thumbprint, string Algorithm, bool PrivateKey);
+
+        internal enum KeyKind
+        {
+            Rsa,
+            ECDsa,
+            Ed25519
+        }
+
+        /*
+         * Holds the parsed key parameters for a single key and algorithm, 
+         * and a pool of imported instances created from them. 
+         * 
+         * The cache and every outstanding lease hold a reference, key material 
+         * is only wiped once the entry is evicted and all leases are returned.
+         */
+        internal sealed class KeyEntry
+        {
+            private readonly ConcurrentStack<AsymmetricAlgorithm> _idle = new();
+            private readonly int _maxIdle;
+            private RSAParameters _rsaParams;
+            private ECParameters _ecParams;
+            private int _idleCount;
+            private int _refs = 1;
+            private volatile bool _evicted;
+
+            public CacheKey Key { get; }
+
+            public string Thumbprint => Key.Thumbprint;
+
+            public KeyKind Kind { get; }
+
+            public HashAlg HashAlg { get; }
+
+            public RSASignaturePadding? Padding { get; }
+
+            /// <summary>
+            /// The raw Ed25519 public key or expanded secret key
+            /// </summary>
+            public byte[]? EdKey { get; private set; }
+
+            public MonoCypherLibrary? Library { get; private set; }
+
+            public long LastUsed { get; set; }
+
+            private KeyEntry(CacheKey key, KeyKind kind, HashAlg hashAlg, RSASignaturePadding? padding, int maxIdle)
+            {
+                Key = key;
+                Kind = kind;
+                HashAlg = hashAlg;
+                Padding = padding;
+                _maxIdle = maxIdle;
+            }
+
+            public static KeyEntry? Create<TKey>(in TKey jwk, CacheKey key, int maxIdle) where TKey : IJsonWebKey
+            {
+                KeyEntry entry = key.Algorithm switch
+                {
+                    JWKAlgorithms.RS256 => new(key, KeyKind.Rsa, HashAlg.SHA256, RSASignaturePadding.Pkcs1, maxIdle),
+                    JWKAlgorithms.RS384 => new(key, KeyKind.Rsa, HashAlg.SHA384, RSASignaturePadding.Pkcs1, maxIdle),
+                    JWKAlgorithms.RS512 => new(key, KeyKind.Rsa, HashAlg.SHA512, RSASignaturePadding.Pkcs1, maxIdle),
+                    JWKAlgorithms.PS256 => new(key, KeyKind.Rsa, HashAlg.SHA256, RSASignaturePadding.Pss, maxIdle),
+                    JWKAlgorithms.PS384 => new(key, KeyKind.Rsa, HashAlg.SHA384, RSASignaturePadding.Pss, maxIdle),
+                    JWKAlgorithms.PS512 => new(key, KeyKind.Rsa, HashAlg.SHA512, RSASignaturePadding.Pss, maxIdle),
+                    JWKAlgorithms.ES256 => new(key, KeyKind.ECDsa, HashAlg.SHA256, null, maxIdle),
+                    JWKAlgorithms.ES384 => new(key, KeyKind.ECDsa, HashAlg.SHA384, null, maxIdle),
+                    JWKAlgorithms.ES512 => new(key, KeyKind.ECDsa, HashAlg.SHA512, null, maxIdle),
+                    JWKAlgorithms.ES256K => new(key, KeyKind.ECDsa, HashAlg.SHA256, null, maxIdle),
+                    //Edwards curves, alg is compared in upper case
+                    "EDDSA" => new(key, KeyKind.Ed25519, HashAlg.None, null, maxIdle),
+                    _ => throw new EncryptionTypeNotSupportedException(),
+                };
+
+                return entry.Import(in jwk) ? entry : null;
+            }
+
+            private bool Import<TKey>(in TKey jwk) where TKey : IJsonWebKey
+            {
+                switch (Kind)
+                {
+                    case KeyKind.Rsa:
+                        {
+                            RSAParameters? p = JsonWebKey.GetRsaParameters(in jwk, Key.PrivateKey);
+
+                            if (!p.HasValue || (Key.PrivateKey && p.Value.D == null))
+                            {
+                                return false;
+                            }
+
+                            _rsaParams = p.Value;
+                        }
+                        break;
+                    case KeyKind.ECDsa:
+                        {
+                            ECParameters? p = JsonWebKey.GetECParameters(in jwk, Key.PrivateKey);
+
+                            if (!p.HasValue || (Key.PrivateKey && p.Value.D == null))
+                            {
+                                return false;
+                            }
+
+                            _ecParams = p.Value;
+                        }
+                        break;
+                    case KeyKind.Ed25519:
+                        return ImportEd25519(in jwk);
+                }
+
+                //Import the first instance now so an invalid key fails before it is cached
+                _idle.Push(CreateInstance());
+                _idleCount = 1;
+                return true;
+            }
+
+            private bool ImportEd25519<TKey>(in TKey jwk) where TKey : IJsonWebKey
+            {
+                MonoCypherLibrary library = JsonWebKey.GetEdDSALibrary();
+
+                if (!Key.PrivateKey)
+                {
+                    EdKey = jwk.GetEd25519PublicKey();
+                    Library = library;
+                    return EdKey != null;
+                }
+
+                byte[]? seed = jwk.GetEd25519PrivateKey();
+
+                if (seed == null)
+                {
+                    return false;
+                }
+
+                byte[] secretKey = new byte[MCCurve25519Module.Ed25519SecretKeySize];
+                Span<byte> publicKey = stackalloc byte[MCCurve25519Module.Ed25519PublicKeySize];
+
+                try
+                {
+                    //The jwk only stores the seed, the expanded signing key is cached instead
+                    library.Ed25519CreateKeyPair(seed, secretKey, publicKey);
+                }
+                finally
+                {
+                    CryptographicOperations.ZeroMemory(seed);
+                }
+
+                EdKey = secretKey;
+                Library = library;
+                return true;
+            }
+
+            private AsymmetricAlgorithm CreateInstance()
+            {
+                return Kind == KeyKind.Rsa 
+                    ? RSA.Create(_rsaParams) 
+                    : ECDsa.Create(_ecParams);
+            }
+
+            /// <summary>
+            /// Adds a reference for a lease, must be called while the entry is held by the cache
+            /// </summary>
+            public void AddRef() => Interlocked.Increment(ref _refs);
+
+            public JwkSignatureLease Rent()
+            {
+                if (Kind == KeyKind.Ed25519)
+                {
+                    //Ed25519 only needs the raw key, there is nothing to pool
+                    return new(this, null);
+                }
+
+                if (_idle.TryPop(out AsymmetricAlgorithm? alg))
+                {
+                    Interlocked.Decrement(ref _idleCount);
+                    return new(this, alg);
+                }
+
+                return new(this, CreateInstance());
+            }
+
+            public void Return(AsymmetricAlgorithm? alg)
+            {
+                if (alg != null)
+                {
+                    if (!_evicted && Interlocked.Increment(ref _idleCount) <= _maxIdle)
+                    {
+                        _idle.Push(alg);
+                    }
+                    else
+                    {
+                        if (!_evicted)
+                        {
+                            Interlocked.Decrement(ref _idleCount);
+                        }
+
+                        alg.Dispose();
+                    }
+                }
+
+                Release();
+            }
+
+            /// <summary>
+            /// Releases the cache's reference after the entry was removed
+            /// </summary>
+            public void Evict()
+            {
+                _evicted = true;
+                Release();
+            }
+
+            private void Release()
+            {
+                if (Interlocked.Decrement(ref _refs) != 0)
+                {
+                    return;
+                }
+
+                DrainIdle();
+
+                //Wipe private key material that is no longer needed
+                if (Key.PrivateKey)
+                {
+                    CryptographicOperations.ZeroMemory(_rsaParams.D);
+                    CryptographicOperations.ZeroMemory(_rsaParams.DP);
+                    CryptographicOperations.ZeroMemory(_rsaParams.DQ);
+                    CryptographicOperations.ZeroMemory(_rsaParams.P);
+                    CryptographicOperations.ZeroMemory(_rsaParams.Q);
+                    CryptographicOperations.ZeroMemory(_rsaParams.InverseQ);
+                    CryptographicOperations.ZeroMemory(_ecParams.D);
+                    CryptographicOperations.ZeroMemory(EdKey);
+                }
+            }
+
+            private void DrainIdle()
+            {
+                while (_idle.TryPop(out AsymmetricAlgorithm? alg))
+                {
+                    alg.Dispose();
+                }
+            }
+        }
+    }
+}
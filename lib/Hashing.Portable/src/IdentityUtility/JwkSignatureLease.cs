@@ -0,0 +1,122 @@
+﻿/*
+* Copyright (c) 2023 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: JwkSignatureLease.cs 
+*
+* JwkSignatureLease.cs is part of VNLib.Hashing.Portable which is 
+* part of the larger VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Diagnostics;
+using System.Security.Cryptography;
+
+using VNLib.Utils;
+using VNLib.Hashing.Native.MonoCypher;
+
+using static VNLib.Hashing.IdentityUtility.JwkSignatureCache;
+
+namespace VNLib.Hashing.IdentityUtility
+{
+    /// <summary>
+    /// A signer or verifier rented from a <see cref="JwkSignatureCache"/>. The lease 
+    /// must not be used by more than one thread at a time and must be disposed to 
+    /// return it to the cache.
+    /// </summary>
+    /// <remarks>
+    /// When <see cref="HashAlg"/> is <see cref="HashAlg.None"/> the algorithm signs the 
+    /// entire message (EdDSA), so the lease must be used with the EdDSA specific JWT 
+    /// sign and verify methods that do not take a <see cref="HashAlg"/>.
+    /// </remarks>
+    public readonly struct JwkSignatureLease : IJwtSignatureVerifier, IJwtSignatureProvider, IDisposable
+    {
+        private readonly KeyEntry _entry;
+        private readonly AsymmetricAlgorithm? _alg;
+
+        internal JwkSignatureLease(KeyEntry entry, AsymmetricAlgorithm? alg)
+        {
+            _entry = entry;
+            _alg = alg;
+        }
+
+        /// <summary>
+        /// The hash algorithm used to compute the message digest for this key
+        /// </summary>
+        public readonly HashAlg HashAlg => _entry.HashAlg;
+
+        /// <summary>
+        /// The RFC 7638 thumbprint of the rented key
+        /// </summary>
+        public readonly string Thumbprint => _entry.Thumbprint;
+
+        ///<inheritdoc/>
+        public readonly int RequiredBufferSize => _entry.Kind switch
+        {
+            KeyKind.Rsa => 1024,
+            KeyKind.ECDsa => 512,
+            _ => MCCurve25519Module.Ed25519SignatureSize
+        };
+
+        ///<inheritdoc/>
+        public readonly bool Verify(ReadOnlySpan<byte> messageHash, ReadOnlySpan<byte> signature)
+        {
+            switch (_entry.Kind)
+            {
+                case KeyKind.Rsa:
+                    return ((RSA)_alg!).VerifyHash(messageHash, signature, _entry.HashAlg.GetAlgName(), _entry.Padding!);
+                case KeyKind.ECDsa:
+                    return ((ECDsa)_alg!).VerifyHash(messageHash, signature, DSASignatureFormat.IeeeP1363FixedFieldConcatenation);
+                default:
+                    {
+                        Debug.Assert(!_entry.Key.PrivateKey, "Ed25519 verification requires a public key lease");
+
+                        MCEd25519SignatureVerifier verifier = new(_entry.Library!, _entry.EdKey);
+                        return verifier.Verify(messageHash, signature);
+                    }
+            }
+        }
+
+        ///<inheritdoc/>
+        public readonly ERRNO ComputeSignatureFromHash(ReadOnlySpan<byte> hash, Span<byte> outputBuffer)
+        {
+            switch (_entry.Kind)
+            {
+                case KeyKind.Rsa:
+                    return ((RSA)_alg!).TrySignHash(hash, outputBuffer, _entry.HashAlg.GetAlgName(), _entry.Padding!, out int rsaWritten) 
+                        ? rsaWritten 
+                        : ERRNO.E_FAIL;
+                case KeyKind.ECDsa:
+                    return ((ECDsa)_alg!).TrySignHash(hash, outputBuffer, DSASignatureFormat.IeeeP1363FixedFieldConcatenation, out int ecWritten) 
+                        ? ecWritten 
+                        : ERRNO.E_FAIL;
+                default:
+                    {
+                        Debug.Assert(_entry.Key.PrivateKey, "Ed25519 signing requires a private key lease");
+
+                        MCEd25519SignatureProvider provider = new(_entry.Library!, _entry.EdKey);
+                        return provider.ComputeSignatureFromHash(hash, outputBuffer);
+                    }
+            }
+        }
+
+        /// <summary>
+        /// Returns the rented instance to the cache
+        /// </summary>
+        public readonly void Dispose() => _entry?.Return(_alg);
+    }
+}
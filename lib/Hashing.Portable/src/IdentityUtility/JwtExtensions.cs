@@ -302,14 +302,15 @@ namespace VNLib.Hashing.IdentityUtility
         public static void Sign<T>(this JsonWebToken jwt, in T provider, HashAlg hashAlg) where T : IJwtSignatureProvider
         {
             //Alloc heap buffer to store hash data (helps with memory locality)
-            nint nearestPage = MemoryUtil.NearestPage(provider.RequiredBufferSize + (int)hashAlg);
+            int hashSize = hashAlg.HashSize();
+            nint nearestPage = MemoryUtil.NearestPage(provider.RequiredBufferSize + hashSize);
 
             //Alloc buffer
             using UnsafeMemoryHandle<byte> handle = jwt.Heap.UnsafeAlloc<byte>((int)nearestPage, true);
 
             //Split buffers
-            Span<byte> hashBuffer = handle.Span[..(int)hashAlg];
-            Span<byte> output = handle.Span[(int)hashAlg..];
+            Span<byte> hashBuffer = handle.Span[..hashSize];
+            Span<byte> output = handle.Span[hashSize..];
           
             //Compute hash
             ERRNO hashLen = ManagedHash.ComputeHash(jwt.HeaderAndPayload, hashBuffer, hashAlg);
@@ -331,6 +332,32 @@ namespace VNLib.Hashing.IdentityUtility
             jwt.WriteSignature(output[..(int)sigLen]);
         }
 
+        /// <summary>
+        /// Computes an EdDSA signature of the entire header and payload of the current <see cref="JsonWebToken"/>.
+        /// EdDSA hashes the message internally, so no message digest is computed first. The provider
+        /// must hold an EdDSA key, other key types must use a <see cref="HashAlg"/> overload.
+        /// </summary>
+        /// <typeparam name="T"></typeparam>
+        /// <param name="jwt"></param>
+        /// <param name="provider">The EdDSA <see cref="IJwtSignatureProvider"/> that will compute the signature of the message</param>
+        /// <exception cref="CryptographicException"></exception>
+        public static void SignEdDSA<T>(this JsonWebToken jwt, in T provider) where T : IJwtSignatureProvider
+        {
+            ArgumentNullException.ThrowIfNull(jwt);
+
+            //Signatures that sign the whole message are small enough to live on the stack
+            Span<byte> output = stackalloc byte[provider.RequiredBufferSize];
+
+            ERRNO sigLen = provider.ComputeSignatureFromHash(jwt.HeaderAndPayload, output);
+
+            if (!sigLen)
+            {
+                throw new CryptographicException("Failed to compute the JWT signature");
+            }
+
+            jwt.WriteSignature(output[..(int)sigLen]);
+        }
+
         /// <summary>
         /// Verifies the current JWT body-segements against the parsed signature segment.
         /// </summary>
@@ -424,6 +451,32 @@ namespace VNLib.Hashing.IdentityUtility
             return provider.Verify(hashBuffer, sigBuffer);
         }
 
+        /// <summary>
+        /// Verifies an EdDSA signature of the entire header and payload of the current <see cref="JsonWebToken"/>.
+        /// EdDSA hashes the message internally, so no message digest is computed first. The verifier
+        /// must hold an EdDSA key, other key types must use a <see cref="HashAlg"/> overload.
+        /// </summary>
+        /// <typeparam name="T"></typeparam>
+        /// <param name="jwt"></param>
+        /// <param name="provider">The EdDSA <see cref="IJwtSignatureVerifier"/> used to verify the message</param>
+        /// <returns>True if the siganture matches the message, false otherwise</returns>
+        /// <exception cref="FormatException"></exception>
+        public static bool VerifyEdDSA<T>(this JsonWebToken jwt, ref readonly T provider) where T : IJwtSignatureVerifier
+        {
+            ArgumentNullException.ThrowIfNull(jwt);
+
+            ReadOnlySpan<byte> signature = jwt.SignatureData;
+
+            int sigBufSize = CalcPadding(signature.Length) + signature.Length;
+
+            using UnsafeMemoryHandle<byte> buffer = jwt.Heap.UnsafeAlloc<byte>(sigBufSize);
+
+            //Decode from urlsafe base64
+            int decoded = DecodeUnpadded(signature, buffer.Span);
+
+            return provider.Verify(jwt.HeaderAndPayload, buffer.Span[..decoded]);
+        }
+
         /// <summary>
         /// Verifies the current JWT body-segements against the parsed signature segment.
         /// </summary>
@@ -538,7 +591,7 @@ namespace VNLib.Hashing.IdentityUtility
 
             ///<inheritdoc/>
             public readonly ERRNO ComputeSignatureFromHash(ReadOnlySpan<byte> hash, Span<byte> outputBuffer) 
-                => !SigAlg.TrySignHash(hash, outputBuffer, Slg.GetAlgName(), Padding, out int written) ? written : ERRNO.E_FAIL;
+                => SigAlg.TrySignHash(hash, outputBuffer, Slg.GetAlgName(), Padding, out int written) ? written : ERRNO.E_FAIL;
         }
 
         /*
@@ -0,0 +1,414 @@
+﻿/*
+* Copyright (c) 2023 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: JwtView.cs 
+*
+* JwtView.cs is part of VNLib.Hashing.Portable which is 
+* part of the larger VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Text;
+using System.Buffers;
+using System.Buffers.Text;
+using System.Text.Json;
+using System.Security.Cryptography;
+
+using VNLib.Utils;
+using VNLib.Utils.Memory;
+
+namespace VNLib.Hashing.IdentityUtility
+{
+    /// <summary>
+    /// A read-only view of a compact serialized JSON Web Token over the raw utf8 bytes 
+    /// it was received in, usually the value of an Authorization header. The token 
+    /// is validated in place and never copied, header and payload segments are only 
+    /// decoded on request into caller supplied buffers and signatures are verified 
+    /// without heap allocations.
+    /// </summary>
+    /// <remarks>
+    /// The view is only valid as long as the memory it was parsed from. Use 
+    /// <see cref="JsonWebToken"/> to create or modify tokens.
+    /// </remarks>
+    public readonly ref struct JwtView
+    {
+        /*
+         * Signatures larger than this are decoded into an unmanaged heap buffer 
+         * instead of the stack, fits up to RSA 4096 signatures
+         */
+        const int MaxStackSignatureSize = 1024;
+        const int MaxStackHeaderSize = 512;
+
+        private static readonly SearchValues<byte> Base64UrlChars = SearchValues.Create(
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"u8
+        );
+
+        private static ReadOnlySpan<byte> BearerPrefix => "Bearer "u8;
+
+        private readonly ReadOnlySpan<byte> _token;
+        private readonly int _headerEnd;
+        private readonly int _payloadEnd;
+
+        private JwtView(ReadOnlySpan<byte> token, int headerEnd, int payloadEnd)
+        {
+            _token = token;
+            _headerEnd = headerEnd;
+            _payloadEnd = payloadEnd;
+        }
+
+        /// <summary>
+        /// The Base64URL encoded UTF8 bytes of the header portion of the token
+        /// </summary>
+        public readonly ReadOnlySpan<byte> HeaderData => _token[.._headerEnd];
+
+        /// <summary>
+        /// The Base64URL encoded UTF8 bytes of the payload portion of the token
+        /// </summary>
+        public readonly ReadOnlySpan<byte> PayloadData => _token[(_headerEnd + 1).._payloadEnd];
+
+        /// <summary>
+        /// The Base64URL encoded UTF8 bytes of the header + '.' + payload portion of the token, 
+        /// the signed message
+        /// </summary>
+        public readonly ReadOnlySpan<byte> HeaderAndPayload => _token[.._payloadEnd];
+
+        /// <summary>
+        /// The Base64URL encoded UTF8 bytes of the signature portion of the token
+        /// </summary>
+        public readonly ReadOnlySpan<byte> SignatureData => _token[(_payloadEnd + 1)..];
+
+        /// <summary>
+        /// The size of the buffer required by <see cref="DecodeHeader(Span{byte})"/>
+        /// </summary>
+        public readonly int HeaderBufferSize => GetDecodeBufferSize(HeaderData.Length);
+
+        /// <summary>
+        /// The size of the buffer required by <see cref="DecodePayload(Span{byte})"/>
+        /// </summary>
+        public readonly int PayloadBufferSize => GetDecodeBufferSize(PayloadData.Length);
+
+        /// <summary>
+        /// Validates the structure of a compact serialized token and creates a view over it. 
+        /// The token must have exactly three base64url segments without padding and a 
+        /// non-empty header. The segment contents are not decoded.
+        /// </summary>
+        /// <param name="utf8Token">The utf8 encoded token</param>
+        /// <param name="view">The view of the token if parsing succeeded</param>
+        /// <returns>True if the token is structurally valid, false otherwise</returns>
+        public static bool TryParse(ReadOnlySpan<byte> utf8Token, out JwtView view)
+        {
+            view = default;
+
+            int headerEnd = utf8Token.IndexOf(JsonWebToken.SAEF_PERIOD);
+            int payloadEnd = utf8Token.LastIndexOf(JsonWebToken.SAEF_PERIOD);
+
+            //Exactly two periods and a header are required
+            if (headerEnd < 1 || payloadEnd == headerEnd || utf8Token[(headerEnd + 1)..payloadEnd].Contains(JsonWebToken.SAEF_PERIOD))
+            {
+                return false;
+            }
+
+            ReadOnlySpan<byte> header = utf8Token[..headerEnd];
+            ReadOnlySpan<byte> payload = utf8Token[(headerEnd + 1)..payloadEnd];
+            ReadOnlySpan<byte> signature = utf8Token[(payloadEnd + 1)..];
+
+            if (!IsValidSegment(header) || !IsValidSegment(payload) || !IsValidSegment(signature))
+            {
+                return false;
+            }
+
+            view = new(utf8Token, headerEnd, payloadEnd);
+            return true;
+        }
+
+        /// <summary>
+        /// Parses a token from the value of an Authorization header using the Bearer scheme, 
+        /// surrounding whitespace is ignored
+        /// </summary>
+        /// <param name="authorization">The utf8 encoded value of the Authorization header</param>
+        /// <param name="view">The view of the token if parsing succeeded</param>
+        /// <returns>True if the header contained a structurally valid bearer token, false otherwise</returns>
+        public static bool TryParseBearer(ReadOnlySpan<byte> authorization, out JwtView view)
+        {
+            authorization = authorization.Trim((byte)' ');
+
+            //The scheme name is case insensitive
+            if (authorization.Length <= BearerPrefix.Length || !Ascii.EqualsIgnoreCase(authorization[..BearerPrefix.Length], BearerPrefix))
+            {
+                view = default;
+                return false;
+            }
+
+            return TryParse(authorization[BearerPrefix.Length..].TrimStart((byte)' '), out view);
+        }
+
+        /// <summary>
+        /// Decodes the header json into the output buffer
+        /// </summary>
+        /// <param name="output">The buffer to write the json to, must be at least <see cref="HeaderBufferSize"/> bytes</param>
+        /// <returns>The number of bytes written to the output, or <see cref="ERRNO.E_FAIL"/> if decoding failed</returns>
+        public readonly ERRNO DecodeHeader(Span<byte> output) => Decode(HeaderData, output);
+
+        /// <summary>
+        /// Decodes the payload json into the output buffer
+        /// </summary>
+        /// <param name="output">The buffer to write the json to, must be at least <see cref="PayloadBufferSize"/> bytes</param>
+        /// <returns>The number of bytes written to the output, or <see cref="ERRNO.E_FAIL"/> if decoding failed</returns>
+        public readonly ERRNO DecodePayload(Span<byte> output) => Decode(PayloadData, output);
+
+        /// <summary>
+        /// Determines if the header "alg" value matches the supplied algorithm name, 
+        /// the comparison is case sensitive as required by RFC 7515
+        /// </summary>
+        /// <param name="algorithm">The utf8 encoded algorithm name to compare</param>
+        /// <returns>True if the header contains an alg property with the given value, false otherwise</returns>
+        public readonly bool AlgorithmEquals(ReadOnlySpan<byte> algorithm)
+        {
+            int bufferSize = HeaderBufferSize;
+
+            //Headers are small, only absurdly large headers need a heap buffer
+            using UnsafeMemoryHandle<byte> handle = bufferSize > MaxStackHeaderSize 
+                ? MemoryUtil.UnsafeAlloc(bufferSize) 
+                : default;
+
+            Span<byte> buffer = bufferSize > MaxStackHeaderSize ? handle.Span : stackalloc byte[MaxStackHeaderSize];
+
+            ERRNO decoded = DecodeHeader(buffer);
+
+            if (!decoded)
+            {
+                return false;
+            }
+
+            try
+            {
+                Utf8JsonReader reader = new(buffer[..(int)decoded]);
+
+                if (!reader.Read() || reader.TokenType != JsonTokenType.StartObject)
+                {
+                    return false;
+                }
+
+                //Only inspect top-level properties
+                while (reader.Read() && reader.TokenType == JsonTokenType.PropertyName)
+                {
+                    bool isAlg = reader.ValueTextEquals("alg"u8);
+
+                    if (!reader.Read())
+                    {
+                        return false;
+                    }
+
+                    if (isAlg)
+                    {
+                        return reader.TokenType == JsonTokenType.String && reader.ValueTextEquals(algorithm);
+                    }
+
+                    reader.Skip();
+                }
+
+                return false;
+            }
+            catch (JsonException)
+            {
+                return false;
+            }
+        }
+
+        /// <summary>
+        /// Verifies the HMAC signature of the token
+        /// </summary>
+        /// <param name="key">The HMAC shared symetric key</param>
+        /// <param name="alg">The HMAC algorithm used to sign the token</param>
+        /// <returns>True if the signature matches the computed signature, false otherwise</returns>
+        /// <exception cref="InternalBufferTooSmallException"></exception>
+        public readonly bool Verify(ReadOnlySpan<byte> key, HashAlg alg)
+        {
+            //Get base64 buffer size for in-place conversion
+            Span<byte> signatureBuffer = stackalloc byte[Base64.GetMaxEncodedToUtf8Length(alg.HashSize())];
+
+            ERRNO count = ManagedHash.ComputeHmac(key, HeaderAndPayload, signatureBuffer, alg);
+
+            if (!count)
+            {
+                throw new InternalBufferTooSmallException("Failed to compute the hash of the JWT data");
+            }
+
+            //Compare the encoded signatures so the token signature does not need decoding
+            ERRNO encoded = VnEncoding.Base64UrlEncodeInPlace(signatureBuffer, count, false);
+
+            if (!encoded)
+            {
+                throw new InternalBufferTooSmallException("Failed to convert the signature buffer to its base64 because the buffer was too small");
+            }
+
+            return CryptographicOperations.FixedTimeEquals(SignatureData, signatureBuffer[..(int)encoded]);
+        }
+
+        /// <summary>
+        /// Verifies the signature of the token against the message digest of the header 
+        /// and payload computed with the supplied hash algorithm
+        /// </summary>
+        /// <typeparam name="T"></typeparam>
+        /// <param name="verifier">The <see cref="IJwtSignatureVerifier"/> used to verify the message digest</param>
+        /// <param name="alg">The <see cref="HashAlg"/> used to compute the message digest</param>
+        /// <returns>True if the signature matches, false otherwise</returns>
+        /// <exception cref="InternalBufferTooSmallException"></exception>
+        public readonly bool Verify<T>(ref readonly T verifier, HashAlg alg) where T : IJwtSignatureVerifier
+        {
+            Span<byte> hashBuffer = stackalloc byte[alg.HashSize()];
+
+            ERRNO hashLen = ManagedHash.ComputeHash(HeaderAndPayload, hashBuffer, alg);
+
+            if (!hashLen)
+            {
+                throw new InternalBufferTooSmallException("Hash output buffer was not properly sized");
+            }
+
+            return VerifyMessage(in verifier, hashBuffer[..(int)hashLen]);
+        }
+
+        /// <summary>
+        /// Verifies an EdDSA signature of the entire header and payload. EdDSA hashes the message 
+        /// internally, so no message digest is computed first. The verifier must hold an EdDSA key, 
+        /// other key types must use a <see cref="HashAlg"/> overload.
+        /// </summary>
+        /// <typeparam name="T"></typeparam>
+        /// <param name="verifier">The EdDSA <see cref="IJwtSignatureVerifier"/> used to verify the message</param>
+        /// <returns>True if the signature matches, false otherwise</returns>
+        public readonly bool VerifyEdDSA<T>(ref readonly T verifier) where T : IJwtSignatureVerifier
+            => VerifyMessage(in verifier, HeaderAndPayload);
+
+        /// <summary>
+        /// Verifies the signature of the token using the specified <see cref="ECDsa"/> public key
+        /// </summary>
+        /// <param name="alg">The ECDsa algorithm that holds the public key</param>
+        /// <param name="hashAlg">The <see cref="HashAlg"/> used to compute the message digest</param>
+        /// <returns>True if the signature matches, false otherwise</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        public readonly bool Verify(ECDsa alg, HashAlg hashAlg)
+        {
+            ArgumentNullException.ThrowIfNull(alg);
+
+            JwtExtensions.ECDSASignatureVerifier verifier = new(alg, DSASignatureFormat.IeeeP1363FixedFieldConcatenation);
+            return Verify(in verifier, hashAlg);
+        }
+
+        /// <summary>
+        /// Verifies the signature of the token using the specified <see cref="RSA"/> public key
+        /// </summary>
+        /// <param name="alg">The RSA algorithm that holds the public key</param>
+        /// <param name="hashAlg">The <see cref="HashAlg"/> used to compute the message digest</param>
+        /// <param name="padding">The RSA signature padding method</param>
+        /// <returns>True if the signature matches, false otherwise</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        public readonly bool Verify(RSA alg, HashAlg hashAlg, RSASignaturePadding padding)
+        {
+            ArgumentNullException.ThrowIfNull(alg);
+            ArgumentNullException.ThrowIfNull(padding);
+
+            JwtExtensions.RSASignatureVerifier verifier = new(alg, hashAlg, padding);
+            return Verify(in verifier, hashAlg);
+        }
+
+        /// <summary>
+        /// Verifies the token against the supplied Json Web Key using a verifier rented from 
+        /// the key cache. The key must be a signature key and its algorithm must match the 
+        /// token header.
+        /// </summary>
+        /// <param name="jwk">The key to verify the token with</param>
+        /// <param name="cache">The key cache to rent the verifier from</param>
+        /// <returns>True if the key matches the token and the signature is valid, false otherwise</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="EncryptionTypeNotSupportedException"></exception>
+        /// <exception cref="ObjectDisposedException"></exception>
+        public readonly bool VerifyFromJwk<TKey>(in TKey jwk, JwkSignatureCache cache) where TKey : notnull, IJsonWebKey
+        {
+            ArgumentNullException.ThrowIfNull(cache);
+
+            string? keyAlg = jwk.Algorithm;
+
+            //Algorithm names are short ascii strings
+            if (jwk.KeyUse != JwkKeyUsage.Signature || keyAlg == null || keyAlg.Length > 32 || !Ascii.IsValid(keyAlg))
+            {
+                return false;
+            }
+
+            Span<byte> utf8Alg = stackalloc byte[keyAlg.Length];
+            Encoding.ASCII.GetBytes(keyAlg, utf8Alg);
+
+            if (!AlgorithmEquals(utf8Alg) || !cache.TryRentVerifier(in jwk, out JwkSignatureLease verifier))
+            {
+                return false;
+            }
+
+            using (verifier)
+            {
+                return verifier.HashAlg == HashAlg.None 
+                    ? VerifyEdDSA(in verifier) 
+                    : Verify(in verifier, verifier.HashAlg);
+            }
+        }
+
+        private readonly bool VerifyMessage<T>(ref readonly T verifier, ReadOnlySpan<byte> message) where T : IJwtSignatureVerifier
+        {
+            ReadOnlySpan<byte> signature = SignatureData;
+
+            if (signature.IsEmpty)
+            {
+                return false;
+            }
+
+            int bufferSize = GetDecodeBufferSize(signature.Length);
+
+            using UnsafeMemoryHandle<byte> handle = bufferSize > MaxStackSignatureSize 
+                ? MemoryUtil.UnsafeAlloc(bufferSize) 
+                : default;
+
+            Span<byte> sigBuffer = bufferSize > MaxStackSignatureSize ? handle.Span : stackalloc byte[MaxStackSignatureSize];
+
+            ERRNO decoded = Decode(signature, sigBuffer);
+
+            return decoded && verifier.Verify(message, sigBuffer[..(int)decoded]);
+        }
+
+        private static ERRNO Decode(ReadOnlySpan<byte> segment, Span<byte> output)
+        {
+            if (segment.IsEmpty)
+            {
+                return ERRNO.E_FAIL;
+            }
+
+            return output.Length < GetDecodeBufferSize(segment.Length) 
+                ? ERRNO.E_FAIL 
+                : VnEncoding.Base64UrlDecode(segment, output);
+        }
+
+        /*
+         * Base64url is decoded in place after padding is restored, so the 
+         * buffer must hold the padded encoded segment
+         */
+        private static int GetDecodeBufferSize(int encodedLength) => encodedLength + ((4 - (encodedLength & 0x03)) & 0x03);
+
+        private static bool IsValidSegment(ReadOnlySpan<byte> segment)
+        {
+            //A single trailing character cannot encode a full byte
+            return (segment.Length & 0x03) != 1 && !segment.ContainsAnyExcept(Base64UrlChars);
+        }
+    }
+}
@@ -39,6 +39,7 @@ namespace VNLib.Hashing.IdentityUtility
     public sealed class ReadOnlyJsonWebKey : IJsonWebKey
     {
         private readonly FrozenDictionary<string, string?> _properties;
+        private string? _thumbprint;
 
         /// <summary>
         /// Creates a new instance of <see cref="ReadOnlyJsonWebKey"/> from a dictionary of 
@@ -143,6 +144,12 @@ namespace VNLib.Hashing.IdentityUtility
         /// </summary>
         public string? Use => _properties.GetValueOrDefault("use");
 
+        /// <summary>
+        /// The RFC 7638 thumbprint of the key, computed on first access. Null if the key 
+        /// type is not supported or required members are missing.
+        /// </summary>
+        public string? Thumbprint => _thumbprint ??= JsonWebKey.ComputeThumbprint(this);
+
         /// <summary>
         /// Returns the JWT header that matches this key
         /// </summary>
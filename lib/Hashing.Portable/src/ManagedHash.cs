@@ -74,6 +74,7 @@ namespace VNLib.Hashing
         private static readonly Sha512 _sha512Alg;
         private static readonly Md5 _md5Alg;
         private static readonly Blake2b _blake2bAlg;
+        private static readonly Blake3 _blake3Alg;
 
         private static readonly Sha3_256 _3_sha256;
         private static readonly Sha3_384 _3_sha384;
@@ -85,6 +86,12 @@ namespace VNLib.Hashing
         /// </summary>
         public static bool SupportsBlake2b => IsAlgSupported(HashAlg.BlAKE2B);
 
+        /// <summary>
+        /// Gets a value that indicates whether the current runtime has the required libraries 
+        /// available to support the BLAKE3 hashing algorithm
+        /// </summary>
+        public static bool SupportsBlake3 => IsAlgSupported(HashAlg.BLAKE3);
+
         /// <summary>
         /// Gets a value that indicates whether the current platform supports the SHA3 
         /// hashing algorithm.
@@ -103,6 +110,7 @@ namespace VNLib.Hashing
             HashAlg.SHA3_384 => Sha3_384.IsSupported,
             HashAlg.SHA3_256 => Sha3_256.IsSupported,
             HashAlg.BlAKE2B => Blake2b.IsSupported,
+            HashAlg.BLAKE3 => Blake3.IsSupported,
             HashAlg.SHA512 => true, //Built-in functions are always supported
             HashAlg.SHA384 => true,
             HashAlg.SHA256 => true,
@@ -123,6 +131,7 @@ namespace VNLib.Hashing
             HashAlg.SHA3_384 => _3_sha384.HashSize,
             HashAlg.SHA3_256 => _3_sha256.HashSize,
             HashAlg.BlAKE2B => _blake2bAlg.HashSize,
+            HashAlg.BLAKE3 => _blake3Alg.HashSize,
             HashAlg.SHA512 => _sha512Alg.HashSize,
             HashAlg.SHA384 => _sha384Alg.HashSize,
             HashAlg.SHA256 => _sha256Alg.HashSize,
@@ -370,6 +379,7 @@ namespace VNLib.Hashing
                 HashAlg.SHA3_384 => computeHashInternal(in _3_sha384, data, buffer, key),
                 HashAlg.SHA3_256 => computeHashInternal(in _3_sha256, data, buffer, key),
                 HashAlg.BlAKE2B => computeHashInternal(in _blake2bAlg, data, buffer, key),
+                HashAlg.BLAKE3 => computeHashInternal(in _blake3Alg, data, buffer, key),
                 HashAlg.SHA512 => computeHashInternal(in _sha512Alg, data, buffer, key),
                 HashAlg.SHA384 => computeHashInternal(in _sha384Alg, data, buffer, key),
                 HashAlg.SHA256 => computeHashInternal(in _sha256Alg, data, buffer, key),
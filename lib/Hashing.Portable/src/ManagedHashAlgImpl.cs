@@ -209,5 +209,45 @@ namespace VNLib.Hashing
                 return count == output.Length;
             }
         }
+
+        private readonly struct Blake3 : IHashAlgorithm
+        {
+            public static bool IsSupported => MonoCypherLibrary.CanLoadDefaultLibrary();
+
+            ///<inheritdoc/>
+            public readonly int HashSize => MCBlake3Module.DefaultHashSize;
+
+            ///<inheritdoc/>
+            public readonly bool TryComputeHash(ReadOnlySpan<byte> data, Span<byte> output, out int count)
+            {
+                //Blake3 is an XOF, so enforce the fixed hash size like the other algorithms
+                if (output.Length > HashSize)
+                {
+                    output = output[..HashSize];
+                }
+
+                count = MonoCypherLibrary.Shared.Blake3ComputeHash(data, output);
+                return count == output.Length;
+            }
+
+            ///<inheritdoc/>
+            public readonly bool TryComputeHmac(ReadOnlySpan<byte> key, ReadOnlySpan<byte> data, Span<byte> output, out int count)
+            {
+                if (output.Length > HashSize)
+                {
+                    output = output[..HashSize];
+                }
+
+                //Keyed mode requires an exact size key, there is no key derivation like HMAC
+                if (key.Length != MCBlake3Module.KeySize)
+                {
+                    count = 0;
+                    return false;
+                }
+
+                count = MonoCypherLibrary.Shared.Blake3ComputeHash(data, output, key);
+                return count == output.Length;
+            }
+        }
     }
 }
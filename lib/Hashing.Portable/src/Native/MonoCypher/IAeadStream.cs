@@ -0,0 +1,63 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: IAeadStream.cs 
+*
+* IAeadStream.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+
+namespace VNLib.Hashing.Native.MonoCypher
+{
+    /// <summary>
+    /// An authenticated encryption stream that encrypts or decrypts an ordered
+    /// sequence of messages with a single key/nonce pair. The internal key is
+    /// ratcheted after every message, so messages must be decrypted in the
+    /// same order they were encrypted.
+    /// </summary>
+    public interface IAeadStream : IDisposable
+    {
+        /// <summary>
+        /// The number of messages that have been processed by this stream
+        /// </summary>
+        ulong MessageCount { get; }
+
+        /// <summary>
+        /// Encrypts the next message in the stream and writes the authentication
+        /// tag to the mac buffer
+        /// </summary>
+        /// <param name="plainText">The message to encrypt</param>
+        /// <param name="cipherText">The output buffer, must be at least the size of the plain text</param>
+        /// <param name="mac">The mac output buffer, must be exactly <see cref="MCAeadModule.MacSize"/> bytes</param>
+        /// <param name="associatedData">Optional data to authenticate but not encrypt</param>
+        void Encrypt(ReadOnlySpan<byte> plainText, Span<byte> cipherText, Span<byte> mac, ReadOnlySpan<byte> associatedData);
+
+        /// <summary>
+        /// Authenticates and decrypts the next message in the stream. If authentication
+        /// fails, the stream state is not advanced and the plain text buffer is not written.
+        /// </summary>
+        /// <param name="cipherText">The encrypted message</param>
+        /// <param name="plainText">The output buffer, must be at least the size of the cipher text</param>
+        /// <param name="mac">The message authentication tag</param>
+        /// <param name="associatedData">Optional data that was authenticated with the message</param>
+        /// <returns>True if the message was authenticated and decrypted, false otherwise</returns>
+        bool Decrypt(ReadOnlySpan<byte> cipherText, Span<byte> plainText, ReadOnlySpan<byte> mac, ReadOnlySpan<byte> associatedData);
+    }
+}
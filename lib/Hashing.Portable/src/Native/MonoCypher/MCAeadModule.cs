@@ -0,0 +1,609 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: MCAeadModule.cs 
+*
+* MCAeadModule.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+
+using VNLib.Utils;
+using VNLib.Utils.Memory;
+using VNLib.Utils.Extensions;
+
+namespace VNLib.Hashing.Native.MonoCypher
+{
+    /// <summary>
+    /// Adds XChaCha20-Poly1305 authenticated encryption support to the <see cref="MonoCypherLibrary"/>
+    /// <para>
+    /// <seealso href="https://monocypher.org/manual/aead"/>
+    /// </para>
+    /// </summary>
+    public static unsafe class MCAeadModule
+    {
+        [SafeMethodName("AeadStreamStructSize")]
+        internal delegate uint AeadStreamStructSize();
+
+        [SafeMethodName("AeadInitStream")]
+        internal delegate int AeadInitStream(IntPtr stream, byte* key, byte* nonce);
+
+        [SafeMethodName("AeadEncrypt")]
+        internal delegate int AeadEncrypt(IntPtr stream, byte* ad, uint adSize, byte* plainText, byte* cipherText, uint textSize, byte* mac);
+
+        [SafeMethodName("AeadDecrypt")]
+        internal delegate int AeadDecrypt(IntPtr stream, byte* ad, uint adSize, byte* cipherText, byte* plainText, uint textSize, byte* mac);
+
+        [SafeMethodName("AeadStreamGetCounter")]
+        internal delegate ulong AeadStreamGetCounter(IntPtr stream);
+
+        [SafeMethodName("AeadLock")]
+        internal delegate int AeadLock(byte* key, byte* nonce, byte* ad, uint adSize, byte* plainText, byte* cipherText, uint textSize, byte* mac);
+
+        [SafeMethodName("AeadUnlock")]
+        internal delegate int AeadUnlock(byte* key, byte* nonce, byte* ad, uint adSize, byte* cipherText, byte* plainText, uint textSize, byte* mac);
+
+        [SafeMethodName("AeadLockBatch")]
+        internal delegate int AeadLockBatch(byte* key, AeadBatchMessage* messages, uint count);
+
+        [SafeMethodName("AeadUnlockBatch")]
+        internal delegate int AeadUnlockBatch(byte* key, AeadBatchMessage* messages, uint count);
+
+        /// <summary>
+        /// The size (in bytes) of the secret key
+        /// </summary>
+        public const int KeySize = 32;
+        /// <summary>
+        /// The size (in bytes) of the extended XChaCha20 nonce
+        /// </summary>
+        public const int NonceSize = 24;
+        /// <summary>
+        /// The size (in bytes) of the Poly1305 authentication tag
+        /// </summary>
+        public const int MacSize = 16;
+
+        /*
+         * Batches are split into fixed size chunks so the message descriptor
+         * array can live on the stack regardless of the number of messages
+         */
+        const int BatchChunkSize = 32;
+
+        //Error codes from the native library
+        const int ERR_NULL_PTR = -1;
+        const int ERR_MAC_MISMATCH = -32;
+        const int ERR_NONCE_EXHAUSTED = -33;
+
+        /// <summary>
+        /// Encrypts and authenticates a single message with the specified key and nonce. A nonce
+        /// must never be reused with the same key, random nonces are safe to use.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="key">The <see cref="KeySize"/> byte secret key</param>
+        /// <param name="nonce">The <see cref="NonceSize"/> byte unique nonce</param>
+        /// <param name="plainText">The message to encrypt</param>
+        /// <param name="cipherText">The cipher text output buffer, must be at least the size of the plain text</param>
+        /// <param name="mac">The <see cref="MacSize"/> byte authentication tag output buffer</param>
+        /// <param name="associatedData">Optional data to authenticate but not encrypt</param>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static void AeadLockMessage(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> key,
+            ReadOnlySpan<byte> nonce,
+            ReadOnlySpan<byte> plainText,
+            Span<byte> cipherText,
+            Span<byte> mac,
+            ReadOnlySpan<byte> associatedData = default
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ValidateKeyAndNonce(key, nonce);
+            ArgumentOutOfRangeException.ThrowIfNotEqual(mac.Length, MacSize, nameof(mac));
+            ArgumentOutOfRangeException.ThrowIfLessThan(cipherText.Length, plainText.Length, nameof(cipherText));
+
+            fixed (byte* keyPtr = &MemoryMarshal.GetReference(key),
+                noncePtr = &MemoryMarshal.GetReference(nonce),
+                adPtr = &MemoryMarshal.GetReference(associatedData),
+                ptPtr = &MemoryMarshal.GetReference(plainText),
+                ctPtr = &MemoryMarshal.GetReference(cipherText),
+                macPtr = &MemoryMarshal.GetReference(mac)
+            )
+            {
+                int result = library.Functions.AeadLock(
+                    keyPtr,
+                    noncePtr,
+                    adPtr,
+                    (uint)associatedData.Length,
+                    ptPtr,
+                    ctPtr,
+                    (uint)plainText.Length,
+                    macPtr
+                );
+
+                ThrowOnAeadError(result);
+            }
+        }
+
+        /// <summary>
+        /// Authenticates and decrypts a single message that was encrypted with <see cref="AeadLockMessage"/>.
+        /// The plain text buffer is not written if authentication fails.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="key">The <see cref="KeySize"/> byte secret key</param>
+        /// <param name="nonce">The <see cref="NonceSize"/> byte nonce the message was encrypted with</param>
+        /// <param name="cipherText">The encrypted message</param>
+        /// <param name="plainText">The plain text output buffer, must be at least the size of the cipher text</param>
+        /// <param name="mac">The <see cref="MacSize"/> byte authentication tag</param>
+        /// <param name="associatedData">Optional data that was authenticated with the message</param>
+        /// <returns>
+        /// True if the message was authenticated and decrypted, false if authentication failed
+        /// </returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static bool AeadUnlockMessage(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> key,
+            ReadOnlySpan<byte> nonce,
+            ReadOnlySpan<byte> cipherText,
+            Span<byte> plainText,
+            ReadOnlySpan<byte> mac,
+            ReadOnlySpan<byte> associatedData = default
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ValidateKeyAndNonce(key, nonce);
+            ArgumentOutOfRangeException.ThrowIfNotEqual(mac.Length, MacSize, nameof(mac));
+            ArgumentOutOfRangeException.ThrowIfLessThan(plainText.Length, cipherText.Length, nameof(plainText));
+
+            fixed (byte* keyPtr = &MemoryMarshal.GetReference(key),
+                noncePtr = &MemoryMarshal.GetReference(nonce),
+                adPtr = &MemoryMarshal.GetReference(associatedData),
+                ctPtr = &MemoryMarshal.GetReference(cipherText),
+                ptPtr = &MemoryMarshal.GetReference(plainText),
+                macPtr = &MemoryMarshal.GetReference(mac)
+            )
+            {
+                int result = library.Functions.AeadUnlock(
+                    keyPtr,
+                    noncePtr,
+                    adPtr,
+                    (uint)associatedData.Length,
+                    ctPtr,
+                    ptPtr,
+                    (uint)cipherText.Length,
+                    macPtr
+                );
+
+                if (result == ERR_MAC_MISMATCH)
+                {
+                    return false;
+                }
+
+                ThrowOnAeadError(result);
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Encrypts many small messages that share a single key with as few calls into the
+        /// native library as possible. Messages are packed back-to-back in the plain text
+        /// buffer and their sizes are given by <paramref name="messageSizes"/>. Cipher text
+        /// is written with the same layout, nonces and macs are packed at fixed strides.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="key">The <see cref="KeySize"/> byte secret key</param>
+        /// <param name="nonces">A buffer of <see cref="NonceSize"/> byte nonces, one per message</param>
+        /// <param name="plainTexts">The packed plain text messages</param>
+        /// <param name="messageSizes">The size of each message in the packed buffer</param>
+        /// <param name="cipherTexts">The packed cipher text output buffer</param>
+        /// <param name="macs">The <see cref="MacSize"/> byte mac output buffer, one per message</param>
+        /// <param name="associatedData">Optional data authenticated with every message</param>
+        /// <returns>The number of messages that were encrypted</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static ERRNO AeadLockMessages(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> key,
+            ReadOnlySpan<byte> nonces,
+            ReadOnlySpan<byte> plainTexts,
+            ReadOnlySpan<int> messageSizes,
+            Span<byte> cipherTexts,
+            Span<byte> macs,
+            ReadOnlySpan<byte> associatedData = default
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ValidateBatch(key, nonces, plainTexts, messageSizes, cipherTexts, macs);
+
+            //Macs are written by the native library on lock
+            fixed (byte* macPtr = &MemoryMarshal.GetReference(macs))
+            {
+                return ExecBatch(
+                    library,
+                    false,
+                    key,
+                    nonces,
+                    plainTexts,
+                    messageSizes,
+                    cipherTexts,
+                    macPtr,
+                    associatedData,
+                    default
+                );
+            }
+        }
+
+        /// <summary>
+        /// Authenticates and decrypts many small messages that share a single key with as few
+        /// calls into the native library as possible. Uses the same packed layout as
+        /// <see cref="AeadLockMessages"/>.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="key">The <see cref="KeySize"/> byte secret key</param>
+        /// <param name="nonces">A buffer of <see cref="NonceSize"/> byte nonces, one per message</param>
+        /// <param name="cipherTexts">The packed cipher text messages</param>
+        /// <param name="messageSizes">The size of each message in the packed buffer</param>
+        /// <param name="plainTexts">The packed plain text output buffer</param>
+        /// <param name="macs">The <see cref="MacSize"/> byte macs, one per message</param>
+        /// <param name="authenticated">An optional buffer that receives the authentication result of each message</param>
+        /// <param name="associatedData">Optional data authenticated with every message</param>
+        /// <returns>The number of messages that were authenticated and decrypted</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static ERRNO AeadUnlockMessages(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> key,
+            ReadOnlySpan<byte> nonces,
+            ReadOnlySpan<byte> cipherTexts,
+            ReadOnlySpan<int> messageSizes,
+            Span<byte> plainTexts,
+            ReadOnlySpan<byte> macs,
+            Span<bool> authenticated = default,
+            ReadOnlySpan<byte> associatedData = default
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ValidateBatch(key, nonces, cipherTexts, messageSizes, plainTexts, macs);
+
+            if (!authenticated.IsEmpty)
+            {
+                ArgumentOutOfRangeException.ThrowIfLessThan(authenticated.Length, messageSizes.Length, nameof(authenticated));
+            }
+
+            //Macs are only read by the native library on unlock
+            fixed (byte* macPtr = &MemoryMarshal.GetReference(macs))
+            {
+                return ExecBatch(
+                    library,
+                    true,
+                    key,
+                    nonces,
+                    cipherTexts,
+                    messageSizes,
+                    plainTexts,
+                    macPtr,
+                    associatedData,
+                    authenticated
+                );
+            }
+        }
+
+        /// <summary>
+        /// Creates a new <see cref="IAeadStream"/> for encrypting or decrypting an ordered
+        /// sequence of messages with a single key/nonce pair.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="key">The <see cref="KeySize"/> byte secret key</param>
+        /// <param name="nonce">The <see cref="NonceSize"/> byte unique nonce</param>
+        /// <param name="heap">The heap to allocate the stream state on</param>
+        /// <returns>The initialized <see cref="IAeadStream"/></returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static IAeadStream AeadCreateStream(this MonoCypherLibrary library, ReadOnlySpan<byte> key, ReadOnlySpan<byte> nonce, IUnmangedHeap? heap)
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ValidateKeyAndNonce(key, nonce);
+
+            //Fall back to the shared heap if none is provided
+            heap ??= MemoryUtil.Shared;
+
+            AeadStream stream = new(library, heap);
+            try
+            {
+                stream.Initialize(key, nonce);
+                return stream;
+            }
+            catch
+            {
+                stream.Dispose();
+                throw;
+            }
+        }
+
+        private static ERRNO ExecBatch(
+            MonoCypherLibrary library,
+            bool unlock,
+            ReadOnlySpan<byte> key,
+            ReadOnlySpan<byte> nonces,
+            ReadOnlySpan<byte> input,
+            ReadOnlySpan<int> messageSizes,
+            Span<byte> output,
+            byte* macPtr,
+            ReadOnlySpan<byte> associatedData,
+            Span<bool> results
+        )
+        {
+            AeadBatchMessage* messages = stackalloc AeadBatchMessage[BatchChunkSize];
+            int processed = 0, offset = 0;
+
+            fixed (byte* keyPtr = &MemoryMarshal.GetReference(key),
+                noncePtr = &MemoryMarshal.GetReference(nonces),
+                adPtr = &MemoryMarshal.GetReference(associatedData),
+                inPtr = &MemoryMarshal.GetReference(input),
+                outPtr = &MemoryMarshal.GetReference(output)
+            )
+            {
+                try
+                {
+                    for (int start = 0; start < messageSizes.Length; start += BatchChunkSize)
+                    {
+                        int count = Math.Min(BatchChunkSize, messageSizes.Length - start);
+
+                        //Build message descriptors for the current chunk
+                        for (int i = 0; i < count; i++)
+                        {
+                            int index = start + i;
+
+                            messages[i] = new AeadBatchMessage
+                            {
+                                nonce = noncePtr + (index * NonceSize),
+                                ad = adPtr,
+                                adSize = (uint)associatedData.Length,
+                                input = inPtr + offset,
+                                output = outPtr + offset,
+                                textSize = (uint)messageSizes[index],
+                                mac = macPtr + (index * MacSize),
+                            };
+
+                            offset += messageSizes[index];
+                        }
+
+                        int result = unlock
+                            ? library.Functions.AeadUnlockBatch(keyPtr, messages, (uint)count)
+                            : library.Functions.AeadLockBatch(keyPtr, messages, (uint)count);
+
+                        //A negative result is a fatal argument error for the entire batch
+                        if (result < 0)
+                        {
+                            return result;
+                        }
+
+                        processed += result;
+
+                        if (!results.IsEmpty)
+                        {
+                            for (int i = 0; i < count; i++)
+                            {
+                                results[start + i] = messages[i].result == 0;
+                            }
+                        }
+                    }
+                }
+                finally
+                {
+                    //Clear descriptors, they point to sensitive buffers
+                    MemoryUtil.InitializeBlock((byte*)messages, sizeof(AeadBatchMessage) * BatchChunkSize);
+                }
+            }
+
+            return processed;
+        }
+
+        private static void ValidateKeyAndNonce(ReadOnlySpan<byte> key, ReadOnlySpan<byte> nonce)
+        {
+            ArgumentOutOfRangeException.ThrowIfNotEqual(key.Length, KeySize, nameof(key));
+            ArgumentOutOfRangeException.ThrowIfNotEqual(nonce.Length, NonceSize, nameof(nonce));
+        }
+
+        private static void ValidateBatch(
+            ReadOnlySpan<byte> key,
+            ReadOnlySpan<byte> nonces,
+            ReadOnlySpan<byte> input,
+            ReadOnlySpan<int> messageSizes,
+            Span<byte> output,
+            ReadOnlySpan<byte> macs
+        )
+        {
+            ArgumentOutOfRangeException.ThrowIfNotEqual(key.Length, KeySize, nameof(key));
+            ArgumentOutOfRangeException.ThrowIfLessThan(nonces.Length, messageSizes.Length * NonceSize, nameof(nonces));
+            ArgumentOutOfRangeException.ThrowIfLessThan(macs.Length, messageSizes.Length * MacSize, nameof(macs));
+
+            long total = 0;
+            foreach (int size in messageSizes)
+            {
+                ArgumentOutOfRangeException.ThrowIfNegative(size, nameof(messageSizes));
+                total += size;
+            }
+
+            if (total > input.Length)
+            {
+                throw new ArgumentException("The sum of all message sizes is larger than the input buffer", nameof(input));
+            }
+
+            if (total > output.Length)
+            {
+                throw new ArgumentException("The output buffer is too small to hold all messages", nameof(output));
+            }
+        }
+
+        private static void ThrowOnAeadError(int result)
+        {
+#pragma warning disable CA2208 // Instantiate argument exceptions correctly
+
+            switch (result)
+            {
+                //Success
+                case 0:
+                    break;
+                //Null pointer
+                case ERR_NULL_PTR:
+                    throw new ArgumentException("An illegal null pointer was passed to the function");
+
+                case ERR_NONCE_EXHAUSTED:
+                    throw new InvalidOperationException("The stream message counter has been exhausted, the stream must be re-keyed");
+
+                default:
+                    throw new Exception($"An unknown error occured during encryption: {result}");
+            }
+
+#pragma warning restore CA2208 // Instantiate argument exceptions correctly
+        }
+
+        /*
+         * Must match the AeadBatchMessage struct in the native library
+         */
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct AeadBatchMessage
+        {
+            public byte* nonce;
+            public byte* ad;
+            public byte* input;
+            public byte* output;
+            public byte* mac;
+            public uint adSize;
+            public uint textSize;
+            public int result;
+        }
+
+        private sealed class AeadStream : SafeHandle, IAeadStream
+        {
+            private readonly MonoCypherLibrary _library;
+            private readonly IUnmangedHeap _heap;
+            private int _stateSize;
+
+            ///<inheritdoc/>
+            public override bool IsInvalid => handle == IntPtr.Zero;
+
+            internal AeadStream(MonoCypherLibrary library, IUnmangedHeap heap) : base(IntPtr.Zero, true)
+            {
+                Debug.Assert(library != null, "Library argument passed to internal aead stream constructor is null");
+                _library = library;
+                _heap = heap;
+            }
+
+            ///<inheritdoc/>
+            public ulong MessageCount
+            {
+                get
+                {
+                    this.ThrowIfClosed();
+                    return _library.Functions.AeadStreamGetCounter(handle);
+                }
+            }
+
+            internal void Initialize(ReadOnlySpan<byte> key, ReadOnlySpan<byte> nonce)
+            {
+                ObjectDisposedException.ThrowIf(IsClosed, this);
+
+                //Alloc the stream state on the heap, zeroed
+                _stateSize = (int)_library.Functions.AeadStreamStructSize();
+                handle = _heap.Alloc(1, (nuint)_stateSize, true);
+
+                fixed (byte* keyPtr = &MemoryMarshal.GetReference(key),
+                    noncePtr = &MemoryMarshal.GetReference(nonce))
+                {
+                    int result = _library.Functions.AeadInitStream(handle, keyPtr, noncePtr);
+                    ThrowOnAeadError(result);
+                }
+            }
+
+            ///<inheritdoc/>
+            public void Encrypt(ReadOnlySpan<byte> plainText, Span<byte> cipherText, Span<byte> mac, ReadOnlySpan<byte> associatedData)
+            {
+                this.ThrowIfClosed();
+                ArgumentOutOfRangeException.ThrowIfNotEqual(mac.Length, MacSize, nameof(mac));
+                ArgumentOutOfRangeException.ThrowIfLessThan(cipherText.Length, plainText.Length, nameof(cipherText));
+
+                fixed (byte* adPtr = &MemoryMarshal.GetReference(associatedData),
+                    ptPtr = &MemoryMarshal.GetReference(plainText),
+                    ctPtr = &MemoryMarshal.GetReference(cipherText),
+                    macPtr = &MemoryMarshal.GetReference(mac)
+                )
+                {
+                    int result = _library.Functions.AeadEncrypt(
+                        handle,
+                        adPtr,
+                        (uint)associatedData.Length,
+                        ptPtr,
+                        ctPtr,
+                        (uint)plainText.Length,
+                        macPtr
+                    );
+
+                    ThrowOnAeadError(result);
+                }
+            }
+
+            ///<inheritdoc/>
+            public bool Decrypt(ReadOnlySpan<byte> cipherText, Span<byte> plainText, ReadOnlySpan<byte> mac, ReadOnlySpan<byte> associatedData)
+            {
+                this.ThrowIfClosed();
+                ArgumentOutOfRangeException.ThrowIfNotEqual(mac.Length, MacSize, nameof(mac));
+                ArgumentOutOfRangeException.ThrowIfLessThan(plainText.Length, cipherText.Length, nameof(plainText));
+
+                fixed (byte* adPtr = &MemoryMarshal.GetReference(associatedData),
+                    ctPtr = &MemoryMarshal.GetReference(cipherText),
+                    ptPtr = &MemoryMarshal.GetReference(plainText),
+                    macPtr = &MemoryMarshal.GetReference(mac)
+                )
+                {
+                    int result = _library.Functions.AeadDecrypt(
+                        handle,
+                        adPtr,
+                        (uint)associatedData.Length,
+                        ctPtr,
+                        ptPtr,
+                        (uint)cipherText.Length,
+                        macPtr
+                    );
+
+                    if (result == ERR_MAC_MISMATCH)
+                    {
+                        return false;
+                    }
+
+                    ThrowOnAeadError(result);
+                    return true;
+                }
+            }
+
+            ///<inheritdoc/>
+            protected override bool ReleaseHandle()
+            {
+                //Wipe the ratcheted key state before freeing
+                MemoryUtil.InitializeBlock((byte*)handle, _stateSize);
+                return _heap.Free(ref handle);
+            }
+        }
+    }
+}
@@ -54,6 +54,15 @@ namespace VNLib.Hashing.Native.MonoCypher
         [SafeMethodName("Blake2GetHashSize")]
         internal delegate uint Blake2GetHashSize(IntPtr context);
 
+        [SafeMethodName("Blake2ComputeMany")]
+        internal delegate int Blake2ComputeMany(uint count, void** messages, uint* lengths, void** outputs, uint hashLen, void* key, uint keyLen);
+
+        /*
+         * Batches are split into fixed size chunks so the pointer arrays
+         * can live on the stack regardless of the number of messages
+         */
+        const int BatchChunkSize = 64;
+
         /// <summary>
         /// The maximum hash size (in bytes) the Blake2b algorithm supports
         /// </summary>
@@ -276,6 +285,104 @@ namespace VNLib.Hashing.Native.MonoCypher
             return output.Length;
         }
 
+        /// <summary>
+        /// Computes the Blake2b hash (or keyed MAC when a key is specified) of many small messages
+        /// with as few calls into the native library as possible. Messages are packed back to back
+        /// in the messages buffer and their sizes are given in order. Every hash is 
+        /// <paramref name="hashSize"/> bytes and is written back to back in the hashes buffer. 
+        /// On x64 cpus with AVX2 support, messages are hashed 4 at a time unless the native 
+        /// library was configured with VNLIB_MONOCYPHER_NO_AVX2.
+        /// </summary>
+        /// <remarks>
+        /// Groups of 4 messages are hashed together until the longest one completes, so similarly 
+        /// sized messages (tokens, session ids, cache keys) get the most benefit.
+        /// </remarks>
+        /// <param name="library"></param>
+        /// <param name="messages">The packed messages to hash</param>
+        /// <param name="messageSizes">The size of each message in the packed buffer</param>
+        /// <param name="hashes">The output buffer, must be at least <paramref name="hashSize"/> bytes per message</param>
+        /// <param name="hashSize">The size of every hash between 1 and <see cref="MaxHashSize"/> inclusive</param>
+        /// <param name="key">An optional key of at most <see cref="MaxKeySize"/> bytes, used to compute a keyed MAC</param>
+        /// <returns>The number of messages hashed or the error code from the native library</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static ERRNO Blake2ComputeHashBatch(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> messages,
+            ReadOnlySpan<int> messageSizes,
+            Span<byte> hashes,
+            int hashSize,
+            ReadOnlySpan<byte> key = default
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(hashSize);
+            ArgumentOutOfRangeException.ThrowIfGreaterThan(hashSize, MaxHashSize);
+            ArgumentOutOfRangeException.ThrowIfGreaterThan(key.Length, MaxKeySize, nameof(key));
+            ArgumentOutOfRangeException.ThrowIfLessThan(hashes.Length, messageSizes.Length * (long)hashSize, nameof(hashes));
+
+            long total = 0;
+            foreach (int size in messageSizes)
+            {
+                ArgumentOutOfRangeException.ThrowIfNegative(size, nameof(messageSizes));
+                total += size;
+            }
+
+            if (total > messages.Length)
+            {
+                throw new ArgumentException("The sum of all message sizes is larger than the messages buffer", nameof(messages));
+            }
+
+            void** msgPtrs = stackalloc void*[BatchChunkSize];
+            void** outPtrs = stackalloc void*[BatchChunkSize];
+            uint* lengths = stackalloc uint[BatchChunkSize];
+
+            int processed = 0, offset = 0;
+
+            fixed (byte* msgPtr = &MemoryMarshal.GetReference(messages),
+                hashPtr = &MemoryMarshal.GetReference(hashes),
+                keyPtr = &MemoryMarshal.GetReference(key)
+            )
+            {
+                for (int start = 0; start < messageSizes.Length; start += BatchChunkSize)
+                {
+                    int count = Math.Min(BatchChunkSize, messageSizes.Length - start);
+
+                    for (int i = 0; i < count; i++)
+                    {
+                        int index = start + i;
+
+                        msgPtrs[i] = msgPtr + offset;
+                        lengths[i] = (uint)messageSizes[index];
+                        outPtrs[i] = hashPtr + (index * hashSize);
+
+                        offset += messageSizes[index];
+                    }
+
+                    int result = library.Functions.Blake2ComputeMany(
+                        (uint)count,
+                        msgPtrs,
+                        lengths,
+                        outPtrs,
+                        (uint)hashSize,
+                        keyPtr,
+                        (uint)key.Length
+                    );
+
+                    //A negative result is an argument error for the entire chunk
+                    if (result < 0)
+                    {
+                        return result;
+                    }
+
+                    processed += result;
+                }
+            }
+
+            return processed;
+        }
+
         //Error codes from the native library
         const int ERR_NULL_PTR = -1;
         const int ERR_HASH_LEN_INVLID = -16;
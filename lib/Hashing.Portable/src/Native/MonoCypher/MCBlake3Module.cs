@@ -0,0 +1,380 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: MCBlake3Module.cs 
+*
+* MCBlake3Module.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+
+using System;
+using System.IO;
+using System.Diagnostics;
+using System.IO.MemoryMappedFiles;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+using VNLib.Utils;
+using VNLib.Utils.Memory;
+using VNLib.Utils.Extensions;
+
+namespace VNLib.Hashing.Native.MonoCypher
+{
+    /// <summary>
+    /// Adds BLAKE3 hashing support to the <see cref="MonoCypherLibrary"/>
+    /// </summary>
+    public static unsafe class MCBlake3Module
+    {
+        [SafeMethodName("Blake3GetContextSize")]
+        internal delegate uint Blake3GetContextSize();
+
+        [SafeMethodName("Blake3Init")]
+        internal delegate int Blake3Init(IntPtr context, void* key, uint keyLen);
+
+        [SafeMethodName("Blake3Update")]
+        internal delegate int Blake3Update(IntPtr context, void* data, uint dataLen);
+
+        [SafeMethodName("Blake3Final")]
+        internal delegate int Blake3Final(IntPtr context, void* hash, uint hashLen);
+
+        [SafeMethodName("Blake3HashParallel")]
+        internal delegate int Blake3HashParallel(void* data, ulong dataLen, void* key, uint keyLen, void* hash, uint hashLen, uint threads);
+
+        /// <summary>
+        /// The default (and recommended) BLAKE3 hash size in bytes. BLAKE3 is an extendable 
+        /// output function so any non-zero output size may be requested.
+        /// </summary>
+        public const int DefaultHashSize = 32;
+
+        /// <summary>
+        /// The exact size (in bytes) of a BLAKE3 key for keyed hashing
+        /// </summary>
+        public const int KeySize = 32;
+
+        /// <summary>
+        /// Creates a new <see cref="IHashStream"/> instance with the specified output hash size
+        /// </summary>
+        /// <remarks>
+        /// <seealso href="https://github.com/BLAKE3-team/BLAKE3-specs"/>
+        /// </remarks>
+        /// <param name="library"></param>
+        /// <param name="hashSize">The non-zero size of the hash output, <see cref="DefaultHashSize"/> is recommended</param>
+        /// <param name="heap">The heap to allocate the stream on</param>
+        /// <returns>The initialzied <see cref="IHashStream"/> instance</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static IHashStream Blake3CreateStream(this MonoCypherLibrary library, byte hashSize, IUnmangedHeap? heap)
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentOutOfRangeException.ThrowIfZero(hashSize);
+
+            //Fall back to the shared heap if none is provided
+            heap ??= MemoryUtil.Shared;
+
+            Blake3Stream stream = new(library, heap, hashSize);
+            try
+            {
+                stream.Initialize();
+                return stream;
+            }
+            catch
+            {
+                stream.Dispose();
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Creates a new <see cref="IHmacStream"/> keyed hash instance with the specified output hash
+        /// size. You must initialize the instance with a <see cref="KeySize"/> byte key before use, 
+        /// otherwise results are undefined.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="hashSize">The non-zero size of the hash output, <see cref="DefaultHashSize"/> is recommended</param>
+        /// <param name="heap">The heap to allocate the stream on</param>
+        /// <returns>The uninitialized keyed stream</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static IHmacStream Blake3CreateHmacStream(this MonoCypherLibrary library, byte hashSize, IUnmangedHeap? heap)
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentOutOfRangeException.ThrowIfZero(hashSize);
+
+            //Fall back to the shared heap if none is provided
+            heap ??= MemoryUtil.Shared;
+
+            //Return the raw stream, it will be initialized later
+            return new Blake3Stream(library, heap, hashSize);
+        }
+
+        /// <summary>
+        /// Computes the BLAKE3 hash of the data buffer on the calling thread and writes it to 
+        /// the variable-length output buffer. If a key is specified, a keyed hash (MAC) is 
+        /// computed instead.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="data">The data buffer to compute the hash of</param>
+        /// <param name="output">The hash output buffer, any non-zero size is allowed</param>
+        /// <param name="key">An optional <see cref="KeySize"/> byte key</param>
+        /// <returns>The number of bytes written to the output buffer or the error code from the native library</returns>
+        public static ERRNO Blake3ComputeHash(this MonoCypherLibrary library, ReadOnlySpan<byte> data, Span<byte> output, ReadOnlySpan<byte> key = default)
+            => Blake3ComputeHashParallel(library, data, output, 1, key);
+
+        /// <summary>
+        /// Computes the BLAKE3 hash of a large data buffer by hashing independent subtrees of 
+        /// the input on up to <paramref name="threads"/> native threads. Small inputs are always 
+        /// hashed on the calling thread. If a key is specified, a keyed hash (MAC) is computed instead.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="data">The data buffer to compute the hash of</param>
+        /// <param name="output">The hash output buffer, any non-zero size is allowed</param>
+        /// <param name="threads">The maximum number of threads to use</param>
+        /// <param name="key">An optional <see cref="KeySize"/> byte key</param>
+        /// <returns>The number of bytes written to the output buffer or the error code from the native library</returns>
+        public static ERRNO Blake3ComputeHashParallel(this MonoCypherLibrary library, ReadOnlySpan<byte> data, Span<byte> output, int threads, ReadOnlySpan<byte> key = default)
+        {
+            fixed (byte* dataPtr = &MemoryMarshal.GetReference(data))
+            {
+                return ComputeHash(library, dataPtr, (ulong)data.Length, output, threads, key);
+            }
+        }
+
+        /// <summary>
+        /// Memory maps the entire file and computes its BLAKE3 hash on up to <paramref name="threads"/> 
+        /// native threads. The file position is not used or modified. If a key is specified, a keyed 
+        /// hash (MAC) is computed instead.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="file">The readable file to hash</param>
+        /// <param name="output">The hash output buffer, any non-zero size is allowed</param>
+        /// <param name="threads">The maximum number of threads to use, 0 uses one thread per processor</param>
+        /// <param name="key">An optional <see cref="KeySize"/> byte key</param>
+        /// <returns>The number of bytes written to the output buffer or the error code from the native library</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="IOException"></exception>
+        public static ERRNO Blake3ComputeFileHash(this MonoCypherLibrary library, FileStream file, Span<byte> output, int threads = 0, ReadOnlySpan<byte> key = default)
+        {
+            ArgumentNullException.ThrowIfNull(file);
+            ArgumentOutOfRangeException.ThrowIfNegative(threads);
+
+            if (threads == 0)
+            {
+                threads = Environment.ProcessorCount;
+            }
+
+            long length = file.Length;
+
+            //Empty files cannot be mapped
+            if (length == 0)
+            {
+                return ComputeHash(library, null, 0, output, 1, key);
+            }
+
+            using MemoryMappedFile map = MemoryMappedFile.CreateFromFile(file, null, 0, MemoryMappedFileAccess.Read, HandleInheritability.None, true);
+            using MemoryMappedViewAccessor view = map.CreateViewAccessor(0, length, MemoryMappedFileAccess.Read);
+
+            byte* basePtr = null;
+            view.SafeMemoryMappedViewHandle.AcquirePointer(ref basePtr);
+            try
+            {
+                return ComputeHash(library, basePtr + view.PointerOffset, (ulong)length, output, threads, key);
+            }
+            finally
+            {
+                view.SafeMemoryMappedViewHandle.ReleasePointer();
+            }
+        }
+
+        private static ERRNO ComputeHash(MonoCypherLibrary library, byte* data, ulong length, Span<byte> output, int threads, ReadOnlySpan<byte> key)
+        {
+            ArgumentNullException.ThrowIfNull(library);
+
+            if (output.IsEmpty)
+            {
+                return ERR_HASH_LEN_INVALID;
+            }
+
+            if (!key.IsEmpty && key.Length != KeySize)
+            {
+                return ERR_KEY_LEN_INVALID;
+            }
+
+            fixed (byte* keyPtr = &MemoryMarshal.GetReference(key),
+                hashPtr = &MemoryMarshal.GetReference(output))
+            {
+                int result = library.Functions.Blake3HashParallel(
+                    data,
+                    length,
+                    keyPtr,
+                    (uint)key.Length,
+                    hashPtr,
+                    (uint)output.Length,
+                    (uint)Math.Max(threads, 1)
+                );
+
+                return result == 0 ? output.Length : result;
+            }
+        }
+
+        //Error codes from the native library
+        const int ERR_NULL_PTR = -1;
+        const int ERR_HASH_LEN_INVALID = -16;
+        const int ERR_KEY_LEN_INVALID = -17;
+
+        private static void ThrowOnBlake3Error(int result)
+        {
+#pragma warning disable CA2208 // Instantiate argument exceptions correctly
+
+            switch (result)
+            {
+                //Success
+                case 0:
+                    break;
+                //Null pointer
+                case ERR_NULL_PTR:
+                    throw new ArgumentException("An illegal null pointer was passed to the function");
+                //Invalid hash length
+                case ERR_HASH_LEN_INVALID:
+                    throw new ArgumentOutOfRangeException("hashLen", "The hash length is invalid");
+                //Invalid key length
+                case ERR_KEY_LEN_INVALID:
+                    throw new ArgumentOutOfRangeException("keyLen", $"The key must be exactly {KeySize} bytes");
+
+                default:
+                    throw new Exception($"An unknown error occured while hashing: {result}");
+
+            }
+#pragma warning restore CA2208 // Instantiate argument exceptions correctly
+        }
+
+        private sealed class Blake3Stream : SafeHandle, IHashStream, IHmacStream
+        {
+            private readonly MonoCypherLibrary _library;
+            private readonly IUnmangedHeap _heap;
+
+            ///<inheritdoc/>
+            public override bool IsInvalid => handle == IntPtr.Zero;
+
+            internal Blake3Stream(MonoCypherLibrary library, IUnmangedHeap heap, byte hashSize) : base(IntPtr.Zero, true)
+            {
+                Debug.Assert(hashSize > 0, "Hash size must be greater than 0");
+                Debug.Assert(library != null, "Library argument passed to internal blake3 stream constructur is null");
+                _library = library;
+                _heap = heap;
+                HashSize = hashSize;
+            }
+
+            internal void Initialize()
+            {
+                //Make sure context is initialized
+                InitContextHandle();
+
+                //Init non-keyed
+                int initResult = _library.Functions.Blake3Init(handle, null, 0);
+                ThrowOnBlake3Error(initResult);
+            }
+
+            ///<inheritdoc/>
+            public byte HashSize { get; }
+
+            ///<inheritdoc/>
+            public int MaxKeySize => KeySize;
+
+            ///<inheritdoc/>
+            public void Flush(ref byte hashOut, byte hashSize)
+            {
+                this.ThrowIfClosed();
+
+                if (Unsafe.IsNullRef(ref hashOut))
+                {
+                    throw new ArgumentNullException(nameof(hashOut));
+                }
+
+                //Guard for hash size
+                if (hashSize != HashSize)
+                {
+                    throw new ArgumentException("The hash output must be the configured hash size", nameof(hashSize));
+                }
+
+                fixed (byte* hashOutPtr = &hashOut)
+                {
+                    int result = _library.Functions.Blake3Final(handle, hashOutPtr, hashSize);
+                    ThrowOnBlake3Error(result);
+                }
+            }
+
+            ///<inheritdoc/>
+            public void Initialize(ref readonly byte key, byte keySize)
+            {
+                if (Unsafe.IsNullRef(in key))
+                {
+                    throw new ArgumentNullException(nameof(key));
+                }
+
+                //Blake3 keys are fixed size
+                ArgumentOutOfRangeException.ThrowIfNotEqual(keySize, KeySize);
+
+                //Make sure context is initialized
+                InitContextHandle();
+
+                fixed (byte* keyPtr = &key)
+                {
+                    int result = _library.Functions.Blake3Init(handle, keyPtr, keySize);
+                    ThrowOnBlake3Error(result);
+                }
+            }
+
+            ///<inheritdoc/>
+            public void Update(ref readonly byte mRef, uint mSize)
+            {
+                this.ThrowIfClosed();
+
+                if (Unsafe.IsNullRef(in mRef))
+                {
+                    throw new ArgumentNullException(nameof(mRef));
+                }
+
+                if (mSize == 0)
+                {
+                    return;
+                }
+
+                fixed (byte* message = &mRef)
+                {
+                    int result = _library.Functions.Blake3Update(handle, message, mSize);
+                    ThrowOnBlake3Error(result);
+                }
+            }
+
+            private void InitContextHandle()
+            {
+                ObjectDisposedException.ThrowIf(IsClosed, this);
+
+                //alloc buffer on the heap if not allocated
+                if (handle == IntPtr.Zero)
+                {
+                    handle = _heap.Alloc(1, _library.Functions.Blake3GetContextSize(), true);
+                }
+            }
+
+            ///<inheritdoc/>
+            protected override bool ReleaseHandle() => _heap.Free(ref handle);
+        }
+    }
+}
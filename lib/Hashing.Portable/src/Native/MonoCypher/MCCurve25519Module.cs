@@ -0,0 +1,280 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: MCCurve25519Module.cs 
+*
+* MCCurve25519Module.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Runtime.InteropServices;
+using System.Security.Cryptography;
+
+using VNLib.Utils;
+using VNLib.Utils.Extensions;
+
+namespace VNLib.Hashing.Native.MonoCypher
+{
+    /// <summary>
+    /// Adds Ed25519 signatures and X25519 key exchange support to the <see cref="MonoCypherLibrary"/>
+    /// <para>
+    /// <seealso href="https://monocypher.org/manual/ed25519"/>
+    /// <seealso href="https://monocypher.org/manual/x25519"/>
+    /// </para>
+    /// </summary>
+    public static unsafe class MCCurve25519Module
+    {
+        [SafeMethodName("Ed25519KeyPair")]
+        internal delegate int Ed25519KeyPair(byte* secretKey, byte* publicKey, byte* seed);
+
+        [SafeMethodName("Ed25519Sign")]
+        internal delegate int Ed25519Sign(byte* signature, byte* secretKey, byte* message, uint messageSize);
+
+        [SafeMethodName("Ed25519Verify")]
+        internal delegate int Ed25519Verify(byte* signature, byte* publicKey, byte* message, uint messageSize);
+
+        [SafeMethodName("X25519PublicKey")]
+        internal delegate int X25519PublicKey(byte* publicKey, byte* secretKey);
+
+        [SafeMethodName("X25519SharedSecret")]
+        internal delegate int X25519SharedSecret(byte* sharedSecret, byte* secretKey, byte* theirPublicKey);
+
+        /// <summary>
+        /// The size (in bytes) of the random seed an Ed25519 key pair is derived from
+        /// </summary>
+        public const int Ed25519SeedSize = 32;
+        /// <summary>
+        /// The size (in bytes) of an expanded Ed25519 secret key, the seed followed by the public key
+        /// </summary>
+        public const int Ed25519SecretKeySize = 64;
+        /// <summary>
+        /// The size (in bytes) of an Ed25519 public key
+        /// </summary>
+        public const int Ed25519PublicKeySize = 32;
+        /// <summary>
+        /// The size (in bytes) of an Ed25519 signature
+        /// </summary>
+        public const int Ed25519SignatureSize = 64;
+        /// <summary>
+        /// The size (in bytes) of X25519 secret keys, public keys and shared secrets
+        /// </summary>
+        public const int X25519KeySize = 32;
+
+        //Error codes from the native library
+        const int ERR_NULL_PTR = -1;
+        const int ERR_SIGNATURE_INVALID = -48;
+        const int ERR_X25519_WEAK_KEY = -49;
+
+        /// <summary>
+        /// Derives an Ed25519 key pair from a random seed. The seed is the private key as
+        /// it is stored in a JWK, the expanded secret key is used for signing.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="seed">The <see cref="Ed25519SeedSize"/> byte random seed</param>
+        /// <param name="secretKey">The <see cref="Ed25519SecretKeySize"/> byte expanded secret key output buffer</param>
+        /// <param name="publicKey">The <see cref="Ed25519PublicKeySize"/> byte public key output buffer</param>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static void Ed25519CreateKeyPair(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> seed,
+            Span<byte> secretKey,
+            Span<byte> publicKey
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentOutOfRangeException.ThrowIfNotEqual(seed.Length, Ed25519SeedSize, nameof(seed));
+            ArgumentOutOfRangeException.ThrowIfNotEqual(secretKey.Length, Ed25519SecretKeySize, nameof(secretKey));
+            ArgumentOutOfRangeException.ThrowIfNotEqual(publicKey.Length, Ed25519PublicKeySize, nameof(publicKey));
+
+            fixed (byte* seedPtr = &MemoryMarshal.GetReference(seed),
+                skPtr = &MemoryMarshal.GetReference(secretKey),
+                pkPtr = &MemoryMarshal.GetReference(publicKey)
+            )
+            {
+                int result = library.Functions.Ed25519KeyPair(skPtr, pkPtr, seedPtr);
+                ThrowOnCurveError(result);
+            }
+        }
+
+        /// <summary>
+        /// Computes the Ed25519 signature of the entire message. EdDSA does not sign a 
+        /// message digest, the message is hashed internally with SHA-512.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="secretKey">The <see cref="Ed25519SecretKeySize"/> byte expanded secret key</param>
+        /// <param name="message">The message to sign</param>
+        /// <param name="signature">The signature output buffer, must be at least <see cref="Ed25519SignatureSize"/> bytes</param>
+        /// <returns>The number of bytes written to the signature buffer</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static ERRNO Ed25519SignMessage(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> secretKey,
+            ReadOnlySpan<byte> message,
+            Span<byte> signature
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentOutOfRangeException.ThrowIfNotEqual(secretKey.Length, Ed25519SecretKeySize, nameof(secretKey));
+            ArgumentOutOfRangeException.ThrowIfLessThan(signature.Length, Ed25519SignatureSize, nameof(signature));
+
+            fixed (byte* skPtr = &MemoryMarshal.GetReference(secretKey),
+                msgPtr = &MemoryMarshal.GetReference(message),
+                sigPtr = &MemoryMarshal.GetReference(signature)
+            )
+            {
+                int result = library.Functions.Ed25519Sign(sigPtr, skPtr, msgPtr, (uint)message.Length);
+                return result == 0 ? Ed25519SignatureSize : result;
+            }
+        }
+
+        /// <summary>
+        /// Verifies the Ed25519 signature of the entire message
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="publicKey">The <see cref="Ed25519PublicKeySize"/> byte public key of the signer</param>
+        /// <param name="message">The message that was signed</param>
+        /// <param name="signature">The signature to verify</param>
+        /// <returns>True if the signature is valid for the message and public key, false otherwise</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static bool Ed25519VerifyMessage(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> publicKey,
+            ReadOnlySpan<byte> message,
+            ReadOnlySpan<byte> signature
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentOutOfRangeException.ThrowIfNotEqual(publicKey.Length, Ed25519PublicKeySize, nameof(publicKey));
+
+            //A mis-sized signature is simply invalid
+            if (signature.Length != Ed25519SignatureSize)
+            {
+                return false;
+            }
+
+            fixed (byte* pkPtr = &MemoryMarshal.GetReference(publicKey),
+                msgPtr = &MemoryMarshal.GetReference(message),
+                sigPtr = &MemoryMarshal.GetReference(signature)
+            )
+            {
+                int result = library.Functions.Ed25519Verify(sigPtr, pkPtr, msgPtr, (uint)message.Length);
+
+                if (result == ERR_SIGNATURE_INVALID)
+                {
+                    return false;
+                }
+
+                ThrowOnCurveError(result);
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Computes the X25519 public key for a random secret key
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="secretKey">The <see cref="X25519KeySize"/> byte random secret key</param>
+        /// <param name="publicKey">The <see cref="X25519KeySize"/> byte public key output buffer</param>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static void X25519GetPublicKey(this MonoCypherLibrary library, ReadOnlySpan<byte> secretKey, Span<byte> publicKey)
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentOutOfRangeException.ThrowIfNotEqual(secretKey.Length, X25519KeySize, nameof(secretKey));
+            ArgumentOutOfRangeException.ThrowIfNotEqual(publicKey.Length, X25519KeySize, nameof(publicKey));
+
+            fixed (byte* skPtr = &MemoryMarshal.GetReference(secretKey),
+                pkPtr = &MemoryMarshal.GetReference(publicKey)
+            )
+            {
+                int result = library.Functions.X25519PublicKey(pkPtr, skPtr);
+                ThrowOnCurveError(result);
+            }
+        }
+
+        /// <summary>
+        /// Computes the raw X25519 shared secret between your secret key and a peer's public
+        /// key. The raw secret is not uniformly random, it must be passed through a KDF
+        /// (for example keyed Blake2b) before it is used as a key.
+        /// </summary>
+        /// <param name="library"></param>
+        /// <param name="secretKey">Your <see cref="X25519KeySize"/> byte secret key</param>
+        /// <param name="theirPublicKey">The peer's <see cref="X25519KeySize"/> byte public key</param>
+        /// <param name="sharedSecret">The <see cref="X25519KeySize"/> byte shared secret output buffer</param>
+        /// <returns>
+        /// The number of bytes written to the shared secret buffer, or the error code from the native 
+        /// library if the peer's public key is a low order point
+        /// </returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static ERRNO X25519ComputeSharedSecret(
+            this MonoCypherLibrary library,
+            ReadOnlySpan<byte> secretKey,
+            ReadOnlySpan<byte> theirPublicKey,
+            Span<byte> sharedSecret
+        )
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentOutOfRangeException.ThrowIfNotEqual(secretKey.Length, X25519KeySize, nameof(secretKey));
+            ArgumentOutOfRangeException.ThrowIfNotEqual(theirPublicKey.Length, X25519KeySize, nameof(theirPublicKey));
+            ArgumentOutOfRangeException.ThrowIfNotEqual(sharedSecret.Length, X25519KeySize, nameof(sharedSecret));
+
+            fixed (byte* skPtr = &MemoryMarshal.GetReference(secretKey),
+                pkPtr = &MemoryMarshal.GetReference(theirPublicKey),
+                ssPtr = &MemoryMarshal.GetReference(sharedSecret)
+            )
+            {
+                int result = library.Functions.X25519SharedSecret(ssPtr, skPtr, pkPtr);
+
+                if (result == ERR_X25519_WEAK_KEY)
+                {
+                    return result;
+                }
+
+                ThrowOnCurveError(result);
+                return X25519KeySize;
+            }
+        }
+
+        private static void ThrowOnCurveError(int result)
+        {
+#pragma warning disable CA2208 // Instantiate argument exceptions correctly
+
+            switch (result)
+            {
+                case 0:
+                    break;
+                //Null pointer
+                case ERR_NULL_PTR:
+                    throw new ArgumentException("An illegal null pointer was passed to the function");
+                case ERR_SIGNATURE_INVALID:
+                    throw new CryptographicException("The signature is not valid");
+                case ERR_X25519_WEAK_KEY:
+                    throw new CryptographicException("The public key is a low order point");
+                default:
+                    throw new CryptographicException($"The native library returned an unexpected error code {result}");
+            }
+
+#pragma warning restore CA2208 // Instantiate argument exceptions correctly
+        }
+    }
+}
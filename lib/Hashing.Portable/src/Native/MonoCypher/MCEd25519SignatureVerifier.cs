@@ -0,0 +1,48 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Hashing.Portable
+* File: MCEd25519SignatureVerifier.cs 
+*
+* MCEd25519SignatureVerifier.cs is part of VNLib.Hashing.Portable which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Hashing.Portable is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Hashing.Portable is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Hashing.Portable. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+
+using VNLib.Hashing.IdentityUtility;
+
+namespace VNLib.Hashing.Native.MonoCypher
+{
+    /// <summary>
+    /// An <see cref="IJwtSignatureVerifier"/> that verifies Ed25519 (JWS EdDSA) signatures 
+    /// using the <see cref="MonoCypherLibrary"/>.
+    /// </summary>
+    /// <remarks>
+    /// EdDSA signs the entire message rather than a message digest, so this verifier must be 
+    /// used with the JWT verification methods that do not take a <see cref="HashAlg"/>. The input 
+    /// buffer is always verified as the message.
+    /// </remarks>
+    /// <param name="library">The library used to verify signatures</param>
+    /// <param name="publicKey">The <see cref="MCCurve25519Module.Ed25519PublicKeySize"/> byte public key of the signer</param>
+    public readonly struct MCEd25519SignatureVerifier(MonoCypherLibrary library, ReadOnlyMemory<byte> publicKey) : IJwtSignatureVerifier
+    {
+        ///<inheritdoc/>
+        public readonly bool Verify(ReadOnlySpan<byte> messageHash, ReadOnlySpan<byte> signature) 
+            => library.Ed25519VerifyMessage(publicKey.Span, messageHash, signature);
+    }
+}
@@ -37,6 +37,11 @@ namespace VNLib.Hashing.Native.MonoCypher
     /// <seealso href="https://monocypher.org/manual/argon2"/>
     /// </para>
     /// </summary>
+    /// <remarks>
+    /// When the parallelism cost is greater than 1, the native library fills lanes 
+    /// on multiple threads (one per lane) so a hash completes in a fraction of 
+    /// the single-threaded time. Results are identical to the reference library.
+    /// </remarks>
     public static unsafe class MCPasswordModule
     {
 
@@ -65,6 +70,21 @@ namespace VNLib.Hashing.Native.MonoCypher
             return new Argon2HashLib(Library, heap);
         }
 
+        /// <summary>
+        /// Creates a new <see cref="IArgon2Library"/> instance that rents work areas from 
+        /// the provided <paramref name="pool"/> instead of allocating one for every hash.
+        /// </summary>
+        /// <param name="Library"></param>
+        /// <param name="pool">The pool to rent work areas from</param>
+        /// <returns>The <see cref="IArgon2Library"/> wrapper instance</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        public static IArgon2Library Argon2CreateLibrary(this MonoCypherLibrary Library, Argon2WorkAreaPool pool)
+        {
+            ArgumentNullException.ThrowIfNull(Library);
+            ArgumentNullException.ThrowIfNull(pool);
+            return new Argon2PooledHashLib(Library, pool);
+        }
+
         private static void Hash(this MonoCypherLibrary library, IUnmangedHeap heap, Argon2Context* context)
         {
             ArgumentNullException.ThrowIfNull(library);
@@ -92,6 +112,31 @@ namespace VNLib.Hashing.Native.MonoCypher
             }
         }
 
+        private static void Hash(this MonoCypherLibrary library, Argon2WorkAreaPool pool, Argon2Context* context)
+        {
+            ArgumentNullException.ThrowIfNull(library);
+            ArgumentNullException.ThrowIfNull(pool);
+
+            ValidateContext(context);
+
+            CalcWorkAreaSize(context, out uint elements, out uint alignment);
+
+            //Pooled work areas are page aligned which satisfies the native alignment
+            nuint size = (nuint)elements * alignment;
+            IntPtr workArea = pool.Rent(size);
+
+            try
+            {
+                Argon2_ErrorCodes result = library.Functions.Argon2Hash(context, workArea.ToPointer());
+                VnArgon2.ThrowOnArgonErr(result);
+            }
+            finally
+            {
+                //Wipes the work area before it can be reused
+                pool.Return(workArea, size);
+            }
+        }
+
         /*
          * Since unmanaged heaps are being utilized and they support alignment args, we can compute
          * a proper alignment value and element count for the work area that best matches the native
@@ -148,6 +193,19 @@ namespace VNLib.Hashing.Native.MonoCypher
                 return 0;
             }
         }
+
+        private sealed record class Argon2PooledHashLib(MonoCypherLibrary Library, Argon2WorkAreaPool Pool) : IArgon2Library
+        {
+
+            ///<inheritdoc/>
+            public int Argon2Hash(IntPtr context)
+            {
+                ArgumentNullException.ThrowIfNull((void*)context);
+
+                Hash(Library, Pool, (Argon2Context*)context);
+                return 0;
+            }
+        }
     }
 
 }
\ No newline at end of file
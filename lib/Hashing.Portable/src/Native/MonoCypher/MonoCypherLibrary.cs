@@ -140,6 +140,32 @@ namespace VNLib.Hashing.Native.MonoCypher
                 Blake2Update = library.DangerousGetFunction<MCBlake2Module.Blake2Update>(),
                 Blake2Final = library.DangerousGetFunction<MCBlake2Module.Blake2Final>(),
                 Blake2GethashSize = library.DangerousGetFunction<MCBlake2Module.Blake2GetHashSize>(),
+                Blake2ComputeMany = library.DangerousGetFunction<MCBlake2Module.Blake2ComputeMany>(),
+
+                //Blake3
+                Blake3GetContextSize = library.DangerousGetFunction<MCBlake3Module.Blake3GetContextSize>(),
+                Blake3Init = library.DangerousGetFunction<MCBlake3Module.Blake3Init>(),
+                Blake3Update = library.DangerousGetFunction<MCBlake3Module.Blake3Update>(),
+                Blake3Final = library.DangerousGetFunction<MCBlake3Module.Blake3Final>(),
+                Blake3HashParallel = library.DangerousGetFunction<MCBlake3Module.Blake3HashParallel>(),
+
+                //Aead
+                AeadStreamStructSize = library.DangerousGetFunction<MCAeadModule.AeadStreamStructSize>(),
+                AeadInitStream = library.DangerousGetFunction<MCAeadModule.AeadInitStream>(),
+                AeadEncrypt = library.DangerousGetFunction<MCAeadModule.AeadEncrypt>(),
+                AeadDecrypt = library.DangerousGetFunction<MCAeadModule.AeadDecrypt>(),
+                AeadStreamGetCounter = library.DangerousGetFunction<MCAeadModule.AeadStreamGetCounter>(),
+                AeadLock = library.DangerousGetFunction<MCAeadModule.AeadLock>(),
+                AeadUnlock = library.DangerousGetFunction<MCAeadModule.AeadUnlock>(),
+                AeadLockBatch = library.DangerousGetFunction<MCAeadModule.AeadLockBatch>(),
+                AeadUnlockBatch = library.DangerousGetFunction<MCAeadModule.AeadUnlockBatch>(),
+
+                //Curve25519
+                Ed25519KeyPair = library.DangerousGetFunction<MCCurve25519Module.Ed25519KeyPair>(),
+                Ed25519Sign = library.DangerousGetFunction<MCCurve25519Module.Ed25519Sign>(),
+                Ed25519Verify = library.DangerousGetFunction<MCCurve25519Module.Ed25519Verify>(),
+                X25519PublicKey = library.DangerousGetFunction<MCCurve25519Module.X25519PublicKey>(),
+                X25519SharedSecret = library.DangerousGetFunction<MCCurve25519Module.X25519SharedSecret>(),
             };
         }
 
@@ -164,6 +190,32 @@ namespace VNLib.Hashing.Native.MonoCypher
             public readonly MCBlake2Module.Blake2Update Blake2Update { get; init; }           
             public readonly MCBlake2Module.Blake2Final Blake2Final { get; init; }
             public readonly MCBlake2Module.Blake2GetHashSize Blake2GethashSize { get; init; }
+            public readonly MCBlake2Module.Blake2ComputeMany Blake2ComputeMany { get; init; }
+
+            //Blake3 module
+            public readonly MCBlake3Module.Blake3GetContextSize Blake3GetContextSize { get; init; }
+            public readonly MCBlake3Module.Blake3Init Blake3Init { get; init; }
+            public readonly MCBlake3Module.Blake3Update Blake3Update { get; init; }
+            public readonly MCBlake3Module.Blake3Final Blake3Final { get; init; }
+            public readonly MCBlake3Module.Blake3HashParallel Blake3HashParallel { get; init; }
+
+            //Aead module
+            public readonly MCAeadModule.AeadStreamStructSize AeadStreamStructSize { get; init; }
+            public readonly MCAeadModule.AeadInitStream AeadInitStream { get; init; }
+            public readonly MCAeadModule.AeadEncrypt AeadEncrypt { get; init; }
+            public readonly MCAeadModule.AeadDecrypt AeadDecrypt { get; init; }
+            public readonly MCAeadModule.AeadStreamGetCounter AeadStreamGetCounter { get; init; }
+            public readonly MCAeadModule.AeadLock AeadLock { get; init; }
+            public readonly MCAeadModule.AeadUnlock AeadUnlock { get; init; }
+            public readonly MCAeadModule.AeadLockBatch AeadLockBatch { get; init; }
+            public readonly MCAeadModule.AeadUnlockBatch AeadUnlockBatch { get; init; }
+
+            //Curve25519 module
+            public readonly MCCurve25519Module.Ed25519KeyPair Ed25519KeyPair { get; init; }
+            public readonly MCCurve25519Module.Ed25519Sign Ed25519Sign { get; init; }
+            public readonly MCCurve25519Module.Ed25519Verify Ed25519Verify { get; init; }
+            public readonly MCCurve25519Module.X25519PublicKey X25519PublicKey { get; init; }
+            public readonly MCCurve25519Module.X25519SharedSecret X25519SharedSecret { get; init; }
         }
     }
 }
\ No newline at end of file
@@ -39,6 +39,15 @@ namespace VNLib.Hashing
 
         private const int MAX_STACK_ALLOC = 128;
 
+        /*
+         * Larger requests amortize the system call on their own, so only small
+         * requests are served from the per-thread generator
+         */
+        private const int MAX_DRBG_REQUEST = 256;
+
+        [ThreadStatic]
+        private static ChaCha20Drbg? _threadDrbg;
+
         /// <summary>
         /// Generates a cryptographic random number, computes the hash, and encodes the hash as a string.
         /// </summary>
@@ -135,6 +144,38 @@ namespace VNLib.Hashing
             }
         }
         
+        /// <summary>
+        /// Generates a cryptographic random number and writes the base64 encoded characters 
+        /// of that number to the output buffer without allocating
+        /// </summary>
+        /// <param name="output">The character buffer to write the base64 string to</param>
+        /// <param name="size">Number of random bytes</param>
+        /// <returns>The number of characters written, or <see cref="ERRNO.E_FAIL"/> if the output buffer was too small</returns>
+        public static ERRNO GetRandomBase64(Span<char> output, int size = 64)
+        {
+            if (output.Length < (size + 2) / 3 * 4)
+            {
+                return ERRNO.E_FAIL;
+            }
+
+            if (size > MAX_STACK_ALLOC)
+            {
+                using UnsafeMemoryHandle<byte> buffer = MemoryUtil.UnsafeAlloc(size);
+
+                GetRandomBytes(buffer.Span);
+
+                return VnEncoding.TryToBase64Chars(buffer.Span, output);
+            }
+            else
+            {
+                Span<byte> buffer = stackalloc byte[size];
+
+                GetRandomBytes(buffer);
+
+                return VnEncoding.TryToBase64Chars(buffer, output);
+            }
+        }
+
         /// <summary>
         /// Generates a cryptographic random number and returns the hex string of that number
         /// </summary>
@@ -197,6 +238,41 @@ namespace VNLib.Hashing
             }
         }
 
+        /// <summary>
+        /// Generates a cryptographic random number and writes the unpadded Base32 encoded 
+        /// characters of that number to the output buffer without allocating
+        /// </summary>
+        /// <param name="output">
+        /// The character buffer to write the base32 string to, must be large enough to hold 
+        /// the padded string even though padding is not included in the result
+        /// </param>
+        /// <param name="size">Number of random bytes</param>
+        /// <returns>The number of characters written, or <see cref="ERRNO.E_FAIL"/> if the output buffer was too small</returns>
+        public static ERRNO GetRandomBase32(Span<char> output, int size = 64)
+        {
+            ERRNO encoded;
+
+            if (size > MAX_STACK_ALLOC)
+            {
+                using UnsafeMemoryHandle<byte> buffer = MemoryUtil.UnsafeAlloc(size);
+
+                GetRandomBytes(buffer.Span);
+
+                encoded = VnEncoding.TryToBase32Chars(buffer.Span, output);
+            }
+            else
+            {
+                Span<byte> buffer = stackalloc byte[size];
+
+                GetRandomBytes(buffer);
+
+                encoded = VnEncoding.TryToBase32Chars(buffer, output);
+            }
+
+            //Trim padding to match the string overload
+            return encoded ? output[..(int)encoded].TrimEnd('=').Length : encoded;
+        }
+
         /// <summary>
         /// Allocates a new byte[] of the specified size and fills it with non-zero random values
         /// </summary>
@@ -210,10 +286,21 @@ namespace VNLib.Hashing
         }
 
         /// <summary>
-        /// Fill the buffer with cryptographically secure non-zero bytes 
+        /// Fill the buffer with cryptographically secure random bytes. Small requests are 
+        /// served from a per-thread <see cref="ChaCha20Drbg"/> seeded from the operating 
+        /// system, larger requests are filled by the operating system directly.
         /// </summary>
         /// <param name="data">Buffer to fill</param>
-        [MethodImpl(MethodImplOptions.NoOptimization)]
-        public static void GetRandomBytes(Span<byte> data) => RandomNumberGenerator.Fill(data);
+        public static void GetRandomBytes(Span<byte> data)
+        {
+            if (data.Length > MAX_DRBG_REQUEST)
+            {
+                RandomNumberGenerator.Fill(data);
+            }
+            else
+            {
+                (_threadDrbg ??= new()).Fill(data);
+            }
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text.Json;
+
+using VNLib.Utils.Memory;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class Argon2CalibrationTests
+    {
+        [TestInitialize()]
+        public void Init()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+        }
+
+        [TestMethod()]
+        public void CalibrateTest()
+        {
+            IArgon2Library lib = MonoCypherLibrary.Shared.Argon2CreateLibrary(MemoryUtil.Shared);
+
+            //A generous latency budget must afford the whole memory ceiling at the highest time cost
+            Argon2CalibrationOptions options = new()
+            {
+                TargetLatency = TimeSpan.FromSeconds(30),
+                Concurrency = 2,
+                MaxMemoryBytes = 16 * 1024 * 1024,
+                MinMemoryCost = 1024,
+                MaxTimeCost = 2,
+                Parallelism = [1],
+                TrialsPerWorker = 1
+            };
+
+            Argon2CalibrationResult result = lib.Calibrate2id(options);
+
+            Assert.IsTrue(result.TargetMet);
+            Assert.AreEqual(2u, result.TimeCost);
+            Assert.AreEqual(8192u, result.MemoryCost);
+            Assert.AreEqual(1u, result.Parallelism);
+            Assert.AreEqual(options.MaxMemoryBytes, result.PeakMemoryBytes);
+
+            using JsonDocument config = JsonDocument.Parse(result.ToConfigBlock());
+            JsonElement argon2 = config.RootElement.GetProperty("argon2");
+            Assert.AreEqual(2u, argon2.GetProperty("time_cost").GetUInt32());
+            Assert.AreEqual(8192u, argon2.GetProperty("memory_cost").GetUInt32());
+            Assert.AreEqual(1u, argon2.GetProperty("parallelism").GetUInt32());
+
+            //An impossible target must report the cheapest parameters
+            result = lib.Calibrate2id(options with { TargetLatency = TimeSpan.FromTicks(1) });
+
+            Assert.IsFalse(result.TargetMet);
+            Assert.AreEqual(1u, result.TimeCost);
+            Assert.AreEqual(1024u, result.MemoryCost);
+
+            //The ceiling must fit the minimum memory cost at the requested concurrency
+            Assert.ThrowsException<ArgumentException>(() => lib.Calibrate2id(options with { Concurrency = 32 }));
+        }
+    }
+}
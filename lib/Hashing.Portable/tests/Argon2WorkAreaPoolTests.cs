@@ -0,0 +1,151 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using VNLib.Utils.Memory;
+
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public unsafe class Argon2WorkAreaPoolTests
+    {
+        [TestMethod()]
+        public void RentReturnTest()
+        {
+            const nuint size = 64 * 1024;
+
+            using Argon2WorkAreaPool pool = new(size * 2, false);
+
+            IntPtr first = pool.Rent(size);
+            new Span<byte>(first.ToPointer(), (int)size).Fill(0xAA);
+
+            pool.Return(first, size);
+            Assert.AreEqual(size, pool.PooledBytes);
+
+            //The same block must be reused and must have been wiped
+            IntPtr second = pool.Rent(size);
+            Assert.AreEqual(first, second);
+            Assert.AreEqual(-1, new Span<byte>(second.ToPointer(), (int)size).IndexOfAnyExcept((byte)0));
+            Assert.AreEqual((nuint)0, pool.PooledBytes);
+
+            pool.Return(second, size);
+        }
+
+        [TestMethod()]
+        public void CapacityTest()
+        {
+            const nuint size = 64 * 1024;
+
+            using Argon2WorkAreaPool pool = new(size * 2, false);
+
+            IntPtr a = pool.Rent(size);
+            IntPtr b = pool.Rent(size);
+            IntPtr c = pool.Rent(size);
+
+            pool.Return(a, size);
+            pool.Return(b, size);
+            pool.Return(c, size);
+
+            //Only two blocks fit, the third must have been freed
+            Assert.AreEqual(size * 2, pool.PooledBytes);
+
+            //A larger size must evict the idle blocks of other sizes
+            IntPtr large = pool.Rent(size * 2);
+            pool.Return(large, size * 2);
+            Assert.AreEqual(size * 2, pool.PooledBytes);
+
+            //Blocks larger than the pool are never retained
+            IntPtr tooLarge = pool.Rent(size * 4);
+            pool.Return(tooLarge, size * 4);
+            Assert.AreEqual(size * 2, pool.PooledBytes);
+
+            pool.Trim();
+            Assert.AreEqual((nuint)0, pool.PooledBytes);
+        }
+
+        [TestMethod()]
+        public void AllocationSizeAccountingTest()
+        {
+            nuint pageSize = (nuint)Environment.SystemPageSize;
+
+            using Argon2WorkAreaPool pool = new(pageSize * 2, false);
+
+            //Partial pages are charged as whole pages
+            IntPtr a = pool.Rent(pageSize / 2);
+            IntPtr b = pool.Rent(pageSize + 1);
+
+            //Rented work areas do not count towards the limit
+            Assert.AreEqual((nuint)0, pool.PooledBytes);
+
+            pool.Return(a, pageSize / 2);
+            Assert.AreEqual(pageSize, pool.PooledBytes);
+
+            //Two pages do not fit next to the first block, so it is evicted
+            pool.Return(b, pageSize + 1);
+            Assert.AreEqual(pageSize * 2, pool.PooledBytes);
+        }
+
+        [TestMethod()]
+        public void HugePageAccountingTest()
+        {
+            if (!OperatingSystem.IsLinux())
+            {
+                Assert.Inconclusive("Huge pages are only used on Linux");
+            }
+
+            const nuint hugePage = 2 * 1024 * 1024;
+            const nuint size = hugePage + 1024;
+
+            using Argon2WorkAreaPool pool = new(hugePage * 3, true);
+
+            IntPtr first = pool.Rent(size);
+            IntPtr second = pool.Rent(size);
+
+            //Each block is charged the two huge pages it maps, only one fits
+            pool.Return(first, size);
+            Assert.AreEqual(hugePage * 2, pool.PooledBytes);
+
+            pool.Return(second, size);
+            Assert.AreEqual(hugePage * 2, pool.PooledBytes);
+
+            IntPtr reused = pool.Rent(size);
+            Assert.AreEqual(first, reused);
+            Assert.AreEqual((nuint)0, pool.PooledBytes);
+
+            pool.Return(reused, size);
+        }
+
+        [TestMethod()]
+        public void PooledHashTest()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+
+            Argon2CostParams costParams = new()
+            {
+                MemoryCost = 1024,
+                TimeCost = 2,
+                Parallelism = 2
+            };
+
+            byte[] password = RandomHash.GetRandomBytes(32);
+            byte[] salt = RandomHash.GetRandomBytes(16);
+
+            using Argon2WorkAreaPool pool = new(16 * 1024 * 1024, true);
+
+            IArgon2Library pooled = MonoCypherLibrary.Shared.Argon2CreateLibrary(pool);
+            IArgon2Library unpooled = MonoCypherLibrary.Shared.Argon2CreateLibrary(MemoryUtil.Shared);
+
+            string expected = unpooled.Hash2id(password, salt, default, in costParams);
+
+            //Hashing several times must reuse the same work area and produce the same result
+            for (int i = 0; i < 3; i++)
+            {
+                Assert.AreEqual(expected, pooled.Hash2id(password, salt, default, in costParams));
+                Assert.AreEqual((nuint)costParams.MemoryCost * 1024, pool.PooledBytes);
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using VNLib.Utils;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class ChaCha20DrbgTests
+    {
+        /*
+         * Keystream of an all zero key from RFC 8439 appendix A.1, the first 32 bytes 
+         * of every refill become the next key so output starts at byte 32 of block 0
+         */
+        const string ZeroSeedFirstOutput = "da41597c5157488d7724e03fb8d84a376a43b8f41518a11cc387b669b2ee6586" 
+            + "9f07e7be5551387a98ba977c732d080dcb0f29a048e3656912c6533e32ee7aed";
+
+        //Output at offset 992, the first bytes after the first refill
+        const string ZeroSeedSecondBufferOutput = "afbdad2845b93cdbb2fe6463d2fe162adae0f6e676f0494218f5ce0596e79f5c" 
+            + "551aaa9ba46faad528f6763dde93c03fa3b121b2ffc0533a695ed56e8fda0589";
+
+        [TestMethod()]
+        public void ChaCha20DrbgKnownOutput()
+        {
+            using ChaCha20Drbg drbg = new(new byte[ChaCha20Drbg.SeedSize]);
+
+            Assert.AreEqual(0L, drbg.ReseedInterval);
+
+            byte[] output = new byte[2048];
+            drbg.Fill(output);
+
+            Assert.AreEqual(ZeroSeedFirstOutput, Convert.ToHexString(output, 0, 64).ToLowerInvariant());
+            Assert.AreEqual(ZeroSeedSecondBufferOutput, Convert.ToHexString(output, 992, 64).ToLowerInvariant());
+        }
+
+        [TestMethod()]
+        public void ChaCha20DrbgSegmentedFill()
+        {
+            byte[] seed = RandomHash.GetRandomBytes(ChaCha20Drbg.SeedSize);
+            byte[] expected = new byte[5000];
+            byte[] actual = new byte[5000];
+
+            using (ChaCha20Drbg drbg = new(seed))
+            {
+                drbg.Fill(expected);
+            }
+
+            //Small segments that straddle refills must produce the same stream
+            using (ChaCha20Drbg drbg = new(seed))
+            {
+                Random rand = new(42);
+
+                for (int offset = 0; offset < actual.Length;)
+                {
+                    int segment = Math.Min(rand.Next(0, 100), actual.Length - offset);
+                    drbg.Fill(actual.AsSpan(offset, segment));
+                    offset += segment;
+                }
+            }
+
+            CollectionAssert.AreEqual(expected, actual);
+        }
+
+        [TestMethod()]
+        public void ChaCha20DrbgReseed()
+        {
+            using ChaCha20Drbg first = new();
+            using ChaCha20Drbg second = new(4096);
+
+            Assert.AreEqual(ChaCha20Drbg.DefaultReseedInterval, first.ReseedInterval);
+            Assert.ThrowsException<ArgumentOutOfRangeException>(() => new ChaCha20Drbg(0));
+            Assert.ThrowsException<ArgumentException>(() => new ChaCha20Drbg(new byte[16]));
+
+            byte[] a = new byte[64];
+            byte[] b = new byte[64];
+
+            first.Fill(a);
+            second.Fill(b);
+            Assert.IsFalse(a.SequenceEqual(b));
+
+            //Output past many reseeds must still be filled
+            byte[] large = new byte[64 * 1024];
+            second.Fill(large);
+            Assert.IsTrue(large.Skip(large.Length - 64).Any(static x => x != 0));
+
+            first.Dispose();
+            Assert.ThrowsException<ObjectDisposedException>(() => first.Fill(a));
+        }
+
+        [TestMethod()]
+        public void RandomHashSpanEncodings()
+        {
+            Span<char> output = stackalloc char[512];
+
+            ERRNO count = RandomHash.GetRandomBase64(output, 32);
+            Assert.AreEqual(44, (int)count);
+            Assert.AreEqual(32, Convert.FromBase64String(output[..(int)count].ToString()).Length);
+
+            //Buffers that are too small must fail without writing
+            Assert.IsFalse(RandomHash.GetRandomBase64(output[..43], 32));
+
+            count = RandomHash.GetRandomBase32(output, 32);
+            Assert.AreEqual(RandomHash.GetRandomBase32(32).Length, (int)count);
+            Assert.AreEqual(32, VnEncoding.FromBase32String(output[..(int)count])!.Length);
+
+            Assert.IsFalse(RandomHash.GetRandomBase32(output[..50], 32));
+
+            //Large sizes go through the heap buffer path
+            Assert.AreEqual(344, (int)RandomHash.GetRandomBase64(output, 256));
+            Assert.AreEqual(RandomHash.GetRandomBase32(200).Length, (int)RandomHash.GetRandomBase32(output, 200));
+        }
+    }
+}
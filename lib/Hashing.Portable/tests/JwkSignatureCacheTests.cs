@@ -0,0 +1,265 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+using System.Collections.Frozen;
+using System.Security.Cryptography;
+
+using VNLib.Utils;
+using VNLib.Hashing.IdentityUtility;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class JwkSignatureCacheTests
+    {
+        /*
+         * RFC 7638 section 3.1 example key and thumbprint
+         */
+        const string Rfc7638Jwk = @"{""kty"":""RSA"",""e"":""AQAB"",""alg"":""RS256"",""kid"":""2011-04-29"",
+            ""n"":""0vx7agoebGcQSuuPiLJXZptN9nndrQmbXEps2aiAFbWhM78LhWx4cbbfAAtVT86zwu1RK7aPFFxuhDR1L6tSoc_BJECPebWKRXjBZCiFV4n3oknjhMstn64tZ_2W-5JsGY4Hc5n9yBXArwl93lqt7_RN5w6Cf0h4QyQ5v-65YGjQR0_FDW2QvzqY368QQMicAtaSqzs8KJZgnYb9c7d0zgdAZHzu6qMQvRL5hajrn1n91CbOpbISD08qNLyrdkt-bFTWhAI4vMQFh6WeZu0fM4lFd2NcRwr3XPksINHaQ-G_xBniIqbw0Ls1jF44-csFCur-kEgU8awapJzKnqDKgw""}";
+
+        const string Rfc7638Thumbprint = "NzbLsXh8uDCcd-6MNwXF4W_7noWXFZAfHkxZsRGC9Xs";
+
+        /*
+         * RFC 8037 appendix A key and thumbprint
+         */
+        const string Rfc8037Jwk = @"{""kty"":""OKP"",""crv"":""Ed25519"",""alg"":""EdDSA"",""use"":""sig"",
+            ""d"":""nWGxne_9WmC6hEr0kuwsxERJxWl7MmkZcDusAxyuf2A"",""x"":""11qYAYKxCrfVS_7TyWQHOg7hcvPapiMlrwIaaPcHURo""}";
+
+        const string Rfc8037Thumbprint = "kPrK_qmxVWaYVA9wwBF6Iuo3vVzz7TxHCTwXBygrS4k";
+
+        [TestMethod()]
+        public void ThumbprintTest()
+        {
+            Assert.AreEqual(Rfc7638Thumbprint, ReadOnlyJsonWebKey.FromJsonString(Rfc7638Jwk).GetThumbprint());
+            Assert.AreEqual(Rfc8037Thumbprint, ReadOnlyJsonWebKey.FromJsonString(Rfc8037Jwk).GetThumbprint());
+
+            using ECDsa ec = ECDsa.Create(ECCurve.NamedCurves.nistP256);
+
+            //Public and private keys of the same pair must share a thumbprint
+            Assert.AreEqual(CreateJwk(ec, "ES256", false).GetThumbprint(), CreateJwk(ec, "ES256", true).GetThumbprint());
+        }
+
+        [TestMethod()]
+        public void SignVerifyTest()
+        {
+            using JwkSignatureCache cache = new();
+
+            using (ECDsa ec = ECDsa.Create(ECCurve.NamedCurves.nistP256))
+            {
+                TestSignVerify(cache, CreateJwk(ec, "ES256", true), CreateJwk(ec, "ES256", false));
+            }
+
+            using (ECDsa ec = ECDsa.Create(ECCurve.NamedCurves.nistP384))
+            {
+                TestSignVerify(cache, CreateJwk(ec, "ES384", true), CreateJwk(ec, "ES384", false));
+            }
+
+            using (RSA rsa = RSA.Create(2048))
+            {
+                TestSignVerify(cache, CreateJwk(rsa, "RS256", true), CreateJwk(rsa, "RS256", false));
+                TestSignVerify(cache, CreateJwk(rsa, "PS512", true), CreateJwk(rsa, "PS512", false));
+            }
+
+            //Each key and algorithm is cached separately for signing and verifying
+            Assert.AreEqual(8, cache.Count);
+        }
+
+        [TestMethod()]
+        public void EdDSATest()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+
+            using JwkSignatureCache cache = new();
+
+            ReadOnlyJsonWebKey jwk = ReadOnlyJsonWebKey.FromJsonString(Rfc8037Jwk);
+            TestSignVerify(cache, jwk, jwk);
+        }
+
+        [TestMethod()]
+        public void RentReuseTest()
+        {
+            using JwkSignatureCache cache = new(maxKeys: 4, maxInstancesPerKey: 2);
+            using ECDsa ec = ECDsa.Create(ECCurve.NamedCurves.nistP256);
+
+            ReadOnlyJsonWebKey jwk = CreateJwk(ec, "ES256", false);
+
+            Assert.IsTrue(cache.TryRentVerifier(in jwk, out JwkSignatureLease first));
+            Assert.AreEqual(jwk.Thumbprint, first.Thumbprint);
+            Assert.AreEqual(HashAlg.SHA256, first.HashAlg);
+
+            //Concurrent rentals get their own instances but share the cached key
+            Assert.IsTrue(cache.TryRentVerifier(in jwk, out JwkSignatureLease second));
+            Assert.IsTrue(cache.TryRentVerifier(in jwk, out JwkSignatureLease third));
+            Assert.AreEqual(1, cache.Count);
+
+            first.Dispose();
+            second.Dispose();
+            third.Dispose();
+
+            //Verification keys must not be rentable as signers
+            Assert.IsFalse(cache.TryRentSigner(in jwk, out _));
+
+            //Encryption keys are not signature keys
+            ReadOnlyJsonWebKey encKey = CreateJwk(ec, "ES256", false, "enc");
+            Assert.IsFalse(cache.TryRentVerifier(in encKey, out _));
+        }
+
+        [TestMethod()]
+        public void ConcurrentVerifyTest()
+        {
+            using JwkSignatureCache cache = new(maxKeys: 2, maxInstancesPerKey: 2);
+            using ECDsa ec = ECDsa.Create(ECCurve.NamedCurves.nistP256);
+
+            ReadOnlyJsonWebKey privKey = CreateJwk(ec, "ES256", true);
+            ReadOnlyJsonWebKey pubKey = CreateJwk(ec, "ES256", false);
+
+            using JsonWebToken jwt = CreateToken("ES256");
+            jwt.SignFromJwk(privKey, cache);
+            string compiled = jwt.Compile();
+
+            Parallel.For(0, 200, new ParallelOptions { MaxDegreeOfParallelism = 8 }, i =>
+            {
+                using JsonWebToken parsed = JsonWebToken.Parse(compiled);
+                Assert.IsTrue(parsed.VerifyFromJwk(pubKey, cache));
+
+                //Rotation happening during verification must not break outstanding leases
+                if (i % 50 == 0)
+                {
+                    cache.Clear();
+                }
+            });
+        }
+
+        [TestMethod()]
+        public void EvictionTest()
+        {
+            using JwkSignatureCache cache = new(maxKeys: 2);
+
+            using ECDsa ec1 = ECDsa.Create(ECCurve.NamedCurves.nistP256);
+            using ECDsa ec2 = ECDsa.Create(ECCurve.NamedCurves.nistP256);
+            using ECDsa ec3 = ECDsa.Create(ECCurve.NamedCurves.nistP256);
+
+            ReadOnlyJsonWebKey k1 = CreateJwk(ec1, "ES256", false);
+            ReadOnlyJsonWebKey k2 = CreateJwk(ec2, "ES256", false);
+            ReadOnlyJsonWebKey k3 = CreateJwk(ec3, "ES256", false);
+
+            Rent(cache, k1);
+            Rent(cache, k2);
+
+            //Touch k1 so k2 is the least recently used key
+            Rent(cache, k1);
+            Rent(cache, k3);
+
+            Assert.AreEqual(2, cache.Count);
+
+            //Rotation removes keys no longer in the key set
+            Assert.AreEqual(1, cache.EvictExcept([k3.Thumbprint!]));
+            Assert.AreEqual(1, cache.Count);
+
+            Assert.IsTrue(cache.Evict(k3.Thumbprint!));
+            Assert.IsFalse(cache.Evict(k3.Thumbprint!));
+            Assert.AreEqual(0, cache.Count);
+
+            cache.Dispose();
+            Assert.ThrowsException<ObjectDisposedException>(() => Rent(cache, k1));
+
+            static void Rent(JwkSignatureCache cache, ReadOnlyJsonWebKey key)
+            {
+                Assert.IsTrue(cache.TryRentVerifier(in key, out JwkSignatureLease lease));
+                lease.Dispose();
+            }
+        }
+
+        static void TestSignVerify(JwkSignatureCache cache, ReadOnlyJsonWebKey privKey, ReadOnlyJsonWebKey pubKey)
+        {
+            using JsonWebToken jwt = CreateToken(pubKey.Algorithm!);
+
+            //Sign twice to use the cached signer
+            jwt.SignFromJwk(privKey, cache);
+            jwt.SignFromJwk(privKey, cache);
+
+            string compiled = jwt.Compile();
+
+            using (JsonWebToken parsed = JsonWebToken.Parse(compiled))
+            {
+                Assert.IsTrue(parsed.VerifyFromJwk(pubKey, cache));
+                Assert.IsTrue(parsed.VerifyFromJwk(pubKey, cache));
+
+                //Must agree with the uncached implementation
+                Assert.IsTrue(parsed.VerifyFromJwk(pubKey));
+            }
+
+            //Tampered payload must fail verification
+            string[] parts = compiled.Split('.');
+            parts[1] = VnEncoding.ToBase64UrlSafeString(Encoding.UTF8.GetBytes(@"{""sub"":""mallory""}"), false);
+
+            using (JsonWebToken parsed = JsonWebToken.Parse(string.Join('.', parts)))
+            {
+                Assert.IsFalse(parsed.VerifyFromJwk(pubKey, cache));
+            }
+        }
+
+        static JsonWebToken CreateToken(string alg)
+        {
+            JsonWebToken jwt = new();
+            jwt.WriteHeader(Encoding.UTF8.GetBytes($@"{{""alg"":""{alg}"",""typ"":""JWT""}}"));
+            jwt.WritePayload(Encoding.UTF8.GetBytes(@"{""sub"":""alice""}"));
+            return jwt;
+        }
+
+        static ReadOnlyJsonWebKey CreateJwk(ECDsa ec, string alg, bool includePrivate, string use = "sig")
+        {
+            ECParameters p = ec.ExportParameters(includePrivate);
+
+            Dictionary<string, string?> props = new(StringComparer.OrdinalIgnoreCase)
+            {
+                ["kty"] = "EC",
+                ["use"] = use,
+                ["alg"] = alg,
+                ["crv"] = p.Curve.Oid.FriendlyName == "nistP384" || p.Curve.Oid.FriendlyName == "ECDSA_P384" ? "P-384" : "P-256",
+                ["x"] = Encode(p.Q.X),
+                ["y"] = Encode(p.Q.Y),
+            };
+
+            if (includePrivate)
+            {
+                props["d"] = Encode(p.D);
+            }
+
+            return new(props.ToFrozenDictionary(StringComparer.OrdinalIgnoreCase));
+        }
+
+        static ReadOnlyJsonWebKey CreateJwk(RSA rsa, string alg, bool includePrivate)
+        {
+            RSAParameters p = rsa.ExportParameters(includePrivate);
+
+            Dictionary<string, string?> props = new(StringComparer.OrdinalIgnoreCase)
+            {
+                ["kty"] = "RSA",
+                ["use"] = "sig",
+                ["alg"] = alg,
+                ["e"] = Encode(p.Exponent),
+                ["n"] = Encode(p.Modulus),
+            };
+
+            if (includePrivate)
+            {
+                props["d"] = Encode(p.D);
+                props["p"] = Encode(p.P);
+                props["q"] = Encode(p.Q);
+                props["dp"] = Encode(p.DP);
+                props["dq"] = Encode(p.DQ);
+                props["qi"] = Encode(p.InverseQ);
+            }
+
+            return new(props.ToFrozenDictionary(StringComparer.OrdinalIgnoreCase));
+        }
+
+        static string Encode(byte[]? data) => VnEncoding.ToBase64UrlSafeString(data, false);
+    }
+}
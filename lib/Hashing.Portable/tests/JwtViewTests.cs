@@ -0,0 +1,169 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+using System.Security.Cryptography;
+
+using VNLib.Hashing.IdentityUtility;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class JwtViewTests
+    {
+        const string Payload = @"{""sub"":""alice"",""scope"":""openid""}";
+
+        /*
+         * RFC 8037 appendix A test vectors
+         */
+        const string Rfc8037PublicJwk = @"{""kty"":""OKP"",""crv"":""Ed25519"",""alg"":""EdDSA"",""use"":""sig"",""x"":""11qYAYKxCrfVS_7TyWQHOg7hcvPapiMlrwIaaPcHURo""}";
+
+        const string Rfc8037Jws = "eyJhbGciOiJFZERTQSJ9.RXhhbXBsZSBvZiBFZDI1NTE5IHNpZ25pbmc" +
+            ".hgyY0il_MGCjP0JzlnLWG1PPOt7-09PGcvMg3AIbQR6dWbhijcNR4ki4iylGjg5BhVsPt9g7sVvpAr_MuM0KAg";
+
+        [TestMethod()]
+        public void ParseTest()
+        {
+            byte[] token = CreateToken("HS256", jwt => jwt.Sign(new byte[32], HashAlg.SHA256));
+
+            Assert.IsTrue(JwtView.TryParse(token, out JwtView view));
+
+            using (JsonWebToken jwt = JsonWebToken.ParseRaw(token))
+            {
+                Assert.IsTrue(jwt.HeaderData.SequenceEqual(view.HeaderData));
+                Assert.IsTrue(jwt.PayloadData.SequenceEqual(view.PayloadData));
+                Assert.IsTrue(jwt.SignatureData.SequenceEqual(view.SignatureData));
+                Assert.IsTrue(jwt.HeaderAndPayload.SequenceEqual(view.HeaderAndPayload));
+            }
+
+            Span<byte> buffer = stackalloc byte[view.PayloadBufferSize];
+            int decoded = view.DecodePayload(buffer);
+            Assert.AreEqual(Payload, Encoding.UTF8.GetString(buffer[..decoded]));
+
+            Assert.IsTrue(view.AlgorithmEquals("HS256"u8));
+            Assert.IsFalse(view.AlgorithmEquals("hs256"u8));
+            Assert.IsFalse(view.AlgorithmEquals("none"u8));
+
+            //Bearer scheme is case insensitive and surrounding whitespace is ignored
+            byte[] bearer = [.. " bearer  "u8, .. token, .. " "u8];
+            Assert.IsTrue(JwtView.TryParseBearer(bearer, out JwtView bearerView));
+            Assert.IsTrue(bearerView.SignatureData.SequenceEqual(view.SignatureData));
+
+            Assert.IsFalse(JwtView.TryParseBearer(token, out _));
+            Assert.IsFalse(JwtView.TryParseBearer("Basic dXNlcjpwYXNz"u8, out _));
+        }
+
+        [TestMethod()]
+        public void MalformedTest()
+        {
+            string[] malformed =
+            [
+                "",
+                "abc",
+                "abc.def",
+                ".def.ghi",
+                "abc.def.ghi.jkl",
+                "ab=.def.ghi",
+                "abc.de+f.ghi",
+                "abc.def.gh/i",
+                "abcde.def.ghi",
+                "abc.d f.ghi",
+            ];
+
+            foreach (string token in malformed)
+            {
+                Assert.IsFalse(JwtView.TryParse(Encoding.UTF8.GetBytes(token), out _), token);
+            }
+
+            //Unsigned tokens may be parsed but never verify
+            Assert.IsTrue(JwtView.TryParse("eyJhbGciOiJub25lIn0.e30."u8, out JwtView unsigned));
+            Assert.IsTrue(unsigned.SignatureData.IsEmpty);
+            Assert.IsTrue(unsigned.AlgorithmEquals("none"u8));
+            Assert.IsFalse(unsigned.Verify(new byte[32], HashAlg.SHA256));
+        }
+
+        [TestMethod()]
+        public void HmacVerifyTest()
+        {
+            byte[] key = RandomHash.GetRandomBytes(64);
+            byte[] token = CreateToken("HS512", jwt => jwt.Sign(key, HashAlg.SHA512));
+
+            Assert.IsTrue(JwtView.TryParse(token, out JwtView view));
+            Assert.IsTrue(view.Verify(key, HashAlg.SHA512));
+            Assert.IsFalse(view.Verify(key, HashAlg.SHA256));
+            Assert.IsFalse(view.Verify(RandomHash.GetRandomBytes(64), HashAlg.SHA512));
+
+            //Verification must not allocate once the hash functions are warm
+            long before = GC.GetAllocatedBytesForCurrentThread();
+            for (int i = 0; i < 100; i++)
+            {
+                Assert.IsTrue(VerifyHmac(token, key));
+            }
+            Assert.AreEqual(0, GC.GetAllocatedBytesForCurrentThread() - before);
+
+            //Tampering with the payload must fail
+            token[token.AsSpan().IndexOf((byte)'.') + 2] ^= 0x01;
+            Assert.IsTrue(JwtView.TryParse(token, out view));
+            Assert.IsFalse(view.Verify(key, HashAlg.SHA512));
+
+            static bool VerifyHmac(byte[] token, byte[] key) => JwtView.TryParse(token, out JwtView view) && view.Verify(key, HashAlg.SHA512);
+        }
+
+        [TestMethod()]
+        public void AsymmetricVerifyTest()
+        {
+            using (ECDsa ec = ECDsa.Create(ECCurve.NamedCurves.nistP256))
+            {
+                byte[] token = CreateToken("ES256", jwt => jwt.Sign(ec, HashAlg.SHA256));
+
+                Assert.IsTrue(JwtView.TryParse(token, out JwtView view));
+                Assert.IsTrue(view.Verify(ec, HashAlg.SHA256));
+
+                using ECDsa other = ECDsa.Create(ECCurve.NamedCurves.nistP256);
+                Assert.IsFalse(view.Verify(other, HashAlg.SHA256));
+            }
+
+            using (RSA rsa = RSA.Create(4096))
+            {
+                byte[] token = CreateToken("PS256", jwt => jwt.Sign(rsa, HashAlg.SHA256, RSASignaturePadding.Pss));
+
+                Assert.IsTrue(JwtView.TryParse(token, out JwtView view));
+                Assert.IsTrue(view.Verify(rsa, HashAlg.SHA256, RSASignaturePadding.Pss));
+                Assert.IsFalse(view.Verify(rsa, HashAlg.SHA256, RSASignaturePadding.Pkcs1));
+            }
+        }
+
+        [TestMethod()]
+        public void EdDSAVerifyTest()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+
+            ReadOnlyJsonWebKey jwk = ReadOnlyJsonWebKey.FromJsonString(Rfc8037PublicJwk);
+            using JwkSignatureCache cache = new();
+
+            Assert.IsTrue(JwtView.TryParse(Encoding.UTF8.GetBytes(Rfc8037Jws), out JwtView view));
+            Assert.IsTrue(view.VerifyFromJwk(in jwk, cache));
+
+            //The same key must not verify a token with a different algorithm
+            byte[] hsToken = CreateToken("HS256", jwt => jwt.Sign(new byte[32], HashAlg.SHA256));
+            Assert.IsTrue(JwtView.TryParse(hsToken, out view));
+            Assert.IsFalse(view.VerifyFromJwk(in jwk, cache));
+
+            byte[] tampered = Encoding.UTF8.GetBytes(Rfc8037Jws.Replace(".RXhh", ".RXhi"));
+            Assert.IsTrue(JwtView.TryParse(tampered, out view));
+            Assert.IsFalse(view.VerifyFromJwk(in jwk, cache));
+        }
+
+        static byte[] CreateToken(string alg, Action<JsonWebToken> sign)
+        {
+            using JsonWebToken jwt = new();
+            jwt.WriteHeader(Encoding.UTF8.GetBytes($@"{{""typ"":""JWT"",""alg"":""{alg}""}}"));
+            jwt.WritePayload(Encoding.UTF8.GetBytes(Payload));
+            sign(jwt);
+            return jwt.DataBuffer.ToArray();
+        }
+    }
+}
@@ -0,0 +1,148 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+
+using VNLib.Utils;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class MCAeadTests
+    {
+        const string TestMessage = "Hello world, this is a test of the XChaCha20-Poly1305 AEAD module";
+
+        [TestInitialize()]
+        public void Init()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+        }
+
+        [TestMethod()]
+        public void LockUnlockTest()
+        {
+            byte[] key = RandomHash.GetRandomBytes(MCAeadModule.KeySize);
+            byte[] nonce = RandomHash.GetRandomBytes(MCAeadModule.NonceSize);
+            byte[] message = Encoding.UTF8.GetBytes(TestMessage);
+            byte[] ad = Encoding.UTF8.GetBytes("associated data");
+
+            byte[] cipherText = new byte[message.Length];
+            byte[] plainText = new byte[message.Length];
+            byte[] mac = new byte[MCAeadModule.MacSize];
+
+            MonoCypherLibrary.Shared.AeadLockMessage(key, nonce, message, cipherText, mac, ad);
+            Assert.IsFalse(message.AsSpan().SequenceEqual(cipherText));
+
+            Assert.IsTrue(MonoCypherLibrary.Shared.AeadUnlockMessage(key, nonce, cipherText, plainText, mac, ad));
+            Assert.IsTrue(message.AsSpan().SequenceEqual(plainText));
+
+            //Tampered cipher text must fail authentication
+            cipherText[0] ^= 0x01;
+            Assert.IsFalse(MonoCypherLibrary.Shared.AeadUnlockMessage(key, nonce, cipherText, plainText, mac, ad));
+
+            //Mismatched associated data must fail authentication
+            cipherText[0] ^= 0x01;
+            Assert.IsFalse(MonoCypherLibrary.Shared.AeadUnlockMessage(key, nonce, cipherText, plainText, mac, default));
+        }
+
+        [TestMethod()]
+        public void LockUnlockEmptyMessageTest()
+        {
+            byte[] key = RandomHash.GetRandomBytes(MCAeadModule.KeySize);
+            byte[] nonce = RandomHash.GetRandomBytes(MCAeadModule.NonceSize);
+            byte[] ad = Encoding.UTF8.GetBytes("associated data");
+            byte[] mac = new byte[MCAeadModule.MacSize];
+
+            //An empty message still produces a mac over the associated data
+            MonoCypherLibrary.Shared.AeadLockMessage(key, nonce, [], [], mac, ad);
+            Assert.IsTrue(MonoCypherLibrary.Shared.AeadUnlockMessage(key, nonce, [], [], mac, ad));
+
+            mac[0] ^= 0x01;
+            Assert.IsFalse(MonoCypherLibrary.Shared.AeadUnlockMessage(key, nonce, [], [], mac, ad));
+        }
+
+        [TestMethod()]
+        public void StreamTest()
+        {
+            byte[] key = RandomHash.GetRandomBytes(MCAeadModule.KeySize);
+            byte[] nonce = RandomHash.GetRandomBytes(MCAeadModule.NonceSize);
+            byte[] message = Encoding.UTF8.GetBytes(TestMessage);
+
+            byte[] cipher1 = new byte[message.Length];
+            byte[] cipher2 = new byte[message.Length];
+            byte[] mac1 = new byte[MCAeadModule.MacSize];
+            byte[] mac2 = new byte[MCAeadModule.MacSize];
+            byte[] plainText = new byte[message.Length];
+
+            using (IAeadStream encStream = MonoCypherLibrary.Shared.AeadCreateStream(key, nonce, null))
+            {
+                encStream.Encrypt(message, cipher1, mac1, default);
+                encStream.Encrypt(message, cipher2, mac2, default);
+                Assert.AreEqual(2UL, encStream.MessageCount);
+            }
+
+            //The key is ratcheted so the same message must produce different cipher text
+            Assert.IsFalse(cipher1.AsSpan().SequenceEqual(cipher2));
+
+            using IAeadStream decStream = MonoCypherLibrary.Shared.AeadCreateStream(key, nonce, null);
+
+            //Out of order messages must fail and must not advance the stream
+            Assert.IsFalse(decStream.Decrypt(cipher2, plainText, mac2, default));
+            Assert.AreEqual(0UL, decStream.MessageCount);
+
+            Assert.IsTrue(decStream.Decrypt(cipher1, plainText, mac1, default));
+            Assert.IsTrue(message.AsSpan().SequenceEqual(plainText));
+
+            Assert.IsTrue(decStream.Decrypt(cipher2, plainText, mac2, default));
+            Assert.IsTrue(message.AsSpan().SequenceEqual(plainText));
+            Assert.AreEqual(2UL, decStream.MessageCount);
+        }
+
+        [TestMethod()]
+        public void BatchTest()
+        {
+            const int messageCount = 100;
+
+            byte[] key = RandomHash.GetRandomBytes(MCAeadModule.KeySize);
+            byte[] nonces = RandomHash.GetRandomBytes(MCAeadModule.NonceSize * messageCount);
+            int[] sizes = new int[messageCount];
+
+            for (int i = 0; i < messageCount; i++)
+            {
+                sizes[i] = i + 1;
+            }
+
+            byte[] messages = RandomHash.GetRandomBytes(sizes.Sum());
+            byte[] cipherTexts = new byte[messages.Length];
+            byte[] plainTexts = new byte[messages.Length];
+            byte[] macs = new byte[MCAeadModule.MacSize * messageCount];
+            bool[] authenticated = new bool[messageCount];
+
+            ERRNO count = MonoCypherLibrary.Shared.AeadLockMessages(key, nonces, messages, sizes, cipherTexts, macs);
+            Assert.AreEqual(messageCount, (int)count);
+
+            //Corrupt a single mac
+            macs[MCAeadModule.MacSize * 10] ^= 0x01;
+
+            count = MonoCypherLibrary.Shared.AeadUnlockMessages(key, nonces, cipherTexts, sizes, plainTexts, macs, authenticated);
+            Assert.AreEqual(messageCount - 1, (int)count);
+            Assert.IsFalse(authenticated[10]);
+            Assert.AreEqual(messageCount - 1, authenticated.Count(static a => a));
+
+            //Every message except the corrupted one must match a single-shot decryption
+            int offset = 0;
+            for (int i = 0; i < messageCount; offset += sizes[i], i++)
+            {
+                if (i == 10)
+                {
+                    continue;
+                }
+
+                Assert.IsTrue(messages.AsSpan(offset, sizes[i]).SequenceEqual(plainTexts.AsSpan(offset, sizes[i])));
+            }
+        }
+    }
+}
@@ -0,0 +1,73 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using VNLib.Utils;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class MCBlake2Tests
+    {
+        [TestInitialize()]
+        public void Init()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+        }
+
+        [TestMethod()]
+        public void BatchHashTest()
+        {
+            //Not a multiple of 4 and larger than a single native chunk
+            const int messageCount = 151;
+            const int hashSize = 32;
+
+            int[] sizes = new int[messageCount];
+
+            for (int i = 0; i < messageCount; i++)
+            {
+                //Mostly short tokens with a few empty and multi-block messages mixed in
+                sizes[i] = i % 17 == 0 ? i * 3 : i % 129;
+            }
+
+            byte[] messages = RandomHash.GetRandomBytes(sizes.Sum());
+            byte[] key = RandomHash.GetRandomBytes(MCBlake2Module.MaxKeySize);
+            byte[] hashes = new byte[messageCount * hashSize];
+            byte[] macs = new byte[messageCount * hashSize];
+            byte[] expected = new byte[hashSize];
+
+            ERRNO count = MonoCypherLibrary.Shared.Blake2ComputeHashBatch(messages, sizes, hashes, hashSize);
+            Assert.AreEqual(messageCount, (int)count);
+
+            count = MonoCypherLibrary.Shared.Blake2ComputeHashBatch(messages, sizes, macs, hashSize, key);
+            Assert.AreEqual(messageCount, (int)count);
+
+            //Every batch result must match the single message functions
+            int offset = 0;
+            for (int i = 0; i < messageCount; offset += sizes[i], i++)
+            {
+                ReadOnlySpan<byte> message = messages.AsSpan(offset, sizes[i]);
+
+                MonoCypherLibrary.Shared.Blake2ComputeHash(message, expected);
+                Assert.IsTrue(expected.AsSpan().SequenceEqual(hashes.AsSpan(i * hashSize, hashSize)));
+
+                MonoCypherLibrary.Shared.Blake2ComputeHmac(key, message, expected);
+                Assert.IsTrue(expected.AsSpan().SequenceEqual(macs.AsSpan(i * hashSize, hashSize)));
+            }
+        }
+
+        [TestMethod()]
+        public void BatchArgumentsTest()
+        {
+            byte[] messages = new byte[64];
+            int[] sizes = [32, 32];
+
+            Assert.ThrowsException<ArgumentOutOfRangeException>(() => MonoCypherLibrary.Shared.Blake2ComputeHashBatch(messages, sizes, new byte[128], 0));
+            Assert.ThrowsException<ArgumentOutOfRangeException>(() => MonoCypherLibrary.Shared.Blake2ComputeHashBatch(messages, sizes, new byte[256], MCBlake2Module.MaxHashSize + 1));
+            Assert.ThrowsException<ArgumentOutOfRangeException>(() => MonoCypherLibrary.Shared.Blake2ComputeHashBatch(messages, sizes, new byte[32], 32));
+            Assert.ThrowsException<ArgumentException>(() => MonoCypherLibrary.Shared.Blake2ComputeHashBatch(messages, [32, 33], new byte[64], 32));
+        }
+    }
+}
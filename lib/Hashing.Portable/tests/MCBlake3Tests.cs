@@ -0,0 +1,124 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.IO;
+using System.Text;
+
+using VNLib.Utils;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class MCBlake3Tests
+    {
+        //Official BLAKE3 test vectors, input byte i is i % 251
+        static readonly (int length, string hash, string keyedHash)[] KnownVectors =
+        [
+            (0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262", "92b2b75604ed3c761f9d6f62392c8a9227ad0ea3f09573e783f1498a4ed60d26"),
+            (1025, "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444", "357dc55de0c7e382c900fd6e320acc04146be01db6a8ce7210b7189bd664ea69"),
+            (102400, "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085", "1c35d1a5811083fd7119f5d5d1ba027b4d01c0c6c49fb6ff2cf75393ea5db4a7"),
+        ];
+
+        static readonly byte[] TestKey = Encoding.UTF8.GetBytes("whats the Elvish word for friend");
+
+        [TestInitialize()]
+        public void Init()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+        }
+
+        private static byte[] GetTestInput(int length)
+        {
+            byte[] input = new byte[length];
+            for (int i = 0; i < length; i++)
+            {
+                input[i] = (byte)(i % 251);
+            }
+            return input;
+        }
+
+        [TestMethod()]
+        public void KnownVectorTest()
+        {
+            byte[] hash = new byte[MCBlake3Module.DefaultHashSize];
+
+            foreach ((int length, string expected, string expectedKeyed) in KnownVectors)
+            {
+                byte[] input = GetTestInput(length);
+
+                ERRNO result = MonoCypherLibrary.Shared.Blake3ComputeHash(input, hash);
+                Assert.AreEqual(hash.Length, (int)result);
+                Assert.AreEqual(expected, Convert.ToHexString(hash), true);
+
+                result = MonoCypherLibrary.Shared.Blake3ComputeHash(input, hash, TestKey);
+                Assert.AreEqual(hash.Length, (int)result);
+                Assert.AreEqual(expectedKeyed, Convert.ToHexString(hash), true);
+
+                //Parallel hashing must produce the same tree
+                result = MonoCypherLibrary.Shared.Blake3ComputeHashParallel(input, hash, 4);
+                Assert.AreEqual(hash.Length, (int)result);
+                Assert.AreEqual(expected, Convert.ToHexString(hash), true);
+            }
+
+            //Keys must be exactly 32 bytes
+            Assert.IsTrue(MonoCypherLibrary.Shared.Blake3ComputeHash(TestKey, hash, TestKey.AsSpan(1)) < 0);
+        }
+
+        [TestMethod()]
+        public void StreamTest()
+        {
+            byte[] input = GetTestInput(102400);
+            byte[] streamHash = new byte[MCBlake3Module.DefaultHashSize];
+
+            using (IHashStream stream = MonoCypherLibrary.Shared.Blake3CreateStream(MCBlake3Module.DefaultHashSize, null))
+            {
+                //Uneven updates that cross block and chunk boundaries
+                for (int offset = 0; offset < input.Length; offset += 9973)
+                {
+                    int size = Math.Min(9973, input.Length - offset);
+                    stream.Update(ref input[offset], (uint)size);
+                }
+
+                stream.Flush(ref streamHash[0], (byte)streamHash.Length);
+                Assert.AreEqual(KnownVectors[2].hash, Convert.ToHexString(streamHash), true);
+            }
+
+            using IHmacStream keyed = MonoCypherLibrary.Shared.Blake3CreateHmacStream(MCBlake3Module.DefaultHashSize, null);
+            keyed.Initialize(ref TestKey[0], (byte)TestKey.Length);
+            keyed.Update(ref input[0], (uint)input.Length);
+            keyed.Flush(ref streamHash[0], (byte)streamHash.Length);
+
+            Assert.AreEqual(KnownVectors[2].keyedHash, Convert.ToHexString(streamHash), true);
+        }
+
+        [TestMethod()]
+        public void FileHashTest()
+        {
+            //Large enough to be split over threads
+            byte[] input = RandomHash.GetRandomBytes(3 * 1024 * 1024 + 17);
+            byte[] expected = new byte[MCBlake3Module.DefaultHashSize];
+            byte[] fileHash = new byte[MCBlake3Module.DefaultHashSize];
+
+            MonoCypherLibrary.Shared.Blake3ComputeHash(input, expected);
+
+            string path = Path.GetTempFileName();
+            try
+            {
+                File.WriteAllBytes(path, input);
+
+                using FileStream file = new(path, FileMode.Open, FileAccess.Read, FileShare.Read);
+
+                ERRNO result = MonoCypherLibrary.Shared.Blake3ComputeFileHash(file, fileHash);
+                Assert.AreEqual(fileHash.Length, (int)result);
+                Assert.IsTrue(expected.AsSpan().SequenceEqual(fileHash));
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+    }
+}
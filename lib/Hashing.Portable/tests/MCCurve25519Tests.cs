@@ -0,0 +1,112 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+
+using VNLib.Utils;
+using VNLib.Hashing.IdentityUtility;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class MCCurve25519Tests
+    {
+        /*
+         * RFC 8037 appendix A test vectors
+         */
+        const string Rfc8037Jwk = @"{""kty"":""OKP"",""crv"":""Ed25519"",""alg"":""EdDSA"",""use"":""sig"",
+            ""d"":""nWGxne_9WmC6hEr0kuwsxERJxWl7MmkZcDusAxyuf2A"",""x"":""11qYAYKxCrfVS_7TyWQHOg7hcvPapiMlrwIaaPcHURo""}";
+
+        const string Rfc8037Jws = "eyJhbGciOiJFZERTQSJ9.RXhhbXBsZSBvZiBFZDI1NTE5IHNpZ25pbmc" +
+            ".hgyY0il_MGCjP0JzlnLWG1PPOt7-09PGcvMg3AIbQR6dWbhijcNR4ki4iylGjg5BhVsPt9g7sVvpAr_MuM0KAg";
+
+        [TestInitialize()]
+        public void Init()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+        }
+
+        [TestMethod()]
+        public void Ed25519KnownVectorTest()
+        {
+            //RFC 8032 test 1, empty message
+            byte[] seed = Convert.FromHexString("9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60");
+            byte[] expectedPub = Convert.FromHexString("d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a");
+            byte[] expectedSig = Convert.FromHexString(
+                "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"
+            );
+
+            byte[] secretKey = new byte[MCCurve25519Module.Ed25519SecretKeySize];
+            byte[] publicKey = new byte[MCCurve25519Module.Ed25519PublicKeySize];
+            byte[] signature = new byte[MCCurve25519Module.Ed25519SignatureSize];
+
+            MonoCypherLibrary.Shared.Ed25519CreateKeyPair(seed, secretKey, publicKey);
+            Assert.IsTrue(expectedPub.AsSpan().SequenceEqual(publicKey));
+
+            ERRNO written = MonoCypherLibrary.Shared.Ed25519SignMessage(secretKey, default, signature);
+            Assert.AreEqual(MCCurve25519Module.Ed25519SignatureSize, (int)written);
+            Assert.IsTrue(expectedSig.AsSpan().SequenceEqual(signature));
+
+            Assert.IsTrue(MonoCypherLibrary.Shared.Ed25519VerifyMessage(publicKey, default, signature));
+
+            //A modified signature must fail
+            signature[0] ^= 0x01;
+            Assert.IsFalse(MonoCypherLibrary.Shared.Ed25519VerifyMessage(publicKey, default, signature));
+        }
+
+        [TestMethod()]
+        public void X25519KnownVectorTest()
+        {
+            //RFC 7748 section 6.1
+            byte[] alicePriv = Convert.FromHexString("77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a");
+            byte[] bobPub = Convert.FromHexString("de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f");
+            byte[] expectedAlicePub = Convert.FromHexString("8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a");
+            byte[] expectedShared = Convert.FromHexString("4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742");
+
+            byte[] alicePub = new byte[MCCurve25519Module.X25519KeySize];
+            byte[] shared = new byte[MCCurve25519Module.X25519KeySize];
+
+            MonoCypherLibrary.Shared.X25519GetPublicKey(alicePriv, alicePub);
+            Assert.IsTrue(expectedAlicePub.AsSpan().SequenceEqual(alicePub));
+
+            ERRNO result = MonoCypherLibrary.Shared.X25519ComputeSharedSecret(alicePriv, bobPub, shared);
+            Assert.AreEqual(MCCurve25519Module.X25519KeySize, (int)result);
+            Assert.IsTrue(expectedShared.AsSpan().SequenceEqual(shared));
+
+            //The all zero point is low order and must be rejected
+            result = MonoCypherLibrary.Shared.X25519ComputeSharedSecret(alicePriv, new byte[MCCurve25519Module.X25519KeySize], shared);
+            Assert.IsTrue(result < 0);
+        }
+
+        [TestMethod()]
+        public void JwkEdDSATest()
+        {
+            ReadOnlyJsonWebKey jwk = ReadOnlyJsonWebKey.FromUtf8Bytes(Encoding.UTF8.GetBytes(Rfc8037Jwk).AsMemory());
+
+            //Signing is deterministic so the token must match the RFC exactly
+            using (JsonWebToken jwt = new())
+            {
+                jwt.WriteHeader(Encoding.UTF8.GetBytes(@"{""alg"":""EdDSA""}"));
+                jwt.WritePayload(Encoding.UTF8.GetBytes("Example of Ed25519 signing"));
+                jwt.SignFromJwk(jwk);
+
+                Assert.AreEqual(Rfc8037Jws, jwt.Compile());
+            }
+
+            using (JsonWebToken parsed = JsonWebToken.Parse(Rfc8037Jws))
+            {
+                Assert.IsTrue(parsed.VerifyFromJwk(jwk));
+            }
+
+            //Tampered payload must fail verification
+            string tampered = Rfc8037Jws.Replace(".RXhh", ".RXhi");
+            using (JsonWebToken parsed = JsonWebToken.Parse(tampered))
+            {
+                Assert.IsFalse(parsed.VerifyFromJwk(jwk));
+            }
+        }
+    }
+}
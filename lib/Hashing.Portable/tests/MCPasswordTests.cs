@@ -0,0 +1,85 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using VNLib.Utils.Memory;
+using VNLib.Hashing.Native.MonoCypher;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public unsafe class MCPasswordTests
+    {
+        //The native library reads the algorithm from the version field
+        const Argon2Version Argon2id = (Argon2Version)2;
+
+        [TestInitialize()]
+        public void Init()
+        {
+            if (!MonoCypherLibrary.CanLoadDefaultLibrary())
+            {
+                Assert.Inconclusive("The native monocypher library is not available");
+            }
+        }
+
+        [TestMethod()]
+        public void Argon2idKnownVectorTest()
+        {
+            //RFC 9106 5.3, 4 lanes
+            byte[] expected = Convert.FromHexString("0d640df58d78766c08c037a34a8b53c9d01ef0452d75b65eb52520e96b01e659");
+
+            CollectionAssert.AreEqual(expected, Hash(lanes: 4, threads: 1, mCost: 32, tCost: 3));
+            CollectionAssert.AreEqual(expected, Hash(lanes: 4, threads: 4, mCost: 32, tCost: 3));
+        }
+
+        [TestMethod()]
+        public void ParallelMatchesSingleThreadedTest()
+        {
+            //Uneven thread counts leave some threads with more lanes than others
+            foreach (uint lanes in (uint[])[2, 3, 4, 8])
+            {
+                byte[] reference = Hash(lanes, 1, 1024, 2);
+
+                for (uint threads = 2; threads <= lanes; threads++)
+                {
+                    CollectionAssert.AreEqual(reference, Hash(lanes, threads, 1024, 2), $"lanes={lanes} threads={threads}");
+                }
+            }
+        }
+
+        private static byte[] Hash(uint lanes, uint threads, uint mCost, uint tCost)
+        {
+            byte[] password = Enumerable.Repeat((byte)0x01, 32).ToArray();
+            byte[] salt = Enumerable.Repeat((byte)0x02, 16).ToArray();
+            byte[] secret = Enumerable.Repeat((byte)0x03, 8).ToArray();
+            byte[] ad = Enumerable.Repeat((byte)0x04, 12).ToArray();
+            byte[] output = new byte[32];
+
+            IArgon2Library lib = MonoCypherLibrary.Shared.Argon2CreateLibrary(MemoryUtil.Shared);
+
+            fixed (byte* pPass = password, pSalt = salt, pSecret = secret, pAd = ad, pOut = output)
+            {
+                Argon2Context ctx = new()
+                {
+                    version = Argon2id,
+                    t_cost = tCost,
+                    m_cost = mCost,
+                    lanes = lanes,
+                    threads = threads,
+                    pwd = pPass,
+                    pwdlen = (uint)password.Length,
+                    salt = pSalt,
+                    saltlen = (uint)salt.Length,
+                    secret = pSecret,
+                    secretlen = (uint)secret.Length,
+                    ad = pAd,
+                    adlen = (uint)ad.Length,
+                    outptr = pOut,
+                    outlen = (uint)output.Length
+                };
+
+                Assert.AreEqual(0, lib.Argon2Hash(new IntPtr(&ctx)));
+            }
+
+            return output;
+        }
+    }
+}
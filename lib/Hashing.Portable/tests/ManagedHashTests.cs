@@ -119,7 +119,10 @@ namespace VNLib.Hashing.Tests
             "32400b5e89822de254e8d5d94252c52bdcb27a3562ca593e980364d9848b8041b98eabe16c1a6797484941d2376864a1b0e248b0f7af8b1555a778c336a5bf48",
 
             //Blake2b (64 bytes/512 bits)
-            "54b113f499799d2f3c0711da174e3bc724737ad18f63feb286184f0597e1466436705d6c8e8c7d3d3b88f5a22e83496e0043c44a3c2b1700e0e02259f8ac468e"
+            "54b113f499799d2f3c0711da174e3bc724737ad18f63feb286184f0597e1466436705d6c8e8c7d3d3b88f5a22e83496e0043c44a3c2b1700e0e02259f8ac468e",
+
+            //Blake3 (32 bytes/256 bits)
+            "5ca7815adcb484e9a136c11efe69c1d530176d549b5d18d038eb5280b4b3470c"
         ];
 
         //Known hash sizes to compare against
@@ -134,7 +137,8 @@ namespace VNLib.Hashing.Tests
             32,
             48,
             64,
-            64
+            64,
+            32
         ];
 
         [TestMethod()]
@@ -0,0 +1,138 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Globalization;
+
+using VNLib.Hashing.Checksums;
+
+namespace VNLib.Hashing.Tests
+{
+    [TestClass()]
+    public class XxHash3Tests
+    {
+        /*
+         * Vectors were computed with the reference xxHash library (0.8.3) over 
+         * the deterministic input from CreateInput, lengths are chosen to cover 
+         * every short input branch and the long input block boundaries
+         */
+
+        static readonly (int length, ulong seed, ulong known64, string known128Hex)[] KnownVectors =
+        [
+            (0, 0x0000000000000000UL, 0x2d06800538d394c2UL, "99aa06d3014798d86001c324468d497f"),
+            (1, 0x0000000000000000UL, 0x4c5cca45d0f4811fUL, "495b62073ef70ca44c5cca45d0f4811f"),
+            (3, 0x0000000000000000UL, 0x15f7093b173d005cUL, "46f66cb93538156515f7093b173d005c"),
+            (4, 0x0000000000000000UL, 0xdca012f95811b6b9UL, "7fefeeffb4d0eab3b987ca5d9241572a"),
+            (8, 0x0000000000000000UL, 0xdec6a9a43575982eUL, "803c675a846cc6c256bb836ceb6d4baa"),
+            (9, 0x0000000000000000UL, 0xcbe393399f17ffbdUL, "d46556872d230f224376673580310154"),
+            (16, 0x0000000000000000UL, 0x7e484c18d74895d0UL, "650fe308c566747df853dd94614dfa07"),
+            (17, 0x0000000000000000UL, 0x208bde5ee2bed407UL, "18217300b5132d5a78c349fe81b2f26c"),
+            (128, 0x0000000000000000UL, 0xf92b70eaa21a6288UL, "b4f87b99d2db8a511e04fad9f0cacb4d"),
+            (129, 0x0000000000000000UL, 0xf8f76713f2bb60faUL, "6881633650cd8924c51bc887976aef63"),
+            (240, 0x0000000000000000UL, 0xccc7375172c41f03UL, "de57aab31e77a2ff93e173833f75ab66"),
+            (241, 0x0000000000000000UL, 0x0b3b630948ce4a00UL, "92b991a7192f3f080b3b630948ce4a00"),
+            (1024, 0x0000000000000000UL, 0x23bc880ebf0d29c6UL, "4c17271c906df79223bc880ebf0d29c6"),
+            (1025, 0x0000000000000000UL, 0xc09fdfbc398c7d82UL, "70a4eb1b9691d77fc09fdfbc398c7d82"),
+            (4096, 0x0000000000000000UL, 0xa3c19f8174cde0bbUL, "49d3842b33d51e8aa3c19f8174cde0bb"),
+            (10000, 0x0000000000000000UL, 0x441f01d9711bebedUL, "d53e809be21e616d441f01d9711bebed"),
+            (0, 0x9e3779b97f4a7c15UL, 0x602b0e2cd6662c8bUL, "d142977a2cca554b4ca5176998171787"),
+            (1, 0x9e3779b97f4a7c15UL, 0x2f3acd3805f81de3UL, "00a711eb5a736b262f3acd3805f81de3"),
+            (3, 0x9e3779b97f4a7c15UL, 0x079dd5d54d89480aUL, "bf6c84df5f76651d079dd5d54d89480a"),
+            (4, 0x9e3779b97f4a7c15UL, 0x1a246e2efb9c9b2eUL, "b51a3f0020dfa57e64e9e646b51d20e4"),
+            (8, 0x9e3779b97f4a7c15UL, 0x19ef7d3919108affUL, "c3612dc11470e7213edb070ecf3a9343"),
+            (9, 0x9e3779b97f4a7c15UL, 0x9c98d3e24dc54d34UL, "d073a967e56faabb2d1266ad8e2a983e"),
+            (16, 0x9e3779b97f4a7c15UL, 0xa106510078b0a252UL, "be0f27bac4d1f58f4e683254a04c377f"),
+            (17, 0x9e3779b97f4a7c15UL, 0x0b2caf8bf9648effUL, "81d87d7004dc4f98ec6d60966729df8d"),
+            (128, 0x9e3779b97f4a7c15UL, 0x95425530beb89fe8UL, "f1355c6816c0b7248dd13adf89d20a39"),
+            (129, 0x9e3779b97f4a7c15UL, 0x29fa850b97ed9666UL, "b8c736db70349640a1c74215b3db7ab4"),
+            (240, 0x9e3779b97f4a7c15UL, 0x2d882e7899ff64ccUL, "5b131678a4a9b8f4de896b7f1ae3bc6f"),
+            (241, 0x9e3779b97f4a7c15UL, 0x422e82e8913e49e0UL, "c39cbfb460caf47e422e82e8913e49e0"),
+            (1024, 0x9e3779b97f4a7c15UL, 0x7e249adc60e1f9b4UL, "927c8d2b50d33f537e249adc60e1f9b4"),
+            (1025, 0x9e3779b97f4a7c15UL, 0x16cfe055154ff1ddUL, "0d225711ec9bb34416cfe055154ff1dd"),
+            (4096, 0x9e3779b97f4a7c15UL, 0x224e1aff9c0f0707UL, "95fad31aabba45e1224e1aff9c0f0707"),
+            (10000, 0x9e3779b97f4a7c15UL, 0xd19cf166bc6207dfUL, "0540bede911260ffd19cf166bc6207df"),
+        ];
+
+        [TestMethod()]
+        public void XxHash3Known()
+        {
+            foreach ((int length, ulong seed, ulong known64, string known128Hex) in KnownVectors)
+            {
+                byte[] input = CreateInput(length);
+                UInt128 known128 = UInt128.Parse(known128Hex, NumberStyles.HexNumber);
+
+                Assert.AreEqual(known64, XxHash3.Compute64(input, seed), $"Length {length} seed {seed:x}");
+                Assert.AreEqual(known128, XxHash3.Compute128(input, seed), $"Length {length} seed {seed:x}");
+
+                //A single update must produce the same digest
+                XxHash3State state = XxHash3State.Create(seed);
+                state.Update(input);
+
+                Assert.AreEqual((ulong)length, state.TotalLength);
+                Assert.AreEqual(known64, state.Digest64());
+                Assert.AreEqual(known128, state.Digest128());
+            }
+        }
+
+        [TestMethod()]
+        public void XxHash3StreamingMatchesOneShot()
+        {
+            Random rand = new(1234);
+            byte[] input = RandomHash.GetRandomBytes(20000);
+
+            foreach (ulong seed in new ulong[] { 0, 0x9E3779B97F4A7C15 })
+            {
+                for (int trial = 0; trial < 50; trial++)
+                {
+                    int length = rand.Next(0, input.Length);
+                    ReadOnlySpan<byte> data = input.AsSpan(0, length);
+
+                    XxHash3State state = XxHash3State.Create(seed);
+
+                    //Random segment sizes exercise partial buffers and block boundaries
+                    for (int offset = 0; offset < length;)
+                    {
+                        int segment = Math.Min(rand.Next(0, 700), length - offset);
+                        state.Update(data.Slice(offset, segment));
+                        offset += segment;
+                    }
+
+                    Assert.AreEqual(XxHash3.Compute64(data, seed), state.Digest64());
+                    Assert.AreEqual(XxHash3.Compute128(data, seed), state.Digest128());
+                }
+            }
+        }
+
+        [TestMethod()]
+        public void XxHash3StateReuse()
+        {
+            byte[] input = CreateInput(5000);
+
+            //Default state must be valid and equal to a seed of 0
+            XxHash3State state = default;
+            state.Update(input.AsSpan(0, 3000));
+
+            //Digest must not modify the state
+            Assert.AreEqual(XxHash3.Compute64(input.AsSpan(0, 3000)), state.Digest64());
+
+            state.Update(input.AsSpan(3000));
+            Assert.AreEqual(XxHash3.Compute64(input), state.Digest64());
+
+            state.Reset(42);
+            Assert.AreEqual(0UL, state.TotalLength);
+
+            state.Update(input);
+            Assert.AreEqual(XxHash3.Compute128(input, 42), state.Digest128());
+        }
+
+        static byte[] CreateInput(int length)
+        {
+            byte[] input = new byte[length];
+
+            for (int i = 0; i < length; i++)
+            {
+                input[i] = (byte)((i * 31) + 7);
+            }
+
+            return input;
+        }
+    }
+}
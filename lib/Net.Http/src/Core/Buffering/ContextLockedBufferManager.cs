@@ -57,11 +57,11 @@ namespace VNLib.Net.Http.Core.Buffering
             //Compute total buffer size from server config
             TotalBufferSize = ComputeTotalBufferSize(in config, chunkingEnabled);
 
-             /*
-              * Individual instances of the header accumulator buffer are required
-              * because the user controls the size of the binary buffer for responses 
-              * and requests. The buffer segment is shared between the two instances.
-              */
+            /*
+             * Individual instances of the header accumulator buffer are required
+             * because the user controls the size of the binary buffer for responses 
+             * and requests.
+             */
             _requestHeaderBuffer = new(config.RequestHeaderBufferSize);           
             _responseHeaderBuffer = new(config.ResponseHeaderBufferSize);
 
@@ -83,17 +83,16 @@ namespace VNLib.Net.Http.Core.Buffering
             {
                 Memory<byte> full = _handle.Memory;
 
-                //Header parse buffer is a special case as it will be double the size due to the char buffer
-                int headerParseBufferSize = GetMaxHeaderBufferSize(in Config);
-
                 //Response/form data buffer
                 int responseAndFormDataSize = ComputeResponseAndFormDataBuffer(in Config);
 
                 //Slice and store the buffer segments
                 _segments = new()
                 {
-                    //Shared header buffer
-                    HeaderAccumulator = GetNextSegment(ref full, headerParseBufferSize),
+                    //Header buffers are split buffers, so they are larger than the configured size due to the char buffer
+                    RequestHeader = GetNextSegment(ref full, SplitHttpBufferElement.GetfullSize(Config.RequestHeaderBufferSize)),
+
+                    ResponseHeader = GetNextSegment(ref full, SplitHttpBufferElement.GetfullSize(Config.ResponseHeaderBufferSize)),
 
                     //Shared response and form data buffer
                     ResponseAndFormData = GetNextSegment(ref full, responseAndFormDataSize),
@@ -106,22 +105,16 @@ namespace VNLib.Net.Http.Core.Buffering
                 };
 
                 /*
-                 * ************* WARNING ****************
-                 * 
-                 * Request header and response header buffers are shared 
-                 * because they are assumed to be used in a single threaded context
-                 * and control flow never allows them to be used at the same time.
-                 * 
-                 * The bin buffer size is determined by the buffer config so the 
-                 * user may still configure the buffer size for restriction, so we
-                 * just alloc the largerest of the two and use it for requests and 
-                 * responses.
-                 * 
-                 * Control flow may change and become unsafe in the future!
+                 * Request and response header buffers are NOT shared. The 
+                 * request head is parsed in place, and the request target 
+                 * and some header values are only stored as offsets into 
+                 * the request header buffer, so it must remain valid until 
+                 * the request is complete, while response headers are 
+                 * written.
                  */
 
-                _requestHeaderBuffer.SetBuffer(_segments.HeaderAccumulator);
-                _responseHeaderBuffer.SetBuffer(_segments.HeaderAccumulator);
+                _requestHeaderBuffer.SetBuffer(_segments.RequestHeader);
+                _responseHeaderBuffer.SetBuffer(_segments.ResponseHeader);
 
                 //Chunk buffer will be used at the same time as the response buffer and discard buffers
                 _chunkAccBuffer.SetBuffer(_segments.ChunkedResponseAccumulator);
@@ -194,25 +187,13 @@ namespace VNLib.Net.Http.Core.Buffering
             return segment;
         }
 
-        /*
-         * Computes the correct size of the request header buffer from the config
-         * so it is large enough to hold the binary buffer but also the split char 
-         * buffer
-         */
-       
-        static int GetMaxHeaderBufferSize(in HttpBufferConfig config)
-        {
-            int max = Math.Max(config.RequestHeaderBufferSize, config.ResponseHeaderBufferSize);
-
-            //Compute the max size including the char buffer
-            return SplitHttpBufferElement.GetfullSize(max);
-        }
-
         static int ComputeTotalBufferSize(in HttpBufferConfig config, bool chunkingEnabled)
         {
             int baseSize = config.ResponseBufferSize
                 + ComputeResponseAndFormDataBuffer(in config)
-                + GetMaxHeaderBufferSize(in config);    //Header buffers are shared
+                //Header buffers include the split char buffer
+                + SplitHttpBufferElement.GetfullSize(config.RequestHeaderBufferSize)
+                + SplitHttpBufferElement.GetfullSize(config.ResponseHeaderBufferSize);
 
             if (chunkingEnabled)
             {
@@ -232,7 +213,8 @@ namespace VNLib.Net.Http.Core.Buffering
 
         readonly struct HttpBufferSegments<T>
         {
-            public readonly Memory<T> HeaderAccumulator { get; init; }
+            public readonly Memory<T> RequestHeader { get; init; }
+            public readonly Memory<T> ResponseHeader { get; init; }
             public readonly Memory<T> ChunkedResponseAccumulator { get; init; }
             public readonly Memory<T> ResponseAndFormData { get; init; }
         }  
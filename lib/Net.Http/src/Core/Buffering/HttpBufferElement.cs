@@ -76,7 +76,7 @@ namespace VNLib.Net.Http.Core.Buffering
         ///<inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public virtual Span<byte> GetBinSpan(int offset, int size) 
-            => (offset + size) < _handle.Size ? _handle.GetSpan(offset, size) : throw new ArgumentOutOfRangeException(nameof(offset));
+            => (offset + size) <= _handle.Size ? _handle.GetSpan(offset, size) : throw new ArgumentOutOfRangeException(nameof(offset));
 
 
         private struct HandleState
@@ -99,7 +99,7 @@ namespace VNLib.Net.Http.Core.Buffering
 
             public readonly Span<byte> GetSpan(int offset, int size)
             {
-                Debug.Assert((offset + size) < Size, "Call to GetSpan failed because the offset/size was out of valid range");
+                Debug.Assert((offset + size) <= Size, "Call to GetSpan failed because the offset/size was out of valid range");
                 return MemoryUtil.GetSpan<byte>(IntPtr.Add(_pointer, offset), size);
             }
 
@@ -40,8 +40,8 @@ namespace VNLib.Net.Http.Core.Buffering
         ///<inheritdoc/>
         public Span<char> GetCharSpan()
         {
-            //Get space available after binary buffer
-            Span<byte> _base = base.GetBinSpan(BinSize);
+            //Get space available after binary buffer, bypass the overrides that trim to the binary segment
+            Span<byte> _base = base.GetBinSpan(BinSize, Size - BinSize);
 
             //Return char span
             return MemoryMarshal.Cast<byte, char>(_base);
@@ -53,7 +53,7 @@ namespace VNLib.Net.Http.Core.Buffering
          */
         ///<inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        public override Span<byte> GetBinSpan(int offset) => base.GetBinSpan(offset, BinSize);
+        public override Span<byte> GetBinSpan(int offset) => base.GetBinSpan(offset, BinSize - offset);
 
         /*
          * Override to trim the bin buffer to the actual size of the 
@@ -61,7 +61,7 @@ namespace VNLib.Net.Http.Core.Buffering
          */
         ///<inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        public override Span<byte> GetBinSpan(int offset, int size) => base.GetBinSpan(offset, Math.Min(BinSize, size));
+        public override Span<byte> GetBinSpan(int offset, int size) => base.GetBinSpan(offset, Math.Min(BinSize - offset, size));
 
         /// <summary>
         /// Gets the size total of the buffer required for binary data and char data
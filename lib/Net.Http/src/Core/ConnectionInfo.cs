@@ -35,21 +35,32 @@ namespace VNLib.Net.Http
     internal sealed class ConnectionInfo : IConnectionInfo
     {
         private HttpContext Context;
+        private string? _path;
+        private bool? _crossOrigin;
 
         ///<inheritdoc/>
-        public Uri RequestUri => Context.Request.State.Location;
+        public Uri RequestUri => Context.Request.Location;
 
         ///<inheritdoc/>
-        public string Path => RequestUri.LocalPath;
+        public string Path => _path ??= Context.Request.Path.ToString();
 
         ///<inheritdoc/>
-        public string? UserAgent => Context.Request.State.UserAgent;
+        public ReadOnlySpan<char> PathSpan => Context.Request.Path;
+
+        ///<inheritdoc/>
+        public ReadOnlySpan<char> QuerySpan => Context.Request.Query;
+
+        ///<inheritdoc/>
+        public ReadOnlySpan<char> HostSpan => Context.Request.Host;
+
+        ///<inheritdoc/>
+        public string? UserAgent => Context.Request.Headers[HttpRequestHeader.UserAgent];
 
         ///<inheritdoc/>
         public IHeaderCollection Headers { get; private set; }
 
         ///<inheritdoc/>
-        public bool CrossOrigin { get; }
+        public bool CrossOrigin => _crossOrigin ??= Context.Request.IsCrossOrigin();
 
         ///<inheritdoc/>
         public bool IsWebSocketRequest { get; }
@@ -64,10 +75,10 @@ namespace VNLib.Net.Http
         public HttpVersion ProtocolVersion => Context.Request.State.HttpVersion;
 
         ///<inheritdoc/>
-        public Uri? Origin => Context.Request.State.Origin;
+        public Uri? Origin => Context.Request.Origin;
 
         ///<inheritdoc/>
-        public Uri? Referer => Context.Request.State.Referrer;
+        public Uri? Referer => Context.Request.Referrer;
 
         ///<inheritdoc/>
         public HttpRange Range => Context.Request.State.Range;
@@ -105,8 +116,6 @@ namespace VNLib.Net.Http
             Context = ctx;
             //Create new header collection
             Headers = new VnHeaderCollection(ctx);
-            //set co value
-            CrossOrigin = ctx.Request.IsCrossOrigin();
             //Set websocket status
             IsWebSocketRequest = ctx.Request.IsWebSocketRequest();
         }
@@ -0,0 +1,269 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HpackDecoder.cs 
+*
+* HpackDecoder.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// Decodes HPACK (RFC 7541) header blocks and maintains the connection's 
+    /// request dynamic table
+    /// </summary>
+    /// <param name="maxTableSize">The dynamic table size limit advertised to the client</param>
+    internal sealed class HpackDecoder(int maxTableSize)
+    {
+        //Every entry is charged 32 bytes of overhead (RFC 7541 4.1)
+        private const int EntryOverhead = 32;
+
+        private readonly record struct Entry(byte[] Data, int NameLength);
+
+        //Ring of dynamic table entries, the newest entry is at _newest
+        private readonly Entry[] _entries = new Entry[maxTableSize / EntryOverhead + 1];
+
+        //The limit advertised to the client, size updates may only lower the table size below it
+        private readonly int _maxTableSize = maxTableSize;
+
+        private int _newest;
+        private int _count;
+        private int _size;
+        private int _maxSize = maxTableSize;
+        private bool _fieldRead;
+
+        /// <summary>
+        /// Prepares the decoder to read a new header block
+        /// </summary>
+        public void BeginBlock() => _fieldRead = false;
+
+        /// <summary>
+        /// Reads the next header field from a complete header block
+        /// </summary>
+        /// <param name="block">The remaining header block, advanced past the field</param>
+        /// <param name="scratch">
+        /// A buffer huffman encoded strings are decoded to, it is only valid until the next field 
+        /// is read. It must be able to store 8/5 of the header block size.
+        /// </param>
+        /// <param name="name">The field name</param>
+        /// <param name="value">The field value</param>
+        /// <returns>True if a field was read, false if the end of the block was reached</returns>
+        /// <exception cref="Http2ProtocolException"></exception>
+        public bool TryReadField(ref ReadOnlySpan<byte> block, Span<byte> scratch, out ReadOnlySpan<byte> name, out ReadOnlySpan<byte> value)
+        {
+            while (!block.IsEmpty)
+            {
+                byte first = block[0];
+
+                //Indexed field
+                if ((first & 0x80) != 0)
+                {
+                    GetEntry(ReadInteger(ref block, 7), out name, out value);
+                }
+                //Literal with incremental indexing
+                else if ((first & 0x40) != 0)
+                {
+                    ReadLiteral(ref block, 6, scratch, out name, out value);
+                    Insert(name, value);
+                }
+                //Dynamic table size update, only allowed at the start of a block
+                else if ((first & 0x20) != 0)
+                {
+                    int size = ReadInteger(ref block, 5);
+
+                    if (_fieldRead || size > _maxTableSize)
+                    {
+                        throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Invalid dynamic table size update");
+                    }
+
+                    _maxSize = size;
+                    Evict(0);
+                    continue;
+                }
+                //Literal without indexing or never indexed
+                else
+                {
+                    ReadLiteral(ref block, 4, scratch, out name, out value);
+                }
+
+                _fieldRead = true;
+                return true;
+            }
+
+            name = value = default;
+            return false;
+        }
+
+        private void ReadLiteral(ref ReadOnlySpan<byte> block, int prefix, Span<byte> scratch, out ReadOnlySpan<byte> name, out ReadOnlySpan<byte> value)
+        {
+            int index = ReadInteger(ref block, prefix);
+            int used = 0;
+
+            if (index == 0)
+            {
+                name = ReadString(ref block, scratch, ref used);
+            }
+            else
+            {
+                GetEntry(index, out name, out _);
+            }
+
+            value = ReadString(ref block, scratch, ref used);
+        }
+
+        private void GetEntry(int index, out ReadOnlySpan<byte> name, out ReadOnlySpan<byte> value)
+        {
+            if (index > 0 && index <= HpackStaticTable.Count)
+            {
+                name = HpackStaticTable.GetName(index);
+                value = HpackStaticTable.GetValue(index);
+                return;
+            }
+
+            index -= HpackStaticTable.Count + 1;
+
+            if (index < 0 || index >= _count)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Header field index is out of range");
+            }
+
+            Entry entry = _entries[(_newest - index + _entries.Length) % _entries.Length];
+
+            name = entry.Data.AsSpan(0, entry.NameLength);
+            value = entry.Data.AsSpan(entry.NameLength);
+        }
+
+        private void Insert(ReadOnlySpan<byte> name, ReadOnlySpan<byte> value)
+        {
+            int size = name.Length + value.Length + EntryOverhead;
+
+            //An entry larger than the table empties it (RFC 7541 4.4)
+            if (size > _maxSize)
+            {
+                _count = _size = 0;
+                return;
+            }
+
+            //Copy before evicting, the name may refer to an entry that is evicted
+            byte[] data = new byte[name.Length + value.Length];
+            name.CopyTo(data);
+            value.CopyTo(data.AsSpan(name.Length));
+
+            Evict(size);
+
+            _newest = (_newest + 1) % _entries.Length;
+            _entries[_newest] = new(data, name.Length);
+            _count++;
+            _size += size;
+        }
+
+        /*
+         * Evicts the oldest entries until the table has room for 
+         * an entry of the required size
+         */
+        private void Evict(int required)
+        {
+            while (_count > 0 && _size + required > _maxSize)
+            {
+                int oldest = (_newest - _count + 1 + _entries.Length) % _entries.Length;
+
+                Entry entry = _entries[oldest];
+                _size -= entry.Data.Length + EntryOverhead;
+                _entries[oldest] = default;
+                _count--;
+            }
+        }
+
+        private static int ReadInteger(ref ReadOnlySpan<byte> block, int prefixBits)
+        {
+            int mask = (1 << prefixBits) - 1;
+            int value = block[0] & mask;
+            int read = 1;
+
+            if (value == mask)
+            {
+                long result = value;
+
+                for (int shift = 0; ; shift += 7)
+                {
+                    //Lengths and indexes never exceed an int
+                    if (read == block.Length || shift > 28)
+                    {
+                        throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Invalid HPACK integer");
+                    }
+
+                    byte b = block[read++];
+                    result += (long)(b & 0x7f) << shift;
+
+                    if ((b & 0x80) == 0)
+                    {
+                        break;
+                    }
+                }
+
+                if (result > int.MaxValue)
+                {
+                    throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Invalid HPACK integer");
+                }
+
+                value = (int)result;
+            }
+
+            block = block[read..];
+            return value;
+        }
+
+        private static ReadOnlySpan<byte> ReadString(ref ReadOnlySpan<byte> block, Span<byte> scratch, scoped ref int used)
+        {
+            if (block.IsEmpty)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Truncated HPACK string");
+            }
+
+            bool huffman = (block[0] & 0x80) != 0;
+            int length = ReadInteger(ref block, 7);
+
+            if (length > block.Length)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Truncated HPACK string");
+            }
+
+            ReadOnlySpan<byte> data = block[..length];
+            block = block[length..];
+
+            if (!huffman)
+            {
+                return data;
+            }
+
+            Span<byte> output = scratch[used..];
+            int written = HpackHuffman.Decode(data, output);
+
+            if (written < 0)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Decoded header field is too large");
+            }
+
+            used += written;
+            return output[..written];
+        }
+    }
+}
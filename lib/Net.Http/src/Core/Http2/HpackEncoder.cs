@@ -0,0 +1,122 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HpackEncoder.cs 
+*
+* HpackEncoder.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// Writes HPACK (RFC 7541) header field representations. The encoder does not 
+    /// use a dynamic table, fields are either fully indexed in the static table or 
+    /// written as literals without indexing, so encoding is stateless and response 
+    /// header blocks may be built by any stream in any order.
+    /// </summary>
+    internal static class HpackEncoder
+    {
+        /// <summary>
+        /// The maximum number of bytes a string length prefix may require
+        /// </summary>
+        public const int MaxIntegerSize = 6;
+
+        /// <summary>
+        /// Writes an HPACK integer with the given prefix size and representation bits
+        /// </summary>
+        /// <param name="output">The buffer to write the integer to</param>
+        /// <param name="value">The integer value</param>
+        /// <param name="prefixBits">The number of bits of the first byte used by the integer</param>
+        /// <param name="pattern">The representation bits of the first byte</param>
+        /// <returns>The number of bytes written</returns>
+        public static int WriteInteger(Span<byte> output, int value, int prefixBits, byte pattern)
+        {
+            int mask = (1 << prefixBits) - 1;
+
+            if (value < mask)
+            {
+                output[0] = (byte)(pattern | value);
+                return 1;
+            }
+
+            output[0] = (byte)(pattern | mask);
+            value -= mask;
+
+            int written = 1;
+
+            while (value >= 0x80)
+            {
+                output[written++] = (byte)(value | 0x80);
+                value >>= 7;
+            }
+
+            output[written++] = (byte)value;
+            return written;
+        }
+
+        /// <summary>
+        /// Writes a string literal, huffman encoded if it is shorter
+        /// </summary>
+        /// <param name="output">The buffer to write the string to</param>
+        /// <param name="value">The string data</param>
+        /// <returns>The number of bytes written</returns>
+        public static int WriteString(Span<byte> output, ReadOnlySpan<byte> value)
+        {
+            int huffmanLength = HpackHuffman.GetEncodedLength(value);
+
+            if (huffmanLength < value.Length)
+            {
+                int written = WriteInteger(output, huffmanLength, 7, 0x80);
+                return written + HpackHuffman.Encode(value, output[written..]);
+            }
+            else
+            {
+                int written = WriteInteger(output, value.Length, 7, 0);
+                value.CopyTo(output[written..]);
+                return written + value.Length;
+            }
+        }
+
+        /// <summary>
+        /// Writes a field that is fully indexed in the static table
+        /// </summary>
+        public static int WriteIndexed(Span<byte> output, int index) => WriteInteger(output, index, 7, 0x80);
+
+        /// <summary>
+        /// Writes the start of a literal field without indexing whose name is indexed in the 
+        /// static table, the value string must follow
+        /// </summary>
+        public static int WriteLiteralName(Span<byte> output, int nameIndex) => WriteInteger(output, nameIndex, 4, 0);
+
+        /// <summary>
+        /// Writes the start of a literal field without indexing with a literal name, the value 
+        /// string must follow
+        /// </summary>
+        /// <param name="output">The buffer to write the field to</param>
+        /// <param name="name">The lowercase field name</param>
+        /// <returns>The number of bytes written</returns>
+        public static int WriteLiteralName(Span<byte> output, ReadOnlySpan<byte> name)
+        {
+            output[0] = 0;
+            return 1 + WriteString(output[1..], name);
+        }
+    }
+}
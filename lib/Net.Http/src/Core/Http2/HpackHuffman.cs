@@ -0,0 +1,233 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HpackHuffman.cs 
+*
+* HpackHuffman.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// Encodes and decodes strings with the static HPACK huffman code (RFC 7541 Appendix B)
+    /// </summary>
+    /// <remarks>
+    /// The HPACK code is canonical, codes of the same length are consecutive and ordered 
+    /// by symbol, so only the code lengths are stored and the codes are rebuilt once. 
+    /// Decoding compares a left justified window of the input against the upper bound 
+    /// of each code length instead of walking a tree one bit at a time.
+    /// </remarks>
+    internal static class HpackHuffman
+    {
+        private const int EosSymbol = 256;
+        private const int MaxCodeLength = 30;
+
+        /*
+         * Code length of every symbol in symbol order, the last 
+         * entry is the end of string symbol
+         */
+        private static ReadOnlySpan<byte> CodeLengths =>
+        [
+            13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+            28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+            6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+            5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+            13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+            7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+            15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+            6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+            20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+            24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+            22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+            21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+            26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+            19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+            20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+            26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+            30
+        ];
+
+        private static readonly uint[] Codes = new uint[EosSymbol + 1];
+
+        //Symbols ordered by their code
+        private static readonly ushort[] Symbols = new ushort[EosSymbol + 1];
+
+        //Exclusive upper bound of the codes of each length, left justified to 32 bits
+        private static readonly ulong[] Limits = new ulong[MaxCodeLength + 1];
+
+        //The symbol index of a code of each length is its code plus the offset of the length
+        private static readonly int[] Offsets = new int[MaxCodeLength + 1];
+
+        static HpackHuffman()
+        {
+            ReadOnlySpan<byte> lengths = CodeLengths;
+
+            int[] counts = new int[MaxCodeLength + 1];
+
+            foreach (byte length in lengths)
+            {
+                counts[length]++;
+            }
+
+            uint code = 0;
+            int index = 0;
+
+            //Assign consecutive codes to each length in symbol order
+            for (int length = 1; length <= MaxCodeLength; length++)
+            {
+                Offsets[length] = index - (int)code;
+
+                for (int symbol = 0; symbol < lengths.Length; symbol++)
+                {
+                    if (lengths[symbol] == length)
+                    {
+                        Codes[symbol] = code++;
+                        Symbols[index++] = (ushort)symbol;
+                    }
+                }
+
+                Limits[length] = (ulong)code << (32 - length);
+                code <<= 1;
+            }
+        }
+
+        /// <summary>
+        /// Computes the number of bytes required to huffman encode the data
+        /// </summary>
+        /// <param name="data">The data to encode</param>
+        /// <returns>The encoded size in bytes</returns>
+        public static int GetEncodedLength(ReadOnlySpan<byte> data)
+        {
+            ReadOnlySpan<byte> lengths = CodeLengths;
+            long bits = 0;
+
+            foreach (byte b in data)
+            {
+                bits += lengths[b];
+            }
+
+            return (int)((bits + 7) >> 3);
+        }
+
+        /// <summary>
+        /// Huffman encodes the data to the output buffer
+        /// </summary>
+        /// <param name="data">The data to encode</param>
+        /// <param name="output">The buffer to write the encoded data to, must be at least <see cref="GetEncodedLength"/> bytes</param>
+        /// <returns>The number of bytes written to the output</returns>
+        public static int Encode(ReadOnlySpan<byte> data, Span<byte> output)
+        {
+            ReadOnlySpan<byte> lengths = CodeLengths;
+            ulong acc = 0;
+            int bits = 0, written = 0;
+
+            foreach (byte b in data)
+            {
+                acc = acc << lengths[b] | Codes[b];
+                bits += lengths[b];
+
+                while (bits >= 8)
+                {
+                    bits -= 8;
+                    output[written++] = (byte)(acc >> bits);
+                }
+            }
+
+            //Pad the last byte with the most significant bits of the EOS symbol (all ones)
+            if (bits > 0)
+            {
+                output[written++] = (byte)(acc << (8 - bits) | (0xffu >> bits));
+            }
+
+            return written;
+        }
+
+        /// <summary>
+        /// Decodes a huffman encoded string to the output buffer
+        /// </summary>
+        /// <param name="data">The encoded data</param>
+        /// <param name="output">The buffer to write the decoded data to</param>
+        /// <returns>The number of bytes written to the output, or -1 if the output buffer is too small</returns>
+        /// <exception cref="Http2ProtocolException"></exception>
+        public static int Decode(ReadOnlySpan<byte> data, Span<byte> output)
+        {
+            ulong acc = 0;
+            int bits = 0, written = 0, read = 0;
+
+            while (true)
+            {
+                //Keep at least a full code in the accumulator while data remains
+                while (bits <= 56 && read < data.Length)
+                {
+                    acc = acc << 8 | data[read++];
+                    bits += 8;
+                }
+
+                if (bits == 0)
+                {
+                    return written;
+                }
+
+                //Left justify the next 32 bits, padding short input with ones like the EOS padding
+                ulong window = bits >= 32
+                    ? (acc >> (bits - 32)) & uint.MaxValue
+                    : (acc << (32 - bits) | (uint.MaxValue >> bits)) & uint.MaxValue;
+
+                int length = 5;
+
+                while (window >= Limits[length])
+                {
+                    length++;
+                }
+
+                if (length > bits)
+                {
+                    //The remaining bits must be padding, shorter than a byte and all ones
+                    ulong padMask = (1ul << bits) - 1;
+
+                    if (bits > 7 || (acc & padMask) != padMask)
+                    {
+                        throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Invalid huffman string padding");
+                    }
+
+                    return written;
+                }
+
+                int symbol = Symbols[Offsets[length] + (int)(window >> (32 - length))];
+
+                if (symbol == EosSymbol)
+                {
+                    throw new Http2ProtocolException(Http2ErrorCode.CompressionError, "Huffman string contains the EOS symbol");
+                }
+
+                if (written == output.Length)
+                {
+                    return -1;
+                }
+
+                output[written++] = (byte)symbol;
+
+                bits -= length;
+                acc &= (1ul << bits) - 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,205 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HpackStaticTable.cs 
+*
+* HpackStaticTable.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Net;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// The predefined HPACK static table (RFC 7541 Appendix A) and the lookups 
+    /// used to encode response headers against it
+    /// </summary>
+    internal static class HpackStaticTable
+    {
+        /// <summary>
+        /// The number of entries in the static table, dynamic table indexes begin after it
+        /// </summary>
+        public const int Count = 61;
+
+        public const int Authority = 1;
+        public const int Status = 8;
+        public const int Date = 33;
+
+        private static readonly (byte[] Name, byte[] Value)[] Entries =
+        [
+            (":authority"u8.ToArray(), []),
+            (":method"u8.ToArray(), "GET"u8.ToArray()),
+            (":method"u8.ToArray(), "POST"u8.ToArray()),
+            (":path"u8.ToArray(), "/"u8.ToArray()),
+            (":path"u8.ToArray(), "/index.html"u8.ToArray()),
+            (":scheme"u8.ToArray(), "http"u8.ToArray()),
+            (":scheme"u8.ToArray(), "https"u8.ToArray()),
+            (":status"u8.ToArray(), "200"u8.ToArray()),
+            (":status"u8.ToArray(), "204"u8.ToArray()),
+            (":status"u8.ToArray(), "206"u8.ToArray()),
+            (":status"u8.ToArray(), "304"u8.ToArray()),
+            (":status"u8.ToArray(), "400"u8.ToArray()),
+            (":status"u8.ToArray(), "404"u8.ToArray()),
+            (":status"u8.ToArray(), "500"u8.ToArray()),
+            ("accept-charset"u8.ToArray(), []),
+            ("accept-encoding"u8.ToArray(), "gzip, deflate"u8.ToArray()),
+            ("accept-language"u8.ToArray(), []),
+            ("accept-ranges"u8.ToArray(), []),
+            ("accept"u8.ToArray(), []),
+            ("access-control-allow-origin"u8.ToArray(), []),
+            ("age"u8.ToArray(), []),
+            ("allow"u8.ToArray(), []),
+            ("authorization"u8.ToArray(), []),
+            ("cache-control"u8.ToArray(), []),
+            ("content-disposition"u8.ToArray(), []),
+            ("content-encoding"u8.ToArray(), []),
+            ("content-language"u8.ToArray(), []),
+            ("content-length"u8.ToArray(), []),
+            ("content-location"u8.ToArray(), []),
+            ("content-range"u8.ToArray(), []),
+            ("content-type"u8.ToArray(), []),
+            ("cookie"u8.ToArray(), []),
+            ("date"u8.ToArray(), []),
+            ("etag"u8.ToArray(), []),
+            ("expect"u8.ToArray(), []),
+            ("expires"u8.ToArray(), []),
+            ("from"u8.ToArray(), []),
+            ("host"u8.ToArray(), []),
+            ("if-match"u8.ToArray(), []),
+            ("if-modified-since"u8.ToArray(), []),
+            ("if-none-match"u8.ToArray(), []),
+            ("if-range"u8.ToArray(), []),
+            ("if-unmodified-since"u8.ToArray(), []),
+            ("last-modified"u8.ToArray(), []),
+            ("link"u8.ToArray(), []),
+            ("location"u8.ToArray(), []),
+            ("max-forwards"u8.ToArray(), []),
+            ("proxy-authenticate"u8.ToArray(), []),
+            ("proxy-authorization"u8.ToArray(), []),
+            ("range"u8.ToArray(), []),
+            ("referer"u8.ToArray(), []),
+            ("refresh"u8.ToArray(), []),
+            ("retry-after"u8.ToArray(), []),
+            ("server"u8.ToArray(), []),
+            ("set-cookie"u8.ToArray(), []),
+            ("strict-transport-security"u8.ToArray(), []),
+            ("transfer-encoding"u8.ToArray(), []),
+            ("user-agent"u8.ToArray(), []),
+            ("vary"u8.ToArray(), []),
+            ("via"u8.ToArray(), []),
+            ("www-authenticate"u8.ToArray(), []),
+        ];
+
+        /// <summary>
+        /// Gets the name of the static table entry at the 1 based index
+        /// </summary>
+        public static ReadOnlySpan<byte> GetName(int index) => Entries[index - 1].Name;
+
+        /// <summary>
+        /// Gets the value of the static table entry at the 1 based index
+        /// </summary>
+        public static ReadOnlySpan<byte> GetValue(int index) => Entries[index - 1].Value;
+
+        /// <summary>
+        /// Gets the full static table index of a response status code, 0 if the 
+        /// status code does not have an entry
+        /// </summary>
+        public static int GetStatusIndex(HttpStatusCode code)
+        {
+            return code switch
+            {
+                HttpStatusCode.OK => 8,
+                HttpStatusCode.NoContent => 9,
+                HttpStatusCode.PartialContent => 10,
+                HttpStatusCode.NotModified => 11,
+                HttpStatusCode.BadRequest => 12,
+                HttpStatusCode.NotFound => 13,
+                HttpStatusCode.InternalServerError => 14,
+                _ => 0
+            };
+        }
+
+        /// <summary>
+        /// Gets the static table name index of a known response header, 0 if 
+        /// the header name does not have an entry
+        /// </summary>
+        public static int GetNameIndex(HttpResponseHeader header)
+        {
+            return header switch
+            {
+                HttpResponseHeader.AcceptRanges => 18,
+                HttpResponseHeader.Age => 21,
+                HttpResponseHeader.Allow => 22,
+                HttpResponseHeader.CacheControl => 24,
+                HttpResponseHeader.ContentEncoding => 26,
+                HttpResponseHeader.ContentLanguage => 27,
+                HttpResponseHeader.ContentLength => 28,
+                HttpResponseHeader.ContentLocation => 29,
+                HttpResponseHeader.ContentRange => 30,
+                HttpResponseHeader.ContentType => 31,
+                HttpResponseHeader.Date => 33,
+                HttpResponseHeader.ETag => 34,
+                HttpResponseHeader.Expires => 36,
+                HttpResponseHeader.LastModified => 44,
+                HttpResponseHeader.Location => 46,
+                HttpResponseHeader.ProxyAuthenticate => 48,
+                HttpResponseHeader.RetryAfter => 53,
+                HttpResponseHeader.Server => 54,
+                HttpResponseHeader.SetCookie => 55,
+                HttpResponseHeader.Vary => 59,
+                HttpResponseHeader.Via => 60,
+                HttpResponseHeader.WwwAuthenticate => 61,
+                _ => 0
+            };
+        }
+
+        /// <summary>
+        /// Gets the lowercase field name of a known response header that does 
+        /// not have a static table entry
+        /// </summary>
+        public static ReadOnlySpan<byte> GetLiteralName(HttpResponseHeader header)
+        {
+            return header switch
+            {
+                HttpResponseHeader.Pragma => "pragma"u8,
+                HttpResponseHeader.Trailer => "trailer"u8,
+                HttpResponseHeader.Warning => "warning"u8,
+                HttpResponseHeader.ContentMd5 => "content-md5"u8,
+                HttpResponseHeader.Connection => "connection"u8,
+                HttpResponseHeader.KeepAlive => "keep-alive"u8,
+                HttpResponseHeader.TransferEncoding => "transfer-encoding"u8,
+                HttpResponseHeader.Upgrade => "upgrade"u8,
+                _ => GetName(GetNameIndex(header))
+            };
+        }
+
+        /// <summary>
+        /// Determines if the response header is connection specific and must not 
+        /// be sent in an HTTP/2 header block
+        /// </summary>
+        public static bool IsConnectionSpecific(HttpResponseHeader header)
+        {
+            return header is HttpResponseHeader.Connection 
+                or HttpResponseHeader.KeepAlive 
+                or HttpResponseHeader.TransferEncoding 
+                or HttpResponseHeader.Upgrade;
+        }
+    }
+}
@@ -0,0 +1,1125 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: Http2Connection.cs 
+*
+* Http2Connection.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.IO;
+using System.Buffers;
+using System.Threading;
+using System.Buffers.Binary;
+using System.Threading.Tasks;
+using System.Collections.Generic;
+
+using VNLib.Utils.Logging;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// Runs the HTTP/2 (RFC 9113) framing layer of a single transport connection. Frames are 
+    /// read on the connection's receive loop and requests are dispatched to pooled streams, 
+    /// so many requests are processed concurrently. Responses from all streams are written 
+    /// through a single send lock, and flow control windows are enforced in both directions.
+    /// </summary>
+    internal sealed class Http2Connection
+    {
+        //Enough to buffer a maximum size frame and the header of the next
+        private const int ReadBufferSize = 2 * (Http2FrameHeader.Size + Http2FrameHeader.DefaultMaxFrameSize);
+        private const int SendBufferSize = Http2FrameHeader.Size + Http2FrameHeader.DefaultMaxFrameSize;
+        private const int HeaderTableSize = 4096;
+
+        //The number of idle streams (and their contexts) kept for reuse
+        private const int MaxIdleStreams = 8;
+
+        //The number of streams reset by the server whose late frames are still ignored
+        private const int RecentResetCount = 64;
+
+        /// <summary>
+        /// The connection preface a client sends before any frames
+        /// </summary>
+        public static ReadOnlySpan<byte> Preface => "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"u8;
+
+        private readonly HttpServer _server;
+        private readonly Stream _transport;
+        private readonly IMemoryOwner<byte> _handle;
+        private readonly Memory<byte> _readBuffer;
+        private readonly Memory<byte> _sendBuffer;
+        private readonly Memory<byte> _headerBlock;
+        private readonly Memory<byte> _scratch;
+        private readonly HpackDecoder _decoder = new(HeaderTableSize);
+        private readonly SemaphoreSlim _sendLock = new(1, 1);
+        private readonly object _sync = new();
+        private readonly Dictionary<int, Http2Stream> _streams = [];
+        private readonly Stack<Http2Stream> _idle = new();
+        private readonly int[] _recentResets = new int[RecentResetCount];
+        private readonly int _maxStreams;
+
+        private int _recentResetIndex;
+
+        private int _readStart;
+        private int _readEnd;
+
+        //State of a header block that is continued in CONTINUATION frames
+        private int _headerStreamId;
+        private int _headerBlockLength;
+        private bool _headerEndStream;
+
+        private int _lastStreamId;
+        private int _receiveWindow = Http2FrameHeader.DefaultWindowSize;
+
+        //Send windows are guarded by the sync lock
+        private int _sendWindow = Http2FrameHeader.DefaultWindowSize;
+        private int _initialSendWindow = Http2FrameHeader.DefaultWindowSize;
+        private TaskCompletionSource? _windowWaiter;
+
+        private bool _closed;
+        private TaskCompletionSource? _drained;
+
+        /// <summary>
+        /// Initializes a new connection on a transport that has received the connection preface
+        /// </summary>
+        /// <param name="server">The server that processes requests</param>
+        /// <param name="transport">The connection's transport</param>
+        /// <param name="buffered">Data that was buffered from the transport after the preface</param>
+        public Http2Connection(HttpServer server, ITransportContext transport, ReadOnlySpan<byte> buffered)
+        {
+            _server = server;
+            Transport = transport;
+            _transport = transport.ConnectionStream;
+
+            ref readonly HttpConfig config = ref server.Config;
+
+            //Header blocks are only buffered when they are continued, a single frame is decoded in place
+            int headerBlockSize = Math.Max(config.BufferConfig.RequestHeaderBufferSize, Http2FrameHeader.DefaultMaxFrameSize);
+
+            //Huffman decoding expands a string by at most 8/5
+            int scratchSize = 2 * headerBlockSize;
+
+            //The transport may have buffered more data after the preface than a single read buffer holds
+            int readBufferSize = Math.Max(ReadBufferSize, buffered.Length);
+
+            _handle = config.MemoryPool.AllocateBufferForContext(readBufferSize + SendBufferSize + headerBlockSize + scratchSize);
+
+            Memory<byte> full = _handle.Memory;
+            _readBuffer = full[..readBufferSize];
+            _sendBuffer = full.Slice(readBufferSize, SendBufferSize);
+            _headerBlock = full.Slice(readBufferSize + SendBufferSize, headerBlockSize);
+            _scratch = full.Slice(readBufferSize + SendBufferSize + headerBlockSize, scratchSize);
+
+            _maxStreams = config.Http2MaxConcurrentStreams;
+
+            buffered.CopyTo(_readBuffer.Span);
+            _readEnd = buffered.Length;
+        }
+
+        /// <summary>
+        /// The transport the connection is running on
+        /// </summary>
+        public ITransportContext Transport { get; }
+
+        /// <summary>
+        /// The server that processes the connection's requests
+        /// </summary>
+        public HttpServer Server => _server;
+
+        /// <summary>
+        /// Determines if the buffered transport data begins with the HTTP/2 connection preface, 
+        /// and consumes it if it does
+        /// </summary>
+        /// <param name="reader">The connection's transport reader</param>
+        /// <returns>True if the client sent the connection preface</returns>
+        public static bool TryReadPreface(ref TransportReader reader)
+        {
+            while (true)
+            {
+                ReadOnlySpan<byte> window = reader.BufferedDataWindow;
+                int length = Math.Min(window.Length, Preface.Length);
+
+                //Any HTTP/1.x request line differs from the preface within the first few bytes
+                if (!window[..length].SequenceEqual(Preface[..length]))
+                {
+                    return false;
+                }
+
+                if (length == Preface.Length)
+                {
+                    reader.Advance(length);
+                    return true;
+                }
+
+                int buffered = reader.Available;
+
+                reader.FillBuffer();
+
+                //Let the HTTP/1.x parser handle the closed transport
+                if (reader.Available == buffered)
+                {
+                    return false;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Processes frames until the client closes the connection or a connection error occurs
+        /// </summary>
+        /// <param name="cancellation">A token that cancels waiting for transport data</param>
+        /// <returns>A task that completes when the connection and all of its streams are complete</returns>
+        public async Task RunAsync(CancellationToken cancellation)
+        {
+            try
+            {
+                await WriteSettingsAsync().ConfigureAwait(false);
+
+                bool first = true;
+
+                while (await ReadFrameAsync(cancellation).ConfigureAwait(false))
+                {
+                    Http2FrameHeader header = Http2FrameHeader.Read(_readBuffer.Span[_readStart..]);
+                    ReadOnlyMemory<byte> payload = _readBuffer.Slice(_readStart + Http2FrameHeader.Size, header.Length);
+
+                    //The preface must be followed by the client's settings
+                    if (first && (header.Type != Http2FrameType.Settings || header.HasFlag(Http2FrameFlags.Ack)))
+                    {
+                        throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "The connection preface was not followed by a SETTINGS frame");
+                    }
+
+                    first = false;
+
+                    await ProcessFrameAsync(header, payload).ConfigureAwait(false);
+
+                    _readStart += Http2FrameHeader.Size + header.Length;
+                }
+            }
+            catch (Http2ProtocolException pe)
+            {
+                _server.Config.ServerLog.Debug("HTTP/2 connection error {code}, {m}", pe.Code, pe.Message);
+
+                await WriteControlFrameAsync(Http2FrameType.GoAway, 0, 0, (ulong)(uint)_lastStreamId << 32 | (uint)pe.Code, 8).ConfigureAwait(false);
+            }
+            finally
+            {
+                await CloseAsync().ConfigureAwait(false);
+            }
+        }
+
+        private async ValueTask<bool> ReadFrameAsync(CancellationToken cancellation)
+        {
+            if (!await FillAsync(Http2FrameHeader.Size, cancellation).ConfigureAwait(false))
+            {
+                return false;
+            }
+
+            int length = Http2FrameHeader.Read(_readBuffer.Span[_readStart..]).Length;
+
+            //The default maximum frame size is never changed
+            if (length > Http2FrameHeader.DefaultMaxFrameSize)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.FrameSizeError, "Frame exceeds the maximum frame size");
+            }
+
+            return await FillAsync(Http2FrameHeader.Size + length, cancellation).ConfigureAwait(false);
+        }
+
+        private async ValueTask<bool> FillAsync(int required, CancellationToken cancellation)
+        {
+            while (_readEnd - _readStart < required)
+            {
+                //Shift the partial frame to the start of the buffer if it cannot fit
+                if (_readStart + required > _readBuffer.Length)
+                {
+                    _readBuffer[_readStart.._readEnd].CopyTo(_readBuffer);
+                    _readEnd -= _readStart;
+                    _readStart = 0;
+                }
+
+                int read = await _transport.ReadAsync(_readBuffer[_readEnd..], cancellation).ConfigureAwait(false);
+
+                if (read == 0)
+                {
+                    return false;
+                }
+
+                _readEnd += read;
+            }
+
+            return true;
+        }
+
+        #region Frame processing
+
+        private ValueTask ProcessFrameAsync(Http2FrameHeader header, ReadOnlyMemory<byte> payload)
+        {
+            //A continued header block must not be interleaved with any other frame
+            if (_headerStreamId != 0 && (header.Type != Http2FrameType.Continuation || header.StreamId != _headerStreamId))
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "Expected a CONTINUATION frame");
+            }
+
+            switch (header.Type)
+            {
+                case Http2FrameType.Data:
+                    return OnDataAsync(header, payload);
+
+                case Http2FrameType.Headers:
+                    return OnHeadersAsync(header, payload);
+
+                case Http2FrameType.Continuation:
+                    return OnContinuationAsync(header, payload);
+
+                case Http2FrameType.Priority:
+                    {
+                        //Priority signals are ignored
+                        RequireStream(header);
+
+                        if (header.Length != 5)
+                        {
+                            return ResetAsync(header.StreamId, Http2ErrorCode.FrameSizeError);
+                        }
+                    }
+                    break;
+
+                case Http2FrameType.RstStream:
+                    OnReset(header, payload.Span);
+                    break;
+
+                case Http2FrameType.Settings:
+                    return OnSettingsAsync(header, payload);
+
+                case Http2FrameType.Ping:
+                    {
+                        if (header.StreamId != 0)
+                        {
+                            throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "PING frame on a stream");
+                        }
+
+                        if (header.Length != 8)
+                        {
+                            throw new Http2ProtocolException(Http2ErrorCode.FrameSizeError, "Invalid PING frame size");
+                        }
+
+                        if (!header.HasFlag(Http2FrameFlags.Ack))
+                        {
+                            ulong data = BinaryPrimitives.ReadUInt64BigEndian(payload.Span);
+                            return WriteControlFrameAsync(Http2FrameType.Ping, Http2FrameFlags.Ack, 0, data, 8);
+                        }
+                    }
+                    break;
+
+                case Http2FrameType.GoAway:
+                    {
+                        if (header.StreamId != 0)
+                        {
+                            throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "GOAWAY frame on a stream");
+                        }
+
+                        //The client will not open more streams, open streams are completed and the client closes the connection
+                    }
+                    break;
+
+                case Http2FrameType.WindowUpdate:
+                    return OnWindowUpdateAsync(header, payload.Span);
+
+                case Http2FrameType.PushPromise:
+                    throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "Clients cannot push streams");
+
+                //Unknown frame types must be ignored
+                default:
+                    break;
+            }
+
+            return ValueTask.CompletedTask;
+        }
+
+        private ValueTask OnDataAsync(Http2FrameHeader header, ReadOnlyMemory<byte> payload)
+        {
+            RequireStream(header);
+
+            ReadOnlySpan<byte> data = RemovePadding(header, payload.Span);
+
+            //The entire frame including padding is flow controlled
+            if (header.Length > _receiveWindow)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.FlowControlError, "Connection flow control window exceeded");
+            }
+
+            _receiveWindow -= header.Length;
+
+            Http2ErrorCode? error = null;
+
+            Http2Stream? stream = GetStream(header.StreamId);
+
+            if (stream == null)
+            {
+                if (header.StreamId > _lastStreamId)
+                {
+                    throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "DATA frame on an idle stream");
+                }
+
+                //Data for streams that were already reset is discarded
+            }
+            else if (stream.IsRemoteClosed)
+            {
+                error = Http2ErrorCode.StreamClosed;
+            }
+            else if (!stream.TryReceive(data, header.Length, header.HasFlag(Http2FrameFlags.EndStream)))
+            {
+                error = Http2ErrorCode.FlowControlError;
+            }
+
+            //Data is buffered by the stream, so the connection window is replenished as soon as it is received
+            int increment = _receiveWindow <= Http2FrameHeader.DefaultWindowSize / 2 ? Http2FrameHeader.DefaultWindowSize - _receiveWindow : 0;
+
+            return increment > 0 || error.HasValue ? CompleteDataAsync(header.StreamId, increment, error) : ValueTask.CompletedTask;
+        }
+
+        private async ValueTask CompleteDataAsync(int streamId, int increment, Http2ErrorCode? error)
+        {
+            if (error.HasValue)
+            {
+                await ResetAsync(streamId, error.Value).ConfigureAwait(false);
+            }
+
+            if (increment > 0)
+            {
+                _receiveWindow += increment;
+                await WriteWindowUpdateAsync(0, increment).ConfigureAwait(false);
+            }
+        }
+
+        private ValueTask OnHeadersAsync(Http2FrameHeader header, ReadOnlyMemory<byte> payload)
+        {
+            RequireStream(header);
+
+            ReadOnlySpan<byte> fragment = RemovePadding(header, payload.Span);
+
+            //Priority signals are ignored
+            if (header.HasFlag(Http2FrameFlags.Priority))
+            {
+                if (fragment.Length < 5)
+                {
+                    throw new Http2ProtocolException(Http2ErrorCode.FrameSizeError, "Invalid HEADERS frame size");
+                }
+
+                fragment = fragment[5..];
+            }
+
+            bool endStream = header.HasFlag(Http2FrameFlags.EndStream);
+
+            //The block is decoded in place when it is not continued
+            if (header.HasFlag(Http2FrameFlags.EndHeaders))
+            {
+                return OnHeaderBlockAsync(header.StreamId, endStream, fragment);
+            }
+
+            _headerStreamId = header.StreamId;
+            _headerEndStream = endStream;
+            _headerBlockLength = 0;
+
+            AppendHeaderBlock(fragment);
+
+            return ValueTask.CompletedTask;
+        }
+
+        private ValueTask OnContinuationAsync(Http2FrameHeader header, ReadOnlyMemory<byte> payload)
+        {
+            if (_headerStreamId == 0)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "Unexpected CONTINUATION frame");
+            }
+
+            AppendHeaderBlock(payload.Span);
+
+            if (!header.HasFlag(Http2FrameFlags.EndHeaders))
+            {
+                return ValueTask.CompletedTask;
+            }
+
+            int streamId = _headerStreamId;
+            _headerStreamId = 0;
+
+            return OnHeaderBlockAsync(streamId, _headerEndStream, _headerBlock.Span[.._headerBlockLength]);
+        }
+
+        private void AppendHeaderBlock(ReadOnlySpan<byte> fragment)
+        {
+            /*
+             * A header block must be decoded to keep the decoder state in sync with 
+             * the client, so a block that cannot be buffered ends the connection
+             */
+            if (_headerBlockLength + fragment.Length > _headerBlock.Length)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.EnhanceYourCalm, "Header block exceeds the request header buffer");
+            }
+
+            fragment.CopyTo(_headerBlock.Span[_headerBlockLength..]);
+            _headerBlockLength += fragment.Length;
+        }
+
+        private ValueTask OnHeaderBlockAsync(int streamId, bool endStream, ReadOnlySpan<byte> block)
+        {
+            //Client streams always have odd identifiers
+            if ((streamId & 1) == 0)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "Invalid client stream identifier");
+            }
+
+            _decoder.BeginBlock();
+
+            if (streamId <= _lastStreamId)
+            {
+                //Trailers are decoded to keep the decoder in sync, but are not used
+                DiscardHeaderBlock(block);
+
+                Http2Stream? existing = GetStream(streamId);
+
+                /*
+                 * RFC 9113 5.1, frames may still arrive on a stream the server reset 
+                 * before the client received the reset, but HEADERS on any other 
+                 * closed stream is a connection error
+                 */
+                if (existing == null)
+                {
+                    return WasRecentlyReset(streamId)
+                        ? ValueTask.CompletedTask
+                        : throw new Http2ProtocolException(Http2ErrorCode.StreamClosed, "HEADERS frame on a closed stream");
+                }
+
+                if (existing.IsReset)
+                {
+                    return ValueTask.CompletedTask;
+                }
+
+                //Trailers must end the stream
+                if (existing.IsRemoteClosed || !endStream)
+                {
+                    return ResetAsync(streamId, existing.IsRemoteClosed ? Http2ErrorCode.StreamClosed : Http2ErrorCode.ProtocolError);
+                }
+
+                existing.TryReceive(default, 0, true);
+                return ValueTask.CompletedTask;
+            }
+
+            _lastStreamId = streamId;
+
+            Http2Stream? stream = null;
+
+            lock (_sync)
+            {
+                if (_streams.Count < _maxStreams)
+                {
+                    stream = _idle.TryPop(out Http2Stream? idle) ? idle : new Http2Stream(this, _server.RentContext());
+                }
+            }
+
+            if (stream == null)
+            {
+                DiscardHeaderBlock(block);
+                return ResetAsync(streamId, Http2ErrorCode.RefusedStream);
+            }
+
+            stream.Open(streamId, _initialSendWindow, endStream);
+
+            //Translate the request into the stream context's request header buffer
+            Http2HeadBuilder head = new(stream.Context.Buffers.RequestHeaderParseBuffer.GetBinSpan(0));
+
+            try
+            {
+                DecodeHeaderBlock(block, ref head);
+            }
+            catch (Http2ProtocolException)
+            {
+                //Compression errors end the connection, the stream must not keep its context
+                ReturnStream(stream);
+                throw;
+            }
+
+            int headLength = head.Complete();
+
+            if (head.Error == Http2HeadError.Malformed)
+            {
+                ReturnStream(stream);
+                return ResetAsync(streamId, Http2ErrorCode.ProtocolError);
+            }
+
+            //Oversized heads are answered with a 431 response
+            stream.HeadLength = headLength;
+
+            lock (_sync)
+            {
+                _streams.Add(streamId, stream);
+            }
+
+            ThreadPool.UnsafeQueueUserWorkItem(stream, preferLocal: false);
+
+            return ValueTask.CompletedTask;
+        }
+
+        private void DecodeHeaderBlock(ReadOnlySpan<byte> block, ref Http2HeadBuilder head)
+        {
+            Span<byte> scratch = _scratch.Span;
+
+            while (_decoder.TryReadField(ref block, scratch, out ReadOnlySpan<byte> name, out ReadOnlySpan<byte> value))
+            {
+                head.Add(name, value);
+            }
+        }
+
+        private void DiscardHeaderBlock(ReadOnlySpan<byte> block)
+        {
+            Http2HeadBuilder discard = new(default);
+            DecodeHeaderBlock(block, ref discard);
+        }
+
+        private void OnReset(Http2FrameHeader header, ReadOnlySpan<byte> payload)
+        {
+            RequireStream(header);
+
+            if (header.Length != 4)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.FrameSizeError, "Invalid RST_STREAM frame size");
+            }
+
+            if (header.StreamId > _lastStreamId)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "RST_STREAM frame on an idle stream");
+            }
+
+            if (GetStream(header.StreamId) is Http2Stream stream)
+            {
+                stream.Abort();
+
+                //Release writers waiting for window on the stream
+                lock (_sync)
+                {
+                    ReleaseWindowWaiters();
+                }
+            }
+        }
+
+        private ValueTask OnSettingsAsync(Http2FrameHeader header, ReadOnlyMemory<byte> payload)
+        {
+            if (header.StreamId != 0)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "SETTINGS frame on a stream");
+            }
+
+            if (header.HasFlag(Http2FrameFlags.Ack))
+            {
+                return header.Length == 0 
+                    ? ValueTask.CompletedTask 
+                    : throw new Http2ProtocolException(Http2ErrorCode.FrameSizeError, "Invalid SETTINGS acknowledgment");
+            }
+
+            if (header.Length % 6 != 0)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.FrameSizeError, "Invalid SETTINGS frame size");
+            }
+
+            for (ReadOnlySpan<byte> settings = payload.Span; !settings.IsEmpty; settings = settings[6..])
+            {
+                uint value = BinaryPrimitives.ReadUInt32BigEndian(settings[2..]);
+
+                switch ((Http2SettingsId)BinaryPrimitives.ReadUInt16BigEndian(settings))
+                {
+                    case Http2SettingsId.EnablePush:
+                        if (value > 1)
+                        {
+                            throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "Invalid SETTINGS_ENABLE_PUSH value");
+                        }
+                        break;
+
+                    case Http2SettingsId.InitialWindowSize:
+                        if (value > Http2FrameHeader.MaxWindowSize)
+                        {
+                            throw new Http2ProtocolException(Http2ErrorCode.FlowControlError, "Invalid SETTINGS_INITIAL_WINDOW_SIZE value");
+                        }
+
+                        SetInitialSendWindow((int)value);
+                        break;
+
+                    case Http2SettingsId.MaxFrameSize:
+                        //Frames are never sent larger than the default size
+                        if (value < Http2FrameHeader.DefaultMaxFrameSize || value > Http2FrameHeader.MaxAllowedFrameSize)
+                        {
+                            throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "Invalid SETTINGS_MAX_FRAME_SIZE value");
+                        }
+                        break;
+
+                    //The encoder does not use a dynamic table and push is never used, so other settings do not apply
+                    default:
+                        break;
+                }
+            }
+
+            return WriteControlFrameAsync(Http2FrameType.Settings, Http2FrameFlags.Ack, 0, 0, 0);
+        }
+
+        private void SetInitialSendWindow(int value)
+        {
+            lock (_sync)
+            {
+                int delta = value - _initialSendWindow;
+                _initialSendWindow = value;
+
+                //The change applies to the windows of all open streams
+                foreach (Http2Stream stream in _streams.Values)
+                {
+                    if ((long)stream.SendWindow + delta > Http2FrameHeader.MaxWindowSize)
+                    {
+                        throw new Http2ProtocolException(Http2ErrorCode.FlowControlError, "Stream flow control window overflow");
+                    }
+
+                    stream.SendWindow += delta;
+                }
+
+                ReleaseWindowWaiters();
+            }
+        }
+
+        private ValueTask OnWindowUpdateAsync(Http2FrameHeader header, ReadOnlySpan<byte> payload)
+        {
+            if (header.Length != 4)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.FrameSizeError, "Invalid WINDOW_UPDATE frame size");
+            }
+
+            int increment = (int)(BinaryPrimitives.ReadUInt32BigEndian(payload) & 0x7fffffffu);
+
+            if (header.StreamId == 0)
+            {
+                lock (_sync)
+                {
+                    if (increment == 0 || (long)_sendWindow + increment > Http2FrameHeader.MaxWindowSize)
+                    {
+                        throw new Http2ProtocolException(increment == 0 ? Http2ErrorCode.ProtocolError : Http2ErrorCode.FlowControlError, "Invalid connection WINDOW_UPDATE");
+                    }
+
+                    _sendWindow += increment;
+                    ReleaseWindowWaiters();
+                }
+
+                return ValueTask.CompletedTask;
+            }
+
+            Http2Stream? stream = GetStream(header.StreamId);
+
+            if (stream == null)
+            {
+                return header.StreamId > _lastStreamId
+                    ? throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "WINDOW_UPDATE frame on an idle stream")
+                    : ValueTask.CompletedTask;
+            }
+
+            lock (_sync)
+            {
+                if (increment > 0 && (long)stream.SendWindow + increment <= Http2FrameHeader.MaxWindowSize)
+                {
+                    stream.SendWindow += increment;
+                    ReleaseWindowWaiters();
+                    return ValueTask.CompletedTask;
+                }
+            }
+
+            return ResetAsync(header.StreamId, increment == 0 ? Http2ErrorCode.ProtocolError : Http2ErrorCode.FlowControlError);
+        }
+
+        private static void RequireStream(Http2FrameHeader header)
+        {
+            if (header.StreamId == 0)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, $"{header.Type} frame on the connection stream");
+            }
+        }
+
+        private static ReadOnlySpan<byte> RemovePadding(Http2FrameHeader header, ReadOnlySpan<byte> payload)
+        {
+            if (!header.HasFlag(Http2FrameFlags.Padded))
+            {
+                return payload;
+            }
+
+            if (payload.IsEmpty || payload[0] >= payload.Length)
+            {
+                throw new Http2ProtocolException(Http2ErrorCode.ProtocolError, "Invalid frame padding");
+            }
+
+            return payload[1..^payload[0]];
+        }
+
+        private Http2Stream? GetStream(int streamId)
+        {
+            lock (_sync)
+            {
+                return _streams.GetValueOrDefault(streamId);
+            }
+        }
+
+        private bool WasRecentlyReset(int streamId)
+        {
+            lock (_sync)
+            {
+                return Array.IndexOf(_recentResets, streamId) >= 0;
+            }
+        }
+
+        #endregion
+
+        #region Streams
+
+        /// <summary>
+        /// Completes the response of a stream after the request was processed
+        /// </summary>
+        /// <param name="stream">The stream to complete</param>
+        /// <returns>A task that completes when the stream was closed</returns>
+        public async ValueTask EndStreamAsync(Http2Stream stream)
+        {
+            if (stream.IsReset)
+            {
+                return;
+            }
+
+            if (!stream.IsEndStreamSent)
+            {
+                await stream.WriteDataAsync(default, true).ConfigureAwait(false);
+            }
+
+            //The remaining request body is no longer needed
+            if (!stream.IsRemoteClosed)
+            {
+                await ResetAsync(stream.Id, Http2ErrorCode.NoError).ConfigureAwait(false);
+            }
+        }
+
+        /// <summary>
+        /// Resets a stream with an error code
+        /// </summary>
+        /// <param name="streamId">The identifier of the stream to reset</param>
+        /// <param name="code">The error code to send</param>
+        /// <returns>A task that completes when the reset frame was sent</returns>
+        public ValueTask ResetAsync(int streamId, Http2ErrorCode code)
+        {
+            Http2Stream? stream = GetStream(streamId);
+
+            stream?.Abort();
+
+            lock (_sync)
+            {
+                //Remember the stream so late frames from the client are ignored
+                _recentResets[_recentResetIndex] = streamId;
+                _recentResetIndex = (_recentResetIndex + 1) % RecentResetCount;
+
+                if (stream != null)
+                {
+                    ReleaseWindowWaiters();
+                }
+            }
+
+            return WriteControlFrameAsync(Http2FrameType.RstStream, 0, streamId, (uint)code, 4);
+        }
+
+        /// <summary>
+        /// Returns a stream whose request is complete, so it may be reused for another request
+        /// </summary>
+        /// <param name="stream">The stream to return</param>
+        public void ReturnStream(Http2Stream stream)
+        {
+            stream.ReleaseBuffers();
+
+            lock (_sync)
+            {
+                _streams.Remove(stream.Id);
+
+                if (_closed || _idle.Count >= MaxIdleStreams)
+                {
+                    _server.ReturnContext(stream.Context);
+                }
+                else
+                {
+                    _idle.Push(stream);
+                }
+
+                if (_closed && _streams.Count == 0)
+                {
+                    _drained?.TrySetResult();
+                }
+            }
+        }
+
+        private async Task CloseAsync()
+        {
+            Task? drained = null;
+
+            lock (_sync)
+            {
+                _closed = true;
+
+                //Streams still processing a request cannot send or receive anymore
+                foreach (Http2Stream stream in _streams.Values)
+                {
+                    stream.Abort();
+                }
+
+                ReleaseWindowWaiters();
+
+                if (_streams.Count > 0)
+                {
+                    _drained = new TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously);
+                    drained = _drained.Task;
+                }
+            }
+
+            if (drained != null)
+            {
+                await drained.ConfigureAwait(false);
+            }
+
+            lock (_sync)
+            {
+                while (_idle.TryPop(out Http2Stream? stream))
+                {
+                    _server.ReturnContext(stream.Context);
+                }
+            }
+
+            _handle.Dispose();
+            _sendLock.Dispose();
+        }
+
+        #endregion
+
+        #region Sending
+
+        private ValueTask WriteSettingsAsync()
+        {
+            byte[] settings = new byte[12];
+
+            BinaryPrimitives.WriteUInt16BigEndian(settings, (ushort)Http2SettingsId.MaxConcurrentStreams);
+            BinaryPrimitives.WriteUInt32BigEndian(settings.AsSpan(2), (uint)_maxStreams);
+            BinaryPrimitives.WriteUInt16BigEndian(settings.AsSpan(6), (ushort)Http2SettingsId.MaxHeaderListSize);
+            BinaryPrimitives.WriteUInt32BigEndian(settings.AsSpan(8), (uint)_server.Config.BufferConfig.RequestHeaderBufferSize);
+
+            return WriteFrameAsync(new(settings.Length, Http2FrameType.Settings, 0, 0), settings);
+        }
+
+        /// <summary>
+        /// Grants the client more flow control window
+        /// </summary>
+        /// <param name="streamId">The stream to grant window for, 0 for the connection</param>
+        /// <param name="increment">The number of bytes to add to the window</param>
+        /// <returns>A task that completes when the frame was sent</returns>
+        public ValueTask WriteWindowUpdateAsync(int streamId, int increment) 
+            => WriteControlFrameAsync(Http2FrameType.WindowUpdate, 0, streamId, (uint)increment, 4);
+
+        /// <summary>
+        /// Sends a stream's response header block in a HEADERS frame and as many 
+        /// CONTINUATION frames as required
+        /// </summary>
+        /// <param name="stream">The stream the headers belong to</param>
+        /// <param name="block">The encoded header block</param>
+        /// <param name="endStream">True if the response does not have a body</param>
+        /// <returns>A task that completes when the header block was sent</returns>
+        public async ValueTask WriteHeadersAsync(Http2Stream stream, ReadOnlyMemory<byte> block, bool endStream)
+        {
+            await _sendLock.WaitAsync().ConfigureAwait(false);
+
+            try
+            {
+                ThrowIfReset(stream);
+
+                //The frames of a header block must be sent contiguously, so the lock is held for all of them
+                Http2FrameType type = Http2FrameType.Headers;
+                Http2FrameFlags flags = endStream ? Http2FrameFlags.EndStream : 0;
+
+                do
+                {
+                    int size = Math.Min(block.Length, Http2FrameHeader.DefaultMaxFrameSize);
+
+                    if (size == block.Length)
+                    {
+                        flags |= Http2FrameFlags.EndHeaders;
+                    }
+
+                    int length = CopyFrame(new(size, type, flags, stream.Id), block.Span[..size]);
+
+                    await _transport.WriteAsync(_sendBuffer[..length]).ConfigureAwait(false);
+
+                    block = block[size..];
+                    type = Http2FrameType.Continuation;
+                    flags = 0;
+
+                } while (!block.IsEmpty);
+
+                await _transport.FlushAsync().ConfigureAwait(false);
+            }
+            finally
+            {
+                _sendLock.Release();
+            }
+        }
+
+        /// <summary>
+        /// Sends a stream's response data in DATA frames, waiting for flow control window 
+        /// when required
+        /// </summary>
+        /// <param name="stream">The stream the data belongs to</param>
+        /// <param name="data">The data to send</param>
+        /// <param name="endStream">True if the data is the end of the response</param>
+        /// <returns>A task that completes when all data was sent</returns>
+        public async ValueTask WriteDataAsync(Http2Stream stream, ReadOnlyMemory<byte> data, bool endStream)
+        {
+            do
+            {
+                //Empty frames are not flow controlled
+                int size = data.IsEmpty ? 0 : await ReserveWindowAsync(stream, data.Length).ConfigureAwait(false);
+
+                bool end = endStream && size == data.Length;
+
+                await WriteFrameAsync(
+                    new(size, Http2FrameType.Data, end ? Http2FrameFlags.EndStream : 0, stream.Id), 
+                    data[..size], 
+                    stream
+                ).ConfigureAwait(false);
+
+                data = data[size..];
+
+            } while (!data.IsEmpty);
+        }
+
+        private async ValueTask<int> ReserveWindowAsync(Http2Stream stream, int required)
+        {
+            while (true)
+            {
+                Task wait;
+
+                lock (_sync)
+                {
+                    ThrowIfReset(stream);
+
+                    int size = Math.Min(Math.Min(required, Http2FrameHeader.DefaultMaxFrameSize), Math.Min(stream.SendWindow, _sendWindow));
+
+                    if (size > 0)
+                    {
+                        stream.SendWindow -= size;
+                        _sendWindow -= size;
+                        return size;
+                    }
+
+                    //Wait for the client to grant more window
+                    _windowWaiter ??= new TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously);
+                    wait = _windowWaiter.Task;
+                }
+
+                await wait.ConfigureAwait(false);
+            }
+        }
+
+        private void ReleaseWindowWaiters()
+        {
+            _windowWaiter?.TrySetResult();
+            _windowWaiter = null;
+        }
+
+        private async ValueTask WriteFrameAsync(Http2FrameHeader header, ReadOnlyMemory<byte> payload, Http2Stream? stream = null)
+        {
+            await _sendLock.WaitAsync().ConfigureAwait(false);
+
+            try
+            {
+                if (stream != null)
+                {
+                    ThrowIfReset(stream);
+                }
+
+                int length = CopyFrame(header, payload.Span);
+
+                await _transport.WriteAsync(_sendBuffer[..length]).ConfigureAwait(false);
+                await _transport.FlushAsync().ConfigureAwait(false);
+            }
+            finally
+            {
+                _sendLock.Release();
+            }
+        }
+
+        /*
+         * Writes a frame whose payload is a single big endian integer of 
+         * 0, 4 or 8 bytes, so control frames do not need a payload buffer
+         */
+        private async ValueTask WriteControlFrameAsync(Http2FrameType type, Http2FrameFlags flags, int streamId, ulong value, int length)
+        {
+            await _sendLock.WaitAsync().ConfigureAwait(false);
+
+            try
+            {
+                if (_closed)
+                {
+                    return;
+                }
+
+                CopyControlFrame(new(length, type, flags, streamId), value);
+
+                await _transport.WriteAsync(_sendBuffer[..(Http2FrameHeader.Size + length)]).ConfigureAwait(false);
+                await _transport.FlushAsync().ConfigureAwait(false);
+            }
+            finally
+            {
+                _sendLock.Release();
+            }
+        }
+
+        private void CopyControlFrame(Http2FrameHeader header, ulong value)
+        {
+            Span<byte> buffer = _sendBuffer.Span;
+
+            header.Write(buffer);
+
+            if (header.Length == 8)
+            {
+                BinaryPrimitives.WriteUInt64BigEndian(buffer[Http2FrameHeader.Size..], value);
+            }
+            else if (header.Length == 4)
+            {
+                BinaryPrimitives.WriteUInt32BigEndian(buffer[Http2FrameHeader.Size..], (uint)value);
+            }
+        }
+
+        private int CopyFrame(Http2FrameHeader header, ReadOnlySpan<byte> payload)
+        {
+            Span<byte> buffer = _sendBuffer.Span;
+
+            header.Write(buffer);
+            payload.CopyTo(buffer[Http2FrameHeader.Size..]);
+
+            return Http2FrameHeader.Size + payload.Length;
+        }
+
+        private static void ThrowIfReset(Http2Stream stream)
+        {
+            if (stream.IsReset)
+            {
+                throw new IOException("The HTTP/2 stream was reset");
+            }
+        }
+
+        #endregion
+    }
+}
@@ -0,0 +1,165 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: Http2Frames.cs 
+*
+* Http2Frames.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Buffers.Binary;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// HTTP/2 frame types defined by RFC 9113
+    /// </summary>
+    internal enum Http2FrameType : byte
+    {
+        Data = 0x0,
+        Headers = 0x1,
+        Priority = 0x2,
+        RstStream = 0x3,
+        Settings = 0x4,
+        PushPromise = 0x5,
+        Ping = 0x6,
+        GoAway = 0x7,
+        WindowUpdate = 0x8,
+        Continuation = 0x9
+    }
+
+    /// <summary>
+    /// HTTP/2 frame flags, the meaning of a flag depends on the frame type
+    /// </summary>
+    [Flags]
+    internal enum Http2FrameFlags : byte
+    {
+        None = 0x0,
+        EndStream = 0x1,
+        Ack = 0x1,
+        EndHeaders = 0x4,
+        Padded = 0x8,
+        Priority = 0x20
+    }
+
+    /// <summary>
+    /// HTTP/2 error codes sent in RST_STREAM and GOAWAY frames
+    /// </summary>
+    internal enum Http2ErrorCode : uint
+    {
+        NoError = 0x0,
+        ProtocolError = 0x1,
+        InternalError = 0x2,
+        FlowControlError = 0x3,
+        SettingsTimeout = 0x4,
+        StreamClosed = 0x5,
+        FrameSizeError = 0x6,
+        RefusedStream = 0x7,
+        Cancel = 0x8,
+        CompressionError = 0x9,
+        ConnectError = 0xa,
+        EnhanceYourCalm = 0xb,
+        InadequateSecurity = 0xc,
+        Http11Required = 0xd
+    }
+
+    /// <summary>
+    /// HTTP/2 SETTINGS frame parameter identifiers
+    /// </summary>
+    internal enum Http2SettingsId : ushort
+    {
+        HeaderTableSize = 0x1,
+        EnablePush = 0x2,
+        MaxConcurrentStreams = 0x3,
+        InitialWindowSize = 0x4,
+        MaxFrameSize = 0x5,
+        MaxHeaderListSize = 0x6
+    }
+
+    /// <summary>
+    /// The fixed 9 byte header that precedes every HTTP/2 frame
+    /// </summary>
+    /// <param name="Length">The length of the frame payload</param>
+    /// <param name="Type">The frame type</param>
+    /// <param name="Flags">The frame flags</param>
+    /// <param name="StreamId">The stream the frame belongs to, 0 for connection frames</param>
+    internal readonly record struct Http2FrameHeader(int Length, Http2FrameType Type, Http2FrameFlags Flags, int StreamId)
+    {
+        /// <summary>
+        /// The size of an encoded frame header
+        /// </summary>
+        public const int Size = 9;
+
+        /// <summary>
+        /// The default and minimum maximum frame payload size
+        /// </summary>
+        public const int DefaultMaxFrameSize = 16384;
+
+        /// <summary>
+        /// The largest maximum frame payload size a peer may advertise
+        /// </summary>
+        public const int MaxAllowedFrameSize = 16777215;
+
+        /// <summary>
+        /// The largest flow control window size
+        /// </summary>
+        public const int MaxWindowSize = int.MaxValue;
+
+        /// <summary>
+        /// The default initial flow control window size for streams and the connection
+        /// </summary>
+        public const int DefaultWindowSize = 65535;
+
+        /// <summary>
+        /// Determines if the flag is set on the frame
+        /// </summary>
+        /// <param name="flag">The flag to test</param>
+        /// <returns>True if the flag is set</returns>
+        public bool HasFlag(Http2FrameFlags flag) => (Flags & flag) != 0;
+
+        /// <summary>
+        /// Reads a frame header from the start of the buffer
+        /// </summary>
+        /// <param name="buffer">The buffer containing at least <see cref="Size"/> bytes</param>
+        /// <returns>The decoded frame header</returns>
+        public static Http2FrameHeader Read(ReadOnlySpan<byte> buffer)
+        {
+            int length = buffer[0] << 16 | buffer[1] << 8 | buffer[2];
+
+            //The reserved bit of the stream identifier must be ignored
+            int streamId = (int)(BinaryPrimitives.ReadUInt32BigEndian(buffer[5..]) & 0x7fffffffu);
+
+            return new(length, (Http2FrameType)buffer[3], (Http2FrameFlags)buffer[4], streamId);
+        }
+
+        /// <summary>
+        /// Writes the frame header to the start of the buffer
+        /// </summary>
+        /// <param name="buffer">The buffer to write at least <see cref="Size"/> bytes to</param>
+        public void Write(Span<byte> buffer)
+        {
+            buffer[0] = (byte)(Length >> 16);
+            buffer[1] = (byte)(Length >> 8);
+            buffer[2] = (byte)Length;
+            buffer[3] = (byte)Type;
+            buffer[4] = (byte)Flags;
+            BinaryPrimitives.WriteUInt32BigEndian(buffer[5..], (uint)StreamId);
+        }
+    }
+}
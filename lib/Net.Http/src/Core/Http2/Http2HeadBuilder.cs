@@ -0,0 +1,256 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: Http2HeadBuilder.cs 
+*
+* Http2HeadBuilder.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Buffers;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// The result of translating an HTTP/2 request header block
+    /// </summary>
+    internal enum Http2HeadError
+    {
+        None,
+        /// <summary>
+        /// The header block is not a valid HTTP/2 request (RFC 9113 8.1.1)
+        /// </summary>
+        Malformed,
+        /// <summary>
+        /// The translated request head does not fit in the request header buffer
+        /// </summary>
+        TooLarge
+    }
+
+    /// <summary>
+    /// Translates the decoded fields of an HTTP/2 request header block into an HTTP/1.1 
+    /// style request head, so requests on every protocol version are validated and parsed 
+    /// by the same request parser.
+    /// </summary>
+    /// <remarks>
+    /// Pseudo-header fields always precede regular fields, but the request line must be 
+    /// written before any header line. Pseudo-header values are stored at the end of the 
+    /// buffer until the first regular field arrives and the request line can be written.
+    /// </remarks>
+    /// <param name="buffer">The request header buffer to write the translated head to</param>
+    internal ref struct Http2HeadBuilder(Span<byte> buffer)
+    {
+        //Lowercase token characters, uppercase field names are malformed in HTTP/2
+        private static readonly SearchValues<byte> FieldNameChars = SearchValues.Create("abcdefghijklmnopqrstuvwxyz0123456789!#$%&'*+-.^_`|~"u8);
+
+        private readonly Span<byte> _buffer = buffer;
+        private int _position;
+        private int _tailStart = buffer.Length;
+        private bool _requestLineWritten;
+        private bool _schemeFound;
+
+        private Range _method;
+        private Range _path;
+        private Range _authority;
+
+        /// <summary>
+        /// The first error encountered while translating the header block. Once set, 
+        /// remaining fields are ignored but should still be decoded.
+        /// </summary>
+        public Http2HeadError Error { get; private set; }
+
+        /// <summary>
+        /// Adds a decoded header field to the request head
+        /// </summary>
+        /// <param name="name">The field name</param>
+        /// <param name="value">The field value</param>
+        public void Add(scoped ReadOnlySpan<byte> name, scoped ReadOnlySpan<byte> value)
+        {
+            if (Error != Http2HeadError.None)
+            {
+                return;
+            }
+
+            //Field values must not contain line delimiters or NUL (RFC 9113 8.2.1)
+            if (name.IsEmpty || value.IndexOfAny((byte)'\0', (byte)'\r', (byte)'\n') >= 0)
+            {
+                Error = Http2HeadError.Malformed;
+                return;
+            }
+
+            if (name[0] == ':')
+            {
+                AddPseudoHeader(name, value);
+                return;
+            }
+
+            if (name.IndexOfAnyExcept(FieldNameChars) >= 0 || IsConnectionSpecific(name, value))
+            {
+                Error = Http2HeadError.Malformed;
+                return;
+            }
+
+            if (!_requestLineWritten && !WriteRequestLine())
+            {
+                return;
+            }
+
+            //The host header is redundant when the authority pseudo-header is set
+            if (!_authority.Equals(default(Range)) && name.SequenceEqual("host"u8))
+            {
+                return;
+            }
+
+            WriteLine(name, value);
+        }
+
+        /// <summary>
+        /// Writes the end of the request head
+        /// </summary>
+        /// <returns>The length of the request head, or -1 if the header block could not be translated</returns>
+        public int Complete()
+        {
+            if (Error == Http2HeadError.None && (_requestLineWritten || WriteRequestLine()) && Append("\r\n"u8))
+            {
+                return _position;
+            }
+
+            return -1;
+        }
+
+        private void AddPseudoHeader(scoped ReadOnlySpan<byte> name, scoped ReadOnlySpan<byte> value)
+        {
+            //Pseudo-headers must precede regular fields and may only appear once
+            if (_requestLineWritten)
+            {
+                Error = Http2HeadError.Malformed;
+                return;
+            }
+
+            if (name.SequenceEqual(":method"u8))
+            {
+                StoreValue(ref _method, value);
+            }
+            else if (name.SequenceEqual(":path"u8))
+            {
+                StoreValue(ref _path, value);
+            }
+            else if (name.SequenceEqual(":authority"u8))
+            {
+                StoreValue(ref _authority, value);
+            }
+            else if (name.SequenceEqual(":scheme"u8) && !_schemeFound)
+            {
+                /*
+                 * The scheme is determined by the transport, the value 
+                 * is only required to be present
+                 */
+                _schemeFound = true;
+            }
+            else
+            {
+                Error = Http2HeadError.Malformed;
+            }
+        }
+
+        private void StoreValue(ref Range range, scoped ReadOnlySpan<byte> value)
+        {
+            //Values must be non-empty, must not contain whitespace and may only be set once
+            if (!range.Equals(default(Range)) || value.IsEmpty || value.IndexOfAny((byte)' ', (byte)'\t') >= 0)
+            {
+                Error = Http2HeadError.Malformed;
+                return;
+            }
+
+            if (_tailStart - value.Length < _position)
+            {
+                Error = Http2HeadError.TooLarge;
+                return;
+            }
+
+            _tailStart -= value.Length;
+            value.CopyTo(_buffer[_tailStart..]);
+
+            range = new(_tailStart, _tailStart + value.Length);
+        }
+
+        private bool WriteRequestLine()
+        {
+            if (_method.Equals(default(Range)) || _path.Equals(default(Range)) || !_schemeFound)
+            {
+                Error = Http2HeadError.Malformed;
+                return false;
+            }
+
+            _requestLineWritten = true;
+
+            /*
+             * The request line is written to the start of the buffer while the 
+             * pseudo-header values are still stored at the end, they must not 
+             * overlap
+             */
+            bool written = Append(_buffer[_method])
+                && Append(" "u8)
+                && Append(_buffer[_path])
+                && Append(" HTTP/2.0\r\n"u8);
+
+            if (written && !_authority.Equals(default(Range)))
+            {
+                written = Append("Host: "u8) && Append(_buffer[_authority]) && Append("\r\n"u8);
+            }
+
+            //The stored values are no longer needed
+            _tailStart = _buffer.Length;
+
+            return written;
+        }
+
+        private void WriteLine(scoped ReadOnlySpan<byte> name, scoped ReadOnlySpan<byte> value)
+        {
+            _ = Append(name) && Append(": "u8) && Append(value) && Append("\r\n"u8);
+        }
+
+        private bool Append(scoped ReadOnlySpan<byte> data)
+        {
+            if (_position + data.Length > _tailStart)
+            {
+                Error = Http2HeadError.TooLarge;
+                return false;
+            }
+
+            data.CopyTo(_buffer[_position..]);
+            _position += data.Length;
+            return true;
+        }
+
+        /*
+         * Connection specific fields are malformed in HTTP/2, the only 
+         * exception is the TE header with the trailers value (RFC 9113 8.2.2)
+         */
+        private static bool IsConnectionSpecific(ReadOnlySpan<byte> name, ReadOnlySpan<byte> value)
+        {
+            return name.SequenceEqual("connection"u8)
+                || name.SequenceEqual("keep-alive"u8)
+                || name.SequenceEqual("proxy-connection"u8)
+                || name.SequenceEqual("transfer-encoding"u8)
+                || name.SequenceEqual("upgrade"u8)
+                || (name.SequenceEqual("te"u8) && !value.SequenceEqual("trailers"u8));
+        }
+    }
+}
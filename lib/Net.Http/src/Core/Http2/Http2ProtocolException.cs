@@ -0,0 +1,42 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: Http2ProtocolException.cs 
+*
+* Http2ProtocolException.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// Raised when the peer violates the HTTP/2 protocol in a way that 
+    /// requires the connection to be closed with a GOAWAY frame
+    /// </summary>
+    /// <param name="code">The error code to send to the peer</param>
+    /// <param name="message">The reason the connection is being closed</param>
+    internal sealed class Http2ProtocolException(Http2ErrorCode code, string message) : Exception(message)
+    {
+        /// <summary>
+        /// The error code sent to the peer in the GOAWAY frame
+        /// </summary>
+        public Http2ErrorCode Code { get; } = code;
+    }
+}
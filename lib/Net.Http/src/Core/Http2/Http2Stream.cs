@@ -0,0 +1,440 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: Http2Stream.cs 
+*
+* Http2Stream.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.IO;
+using System.Net;
+using System.Buffers;
+using System.Threading;
+using System.Diagnostics;
+using System.Threading.Tasks;
+
+namespace VNLib.Net.Http.Core.Http2
+{
+    /// <summary>
+    /// A single HTTP/2 request stream. The stream is the transport of the <see cref="HttpContext"/> 
+    /// it is paired with, so requests are processed by the same request and response pipeline as 
+    /// HTTP/1.x requests. Reads return the request entity body received in DATA frames and writes 
+    /// are sent as DATA frames.
+    /// </summary>
+    /// <remarks>
+    /// Streams are paired with their context once and reused for many requests on the same 
+    /// connection, so a request stream does not allocate or initialize a context.
+    /// </remarks>
+    internal sealed class Http2Stream : Stream, ITransportContext, IThreadPoolWorkItem
+    {
+        private readonly Http2Connection _connection;
+        private readonly object _sync = new();
+
+        private byte[]? _receiveBuffer;
+        private int _receiveStart;
+        private int _receiveEnd;
+        private int _receiveWindow;
+        private int _consumed;
+        private TaskCompletionSource? _readWaiter;
+
+        private volatile bool _remoteClosed;
+        private volatile bool _reset;
+        private bool _endStreamSent;
+        private long _bodyRemaining;
+
+        /// <summary>
+        /// The context that processes requests on this stream
+        /// </summary>
+        public readonly HttpContext Context;
+
+        public Http2Stream(Http2Connection connection, HttpContext context)
+        {
+            _connection = connection;
+            Context = context;
+
+            //The context is bound to the stream for its lifetime
+            context.InitializeContext(this);
+        }
+
+        /// <summary>
+        /// The connection the stream belongs to
+        /// </summary>
+        public Http2Connection Connection => _connection;
+
+        /// <summary>
+        /// The current stream identifier
+        /// </summary>
+        public int Id { get; private set; }
+
+        /// <summary>
+        /// The length of the translated request head in the context's request header 
+        /// buffer, or -1 if the request head was too large
+        /// </summary>
+        public int HeadLength { get; set; }
+
+        /// <summary>
+        /// The number of bytes that may be sent before the client grants more window, 
+        /// guarded by the connection
+        /// </summary>
+        public int SendWindow { get; set; }
+
+        /// <summary>
+        /// True if the client has finished sending the request
+        /// </summary>
+        public bool IsRemoteClosed => _remoteClosed;
+
+        /// <summary>
+        /// True if the stream was reset by either endpoint
+        /// </summary>
+        public bool IsReset => _reset;
+
+        /// <summary>
+        /// True if the end of the response was sent
+        /// </summary>
+        public bool IsEndStreamSent => _endStreamSent;
+
+        /// <summary>
+        /// Opens the stream for a new request
+        /// </summary>
+        /// <param name="id">The stream identifier</param>
+        /// <param name="sendWindow">The initial send window of the stream</param>
+        /// <param name="remoteClosed">True if the request headers ended the stream</param>
+        public void Open(int id, int sendWindow, bool remoteClosed)
+        {
+            Id = id;
+            SendWindow = sendWindow;
+            HeadLength = 0;
+
+            _receiveStart = _receiveEnd = _consumed = 0;
+            _receiveWindow = Http2FrameHeader.DefaultWindowSize;
+            _remoteClosed = remoteClosed;
+            _reset = false;
+            _endStreamSent = false;
+            _bodyRemaining = -1;
+        }
+
+        /// <summary>
+        /// Releases the receive buffer when the stream is returned to its connection
+        /// </summary>
+        public void ReleaseBuffers()
+        {
+            lock (_sync)
+            {
+                if (_receiveBuffer != null)
+                {
+                    ArrayPool<byte>.Shared.Return(_receiveBuffer);
+                    _receiveBuffer = null;
+                }
+
+                _readWaiter = null;
+            }
+        }
+
+        /// <summary>
+        /// Buffers entity body data received from the client
+        /// </summary>
+        /// <param name="data">The DATA frame payload without padding</param>
+        /// <param name="flowControlled">The number of bytes of the frame counted against the window</param>
+        /// <param name="endStream">True if the frame ends the stream</param>
+        /// <returns>False if the client exceeded the stream's receive window</returns>
+        public bool TryReceive(ReadOnlySpan<byte> data, int flowControlled, bool endStream)
+        {
+            lock (_sync)
+            {
+                if (flowControlled > _receiveWindow)
+                {
+                    return false;
+                }
+
+                _receiveWindow -= flowControlled;
+
+                if (!data.IsEmpty && !_reset)
+                {
+                    /*
+                     * Buffered data and the receive window never exceed the 
+                     * default window size, so the data always fits once 
+                     * the buffer is compacted
+                     */
+                    _receiveBuffer ??= ArrayPool<byte>.Shared.Rent(Http2FrameHeader.DefaultWindowSize);
+
+                    if (_receiveEnd + data.Length > _receiveBuffer.Length)
+                    {
+                        Buffer.BlockCopy(_receiveBuffer, _receiveStart, _receiveBuffer, 0, _receiveEnd - _receiveStart);
+                        _receiveEnd -= _receiveStart;
+                        _receiveStart = 0;
+                    }
+
+                    data.CopyTo(_receiveBuffer.AsSpan(_receiveEnd));
+                    _receiveEnd += data.Length;
+                }
+
+                //Padding is consumed immediately
+                _consumed += flowControlled - data.Length;
+
+                if (endStream)
+                {
+                    _remoteClosed = true;
+                }
+
+                ReleaseReader();
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Marks the stream as reset and wakes any waiting reader
+        /// </summary>
+        public void Abort()
+        {
+            lock (_sync)
+            {
+                _reset = true;
+                ReleaseReader();
+            }
+        }
+
+        private void ReleaseReader()
+        {
+            _readWaiter?.TrySetResult();
+            _readWaiter = null;
+        }
+
+        /// <summary>
+        /// Sends the response header block
+        /// </summary>
+        /// <param name="block">The HPACK encoded header block</param>
+        /// <param name="bodyLength">The length of the response entity body, 0 if there is no body, or -1 if it is not known</param>
+        /// <returns>A task that completes when the headers have been sent</returns>
+        public ValueTask WriteHeadersAsync(ReadOnlyMemory<byte> block, long bodyLength)
+        {
+            _bodyRemaining = bodyLength;
+            _endStreamSent = bodyLength == 0;
+
+            return _connection.WriteHeadersAsync(this, block, _endStreamSent);
+        }
+
+        /// <summary>
+        /// Sends response entity body data
+        /// </summary>
+        /// <param name="data">The data to send</param>
+        /// <param name="endStream">True if the data is the end of the response</param>
+        /// <returns>A task that completes when the data has been sent</returns>
+        public ValueTask WriteDataAsync(ReadOnlyMemory<byte> data, bool endStream)
+        {
+            //Data beyond the end of the response cannot be sent
+            if (_endStreamSent || (data.IsEmpty && !endStream))
+            {
+                return ValueTask.CompletedTask;
+            }
+
+            _endStreamSent = endStream;
+
+            return _connection.WriteDataAsync(this, data, endStream);
+        }
+
+        ///<inheritdoc/>
+        public override ValueTask WriteAsync(ReadOnlyMemory<byte> buffer, CancellationToken cancellationToken = default)
+        {
+            bool endStream = false;
+
+            //The last byte of a response with a known length ends the stream
+            if (_bodyRemaining > 0)
+            {
+                _bodyRemaining -= buffer.Length;
+                endStream = _bodyRemaining <= 0;
+            }
+
+            return WriteDataAsync(buffer, endStream);
+        }
+
+        ///<inheritdoc/>
+        public override void Write(ReadOnlySpan<byte> buffer)
+        {
+            byte[] copy = ArrayPool<byte>.Shared.Rent(buffer.Length);
+
+            try
+            {
+                buffer.CopyTo(copy);
+                WriteAsync(copy.AsMemory(0, buffer.Length)).AsTask().GetAwaiter().GetResult();
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(copy);
+            }
+        }
+
+        ///<inheritdoc/>
+        public override void Write(byte[] buffer, int offset, int count) => Write(buffer.AsSpan(offset, count));
+
+        ///<inheritdoc/>
+        public override Task WriteAsync(byte[] buffer, int offset, int count, CancellationToken cancellationToken) 
+            => WriteAsync(buffer.AsMemory(offset, count), cancellationToken).AsTask();
+
+        ///<inheritdoc/>
+        public override async ValueTask<int> ReadAsync(Memory<byte> buffer, CancellationToken cancellationToken = default)
+        {
+            while (true)
+            {
+                Task wait;
+                int read, increment = 0;
+
+                lock (_sync)
+                {
+                    read = Math.Min(buffer.Length, _receiveEnd - _receiveStart);
+
+                    if (read > 0)
+                    {
+                        _receiveBuffer.AsSpan(_receiveStart, read).CopyTo(buffer.Span);
+                        _receiveStart += read;
+                        _consumed += read;
+
+                        //Grant more window once half of it was consumed
+                        if (_consumed >= Http2FrameHeader.DefaultWindowSize / 2 && !_remoteClosed)
+                        {
+                            increment = _consumed;
+                            _receiveWindow += increment;
+                            _consumed = 0;
+                        }
+                    }
+                    else if (_reset)
+                    {
+                        throw new IOException("The HTTP/2 stream was reset");
+                    }
+                    else if (_remoteClosed || buffer.IsEmpty)
+                    {
+                        /*
+                         * The entity body is only read while data remains, so 
+                         * the end of the stream means the body was truncated
+                         */
+                        return buffer.IsEmpty ? 0 : throw new EndOfStreamException("The client ended the HTTP/2 stream before the entity body was received");
+                    }
+
+                    if (read == 0)
+                    {
+                        _readWaiter ??= new TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously);
+                    }
+
+                    wait = _readWaiter?.Task ?? Task.CompletedTask;
+                }
+
+                if (read > 0)
+                {
+                    if (increment > 0)
+                    {
+                        await _connection.WriteWindowUpdateAsync(Id, increment).ConfigureAwait(false);
+                    }
+
+                    return read;
+                }
+
+                await wait.WaitAsync(cancellationToken).ConfigureAwait(false);
+            }
+        }
+
+        ///<inheritdoc/>
+        public override int Read(Span<byte> buffer)
+        {
+            byte[] copy = ArrayPool<byte>.Shared.Rent(buffer.Length);
+
+            try
+            {
+                int read = ReadAsync(copy.AsMemory(0, buffer.Length)).AsTask().GetAwaiter().GetResult();
+                copy.AsSpan(0, read).CopyTo(buffer);
+                return read;
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(copy);
+            }
+        }
+
+        ///<inheritdoc/>
+        public override int Read(byte[] buffer, int offset, int count) => Read(buffer.AsSpan(offset, count));
+
+        ///<inheritdoc/>
+        public override Task<int> ReadAsync(byte[] buffer, int offset, int count, CancellationToken cancellationToken)
+            => ReadAsync(buffer.AsMemory(offset, count), cancellationToken).AsTask();
+
+        /// <summary>
+        /// Frames are sent as they are written, NOOP
+        /// </summary>
+        public override void Flush()
+        { }
+
+        /// <summary>
+        /// Frames are sent as they are written, NOOP
+        /// </summary>
+        public override Task FlushAsync(CancellationToken cancellationToken) => Task.CompletedTask;
+
+        ///<inheritdoc/>
+        public override bool CanRead => true;
+
+        ///<inheritdoc/>
+        public override bool CanSeek => false;
+
+        ///<inheritdoc/>
+        public override bool CanWrite => true;
+
+        ///<inheritdoc/>
+        public override long Length => throw new NotSupportedException();
+
+        ///<inheritdoc/>
+        public override long Position
+        {
+            get => throw new NotSupportedException();
+            set => throw new NotSupportedException();
+        }
+
+        ///<inheritdoc/>
+        public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+
+        ///<inheritdoc/>
+        public override void SetLength(long value) => throw new NotSupportedException();
+
+        #region Transport context
+
+        ///<inheritdoc/>
+        Stream ITransportContext.ConnectionStream => this;
+
+        ///<inheritdoc/>
+        public IPEndPoint LocalEndPoint => _connection.Transport.LocalEndPoint;
+
+        ///<inheritdoc/>
+        public IPEndPoint RemoteEndpoint => _connection.Transport.RemoteEndpoint;
+
+        ///<inheritdoc/>
+        public ref readonly TransportSecurityInfo? GetSecurityInfo() => ref _connection.Transport.GetSecurityInfo();
+
+        /// <summary>
+        /// The connection is owned by the HTTP/2 connection, NOOP
+        /// </summary>
+        ValueTask ITransportContext.CloseConnectionAsync() => ValueTask.CompletedTask;
+
+        #endregion
+
+        ///<inheritdoc/>
+        void IThreadPoolWorkItem.Execute()
+        {
+            Debug.Assert(HeadLength != 0, "A stream was dispatched before its request head was translated");
+            _ = _connection.Server.ProcessHttp2StreamAsync(this);
+        }
+    }
+}
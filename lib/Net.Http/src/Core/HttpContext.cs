@@ -82,6 +82,13 @@ namespace VNLib.Net.Http.Core
 
         private readonly ManagedHttpCompressor? _compressor;
         private ITransportContext? _ctx;
+
+        /*
+         * The transport reader lives as long as the connection, so request data 
+         * a client pipelined behind the current request stays buffered for the 
+         * next request instead of being discarded
+         */
+        private TransportReader _reader;
         
         public HttpContext(HttpServer server, CompressionMethod supportedMethods)
         {
@@ -108,7 +115,7 @@ namespace VNLib.Net.Http.Core
             Buffers = new(server.Config.BufferConfig, _compressor != null);
 
             //Create new request
-            Request = new (this, server.Config.MaxUploadsPerRequest);
+            Request = new (this, Buffers, server.Config.MaxUploadsPerRequest);
             
             //create a new response object
             Response = new (this, Buffers);
@@ -123,6 +130,18 @@ namespace VNLib.Net.Http.Core
         /// <returns>A readonly referrence to the <see cref="TransportSecurityInfo"/> structure </returns>
         public ref readonly TransportSecurityInfo? GetSecurityInfo() => ref _ctx!.GetSecurityInfo();
 
+        /// <summary>
+        /// Gets a reference to the connection's request header reader
+        /// </summary>
+        /// <returns>A reference to the <see cref="TransportReader"/> for the current connection</returns>
+        internal ref TransportReader GetReader() => ref _reader;
+
+        /// <summary>
+        /// Determines if the start of another request is already buffered after the 
+        /// current request, which happens when a client pipelines requests
+        /// </summary>
+        internal bool HasPipelinedRequest => _reader.BufferedDataWindow.IndexOfAnyExcept((byte)'\r', (byte)'\n') >= 0;
+
         #region Context information
 
         ///<inheritdoc/>
@@ -152,6 +171,9 @@ namespace VNLib.Net.Http.Core
             //Alloc buffers during context init incase exception occurs in user-code
             Buffers.AllocateBuffer(ParentServer.Config.MemoryPool);
 
+            //Start with an empty reader for every connection
+            _reader = new(ctx.ConnectionStream, Buffers.RequestHeaderParseBuffer, ParentServer.Config.HttpEncoding, ParentServer.HeaderLineTermination);
+
             //Init new connection
             Response.OnNewConnection(ctx.ConnectionStream);
         } 
@@ -192,10 +214,12 @@ namespace VNLib.Net.Http.Core
         bool IReusable.Release()
         {
             _ctx = null;
+            _reader = default;
 
             AlternateProtocol = null;
 
             //Release response/requqests
+            Request.OnRelease();
             Response.OnRelease();
            
             //Free buffers
@@ -66,6 +66,12 @@ namespace VNLib.Net.Http
             }
 
             ArgumentNullException.ThrowIfNull(protocolHandler);
+
+            //The connection is shared by all of the streams of an HTTP/2 connection
+            if (Context.Request.State.HttpVersion == HttpVersion.Http2)
+            {
+                throw new NotSupportedException("Protocol switching is not supported for HTTP/2 requests");
+            }
             
             //Set 101 status code
             Context.Respond(HttpStatusCode.SwitchingProtocols);
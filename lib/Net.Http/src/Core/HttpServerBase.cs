@@ -36,16 +36,18 @@
  */
 
 using System;
+using System.Linq;
 using System.Threading;
 using System.Net.Sockets;
 using System.Threading.Tasks;
-using System.Collections.Frozen;
 using System.Collections.Generic;
 
+using VNLib.Utils;
 using VNLib.Utils.Logging;
 using VNLib.Utils.Memory.Caching;
 
 using VNLib.Net.Http.Core;
+using VNLib.Net.Http.Core.PerfCounter;
 
 namespace VNLib.Net.Http
 {
@@ -69,16 +71,33 @@ namespace VNLib.Net.Http
         /// </summary>
         public const HttpVersion SupportedVersions = HttpVersion.Http09 | HttpVersion.Http1 | HttpVersion.Http11;
 
+        /// <summary>
+        /// The name of the <see cref="System.Diagnostics.Metrics.Meter"/> server metrics are published on
+        /// </summary>
+        public const string MeterName = "VNLib.Net.Http";
+
+        /// <summary>
+        /// The name of the <see cref="System.Diagnostics.ActivitySource"/> sampled request 
+        /// traces are started on. The W3C traceparent header of a request is used as the 
+        /// parent of its trace.
+        /// </summary>
+        public const string ActivitySourceName = "VNLib.Net.Http";
+
         /// <summary>
         /// Static discard buffer for destroying data. This buffer must never be read from
         /// </summary>
         internal static readonly Memory<byte> WriteOnlyScratchBuffer = new byte[64 * 1024];
 
         private readonly ITransportProvider Transport;
-        private readonly FrozenDictionary<string, IWebRoot> ServerRoots;
+        private readonly SpanKeyedTable<IWebRoot> ServerRoots;
         private readonly IWebRoot? _wildcardRoot;
         private readonly HttpConfig _config;
 
+        /// <summary>
+        /// Always-on request counters and phase latency histograms
+        /// </summary>
+        internal readonly HttpServerMetrics Metrics;
+
         #region caches
         /// <summary>
         /// The cached HTTP1/1 keepalive timeout header value
@@ -93,7 +112,7 @@ namespace VNLib.Net.Http
         /// <summary>
         /// The cached header-line termination value
         /// </summary>
-        private readonly ReadOnlyMemory<byte> HeaderLineTermination;
+        internal readonly ReadOnlyMemory<byte> HeaderLineTermination;
         #endregion
 
         /// <summary>
@@ -137,8 +156,11 @@ namespace VNLib.Net.Http
             ValidateConfig(in config);
 
             _config = config;
-            //Configure roots and their directories
-            ServerRoots = sites.ToFrozenDictionary(static r => r.Hostname, static tv => tv, StringComparer.OrdinalIgnoreCase);
+            //Configure roots and their directories, roots are found by the request host without allocating a string
+            ServerRoots = new(
+                sites.Select(static r => new KeyValuePair<string, IWebRoot>(r.Hostname, r)), 
+                StringComparison.OrdinalIgnoreCase
+            );
             //Compile and store the timeout keepalive header
             KeepAliveTimeoutHeaderValue = $"timeout={(int)_config.ConnectionKeepAlive.TotalSeconds}";           
             //Setup config copy with the internal http pool
@@ -148,6 +170,8 @@ namespace VNLib.Net.Http
                 CompressionMethod.None : 
                 config.CompressorManager.GetSupportedMethods();
 
+            Metrics = new(MeterName, () => Volatile.Read(ref OpenConnectionCount));
+
             //Create a new context store
             ContextStore = ObjectRental.CreateReusable(() => new HttpContext(this, SupportedCompressionMethods));
 
@@ -168,6 +192,12 @@ namespace VNLib.Net.Http
             ArgumentNullException.ThrowIfNull(conf.ServerLog, nameof(conf.ServerLog));
             ArgumentNullException.ThrowIfNull(conf.MemoryPool, nameof(conf.MemoryPool));
 
+            //Request heads are parsed as raw bytes, so the encoding must encode ascii as single bytes
+            if (!conf.HttpEncoding.GetBytes("GET / HTTP/1.1\r\n").AsSpan().SequenceEqual("GET / HTTP/1.1\r\n"u8))
+            {
+                throw new ArgumentException("HttpEncoding must be an ascii compatible encoding", nameof(conf));
+            }
+
             if (conf.ActiveConnectionRecvTimeout < -1)
             {
                 throw new ArgumentException("ActiveConnectionRecvTimeout cannot be less than -1", nameof(conf));
@@ -249,6 +279,11 @@ namespace VNLib.Net.Http
             {
                 throw new ArgumentException("SendTimeout cannot be less than 1 millisecond", nameof(conf));
             }
+
+            if (conf.EnableHttp2 && conf.Http2MaxConcurrentStreams < 1)
+            {
+                throw new ArgumentException("Http2MaxConcurrentStreams cannot be less than 1 when HTTP/2 is enabled", nameof(conf));
+            }
         }
 
         /// <summary>
@@ -318,6 +353,9 @@ namespace VNLib.Net.Http
         /// <exception cref="ObjectDisposedException"></exception>
         public void CacheHardClear() => ContextStore.CacheHardClear();
 
+        ///<inheritdoc/>
+        public HttpMetricsSnapshot GetMetrics() => Metrics.GetSnapshot();
+
         /// <summary>
         /// Writes the specialized log for a socket exception
         /// </summary>
@@ -0,0 +1,190 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpServerHttp2Processing.cs 
+*
+* HttpServerHttp2Processing.cs is part of VNLib.Net.Http which is part 
+* of the larger VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.IO;
+using System.Net;
+using System.Net.Sockets;
+using System.Diagnostics;
+using System.Threading.Tasks;
+using System.Runtime.CompilerServices;
+
+using VNLib.Utils.Logging;
+using VNLib.Net.Http.Core;
+using VNLib.Net.Http.Core.Http2;
+using VNLib.Net.Http.Core.Response;
+using VNLib.Net.Http.Core.PerfCounter;
+
+namespace VNLib.Net.Http
+{
+    public sealed partial class HttpServer
+    {
+        /// <summary>
+        /// Rents a context to pair with an HTTP/2 stream
+        /// </summary>
+        internal HttpContext RentContext() => ContextStore.Rent();
+
+        /// <summary>
+        /// Returns a context that was paired with an HTTP/2 stream
+        /// </summary>
+        internal void ReturnContext(HttpContext context) => ContextStore.Return(context);
+
+        /// <summary>
+        /// Processes the request of a single HTTP/2 stream. The stream's context was already 
+        /// initialized with the stream as its transport, and the request head was translated 
+        /// into the context's request header buffer.
+        /// </summary>
+        /// <param name="stream">The stream to process</param>
+        /// <returns>A task that completes when the response has been sent</returns>
+        [MethodImpl(MethodImplOptions.AggressiveOptimization)]
+        internal async Task ProcessHttp2StreamAsync(Http2Stream stream)
+        {
+            HttpContext context = stream.Context;
+            Activity? activity = null;
+
+            context.BeginRequest();
+
+            try
+            {
+                HttpStatusCode status = ParseHttp2Request(context, stream.HeadLength);
+
+                if (status != 0)
+                {
+                    //There is no transport state to protect, so the error is only returned to the client
+                    context.Respond(context.Request.State.Expect ? HttpStatusCode.ExpectationFailed : (int)status >= 1000 ? HttpStatusCode.BadRequest : status);
+                }
+                //Check open connection count (not super accurate, or might not be atomic)
+                else if (OpenConnectionCount > _config.MaxOpenConnections)
+                {
+                    context.Respond(HttpStatusCode.ServiceUnavailable);
+                }
+                else
+                {
+                    activity = HttpTracing.StartRequest(context);
+
+                    /*
+                     * A request for connection termination only ends the stream, 
+                     * the connection is shared with other requests
+                     */
+                    _ = await ProcessRequestAsync(context);
+                }
+
+                using (HttpTracing.StartChild(activity, "write response"))
+                {
+                    await context.WriteResponseAsync();
+                }
+
+                await stream.Connection.EndStreamAsync(stream);
+
+                Metrics.CountResponse(context.Response.StatusCode);
+            }
+            catch (Exception ex)
+            {
+                switch (ex)
+                {
+                    //The stream was reset or the connection was lost
+                    case IOException ioe when ioe.InnerException is SocketException se:
+                        WriteSocketExecption(se);
+                        break;
+                    case IOException:
+                    case OperationCanceledException:
+                        _config.ServerLog.Debug("HTTP/2 stream {id} closed before the response was sent, {m}", stream.Id, ex.Message);
+                        break;
+                    default:
+                        _config.ServerLog.Error(ex);
+                        break;
+                }
+
+                try
+                {
+                    await stream.Connection.ResetAsync(stream.Id, Http2ErrorCode.InternalError);
+                }
+                catch(Exception rex)
+                {
+                    _config.ServerLog.Debug("Failed to reset HTTP/2 stream {id}, {m}", stream.Id, rex.Message);
+                }
+            }
+            finally
+            {
+                if (activity != null)
+                {
+                    HttpTracing.StopRequest(activity, context);
+                }
+
+                context.EndRequest();
+                stream.Connection.ReturnStream(stream);
+            }
+        }
+
+        /// <summary>
+        /// Parses the request head an HTTP/2 request was translated to
+        /// </summary>
+        /// <param name="ctx">The stream's context</param>
+        /// <param name="headLength">The length of the request head in the request header buffer, -1 if it did not fit</param>
+        /// <returns>0 if the request was successfully parsed, the <see cref="HttpStatusCode"/> 
+        /// to return to the client because the entity could not be processed</returns>
+        private HttpStatusCode ParseHttp2Request(HttpContext ctx, int headLength)
+        {
+            if (headLength < 0)
+            {
+                return HttpStatusCode.RequestHeaderFieldsTooLarge;
+            }
+
+            ref readonly TransportSecurityInfo? secInfo = ref ctx.GetSecurityInfo();
+
+            HttpStatusCode code;
+
+            try
+            {
+                Http11ParseExtensions.Http1ParseState parseState = new()
+                {
+                    Head = new(ctx.Buffers.RequestHeaderParseBuffer.GetBinSpan(0, headLength))
+                };
+
+                //Entity body data is never buffered with the head, it is read from the stream
+                TransportReader reader = default;
+
+                if ((code = ctx.Request.Http1ParseRequestLine(ref parseState, in _config, secInfo.HasValue)) > 0)
+                {
+                    return code;
+                }
+
+                if ((code = ctx.Request.Http1ParseHeaders(ref parseState, in _config)) > 0)
+                {
+                    return code;
+                }
+
+                return ctx.Request.Http1PrepareEntityBody(ref parseState, ref reader, in _config);
+            }
+            catch (OutOfMemoryException)
+            {
+                return HttpStatusCode.RequestHeaderFieldsTooLarge;
+            }
+            catch (UriFormatException)
+            {
+                return HttpStatusCode.BadRequest;
+            }
+        }
+    }
+}
@@ -36,6 +36,7 @@ using VNLib.Utils.Memory;
 using VNLib.Utils.Logging;
 using VNLib.Utils.Extensions;
 using VNLib.Net.Http.Core;
+using VNLib.Net.Http.Core.Http2;
 using VNLib.Net.Http.Core.Buffering;
 using VNLib.Net.Http.Core.Response;
 using VNLib.Net.Http.Core.PerfCounter;
@@ -52,6 +53,7 @@ namespace VNLib.Net.Http
         {
             //Increment open connection count
             Interlocked.Increment(ref OpenConnectionCount);
+            Metrics.CountConnection();
             
             //Rent a new context object to reuse
             HttpContext? context = ContextStore.Rent();
@@ -65,56 +67,86 @@ namespace VNLib.Net.Http
 
                 //Init stream
                 context.InitializeContext(transportContext);
-                
-                //Keep the transport open and listen for messages as long as keepalive is enabled
-                do
+
+                //Set rx timeout low for initial reading
+                stream.ReadTimeout = _config.ActiveConnectionRecvTimeout;
+
+                //Clients with prior knowledge of HTTP/2 support open the connection with the HTTP/2 preface
+                if (_config.EnableHttp2 && Http2Connection.TryReadPreface(ref context.GetReader()))
                 {
-                    //Set rx timeout low for initial reading
-                    stream.ReadTimeout = _config.ActiveConnectionRecvTimeout;
-                    
-                    //Process the request
-                    bool keepAlive = await ProcessHttpEventAsync(context);
+                    //Streams rent their own contexts, so only the data buffered after the preface is kept
+                    Http2Connection connection = new(this, transportContext, context.GetReader().BufferedDataWindow);
 
-                    //If not keepalive, exit the listening loop and clean up connection
-                    if (!keepAlive)
-                    {
-                        break;
-                    }
+                    ContextStore.Return(context);
+                    context = null;
 
-                    //Reset inactive keeaplive timeout, when expired the following read will throw a cancealltion exception
+                    //Frames are read continuously, so the connection is only closed when idle for the keepalive timeout
                     stream.ReadTimeout = (int)_config.ConnectionKeepAlive.TotalMilliseconds;
+
+                    await connection.RunAsync(StopToken!.Token);
+                }
+                else
+                {
+                    bool connectionReused = false;
+
+                    //Keep the transport open and listen for messages as long as keepalive is enabled
+                    do
+                    {
+                        //Set rx timeout low for initial reading
+                        stream.ReadTimeout = _config.ActiveConnectionRecvTimeout;
+                    
+                        //Process the request
+                        bool keepAlive = await ProcessHttpEventAsync(context, connectionReused);
+
+                        connectionReused = true;
+
+                        //If not keepalive, exit the listening loop and clean up connection
+                        if (!keepAlive)
+                        {
+                            break;
+                        }
+
+                        //A pipelined request is already buffered, so process it immediately without waiting on the transport
+                        if (context.HasPipelinedRequest)
+                        {
+                            continue;
+                        }
+
+                        //Reset inactive keeaplive timeout, when expired the following read will throw a cancealltion exception
+                        stream.ReadTimeout = (int)_config.ConnectionKeepAlive.TotalMilliseconds;
                     
-                    //"Peek" or wait for more data to begin another request (may throw timeout exception when timmed out)
-                    await stream.ReadAsync(Memory<byte>.Empty, StopToken!.Token);
+                        //"Peek" or wait for more data to begin another request (may throw timeout exception when timmed out)
+                        await stream.ReadAsync(Memory<byte>.Empty, StopToken!.Token);
                     
-                } while (true);
+                    } while (true);
 
-                //Check if an alternate protocol was specified
-                if (context.AlternateProtocol != null)
-                {
-                    //Save the current ap
-                    IAlternateProtocol ap = context.AlternateProtocol;
+                    //Check if an alternate protocol was specified
+                    if (context.AlternateProtocol != null)
+                    {
+                        //Save the current ap
+                        IAlternateProtocol ap = context.AlternateProtocol;
 
-                    //Release the context before listening to free it back to the pool
-                    ContextStore.Return(context);
-                    context = null;
+                        //Release the context before listening to free it back to the pool
+                        ContextStore.Return(context);
+                        context = null;
 
-                    //Remove transport timeouts
-                    stream.ReadTimeout = Timeout.Infinite;
-                    stream.WriteTimeout = Timeout.Infinite;
+                        //Remove transport timeouts
+                        stream.ReadTimeout = Timeout.Infinite;
+                        stream.WriteTimeout = Timeout.Infinite;
 
-                    /*
-                     * Create a transport wrapper so callers cannot take control of the transport
-                     * hooks such as disposing. Timeouts are allowed to be changed, not exactly 
-                     * our problem.
-                     */
+                        /*
+                         * Create a transport wrapper so callers cannot take control of the transport
+                         * hooks such as disposing. Timeouts are allowed to be changed, not exactly 
+                         * our problem.
+                         */
 
 #pragma warning disable CA2000 // Dispose objects before losing scope
-                    AlternateProtocolTransportStreamWrapper apWrapper = new(transport:stream);
+                        AlternateProtocolTransportStreamWrapper apWrapper = new(transport:stream);
 #pragma warning restore CA2000 // Dispose objects before losing scope
 
-                    //Listen on the alternate protocol
-                    await ap.RunAsync(apWrapper, StopToken!.Token).ConfigureAwait(false);
+                        //Listen on the alternate protocol
+                        await ap.RunAsync(apWrapper, StopToken!.Token).ConfigureAwait(false);
+                    }
                 }
             }
             //Catch wrapped socket exceptions
@@ -166,10 +198,12 @@ namespace VNLib.Net.Http
         /// Main event handler for all incoming connections
         /// </summary>
         /// <param name="context">Reusable context object</param>
+        /// <param name="connectionReused">A value that indicates if the connection was kept alive from a previous request</param>
         [MethodImpl(MethodImplOptions.AggressiveOptimization)]
-        private async Task<bool> ProcessHttpEventAsync(HttpContext context)
+        private async Task<bool> ProcessHttpEventAsync(HttpContext context, bool connectionReused)
         {
             HttpPerfCounterState counter = default;
+            Activity? activity = null;
 
             //Prepare http context to process a new message
             context.BeginRequest();
@@ -178,6 +212,8 @@ namespace VNLib.Net.Http
             {
                 HttpPerfCounter.StartCounter(ref counter);
 
+                long phaseStart = HttpServerMetrics.GetTimestamp();
+
                 //Try to parse the http request (may throw exceptions, let them propagate to the transport layer)
                 int status = (int)ParseRequest(context);
 
@@ -189,14 +225,29 @@ namespace VNLib.Net.Http
                     return false;
                 }
 
+                //Only record requests that were received, the client may have closed the connection
+                Metrics.Record(HttpServerPhase.Parse, phaseStart);
+
+                if (connectionReused)
+                {
+                    Metrics.CountKeepAliveRequest();
+                }
+
                 bool keepalive = true;
 
                 //Handle an error parsing the request
                 if(!PreProcessRequest(context, (HttpStatusCode)status, ref keepalive))
                 {
+                    //Send the error status before the connection is closed
+                    await context.WriteResponseAsync();
+                    await context.FlushTransportAsync();
+
+                    Metrics.CountResponse(context.Response.StatusCode);
                     return false;
                 }
 
+                activity = HttpTracing.StartRequest(context);
+
                 //process the request
                 bool processSuccess = await ProcessRequestAsync(context);
 
@@ -229,21 +280,44 @@ namespace VNLib.Net.Http
 
                 HttpPerfCounter.StartCounter(ref counter);
                
-                await context.WriteResponseAsync();
-
-                await context.FlushTransportAsync();
-
-                HttpPerfCounter.StopAndLog(ref counter, in _config, "HTTP Response");
+                using (HttpTracing.StartChild(activity, "write response"))
+                {
+                    await context.WriteResponseAsync();
+                }
 
                 /*
                  * If an alternate protocol was specified, we need to break the keepalive loop
                  * the handler will manage the alternate protocol
                  */
+                keepalive &= processSuccess & context.AlternateProtocol == null;
 
-                return processSuccess & keepalive & context.AlternateProtocol == null;
+                /*
+                 * When the client pipelined another request behind this one, the transport 
+                 * flush is deferred so the responses are coalesced and flushed once the 
+                 * last buffered request has been answered
+                 */
+                if (!keepalive || !context.HasPipelinedRequest)
+                {
+                    phaseStart = HttpServerMetrics.GetTimestamp();
+
+                    await context.FlushTransportAsync();
+
+                    Metrics.Record(HttpServerPhase.TransportFlush, phaseStart);
+                }
+
+                Metrics.CountResponse(context.Response.StatusCode);
+
+                HttpPerfCounter.StopAndLog(ref counter, in _config, "HTTP Response");
+
+                return keepalive;
             }
             finally
             {
+                if (activity != null)
+                {
+                    HttpTracing.StopRequest(activity, context);
+                }
+
                 //Clean end request
                 context.EndRequest();
             }
@@ -276,27 +350,31 @@ namespace VNLib.Net.Http
                 //TODO: future support for http2 and http3 over tls
             }
 
-            //Get the parse buffer
-            IHttpHeaderParseBuffer parseBuffer = ctx.Buffers.RequestHeaderParseBuffer;
-            
-            TransportReader reader = new (ctx.GetTransport(), parseBuffer, _config.HttpEncoding, HeaderLineTermination);
+            /*
+             * The reader is kept for the connection, it may already hold 
+             * the start of a pipelined request
+             */
+            ref TransportReader reader = ref ctx.GetReader();
 
             HttpStatusCode code;
 
             try
             {
-                //Get the char span
-                Span<char> lineBuf = parseBuffer.GetCharSpan();
-                
                 Http11ParseExtensions.Http1ParseState parseState = new();
+
+                //Buffer the entire request head before parsing
+                if ((code = ctx.Request.Http1ReadHead(ref parseState, ref reader)) > 0)
+                {
+                    return code;
+                }
                 
-                if ((code = ctx.Request.Http1ParseRequestLine(ref parseState, ref reader, lineBuf, secInfo.HasValue)) > 0)
+                if ((code = ctx.Request.Http1ParseRequestLine(ref parseState, in _config, secInfo.HasValue)) > 0)
                 {
                     return code;
                 }
 
                 //Parse the headers
-                if ((code = ctx.Request.Http1ParseHeaders(ref parseState, ref reader, in _config, lineBuf)) > 0)
+                if ((code = ctx.Request.Http1ParseHeaders(ref parseState, in _config)) > 0)
                 {
                     return code;
                 }
@@ -387,7 +465,7 @@ namespace VNLib.Net.Http
         private async Task<bool> ProcessRequestAsync(HttpContext context)
         {
             //Get the server root for the specified location or fallback to a wildcard host if one is selected
-            IWebRoot? root = ServerRoots!.GetValueOrDefault(context.Request.State.Location.DnsSafeHost, _wildcardRoot);
+            IWebRoot? root = ServerRoots!.GetValueOrDefault(context.Request.Host, _wildcardRoot);
             
             if (root == null)
             {
@@ -424,6 +502,8 @@ namespace VNLib.Net.Http
              */
             HttpEvent ev = new(context);
 
+            long appStart = HttpServerMetrics.GetTimestamp();
+
             try
             {
                 //Enter user-code
@@ -462,6 +542,8 @@ namespace VNLib.Net.Http
             finally
             {
                 ev.Clear();
+
+                Metrics.Record(HttpServerPhase.Application, appStart);
             }
 
             /*
@@ -0,0 +1,165 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpLatencyHistogram.cs 
+*
+* HttpLatencyHistogram.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+/*
+ * A log-linear (HDR style) latency histogram. Durations are recorded as raw
+ * stopwatch ticks, each power of two is divided into 8 linear sub-buckets,
+ * so a bucket is never wider than 12.5% of the values it holds.
+ * 
+ * Buckets are striped per processor so concurrent requests on different 
+ * cores do not contend on the same cache lines, recording is a bucket index
+ * calculation and two uncontended interlocked adds. Stripes are only merged
+ * when a snapshot is captured.
+ */
+
+using System;
+using System.Numerics;
+using System.Threading;
+using System.Diagnostics;
+
+namespace VNLib.Net.Http.Core.PerfCounter
+{
+    internal sealed class HttpLatencyHistogram
+    {
+        private const int SubBucketBits = 3;
+        private const int SubBucketCount = 1 << SubBucketBits;
+
+        /*
+         * Values are clamped to 2^48 ticks, which is days even with 
+         * a nanosecond resolution stopwatch
+         */
+        private const int MaxMagnitude = 47;
+
+        /// <summary>
+        /// The number of buckets in the histogram
+        /// </summary>
+        public const int BucketCount = (MaxMagnitude - SubBucketBits + 2) * SubBucketCount;
+
+        private const int SumSlot = BucketCount;
+
+        //Leaves at least a cache line between the slots of adjacent stripes
+        private const int StripeLength = BucketCount + 16;
+
+        private readonly long[] _slots;
+        private readonly int _stripeMask;
+
+        public HttpLatencyHistogram(int stripes)
+        {
+            Debug.Assert(BitOperations.IsPow2(stripes), "Stripe count must be a power of two");
+
+            _slots = new long[stripes * StripeLength];
+            _stripeMask = stripes - 1;
+        }
+
+        /// <summary>
+        /// Records a duration in stopwatch ticks
+        /// </summary>
+        /// <param name="ticks">The elapsed stopwatch ticks</param>
+        public void Record(long ticks)
+        {
+            int stripe = (Thread.GetCurrentProcessorId() & _stripeMask) * StripeLength;
+
+            Interlocked.Increment(ref _slots[stripe + GetBucket(ticks)]);
+            Interlocked.Add(ref _slots[stripe + SumSlot], ticks);
+        }
+
+        /// <summary>
+        /// Merges the stripes into a point-in-time snapshot of the histogram
+        /// </summary>
+        /// <returns>The histogram snapshot</returns>
+        public HttpLatencySnapshot GetSnapshot()
+        {
+            long[] buckets = new long[BucketCount];
+            long count = 0, sum = 0;
+
+            for (int stripe = 0; stripe < _slots.Length; stripe += StripeLength)
+            {
+                for (int i = 0; i < BucketCount; i++)
+                {
+                    long value = Volatile.Read(ref _slots[stripe + i]);
+                    buckets[i] += value;
+                    count += value;
+                }
+
+                sum += Volatile.Read(ref _slots[stripe + SumSlot]);
+            }
+
+            return new HttpLatencySnapshot(buckets, count, sum);
+        }
+
+        /// <summary>
+        /// Gets the index of the bucket a duration is recorded in
+        /// </summary>
+        /// <param name="ticks">The duration in stopwatch ticks</param>
+        /// <returns>The index of the bucket that holds the value</returns>
+        public static int GetBucket(long ticks)
+        {
+            //Small values are stored exactly
+            if (ticks < SubBucketCount)
+            {
+                return ticks < 0 ? 0 : (int)ticks;
+            }
+
+            //Clamped values land in the last bucket
+            if (ticks >= 1L << (MaxMagnitude + 1))
+            {
+                return BucketCount - 1;
+            }
+
+            int magnitude = BitOperations.Log2((ulong)ticks);
+
+            //The sub bucket is the bits directly below the most significant bit
+            int subBucket = (int)(ticks >> (magnitude - SubBucketBits)) & (SubBucketCount - 1);
+
+            return ((magnitude - SubBucketBits + 1) * SubBucketCount) + subBucket;
+        }
+
+        /// <summary>
+        /// Gets the largest value that is stored in the given bucket
+        /// </summary>
+        /// <param name="bucket">The index of the bucket</param>
+        /// <returns>The largest value of the bucket in stopwatch ticks</returns>
+        public static long GetBucketUpperBound(int bucket)
+        {
+            if (bucket < SubBucketCount)
+            {
+                return bucket;
+            }
+
+            int magnitude = (bucket / SubBucketCount) + SubBucketBits - 1;
+            int subBucket = bucket % SubBucketCount;
+            int shift = magnitude - SubBucketBits;
+
+            return ((long)(SubBucketCount + subBucket + 1) << shift) - 1;
+        }
+
+        /// <summary>
+        /// Converts stopwatch ticks to a <see cref="TimeSpan"/>
+        /// </summary>
+        /// <param name="ticks">The stopwatch ticks to convert</param>
+        /// <returns>The duration of the ticks</returns>
+        public static TimeSpan ToTimeSpan(long ticks) 
+            => TimeSpan.FromTicks((long)(ticks * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency)));
+    }
+}
@@ -0,0 +1,207 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpServerMetrics.cs 
+*
+* HttpServerMetrics.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+/*
+ * Always-on server metrics. Counters are striped per processor the same way 
+ * the phase histograms are, so recording never contends across cores and 
+ * costs a few uncontended interlocked adds per request. Nothing is aggregated
+ * on the request path, the stripes are merged when a snapshot is pulled or 
+ * when a MeterListener observes the instruments.
+ */
+
+using System;
+using System.Net;
+using System.Numerics;
+using System.Threading;
+using System.Diagnostics;
+using System.Collections.Generic;
+using System.Diagnostics.Metrics;
+
+namespace VNLib.Net.Http.Core.PerfCounter
+{
+    internal sealed class HttpServerMetrics
+    {
+        private const int MaxStripes = 16;
+
+        private const int ConnectionsSlot = 0;
+        private const int KeepAliveSlot = 1;
+        private const int EntityBytesSlot = 2;
+        private const int StatusClassSlot = 3;
+        private const int StatusClassCount = 5;
+
+        //Two cache lines per stripe
+        private const int StripeLength = 16;
+
+        private static readonly string[] StatusClassNames = ["1xx", "2xx", "3xx", "4xx", "5xx"];
+        private static readonly HttpServerPhase[] Phases = Enum.GetValues<HttpServerPhase>();
+
+        private readonly long[] _counters;
+        private readonly int _stripeMask;
+        private readonly HttpLatencyHistogram[] _phases;
+        private readonly Func<long> _activeConnections;
+        private readonly Meter _meter;
+
+        public HttpServerMetrics(string meterName, Func<long> activeConnections)
+        {
+            int stripes = (int)Math.Min(BitOperations.RoundUpToPowerOf2((uint)Environment.ProcessorCount), MaxStripes);
+
+            _counters = new long[stripes * StripeLength];
+            _stripeMask = stripes - 1;
+            _activeConnections = activeConnections;
+
+            _phases = new HttpLatencyHistogram[Phases.Length];
+            for (int i = 0; i < _phases.Length; i++)
+            {
+                _phases[i] = new(stripes);
+            }
+
+            _meter = new(meterName);
+
+            _meter.CreateObservableCounter("vnlib.http.server.connections", () => Sum(ConnectionsSlot), "{connection}", "Connections accepted by the server");
+            _meter.CreateObservableUpDownCounter("vnlib.http.server.active_connections", _activeConnections, "{connection}", "Connections currently open");
+            _meter.CreateObservableCounter("vnlib.http.server.keepalive_requests", () => Sum(KeepAliveSlot), "{request}", "Requests received on a kept-alive connection");
+            _meter.CreateObservableCounter("vnlib.http.server.response_entity_bytes", () => Sum(EntityBytesSlot), "By", "Response entity bytes written before compression");
+            _meter.CreateObservableCounter("vnlib.http.server.responses", ObserveStatusClasses, "{response}", "Responses sent by status class");
+            _meter.CreateObservableGauge("vnlib.http.server.phase_duration", ObservePhases, "us", "Request phase latency percentiles");
+        }
+
+        /// <summary>
+        /// Gets the current timestamp to time a phase from
+        /// </summary>
+        /// <returns>The current stopwatch timestamp</returns>
+        public static long GetTimestamp() => Stopwatch.GetTimestamp();
+
+        /// <summary>
+        /// Records the time elapsed since the start timestamp for a phase
+        /// </summary>
+        /// <param name="phase">The phase to record the duration of</param>
+        /// <param name="startTimestamp">The timestamp captured when the phase began</param>
+        public void Record(HttpServerPhase phase, long startTimestamp) 
+            => _phases[(int)phase].Record(Stopwatch.GetTimestamp() - startTimestamp);
+
+        /// <summary>
+        /// Counts a connection accepted by the server
+        /// </summary>
+        public void CountConnection() => Add(ConnectionsSlot, 1);
+
+        /// <summary>
+        /// Counts a request received on a connection kept alive from a previous request
+        /// </summary>
+        public void CountKeepAliveRequest() => Add(KeepAliveSlot, 1);
+
+        /// <summary>
+        /// Counts the bytes of a response entity
+        /// </summary>
+        /// <param name="bytes">The length of the response entity</param>
+        public void CountEntityBytes(long bytes) => Add(EntityBytesSlot, bytes);
+
+        /// <summary>
+        /// Counts a response sent to the client by its status class
+        /// </summary>
+        /// <param name="code">The status code of the response</param>
+        public void CountResponse(HttpStatusCode code)
+        {
+            int statusClass = Math.Clamp((int)code / 100, 1, StatusClassCount);
+            Add(StatusClassSlot + statusClass - 1, 1);
+        }
+
+        private void Add(int slot, long value)
+        {
+            int stripe = (Thread.GetCurrentProcessorId() & _stripeMask) * StripeLength;
+            Interlocked.Add(ref _counters[stripe + slot], value);
+        }
+
+        private long Sum(int slot)
+        {
+            long sum = 0;
+
+            for (int stripe = 0; stripe < _counters.Length; stripe += StripeLength)
+            {
+                sum += Volatile.Read(ref _counters[stripe + slot]);
+            }
+
+            return sum;
+        }
+
+        /// <summary>
+        /// Merges all counters and histograms into a point-in-time snapshot
+        /// </summary>
+        /// <returns>The metrics snapshot</returns>
+        public HttpMetricsSnapshot GetSnapshot()
+        {
+            long[] statusClasses = new long[StatusClassCount];
+            long requests = 0;
+
+            for (int i = 0; i < statusClasses.Length; i++)
+            {
+                statusClasses[i] = Sum(StatusClassSlot + i);
+                requests += statusClasses[i];
+            }
+
+            HttpLatencySnapshot[] phases = new HttpLatencySnapshot[_phases.Length];
+
+            for (int i = 0; i < phases.Length; i++)
+            {
+                phases[i] = _phases[i].GetSnapshot();
+            }
+
+            return new HttpMetricsSnapshot(statusClasses, phases)
+            {
+                Connections = Sum(ConnectionsSlot),
+                ActiveConnections = _activeConnections(),
+                Requests = requests,
+                KeepAliveRequests = Sum(KeepAliveSlot),
+                ResponseEntityBytes = Sum(EntityBytesSlot)
+            };
+        }
+
+        private IEnumerable<Measurement<long>> ObserveStatusClasses()
+        {
+            for (int i = 0; i < StatusClassCount; i++)
+            {
+                yield return new(Sum(StatusClassSlot + i), new KeyValuePair<string, object?>("http.response.status_class", StatusClassNames[i]));
+            }
+        }
+
+        private IEnumerable<Measurement<double>> ObservePhases()
+        {
+            foreach (HttpServerPhase phase in Phases)
+            {
+                HttpLatencySnapshot snapshot = _phases[(int)phase].GetSnapshot();
+
+                if (snapshot.Count == 0)
+                {
+                    continue;
+                }
+
+                KeyValuePair<string, object?> phaseTag = new("phase", phase.ToString());
+
+                yield return new(snapshot.GetPercentile(50).TotalMicroseconds, phaseTag, new("quantile", "0.5"));
+                yield return new(snapshot.GetPercentile(90).TotalMicroseconds, phaseTag, new("quantile", "0.9"));
+                yield return new(snapshot.GetPercentile(99).TotalMicroseconds, phaseTag, new("quantile", "0.99"));
+                yield return new(snapshot.Max.TotalMicroseconds, phaseTag, new("quantile", "1"));
+            }
+        }
+    }
+}
@@ -0,0 +1,169 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpTracing.cs 
+*
+* HttpTracing.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+/*
+ * Request tracing is opt-in by registering an ActivityListener for the 
+ * server's ActivitySource. When nothing listens, the only cost per request
+ * is the HasListeners check. When a listener is registered, the W3C 
+ * traceparent header is parsed from the raw request head without decoding 
+ * it, and the listener's sampler decides before the activity is allocated. 
+ * Tags are only set on activities that were sampled.
+ * 
+ * The request activity is the ambient Activity.Current while application 
+ * code runs, so outgoing calls made by the application propagate the trace.
+ */
+
+using System;
+using System.Buffers;
+using System.Diagnostics;
+using System.Globalization;
+
+namespace VNLib.Net.Http.Core.PerfCounter
+{
+    internal static class HttpTracing
+    {
+        private const string TraceParentHeader = "traceparent";
+        private const string TraceStateHeader = "tracestate";
+
+        //version-traceid-parentid-flags
+        private const int TraceParentLength = 55;
+
+        private static readonly SearchValues<byte> LowerHex = SearchValues.Create("0123456789abcdef"u8);
+
+        public static readonly ActivitySource Source = new(HttpServer.ActivitySourceName);
+
+        /// <summary>
+        /// Starts the server activity for a request if a listener samples it
+        /// </summary>
+        /// <param name="context">The context of the request to trace</param>
+        /// <returns>The started activity, or null if the request is not traced</returns>
+        public static Activity? StartRequest(HttpContext context)
+        {
+            if (!Source.HasListeners())
+            {
+                return null;
+            }
+
+            bool hasParent = TryParseTraceParent(context.Request.Headers.GetRawValue(TraceParentHeader), out ActivityContext parent);
+
+            Activity? activity = Source.StartActivity("HTTP request", ActivityKind.Server, parent);
+
+            if (activity is { IsAllDataRequested: true })
+            {
+                if (hasParent)
+                {
+                    activity.TraceStateString = context.Request.Headers[TraceStateHeader];
+                }
+
+                activity.DisplayName = context.Request.State.Method.ToString();
+                activity.SetTag("http.request.method", activity.DisplayName);
+                activity.SetTag("url.path", context.Request.Path.ToString());
+                activity.SetTag("server.address", context.Request.Host.ToString());
+            }
+
+            return activity;
+        }
+
+        /// <summary>
+        /// Records the response status and stops the request activity
+        /// </summary>
+        /// <param name="activity">The request activity to stop</param>
+        /// <param name="context">The context of the request</param>
+        public static void StopRequest(Activity activity, HttpContext context)
+        {
+            int status = (int)context.Response.StatusCode;
+
+            if (activity.IsAllDataRequested)
+            {
+                activity.SetTag("http.response.status_code", status);
+            }
+
+            if (status >= 500)
+            {
+                activity.SetStatus(ActivityStatusCode.Error);
+            }
+
+            activity.Dispose();
+        }
+
+        /// <summary>
+        /// Starts a child activity of a traced request
+        /// </summary>
+        /// <param name="request">The request activity, null if the request is not traced</param>
+        /// <param name="name">The name of the child activity</param>
+        /// <returns>The started activity, or null if the request is not traced</returns>
+        public static Activity? StartChild(Activity? request, string name) 
+            => request != null ? Source.StartActivity(name) : null;
+
+        /// <summary>
+        /// Parses a W3C traceparent header value into a remote parent context
+        /// </summary>
+        /// <param name="value">The raw header value</param>
+        /// <param name="context">The parsed parent context</param>
+        /// <returns>True if the value was a valid traceparent, false otherwise</returns>
+        public static bool TryParseTraceParent(ReadOnlySpan<byte> value, out ActivityContext context)
+        {
+            context = default;
+
+            if (value.Length < TraceParentLength || value[2] != '-' || value[35] != '-' || value[52] != '-')
+            {
+                return false;
+            }
+
+            ReadOnlySpan<byte> version = value[..2];
+            ReadOnlySpan<byte> traceId = value.Slice(3, 32);
+            ReadOnlySpan<byte> spanId = value.Slice(36, 16);
+            ReadOnlySpan<byte> flags = value.Slice(53, 2);
+
+            //Version ff is invalid, and future versions may only append fields
+            if (version.SequenceEqual("ff"u8) || (value.Length > TraceParentLength && (version.SequenceEqual("00"u8) || value[TraceParentLength] != '-')))
+            {
+                return false;
+            }
+
+            if (version.ContainsAnyExcept(LowerHex) || traceId.ContainsAnyExcept(LowerHex) 
+                || spanId.ContainsAnyExcept(LowerHex) || flags.ContainsAnyExcept(LowerHex))
+            {
+                return false;
+            }
+
+            //All zero ids are invalid
+            if (!traceId.ContainsAnyExcept((byte)'0') || !spanId.ContainsAnyExcept((byte)'0'))
+            {
+                return false;
+            }
+
+            byte traceFlags = byte.Parse(flags, NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture);
+
+            context = new(
+                ActivityTraceId.CreateFromUtf8String(traceId),
+                ActivitySpanId.CreateFromUtf8String(spanId),
+                (traceFlags & 1) != 0 ? ActivityTraceFlags.Recorded : ActivityTraceFlags.None,
+                isRemote: true
+            );
+
+            return true;
+        }
+    }
+}
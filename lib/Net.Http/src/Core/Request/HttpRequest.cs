@@ -23,21 +23,25 @@
 */
 
 using System;
+using System.Text;
+using System.Diagnostics;
 using System.Collections.Generic;
 using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
 
 using VNLib.Utils;
 using VNLib.Utils.Memory;
 using VNLib.Utils.Extensions;
+using VNLib.Net.Http.Core.Buffering;
 
 namespace VNLib.Net.Http.Core
 {
-    internal sealed class HttpRequest(IHttpContextInformation contextInfo, ushort maxUploads) : IHttpLifeCycle
+    internal sealed class HttpRequest(IHttpContextInformation contextInfo, IHttpBufferManager manager, ushort maxUploads) : IHttpLifeCycle
 #if DEBUG
         ,IStringSerializeable
 #endif
     {
-        public readonly VnWebHeaderCollection Headers = new();
+        public readonly RequestHeaderTable Headers = new(manager.RequestHeaderParseBuffer, contextInfo);
         public readonly List<string> Accept = new(8);
         public readonly List<string> AcceptLanguage = new(8);
         public readonly Dictionary<string, string> Cookies = new(5, StringComparer.OrdinalIgnoreCase);
@@ -64,6 +68,13 @@ namespace VNLib.Net.Http.Core
         private HttpRequestState _state;
         private readonly FileUpload[] _uploads = new FileUpload[maxUploads];
 
+        /*
+         * The request head is parsed in place and remains in the header buffer 
+         * until the request completes, so the request target and some header 
+         * values are stored as offsets into it and only materialized on demand.
+         */
+        private readonly IHttpHeaderParseBuffer _headBuffer = manager.RequestHeaderParseBuffer;
+
         /// <summary>
         /// Gets a mutable structure ref only used to initalize the request 
         /// state.
@@ -76,11 +87,131 @@ namespace VNLib.Net.Http.Core
         /// </summary>
         internal ref readonly HttpRequestState State => ref _state;
 
+        /// <summary>
+        /// The requested resource location. If the client sent a canonical request 
+        /// target, the uri is only built the first time it is used.
+        /// </summary>
+        public Uri Location => _state.Location ??= BuildLocation();
+
+        /// <summary>
+        /// The unescaped request path, equal to the <see cref="Uri.LocalPath"/> 
+        /// of the <see cref="Location"/>
+        /// </summary>
+        public ReadOnlySpan<char> Path => _state.Target.IsCanonical
+            ? _headBuffer.GetCharSpan()[.._state.Target.PathLength]
+            : _state.Location!.LocalPath;
+
+        /// <summary>
+        /// The request query string including the leading '?', empty if the 
+        /// request did not include a query. Equal to the <see cref="Uri.Query"/>
+        /// of the <see cref="Location"/>
+        /// </summary>
+        public ReadOnlySpan<char> Query => _state.Target.IsCanonical
+            ? _headBuffer.GetCharSpan().Slice(_state.Target.PathLength, _state.Target.QueryLength)
+            : _state.Location!.Query;
+
+        /// <summary>
+        /// The lowercase requested host name, equal to the <see cref="Uri.DnsSafeHost"/>
+        /// of the <see cref="Location"/>
+        /// </summary>
+        public ReadOnlySpan<char> Host => _state.Target.IsCanonical
+            ? _headBuffer.GetCharSpan().Slice(_state.Target.PathLength + _state.Target.QueryLength, _state.Target.HostLength)
+            : _state.Location!.DnsSafeHost;
+
+        /// <summary>
+        /// The value of the origin header if one was sent and is a valid absolute uri
+        /// </summary>
+        public Uri? Origin => _state.Origin ??= ParseHeaderUri(ref _state.OriginValue);
+
+        /// <summary>
+        /// The value of the referer header if one was sent and is a valid absolute uri
+        /// </summary>
+        public Uri? Referrer => _state.Referrer ??= ParseHeaderUri(ref _state.RefererValue);
+
+        /// <summary>
+        /// Stores a canonical request target by widening the raw ascii components into the
+        /// header buffer's char segment
+        /// </summary>
+        /// <param name="path">The raw request path</param>
+        /// <param name="query">The raw request query including the leading '?'</param>
+        /// <param name="host">The raw host name</param>
+        /// <param name="port">The port from the host header or -1 if not specified</param>
+        /// <param name="secure">True if the connection is using tls</param>
+        internal void SetCanonicalTarget(ReadOnlySpan<byte> path, ReadOnlySpan<byte> query, ReadOnlySpan<byte> host, int port, bool secure)
+        {
+            Span<char> chars = _headBuffer.GetCharSpan();
+
+            Ascii.ToUtf16(path, chars, out int pathLength);
+            Ascii.ToUtf16(query, chars[pathLength..], out int queryLength);
+
+            //Uri lowercases dns host names
+            Ascii.ToLower(host, chars[(pathLength + queryLength)..], out int hostLength);
+
+            Debug.Assert(pathLength == path.Length && queryLength == query.Length && hostLength == host.Length, "Target did not fit in the header char buffer");
+
+            _state.Target = new()
+            {
+                IsCanonical = true,
+                Secure = secure,
+                PathLength = pathLength,
+                QueryLength = queryLength,
+                HostLength = hostLength,
+                Port = port
+            };
+        }
+
+        /// <summary>
+        /// Gets the location of a slice of the request head within the header buffer
+        /// </summary>
+        /// <param name="value">A slice of the buffered request head</param>
+        /// <returns>The range of the value within the header buffer</returns>
+        internal Range GetHeadRange(ReadOnlySpan<byte> value)
+        {
+            int offset = (int)Unsafe.ByteOffset(ref _headBuffer.DangerousGetBinRef(0), ref MemoryMarshal.GetReference(value));
+
+            Debug.Assert(offset >= 0 && offset + value.Length <= _headBuffer.BinSize, "Value is not within the request header buffer");
+
+            return new(offset, offset + value.Length);
+        }
+
+        private Uri BuildLocation()
+        {
+            Debug.Assert(_state.Target.IsCanonical, "Location must be set while parsing for non-canonical targets");
+
+            ReadOnlySpan<char> chars = _headBuffer.GetCharSpan();
+
+            //Components are already validated, so uri creation will not fail
+            UriBuilder builder = new(
+                _state.Target.Secure ? Uri.UriSchemeHttps : Uri.UriSchemeHttp,
+                Host.ToString(),
+                _state.Target.Port,
+                chars[.._state.Target.PathLength].ToString(),
+                Query.ToString()
+            );
+
+            return builder.Uri;
+        }
+
+        private Uri? ParseHeaderUri(ref Range value)
+        {
+            if (value.Equals(default))
+            {
+                return null;
+            }
+
+            ReadOnlySpan<byte> raw = _headBuffer.GetBinSpan(0)[value];
+
+            //Only attempt to parse the value once
+            value = default;
+
+            //Header uris should always be absolute address "parsable"
+            return Uri.TryCreate(contextInfo.Encoding.GetString(raw), UriKind.Absolute, out Uri? uri) ? uri : null;
+        }
+
         void IHttpLifeCycle.OnPrepare()
         { }
 
-        void IHttpLifeCycle.OnRelease()
-        { }
+        public void OnRelease() => Headers.TrimExcess();
         
         void IHttpLifeCycle.OnNewRequest()
         { }
@@ -186,10 +317,13 @@ namespace VNLib.Net.Http.Core
 
         public void Compile(ref ForwardOnlyWriter<char> writer)
         {
+            //The location may not have been set if parsing failed
+            Uri? location = _state.Target.IsCanonical ? Location : _state.Location;
+
             //Request line
             writer.Append(_state.Method.ToString());
             writer.Append(" ");
-            writer.Append(_state.Location?.PathAndQuery);
+            writer.Append(location?.PathAndQuery);
             writer.Append(" HTTP/");
             switch (_state.HttpVersion)
             {
@@ -214,15 +348,15 @@ namespace VNLib.Net.Http.Core
 
             //write host
             writer.Append("Host: ");
-            writer.Append(_state.Location?.Authority);
+            writer.Append(location?.Authority);
             writer.Append("\r\n");
 
             //Write headers
-            foreach (string header in Headers.Keys)
+            foreach (KeyValuePair<string, string> header in Headers)
             {
-                writer.Append(header);
+                writer.Append(header.Key);
                 writer.Append(": ");
-                writer.Append(Headers[header]);
+                writer.Append(header.Value);
                 writer.Append("\r\n");
             }
 
@@ -258,13 +392,6 @@ namespace VNLib.Net.Http.Core
                 }
                 writer.Append("\r\n");
             }
-            //Write user agent
-            if (_state.UserAgent != null)
-            {
-                writer.Append("User-Agent: ");
-                writer.Append(_state.UserAgent);
-                writer.Append("\r\n");
-            }
             //Write content type
             if (_state.ContentType != ContentType.NonSupported)
             {
@@ -287,16 +414,16 @@ namespace VNLib.Net.Http.Core
             {
                 writer.Append("Expect: 100-continue\r\n");
             }
-            if(_state.Origin != null)
+            if(Origin != null)
             {
                 writer.Append("Origin: ");
-                writer.Append(_state.Origin.ToString());
+                writer.Append(Origin.ToString());
                 writer.Append("\r\n");
             }
-            if (_state.Referrer != null)
+            if (Referrer != null)
             {
                 writer.Append("Referrer: ");
-                writer.Append(_state.Referrer.ToString());
+                writer.Append(Referrer.ToString());
                 writer.Append("\r\n");
             }
             writer.Append("from ");
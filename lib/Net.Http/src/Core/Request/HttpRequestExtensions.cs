@@ -49,30 +49,30 @@ namespace VNLib.Net.Http.Core
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public static CompressionMethod GetCompressionSupport(this HttpRequest request, CompressionMethod serverSupported)
         {
-            string? acceptEncoding = request.Headers[HttpRequestHeader.AcceptEncoding];
-
             /*
              * Priority order is gzip, deflate, br. Br is last for dynamic compression 
              * because of performace. We also need to make sure the server supports 
              * the desired compression method also.
+             * 
+             * The header value is searched in place without decoding it
              */
 
-            if (acceptEncoding == null)
+            if (!request.Headers.IsSet(HttpRequestHeader.AcceptEncoding))
             {
                 return CompressionMethod.None;
             }
             else if (serverSupported.HasFlag(CompressionMethod.Gzip) 
-                && acceptEncoding.Contains("gzip", StringComparison.OrdinalIgnoreCase))
+                && request.Headers.ValueContains(HttpRequestHeader.AcceptEncoding, "gzip"))
             {
                 return CompressionMethod.Gzip;
             }
             else if (serverSupported.HasFlag(CompressionMethod.Deflate) 
-                && acceptEncoding.Contains("deflate", StringComparison.OrdinalIgnoreCase))
+                && request.Headers.ValueContains(HttpRequestHeader.AcceptEncoding, "deflate"))
             {
                 return CompressionMethod.Deflate;
             }
             else if (serverSupported.HasFlag(CompressionMethod.Brotli) 
-                && acceptEncoding.Contains("br", StringComparison.OrdinalIgnoreCase))
+                && request.Headers.ValueContains(HttpRequestHeader.AcceptEncoding, "br"))
             {
                 return CompressionMethod.Brotli;
             }
@@ -91,14 +91,32 @@ namespace VNLib.Net.Http.Core
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public static bool IsCrossOrigin(this HttpRequest Request)
         {
-            if(Request.State.Origin is null)
+            Uri? origin = Request.Origin;
+
+            if(origin is null)
             {
                 return false;
             }
 
+            ref readonly HttpRequestTarget target = ref Request.State.Target;
+
+            /*
+             * Canonical targets store a dns host, so the origin can be compared 
+             * directly without building the location uri
+             */
+            if (target.IsCanonical)
+            {
+                string scheme = target.Secure ? Uri.UriSchemeHttps : Uri.UriSchemeHttp;
+                int port = target.Port < 0 ? (target.Secure ? 443 : 80) : target.Port;
+
+                return !string.Equals(origin.Scheme, scheme, StringComparison.OrdinalIgnoreCase)
+                    || !Request.Host.Equals(origin.Host, StringComparison.OrdinalIgnoreCase)
+                    || origin.Port != port;
+            }
+
             //Get the origin string components for comparison (allocs new strings :( )
-            string locOrigin = Request.State.Location.GetComponents(UriComponents.SchemeAndServer, UriFormat.SafeUnescaped);
-            string reqOrigin = Request.State.Origin.GetComponents(UriComponents.SchemeAndServer, UriFormat.SafeUnescaped);
+            string locOrigin = Request.Location.GetComponents(UriComponents.SchemeAndServer, UriFormat.SafeUnescaped);
+            string reqOrigin = origin.GetComponents(UriComponents.SchemeAndServer, UriFormat.SafeUnescaped);
 
             //If origin components are not equal, this is a cross origin request
             return !string.Equals(locOrigin, reqOrigin, StringComparison.OrdinalIgnoreCase);
@@ -110,18 +128,9 @@ namespace VNLib.Net.Http.Core
         /// <returns>true if the connection is a websocket upgrade request, false otherwise</returns>
         public static bool IsWebSocketRequest(this HttpRequest Request)
         {
-            string? upgrade = Request.Headers[HttpRequestHeader.Upgrade];
-
-            if (!string.IsNullOrWhiteSpace(upgrade) && upgrade.Contains("websocket", StringComparison.OrdinalIgnoreCase))
-            {
-                //This request is a websocket request
-                //Check connection header
-                string? connection = Request.Headers[HttpRequestHeader.Connection];
-
-                //Must be a web socket request
-                return !string.IsNullOrWhiteSpace(connection) && connection.Contains("upgrade", StringComparison.OrdinalIgnoreCase);
-            }
-            return false;
+            //This request is a websocket request if the upgrade header requests it, and the connection header must request an upgrade
+            return Request.Headers.ValueContains(HttpRequestHeader.Upgrade, "websocket")
+                && Request.Headers.ValueContains(HttpRequestHeader.Connection, "upgrade");
         }
 
         /// <summary>
@@ -408,7 +417,7 @@ namespace VNLib.Net.Http.Core
             }
 
             //if the request has query args, parse and store them
-            ReadOnlySpan<char> queryString = Request.State.Location.Query;
+            ReadOnlySpan<char> queryString = Request.Query;
 
             if (!queryString.IsEmpty)
             {
@@ -75,11 +75,6 @@ namespace VNLib.Net.Http.Core
         /// </summary>
         public int UploadCount;
 
-        /// <summary>
-        /// request's user-agent string
-        /// </summary>
-        public string? UserAgent;
-        
         /// <summary>
         /// Boundry header value if reuqest send data using MIME mulit-part form data
         /// </summary>
@@ -91,20 +86,36 @@ namespace VNLib.Net.Http.Core
         public string? Charset;
 
         /// <summary>
-        /// The requested resource location url
+        /// The requested resource target
+        /// </summary>
+        public HttpRequestTarget Target;
+
+        /// <summary>
+        /// The requested resource location url, built lazily when the 
+        /// target is canonical
         /// </summary>
-        public Uri Location;
+        public Uri? Location;
 
         /// <summary>
-        /// The value of the origin header if one was sent
+        /// The value of the origin header if one was sent, parsed lazily
         /// </summary>
         public Uri? Origin;
 
         /// <summary>
-        /// The url value of the referer header if one was sent
+        /// The url value of the referer header if one was sent, parsed lazily
         /// </summary>
         public Uri? Referrer;
 
+        /// <summary>
+        /// The location of the raw origin header value in the request header buffer
+        /// </summary>
+        public Range OriginValue;
+
+        /// <summary>
+        /// The location of the raw referer header value in the request header buffer
+        /// </summary>
+        public Range RefererValue;
+
         /// <summary>
         /// The connection's remote endpoint (ip/port) captured from transport
         /// </summary>
@@ -0,0 +1,203 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpRequest.cs 
+*
+* HttpRequest.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Buffers;
+
+namespace VNLib.Net.Http.Core
+{
+    /// <summary>
+    /// A compact representation of the request target. When the client sent a target
+    /// in canonical form, the path, query and host are widened into the request header 
+    /// buffer's char segment and only their lengths are stored, so no strings or 
+    /// <see cref="Uri"/> are allocated until they are requested.
+    /// </summary>
+    /// <remarks>
+    /// The target chars are stored in order: path, query (including the leading '?') then 
+    /// the lowercase host.
+    /// </remarks>
+    internal struct HttpRequestTarget
+    {
+        /// <summary>
+        /// True if the target was stored in the char buffer, false if the 
+        /// location uri was built while parsing and must be used instead
+        /// </summary>
+        public bool IsCanonical;
+
+        /// <summary>
+        /// True if the connection was using transport security
+        /// </summary>
+        public bool Secure;
+
+        /// <summary>
+        /// The number of path chars
+        /// </summary>
+        public int PathLength;
+
+        /// <summary>
+        /// The number of query chars including the leading '?'
+        /// </summary>
+        public int QueryLength;
+
+        /// <summary>
+        /// The number of host chars
+        /// </summary>
+        public int HostLength;
+
+        /// <summary>
+        /// The port number from the host header, -1 if one was not specified
+        /// </summary>
+        public int Port;
+
+        /*
+         * Canonical targets are those where Uri would return exactly the 
+         * same path, query and host strings the client sent, so the Uri 
+         * may be built lazily and the raw values can be used for routing.
+         * 
+         * Anything that Uri would modify, percent encoded paths, dot 
+         * segments, backslashes, non-ascii chars and so on, are not 
+         * canonical and the Uri is built while parsing as before.
+         */
+
+        private static readonly SearchValues<byte> PathChars = SearchValues.Create(
+            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._~!$&'()*+,;=:@/"u8
+        );
+
+        //Query allows the path chars and '?', percent encodings are checked separately
+        private static readonly SearchValues<byte> QueryChars = SearchValues.Create(
+            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._~!$&'()*+,;=:@/?%"u8
+        );
+
+        private static readonly SearchValues<byte> HostChars = SearchValues.Create(
+            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._"u8
+        );
+
+        private static readonly SearchValues<byte> UnreservedChars = SearchValues.Create(
+            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._~"u8
+        );
+
+        /// <summary>
+        /// Determines if the raw request path is in canonical form
+        /// </summary>
+        /// <param name="path">The raw request path, must begin with '/'</param>
+        /// <returns>True if the path may be used without normalization</returns>
+        public static bool IsCanonicalPath(ReadOnlySpan<byte> path)
+        {
+            if (path.IndexOfAnyExcept(PathChars) >= 0)
+            {
+                return false;
+            }
+
+            //Search for "." and ".." segments
+            for (int i = path.IndexOf("/."u8); i >= 0; )
+            {
+                ReadOnlySpan<byte> segment = path[(i + 1)..];
+                int end = segment.IndexOf((byte)'/');
+
+                segment = end < 0 ? segment : segment[..end];
+
+                if (segment.SequenceEqual("."u8) || segment.SequenceEqual(".."u8))
+                {
+                    return false;
+                }
+
+                int next = path[(i + 2)..].IndexOf("/."u8);
+                i = next < 0 ? -1 : i + 2 + next;
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Determines if the raw query string is in canonical form
+        /// </summary>
+        /// <param name="query">The raw query string including the leading '?'</param>
+        /// <returns>True if the query may be used without normalization</returns>
+        public static bool IsCanonicalQuery(ReadOnlySpan<byte> query)
+        {
+            if (query.IndexOfAnyExcept(QueryChars) >= 0)
+            {
+                return false;
+            }
+
+            //Uri decodes percent encoded unreserved chars and escapes invalid encodings
+            for (int i = query.IndexOf((byte)'%'); i >= 0; )
+            {
+                if (i + 2 >= query.Length 
+                    || !IsHexDigit(query[i + 1]) 
+                    || !IsHexDigit(query[i + 2])
+                    || UnreservedChars.Contains((byte)((HexValue(query[i + 1]) << 4) | HexValue(query[i + 2]))))
+                {
+                    return false;
+                }
+
+                int next = query[(i + 3)..].IndexOf((byte)'%');
+                i = next < 0 ? -1 : i + 3 + next;
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Determines if the raw host name is a dns name in canonical form
+        /// </summary>
+        /// <param name="host">The raw host name without a port</param>
+        /// <returns>True if the host is a valid dns name that may be used without normalization</returns>
+        public static bool IsCanonicalHost(ReadOnlySpan<byte> host)
+        {
+            if (host.IsEmpty || host.Length > 255 || host.IndexOfAnyExcept(HostChars) >= 0)
+            {
+                return false;
+            }
+
+            //Every label must be a valid length and must not begin or end with a hyphen
+            ReadOnlySpan<byte> label = default;
+
+            for (ReadOnlySpan<byte> remaining = host; ; )
+            {
+                int dot = remaining.IndexOf((byte)'.');
+                label = dot < 0 ? remaining : remaining[..dot];
+
+                if (label.IsEmpty || label.Length > 63 || label[0] == '-' || label[^1] == '-')
+                {
+                    return false;
+                }
+
+                if (dot < 0)
+                {
+                    break;
+                }
+
+                remaining = remaining[(dot + 1)..];
+            }
+
+            //The last label must start with a letter, so addresses such as 127.1 that Uri normalizes are excluded
+            return char.IsAsciiLetter((char)label[0]);
+        }
+
+        private static bool IsHexDigit(byte value) => char.IsAsciiHexDigit((char)value);
+
+        private static int HexValue(byte value) => value <= '9' ? value - '0' : (value | 0x20) - 'a' + 10;
+    }
+}
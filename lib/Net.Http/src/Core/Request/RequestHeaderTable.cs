@@ -0,0 +1,273 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: RequestHeaderTable.cs 
+*
+* RequestHeaderTable.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Net;
+using System.Text;
+using System.Numerics;
+using System.Collections;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
+using VNLib.Net.Http.Core.Buffering;
+
+namespace VNLib.Net.Http.Core
+{
+    /// <summary>
+    /// Stores request headers as locations of their values within the buffered request 
+    /// head. Well known headers are stored in a fixed slot by their <see cref="HttpRequestHeader"/>
+    /// value, all other headers are stored by name in an overflow list. Values are only 
+    /// decoded to strings when they are read.
+    /// </summary>
+    internal sealed class RequestHeaderTable(IHttpHeaderParseBuffer buffer, IHttpContextInformation contextInfo) 
+        : IEnumerable<KeyValuePair<string, string>>
+    {
+        private const int KnownHeaderCount = (int)HttpRequestHeader.UserAgent + 1;
+        private const int DefaultCustomCapacity = 8;
+
+        private readonly HeaderSlot[] _known = new HeaderSlot[KnownHeaderCount];
+        private readonly List<CustomHeader> _custom = new(DefaultCustomCapacity);
+
+        //Bit per known header slot that is currently set
+        private ulong _setMask;
+
+        /// <summary>
+        /// The number of unique headers stored
+        /// </summary>
+        public int Count => BitOperations.PopCount(_setMask) + _custom.Count;
+
+        /// <summary>
+        /// Gets the value of a well known request header, or null if the header was not sent
+        /// </summary>
+        /// <param name="header">The request header to get</param>
+        /// <returns>The header value if set, null otherwise</returns>
+        public string? this[HttpRequestHeader header] => IsSet(header) ? GetValue(ref _known[(int)header]) : null;
+
+        /// <summary>
+        /// Gets the value of a request header by its name, or null if the header was not sent
+        /// </summary>
+        /// <param name="name">The name of the header to get</param>
+        /// <returns>The header value if set, null otherwise</returns>
+        public string? this[string name]
+        {
+            get
+            {
+                if (HttpHelpers.TryGetRequestHeader(name, out HttpRequestHeader known))
+                {
+                    return this[known];
+                }
+
+                int index = IndexOf(name);
+                return index < 0 ? null : GetValue(ref CollectionsMarshal.AsSpan(_custom)[index]);
+            }
+        }
+
+        /// <summary>
+        /// Gets the raw value of a header that is not well known without decoding 
+        /// it to a string
+        /// </summary>
+        /// <param name="name">The name of the header to get</param>
+        /// <returns>The raw header value, empty if the header was not sent</returns>
+        public ReadOnlySpan<byte> GetRawValue(string name)
+        {
+            int index = IndexOf(name);
+            return index < 0 ? default : GetRaw(_custom[index].Value);
+        }
+
+        /// <summary>
+        /// Determines if a well known header was sent with the request
+        /// </summary>
+        /// <param name="header">The request header to check</param>
+        /// <returns>True if the header was sent, false otherwise</returns>
+        public bool IsSet(HttpRequestHeader header) => (uint)header < KnownHeaderCount && (_setMask & (1UL << (int)header)) != 0;
+
+        /// <summary>
+        /// Determines if a well known header value contains the ascii token, ignoring case, 
+        /// without decoding the value
+        /// </summary>
+        /// <param name="header">The request header to search</param>
+        /// <param name="token">The ascii token to find</param>
+        /// <returns>True if the header was sent and its value contains the token</returns>
+        public bool ValueContains(HttpRequestHeader header, string token)
+        {
+            if (!IsSet(header))
+            {
+                return false;
+            }
+
+            ref HeaderSlot slot = ref _known[(int)header];
+
+            //Repeated headers are combined into a string when they are stored
+            if (slot.String != null)
+            {
+                return slot.String.Contains(token, StringComparison.OrdinalIgnoreCase);
+            }
+
+            ReadOnlySpan<byte> value = GetRaw(slot.Value);
+
+            for (int i = 0; i <= value.Length - token.Length; i++)
+            {
+                if (Ascii.EqualsIgnoreCase(value.Slice(i, token.Length), token))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /// <summary>
+        /// Stores the value of a well known header. Repeated headers are combined 
+        /// into a comma separated list.
+        /// </summary>
+        /// <param name="header">The well known request header</param>
+        /// <param name="value">The location of the header value within the request head</param>
+        public void Add(HttpRequestHeader header, Range value)
+        {
+            ref HeaderSlot slot = ref _known[(int)header];
+
+            if (IsSet(header))
+            {
+                slot.String = $"{GetValue(ref slot)},{Decode(value)}";
+                return;
+            }
+
+            slot = new() { Value = value };
+            _setMask |= 1UL << (int)header;
+        }
+
+        /// <summary>
+        /// Stores the value of a custom header by its name. Repeated headers are combined 
+        /// into a comma separated list.
+        /// </summary>
+        /// <param name="name">The location of the header name within the request head</param>
+        /// <param name="value">The location of the header value within the request head</param>
+        public void Add(Range name, Range value)
+        {
+            ReadOnlySpan<byte> rawName = GetRaw(name);
+            Span<CustomHeader> custom = CollectionsMarshal.AsSpan(_custom);
+
+            for (int i = 0; i < custom.Length; i++)
+            {
+                if (Ascii.EqualsIgnoreCase(GetRaw(custom[i].Name), rawName))
+                {
+                    custom[i].String = $"{GetValue(ref custom[i])},{Decode(value)}";
+                    return;
+                }
+            }
+
+            _custom.Add(new() { Name = name, Value = value });
+        }
+
+        /// <summary>
+        /// Removes all stored headers
+        /// </summary>
+        public void Clear()
+        {
+            //Only slots that were set may hold strings
+            for (ulong mask = _setMask; mask != 0; mask &= mask - 1)
+            {
+                _known[BitOperations.TrailingZeroCount(mask)] = default;
+            }
+
+            _setMask = 0;
+            _custom.Clear();
+        }
+
+        /// <summary>
+        /// Releases the memory held by the overflow list if it grew past its default size
+        /// </summary>
+        public void TrimExcess()
+        {
+            if (_custom.Capacity > DefaultCustomCapacity)
+            {
+                _custom.Capacity = DefaultCustomCapacity;
+            }
+        }
+
+        ///<inheritdoc/>
+        public IEnumerator<KeyValuePair<string, string>> GetEnumerator()
+        {
+            for (ulong mask = _setMask; mask != 0; mask &= mask - 1)
+            {
+                int index = BitOperations.TrailingZeroCount(mask);
+
+                yield return new(
+                    HttpHelpers.GetRequestHeaderString((HttpRequestHeader)index), 
+                    GetValue(ref _known[index])
+                );
+            }
+
+            for (int i = 0; i < _custom.Count; i++)
+            {
+                CustomHeader header = _custom[i];
+                string value = header.String ?? Decode(header.Value);
+
+                yield return new(Decode(header.Name), value);
+            }
+        }
+
+        IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+
+        private int IndexOf(string name)
+        {
+            Span<CustomHeader> custom = CollectionsMarshal.AsSpan(_custom);
+
+            for (int i = 0; i < custom.Length; i++)
+            {
+                if (Ascii.EqualsIgnoreCase(GetRaw(custom[i].Name), name))
+                {
+                    return i;
+                }
+            }
+
+            return -1;
+        }
+
+        private string GetValue(ref HeaderSlot slot) => slot.String ??= Decode(slot.Value);
+
+        private string GetValue(ref CustomHeader header) => header.String ??= Decode(header.Value);
+
+        private ReadOnlySpan<byte> GetRaw(Range range) => buffer.GetBinSpan(0)[range];
+
+        private string Decode(Range range)
+        {
+            ReadOnlySpan<byte> raw = GetRaw(range);
+            return raw.IsEmpty ? string.Empty : contextInfo.Encoding.GetString(raw);
+        }
+
+        private struct HeaderSlot
+        {
+            public Range Value;
+            public string? String;
+        }
+
+        private struct CustomHeader
+        {
+            public Range Name;
+            public Range Value;
+            public string? String;
+        }
+    }
+}
@@ -24,15 +24,14 @@
 
 using System;
 using System.Net;
-using System.Linq;
+using System.Text;
 using System.Buffers;
+using System.Buffers.Text;
 using System.Collections.Generic;
 using System.Runtime.CompilerServices;
 
-using VNLib.Utils;
 using VNLib.Utils.IO;
 using VNLib.Utils.Logging;
-using VNLib.Utils.Extensions;
 
 namespace VNLib.Net.Http.Core
 {
@@ -52,22 +51,101 @@ namespace VNLib.Net.Http.Core
             internal UriBuilder? Location;
             internal bool IsAbsoluteRequestUrl;
             internal long ContentLength;
+            internal Http1HeadScanner Head;
+
+            /*
+             * Raw request target components, they point into the buffered 
+             * request head so they are only decoded if the target is not 
+             * canonical
+             */
+            internal ReadOnlySpan<byte> Path;
+            internal ReadOnlySpan<byte> Query;
+            internal ReadOnlySpan<byte> Host;
+            internal string? DecodedHost;
+            internal int? Port;
+            internal bool Secure;
         }
 
+        /// <summary>
+        /// Reads from the transport until the entire request head (request line and headers)
+        /// is buffered, and prepares the parse state to scan it. The reader is advanced past
+        /// the head so only entity body data remains.
+        /// </summary>
+        /// <param name="Request"></param>
+        /// <param name="parseState">The HTTP1 parsing state</param>
+        /// <param name="reader">The reader to buffer transport data with</param>
+        /// <returns>0 if the request head was buffered, a status code if the request could not be processed</returns>
+        [MethodImpl(MethodImplOptions.AggressiveOptimization | MethodImplOptions.AggressiveInlining)]
+        public static HttpStatusCode Http1ReadHead(this HttpRequest Request, ref Http1ParseState parseState, ref TransportReader reader)
+        {
+            int searchStart = 0;
+
+            while (true)
+            {
+                Span<byte> window = reader.BufferedDataWindow;
+
+                //RFC 9112 2.2, ignore empty lines preceding the request line
+                if (window.StartsWith("\r\n"u8))
+                {
+                    reader.Advance(2);
+                    searchStart = 0;
+                    continue;
+                }
+
+                int headLength = Http1HeadScanner.GetHeadLength(window, searchStart);
+
+                if (headLength > 0)
+                {
+                    //RFC 9112 2.2, bare line endings are rejected so line splitting agrees with the end of the head
+                    if (!Http1HeadScanner.HasStrictLineEndings(window[..headLength]))
+                    {
+                        return HttpStatusCode.BadRequest;
+                    }
+
+                    parseState.Head = new(window[..headLength]);
+
+                    /*
+                     * The head must stay in place while it is parsed, advancing
+                     * only moves the window start, the buffer is not compacted 
+                     * again until the next request
+                     */
+                    reader.Advance(headLength);
+                    return 0;
+                }
+
+                //The end sequence may be split across reads
+                searchStart = Math.Max(0, window.Length - 3);
+
+                //The head does not fit in the buffer
+                if (reader.CompactBufferWindow() == 0)
+                {
+                    return HttpStatusCode.RequestHeaderFieldsTooLarge;
+                }
+
+                int buffered = reader.Available;
+
+                reader.FillBuffer();
+
+                //Transport closed before the head was complete
+                if (reader.Available == buffered)
+                {
+                    return buffered == 0 ? (HttpStatusCode)1000 : HttpStatusCode.BadRequest;
+                }
+            }
+        }
 
         /// <summary>
-        /// Reads the first line from the transport stream using the specified buffer
-        /// and parses the HTTP request line components: Method, resource, Http Version
+        /// Parses the HTTP request line components from the buffered request head: 
+        /// Method, resource, Http Version
         /// </summary>
         /// <param name="Request"></param>
-        /// <param name="reader">The reader to read lines from the transport</param>
         /// <param name="parseState">The HTTP1 parsing state</param>
-        /// <param name="lineBuf">The buffer to use when parsing the request data</param>
+        /// <param name="Config">The current server <see cref="HttpConfig"/></param>
         /// <param name="usingTls">True if the transport is using TLS</param>
         /// <returns>0 if the request line was successfully parsed, a status code if the request could not be processed</returns>
         /// <exception cref="UriFormatException"></exception>
         [MethodImpl(MethodImplOptions.AggressiveOptimization | MethodImplOptions.AggressiveInlining)]
-        public static HttpStatusCode Http1ParseRequestLine(this HttpRequest Request, ref Http1ParseState parseState, ref TransportReader reader, Span<char> lineBuf, bool usingTls)
+        public static HttpStatusCode Http1ParseRequestLine(this HttpRequest Request, ref Http1ParseState parseState, ref readonly HttpConfig Config, bool usingTls)
         {
             /*
              * Evil mutable struct, get a local mutable reference to the request's 
@@ -76,46 +154,40 @@ namespace VNLib.Net.Http.Core
             ref HttpRequestState reqState = ref Request.GetMutableStateForInit();
 
             //Locals
-            ERRNO requestResult;
             int index, endloc;
-            ReadOnlySpan<char> requestLine, pathAndQuery;
-
-            //Read the start line
-            requestResult = reader.ReadLine(lineBuf);
+            ReadOnlySpan<byte> requestLine, pathAndQuery;
 
             //Must be able to parse the verb and location
-            if (requestResult < 1)
+            if (!parseState.Head.TryReadLine(out requestLine, out _))
             {
                 //empty request
                 return (HttpStatusCode)1000;
             }
             
             //true up the request line to actual size
-            requestLine = lineBuf[..(int)requestResult].Trim();
+            requestLine = requestLine.Trim((byte)' ');
 
             //Find the first white space character ("GET / HTTP/1.1")
-            index = requestLine.IndexOf(' ');
+            index = requestLine.IndexOf((byte)' ');
             if (index == -1)
             {
                 return HttpStatusCode.BadRequest;
             }
 
-            //Decode the verb (function requires the string be the exact characters of the request method)
+            //Decode the verb by comparing the raw method token
             if ((reqState.Method = HttpHelpers.GetRequestMethod(requestLine[0..index])) == HttpMethod.None)
             {
                 return HttpStatusCode.MethodNotAllowed;
             }
-            
-            //location string should be from end of verb to HTTP/ NOTE: Only supports http... this is an http server
-            
+
             //Client must specify an http version prepended by a single whitespace(rfc2612)
-            if ((endloc = requestLine.LastIndexOf(" HTTP/", StringComparison.OrdinalIgnoreCase)) == -1)
+            if ((endloc = requestLine.LastIndexOf((byte)' ')) == index)
             {
                 return HttpStatusCode.HttpVersionNotSupported;
             }
             
             //Try to parse the requested http version, only supported versions
-            if ((reqState.HttpVersion = HttpHelpers.ParseHttpVersion(requestLine[endloc..])) == HttpVersion.None)
+            if ((reqState.HttpVersion = HttpHelpers.ParseHttpVersion(requestLine[(endloc + 1)..])) == HttpVersion.None)
             {
                 return HttpStatusCode.HttpVersionNotSupported;
             }
@@ -124,41 +196,33 @@ namespace VNLib.Net.Http.Core
             reqState.KeepAlive = reqState.HttpVersion == HttpVersion.Http11;
 
             //Get the location segment from the request line
-            pathAndQuery = requestLine[(index + 1)..endloc].TrimCRLF();
+            pathAndQuery = requestLine[(index + 1)..endloc].Trim((byte)' ');
+
+            parseState.Secure = usingTls;
 
             //Process an absolute uri, 
-            if (pathAndQuery.Contains("://", StringComparison.Ordinal))
+            if (pathAndQuery.IndexOf("://"u8) > -1)
             {
                 //Convert the location string to a .net string and init the location builder (will perform validation when the Uri propery is used)
-                parseState.Location = new(pathAndQuery.ToString());
+                parseState.Location = new(Config.HttpEncoding.GetString(pathAndQuery));
                 parseState.IsAbsoluteRequestUrl = true;
                 return 0;
             }
             //Try to capture a realative uri
             else if (pathAndQuery.Length > 0 && pathAndQuery[0] == '/')
             {
-                //Create a default location uribuilder
-                parseState.Location = new()
-                {
-                    //Set a default scheme
-                    Scheme = usingTls ? Uri.UriSchemeHttps : Uri.UriSchemeHttp,
-                };
+                /*
+                 * Only capture the raw path and query, the location is not 
+                 * built until the host is known, and only if the target 
+                 * is not canonical
+                 */
+                int q = pathAndQuery.IndexOf((byte)'?');
 
-                //Need to manually parse the query string
-                int q = pathAndQuery.IndexOf('?');
+                parseState.Path = q < 0 ? pathAndQuery : pathAndQuery[..q];
 
-                //has query?
-                if (q == -1)
-                {
-                    parseState.Location.Path = pathAndQuery.ToString();
-                }
-                //Does have query argument
-                else
-                {
-                    //separate the path from the query
-                    parseState.Location.Path = pathAndQuery[0..q].ToString();
-                    parseState.Location.Query = pathAndQuery[(q + 1)..].ToString();
-                }
+                //An empty query is the same as no query
+                parseState.Query = q < 0 || q == pathAndQuery.Length - 1 ? default : pathAndQuery[q..];
+                
                 return 0;
             }
             //Cannot service an unknonw location
@@ -166,16 +230,14 @@ namespace VNLib.Net.Http.Core
         }
 
         /// <summary>
-        /// Reads headers from the transport using the supplied character buffer, and updates the current request
+        /// Parses the headers from the buffered request head and updates the current request
         /// </summary>
         /// <param name="Request"></param>
         /// <param name="parseState">The HTTP1 parsing state</param>
         /// <param name="Config">The current server <see cref="HttpConfig"/></param>
-        /// <param name="reader">The <see cref="VnStreamReader"/> to read lines from the transport</param>
-        /// <param name="lineBuf">The buffer read data from the transport with</param>
         /// <returns>0 if the request line was successfully parsed, a status code if the request could not be processed</returns>
         [MethodImpl(MethodImplOptions.AggressiveOptimization | MethodImplOptions.AggressiveInlining)]
-        public static HttpStatusCode Http1ParseHeaders(this HttpRequest Request, ref Http1ParseState parseState, ref TransportReader reader, ref readonly HttpConfig Config, Span<char> lineBuf)
+        public static HttpStatusCode Http1ParseHeaders(this HttpRequest Request, ref Http1ParseState parseState, ref readonly HttpConfig Config)
         {
             /*
             * Evil mutable struct, get a local mutable reference to the request's 
@@ -183,101 +245,84 @@ namespace VNLib.Net.Http.Core
             */
             ref HttpRequestState reqState = ref Request.GetMutableStateForInit();
 
+            Encoding encoding = Config.HttpEncoding;
+            bool hostFound = false;
+
             try
             {
                 int headerCount = 0, colon;
-                bool hostFound = false;
-                ERRNO charsRead;
-                ReadOnlySpan<char> headerName, requestHeaderValue;
+                HttpRequestHeader knownHeader;
+                ReadOnlySpan<byte> header, headerName, requestHeaderValue;
                 
                 /*
-                 * This loop will read "lines" from the transport/reader buffer as headers
-                 * and store them in the rented character buffer with 0 allocations.
-                 * 
-                 * Lines will be read from the transport reader until an empty line is read, 
-                 * or an exception occurs. The VnStreamReader class will search for lines 
-                 * directly in the binary rather than converting the data then parsing it. 
-                 * When a line is parsed, its assumed to be an HTTP header at this point in 
-                 * the parsing, and is separated into its key-value pair determined by the 
-                 * first ':' character to appear.
+                 * The entire request head is already buffered, so lines are scanned 
+                 * directly from the transport buffer without decoding them to characters. 
+                 * The scanner locates line feeds and the header name delimiter of every 
+                 * line in a single vectorized pass.
                  * 
-                 * The header length will be limited by the size of the character buffer, 
-                 * or the reader binary buffer while reading lines. Buffer sizes are fixed 
-                 * to the system memory page size. Depending on the encoding the user chooses
-                 * this should not be an issue for most configurations. This strategy is 
-                 * most efficient for realtivly small header sizes. 
-                 * 
-                 * The header's key is hashed by the HttpHelpers class and the hash is used to 
-                 * index a lookup table to return its enumeration value which is used in the swtich 
-                 * statement to reduce the number of strings added to the request header container.
-                 * This was a major effort to reduce memory and CPU overhead while using the 
-                 * WebHeaderCollection .NET class, which I think is still worth using instead of a
-                 * custom header data structure class. 
+                 * Header names are matched against the known header table by comparing 
+                 * the raw ascii bytes, and values are only decoded to strings when they 
+                 * must be stored in the request. Values that are only used to set request 
+                 * state such as Content-Length, Range and Expect are parsed from the raw 
+                 * bytes and never allocated.
                  * 
                  * Some case statments are custom HttpRequestHeader enum values via internal casted 
                  * constants to be consistant with he .NET implementation.
                  */
-                do
+                while (parseState.Head.TryReadLine(out header, out colon))
                 {
-                    //Read a line until we reach the end of headers, this call will block if end of characters is reached and a new string will be read
-                    charsRead = reader.ReadLine(lineBuf);
-
-                    //If the result is less than 1, no line is available (end of headers) or could not be read 
-                    if (charsRead < 1)
+                    //An empty line is the end of the headers
+                    if (header.IsEmpty)
                     {
                         break;
                     }
 
-                    //Header count exceeded or header larger than header buffer size
-                    if (charsRead < 0 || headerCount > Config.MaxRequestHeaderCount)
+                    //Header count exceeded
+                    if (headerCount > Config.MaxRequestHeaderCount)
                     {
                         return HttpStatusCode.RequestHeaderFieldsTooLarge;
-                    }                    
-                    
+                    }
+
+                    /*
+                     * RFC 7230, ignore headers with preceeding whitespace
+                     * 
+                     * If the first character is whitespace that is enough to 
+                     * ignore the rest of the header
+                     */
+                    if (header[0] == ' ' || header[0] == '\t')
+                    {
+                        //Move on to next header
+                        continue;
+                    }
+
+                    //No colon was found, this is an invalid string, try to skip it and keep reading
+                    if (colon <= 0)
+                    {
+                        continue;
+                    }
+
+                    //RFC 9112 5.1, whitespace between the field name and colon must be rejected
+                    if (header[colon - 1] == ' ' || header[colon - 1] == '\t')
                     {
-                        //Get the true size of the read header line as a readonly span 
-                        ReadOnlySpan<char> header = lineBuf[..(int)charsRead];
-
-                        /*
-                         * RFC 7230, ignore headers with preceeding whitespace
-                         * 
-                         * If the first character is whitespace that is enough to 
-                         * ignore the rest of the header
-                         */
-                        if (header[0] == ' ')
-                        {
-                            //Move on to next header
-                            continue;
-                        }
-
-                        //Find the first colon
-                        colon = header.IndexOf(':');
-                        //No colon was found, this is an invalid string, try to skip it and keep reading
-                        if (colon <= 0)
-                        {
-                            continue;
-                        }
-                        
-                        //Store header and its value (sections before and after colon)
-                        headerName = header[..colon].TrimCRLF();
-                        requestHeaderValue = header[(colon + 1)..].TrimCRLF();
+                        return HttpStatusCode.BadRequest;
                     }
-                   
-                    //Hash the header key and lookup the request header value
-                    switch (HttpHelpers.GetRequestHeaderEnumFromValue(headerName))
+
+                    //Store header and its value (sections before and after colon)
+                    headerName = header[..colon];
+                    requestHeaderValue = TrimOws(header[(colon + 1)..]);
+
+                    //Compare the header name against the known header names
+                    switch (knownHeader = HttpHelpers.GetRequestHeaderEnumFromValue(headerName))
                     {
                         case HttpRequestHeader.Connection:
                             {
                                 //Update keepalive, if the connection header contains "closed" and with the current value of keepalive
-                                reqState.KeepAlive &= !requestHeaderValue.Contains("close", StringComparison.OrdinalIgnoreCase);
-
-                                //Also store the connecion header into the store
-                                Request.Headers.Add(HttpRequestHeader.Connection, requestHeaderValue.ToString());
+                                reqState.KeepAlive &= !ContainsIgnoreCase(requestHeaderValue, "close"u8);
                             }
                             break;
                         case HttpRequestHeader.ContentType:
                             {
-                                if (!HttpHelpers.TryParseContentType(requestHeaderValue.ToString(), out string? ct, out string? charset, out string? boundry) || ct == null)
+                                if (!HttpHelpers.TryParseContentType(encoding.GetString(requestHeaderValue), out string? ct, out string? charset, out string? boundry) || ct == null)
                                 {
                                     //Invalid content type header value
                                     return HttpStatusCode.UnsupportedMediaType;
@@ -300,7 +345,7 @@ namespace VNLib.Net.Http.Core
                                 }
 
                                 //Only capture positive values, and if length is negative we are supposed to ignore it
-                                if (ulong.TryParse(requestHeaderValue, out ulong len) && len < long.MaxValue)
+                                if (TryParseUInt64(requestHeaderValue, out ulong len) && len < long.MaxValue)
                                 {
                                     parseState.ContentLength = (long)len;
                                 }
@@ -322,75 +367,88 @@ namespace VNLib.Net.Http.Core
                                 hostFound = true;
 
                                 //Split the host value by the port parameter 
-                                ReadOnlySpan<char> port = requestHeaderValue.SliceAfterParam(':').Trim();
+                                int portIndex = requestHeaderValue.LastIndexOf((byte)':');
 
-                                //Slicing before the colon should always provide a useable hostname, so allocate a string for it
-                                string hostOnly = requestHeaderValue.SliceBeforeParam(':').Trim().ToString();
-                                
-                                //Verify that the host is usable
-                                if (Uri.CheckHostName(hostOnly) == UriHostNameType.Unknown)
+                                ReadOnlySpan<byte> port = portIndex < 0 ? default : requestHeaderValue[(portIndex + 1)..].Trim((byte)' ');
+
+                                //Slicing before the colon should always provide a useable hostname
+                                parseState.Host = (portIndex < 0 ? requestHeaderValue : requestHeaderValue[..portIndex]).Trim((byte)' ');
+                                parseState.DecodedHost = null;
+
+                                //Dns names in canonical form are valid and do not need to be decoded
+                                if (!HttpRequestTarget.IsCanonicalHost(parseState.Host))
                                 {
-                                    return HttpStatusCode.BadRequest;
+                                    parseState.DecodedHost = encoding.GetString(parseState.Host);
+
+                                    //Verify that the host is usable
+                                    if (Uri.CheckHostName(parseState.DecodedHost) == UriHostNameType.Unknown)
+                                    {
+                                        return HttpStatusCode.BadRequest;
+                                    }
                                 }
                                 
                                 //Verify that the host matches the host header if absolue uri is set
                                 if (parseState.IsAbsoluteRequestUrl)
                                 {
-                                    if (!hostOnly.Equals(parseState.Location!.Host, StringComparison.OrdinalIgnoreCase))
+                                    bool matches = parseState.DecodedHost == null
+                                        ? Ascii.EqualsIgnoreCase(parseState.Host, parseState.Location!.Host)
+                                        : parseState.DecodedHost.Equals(parseState.Location!.Host, StringComparison.OrdinalIgnoreCase);
+
+                                    if (!matches)
                                     {
                                         return HttpStatusCode.BadRequest;
                                     }
                                 }
-
-                                //store the host value
-                                parseState.Location!.Host = hostOnly;
                                 
                                 //If the port span is empty, no colon was found or the port is invalid
                                 if (!port.IsEmpty)
                                 {
                                     //try to parse the port number
-                                    if (!int.TryParse(port, out int p) || p < 0 || p > ushort.MaxValue)
+                                    if (!TryParseUInt64(port, out ulong p) || p > ushort.MaxValue)
                                     {
                                         return HttpStatusCode.BadRequest;
                                     }
                                     //Store port
-                                    parseState.Location.Port = p;
+                                    parseState.Port = (int)p;
                                 }
-
-                                //Set host header in collection also
-                                Request.Headers.Add(HttpRequestHeader.Host, requestHeaderValue.ToString());
                             }
                             break;
                         case HttpRequestHeader.Cookie:
                             {
-                                //Local function to break cookie segments into key-value pairs
-                                static void AddCookiesCallback(ReadOnlySpan<char> cookie, Dictionary<string, string> cookieContainer)
+                                //Split all cookies by ; with trailing whitespace
+                                for (ReadOnlySpan<byte> cookies = requestHeaderValue; !cookies.IsEmpty;)
                                 {
+                                    ReadOnlySpan<byte> cookie = NextListEntry(ref cookies, (byte)';');
+                                    int eq = cookie.IndexOf((byte)'=');
+
+                                    if (cookie.IsEmpty || eq == 0)
+                                    {
+                                        continue;
+                                    }
+
                                     //Get the name parameter and alloc a string
-                                    string name = cookie.SliceBeforeParam('=').Trim().ToString();
-                                    string value = cookie.SliceAfterParam('=').Trim().ToString();
+                                    string name = encoding.GetString((eq < 0 ? cookie : cookie[..eq]).Trim((byte)' '));
+                                    string value = eq < 0 ? string.Empty : encoding.GetString(cookie[(eq + 1)..].Trim((byte)' '));
 
                                     //Add the cookie to the dictionary
-                                    _ = cookieContainer.TryAdd(name, value);
+                                    _ = Request.Cookies.TryAdd(name, value);
                                 }
-                                //Split all cookies by ; with trailing whitespace
-                                requestHeaderValue.Split("; ", StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries, AddCookiesCallback, Request.Cookies);
                             }
                             break;
                         case HttpRequestHeader.AcceptLanguage:
                             //Capture accept languages and store in the request accept collection
-                            requestHeaderValue.Split(',', Request.AcceptLanguage, StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries);
+                            SplitList(requestHeaderValue, Request.AcceptLanguage, encoding);
                             break;
                         case HttpRequestHeader.Accept:
                             //Capture accept content types and store in request accept collection
-                            requestHeaderValue.Split(',', Request.Accept, StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries);
+                            SplitList(requestHeaderValue, Request.Accept, encoding);
                             break;
                         case HttpRequestHeader.Referer:
                             {
-                                //Check the referer header and capture its uri instance, it should be absolutely parseable
-                                if (!requestHeaderValue.IsEmpty && Uri.TryCreate(requestHeaderValue.ToString(), UriKind.Absolute, out Uri? refer))
+                                //Only the location of the value is stored, it is parsed when it is used
+                                if (!requestHeaderValue.IsEmpty)
                                 {
-                                    reqState.Referrer = refer;
+                                    reqState.RefererValue = Request.GetHeadRange(requestHeaderValue);
                                 }
                             }
                             break;
@@ -406,23 +464,26 @@ namespace VNLib.Net.Http.Core
                                 }
 
                                 //See if range bytes value has been set
-                                ReadOnlySpan<char> rawRange = requestHeaderValue.SliceAfterParam("bytes=").TrimCRLF();
+                                int bytesIndex = requestHeaderValue.IndexOf("bytes="u8);
 
                                 //Make sure the bytes parameter is set
-                                if (rawRange.IsEmpty)
+                                if (bytesIndex < 0)
                                 {
                                     //Ignore the header and continue parsing headers
                                     break;
                                 }
 
+                                ReadOnlySpan<byte> rawRange = requestHeaderValue[(bytesIndex + 6)..].Trim((byte)' ');
+                                int dash = rawRange.IndexOf((byte)'-');
+
                                 //Get start range
-                                ReadOnlySpan<char> startRange = rawRange.SliceBeforeParam('-');
+                                ReadOnlySpan<byte> startRange = dash < 0 ? rawRange : rawRange[..dash];
                                 //Get end range (empty if no - exists)
-                                ReadOnlySpan<char> endRange = rawRange.SliceAfterParam('-');
+                                ReadOnlySpan<byte> endRange = dash < 0 ? default : rawRange[(dash + 1)..];
 
                                 //try to parse the range values
-                                bool hasStartRange = ulong.TryParse(startRange, out ulong startRangeValue);
-                                bool hasEndRange = ulong.TryParse(endRange, out ulong endRangeValue);
+                                bool hasStartRange = TryParseUInt64(startRange, out ulong startRangeValue);
+                                bool hasEndRange = TryParseUInt64(endRange, out ulong endRangeValue);
 
                                 /*
                                  * The range header may be a range-from-end type request that 
@@ -465,36 +526,40 @@ namespace VNLib.Net.Http.Core
                                 //No valid range values
                             }
                            
-                            break;
-                        case HttpRequestHeader.UserAgent:
-                            //Store user-agent
-                            reqState.UserAgent = requestHeaderValue.IsEmpty ? string.Empty : requestHeaderValue.TrimCRLF().ToString();
                             break;
                         //Special code for origin header
                         case HttpHelpers.Origin:
                             {
-                                //Alloc a string for origin
-                                string origin = requestHeaderValue.ToString();
-
-                                //Origin headers should always be absolute address "parsable"
-                                if (Uri.TryCreate(origin, UriKind.Absolute, out Uri? org))
+                                //Only the location of the value is stored, it is parsed when it is used
+                                if (!requestHeaderValue.IsEmpty)
                                 {
-                                    reqState.Origin = org;
+                                    reqState.OriginValue = Request.GetHeadRange(requestHeaderValue);
                                 }
                             }
                             break;
                         case HttpRequestHeader.Expect:
                             //Accept 100-continue for the Expect header value
-                            reqState.Expect = requestHeaderValue.Equals("100-continue", StringComparison.OrdinalIgnoreCase);
-                            break;
-                        default:
-                            //By default store the header in the request header store
-                            Request.Headers.Add(headerName.ToString(), requestHeaderValue.ToString());
+                            reqState.Expect = Ascii.EqualsIgnoreCase(requestHeaderValue, "100-continue"u8);
                             break;
                     }
+
+                    /*
+                     * Every header is stored by the location of its value in the head, 
+                     * so it is only decoded if it is read. Well known headers are stored 
+                     * by their enum value so the name is never allocated.
+                     */
+                    if (knownHeader <= HttpRequestHeader.UserAgent)
+                    {
+                        Request.Headers.Add(knownHeader, Request.GetHeadRange(requestHeaderValue));
+                    }
+                    else
+                    {
+                        Request.Headers.Add(Request.GetHeadRange(headerName), Request.GetHeadRange(requestHeaderValue));
+                    }
+
                     //Increment header count
                     headerCount++;
-                } while (true);
+                }
 
                 //If request is http11 then host is required
                 if (reqState.HttpVersion == HttpVersion.Http11 && !hostFound)
@@ -509,6 +574,39 @@ namespace VNLib.Net.Http.Core
                 return HttpStatusCode.BadRequest;
             }
 
+            if (!parseState.IsAbsoluteRequestUrl)
+            {
+                //Http/1.0 requests may omit the host header
+                ReadOnlySpan<byte> host = hostFound ? parseState.Host : "localhost"u8;
+
+                //Canonical targets are stored raw and the location is built when it is first used
+                if (parseState.DecodedHost == null
+                    && HttpRequestTarget.IsCanonicalPath(parseState.Path) 
+                    && HttpRequestTarget.IsCanonicalQuery(parseState.Query))
+                {
+                    Request.SetCanonicalTarget(parseState.Path, parseState.Query, host, parseState.Port ?? -1, parseState.Secure);
+                    return 0;
+                }
+
+                //The uri may alter the target, so it must be built and validated now
+                parseState.Location = new()
+                {
+                    Scheme = parseState.Secure ? Uri.UriSchemeHttps : Uri.UriSchemeHttp,
+                    Host = parseState.DecodedHost ?? encoding.GetString(host),
+                    Path = encoding.GetString(parseState.Path),
+                    Query = parseState.Query.IsEmpty ? string.Empty : encoding.GetString(parseState.Query[1..])
+                };
+            }
+            else if (hostFound)
+            {
+                parseState.Location!.Host = parseState.DecodedHost ?? encoding.GetString(parseState.Host);
+            }
+
+            if (parseState.Port.HasValue)
+            {
+                parseState.Location!.Port = parseState.Port.Value;
+            }
+
             //Check the final location to make sure data was properly sent
             if (string.IsNullOrWhiteSpace(parseState.Location?.Host)
                 || string.IsNullOrWhiteSpace(parseState.Location.Scheme)
@@ -524,6 +622,76 @@ namespace VNLib.Net.Http.Core
             return 0;
         }
 
+        /*
+         * Trims optional whitespace (spaces and tabs) from both ends of a header value
+         */
+        private static ReadOnlySpan<byte> TrimOws(ReadOnlySpan<byte> value)
+        {
+            int start = 0, end = value.Length;
+
+            while (start < end && (value[start] == ' ' || value[start] == '\t'))
+            {
+                start++;
+            }
+
+            while (end > start && (value[end - 1] == ' ' || value[end - 1] == '\t'))
+            {
+                end--;
+            }
+
+            return value[start..end];
+        }
+
+        /*
+         * Parses an unsigned integer that must span the entire value
+         */
+        private static bool TryParseUInt64(ReadOnlySpan<byte> value, out ulong result)
+            => Utf8Parser.TryParse(value, out result, out int consumed) && consumed == value.Length && consumed > 0;
+
+        private static bool ContainsIgnoreCase(ReadOnlySpan<byte> value, ReadOnlySpan<byte> token)
+        {
+            for (int i = 0; i <= value.Length - token.Length; i++)
+            {
+                if (Ascii.EqualsIgnoreCase(value.Slice(i, token.Length), token))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /*
+         * Slices the next trimmed entry from a delimited list and 
+         * removes it from the remaining list
+         */
+        private static ReadOnlySpan<byte> NextListEntry(ref ReadOnlySpan<byte> list, byte delimiter)
+        {
+            int index = list.IndexOf(delimiter);
+
+            ReadOnlySpan<byte> entry = index < 0 ? list : list[..index];
+            list = index < 0 ? default : list[(index + 1)..];
+
+            return TrimOws(entry);
+        }
+
+        /*
+         * Splits a comma separated header value list into the list, skipping 
+         * empty entries and trimming whitespace
+         */
+        private static void SplitList(ReadOnlySpan<byte> value, List<string> output, Encoding encoding)
+        {
+            while (!value.IsEmpty)
+            {
+                ReadOnlySpan<byte> entry = NextListEntry(ref value, (byte)',');
+
+                if (!entry.IsEmpty)
+                {
+                    output.Add(encoding.GetString(entry));
+                }
+            }
+        }
+
         /// <summary>
         /// Prepares the entity body for the current HTTP1 request
         /// </summary>
@@ -567,9 +735,7 @@ namespace VNLib.Net.Http.Core
             }
             
             //Check for chuncked transfer encoding
-            ReadOnlySpan<char> transfer = Request.Headers[HttpRequestHeader.TransferEncoding];
-
-            if (!transfer.IsEmpty && transfer.Contains("chunked", StringComparison.OrdinalIgnoreCase))
+            if (Request.Headers.ValueContains(HttpRequestHeader.TransferEncoding, "chunked"))
             {
                 //Not a valid http version for chunked transfer encoding
                 if (reqState.HttpVersion != HttpVersion.Http11)
@@ -0,0 +1,216 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: Http1HeadScanner.cs 
+*
+* Http1HeadScanner.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Numerics;
+using System.Runtime.Intrinsics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace VNLib.Net.Http.Core
+{
+    /// <summary>
+    /// Splits a buffered HTTP/1.x request head into lines and finds the header name 
+    /// delimiter of every line in the same pass. Line feeds and colons are located 32 
+    /// bytes at a time with vector compares, the resulting bit masks are then consumed 
+    /// one line at a time so the head is only scanned once.
+    /// </summary>
+    internal ref struct Http1HeadScanner
+    {
+        private const int BLOCK_SIZE = 32;
+
+        private readonly ReadOnlySpan<byte> _head;
+        private int _lineStart;
+        private int _blockStart;
+        private uint _lfMask;
+        private uint _colonMask;
+
+        /// <summary>
+        /// Initializes a new scanner over a complete request head
+        /// </summary>
+        /// <param name="head">The request head including the terminating empty line</param>
+        public Http1HeadScanner(ReadOnlySpan<byte> head)
+        {
+            _head = head;
+            //The first call to NextBlock() loads the first block
+            _blockStart = -BLOCK_SIZE;
+        }
+
+        /// <summary>
+        /// The entire request head the scanner was initialized with
+        /// </summary>
+        public readonly ReadOnlySpan<byte> Head => _head;
+
+        /// <summary>
+        /// Reads the next line from the head, without its line terminator
+        /// </summary>
+        /// <param name="line">The line data excluding the CRLF</param>
+        /// <param name="colon">The offset of the first ':' within the line, -1 if the line does not contain one</param>
+        /// <returns>True if a line was read, false if the end of the head was reached</returns>
+        public bool TryReadLine(out ReadOnlySpan<byte> line, out int colon)
+        {
+            int colonPos = -1;
+
+            while (_lfMask == 0)
+            {
+                //The line continues into the next block, so any colon in this block belongs to it
+                if (colonPos < 0)
+                {
+                    colonPos = FirstColon(_head.Length);
+                }
+
+                if (!NextBlock())
+                {
+                    line = default;
+                    colon = -1;
+                    return false;
+                }
+            }
+
+            int lf = _blockStart + BitOperations.TrailingZeroCount(_lfMask);
+
+            //Consume the line feed
+            _lfMask &= _lfMask - 1;
+
+            if (colonPos < 0)
+            {
+                colonPos = FirstColon(lf);
+            }
+
+            int end = lf > _lineStart && _head[lf - 1] == '\r' ? lf - 1 : lf;
+
+            line = _head[_lineStart..end];
+            colon = colonPos < 0 || colonPos >= end ? -1 : colonPos - _lineStart;
+
+            _lineStart = lf + 1;
+            return true;
+        }
+
+        /*
+         * Gets the first colon in the current block at or after the 
+         * start of the current line and before the limit
+         */
+        private readonly int FirstColon(int limit)
+        {
+            uint mask = _colonMask;
+            int skip = _lineStart - _blockStart;
+
+            if (skip > 0)
+            {
+                mask = skip >= BLOCK_SIZE ? 0 : mask & (uint.MaxValue << skip);
+            }
+
+            if (mask == 0)
+            {
+                return -1;
+            }
+
+            int pos = _blockStart + BitOperations.TrailingZeroCount(mask);
+            return pos < limit ? pos : -1;
+        }
+
+        private bool NextBlock()
+        {
+            _blockStart += BLOCK_SIZE;
+
+            int remaining = _head.Length - _blockStart;
+
+            if (remaining <= 0)
+            {
+                return false;
+            }
+
+            ref byte block = ref Unsafe.Add(ref MemoryMarshal.GetReference(_head), _blockStart);
+
+            if (remaining >= BLOCK_SIZE && Vector256.IsHardwareAccelerated)
+            {
+                Vector256<byte> data = Vector256.LoadUnsafe(ref block);
+
+                _lfMask = Vector256.Equals(data, Vector256.Create((byte)'\n')).ExtractMostSignificantBits();
+                _colonMask = Vector256.Equals(data, Vector256.Create((byte)':')).ExtractMostSignificantBits();
+            }
+            else if (remaining >= BLOCK_SIZE && Vector128.IsHardwareAccelerated)
+            {
+                Vector128<byte> lower = Vector128.LoadUnsafe(ref block);
+                Vector128<byte> upper = Vector128.LoadUnsafe(ref block, 16);
+
+                _lfMask = Vector128.Equals(lower, Vector128.Create((byte)'\n')).ExtractMostSignificantBits()
+                    | (Vector128.Equals(upper, Vector128.Create((byte)'\n')).ExtractMostSignificantBits() << 16);
+
+                _colonMask = Vector128.Equals(lower, Vector128.Create((byte)':')).ExtractMostSignificantBits()
+                    | (Vector128.Equals(upper, Vector128.Create((byte)':')).ExtractMostSignificantBits() << 16);
+            }
+            else
+            {
+                //Trailing partial block or no vector support
+                _lfMask = _colonMask = 0;
+
+                int count = Math.Min(remaining, BLOCK_SIZE);
+
+                for (int i = 0; i < count; i++)
+                {
+                    byte b = Unsafe.Add(ref block, i);
+
+                    if (b == '\n')
+                    {
+                        _lfMask |= 1u << i;
+                    }
+                    else if (b == ':')
+                    {
+                        _colonMask |= 1u << i;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Determines if every line of the head is terminated by exactly one CRLF. 
+        /// Lines are split on line feeds but the head only ends at an empty CRLF line, 
+        /// so a bare LF or CR would let the scanner find an empty line before the 
+        /// end of the head, and the headers after it would be silently dropped. 
+        /// </summary>
+        /// <param name="head">The request head including the terminating empty line</param>
+        /// <returns>True if the head contains no bare CR or LF bytes, false otherwise</returns>
+        public static bool HasStrictLineEndings(ReadOnlySpan<byte> head)
+        {
+            //Every CR must be followed by a LF and every LF must follow a CR
+            int crlfCount = head.Count("\r\n"u8);
+            return head.Count((byte)'\r') == crlfCount && head.Count((byte)'\n') == crlfCount;
+        }
+
+        /// <summary>
+        /// Finds the end of the request head, the first empty line 
+        /// </summary>
+        /// <param name="window">The buffered request data</param>
+        /// <param name="searchStart">The offset to begin searching at, data before it is known not to contain the end</param>
+        /// <returns>The length of the head including its terminating empty line, or -1 if the head is not complete</returns>
+        public static int GetHeadLength(ReadOnlySpan<byte> window, int searchStart)
+        {
+            int index = window[searchStart..].IndexOf("\r\n\r\n"u8);
+            return index < 0 ? -1 : searchStart + index + 4;
+        }
+    }
+}
@@ -23,6 +23,7 @@
 */
 
 using System;
+using System.Numerics;
 using System.Diagnostics;
 using System.Runtime.InteropServices;
 
@@ -75,6 +76,14 @@ namespace VNLib.Net.Http.Core.Response
             return Buffer.GetMemory()[reservedOffset..endPtr];
         }
 
+        /// <summary>
+        /// Gets the accumulated data without chunk framing, for protocols that frame 
+        /// the data themselves
+        /// </summary>
+        /// <returns>The accumulated data segment</returns>
+        public readonly Memory<byte> GetData(int accumulatedSize) 
+            => Buffer.GetMemory().Slice(ReservedSize, accumulatedSize);
+
         /// <summary>
         /// Gets the remaining segment of the buffer to write chunk data to.
         /// </summary>
@@ -95,6 +104,92 @@ namespace VNLib.Net.Http.Core.Response
 
         private static int GetPointerToEndOfUsedBuffer(int accumulatedSize) => accumulatedSize + ReservedSize;
 
+        /*
+         * Chunks written directly into transport memory cannot be shifted to 
+         * abutt their size prefix once the data is written, so the chunk size
+         * is zero-padded to a fixed width, wide enough for the largest chunk
+         * the accumulator buffer can hold. Leading zeros are legal in the 
+         * chunk-size field.
+         * 
+         * [padded size\r\n] [chunk data] [\r\n] [optional final chunk]
+         * [000a\r\n] [10 bytes of data] [\r\n]
+         */
+
+        /// <summary>
+        /// The size of the transport memory block a direct chunk is written to
+        /// </summary>
+        public readonly int DirectChunkSize => Buffer.Size;
+
+        private readonly int DirectPrefixSize => GetHexDigitCount(Buffer.Size) + Context.CrlfSegment.Length;
+
+        //Must leave room for the trailing crlf and the final chunk
+        private readonly int DirectMaxDataEnd => Buffer.Size - Context.CrlfSegment.Length - Context.FinalChunkSegment.Length;
+
+        /// <summary>
+        /// Gets the remaining segment of a direct chunk block to write chunk data to
+        /// </summary>
+        /// <param name="chunk">The transport memory block of <see cref="DirectChunkSize"/> bytes</param>
+        /// <param name="accumulatedSize">The number of data bytes already written to the chunk</param>
+        /// <returns>The chunk buffer to write data to</returns>
+        public readonly Memory<byte> GetDirectRemainingSegment(Memory<byte> chunk, int accumulatedSize) 
+            => chunk[(DirectPrefixSize + accumulatedSize)..DirectMaxDataEnd];
+
+        /// <summary>
+        /// Calculates the usable remaining size of a direct chunk block
+        /// </summary>
+        /// <returns>The number of bytes remaining in the chunk</returns>
+        public readonly int GetDirectRemainingSegmentSize(int accumulatedSize) 
+            => DirectMaxDataEnd - DirectPrefixSize - accumulatedSize;
+
+        /// <summary>
+        /// Completes the framing of a direct chunk block in place 
+        /// </summary>
+        /// <param name="chunk">The transport memory block the chunk data was written to</param>
+        /// <param name="accumulatedSize">The number of data bytes written to the chunk</param>
+        /// <param name="isFinalChunk">A value that indicates if the final chunk should be appended</param>
+        /// <returns>The number of bytes of the block that must be sent</returns>
+        public readonly int CompleteDirectChunk(Span<byte> chunk, int accumulatedSize, bool isFinalChunk)
+        {
+            int endPtr = 0;
+
+            //Empty data chunks would terminate the body, so only the final chunk may be written
+            if (accumulatedSize > 0)
+            {
+                endPtr += WritePaddedChunkSize(chunk, GetHexDigitCount(Buffer.Size), accumulatedSize);
+                endPtr += Context.CrlfSegment.DangerousCopyTo(chunk[endPtr..]);
+
+                //Data is already in place
+                endPtr += accumulatedSize;
+
+                //Write trailing chunk delimiter
+                endPtr += Context.CrlfSegment.DangerousCopyTo(chunk[endPtr..]);
+            }
+
+            if (isFinalChunk)
+            {
+                endPtr += Context.FinalChunkSegment.DangerousCopyTo(chunk[endPtr..]);
+            }
+
+            return endPtr;
+        }
+
+        private readonly int WritePaddedChunkSize(Span<byte> output, int digits, int chunkSize)
+        {
+            Debug.Assert(digits < 10, "Chunk size digit count must be a single format digit");
+
+            //Format as zero-padded hex, ex: x4
+            ReadOnlySpan<char> format = ['x', (char)('0' + digits)];
+
+            Span<char> intFormatBuffer = stackalloc char[2 * sizeof(int)];
+
+            bool formatSuccess = chunkSize.TryFormat(intFormatBuffer, out int charsFormatted, format, null);
+            Debug.Assert(formatSuccess && charsFormatted == digits, "Failed to write padded chunk size to temp buffer");
+
+            return Context.Encoding.GetBytes(intFormatBuffer[..charsFormatted], output);
+        }
+
+        private static int GetHexDigitCount(int value) => (32 - BitOperations.LeadingZeroCount((uint)value) + 3) / 4;
+
         /*
          * UpdateChunkSize method updates the running total of the chunk size
          * in the reserved segment of the buffer. This is because http chunking 
@@ -1,5 +1,5 @@
 ﻿/*
-* Copyright (c) 2023 Vaughn Nugent
+* Copyright (c) 2024 Vaughn Nugent
 * 
 * Library: VNLib
 * Package: VNLib.Net.Http
@@ -23,10 +23,14 @@
 */
 
 using System;
+using System.Net;
+using System.Text;
+using System.Buffers.Text;
 
 using VNLib.Utils.Memory;
 using VNLib.Utils.Extensions;
 
+using VNLib.Net.Http.Core.Http2;
 using VNLib.Net.Http.Core.Buffering;
 
 namespace VNLib.Net.Http.Core.Response
@@ -35,15 +39,24 @@ namespace VNLib.Net.Http.Core.Response
     /// <summary>
     /// Specialized data accumulator for compiling response headers
     /// </summary>
+    /// <remarks>
+    /// For HTTP/2 streams the same header writes produce an HPACK header block instead 
+    /// of header lines, so the response pipeline does not depend on the protocol version.
+    /// </remarks>
     internal readonly struct HeaderDataAccumulator
     {
+        //Values up to this size are huffman encoded when it makes them shorter
+        private const int MaxHuffmanValueSize = 256;
+
         private readonly IResponseHeaderAccBuffer _buffer;
         private readonly IHttpContextInformation _contextInfo;
+        private readonly bool _hpack;
 
-        public HeaderDataAccumulator(IResponseHeaderAccBuffer accBuffer, IHttpContextInformation ctx)
+        public HeaderDataAccumulator(IResponseHeaderAccBuffer accBuffer, IHttpContextInformation ctx, bool hpack)
         {
             _buffer = accBuffer;
             _contextInfo = ctx;
+            _hpack = hpack;
         }
 
         /// <summary>
@@ -93,10 +106,205 @@ namespace VNLib.Net.Http.Core.Response
         }
 
         /// <summary>
-        /// Writes the http termination sequence to the internal accumulator
+        /// Writes pre-encoded data directly to the internal accumulator
+        /// </summary>
+        /// <param name="data">The encoded data to accumulate</param>
+        /// <param name="accumulatedSize">A reference to the cumulative number of bytes written to the buffer</param>
+        public readonly void WriteBytes(ReadOnlySpan<byte> data, ref int accumulatedSize)
+        {
+            data.CopyTo(_buffer.GetBinSpan(accumulatedSize));
+            accumulatedSize += data.Length;
+        }
+
+        /// <summary>
+        /// Writes the pre-encoded status line for the current http version and the 
+        /// cached Date header to the internal accumulator
+        /// </summary>
+        /// <param name="code">The response status code</param>
+        /// <param name="accumulatedSize">A reference to the cumulative number of bytes written to the buffer</param>
+        public readonly void WriteStatusLine(HttpStatusCode code, ref int accumulatedSize)
+        {
+            if (_hpack)
+            {
+                WriteHpackStatus(code, ref accumulatedSize);
+                return;
+            }
+
+            WriteBytes(HttpHelpers.GetResponseStatusLine(_contextInfo.CurrentVersion, code), ref accumulatedSize);
+            WriteBytes(HttpDateHeader.Current, ref accumulatedSize);
+        }
+
+        /// <summary>
+        /// Writes a single <![CDATA[<name>: <value>\r\n]]> header line to the internal accumulator
+        /// </summary>
+        /// <param name="name">The header name</param>
+        /// <param name="value">The header value</param>
+        /// <param name="accumulatedSize">A reference to the cumulative number of bytes written to the buffer</param>
+        public readonly void WriteHeader(ReadOnlySpan<char> name, ReadOnlySpan<char> value, ref int accumulatedSize)
+        {
+            if (_hpack)
+            {
+                //Literal field without indexing and a new name, field names must be lowercase in HTTP/2
+                _buffer.GetBinSpan(accumulatedSize)[0] = 0;
+                accumulatedSize++;
+
+                WriteHpackString(name, true, ref accumulatedSize);
+                WriteHpackString(value, false, ref accumulatedSize);
+                return;
+            }
+
+            WriteToken(name, ref accumulatedSize);
+            WriteBytes(": "u8, ref accumulatedSize);
+            WriteToken(value, ref accumulatedSize);
+            WriteBytes("\r\n"u8, ref accumulatedSize);
+        }
+
+        /// <summary>
+        /// Writes a well-known header line with a pre-encoded name to the internal accumulator
+        /// </summary>
+        /// <param name="header">The well-known response header</param>
+        /// <param name="value">The header value</param>
+        /// <param name="accumulatedSize">A reference to the cumulative number of bytes written to the buffer</param>
+        public readonly void WriteHeader(HttpResponseHeader header, ReadOnlySpan<char> value, ref int accumulatedSize)
+        {
+            if (_hpack)
+            {
+                if (WriteHpackName(header, ref accumulatedSize))
+                {
+                    WriteHpackString(value, false, ref accumulatedSize);
+                }
+                return;
+            }
+
+            WriteBytes(HttpHelpers.GetResponseHeaderName(header), ref accumulatedSize);
+            WriteToken(value, ref accumulatedSize);
+            WriteBytes("\r\n"u8, ref accumulatedSize);
+        }
+
+        /// <summary>
+        /// Writes a well-known header line with an integer value, the value is formatted 
+        /// directly into the accumulator
+        /// </summary>
+        /// <param name="header">The well-known response header</param>
+        /// <param name="value">The integer header value</param>
+        /// <param name="accumulatedSize">A reference to the cumulative number of bytes written to the buffer</param>
+        /// <exception cref="ArgumentException"></exception>
+        public readonly void WriteHeader(HttpResponseHeader header, long value, ref int accumulatedSize)
+        {
+            if (_hpack)
+            {
+                Span<byte> digits = stackalloc byte[20];
+
+                if (WriteHpackName(header, ref accumulatedSize) && Utf8Formatter.TryFormat(value, digits, out int length))
+                {
+                    accumulatedSize += HpackEncoder.WriteString(_buffer.GetBinSpan(accumulatedSize), digits[..length]);
+                }
+                return;
+            }
+
+            WriteBytes(HttpHelpers.GetResponseHeaderName(header), ref accumulatedSize);
+
+            if (!Utf8Formatter.TryFormat(value, _buffer.GetBinSpan(accumulatedSize), out int written))
+            {
+                throw new ArgumentException("The header buffer is too small to store the header value");
+            }
+
+            accumulatedSize += written;
+
+            WriteBytes("\r\n"u8, ref accumulatedSize);
+        }
+
+        /// <summary>
+        /// Writes the http termination sequence to the internal accumulator, an HPACK 
+        /// header block does not have one
         /// </summary>
         public readonly void WriteTermination(ref int accumulatedSize)
-            => accumulatedSize += _contextInfo.CrlfSegment.DangerousCopyTo(_buffer, accumulatedSize);
+        {
+            if (!_hpack)
+            {
+                accumulatedSize += _contextInfo.CrlfSegment.DangerousCopyTo(_buffer, accumulatedSize);
+            }
+        }
+
+        /*
+         * Writes the :status pseudo-header followed by the cached date, 
+         * common status codes are fully indexed in the static table
+         */
+        private readonly void WriteHpackStatus(HttpStatusCode code, ref int accumulatedSize)
+        {
+            int index = HpackStaticTable.GetStatusIndex(code);
+
+            if (index > 0)
+            {
+                accumulatedSize += HpackEncoder.WriteIndexed(_buffer.GetBinSpan(accumulatedSize), index);
+            }
+            else
+            {
+                Span<byte> digits = stackalloc byte[3];
+                Utf8Formatter.TryFormat((int)code, digits, out int length);
+
+                accumulatedSize += HpackEncoder.WriteLiteralName(_buffer.GetBinSpan(accumulatedSize), HpackStaticTable.Status);
+                accumulatedSize += HpackEncoder.WriteString(_buffer.GetBinSpan(accumulatedSize), digits[..length]);
+            }
+
+            //The cached header line is "Date: <value>\r\n"
+            accumulatedSize += HpackEncoder.WriteLiteralName(_buffer.GetBinSpan(accumulatedSize), HpackStaticTable.Date);
+            accumulatedSize += HpackEncoder.WriteString(_buffer.GetBinSpan(accumulatedSize), HttpDateHeader.Current[6..^2]);
+        }
+
+        /*
+         * Writes the name of a known header, connection specific headers 
+         * are not allowed in HTTP/2 and are skipped
+         */
+        private readonly bool WriteHpackName(HttpResponseHeader header, ref int accumulatedSize)
+        {
+            if (HpackStaticTable.IsConnectionSpecific(header))
+            {
+                return false;
+            }
+
+            int index = HpackStaticTable.GetNameIndex(header);
+
+            accumulatedSize += index > 0
+                ? HpackEncoder.WriteLiteralName(_buffer.GetBinSpan(accumulatedSize), index)
+                : HpackEncoder.WriteLiteralName(_buffer.GetBinSpan(accumulatedSize), HpackStaticTable.GetLiteralName(header));
+
+            return true;
+        }
+
+        private readonly void WriteHpackString(ReadOnlySpan<char> value, bool lowercase, ref int accumulatedSize)
+        {
+            Encoding encoding = _contextInfo.Encoding;
+            int byteCount = encoding.GetByteCount(value);
+
+            if (byteCount <= MaxHuffmanValueSize)
+            {
+                Span<byte> raw = stackalloc byte[MaxHuffmanValueSize];
+                raw = raw[..encoding.GetBytes(value, raw)];
+
+                if (lowercase)
+                {
+                    Ascii.ToLowerInPlace(raw, out _);
+                }
+
+                accumulatedSize += HpackEncoder.WriteString(_buffer.GetBinSpan(accumulatedSize), raw);
+            }
+            else
+            {
+                //Large values are encoded in place without huffman coding
+                Span<byte> output = _buffer.GetBinSpan(accumulatedSize);
+
+                int prefix = HpackEncoder.WriteInteger(output, byteCount, 7, 0);
+                int written = encoding.GetBytes(value, output[prefix..]);
+
+                if (lowercase)
+                {
+                    Ascii.ToLowerInPlace(output.Slice(prefix, written), out _);
+                }
+
+                accumulatedSize += prefix + written;
+            }
+        }
 
     }
-}
\ No newline at end of file
+}
@@ -25,9 +25,11 @@
 using System;
 using System.Net;
 using System.Diagnostics;
+using System.Diagnostics.CodeAnalysis;
 using System.Threading.Tasks;
 
 using VNLib.Net.Http.Core.Response;
+using VNLib.Net.Http.Core.PerfCounter;
 
 namespace VNLib.Net.Http.Core
 {
@@ -70,8 +72,15 @@ namespace VNLib.Net.Http.Core
                 await discardTask;
             }
 
-            //Close response once send and discard are complete
-            await Response.CloseAsync();
+            //Close response once send and discard are complete, headers are still unsent if there was no entity
+            if (!Response.HeadersSent)
+            {
+                long start = HttpServerMetrics.GetTimestamp();
+
+                await Response.CloseAsync();
+
+                ParentServer.Metrics.Record(HttpServerPhase.HeaderFlush, start);
+            }
         }
 
         /// <summary>
@@ -154,10 +163,24 @@ namespace VNLib.Net.Http.Core
             //Determine if buffer is required
             Memory<byte> buffer = ResponseBody.BufferRequired ? Buffers.GetResponseDataBuffer() : Memory<byte>.Empty;
 
+            long start = HttpServerMetrics.GetTimestamp();
+
             //We need to flush header before we can write to the transport
             await Response.CompleteHeadersAsync(compMethod == CompressionMethod.None ? length : -1);
 
-            if (compMethod == CompressionMethod.None)
+            ParentServer.Metrics.Record(HttpServerPhase.HeaderFlush, start);
+
+            if (compMethod == CompressionMethod.None && ResponseBody.FileRegion != null && TryGetFileSender(out ITransportFileSender? sender))
+            {
+                //The transport can send the file without copying it through the response buffer
+                await ResponseBody.WriteFileRegionAsync(sender);
+            }
+            else if (compMethod == CompressionMethod.None && ResponseBody.BufferRequired && Response.GetSendBufferWriter(buffer.Length) is IResponseDataWriter sendBuffer)
+            {
+                //Stream data is read directly into the transport's send buffer instead of the response buffer
+                await ResponseBody.WriteStreamEntityAsync(sendBuffer);
+            }
+            else if (compMethod == CompressionMethod.None)
             {
                 //Setup a direct stream to write to because compression is not enabled
                 IDirectResponsWriter output = Response.GetDirectStream();
@@ -176,12 +199,29 @@ namespace VNLib.Net.Http.Core
                 //Init compressor (Deinint is deferred to the end of the request)
                 _compressor.Init(compMethod);
 
+                start = HttpServerMetrics.GetTimestamp();
+
                 //Write response
                 await ResponseBody.WriteEntityAsync(_compressor, output, buffer);
+
+                ParentServer.Metrics.Record(HttpServerPhase.Compression, start);
             }
+
+            ParentServer.Metrics.CountEntityBytes(length);
         }
 
 
+        /*
+         * File data can only bypass the response buffers when the transport 
+         * writes it to the socket unmodified, so encrypted transports must 
+         * always use the buffered path
+         */
+        private bool TryGetFileSender([NotNullWhen(true)] out ITransportFileSender? sender)
+        {
+            sender = _ctx as ITransportFileSender;
+            return sender != null && !_ctx!.GetSecurityInfo().HasValue;
+        }
+
 #pragma warning restore CA2007 // Consider calling ConfigureAwait on the awaited task
 
     }
@@ -0,0 +1,85 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpDateHeader.cs 
+*
+* HttpDateHeader.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Buffers;
+using System.Threading;
+using System.Buffers.Text;
+
+namespace VNLib.Net.Http.Core.Response
+{
+    /// <summary>
+    /// Caches the encoded Date response header line. The value only has a resolution 
+    /// of one second, so it is formatted once per second by a shared timer instead 
+    /// of once per response.
+    /// </summary>
+    internal static class HttpDateHeader
+    {
+        //"Date: " + rfc1123 date (always 29 chars) + CRLF
+        private const int LineSize = 6 + 29 + 2;
+
+        private static byte[] _current = Format(DateTimeOffset.UtcNow);
+        private static readonly Timer _timer = CreateTimer();
+
+        /// <summary>
+        /// Gets the current ascii encoded Date header line, including the trailing CRLF
+        /// </summary>
+        public static ReadOnlySpan<byte> Current => Volatile.Read(ref _current);
+
+        private static Timer CreateTimer()
+        {
+            /*
+             * The timer is created lazily by the first response, do not capture 
+             * that request's execution context for the lifetime of the process
+             */
+            using (ExecutionContext.SuppressFlow())
+            {
+                return new Timer(static _ => Update(), null, GetNextTickDelay(), Timeout.InfiniteTimeSpan);
+            }
+        }
+
+        private static void Update()
+        {
+            Volatile.Write(ref _current, Format(DateTimeOffset.UtcNow));
+
+            //Reschedule each tick so the update stays aligned to the second boundary
+            _timer.Change(GetNextTickDelay(), Timeout.InfiniteTimeSpan);
+        }
+
+        private static TimeSpan GetNextTickDelay() => TimeSpan.FromMilliseconds(1000 - DateTimeOffset.UtcNow.Millisecond);
+
+        private static byte[] Format(DateTimeOffset now)
+        {
+            byte[] line = new byte[LineSize];
+
+            "Date: "u8.CopyTo(line);
+
+            Utf8Formatter.TryFormat(now, line.AsSpan(6), out int written, new StandardFormat('R'));
+
+            "\r\n"u8.CopyTo(line.AsSpan(6 + written));
+
+            return line;
+        }
+    }
+}
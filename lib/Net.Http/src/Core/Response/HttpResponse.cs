@@ -25,6 +25,7 @@
 using System;
 using System.IO;
 using System.Net;
+using System.Buffers;
 using System.Threading;
 using System.Diagnostics;
 using System.Threading.Tasks;
@@ -35,6 +36,7 @@ using VNLib.Utils;
 using VNLib.Utils.IO;
 using VNLib.Utils.Memory;
 using VNLib.Utils.Extensions;
+using VNLib.Net.Http.Core.Http2;
 using VNLib.Net.Http.Core.Buffering;
 
 namespace VNLib.Net.Http.Core.Response
@@ -49,11 +51,20 @@ namespace VNLib.Net.Http.Core.Response
         private readonly Dictionary<string, HttpResponseCookie> Cookies = new(DefaultCookieCapacity, StringComparer.OrdinalIgnoreCase);
         private readonly DirectStream ReusableDirectStream = new();
         private readonly ChunkedStream ReusableChunkedStream = new(manager.ChunkAccumulatorBuffer, ContextInfo);
-        private readonly HeaderDataAccumulator Writer = new(manager.ResponseHeaderBuffer, ContextInfo);
+        private HeaderDataAccumulator Writer = new(manager.ResponseHeaderBuffer, ContextInfo, false);
+
+        //Set when the response is sent on an HTTP/2 stream
+        private Http2Stream? _h2;
+
+        //Set when the transport exposes its send buffer
+        private IBufferWriter<byte>? _sendBuffer;
 
         private int _headerWriterPosition;
 
-        private bool HeadersSent;
+        /// <summary>
+        /// Gets a value that indicates if the header block has been written to the transport
+        /// </summary>
+        internal bool HeadersSent { get; private set; }
         private bool HeadersBegun;
 
         private HttpStatusCode _code;
@@ -61,7 +72,7 @@ namespace VNLib.Net.Http.Core.Response
         /// <summary>
         /// Response header collection
         /// </summary>
-        public readonly VnWebHeaderCollection Headers = [];
+        public readonly ResponseHeaderTable Headers = new();
 
         /// <summary>
         /// The current http status code value
@@ -98,64 +109,49 @@ namespace VNLib.Net.Http.Core.Response
         public void FlushHeaders()
         {
             Check();
+            WriteHeaderLines();
+            WriteCookies();
+        }
 
-            //Get a fresh writer to buffer character data
-            ForwardOnlyWriter<char> writer = Writer.GetWriter();
-
-            //If headers havent been sent yet, start with status line
+        private void WriteHeaderLines()
+        {
+            //If headers havent been sent yet, start with the pre-encoded status line and cached date
             if (!HeadersBegun)
             {
-                //write status code first
-                writer.AppendSmall(HttpHelpers.GetResponseString(ContextInfo.CurrentVersion, _code));
-                writer.AppendSmall(HttpHelpers.CRLF);
-
-                //Write the date to header buffer
-                writer.AppendSmall("Date: ");
-                writer.Append(DateTimeOffset.UtcNow, "R");
-                writer.AppendSmall(HttpHelpers.CRLF);
+                Writer.WriteStatusLine(_code, ref _headerWriterPosition);
 
                 //Set begun flag
                 HeadersBegun = true;
             }
 
-            //Write headers
-            for (int i = 0; i < Headers.Count; i++)
-            {
-                //<name>: <value>\r\n
-                writer.Append(Headers.Keys[i]);
-                writer.AppendSmall(": ");
-                writer.Append(Headers[i]);
-                writer.AppendSmall(HttpHelpers.CRLF);
-            }
+            //Write headers directly to the accumulator, <name>: <value>\r\n
+            Headers.WriteTo(in Writer, ref _headerWriterPosition);
 
             //Remove writen headers
             Headers.Clear();
+        }
 
+        private void WriteCookies()
+        {
             //Write cookies if any are set
             if (Cookies.Count > 0)
             {
                 foreach (HttpResponseCookie cookie in Cookies.Values)
                 {
-                    writer.AppendSmall("Set-Cookie: ");
+                    //Cookies are compiled as characters first, then encoded after the pre-encoded name
+                    ForwardOnlyWriter<char> writer = Writer.GetWriter();
 
-                    //Write the cookie to the header buffer
                     cookie.Compile(ref writer);
 
-                    writer.AppendSmall(HttpHelpers.CRLF);
+                    Writer.WriteHeader(HttpResponseHeader.SetCookie, writer.AsSpan(), ref _headerWriterPosition);
                 }
                 
                 Cookies.Clear();
             }
-
-            //Commit headers
-            Writer.CommitChars(ref writer, ref _headerWriterPosition);
         }
 
-        private ValueTask EndFlushHeadersAsync()
+        private ValueTask EndFlushHeadersAsync(long bodyLength)
         {
-            //Sent all available headers
-            FlushHeaders();
-
             //Last line to end headers
             Writer.WriteTermination(ref _headerWriterPosition);
 
@@ -165,6 +161,23 @@ namespace VNLib.Net.Http.Core.Response
             //Update sent headers
             HeadersSent = true;
 
+            //The header block is sent in a HEADERS frame, which ends the stream if there is no body
+            if (_h2 != null)
+            {
+                return _h2.WriteHeadersAsync(responseBlock, bodyLength);
+            }
+
+            /*
+             * The header block is copied into the transport's send buffer without 
+             * being sent, it is published along with the first block of entity data
+             * or when the transport is flushed at the end of the request
+             */
+            if (_sendBuffer != null)
+            {
+                _sendBuffer.Write(responseBlock.Span);
+                return ValueTask.CompletedTask;
+            }
+
             //Get the transport stream to write the response data to
             Stream transport = ContextInfo.GetTransport();
 
@@ -183,25 +196,40 @@ namespace VNLib.Net.Http.Core.Response
         /// </summary>
         /// <param name="contentLength">The optional content length if set, <![CDATA[ < 0]]> for chunked responses</param>
         /// <returns>A value task that completes when header data has been made available to the transport</returns>
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public ValueTask CompleteHeadersAsync(long contentLength)
         {
             Check();
 
+            /*
+             * The framing header is written directly after the remaining headers, 
+             * so remove any value the user may have set to avoid sending it twice
+             */
             if (contentLength < 0)
             {
-                //Add chunked header
-                Headers.Set(HttpResponseHeader.TransferEncoding, "chunked");
+                Headers.Remove(HttpResponseHeader.TransferEncoding);
+
+                WriteHeaderLines();
 
+                //Add chunked header, HTTP/2 frames the body itself
+                if (_h2 == null)
+                {
+                    Writer.WriteBytes(HttpHelpers.GetResponseHeaderName(HttpResponseHeader.TransferEncoding), ref _headerWriterPosition);
+                    Writer.WriteBytes("chunked\r\n"u8, ref _headerWriterPosition);
+                }
             }
             else
             {
-                //Add content length header
-                Headers.Set(HttpResponseHeader.ContentLength, contentLength.ToString());
+                Headers.Remove(HttpResponseHeader.ContentLength);
+
+                WriteHeaderLines();
+
+                //Add content length header, formatted without allocating a string
+                Writer.WriteHeader(HttpResponseHeader.ContentLength, contentLength, ref _headerWriterPosition);
             }
 
-            //Flush headers
-            return EndFlushHeadersAsync();
+            WriteCookies();
+
+            return EndFlushHeadersAsync(contentLength);
         }
 
         /// <summary>
@@ -216,6 +244,18 @@ namespace VNLib.Net.Http.Core.Response
             return ReusableDirectStream;
         }
 
+        /// <summary>
+        /// Gets a response writer that writes data directly into the transport's send buffer
+        /// </summary>
+        /// <param name="blockSize">The minimum size of the send buffer blocks to request</param>
+        /// <returns>The <see cref="IResponseDataWriter"/> instance, or null if the transport does not expose its send buffer</returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public IResponseDataWriter? GetSendBufferWriter(int blockSize)
+        {
+            Debug.Assert(HeadersSent, "A call to send buffer capture was made before the headers were flushed to the transport");
+            return ReusableDirectStream.GetSendBufferWriter(blockSize);
+        }
+
         /// <summary>
         /// Gets a response writer for writing chunked data to the transport stream
         /// </summary>
@@ -223,8 +263,8 @@ namespace VNLib.Net.Http.Core.Response
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public IResponseDataWriter GetChunkWriter()
         {
-            //Chunking is only an http 1.1 feature (should never get called otherwise)
-            Debug.Assert(ContextInfo.CurrentVersion == HttpVersion.Http11, "Chunked response handler was requested, but is not an HTTP/1.1 response");
+            //Chunking is only an http 1.1 feature, HTTP/2 streams send the accumulated data as frames (should never get called otherwise)
+            Debug.Assert(ContextInfo.CurrentVersion == HttpVersion.Http11 || _h2 != null, "Chunked response handler was requested, but is not an HTTP/1.1 or HTTP/2 response");
             Debug.Assert(HeadersSent, "Chunk write was requested but header data has not been sent");
 
             return ReusableChunkedStream;
@@ -250,8 +290,20 @@ namespace VNLib.Net.Http.Core.Response
         {
             Check();
 
-            //Send a status message with the continue response status
-            Writer.WriteToken(HttpHelpers.GetResponseString(ContextInfo.CurrentVersion, HttpStatusCode.Continue), ref _headerWriterPosition);
+            //Interim responses are a header block that does not end the stream
+            if (_h2 != null)
+            {
+                Writer.WriteStatusLine(HttpStatusCode.Continue, ref _headerWriterPosition);
+
+                Memory<byte> block = Writer.GetResponseData(_headerWriterPosition);
+                _headerWriterPosition = 0;
+
+                await _h2.WriteHeadersAsync(block, -1);
+                return;
+            }
+
+            //Send a status message with the continue response status, the status line includes its CRLF
+            Writer.WriteBytes(HttpHelpers.GetResponseStatusLine(ContextInfo.CurrentVersion, HttpStatusCode.Continue), ref _headerWriterPosition);
 
             //Trailing crlf
             Writer.WriteTermination(ref _headerWriterPosition);
@@ -282,8 +334,11 @@ namespace VNLib.Net.Http.Core.Response
             //If headers haven't been sent yet, send them and there must be no content
             if (!HeadersSent)
             {
+                //Sent all available headers
+                FlushHeaders();
+
                 //Finalize headers
-                return EndFlushHeadersAsync();
+                return EndFlushHeadersAsync(0);
             }
 
             return ValueTask.CompletedTask;
@@ -300,13 +355,21 @@ namespace VNLib.Net.Http.Core.Response
         {
             ReusableChunkedStream.OnRelease();
             ReusableDirectStream.OnRelease();
+            _h2 = null;
+            _sendBuffer = null;
             Cookies.TrimExcess(DefaultCookieCapacity);
+            Headers.TrimExcess();
         }
 
         ///<inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public void OnNewConnection(Stream transport)
         {
+            //HTTP/2 streams are the transport of the contexts they are paired with
+            _h2 = transport as Http2Stream;
+            _sendBuffer = transport as IBufferWriter<byte>;
+            Writer = new(manager.ResponseHeaderBuffer, ContextInfo, _h2 != null);
+
             ReusableChunkedStream.OnNewConnection(transport);
             ReusableDirectStream.OnNewConnection(transport);
         }
@@ -340,10 +403,32 @@ namespace VNLib.Net.Http.Core.Response
             ReusableChunkedStream.OnComplete();
         }
 
-        private sealed class DirectStream : ReusableResponseStream, IDirectResponsWriter
+        private sealed class DirectStream : ReusableResponseStream, IDirectResponsWriter, IResponseDataWriter
         {
+            private int _blockSize;
+
+            public IResponseDataWriter? GetSendBufferWriter(int blockSize)
+            {
+                _blockSize = blockSize;
+                return sendBuffer != null ? this : null;
+            }
+
             ///<inheritdoc/>
             public ValueTask WriteAsync(ReadOnlyMemory<byte> buffer) => transport!.WriteAsync(buffer);
+
+            ///<inheritdoc/>
+            public Memory<byte> GetMemory() => sendBuffer!.GetMemory(_blockSize);
+
+            ///<inheritdoc/>
+            public int Advance(int written)
+            {
+                //Data is not accumulated, every committed block must be flushed
+                sendBuffer!.Advance(written);
+                return 0;
+            }
+
+            ///<inheritdoc/>
+            public ValueTask FlushAsync(bool isFinal) => new(transport!.FlushAsync());
         }
 
         /// <summary>
@@ -359,20 +444,72 @@ namespace VNLib.Net.Http.Core.Response
              */
             private int _accumulatedBytes;
 
+            /*
+             * The send buffer block the current chunk is being written 
+             * to when chunks are written directly to the transport
+             */
+            private Memory<byte> _directChunk;
+
+            private Http2Stream? _h2;
+
             #region Hooks
 
             ///<inheritdoc/>
-            public void OnComplete() => _accumulatedBytes = 0;
+            public override void OnNewConnection(Stream transport)
+            {
+                base.OnNewConnection(transport);
+                _h2 = transport as Http2Stream;
+            }
+
+            ///<inheritdoc/>
+            public override void OnRelease()
+            {
+                base.OnRelease();
+                _h2 = null;
+            }
 
             ///<inheritdoc/>
-            public Memory<byte> GetMemory() => _chunkAccumulator.GetRemainingSegment(_accumulatedBytes);
+            public void OnComplete()
+            {
+                _accumulatedBytes = 0;
+                _directChunk = default;
+            }
+
+            //Chunks are framed in place when the transport exposes its send buffer
+            private bool IsDirect => sendBuffer != null;
+
+            ///<inheritdoc/>
+            public Memory<byte> GetMemory()
+            {
+                if (IsDirect)
+                {
+                    return _chunkAccumulator.GetDirectRemainingSegment(GetDirectChunk(), _accumulatedBytes);
+                }
+
+                return _chunkAccumulator.GetRemainingSegment(_accumulatedBytes);
+            }
 
             ///<inheritdoc/>
             public int Advance(int written)
             {
                 //Advance the accumulator
                 _accumulatedBytes += written;
-                return _chunkAccumulator.GetRemainingSegmentSize(_accumulatedBytes);
+
+                return IsDirect
+                    ? _chunkAccumulator.GetDirectRemainingSegmentSize(_accumulatedBytes)
+                    : _chunkAccumulator.GetRemainingSegmentSize(_accumulatedBytes);
+            }
+
+            private Memory<byte> GetDirectChunk()
+            {
+                //Chunk blocks are always the full accumulator size so the chunk size prefix width is fixed
+                if (_directChunk.IsEmpty)
+                {
+                    int size = _chunkAccumulator.DirectChunkSize;
+                    _directChunk = sendBuffer!.GetMemory(size)[..size];
+                }
+
+                return _directChunk;
             }
 
             ///<inheritdoc/>
@@ -383,6 +520,28 @@ namespace VNLib.Net.Http.Core.Response
                  * write the final termination sequence to the transport.
                  */
 
+                //HTTP/2 frames the data itself, the final flush ends the stream
+                if (_h2 != null)
+                {
+                    Memory<byte> data = _chunkAccumulator.GetData(_accumulatedBytes);
+                    _accumulatedBytes = 0;
+
+                    return _h2.WriteDataAsync(data, isFinal);
+                }
+
+                //Frame the chunk in place and publish it
+                if (IsDirect)
+                {
+                    int chunkSize = _chunkAccumulator.CompleteDirectChunk(GetDirectChunk().Span, _accumulatedBytes, isFinal);
+                    
+                    sendBuffer!.Advance(chunkSize);
+
+                    _accumulatedBytes = 0;
+                    _directChunk = default;
+
+                    return new(transport!.FlushAsync());
+                }
+
                 Memory<byte> chunkData = _chunkAccumulator.GetChunkData(_accumulatedBytes, isFinal);
 
                 //Reset accumulator now that we captured the final chunk
@@ -422,11 +581,11 @@ namespace VNLib.Net.Http.Core.Response
             writer.Append(HttpHelpers.CRLF);
 
             //Write headers
-            for (int i = 0; i < Headers.Count; i++)
+            foreach (KeyValuePair<string, string> header in Headers)
             {
-                writer.Append(Headers.Keys[i]);     //Write header key
+                writer.Append(header.Key);          //Write header key
                 writer.Append(": ");           //Write separator
-                writer.Append(Headers[i]);          //Write the header value
+                writer.Append(header.Value);        //Write the header value
                 writer.Append(HttpHelpers.CRLF);    //Crlf
             }
 
@@ -0,0 +1,301 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: ResponseHeaderTable.cs 
+*
+* ResponseHeaderTable.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Net;
+using System.Buffers;
+using System.Numerics;
+using System.Collections;
+using System.Collections.Generic;
+
+namespace VNLib.Net.Http.Core.Response
+{
+    /// <summary>
+    /// Stores response headers before they are written. Well known headers are stored 
+    /// in a fixed slot by their <see cref="HttpResponseHeader"/> value and are written 
+    /// with pre-encoded names, all other headers are stored by name in an overflow list.
+    /// </summary>
+    /// <remarks>
+    /// Names and values are validated the same way <see cref="WebHeaderCollection"/> 
+    /// validates them, so user values cannot inject header lines.
+    /// </remarks>
+    internal sealed class ResponseHeaderTable : IEnumerable<KeyValuePair<string, string>>
+    {
+        private const int KnownHeaderCount = (int)HttpResponseHeader.WwwAuthenticate + 1;
+        private const int DefaultCustomCapacity = 8;
+
+        /*
+         * RFC 7230 token characters for header names, and the 
+         * characters trimmed from values by WebHeaderCollection
+         */
+        private static readonly SearchValues<char> TokenChars = SearchValues.Create("!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~");
+        private static readonly char[] TrimChars = ['\t', '\n', '\v', '\f', '\r', ' '];
+
+        private readonly string?[] _known = new string?[KnownHeaderCount];
+        private readonly List<KeyValuePair<string, string>> _custom = new(DefaultCustomCapacity);
+
+        //Bit per known header slot that is currently set
+        private uint _setMask;
+
+        /// <summary>
+        /// The number of unique headers stored
+        /// </summary>
+        public int Count => BitOperations.PopCount(_setMask) + _custom.Count;
+
+        /// <summary>
+        /// Gets or sets the value of a well known response header
+        /// </summary>
+        /// <param name="header">The response header</param>
+        /// <returns>The header value if set, null otherwise</returns>
+        /// <exception cref="ArgumentException"></exception>
+        public string? this[HttpResponseHeader header]
+        {
+            get => _known[(int)header];
+            set => Set(header, value);
+        }
+
+        /// <summary>
+        /// Gets or sets the value of a response header by its name
+        /// </summary>
+        /// <param name="name">The header name</param>
+        /// <returns>The header value if set, null otherwise</returns>
+        /// <exception cref="ArgumentException"></exception>
+        public string? this[string name]
+        {
+            get
+            {
+                if (HttpHelpers.TryGetResponseHeader(name, out HttpResponseHeader known))
+                {
+                    return _known[(int)known];
+                }
+
+                int index = IndexOf(name);
+                return index < 0 ? null : _custom[index].Value;
+            }
+            set => Set(name, value);
+        }
+
+        /// <summary>
+        /// Sets the value of a well known header, replacing the current value
+        /// </summary>
+        /// <param name="header">The response header</param>
+        /// <param name="value">The header value</param>
+        /// <exception cref="ArgumentException"></exception>
+        public void Set(HttpResponseHeader header, string? value)
+        {
+            _known[(int)header] = CheckValue(value);
+            _setMask |= 1u << (int)header;
+        }
+
+        /// <summary>
+        /// Appends a value to a well known header as a comma separated list
+        /// </summary>
+        /// <param name="header">The response header</param>
+        /// <param name="value">The header value to append</param>
+        /// <exception cref="ArgumentException"></exception>
+        public void Add(HttpResponseHeader header, string? value)
+        {
+            value = CheckValue(value);
+
+            string? current = _known[(int)header];
+
+            _known[(int)header] = current == null ? value : $"{current},{value}";
+            _setMask |= 1u << (int)header;
+        }
+
+        /// <summary>
+        /// Sets the value of a header by its name, replacing the current value
+        /// </summary>
+        /// <param name="name">The header name</param>
+        /// <param name="value">The header value</param>
+        /// <exception cref="ArgumentException"></exception>
+        public void Set(string name, string? value)
+        {
+            if (HttpHelpers.TryGetResponseHeader(name, out HttpResponseHeader known))
+            {
+                Set(known, value);
+                return;
+            }
+
+            CheckName(name);
+            value = CheckValue(value);
+
+            int index = IndexOf(name);
+
+            if (index < 0)
+            {
+                _custom.Add(new(name, value));
+            }
+            else
+            {
+                _custom[index] = new(_custom[index].Key, value);
+            }
+        }
+
+        /// <summary>
+        /// Appends a value to a header by its name as a comma separated list
+        /// </summary>
+        /// <param name="name">The header name</param>
+        /// <param name="value">The header value to append</param>
+        /// <exception cref="ArgumentException"></exception>
+        public void Add(string name, string? value)
+        {
+            if (HttpHelpers.TryGetResponseHeader(name, out HttpResponseHeader known))
+            {
+                Add(known, value);
+                return;
+            }
+
+            CheckName(name);
+            value = CheckValue(value);
+
+            int index = IndexOf(name);
+
+            if (index < 0)
+            {
+                _custom.Add(new(name, value));
+            }
+            else
+            {
+                _custom[index] = new(_custom[index].Key, $"{_custom[index].Value},{value}");
+            }
+        }
+
+        /// <summary>
+        /// Removes a well known header if it is set
+        /// </summary>
+        /// <param name="header">The response header to remove</param>
+        public void Remove(HttpResponseHeader header)
+        {
+            _known[(int)header] = null;
+            _setMask &= ~(1u << (int)header);
+        }
+
+        /// <summary>
+        /// Removes all stored headers
+        /// </summary>
+        public void Clear()
+        {
+            for (uint mask = _setMask; mask != 0; mask &= mask - 1)
+            {
+                _known[BitOperations.TrailingZeroCount(mask)] = null;
+            }
+
+            _setMask = 0;
+            _custom.Clear();
+        }
+
+        /// <summary>
+        /// Releases the memory held by the overflow list if it grew past its default size
+        /// </summary>
+        public void TrimExcess()
+        {
+            if (_custom.Capacity > DefaultCustomCapacity)
+            {
+                _custom.Capacity = DefaultCustomCapacity;
+            }
+        }
+
+        /// <summary>
+        /// Writes all stored headers to the header accumulator, well known 
+        /// headers are written with their pre-encoded names
+        /// </summary>
+        /// <param name="writer">The header accumulator to write to</param>
+        /// <param name="accumulatedSize">A reference to the cumulative number of bytes written to the buffer</param>
+        public void WriteTo(in HeaderDataAccumulator writer, ref int accumulatedSize)
+        {
+            for (uint mask = _setMask; mask != 0; mask &= mask - 1)
+            {
+                int index = BitOperations.TrailingZeroCount(mask);
+                writer.WriteHeader((HttpResponseHeader)index, _known[index], ref accumulatedSize);
+            }
+
+            for (int i = 0; i < _custom.Count; i++)
+            {
+                writer.WriteHeader(_custom[i].Key, _custom[i].Value, ref accumulatedSize);
+            }
+        }
+
+        ///<inheritdoc/>
+        public IEnumerator<KeyValuePair<string, string>> GetEnumerator()
+        {
+            for (uint mask = _setMask; mask != 0; mask &= mask - 1)
+            {
+                int index = BitOperations.TrailingZeroCount(mask);
+                yield return new(HttpHelpers.GetResponseHeaderString((HttpResponseHeader)index), _known[index]!);
+            }
+
+            for (int i = 0; i < _custom.Count; i++)
+            {
+                yield return _custom[i];
+            }
+        }
+
+        IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+
+        private int IndexOf(string name)
+        {
+            for (int i = 0; i < _custom.Count; i++)
+            {
+                if (string.Equals(_custom[i].Key, name, StringComparison.OrdinalIgnoreCase))
+                {
+                    return i;
+                }
+            }
+
+            return -1;
+        }
+
+        private static void CheckName(string name)
+        {
+            ArgumentException.ThrowIfNullOrWhiteSpace(name);
+
+            if (name.AsSpan().ContainsAnyExcept(TokenChars))
+            {
+                throw new ArgumentException("The header name contains invalid characters", nameof(name));
+            }
+        }
+
+        private static string CheckValue(string? value)
+        {
+            if (string.IsNullOrEmpty(value))
+            {
+                return string.Empty;
+            }
+
+            value = value.Trim(TrimChars);
+
+            //Control characters other than tab would allow a value to break out of its header line
+            foreach (char c in value)
+            {
+                if (c == 127 || (c < ' ' && c != '\t'))
+                {
+                    throw new ArgumentException("The header value contains invalid control characters", nameof(value));
+                }
+            }
+
+            return value;
+        }
+    }
+}
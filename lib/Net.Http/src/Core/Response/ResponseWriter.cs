@@ -31,6 +31,7 @@
 
 using System;
 using System.IO;
+using System.Threading;
 using System.Diagnostics;
 using System.Threading.Tasks;
 using System.Runtime.CompilerServices;
@@ -53,6 +54,12 @@ namespace VNLib.Net.Http.Core.Response
         ///<inheritdoc/>
         public long Length => _userState.Legnth;
 
+        /// <summary>
+        /// Gets the response entity as a file region if it can be sent 
+        /// directly by the transport, null otherwise
+        /// </summary>
+        public IHttpFileRegionResponse? FileRegion => _userState.Stream as IHttpFileRegionResponse;
+
         /// <summary>
         /// Attempts to set the response body as a stream
         /// </summary>
@@ -131,6 +138,50 @@ namespace VNLib.Net.Http.Core.Response
         ///<inheritdoc/>
         public Task WriteEntityAsync(IDirectResponsWriter dest, Memory<byte> buffer) => WriteEntityAsync(dest, buffer, 0);
 
+        /// <summary>
+        /// Sends the file region response entity directly from its file handle
+        /// </summary>
+        /// <param name="sender">The transport that sends the file data</param>
+        /// <returns>A task that resolves when the response is completed</returns>
+        public async Task WriteFileRegionAsync(ITransportFileSender sender)
+        {
+            IHttpFileRegionResponse region = FileRegion!;
+
+            Debug.Assert(region != null, "File region was requested but the response is not a file region");
+
+            try
+            {
+                await sender.SendFileAsync(region.FileHandle, region.FileOffset, _userState.Legnth, CancellationToken.None);
+            }
+            finally
+            {
+                //The transport no longer uses the handle, even if the send failed
+                await region.DisposeAsync();
+            }
+        }
+
+        /// <summary>
+        /// Writes the stream response entity by reading it directly into the 
+        /// memory of the writer, so it does not need to be copied again
+        /// </summary>
+        /// <param name="dest">The writer to read the stream data into</param>
+        /// <returns>A task that resolves when the response is completed</returns>
+        public async Task WriteStreamEntityAsync(IResponseDataWriter dest)
+        {
+            Debug.Assert(_userState.MemResponse == null, "Memory responses cannot be written as stream data");
+
+            if (_userState.RawStream != null)
+            {
+                await ProcessStreamDataAsync(_userState.GetRawStreamResponse(), dest, _userState.Legnth);
+            }
+            else
+            {
+                Debug.Assert(_userState.Stream != null, "Stream value is null, illegal state");
+
+                await ProcessStreamDataAsync(_userState.Stream, dest, _userState.Legnth);
+            }
+        }
+
         ///<inheritdoc/>        
         public async Task WriteEntityAsync<TComp>(TComp compressor, IResponseDataWriter writer, Memory<byte> buffer) 
             where TComp : IResponseCompressor
@@ -266,6 +317,34 @@ namespace VNLib.Net.Http.Core.Response
             await stream.DisposeAsync();
         }
         
+        private static async Task ProcessStreamDataAsync<TStream>(TStream stream, IResponseDataWriter dest, long length)
+            where TStream : IHttpStreamResponse
+        {
+            long sentBytes = 0;
+            do
+            {
+                Memory<byte> offset = ClampCopyBuffer(dest.GetMemory(), length, sentBytes);
+
+                //read only the amount of data that is required
+                int read = await stream.ReadAsync(offset);
+
+                if (read == 0)
+                {
+                    break;
+                }
+
+                //Commit the data that was read and publish it
+                dest.Advance(read);
+                await dest.FlushAsync(false);
+
+                sentBytes += read;
+
+            } while (sentBytes < length);
+
+            //Try to dispose the response stream asyncrhonously since we are done with it
+            await stream.DisposeAsync();
+        }
+
         private static Memory<byte> ClampCopyBuffer(Memory<byte> buffer, long contentLength, long sentBytes)
         {
             //get offset wrapper of the total buffer or remaining count
@@ -23,6 +23,7 @@
 */
 
 using System.IO;
+using System.Buffers;
 
 namespace VNLib.Net.Http.Core.Response
 {
@@ -31,16 +32,30 @@ namespace VNLib.Net.Http.Core.Response
     {
         protected Stream? transport;
 
+        /// <summary>
+        /// The transport's send buffer if it exposes one, data written to it is 
+        /// published by flushing the transport
+        /// </summary>
+        protected IBufferWriter<byte>? sendBuffer;
+
         /// <summary>
         /// Called when a new connection is established
         /// </summary>
         /// <param name="transport"></param>
-        public virtual void OnNewConnection(Stream transport) => this.transport = transport;
+        public virtual void OnNewConnection(Stream transport)
+        {
+            this.transport = transport;
+            sendBuffer = transport as IBufferWriter<byte>;
+        }
 
         /// <summary>
         /// Called when the connection is released
         /// </summary>
-        public virtual void OnRelease() => transport = null;
+        public virtual void OnRelease()
+        {
+            transport = null;
+            sendBuffer = null;
+        }
 
     }
 }
\ No newline at end of file
@@ -26,12 +26,14 @@ using System;
 using System.Net;
 using System.Collections.Generic;
 
+using VNLib.Net.Http.Core.Response;
+
 namespace VNLib.Net.Http.Core
 {
     internal sealed class VnHeaderCollection : IHeaderCollection
     {
-        private VnWebHeaderCollection _RequestHeaders;
-        private VnWebHeaderCollection _ResponseHeaders;
+        private RequestHeaderTable _RequestHeaders;
+        private ResponseHeaderTable _ResponseHeaders;
 
 
         IEnumerable<KeyValuePair<string, string>> IHeaderCollection.RequestHeaders => _RequestHeaders!;
@@ -0,0 +1,199 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpByteLookups.cs 
+*
+* HttpByteLookups.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Net;
+using System.Linq;
+using System.Text;
+using System.Collections.Generic;
+
+namespace VNLib.Net.Http
+{
+    public static partial class HttpHelpers
+    {
+        /*
+         * Byte level lookup tables for the request parser. Known tokens are 
+         * bucketed by length and compared as ascii without case, so request 
+         * methods, versions and header names never need to be decoded to 
+         * characters or hashed.
+         * 
+         * The response side holds pre-encoded status lines and header names
+         * so response headers can be written to the transport buffer without
+         * going through a char buffer.
+         * 
+         * The tables live in a nested class because static initializer order 
+         * across partial class files is undefined, and the tables are built
+         * from the header name tables and the status code strings.
+         */
+        private static class ByteTokens
+        {
+            public static readonly KnownToken<HttpMethod>[][] Methods = BucketTokens(
+                Enum.GetValues<HttpMethod>()
+                    .Except([HttpMethod.None])
+                    .Select(static m => (m.ToString(), m))
+            );
+
+            public static readonly KnownToken<HttpRequestHeader>[][] RequestHeaders = BucketTokens(
+                RequestHeaderLookup.Select(static kv => (kv.Key, kv.Value))
+            );
+
+            public static readonly byte[][] Http09StatusLines = EncodeStatusLines(HttpVersion.Http09);
+            public static readonly byte[][] Http1StatusLines = EncodeStatusLines(HttpVersion.Http1);
+            public static readonly byte[][] Http11StatusLines = EncodeStatusLines(HttpVersion.Http11);
+            public static readonly byte[][] Http2StatusLines = EncodeStatusLines(HttpVersion.Http2);
+
+            /*
+             * Header names followed by the ": " separator, indexed by the 
+             * HttpResponseHeader enum value
+             */
+            public static readonly byte[][] ResponseHeaderNames = HttpHelpers.ResponseHeaderNames
+                .Select(static n => Encoding.ASCII.GetBytes($"{n}: "))
+                .ToArray();
+        }
+
+        /*
+         * Status lines are stored by the status code offset from 100 and 
+         * include the trailing CRLF
+         */
+        private static byte[][] EncodeStatusLines(HttpVersion version)
+        {
+            byte[][] lines = new byte[500][];
+
+            foreach (HttpStatusCode code in Enum.GetValues<HttpStatusCode>())
+            {
+                lines[(int)code - 100] = Encoding.ASCII.GetBytes(GetResponseString(version, code) + CRLF);
+            }
+
+            return lines;
+        }
+
+        private static KnownToken<T>[][] BucketTokens<T>(IEnumerable<(string name, T value)> tokens)
+        {
+            (string name, T value)[] all = tokens.ToArray();
+
+            KnownToken<T>[][] buckets = new KnownToken<T>[all.Max(static t => t.name.Length) + 1][];
+
+            for (int i = 0; i < buckets.Length; i++)
+            {
+                buckets[i] = all.Where(t => t.name.Length == i)
+                    .Select(static t => new KnownToken<T>(Encoding.ASCII.GetBytes(t.name), t.value))
+                    .ToArray();
+            }
+
+            return buckets;
+        }
+
+        private static bool TryGetToken<T>(KnownToken<T>[][] buckets, ReadOnlySpan<byte> name, out T value)
+        {
+            if (name.Length < buckets.Length)
+            {
+                foreach (KnownToken<T> token in buckets[name.Length])
+                {
+                    if (Ascii.EqualsIgnoreCase(name, token.Name))
+                    {
+                        value = token.Value;
+                        return true;
+                    }
+                }
+            }
+
+            value = default!;
+            return false;
+        }
+
+        /// <summary>
+        /// Gets the request method from its ascii encoded token
+        /// </summary>
+        /// <param name="method">The ascii request method token</param>
+        /// <returns>Request method, <see cref="HttpMethod.None"/> if method is malformatted or unsupported</returns>
+        internal static HttpMethod GetRequestMethod(ReadOnlySpan<byte> method)
+            => TryGetToken(ByteTokens.Methods, method, out HttpMethod m) ? m : HttpMethod.None;
+
+        /// <summary>
+        /// Performs a lookup of the ascii encoded header name to get the <see cref="HttpRequestHeader"/> enum value
+        /// </summary>
+        /// <param name="requestHeaderName">The ascii header name</param>
+        /// <returns>The <see cref="HttpRequestHeader"/> enum value of the header, or 255 if not found</returns>
+        internal static HttpRequestHeader GetRequestHeaderEnumFromValue(ReadOnlySpan<byte> requestHeaderName)
+            => TryGetToken(ByteTokens.RequestHeaders, requestHeaderName, out HttpRequestHeader h) ? h : (HttpRequestHeader)255;
+
+        /// <summary>
+        /// Gets the <see cref="HttpVersion"/> enum value from the ascii version token
+        /// </summary>
+        /// <param name="httpVersion">The ascii http version token</param>
+        /// <returns>The <see cref="HttpVersion"/> enum value, or <see cref="HttpVersion.None"/> if the version is not supported</returns>
+        internal static HttpVersion ParseHttpVersion(ReadOnlySpan<byte> httpVersion)
+        {
+            //Versions are always HTTP/x.y
+            if (httpVersion.Length != 8 || !Ascii.EqualsIgnoreCase(httpVersion[..5], "HTTP/"u8) || httpVersion[6] != '.')
+            {
+                return HttpVersion.None;
+            }
+
+            return (httpVersion[5], httpVersion[7]) switch
+            {
+                ((byte)'1', (byte)'1') => HttpVersion.Http11,
+                ((byte)'1', (byte)'0') => HttpVersion.Http1,
+                ((byte)'2', (byte)'0') => HttpVersion.Http2,
+                ((byte)'0', (byte)'9') => HttpVersion.Http09,
+                _ => HttpVersion.None
+            };
+        }
+
+        /// <summary>
+        /// Gets the pre-encoded response status line for the version and status code, 
+        /// including the trailing CRLF
+        /// </summary>
+        /// <param name="version">The response http version</param>
+        /// <param name="code">The response status code</param>
+        /// <returns>The ascii encoded status line</returns>
+        /// <exception cref="KeyNotFoundException"></exception>
+        internal static ReadOnlySpan<byte> GetResponseStatusLine(HttpVersion version, HttpStatusCode code)
+        {
+            byte[][] lines = version switch
+            {
+                HttpVersion.Http09 => ByteTokens.Http09StatusLines,
+                HttpVersion.Http1 => ByteTokens.Http1StatusLines,
+                HttpVersion.Http2 => ByteTokens.Http2StatusLines,
+                //Default to HTTP/1.1
+                _ => ByteTokens.Http11StatusLines,
+            };
+
+            uint index = (uint)code - 100;
+
+            return index < (uint)lines.Length && lines[index] != null
+                ? lines[index]
+                : throw new KeyNotFoundException($"The status code {code} is not a known status code");
+        }
+
+        /// <summary>
+        /// Gets the ascii encoded response header name followed by the ": " separator
+        /// </summary>
+        /// <param name="header">The response header</param>
+        /// <returns>The encoded header name and separator</returns>
+        internal static ReadOnlySpan<byte> GetResponseHeaderName(HttpResponseHeader header) => ByteTokens.ResponseHeaderNames[(int)header];
+
+        private readonly record struct KnownToken<T>(byte[] Name, T Value);
+    }
+}
@@ -76,7 +76,7 @@ namespace VNLib.Net.Http
 
         private static readonly FrozenDictionary<string, HttpRequestHeader> RequestHeaderLookup = new Dictionary<string, HttpRequestHeader>(StringComparer.OrdinalIgnoreCase)
         {
-            {"CacheControl", HttpRequestHeader.CacheControl },
+            {"Cache-Control", HttpRequestHeader.CacheControl },
             {"Connection", HttpRequestHeader.Connection },
             {"Date", HttpRequestHeader.Date },
             {"Keep-Alive", HttpRequestHeader.KeepAlive },
@@ -105,12 +105,12 @@ namespace VNLib.Net.Http
             {"Expect", HttpRequestHeader.Expect },
             {"From", HttpRequestHeader.From },
             {"Host", HttpRequestHeader.Host },
-            {"IfMatch", HttpRequestHeader.IfMatch },
+            {"If-Match", HttpRequestHeader.IfMatch },
             {"If-Modified-Since", HttpRequestHeader.IfModifiedSince },
             {"If-None-Match", HttpRequestHeader.IfNoneMatch },
             {"If-Range", HttpRequestHeader.IfRange },
             {"If-Unmodified-Since", HttpRequestHeader.IfUnmodifiedSince },
-            {"MaxForwards", HttpRequestHeader.MaxForwards },
+            {"Max-Forwards", HttpRequestHeader.MaxForwards },
             {"Proxy-Authorization", HttpRequestHeader.ProxyAuthorization },
             {"Referer", HttpRequestHeader.Referer },
             {"Range", HttpRequestHeader.Range },
@@ -120,7 +120,7 @@ namespace VNLib.Net.Http
             //Custom request headers
             { "Content-Disposition", ContentDisposition },
             { "origin", Origin }
-        }.ToFrozenDictionary();
+        }.ToFrozenDictionary(StringComparer.OrdinalIgnoreCase);
 
         /*
          * Provides a lookup table for request header hashcodes (that are hashed in 
@@ -131,6 +131,30 @@ namespace VNLib.Net.Http
          */
         private static readonly FrozenDictionary<int, HttpRequestHeader> RequestHeaderHashLookup = ComputeCodeHashLookup(RequestHeaderLookup);
 
+        /*
+         * Header names indexed by their enum values, so headers stored by enum 
+         * value can be enumerated by name. Response header names match the 
+         * casing used by WebHeaderCollection.
+         */
+        private static readonly string[] RequestHeaderNames = RequestHeaderLookup
+            .Where(static kv => kv.Value <= HttpRequestHeader.UserAgent)
+            .OrderBy(static kv => kv.Value)
+            .Select(static kv => kv.Key)
+            .ToArray();
+
+        private static readonly string[] ResponseHeaderNames =
+        [
+            "Cache-Control", "Connection", "Date", "Keep-Alive", "Pragma", "Trailer", "Transfer-Encoding",
+            "Upgrade", "Via", "Warning", "Allow", "Content-Length", "Content-Type", "Content-Encoding",
+            "Content-Language", "Content-Location", "Content-MD5", "Content-Range", "Expires", "Last-Modified",
+            "Accept-Ranges", "Age", "ETag", "Location", "Proxy-Authenticate", "Retry-After", "Server",
+            "Set-Cookie", "Vary", "WWW-Authenticate"
+        ];
+
+        private static readonly FrozenDictionary<string, HttpResponseHeader> ResponseHeaderLookup = ResponseHeaderNames
+            .Select(static (name, i) => KeyValuePair.Create(name, (HttpResponseHeader)i))
+            .ToFrozenDictionary(StringComparer.OrdinalIgnoreCase);
+
         /*
          * Provides a constant lookup table for http version hashcodes to an http
          * version enum value
@@ -433,6 +457,38 @@ namespace VNLib.Net.Http
             return RequestHeaderHashLookup.GetValueOrDefault(hashcode, (HttpRequestHeader)255);
         }
 
+        /// <summary>
+        /// Gets the well known <see cref="HttpRequestHeader"/> for a header name
+        /// </summary>
+        /// <param name="headerName">The header name to find</param>
+        /// <param name="header">The request header enum value if found</param>
+        /// <returns>True if the header name is a well known request header, false otherwise</returns>
+        internal static bool TryGetRequestHeader(string headerName, out HttpRequestHeader header) 
+            => RequestHeaderLookup.TryGetValue(headerName, out header) && header <= HttpRequestHeader.UserAgent;
+
+        /// <summary>
+        /// Gets the well known <see cref="HttpResponseHeader"/> for a header name
+        /// </summary>
+        /// <param name="headerName">The header name to find</param>
+        /// <param name="header">The response header enum value if found</param>
+        /// <returns>True if the header name is a well known response header, false otherwise</returns>
+        internal static bool TryGetResponseHeader(string headerName, out HttpResponseHeader header) 
+            => ResponseHeaderLookup.TryGetValue(headerName, out header);
+
+        /// <summary>
+        /// Gets the header name of a well known request header
+        /// </summary>
+        /// <param name="header">The request header</param>
+        /// <returns>The header name</returns>
+        internal static string GetRequestHeaderString(HttpRequestHeader header) => RequestHeaderNames[(int)header];
+
+        /// <summary>
+        /// Gets the header name of a well known response header
+        /// </summary>
+        /// <param name="header">The response header</param>
+        /// <returns>The header name</returns>
+        internal static string GetResponseHeaderString(HttpResponseHeader header) => ResponseHeaderNames[(int)header];
+
         /// <summary>
         /// Gets the <see cref="HttpVersion"/> enum value from the version string
         /// </summary>
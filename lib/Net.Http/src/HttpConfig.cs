@@ -129,5 +129,17 @@ namespace VNLib.Net.Http
         /// Enables debug performance counters
         /// </summary>
         public readonly bool DebugPerformanceCounters { get; init; } = false;
+
+        /// <summary>
+        /// Enables HTTP/2 over cleartext connections for clients that open the connection with 
+        /// the HTTP/2 connection preface (prior knowledge). Connections that begin with an 
+        /// HTTP/1.x request are unaffected.
+        /// </summary>
+        public readonly bool EnableHttp2 { get; init; } = false;
+
+        /// <summary>
+        /// The maximum number of concurrent request streams allowed on a single HTTP/2 connection
+        /// </summary>
+        public readonly int Http2MaxConcurrentStreams { get; init; } = 100;
     }
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpLatencySnapshot.cs 
+*
+* HttpLatencySnapshot.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+
+using VNLib.Net.Http.Core.PerfCounter;
+
+namespace VNLib.Net.Http
+{
+    /// <summary>
+    /// A point-in-time copy of the latency histogram of an <see cref="HttpServerPhase"/>.
+    /// Values are resolved to the upper bound of their histogram bucket, which is 
+    /// within 12.5% of the recorded value.
+    /// </summary>
+    public readonly struct HttpLatencySnapshot
+    {
+        private readonly long[]? _buckets;
+        private readonly long _totalTicks;
+
+        internal HttpLatencySnapshot(long[] buckets, long count, long totalTicks)
+        {
+            _buckets = buckets;
+            _totalTicks = totalTicks;
+            Count = count;
+        }
+
+        /// <summary>
+        /// The number of recorded samples
+        /// </summary>
+        public readonly long Count { get; }
+
+        /// <summary>
+        /// The sum of all recorded durations
+        /// </summary>
+        public readonly TimeSpan Total => HttpLatencyHistogram.ToTimeSpan(_totalTicks);
+
+        /// <summary>
+        /// The mean of all recorded durations
+        /// </summary>
+        public readonly TimeSpan Mean => Count > 0 ? HttpLatencyHistogram.ToTimeSpan(_totalTicks / Count) : TimeSpan.Zero;
+
+        /// <summary>
+        /// The largest recorded duration
+        /// </summary>
+        public readonly TimeSpan Max => GetPercentile(100);
+
+        /// <summary>
+        /// Gets the duration that the given percentage of samples are less than or equal to
+        /// </summary>
+        /// <param name="percentile">The percentile to get in the range 0 to 100</param>
+        /// <returns>The duration at the given percentile, or zero if no samples were recorded</returns>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public readonly TimeSpan GetPercentile(double percentile)
+        {
+            ArgumentOutOfRangeException.ThrowIfNegative(percentile);
+            ArgumentOutOfRangeException.ThrowIfGreaterThan(percentile, 100);
+
+            if (Count == 0 || _buckets == null)
+            {
+                return TimeSpan.Zero;
+            }
+
+            //The rank of the sample at the percentile, at least the first sample
+            long rank = Math.Max(1, (long)Math.Ceiling(percentile / 100 * Count));
+            long seen = 0;
+
+            for (int i = 0; i < _buckets.Length; i++)
+            {
+                seen += _buckets[i];
+
+                if (seen >= rank)
+                {
+                    return HttpLatencyHistogram.ToTimeSpan(HttpLatencyHistogram.GetBucketUpperBound(i));
+                }
+            }
+
+            //The count is the sum of the buckets, so this is never reached
+            return HttpLatencyHistogram.ToTimeSpan(HttpLatencyHistogram.GetBucketUpperBound(_buckets.Length - 1));
+        }
+    }
+}
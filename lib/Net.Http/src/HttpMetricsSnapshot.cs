@@ -0,0 +1,91 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpMetricsSnapshot.cs 
+*
+* HttpMetricsSnapshot.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+
+namespace VNLib.Net.Http
+{
+    /// <summary>
+    /// A point-in-time copy of the counters and phase latency histograms 
+    /// of an <see cref="IHttpServer"/>
+    /// </summary>
+    public sealed class HttpMetricsSnapshot
+    {
+        private readonly long[] _statusClasses;
+        private readonly HttpLatencySnapshot[] _phases;
+
+        internal HttpMetricsSnapshot(long[] statusClasses, HttpLatencySnapshot[] phases)
+        {
+            _statusClasses = statusClasses;
+            _phases = phases;
+        }
+
+        /// <summary>
+        /// The total number of connections accepted by the server
+        /// </summary>
+        public long Connections { get; init; }
+
+        /// <summary>
+        /// The number of connections currently open
+        /// </summary>
+        public long ActiveConnections { get; init; }
+
+        /// <summary>
+        /// The total number of responses sent
+        /// </summary>
+        public long Requests { get; init; }
+
+        /// <summary>
+        /// The number of requests that were received on a connection 
+        /// kept alive from a previous request
+        /// </summary>
+        public long KeepAliveRequests { get; init; }
+
+        /// <summary>
+        /// The total number of response entity bytes written, before compression
+        /// </summary>
+        public long ResponseEntityBytes { get; init; }
+
+        /// <summary>
+        /// Gets the number of responses sent with a status code of the given class
+        /// </summary>
+        /// <param name="statusClass">The status class, 1 for 1xx responses through 5 for 5xx responses</param>
+        /// <returns>The number of responses sent in the status class</returns>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public long GetStatusClassCount(int statusClass)
+        {
+            ArgumentOutOfRangeException.ThrowIfLessThan(statusClass, 1);
+            ArgumentOutOfRangeException.ThrowIfGreaterThan(statusClass, _statusClasses.Length);
+
+            return _statusClasses[statusClass - 1];
+        }
+
+        /// <summary>
+        /// Gets the latency histogram of a processing phase
+        /// </summary>
+        /// <param name="phase">The phase to get the histogram of</param>
+        /// <returns>The latency snapshot of the phase</returns>
+        public HttpLatencySnapshot GetPhase(HttpServerPhase phase) => _phases[(int)phase];
+    }
+}
@@ -0,0 +1,54 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: HttpServerPhase.cs 
+*
+* HttpServerPhase.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+namespace VNLib.Net.Http
+{
+    /// <summary>
+    /// The timed phases of HTTP request processing recorded by the server metrics
+    /// </summary>
+    public enum HttpServerPhase
+    {
+        /// <summary>
+        /// Reading and parsing the request head
+        /// </summary>
+        Parse,
+        /// <summary>
+        /// Application processing of the request by the web root
+        /// </summary>
+        Application,
+        /// <summary>
+        /// Writing a compressed response entity, including the compressor 
+        /// and the transport writes of the compressed data
+        /// </summary>
+        Compression,
+        /// <summary>
+        /// Compiling and writing the response header block to the transport
+        /// </summary>
+        HeaderFlush,
+        /// <summary>
+        /// Flushing buffered response data on the transport at the end of a request
+        /// </summary>
+        TransportFlush
+    }
+}
@@ -45,6 +45,25 @@ namespace VNLib.Net.Http
         /// </summary>
         string Path => RequestUri.LocalPath;
 
+        /// <summary>
+        /// The current request path, equal to <see cref="Path"/>. Implementations may 
+        /// return the path without allocating a string, so it should be preferred for 
+        /// lookups such as routing.
+        /// </summary>
+        ReadOnlySpan<char> PathSpan => Path;
+
+        /// <summary>
+        /// The current request query string including the leading '?', equal to 
+        /// the <seealso cref="RequestUri"/> <see cref="Uri.Query"/>
+        /// </summary>
+        ReadOnlySpan<char> QuerySpan => RequestUri.Query;
+
+        /// <summary>
+        /// The requested host name, equal to the <seealso cref="RequestUri"/> 
+        /// <see cref="Uri.DnsSafeHost"/>
+        /// </summary>
+        ReadOnlySpan<char> HostSpan => RequestUri.DnsSafeHost;
+
         /// <summary>
         /// Current connection's user-agent header, (may be null if no user-agent header found)
         /// </summary>
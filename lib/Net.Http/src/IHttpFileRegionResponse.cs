@@ -0,0 +1,51 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: IHttpFileRegionResponse.cs 
+*
+* IHttpFileRegionResponse.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using Microsoft.Win32.SafeHandles;
+
+namespace VNLib.Net.Http
+{
+    /// <summary>
+    /// Represents a stream response whose data is a region of a file on disk. When the 
+    /// response is not compressed and the connection is not encrypted, transports that 
+    /// implement <see cref="ITransportFileSender"/> send the region directly from the 
+    /// file handle, otherwise the data is read as a normal <see cref="IHttpStreamResponse"/>
+    /// </summary>
+    /// <remarks>
+    /// The region starts at <see cref="FileOffset"/> and its length is the explicit length 
+    /// the response was submitted with.
+    /// </remarks>
+    public interface IHttpFileRegionResponse : IHttpStreamResponse
+    {
+        /// <summary>
+        /// The handle of the file to send data from
+        /// </summary>
+        SafeFileHandle FileHandle { get; }
+
+        /// <summary>
+        /// The file offset of the first byte of the response
+        /// </summary>
+        long FileOffset { get; }
+    }
+}
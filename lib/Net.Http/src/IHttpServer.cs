@@ -43,5 +43,12 @@ namespace VNLib.Net.Http
         /// <param name="cancellationToken">A token used to stop listening for incomming connections and close all open websockets</param>
         /// <returns>A task that resolves when the server has exited</returns>
         Task Start(CancellationToken cancellationToken);
+
+        /// <summary>
+        /// Captures the server's request counters and processing phase latency 
+        /// histograms. Metrics are recorded for the lifetime of the server.
+        /// </summary>
+        /// <returns>A point-in-time snapshot of the server metrics</returns>
+        HttpMetricsSnapshot GetMetrics();
     }
 }
\ No newline at end of file
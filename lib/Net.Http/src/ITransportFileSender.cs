@@ -0,0 +1,50 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Net.Http
+* File: ITransportFileSender.cs 
+*
+* ITransportFileSender.cs is part of VNLib.Net.Http which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Net.Http is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Net.Http is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System.Threading;
+using System.Threading.Tasks;
+
+using Microsoft.Win32.SafeHandles;
+
+namespace VNLib.Net.Http
+{
+    /// <summary>
+    /// An optional interface an <see cref="ITransportContext"/> may implement to send 
+    /// file data directly from a file handle, avoiding copying the data through 
+    /// application buffers.
+    /// </summary>
+    public interface ITransportFileSender
+    {
+        /// <summary>
+        /// Sends a region of a file to the client after all data previously written 
+        /// to the connection stream
+        /// </summary>
+        /// <param name="file">The handle of the file to send data from</param>
+        /// <param name="offset">The file offset of the first byte to send</param>
+        /// <param name="count">The number of bytes to send</param>
+        /// <param name="cancellation">A token to cancel the operation</param>
+        /// <returns>A value task that completes when the file region has been sent</returns>
+        ValueTask SendFileAsync(SafeFileHandle file, long offset, long count, CancellationToken cancellation);
+    }
+}
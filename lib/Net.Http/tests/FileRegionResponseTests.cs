@@ -0,0 +1,80 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class FileRegionResponseTests
+    {
+        static readonly byte[] FileRequest = Encoding.ASCII.GetBytes("GET /file HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+
+        static readonly byte[] ExpectedBody = LoopbackHttpServer.ResponseBody[LoopbackHttpServer.FileRegionOffset..];
+
+        [TestMethod()]
+        public async Task TransportFileSenderTest()
+        {
+            await using LoopbackHttpServer server = new(fileSender: true);
+
+            (string head, byte[] body) = SplitResponse(await server.SendRawAsync(FileRequest));
+
+            //Headers written to the connection stream must precede the file data
+            StringAssert.StartsWith(head, "HTTP/1.1 200");
+            StringAssert.Contains(head, $"Content-Length: {ExpectedBody.Length}");
+            CollectionAssert.AreEqual(ExpectedBody, body);
+
+            Assert.AreEqual(1, server.FileSendCount);
+            Assert.AreEqual(1, server.ReleasedFileRegions);
+        }
+
+        [TestMethod()]
+        public async Task TransportFileSenderWithSendBufferTest()
+        {
+            await using LoopbackHttpServer server = new(exposeSendBuffer: true, fileSender: true);
+
+            (string head, byte[] body) = SplitResponse(await server.SendRawAsync(FileRequest));
+
+            StringAssert.StartsWith(head, "HTTP/1.1 200");
+            CollectionAssert.AreEqual(ExpectedBody, body);
+
+            Assert.AreEqual(1, server.FileSendCount);
+        }
+
+        [TestMethod()]
+        public async Task BufferedFallbackTest()
+        {
+            //Transports without a file sender read the region as a stream
+            await using LoopbackHttpServer server = new();
+
+            (string head, byte[] body) = SplitResponse(await server.SendRawAsync(FileRequest));
+
+            StringAssert.StartsWith(head, "HTTP/1.1 200");
+            CollectionAssert.AreEqual(ExpectedBody, body);
+
+            Assert.AreEqual(0, server.FileSendCount);
+            Assert.AreEqual(1, server.ReleasedFileRegions);
+        }
+
+        [TestMethod()]
+        public async Task HeadRequestTest()
+        {
+            await using LoopbackHttpServer server = new(fileSender: true);
+
+            string response = await server.SendRawAsync("HEAD /file HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+
+            StringAssert.Contains(response, $"Content-Length: {ExpectedBody.Length}");
+            Assert.IsTrue(response.EndsWith("\r\n\r\n"), "A HEAD response must not have a body");
+
+            Assert.AreEqual(0, server.FileSendCount);
+            Assert.AreEqual(1, server.ReleasedFileRegions);
+        }
+
+        private static (string Head, byte[] Body) SplitResponse(byte[] response)
+        {
+            int end = response.AsSpan().IndexOf("\r\n\r\n"u8);
+            Assert.IsTrue(end > 0, "The response head was not terminated");
+
+            return (Encoding.ASCII.GetString(response, 0, end), response[(end + 4)..]);
+        }
+    }
+}
@@ -0,0 +1,230 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Net;
+using System.Text;
+
+using VNLib.Net.Http.Core;
+using VNLib.Net.Http.Core.Buffering;
+using VNLib.Net.Http.Core.Response;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class HeaderTableTests
+    {
+        [TestMethod()]
+        public void RequestCaseInsensitiveLookupTest()
+        {
+            RequestHeaderTable table = ParseRequest("Host: localhost", "X-Custom: value");
+
+            Assert.AreEqual("localhost", table[HttpRequestHeader.Host]);
+
+            foreach (string name in new[] { "Host", "host", "HOST", "hOsT" })
+            {
+                Assert.AreEqual("localhost", table[name], name);
+            }
+
+            foreach (string name in new[] { "X-Custom", "x-custom", "X-CUSTOM" })
+            {
+                Assert.AreEqual("value", table[name], name);
+                Assert.AreEqual("value", Encoding.ASCII.GetString(table.GetRawValue(name)), name);
+            }
+
+            Assert.IsNull(table["X-Missing"]);
+            Assert.IsNull(table[HttpRequestHeader.Referer]);
+            Assert.IsTrue(table.GetRawValue("X-Missing").IsEmpty);
+        }
+
+        [TestMethod()]
+        public void RequestDuplicateMergeTest()
+        {
+            string[] lines = ["Accept: text/html", "X-Custom: a", "accept: application/json", "x-custom: b", "X-CUSTOM: c"];
+
+            RequestHeaderTable table = ParseRequest(lines);
+
+            //Repeated headers were combined by the WebHeaderCollection the table replaced
+            WebHeaderCollection expected = new();
+
+            foreach (string line in lines)
+            {
+                string[] parts = line.Split(": ");
+                expected.Add(parts[0], parts[1]);
+            }
+
+            Assert.AreEqual(expected.Count, table.Count);
+            Assert.AreEqual(expected["Accept"], table["Accept"]);
+            Assert.AreEqual(expected["X-Custom"], table["X-Custom"]);
+            Assert.AreEqual("text/html,application/json", table[HttpRequestHeader.Accept]);
+            Assert.AreEqual("a,b,c", table["x-custom"]);
+
+            //Repeated known header values are still found without decoding
+            Assert.IsTrue(table.ValueContains(HttpRequestHeader.Accept, "APPLICATION/JSON"));
+        }
+
+        [TestMethod()]
+        public void RequestClearTest()
+        {
+            RequestHeaderTable table = ParseRequest("Host: localhost", "X-Custom: value");
+
+            table.Clear();
+
+            Assert.AreEqual(0, table.Count);
+            Assert.IsNull(table["Host"]);
+            Assert.IsNull(table["X-Custom"]);
+        }
+
+        [TestMethod()]
+        public void ResponseCaseInsensitiveLookupTest()
+        {
+            ResponseHeaderTable table = new();
+
+            table["content-type"] = "text/plain";
+            table["X-Custom"] = "value";
+
+            Assert.AreEqual("text/plain", table[HttpResponseHeader.ContentType]);
+            Assert.AreEqual("text/plain", table["Content-Type"]);
+            Assert.AreEqual("text/plain", table["CONTENT-TYPE"]);
+            Assert.AreEqual("value", table["x-custom"]);
+            Assert.AreEqual("value", table["X-CUSTOM"]);
+            Assert.IsNull(table["X-Missing"]);
+
+            Assert.AreEqual(2, table.Count);
+        }
+
+        [TestMethod()]
+        public void ResponseSetAndAddMatchesWebHeaderCollectionTest()
+        {
+            ResponseHeaderTable table = new();
+            WebHeaderCollection expected = new();
+
+            void Add(string name, string value)
+            {
+                table.Add(name, value);
+                expected.Add(name, value);
+            }
+
+            void Set(string name, string value)
+            {
+                table.Set(name, value);
+                expected.Set(name, value);
+            }
+
+            Add("Vary", "Accept-Encoding");
+            Add("vary", "Origin");
+            Add("X-Custom", "a");
+            Add("x-custom", "b");
+            Set("Cache-Control", "no-cache");
+            Set("cache-control", "no-store");
+            Set("X-Other", "1");
+            Set("X-OTHER", "2");
+            Add("X-Trimmed", "  padded\t");
+            Set("X-Empty", "");
+
+            Assert.AreEqual(expected.Count, table.Count);
+
+            foreach (string name in expected.AllKeys)
+            {
+                Assert.AreEqual(expected[name], table[name], name);
+            }
+
+            //Custom headers keep the casing of the name they were first added with
+            CollectionAssert.AreEqual(
+                new[] { "X-Custom", "X-Other", "X-Trimmed", "X-Empty" },
+                table.Select(static h => h.Key).Where(static k => k.StartsWith("X-")).ToArray()
+            );
+        }
+
+        [TestMethod()]
+        public void ResponseRemoveTest()
+        {
+            ResponseHeaderTable table = new();
+
+            table.Set(HttpResponseHeader.Location, "/");
+            table.Remove(HttpResponseHeader.Location);
+
+            Assert.IsNull(table["location"]);
+            Assert.AreEqual(0, table.Count);
+
+            //Removed headers start over when added again
+            table.Add(HttpResponseHeader.Location, "/next");
+            Assert.AreEqual("/next", table[HttpResponseHeader.Location]);
+        }
+
+        [TestMethod()]
+        public void ResponseInvalidValuesTest()
+        {
+            ResponseHeaderTable table = new();
+
+            Assert.ThrowsException<ArgumentException>(() => table.Set("X-Custom", "a\r\nInjected: true"));
+            Assert.ThrowsException<ArgumentException>(() => table.Set("Bad Name", "value"));
+            Assert.ThrowsException<ArgumentException>(() => table.Add(HttpResponseHeader.Location, "/\nInjected: true"));
+
+            //Surrounding whitespace is trimmed like WebHeaderCollection does, not rejected
+            table.Set(HttpResponseHeader.Location, "/\r\n");
+            Assert.AreEqual("/", table[HttpResponseHeader.Location]);
+        }
+
+        private static RequestHeaderTable ParseRequest(params string[] lines)
+        {
+            byte[] head = Encoding.ASCII.GetBytes(string.Join("\r\n", lines));
+            RequestHeaderTable table = new(new ArrayParseBuffer(head), new AsciiContextInfo());
+
+            int offset = 0;
+
+            foreach (string line in lines)
+            {
+                int colon = line.IndexOf(':');
+                string name = line[..colon];
+
+                Range nameRange = offset..(offset + colon);
+                Range valueRange = (offset + colon + 2)..(offset + line.Length);
+
+                //The parser stores well known headers in their slot
+                if (Enum.TryParse(name.Replace("-", ""), true, out HttpRequestHeader known) && known <= HttpRequestHeader.UserAgent)
+                {
+                    table.Add(known, valueRange);
+                }
+                else
+                {
+                    table.Add(nameRange, valueRange);
+                }
+
+                offset += line.Length + 2;
+            }
+
+            return table;
+        }
+
+        private sealed class ArrayParseBuffer(byte[] data) : IHttpHeaderParseBuffer
+        {
+            public int BinSize => data.Length;
+
+            public int Size => data.Length;
+
+            public Span<byte> GetBinSpan(int offset) => data.AsSpan(offset);
+
+            public Span<byte> GetBinSpan(int offset, int size) => data.AsSpan(offset, size);
+
+            public Span<char> GetCharSpan() => throw new NotSupportedException();
+
+            public ref byte DangerousGetBinRef(int offset) => ref data[offset];
+
+            public Memory<byte> GetMemory() => data;
+        }
+
+        private sealed class AsciiContextInfo : IHttpContextInformation
+        {
+            private readonly HttpEncodedSegment _segment = default;
+
+            public ref readonly HttpEncodedSegment CrlfSegment => ref _segment;
+
+            public ref readonly HttpEncodedSegment FinalChunkSegment => ref _segment;
+
+            public Encoding Encoding => Encoding.ASCII;
+
+            public HttpVersion CurrentVersion => HttpVersion.Http11;
+
+            public Stream GetTransport() => throw new NotSupportedException();
+        }
+    }
+}
@@ -0,0 +1,166 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+
+using VNLib.Net.Http.Core.Http2;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class HpackDecoderTests
+    {
+        [TestMethod()]
+        public void RequestsWithoutHuffmanTest()
+        {
+            //RFC 7541 C.3
+            HpackDecoder decoder = new(4096);
+
+            AssertBlock(decoder, "828684410f7777772e6578616d706c652e636f6d",
+                ":method", "GET",
+                ":scheme", "http",
+                ":path", "/",
+                ":authority", "www.example.com"
+            );
+
+            AssertBlock(decoder, "828684be58086e6f2d6361636865",
+                ":method", "GET",
+                ":scheme", "http",
+                ":path", "/",
+                ":authority", "www.example.com",
+                "cache-control", "no-cache"
+            );
+
+            AssertBlock(decoder, "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565",
+                ":method", "GET",
+                ":scheme", "https",
+                ":path", "/index.html",
+                ":authority", "www.example.com",
+                "custom-key", "custom-value"
+            );
+        }
+
+        [TestMethod()]
+        public void RequestsWithHuffmanTest()
+        {
+            //RFC 7541 C.4
+            HpackDecoder decoder = new(4096);
+
+            AssertBlock(decoder, "828684418cf1e3c2e5f23a6ba0ab90f4ff",
+                ":method", "GET",
+                ":scheme", "http",
+                ":path", "/",
+                ":authority", "www.example.com"
+            );
+
+            AssertBlock(decoder, "828684be5886a8eb10649cbf",
+                ":method", "GET",
+                ":scheme", "http",
+                ":path", "/",
+                ":authority", "www.example.com",
+                "cache-control", "no-cache"
+            );
+
+            AssertBlock(decoder, "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf",
+                ":method", "GET",
+                ":scheme", "https",
+                ":path", "/index.html",
+                ":authority", "www.example.com",
+                "custom-key", "custom-value"
+            );
+        }
+
+        [TestMethod()]
+        public void DynamicTableEvictionTest()
+        {
+            //RFC 7541 C.5, the 256 byte table forces evictions
+            HpackDecoder decoder = new(256);
+
+            AssertBlock(decoder,
+                "4803333032580770726976617465611d4d6f6e2c203231204f637420323031332032303a31333a323120474d54" +
+                "6e1768747470733a2f2f7777772e6578616d706c652e636f6d",
+                ":status", "302",
+                "cache-control", "private",
+                "date", "Mon, 21 Oct 2013 20:13:21 GMT",
+                "location", "https://www.example.com"
+            );
+
+            //Inserting :status 307 evicts :status 302
+            AssertBlock(decoder, "4803333037c1c0bf",
+                ":status", "307",
+                "cache-control", "private",
+                "date", "Mon, 21 Oct 2013 20:13:21 GMT",
+                "location", "https://www.example.com"
+            );
+
+            AssertBlock(decoder,
+                "88c1611d4d6f6e2c203231204f637420323031332032303a31333a323220474d54c05a04677a69707738666f6f3d" +
+                "4153444a4b48514b425a584f5157454f50495541585157454f49553b206d61782d6167653d333630303b2076657273696f6e3d31",
+                ":status", "200",
+                "cache-control", "private",
+                "date", "Mon, 21 Oct 2013 20:13:22 GMT",
+                "location", "https://www.example.com",
+                "content-encoding", "gzip",
+                "set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"
+            );
+
+            //Only three entries remain in the table, the fourth dynamic index was evicted
+            AssertBlock(decoder, "c0", "date", "Mon, 21 Oct 2013 20:13:22 GMT");
+            AssertThrows(decoder, "c1");
+        }
+
+        [TestMethod()]
+        public void MalformedIntegerTest()
+        {
+            HpackDecoder decoder = new(4096);
+
+            //Truncated continuation bytes
+            AssertThrows(decoder, "ff");
+            AssertThrows(decoder, "ff80");
+
+            //Larger than an int
+            AssertThrows(decoder, "ffffffffff0f");
+            AssertThrows(decoder, "ff808080808001");
+        }
+
+        [TestMethod()]
+        public void OversizedIndexTest()
+        {
+            HpackDecoder decoder = new(4096);
+
+            //Index 0 is never valid
+            AssertThrows(decoder, "80");
+
+            //The first dynamic index with an empty table
+            AssertThrows(decoder, "be");
+
+            //A literal that refers to a missing name
+            AssertThrows(decoder, "7f0000");
+
+            //A table size update larger than the advertised limit
+            AssertThrows(decoder, "3fe21f");
+        }
+
+        private static void AssertBlock(HpackDecoder decoder, string hex, params string[] fields)
+        {
+            ReadOnlySpan<byte> block = Convert.FromHexString(hex);
+            Span<byte> scratch = new byte[4096];
+            List<string> decoded = [];
+
+            decoder.BeginBlock();
+
+            while (decoder.TryReadField(ref block, scratch, out ReadOnlySpan<byte> name, out ReadOnlySpan<byte> value))
+            {
+                decoded.Add(Encoding.ASCII.GetString(name));
+                decoded.Add(Encoding.ASCII.GetString(value));
+            }
+
+            CollectionAssert.AreEqual(fields, decoded);
+        }
+
+        private static void AssertThrows(HpackDecoder decoder, string hex)
+        {
+            Http2ProtocolException pe = Assert.ThrowsException<Http2ProtocolException>(() => AssertBlock(decoder, hex));
+            Assert.AreEqual(Http2ErrorCode.CompressionError, pe.Code);
+        }
+    }
+}
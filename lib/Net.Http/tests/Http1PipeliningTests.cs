@@ -0,0 +1,79 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text.RegularExpressions;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class Http1PipeliningTests
+    {
+        [TestMethod()]
+        public async Task RequestsInOneSegmentTest()
+        {
+            await using LoopbackHttpServer server = new();
+
+            string response = await server.SendRawAsync(
+                "GET /a HTTP/1.1\r\nHost: localhost\r\n\r\n" +
+                "GET /b HTTP/1.1\r\nHost: localhost\r\n\r\n" +
+                "GET /c HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"
+            );
+
+            CollectionAssert.AreEqual(new[] { "/a", "/b", "/c" }, GetResponsePaths(response));
+            Assert.AreEqual(3, server.RequestCount);
+        }
+
+        [TestMethod()]
+        public async Task RequestSplitAcrossReadsTest()
+        {
+            await using LoopbackHttpServer server = new();
+
+            //Split inside the request line, inside a header and between the final CRLFs
+            string response = await server.SendSegmentsAsync(
+                "GET /a HTTP/1.1\r\nHost: localhost\r\n\r\nGET /b HT",
+                "TP/1.1\r\nHo",
+                "st: localhost\r\n\r",
+                "\nGET /c HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"
+            );
+
+            CollectionAssert.AreEqual(new[] { "/a", "/b", "/c" }, GetResponsePaths(response));
+        }
+
+        [TestMethod()]
+        public async Task StrayCrlfBetweenRequestsTest()
+        {
+            await using LoopbackHttpServer server = new();
+
+            //RFC 9112 2.2, empty lines before a request line are ignored
+            string response = await server.SendRawAsync(
+                "GET /a HTTP/1.1\r\nHost: localhost\r\n\r\n" +
+                "\r\n\r\n" +
+                "GET /b HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"
+            );
+
+            CollectionAssert.AreEqual(new[] { "/a", "/b" }, GetResponsePaths(response));
+        }
+
+        [TestMethod()]
+        public async Task ResponsesInRequestOrderTest()
+        {
+            await using LoopbackHttpServer server = new();
+
+            string[] paths = Enumerable.Range(0, 20).Select(static i => $"/{i}").ToArray();
+
+            string request = string.Concat(paths.Select(static p => $"GET {p} HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+
+            string response = await server.SendRawAsync(request);
+
+            //Every response must be complete and written in the order the requests were sent
+            Assert.AreEqual(paths.Length, Regex.Matches(response, "^HTTP/1.1 204", RegexOptions.Multiline).Count);
+            CollectionAssert.AreEqual(paths, GetResponsePaths(response));
+        }
+
+        private static string[] GetResponsePaths(string response)
+        {
+            return Regex.Matches(response, "^X-Request-Path: (.*)\r$", RegexOptions.Multiline | RegexOptions.IgnoreCase)
+                .Select(static m => m.Groups[1].Value)
+                .ToArray();
+        }
+    }
+}
@@ -0,0 +1,63 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class Http1RequestParsingTests
+    {
+        [TestMethod()]
+        public async Task WellFormedRequestTest()
+        {
+            await using LoopbackHttpServer server = new();
+
+            string response = await server.SendRawAsync("GET / HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+
+            StringAssert.StartsWith(response, "HTTP/1.1 204");
+            Assert.AreEqual(1, server.RequestCount);
+        }
+
+        [TestMethod()]
+        public async Task BareLineFeedRejectedTest()
+        {
+            await using LoopbackHttpServer server = new();
+
+            /*
+             * The bare LF ends the header lines early while the head itself ends 
+             * at the final CRLF, so the Content-Length header would be dropped and 
+             * the body parsed as a second pipelined request
+             */
+            string response = await server.SendRawAsync(
+                "POST / HTTP/1.1\r\nHost: localhost\r\n\nContent-Length: 40\r\n\r\n" +
+                "GET /smuggled HTTP/1.1\r\nHost: localhost\r\n\r\n"
+            );
+
+            StringAssert.StartsWith(response, "HTTP/1.1 400");
+            Assert.AreEqual(0, server.RequestCount);
+        }
+
+        [TestMethod()]
+        public async Task BareCarriageReturnRejectedTest()
+        {
+            await using LoopbackHttpServer server = new();
+
+            string response = await server.SendRawAsync("GET / HTTP/1.1\r\nHost: localhost\r\nX-Other: value\rX-Next: value\r\n\r\n");
+
+            StringAssert.StartsWith(response, "HTTP/1.1 400");
+            Assert.AreEqual(0, server.RequestCount);
+        }
+
+        [TestMethod()]
+        public async Task WhitespaceBeforeColonRejectedTest()
+        {
+            await using LoopbackHttpServer server = new();
+
+            string response = await server.SendRawAsync("GET / HTTP/1.1\r\nHost: localhost\r\nContent-Length : 0\r\n\r\n");
+            StringAssert.StartsWith(response, "HTTP/1.1 400");
+
+            response = await server.SendRawAsync("GET / HTTP/1.1\r\nHost: localhost\r\nContent-Length\t: 0\r\n\r\n");
+            StringAssert.StartsWith(response, "HTTP/1.1 400");
+
+            Assert.AreEqual(0, server.RequestCount);
+        }
+    }
+}
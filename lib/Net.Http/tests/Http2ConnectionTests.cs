@@ -0,0 +1,168 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Buffers.Binary;
+using System.Text;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class Http2ConnectionTests
+    {
+        const byte Data = 0x0, Headers = 0x1, Settings = 0x4, GoAway = 0x7, WindowUpdate = 0x8, Continuation = 0x9;
+        const byte EndStream = 0x1, EndHeaders = 0x4;
+
+        const uint ProtocolError = 0x1, FlowControlError = 0x3, StreamClosed = 0x5, FrameSizeError = 0x6, CompressionError = 0x9;
+
+        //GET / with a literal authority
+        static readonly byte[] RequestBlock = [0x82, 0x86, 0x84, 0x41, 0x09, .."localhost"u8];
+
+        [TestMethod()]
+        public async Task RequestTest()
+        {
+            await using LoopbackHttpServer server = new(enableHttp2: true);
+
+            byte[] response = await server.SendRawAsync(Connect(
+                Frame(Headers, EndStream | EndHeaders, 1, RequestBlock)
+            ), false);
+
+            Assert.IsTrue(ReadFrames(response).Any(static f => f.Type == Headers && f.StreamId == 1));
+            Assert.AreEqual(1, server.RequestCount);
+        }
+
+        [TestMethod()]
+        public async Task BadPrefaceTest()
+        {
+            await using LoopbackHttpServer server = new(enableHttp2: true);
+
+            //A near miss of the preface is handled by the HTTP/1.x parser and rejected
+            string response = await server.SendRawAsync("PRI * HTTP/2.0\r\n\r\nXX\r\n\r\n");
+
+            StringAssert.StartsWith(response, "HTTP/1.1 ");
+            Assert.AreEqual(0, server.RequestCount);
+        }
+
+        [TestMethod()]
+        public async Task FrameSizeViolationTest()
+        {
+            await using LoopbackHttpServer server = new(enableHttp2: true);
+
+            //The default maximum frame size is 16384 bytes
+            byte[] response = await server.SendRawAsync(Connect(
+                Frame(Data, 0, 1, new byte[16385])
+            ), false);
+
+            Assert.AreEqual(FrameSizeError, GetGoAwayCode(response));
+        }
+
+        [TestMethod()]
+        public async Task InterleavedContinuationTest()
+        {
+            await using LoopbackHttpServer server = new(enableHttp2: true);
+
+            //A header block must be continued on the same stream with no frames in between
+            byte[] response = await server.SendRawAsync(Connect(
+                Frame(Headers, EndStream, 1, RequestBlock[..3]),
+                Frame(Headers, EndStream | EndHeaders, 3, RequestBlock),
+                Frame(Continuation, EndHeaders, 1, RequestBlock[3..])
+            ), false);
+
+            Assert.AreEqual(ProtocolError, GetGoAwayCode(response));
+            Assert.AreEqual(0, server.RequestCount);
+        }
+
+        [TestMethod()]
+        public async Task WindowUpdateOverflowTest()
+        {
+            await using LoopbackHttpServer server = new(enableHttp2: true);
+
+            byte[] increment = new byte[4];
+            BinaryPrimitives.WriteUInt32BigEndian(increment, int.MaxValue);
+
+            //The connection window starts at 65535, so the maximum increment overflows it
+            byte[] response = await server.SendRawAsync(Connect(
+                Frame(WindowUpdate, 0, 0, increment)
+            ), false);
+
+            Assert.AreEqual(FlowControlError, GetGoAwayCode(response));
+        }
+
+        [TestMethod()]
+        public async Task HeadersOnClosedStreamTest()
+        {
+            await using LoopbackHttpServer server = new(enableHttp2: true);
+
+            //Stream 1 is implicitly closed when stream 3 is opened
+            byte[] response = await server.SendRawAsync(Connect(
+                Frame(Headers, EndStream | EndHeaders, 3, RequestBlock),
+                Frame(Headers, EndStream | EndHeaders, 1, [0x82, 0x86, 0x84, 0xbe])
+            ), false);
+
+            Assert.AreEqual(StreamClosed, GetGoAwayCode(response));
+        }
+
+        [TestMethod()]
+        public async Task CompressionErrorTest()
+        {
+            await using LoopbackHttpServer server = new(enableHttp2: true);
+
+            //The stream's context must be released when its header block cannot be decoded
+            byte[] response = await server.SendRawAsync(Connect(
+                Frame(Headers, EndStream | EndHeaders, 1, [0x82, 0x86, 0x84, 0xff, 0x80])
+            ), false);
+
+            Assert.AreEqual(CompressionError, GetGoAwayCode(response));
+            Assert.AreEqual(0, server.RequestCount);
+        }
+
+        private static byte[] Connect(params byte[][] frames)
+        {
+            List<byte> data = [.. "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"u8, .. Frame(Settings, 0, 0, [])];
+
+            foreach (byte[] frame in frames)
+            {
+                data.AddRange(frame);
+            }
+
+            return [.. data];
+        }
+
+        private static byte[] Frame(byte type, int flags, int streamId, byte[] payload)
+        {
+            byte[] frame = new byte[9 + payload.Length];
+
+            frame[0] = (byte)(payload.Length >> 16);
+            frame[1] = (byte)(payload.Length >> 8);
+            frame[2] = (byte)payload.Length;
+            frame[3] = type;
+            frame[4] = (byte)flags;
+            BinaryPrimitives.WriteInt32BigEndian(frame.AsSpan(5), streamId);
+            payload.CopyTo(frame, 9);
+
+            return frame;
+        }
+
+        private static List<(byte Type, int StreamId, byte[] Payload)> ReadFrames(byte[] response)
+        {
+            List<(byte, int, byte[])> frames = [];
+
+            for (int offset = 0; offset + 9 <= response.Length;)
+            {
+                int length = response[offset] << 16 | response[offset + 1] << 8 | response[offset + 2];
+                int streamId = BinaryPrimitives.ReadInt32BigEndian(response.AsSpan(offset + 5)) & int.MaxValue;
+
+                frames.Add((response[offset + 3], streamId, response.AsSpan(offset + 9, length).ToArray()));
+                offset += 9 + length;
+            }
+
+            return frames;
+        }
+
+        private static uint GetGoAwayCode(byte[] response)
+        {
+            var goAway = ReadFrames(response).SingleOrDefault(static f => f.Type == GoAway);
+
+            Assert.IsNotNull(goAway.Payload, Encoding.ASCII.GetString(response));
+            return BinaryPrimitives.ReadUInt32BigEndian(goAway.Payload.AsSpan(4));
+        }
+    }
+}
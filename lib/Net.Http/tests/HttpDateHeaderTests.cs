@@ -0,0 +1,56 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+using System.Globalization;
+
+using VNLib.Net.Http.Core.Response;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class HttpDateHeaderTests
+    {
+        [TestMethod()]
+        public void FormatTest()
+        {
+            string line = Encoding.ASCII.GetString(HttpDateHeader.Current);
+
+            StringAssert.StartsWith(line, "Date: ");
+            Assert.IsTrue(line.EndsWith("\r\n"), "The header line must end with CRLF");
+            Assert.AreEqual(37, line.Length);
+
+            //The value must be a valid rfc1123 date
+            DateTimeOffset.ParseExact(line[6..^2], "R", CultureInfo.InvariantCulture);
+        }
+
+        [TestMethod()]
+        public async Task SecondRolloverTest()
+        {
+            //Touch the cache so the timer is running before the first boundary is crossed
+            DateTimeOffset previous = ReadCurrent();
+
+            for (int i = 0; i < 3; i++)
+            {
+                //Sample well after the next boundary so a late timer tick is tolerated
+                await Task.Delay(1000 - DateTimeOffset.UtcNow.Millisecond + 250);
+
+                DateTimeOffset now = DateTimeOffset.UtcNow;
+                DateTimeOffset current = ReadCurrent();
+
+                Assert.AreEqual(TruncateToSecond(now), current, "The cached date did not roll over at the second boundary");
+                Assert.IsTrue(current > previous, "The cached date must advance every second");
+
+                previous = current;
+            }
+        }
+
+        private static DateTimeOffset ReadCurrent()
+        {
+            string line = Encoding.ASCII.GetString(HttpDateHeader.Current);
+            return DateTimeOffset.ParseExact(line[6..^2], "R", CultureInfo.InvariantCulture);
+        }
+
+        private static DateTimeOffset TruncateToSecond(DateTimeOffset value) 
+            => new(value.Ticks - (value.Ticks % TimeSpan.TicksPerSecond), TimeSpan.Zero);
+    }
+}
@@ -0,0 +1,101 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using VNLib.Net.Http.Core.PerfCounter;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class HttpLatencyHistogramTests
+    {
+        const int LastBucket = HttpLatencyHistogram.BucketCount - 1;
+
+        [TestMethod()]
+        public void ZeroValueTest()
+        {
+            Assert.AreEqual(0, HttpLatencyHistogram.GetBucket(0));
+            Assert.AreEqual(0, HttpLatencyHistogram.GetBucketUpperBound(0));
+
+            //Negative durations from a clock adjustment are clamped to zero
+            Assert.AreEqual(0, HttpLatencyHistogram.GetBucket(-1));
+            Assert.AreEqual(0, HttpLatencyHistogram.GetBucket(long.MinValue));
+        }
+
+        [TestMethod()]
+        public void ExactSmallValuesTest()
+        {
+            //Values below the sub bucket count each get their own bucket
+            for (long i = 0; i < 8; i++)
+            {
+                Assert.AreEqual((int)i, HttpLatencyHistogram.GetBucket(i));
+                Assert.AreEqual(i, HttpLatencyHistogram.GetBucketUpperBound((int)i));
+            }
+        }
+
+        [TestMethod()]
+        public void BucketEdgesTest()
+        {
+            for (int i = 0; i < LastBucket; i++)
+            {
+                long upper = HttpLatencyHistogram.GetBucketUpperBound(i);
+
+                //The upper bound is the last value in its bucket, the next value starts the next bucket
+                Assert.AreEqual(i, HttpLatencyHistogram.GetBucket(upper), $"Upper bound of bucket {i}");
+                Assert.AreEqual(i + 1, HttpLatencyHistogram.GetBucket(upper + 1), $"Lower bound of bucket {i + 1}");
+            }
+        }
+
+        [TestMethod()]
+        public void BucketPowerOfTwoEdgesTest()
+        {
+            for (int bit = 3; bit < 48; bit++)
+            {
+                long value = 1L << bit;
+
+                //Each power of two starts a new group of sub buckets
+                Assert.AreEqual(HttpLatencyHistogram.GetBucket(value - 1) + 1, HttpLatencyHistogram.GetBucket(value));
+                Assert.AreEqual(value - 1, HttpLatencyHistogram.GetBucketUpperBound(HttpLatencyHistogram.GetBucket(value - 1)));
+            }
+        }
+
+        [TestMethod()]
+        public void OverflowTest()
+        {
+            //Values past the largest magnitude are clamped into the last bucket
+            Assert.AreEqual(LastBucket, HttpLatencyHistogram.GetBucket((1L << 48) - 1));
+            Assert.AreEqual(LastBucket, HttpLatencyHistogram.GetBucket(1L << 48));
+            Assert.AreEqual(LastBucket, HttpLatencyHistogram.GetBucket(long.MaxValue));
+
+            Assert.AreEqual((1L << 48) - 1, HttpLatencyHistogram.GetBucketUpperBound(LastBucket));
+        }
+
+        [TestMethod()]
+        public void SnapshotTest()
+        {
+            HttpLatencyHistogram histogram = new(4);
+
+            histogram.Record(0);
+            histogram.Record(0);
+            histogram.Record(1L << 50);
+
+            HttpLatencySnapshot snapshot = histogram.GetSnapshot();
+
+            Assert.AreEqual(3, snapshot.Count);
+            Assert.AreEqual(TimeSpan.Zero, snapshot.GetPercentile(0));
+            Assert.AreEqual(TimeSpan.Zero, snapshot.GetPercentile(50));
+
+            //The clamped sample reports the last bucket's bound, the sum keeps the real value
+            Assert.AreEqual(HttpLatencyHistogram.ToTimeSpan((1L << 48) - 1), snapshot.Max);
+            Assert.AreEqual(HttpLatencyHistogram.ToTimeSpan(1L << 50), snapshot.Total);
+        }
+
+        [TestMethod()]
+        public void EmptySnapshotTest()
+        {
+            HttpLatencySnapshot snapshot = new HttpLatencyHistogram(1).GetSnapshot();
+
+            Assert.AreEqual(0, snapshot.Count);
+            Assert.AreEqual(TimeSpan.Zero, snapshot.Max);
+            Assert.AreEqual(TimeSpan.Zero, snapshot.Mean);
+        }
+    }
+}
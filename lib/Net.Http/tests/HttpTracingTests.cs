@@ -0,0 +1,86 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+using System.Diagnostics;
+
+using VNLib.Net.Http.Core.PerfCounter;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class HttpTracingTests
+    {
+        const string TraceId = "4bf92f3577b34da6a3ce929d0e0e4736";
+        const string SpanId = "00f067aa0ba902b7";
+
+        [TestMethod()]
+        public void ValidTraceParentTest()
+        {
+            Assert.IsTrue(Parse($"00-{TraceId}-{SpanId}-01", out ActivityContext context));
+
+            Assert.AreEqual(TraceId, context.TraceId.ToHexString());
+            Assert.AreEqual(SpanId, context.SpanId.ToHexString());
+            Assert.AreEqual(ActivityTraceFlags.Recorded, context.TraceFlags);
+            Assert.IsTrue(context.IsRemote);
+
+            Assert.IsTrue(Parse($"00-{TraceId}-{SpanId}-00", out context));
+            Assert.AreEqual(ActivityTraceFlags.None, context.TraceFlags);
+        }
+
+        [TestMethod()]
+        public void FutureVersionTest()
+        {
+            //Future versions may append fields after another dash
+            Assert.IsTrue(Parse($"cc-{TraceId}-{SpanId}-01", out _));
+            Assert.IsTrue(Parse($"cc-{TraceId}-{SpanId}-01-future", out _));
+            Assert.IsFalse(Parse($"cc-{TraceId}-{SpanId}-01future", out _));
+
+            //Version 00 has exactly four fields
+            Assert.IsFalse(Parse($"00-{TraceId}-{SpanId}-01-future", out _));
+        }
+
+        [TestMethod()]
+        public void InvalidVersionTest()
+        {
+            Assert.IsFalse(Parse($"ff-{TraceId}-{SpanId}-01", out ActivityContext context));
+            Assert.AreEqual(default, context);
+        }
+
+        [TestMethod()]
+        public void AllZeroIdsTest()
+        {
+            Assert.IsFalse(Parse($"00-{new string('0', 32)}-{SpanId}-01", out _));
+            Assert.IsFalse(Parse($"00-{TraceId}-{new string('0', 16)}-01", out _));
+        }
+
+        [TestMethod()]
+        public void WrongLengthTest()
+        {
+            Assert.IsFalse(Parse("", out _));
+            Assert.IsFalse(Parse($"00-{TraceId}-{SpanId}-1", out _));
+            Assert.IsFalse(Parse($"00-{TraceId[1..]}-{SpanId}0-01", out _));
+            Assert.IsFalse(Parse($"00-{TraceId}0-{SpanId[1..]}-01", out _));
+            Assert.IsFalse(Parse($"000-{TraceId}-{SpanId[1..]}-01", out _));
+        }
+
+        [TestMethod()]
+        public void UppercaseHexTest()
+        {
+            //Only lowercase hex is allowed in every field
+            Assert.IsFalse(Parse($"00-{TraceId.ToUpperInvariant()}-{SpanId}-01", out _));
+            Assert.IsFalse(Parse($"00-{TraceId}-{SpanId.ToUpperInvariant()}-01", out _));
+            Assert.IsFalse(Parse($"0A-{TraceId}-{SpanId}-01", out _));
+            Assert.IsFalse(Parse($"00-{TraceId}-{SpanId}-0F", out _));
+        }
+
+        [TestMethod()]
+        public void NonHexTest()
+        {
+            Assert.IsFalse(Parse($"00-{TraceId[..31]}g-{SpanId}-01", out _));
+            Assert.IsFalse(Parse($"00-{TraceId}-{SpanId}-0x", out _));
+        }
+
+        private static bool Parse(string value, out ActivityContext context)
+            => HttpTracing.TryParseTraceParent(Encoding.ASCII.GetBytes(value), out context);
+    }
+}
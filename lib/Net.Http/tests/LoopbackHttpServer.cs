@@ -0,0 +1,407 @@
+﻿using System.Buffers;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+
+using Microsoft.Win32.SafeHandles;
+
+using VNLib.Utils.Memory;
+using VNLib.Utils.Extensions;
+using VNLib.Utils.Logging;
+
+namespace VNLib.Net.Http.Tests
+{
+    /// <summary>
+    /// Hosts an <see cref="HttpServer"/> on a loopback tcp listener so tests can 
+    /// send raw request bytes and inspect the raw response
+    /// </summary>
+    internal sealed class LoopbackHttpServer : IAsyncDisposable
+    {
+        /// <summary>
+        /// The response body sent for requests to the /body path
+        /// </summary>
+        public static readonly byte[] ResponseBody = Enumerable.Range(0, 200 * 1024).Select(static i => (byte)(i * 7)).ToArray();
+
+        /// <summary>
+        /// The offset within <see cref="ResponseBody"/> of the file region sent for requests to the /file path
+        /// </summary>
+        public const int FileRegionOffset = 1000;
+
+        private static readonly Lazy<string> ResponseFile = new(static () =>
+        {
+            string path = Path.GetTempFileName();
+            File.WriteAllBytes(path, ResponseBody);
+            return path;
+        });
+
+        private readonly CancellationTokenSource _cts = new();
+        private readonly LoopbackTransport _transport;
+        private readonly Task _serverTask;
+
+        /// <summary>
+        /// The number of requests that reached the web root
+        /// </summary>
+        public int RequestCount => _root.RequestCount;
+
+        /// <summary>
+        /// The number of file regions sent by the transport's file sender
+        /// </summary>
+        public int FileSendCount => _transport.FileSendCount;
+
+        /// <summary>
+        /// The number of file region responses that were disposed
+        /// </summary>
+        public int ReleasedFileRegions => _root.ReleasedFileRegions;
+
+        private readonly CountingRoot _root = new();
+
+        /// <summary>
+        /// Starts a new server on a random loopback port
+        /// </summary>
+        /// <param name="enableHttp2">Accepts HTTP/2 connections with prior knowledge</param>
+        /// <param name="exposeSendBuffer">
+        /// Exposes an <see cref="IBufferWriter{T}"/> send buffer on the connection stream, 
+        /// like the tcp transport does, so responses are written directly into it
+        /// </param>
+        /// <param name="compressor">An optional compressor manager to enable chunked, compressed responses</param>
+        /// <param name="fileSender">Implements <see cref="ITransportFileSender"/> on the transport context</param>
+        public LoopbackHttpServer(bool enableHttp2 = false, bool exposeSendBuffer = false, IHttpCompressorManager? compressor = null, bool fileSender = false)
+        {
+            _transport = new(exposeSendBuffer, fileSender);
+
+            HttpConfig config = new(new NullLog(), new SharedPool())
+            {
+                EnableHttp2 = enableHttp2,
+                CompressorManager = compressor
+            };
+
+            HttpServer server = new(config, _transport, [_root]);
+            _serverTask = server.Start(_cts.Token);
+        }
+
+        /// <summary>
+        /// Sends the raw request to the server and reads the response until 
+        /// the server closes the connection or the timeout expires
+        /// </summary>
+        /// <param name="rawRequest">The raw request bytes to send</param>
+        /// <returns>The raw response text</returns>
+        public async Task<string> SendRawAsync(string rawRequest)
+        {
+            byte[] response = await SendRawAsync(Encoding.ASCII.GetBytes(rawRequest));
+            return Encoding.ASCII.GetString(response);
+        }
+
+        /// <summary>
+        /// Sends the raw request bytes to the server and reads the response until 
+        /// the server closes the connection or the timeout expires
+        /// </summary>
+        /// <param name="rawRequest">The raw request bytes to send</param>
+        /// <param name="shutdownSend">
+        /// Closes the sending side of the connection after the request is sent. HTTP/2 
+        /// connections are closed by the server when the client stops sending.
+        /// </param>
+        /// <returns>The raw response bytes</returns>
+        public Task<byte[]> SendRawAsync(byte[] rawRequest, bool shutdownSend = true) 
+            => SendAsync([rawRequest], TimeSpan.Zero, shutdownSend);
+
+        /// <summary>
+        /// Sends each segment of the raw request in a separate write, pausing between 
+        /// them so the server receives them in separate reads, then reads the response
+        /// until the server closes the connection or the timeout expires
+        /// </summary>
+        /// <param name="segments">The raw request segments to send in order</param>
+        /// <returns>The raw response text</returns>
+        public async Task<string> SendSegmentsAsync(params string[] segments)
+        {
+            byte[] response = await SendAsync(segments.Select(Encoding.ASCII.GetBytes), TimeSpan.FromMilliseconds(100), true);
+            return Encoding.ASCII.GetString(response);
+        }
+
+        private async Task<byte[]> SendAsync(IEnumerable<byte[]> segments, TimeSpan delay, bool shutdownSend)
+        {
+            using TcpClient client = new();
+            await client.ConnectAsync(_transport.EndPoint);
+
+            //Send each segment in its own packet
+            client.NoDelay = true;
+
+            NetworkStream stream = client.GetStream();
+
+            foreach (byte[] segment in segments)
+            {
+                await stream.WriteAsync(segment);
+                await Task.Delay(delay);
+            }
+
+            //No more requests will be sent, so the server closes the connection when done
+            if (shutdownSend)
+            {
+                client.Client.Shutdown(SocketShutdown.Send);
+            }
+
+            using CancellationTokenSource timeout = new(TimeSpan.FromSeconds(2));
+            using MemoryStream response = new();
+            byte[] buffer = new byte[4096];
+
+            try
+            {
+                int read;
+                while ((read = await stream.ReadAsync(buffer, timeout.Token)) > 0)
+                {
+                    response.Write(buffer, 0, read);
+                }
+            }
+            catch (OperationCanceledException)
+            {
+                //Keepalive connections are not closed by the server
+            }
+
+            return response.ToArray();
+        }
+
+        public async ValueTask DisposeAsync()
+        {
+            _cts.Cancel();
+            await _serverTask;
+            _cts.Dispose();
+        }
+
+        private sealed class LoopbackTransport(bool exposeSendBuffer, bool fileSender) : ITransportProvider
+        {
+            private readonly TcpListener _listener = new(IPAddress.Loopback, 0);
+
+            private int _fileSendCount;
+
+            public int FileSendCount => Volatile.Read(ref _fileSendCount);
+
+            public IPEndPoint EndPoint { get; private set; } = null!;
+
+            public void Start(CancellationToken stopToken)
+            {
+                _listener.Start();
+                EndPoint = (IPEndPoint)_listener.LocalEndpoint;
+                stopToken.Register(_listener.Stop);
+            }
+
+            public async ValueTask<ITransportContext> AcceptAsync(CancellationToken cancellation)
+            {
+                try
+                {
+                    TcpClient client = await _listener.AcceptTcpClientAsync(cancellation);
+
+                    return fileSender
+                        ? new FileSenderContext(client, exposeSendBuffer, () => Interlocked.Increment(ref _fileSendCount))
+                        : new LoopbackContext(client, exposeSendBuffer);
+                }
+                catch (Exception) when (cancellation.IsCancellationRequested)
+                {
+                    //Stopping the listener fails the pending accept, the server only exits on cancellation
+                    throw new OperationCanceledException(cancellation);
+                }
+            }
+        }
+
+        private class LoopbackContext(TcpClient client, bool exposeSendBuffer) : ITransportContext
+        {
+            private readonly TransportSecurityInfo? _securityInfo = null;
+
+            public Stream ConnectionStream { get; } = exposeSendBuffer ? new SendBufferStream(client.GetStream()) : client.GetStream();
+
+            public IPEndPoint LocalEndPoint => (IPEndPoint)client.Client.LocalEndPoint!;
+
+            public IPEndPoint RemoteEndpoint => (IPEndPoint)client.Client.RemoteEndPoint!;
+
+            public ValueTask CloseConnectionAsync()
+            {
+                client.Dispose();
+                return ValueTask.CompletedTask;
+            }
+
+            public ref readonly TransportSecurityInfo? GetSecurityInfo() => ref _securityInfo;
+        }
+
+        /*
+         * Sends file regions by reading the file and writing it after the 
+         * buffered response data, like a transport using sendfile would
+         */
+        private sealed class FileSenderContext(TcpClient client, bool exposeSendBuffer, Action onFileSent) 
+            : LoopbackContext(client, exposeSendBuffer), ITransportFileSender
+        {
+            public async ValueTask SendFileAsync(SafeFileHandle file, long offset, long count, CancellationToken cancellation)
+            {
+                await ConnectionStream.FlushAsync(cancellation);
+
+                byte[] buffer = new byte[8192];
+
+                while (count > 0)
+                {
+                    int read = await RandomAccess.ReadAsync(file, buffer.AsMemory(0, (int)Math.Min(buffer.Length, count)), offset, cancellation);
+
+                    if (read == 0)
+                    {
+                        throw new EndOfStreamException("The file region extends past the end of the file");
+                    }
+
+                    await ConnectionStream.WriteAsync(buffer.AsMemory(0, read), cancellation);
+
+                    offset += read;
+                    count -= read;
+                }
+
+                onFileSent();
+            }
+        }
+
+        private sealed class CountingRoot : IWebRoot
+        {
+            private int _requestCount;
+            private int _releasedFileRegions;
+
+            public int RequestCount => Volatile.Read(ref _requestCount);
+
+            public int ReleasedFileRegions => Volatile.Read(ref _releasedFileRegions);
+
+            public string Hostname => "*";
+
+            public ValueTask ClientConnectedAsync(IHttpEvent httpEvent)
+            {
+                Interlocked.Increment(ref _requestCount);
+
+                //Lets tests match responses to requests
+                httpEvent.Server.Headers["X-Request-Path"] = httpEvent.Server.Path;
+
+                if (httpEvent.Server.Path == "/body")
+                {
+                    httpEvent.CloseResponse(HttpStatusCode.OK, ContentType.Binary, new MemoryStream(ResponseBody, false), ResponseBody.Length);
+                }
+                else if (httpEvent.Server.Path == "/file")
+                {
+                    FileRegion region = new(
+                        File.OpenHandle(ResponseFile.Value, options: FileOptions.Asynchronous), 
+                        FileRegionOffset, 
+                        () => Interlocked.Increment(ref _releasedFileRegions)
+                    );
+
+                    httpEvent.CloseResponse(HttpStatusCode.OK, ContentType.Binary, region, ResponseBody.Length - FileRegionOffset);
+                }
+                else
+                {
+                    httpEvent.CloseResponse(HttpStatusCode.NoContent);
+                }
+
+                return ValueTask.CompletedTask;
+            }
+        }
+
+        private sealed class FileRegion(SafeFileHandle handle, long offset, Action onReleased) : IHttpFileRegionResponse
+        {
+            private long _position = offset;
+
+            public SafeFileHandle FileHandle => handle;
+
+            public long FileOffset => offset;
+
+            public async ValueTask<int> ReadAsync(Memory<byte> buffer)
+            {
+                int read = await RandomAccess.ReadAsync(handle, buffer, _position);
+                _position += read;
+                return read;
+            }
+
+            public void Dispose()
+            {
+                if (!handle.IsClosed)
+                {
+                    handle.Dispose();
+                    onReleased();
+                }
+            }
+
+            public ValueTask DisposeAsync()
+            {
+                Dispose();
+                return ValueTask.CompletedTask;
+            }
+        }
+
+        /*
+         * Buffers data written through the buffer writer until the stream is 
+         * flushed, the same contract the tcp transport's send pipe follows
+         */
+        private sealed class SendBufferStream(Stream inner) : Stream, IBufferWriter<byte>
+        {
+            private readonly ArrayBufferWriter<byte> _pending = new();
+
+            public override bool CanRead => true;
+            public override bool CanSeek => false;
+            public override bool CanWrite => true;
+            public override long Length => throw new NotSupportedException();
+            public override long Position { get => throw new NotSupportedException(); set => throw new NotSupportedException(); }
+            public override bool CanTimeout => true;
+            public override int ReadTimeout { get => inner.ReadTimeout; set => inner.ReadTimeout = value; }
+            public override int WriteTimeout { get => inner.WriteTimeout; set => inner.WriteTimeout = value; }
+
+            public void Advance(int count) => _pending.Advance(count);
+
+            public Memory<byte> GetMemory(int sizeHint = 0) => _pending.GetMemory(sizeHint);
+
+            public Span<byte> GetSpan(int sizeHint = 0) => _pending.GetSpan(sizeHint);
+
+            public override void Flush() => FlushAsync().GetAwaiter().GetResult();
+
+            public override async Task FlushAsync(CancellationToken cancellationToken)
+            {
+                if (_pending.WrittenCount > 0)
+                {
+                    await inner.WriteAsync(_pending.WrittenMemory, cancellationToken);
+                    _pending.Clear();
+                }
+
+                await inner.FlushAsync(cancellationToken);
+            }
+
+            public override int Read(byte[] buffer, int offset, int count) => inner.Read(buffer, offset, count);
+
+            public override ValueTask<int> ReadAsync(Memory<byte> buffer, CancellationToken cancellationToken = default) 
+                => inner.ReadAsync(buffer, cancellationToken);
+
+            public override void Write(byte[] buffer, int offset, int count) => WriteAsync(buffer.AsMemory(offset, count)).AsTask().GetAwaiter().GetResult();
+
+            public override async ValueTask WriteAsync(ReadOnlyMemory<byte> buffer, CancellationToken cancellationToken = default)
+            {
+                //Buffered data always precedes data written to the stream
+                await FlushAsync(cancellationToken);
+                await inner.WriteAsync(buffer, cancellationToken);
+            }
+
+            public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+
+            public override void SetLength(long value) => throw new NotSupportedException();
+        }
+
+        private sealed class SharedPool : IHttpMemoryPool
+        {
+            public IMemoryOwner<byte> AllocateBufferForContext(int bufferSize) => MemoryPool<byte>.Shared.Rent(bufferSize);
+
+            public IResizeableMemoryHandle<T> AllocFormDataBuffer<T>(int initialSize) where T : unmanaged
+                => MemoryUtil.Shared.Alloc<T>((nint)initialSize);
+        }
+
+        private sealed class NullLog : ILogProvider
+        {
+            public void Flush() { }
+
+            public object GetLogProvider() => this;
+
+            public bool IsEnabled(LogLevel level) => false;
+
+            public void Write(LogLevel level, string value) { }
+
+            public void Write(LogLevel level, Exception exception, string value = "") { }
+
+            public void Write(LogLevel level, string value, params object?[] args) { }
+
+            public void Write(LogLevel level, string value, params ValueType[] args) { }
+        }
+    }
+}
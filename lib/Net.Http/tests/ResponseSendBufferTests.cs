@@ -0,0 +1,138 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Text;
+using System.Globalization;
+
+namespace VNLib.Net.Http.Tests
+{
+    [TestClass()]
+    public class ResponseSendBufferTests
+    {
+        const string BodyRequest = "GET /body HTTP/1.1\r\nHost: localhost\r\nAccept-Encoding: gzip\r\nConnection: close\r\n\r\n";
+
+        [TestMethod()]
+        public async Task DirectChunkedRoundTripTest()
+        {
+            await using LoopbackHttpServer server = new(exposeSendBuffer: true, compressor: new PassthroughCompressor());
+
+            byte[] response = await server.SendRawAsync(Encoding.ASCII.GetBytes(BodyRequest));
+
+            (string head, byte[] body) = SplitResponse(response);
+
+            StringAssert.StartsWith(head, "HTTP/1.1 200");
+            StringAssert.Contains(head, "Transfer-Encoding: chunked");
+
+            byte[] decoded = DecodeChunked(body, out List<string> sizeLines);
+
+            CollectionAssert.AreEqual(LoopbackHttpServer.ResponseBody, decoded);
+
+            //Direct chunks are framed in place, so every data chunk has the same zero-padded size width
+            Assert.IsTrue(sizeLines.Count > 2, "Expected the body to span several chunks");
+            Assert.AreEqual(1, sizeLines.Select(static s => s.Length).Distinct().Count());
+        }
+
+        [TestMethod()]
+        public async Task DirectChunkedMatchesBufferedTest()
+        {
+            await using LoopbackHttpServer direct = new(exposeSendBuffer: true, compressor: new PassthroughCompressor());
+            await using LoopbackHttpServer buffered = new(exposeSendBuffer: false, compressor: new PassthroughCompressor());
+
+            byte[] directBody = DecodeChunked(SplitResponse(await direct.SendRawAsync(Encoding.ASCII.GetBytes(BodyRequest))).Body, out _);
+            byte[] bufferedBody = DecodeChunked(SplitResponse(await buffered.SendRawAsync(Encoding.ASCII.GetBytes(BodyRequest))).Body, out _);
+
+            CollectionAssert.AreEqual(bufferedBody, directBody);
+        }
+
+        [TestMethod()]
+        public async Task DirectStreamEntityTest()
+        {
+            await using LoopbackHttpServer server = new(exposeSendBuffer: true);
+
+            byte[] response = await server.SendRawAsync(Encoding.ASCII.GetBytes(BodyRequest));
+
+            (string head, byte[] body) = SplitResponse(response);
+
+            StringAssert.Contains(head, $"Content-Length: {LoopbackHttpServer.ResponseBody.Length}");
+            CollectionAssert.AreEqual(LoopbackHttpServer.ResponseBody, body);
+        }
+
+        [TestMethod()]
+        public async Task EmptyBodyHeadersFlushedTest()
+        {
+            await using LoopbackHttpServer server = new(exposeSendBuffer: true);
+
+            //Headers are only buffered, the connection is kept open so only the end of request flush can send them
+            byte[] response = await server.SendRawAsync(Encoding.ASCII.GetBytes("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"), false);
+
+            StringAssert.StartsWith(Encoding.ASCII.GetString(response), "HTTP/1.1 204");
+            Assert.AreEqual(1, server.RequestCount);
+        }
+
+        private static (string Head, byte[] Body) SplitResponse(byte[] response)
+        {
+            int end = response.AsSpan().IndexOf("\r\n\r\n"u8);
+            Assert.IsTrue(end > 0, "The response head was not terminated");
+
+            return (Encoding.ASCII.GetString(response, 0, end), response[(end + 4)..]);
+        }
+
+        private static byte[] DecodeChunked(byte[] body, out List<string> sizeLines)
+        {
+            using MemoryStream output = new();
+            sizeLines = [];
+
+            int offset = 0;
+
+            while (true)
+            {
+                int lineEnd = body.AsSpan(offset).IndexOf("\r\n"u8);
+                Assert.IsTrue(lineEnd > 0, "Missing chunk size line");
+
+                string sizeLine = Encoding.ASCII.GetString(body, offset, lineEnd);
+                int size = int.Parse(sizeLine, NumberStyles.HexNumber);
+
+                offset += lineEnd + 2;
+
+                if (size == 0)
+                {
+                    //The final chunk has no trailers
+                    Assert.AreEqual("\r\n", Encoding.ASCII.GetString(body, offset, body.Length - offset));
+                    return output.ToArray();
+                }
+
+                sizeLines.Add(sizeLine);
+
+                output.Write(body, offset, size);
+                offset += size;
+
+                Assert.AreEqual("\r\n", Encoding.ASCII.GetString(body, offset, 2));
+                offset += 2;
+            }
+        }
+
+        /*
+         * Copies input to output unmodified so the chunked framing can be 
+         * checked against the original body
+         */
+        private sealed class PassthroughCompressor : IHttpCompressorManager
+        {
+            public CompressionMethod GetSupportedMethods() => CompressionMethod.Gzip;
+
+            public object AllocCompressor() => new();
+
+            public int InitCompressor(object compressorState, CompressionMethod compMethod) => 0;
+
+            public void DeinitCompressor(object compressorState) { }
+
+            public CompressionResult CompressBlock(object compressorState, ReadOnlyMemory<byte> input, Memory<byte> output)
+            {
+                int count = Math.Min(input.Length, output.Length);
+                input.Span[..count].CopyTo(output.Span);
+
+                return new() { BytesRead = count, BytesWritten = count };
+            }
+
+            public int Flush(object compressorState, Memory<byte> output) => 0;
+        }
+    }
+}
@@ -24,14 +24,18 @@
 
 using System;
 using System.IO;
+using System.Collections.Generic;
 using System.Net;
 using System.Diagnostics;
 using System.Net.Sockets;
+using System.Threading;
 using System.IO.Pipelines;
 using System.Threading.Tasks;
 using System.Threading.Tasks.Sources;
 using System.Runtime.InteropServices;
 
+using Microsoft.Win32.SafeHandles;
+
 using VNLib.Utils.Memory.Caching;
 
 namespace VNLib.Net.Transport.Tcp
@@ -52,6 +56,7 @@ namespace VNLib.Net.Transport.Tcp
 
         private Task _sendTask = Task.CompletedTask;
         private Task _recvTask = Task.CompletedTask;
+        private bool _aborted;
 
         public AwaitableAsyncServerSocket(PipeOptions options) : base()
         {
@@ -117,8 +122,10 @@ namespace VNLib.Net.Transport.Tcp
             //Wait for the send task to complete before disconnecting
             await _sendTask.ConfigureAwait(false);
 
-            //Disconnect the socket
-            SocketError error = await _allArgs.DisconnectAsync(_socket);
+            //An aborted socket is already closed and cannot be disconnected
+            SocketError error = Volatile.Read(ref _aborted)
+                ? SocketError.OperationAborted
+                : await _allArgs.DisconnectAsync(_socket);
 
             /*
              * Release hooks will take care of socket cleanup 
@@ -156,6 +163,18 @@ namespace VNLib.Net.Transport.Tcp
             return _allArgs.SendAsync(_socket, socketFlags);
         }
 
+        ///<inheritdoc/>
+        ValueTask<int> ISocketIo.SendAsync(IList<ArraySegment<byte>> buffers, SocketFlags socketFlags)
+        {
+            //Socket must always be defined as this function is called from the pipeline
+            Debug.Assert(_socket != null, "Socket is not connected");
+
+            //The whole list is submitted to the socket as a single gather send
+            _allArgs.BufferList = buffers;
+
+            return _allArgs.SendAsync(_socket, socketFlags);
+        }
+
         ///<inheritdoc/>
         ValueTask<int> ISocketIo.ReceiveAsync(Memory<byte> buffer, SocketFlags socketFlags)
         {
@@ -166,6 +185,56 @@ namespace VNLib.Net.Transport.Tcp
             return _recvArgs.ReceiveAsync(_socket, socketFlags);
         }
 
+        ///<inheritdoc/>
+        void ISocketIo.Abort()
+        {
+            Volatile.Write(ref _aborted, true);
+
+            //Closing the socket fails pending operations so their buffers and handles are released
+            _socket?.Dispose();
+        }
+
+        ///<inheritdoc/>
+        async ValueTask<int> ISocketIo.SendFileAsync(SafeFileHandle file, long offset, int count)
+        {
+            //Socket must always be defined as this function is called from the pipeline
+            Debug.Assert(_socket != null, "Socket is not connected");
+
+            bool addedRef = false;
+            FileStream? wrapper = null;
+
+            try
+            {
+                //Keep the caller's handle open while the socket is reading from it
+                file.DangerousAddRef(ref addedRef);
+
+                /*
+                 * Packet elements only accept async file streams. A file stream owns the 
+                 * handle it wraps, so disposing it would close the caller's handle, and 
+                 * a non-owning copy of the handle loses its async mode on Unix. An 
+                 * unbuffered stream holds no other resources, so the wrapper's finalizer 
+                 * is suppressed once the send completes instead.
+                 */
+                wrapper = new(file, FileAccess.Read, 0, file.IsAsync);
+
+                _allArgs.SendPacketsElements = [new SendPacketsElement(wrapper, offset, count, true)];
+
+                return await _allArgs.SendPacketsAsync(_socket).ConfigureAwait(false);
+            }
+            finally
+            {
+                if (wrapper != null)
+                {
+                    GC.SuppressFinalize(wrapper);
+                }
+
+                if (addedRef)
+                {
+                    file.DangerousRelease();
+                }
+            }
+        }
+
         void IReusable.Prepare()
         {
             Debug.Assert(_socket == null || IsWindows, "Exepcted stale socket to be NULL on non-Windows platform");
@@ -184,6 +253,8 @@ namespace VNLib.Net.Transport.Tcp
             _allArgs.Release();
             _recvArgs.Release();
 
+            _aborted = false;
+
             //if the socket is still 'connected' (or not windows), dispose it and clear the accept socket
             if (_socket?.Connected == true || !IsWindows)
             {
@@ -197,6 +268,16 @@ namespace VNLib.Net.Transport.Tcp
         ///<inheritdoc/>
         Stream ITcpConnectionDescriptor.GetStream() => SocketWorker.NetworkStream;
 
+        ///<inheritdoc/>
+        ValueTask ITcpConnectionDescriptor.SendFileAsync(SafeFileHandle file, long offset, long count, CancellationToken cancellation)
+        {
+            ArgumentNullException.ThrowIfNull(file);
+            ArgumentOutOfRangeException.ThrowIfNegative(offset);
+            ArgumentOutOfRangeException.ThrowIfNegative(count);
+
+            return SocketWorker.SendFileAsync(this, file, offset, count, cancellation);
+        }
+
         ///<inheritdoc/>
         void ITcpConnectionDescriptor.GetEndpoints(out IPEndPoint localEndpoint, out IPEndPoint remoteEndpoint)
         {
@@ -236,6 +317,8 @@ namespace VNLib.Net.Transport.Tcp
                 //Make sure any operation specific data is cleared
                 AcceptSocket = null;
                 UserToken = null;
+                BufferList = null;
+                SendPacketsElements = null;
                 SetBuffer(default);
             }
 
@@ -246,9 +329,12 @@ namespace VNLib.Net.Transport.Tcp
                 {
                     case SocketAsyncOperation.Receive:
                     case SocketAsyncOperation.Send:
+                    case SocketAsyncOperation.SendPackets:
 
                         //Clear buffer after async op
                         SetBuffer(default);
+                        BufferList = null;
+                        SendPacketsElements = null;
 
                         //If the operation was successfull, set the number of bytes transferred
                         if (SocketError == SocketError.Success)
@@ -341,13 +427,33 @@ namespace VNLib.Net.Transport.Tcp
                     return new ValueTask<int>(this, AsyncTaskCore.Version);
                 }
 
-                //clear buffer
+                //clear buffers
                 SetBuffer(default);
+                BufferList = null;
 
                 //Sync send
                 return GetSyncTxRxResult();
             }
 
+            public ValueTask<int> SendPacketsAsync(Socket socket)
+            {
+                SocketError = SocketError.Success;
+                SocketFlags = SocketFlags.None;
+
+                //Clear task source
+                AsyncTaskCore = default;
+
+                if (socket.SendPacketsAsync(this))
+                {
+                    return new ValueTask<int>(this, AsyncTaskCore.Version);
+                }
+
+                //Clear elements
+                SendPacketsElements = null;
+
+                return GetSyncTxRxResult();
+            }
+
             public ValueTask<int> ReceiveAsync(Socket socket, SocketFlags flags)
             {
                 //Store the semaphore in the user token event args 
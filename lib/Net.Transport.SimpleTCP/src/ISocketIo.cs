@@ -23,9 +23,12 @@
 */
 
 using System;
+using System.Collections.Generic;
 using System.Net.Sockets;
 using System.Threading.Tasks;
 
+using Microsoft.Win32.SafeHandles;
+
 
 
 namespace VNLib.Net.Transport.Tcp
@@ -34,6 +37,16 @@ namespace VNLib.Net.Transport.Tcp
     {
         ValueTask<int> SendAsync(ReadOnlyMemory<byte> buffer, SocketFlags socketFlags);
 
+        ValueTask<int> SendAsync(IList<ArraySegment<byte>> buffers, SocketFlags socketFlags);
+
         ValueTask<int> ReceiveAsync(Memory<byte> buffer, SocketFlags socketFlags);
+
+        ValueTask<int> SendFileAsync(SafeFileHandle file, long offset, int count);
+
+        /// <summary>
+        /// Closes the socket to abort any pending operations. The connection 
+        /// cannot be used or disconnected gracefully afterwards.
+        /// </summary>
+        void Abort();
     }
 }
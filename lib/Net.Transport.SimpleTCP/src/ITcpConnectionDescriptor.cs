@@ -24,6 +24,10 @@
 
 using System.IO;
 using System.Net;
+using System.Threading;
+using System.Threading.Tasks;
+
+using Microsoft.Win32.SafeHandles;
 
 namespace VNLib.Net.Transport.Tcp
 {
@@ -46,5 +50,21 @@ namespace VNLib.Net.Transport.Tcp
         /// You must dispose of this stream when you are done with it.
         /// </remarks>
         Stream GetStream();
+
+        /// <summary>
+        /// Sends a region of a file to the client directly from the file handle, 
+        /// without copying the file data through user-space buffers when the 
+        /// platform supports it (sendfile on Linux, TransmitPackets on Windows).
+        /// Data previously written to the connection stream is always sent first.
+        /// If the write timeout expires or the operation is canceled, the connection 
+        /// is aborted and the method returns only after the file handle is no longer 
+        /// in use.
+        /// </summary>
+        /// <param name="file">The handle of the file to send data from, it must be opened for asynchronous IO</param>
+        /// <param name="offset">The file offset of the first byte to send</param>
+        /// <param name="count">The number of bytes to send</param>
+        /// <param name="cancellation">A token to cancel waiting for the operation</param>
+        /// <returns>A value task that completes when the file region has been sent</returns>
+        ValueTask SendFileAsync(SafeFileHandle file, long offset, long count, CancellationToken cancellation);
     }
 }
\ No newline at end of file
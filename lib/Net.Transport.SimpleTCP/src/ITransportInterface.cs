@@ -24,6 +24,7 @@
 
 
 using System;
+using System.Buffers;
 using System.Threading;
 using System.Threading.Tasks;
 
@@ -68,5 +69,25 @@ namespace VNLib.Net.Transport.Tcp
         /// <returns>The number of bytes received</returns>
         int Recv(Span<byte> buffer, int timeout);
 
+        /// <summary>
+        /// Gets a writer that buffers data directly in the send pipeline. Written 
+        /// data is not sent until the next flush or send operation.
+        /// </summary>
+        IBufferWriter<byte> SendBuffer { get; }
+
+        /// <summary>
+        /// Publishes all data written to the <see cref="SendBuffer"/> to the socket
+        /// </summary>
+        /// <param name="timeout">The timeout in milliseconds</param>
+        /// <param name="cancellation">A token to cancel the operation</param>
+        /// <returns>A ValueTask that completes when the buffered data has been published</returns>
+        ValueTask FlushAsync(int timeout, CancellationToken cancellation);
+
+        /// <summary>
+        /// Publishes all data written to the <see cref="SendBuffer"/> to the socket synchronously
+        /// </summary>
+        /// <param name="timeout">The timeout in milliseconds</param>
+        void Flush(int timeout);
+
     }
 }
\ No newline at end of file
@@ -29,11 +29,16 @@
  * pipeline aspects, it supports full duplex IO but it is not thread safe.
  * 
  * IE one thread can read and write, but not more
+ * 
+ * The stream is also a buffer writer over the send pipeline, so callers 
+ * can write data directly into pipe memory and publish it with a flush, 
+ * instead of having it copied in by a write call.
  */
 
 
 using System;
 using System.IO;
+using System.Buffers;
 using System.Threading;
 using System.Threading.Tasks;
 
@@ -45,7 +50,7 @@ namespace VNLib.Net.Transport.Tcp
     /// <summary>
     /// A reusable stream that marshals data between the socket pipeline and the application
     /// </summary>
-    internal sealed class ReusableNetworkStream : Stream
+    internal sealed class ReusableNetworkStream : Stream, IBufferWriter<byte>
     {
         #region stream basics
         public override bool CanRead => true;
@@ -94,11 +99,20 @@ namespace VNLib.Net.Transport.Tcp
         { }
 
         ///<inheritdoc/>
-        public override Task FlushAsync(CancellationToken cancellationToken) => Task.CompletedTask;
+        public override Task FlushAsync(CancellationToken cancellationToken) 
+            => Transport.FlushAsync(_sendTimeoutMs, cancellationToken).AsTask();
 
         ///<inheritdoc/>
-        public override void Flush() 
-        { }
+        public override void Flush() => Transport.Flush(_sendTimeoutMs);
+
+        ///<inheritdoc/>
+        public void Advance(int count) => Transport.SendBuffer.Advance(count);
+
+        ///<inheritdoc/>
+        public Memory<byte> GetMemory(int sizeHint = 0) => Transport.SendBuffer.GetMemory(sizeHint);
+
+        ///<inheritdoc/>
+        public Span<byte> GetSpan(int sizeHint = 0) => Transport.SendBuffer.GetSpan(sizeHint);
 
         ///<inheritdoc/>
         public override int Read(byte[] buffer, int offset, int count) => Read(buffer.AsSpan(offset, count));
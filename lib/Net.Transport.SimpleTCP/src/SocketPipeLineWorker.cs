@@ -25,6 +25,7 @@
 using System;
 using System.IO;
 using System.Buffers;
+using System.Collections.Generic;
 using System.Threading;
 using System.Diagnostics;
 using System.Net.Sockets;
@@ -32,6 +33,8 @@ using System.IO.Pipelines;
 using System.Threading.Tasks;
 using System.Runtime.InteropServices;
 
+using Microsoft.Win32.SafeHandles;
+
 using VNLib.Utils.Memory;
 using VNLib.Utils.Memory.Caching;
 using VNLib.Utils.Extensions;
@@ -83,6 +86,9 @@ namespace VNLib.Net.Transport.Tcp
         public bool Release()
         {
             _sysSocketBufferSize = 0;
+            _fileSend = null;
+            _gatherList.Clear();
+            _sendComplete = false;
 
             //Only reset pipeline if it was started
             if (_started)
@@ -134,15 +140,22 @@ namespace VNLib.Net.Transport.Tcp
          * the pipes and the socket
          */
 
+        /*
+         * Caps the number of buffers submitted to a single gather send, 
+         * remaining segments are sent by the following calls
+         */
+        private const int MaxGatherSegments = 64;
+
+        private readonly List<ArraySegment<byte>> _gatherList = new(MaxGatherSegments);
         private ReadResult _sendReadRes;
         private int _sysSocketBufferSize;
+        private FileSendRequest? _fileSend;
+        private bool _sendComplete;
 
         public async Task SendDoWorkAsync<TIO>(TIO sock, int sendBufferSize)
             where TIO : ISocketIo
         {
             Exception? errCause = null;
-            ReadOnlySequence<byte>.Enumerator enumerator;
-            ForwardOnlyMemoryReader<byte> segmentReader;
 
             _started |= true;
 
@@ -156,8 +169,11 @@ namespace VNLib.Net.Transport.Tcp
                     //wait for data from the write pipe and write it to the socket
                     _sendReadRes = await SendPipe.Reader.ReadAsync(CancellationToken.None);
 
-                    //Catch error/cancel conditions and break the loop
-                    if (_sendReadRes.IsCanceled || _sendReadRes.Buffer.IsEmpty)
+                    /*
+                     * A canceled read is a request to send a file region, or an error 
+                     * condition if no file send is pending
+                     */
+                    if (_sendReadRes.IsCanceled ? Volatile.Read(ref _fileSend) == null : _sendReadRes.Buffer.IsEmpty)
                     {
                         break;
                     }
@@ -167,46 +183,38 @@ namespace VNLib.Net.Transport.Tcp
                      * there is still data to be written to the socket, so we must continue
                      */
 
-                    //Get enumerator to write memory segments
-                   enumerator = _sendReadRes.Buffer.GetEnumerator();
+                    ReadOnlySequence<byte> buffer = _sendReadRes.Buffer;
 
-                    //Begin enumerator
-                    while (enumerator.MoveNext())
+                    while (!buffer.IsEmpty)
                     {
-
                         /*
-                         * Using a foward only reader allows the following loop
-                         * to track the ammount of data written to the socket
-                         * until the entire segment has been sent or if it has
-                         * move to the next segment
+                         * Multi-segment sequences (usually headers followed by body data) 
+                         * are sent with a single gather send when the buffer pool is array 
+                         * backed. Partial writes simply slice the sequence and continue 
+                         * from the unsent data.
                          */
+                        int written = !buffer.IsSingleSegment && TryLoadGatherList(in buffer)
+                            ? await sock.SendAsync(_gatherList, SocketFlags.None)
+                            : await sock.SendAsync(GetFirstSegment(in buffer), SocketFlags.None);
 
-                        segmentReader = new(enumerator.Current);
-                         
-                        while(segmentReader.WindowSize > 0)
+                        //Nothing is sent when the connection was closed, the buffer would never drain
+                        if (written <= 0)
                         {
-                            //Write segment to socket, and upate written data
-                            int written = await sock.SendAsync(segmentReader.Window, SocketFlags.None);
-
-                            if(written < 0)
-                            {
-                                goto ExitOnSocketErr;
-                            }
-
-                            if(written == segmentReader.WindowSize)
-                            {
-                                //All data was written
-                                break;
-                            }
-
-                            //Advance unread window to end of the written data
-                            segmentReader.Advance(written);
-                        } 
-                        //Advance to next window/segment
+                            goto ExitOnSocketErr;
+                        }
+
+                        buffer = buffer.Slice(written);
                     }
                   
                     //Advance pipe
                     SendPipe.Reader.AdvanceTo(_sendReadRes.Buffer.End);
+
+                    //All data buffered before the file request has been sent, so the file data can follow it
+                    if (_sendReadRes.IsCanceled)
+                    {
+                        await SendPendingFileAsync(sock);
+                        continue;
+                    }
                     
                     //Pipe has been completed and all data was written
                     if (_sendReadRes.IsCompleted)
@@ -227,12 +235,82 @@ namespace VNLib.Net.Transport.Tcp
             {
                 _sendReadRes = default;
 
+                //Fail a file send that was requested after the last read
+                Volatile.Write(ref _sendComplete, true);
+                Interlocked.Exchange(ref _fileSend, null)?.TrySetException(new OperationCanceledException("The connection was closed before the file could be sent"));
+
                 //Complete the send pipe reader
                 await SendPipe.Reader.CompleteAsync(errCause);
             }
         }
 
 
+        private bool TryLoadGatherList(in ReadOnlySequence<byte> buffer)
+        {
+            _gatherList.Clear();
+
+            foreach (ReadOnlyMemory<byte> segment in buffer)
+            {
+                if (segment.IsEmpty)
+                {
+                    continue;
+                }
+
+                //Gather sends need array segments, unmanaged pool memory is sent one segment at a time
+                if (!MemoryMarshal.TryGetArray(segment, out ArraySegment<byte> array))
+                {
+                    _gatherList.Clear();
+                    return false;
+                }
+
+                _gatherList.Add(array);
+
+                if (_gatherList.Count == MaxGatherSegments)
+                {
+                    break;
+                }
+            }
+
+            return _gatherList.Count > 0;
+        }
+
+        private static ReadOnlyMemory<byte> GetFirstSegment(in ReadOnlySequence<byte> buffer)
+        {
+            //A sliced sequence may start at the end of a segment
+            foreach (ReadOnlyMemory<byte> segment in buffer)
+            {
+                if (!segment.IsEmpty)
+                {
+                    return segment;
+                }
+            }
+
+            return default;
+        }
+
+        private async Task SendPendingFileAsync<TIO>(TIO sock) where TIO : ISocketIo
+        {
+            FileSendRequest request = Interlocked.Exchange(ref _fileSend, null)!;
+
+            try
+            {
+                int sent = await sock.SendFileAsync(request.File, request.Offset, request.Count);
+
+                if (sent != request.Count)
+                {
+                    throw new IOException("The socket did not send the entire file region");
+                }
+
+                request.TrySetResult();
+            }
+            catch (Exception ex)
+            {
+                request.TrySetException(ex);
+                throw;
+            }
+        }
+
+
         private FlushResult _recvFlushRes;
 
         public async Task RecvDoWorkAsync<TIO>(TIO sock, int bytesTransferred, int recvBufferSize)
@@ -393,6 +471,11 @@ namespace VNLib.Net.Transport.Tcp
             //Publish send data to send pipe
             CopyAndPublishDataOnSendPipe(data, _sysSocketBufferSize, SendPipe.Writer);
 
+            return FlushAsync(timeout, cancellation);
+        }
+
+        private ValueTask FlushAsync(int timeout, CancellationToken cancellation)
+        {
             //See if timer is required
             if (timeout < 1)
             {
@@ -415,6 +498,81 @@ namespace VNLib.Net.Transport.Tcp
             return SendAsync(data.Span, timeout, cancellation);
         }
 
+        IBufferWriter<byte> ITransportInterface.SendBuffer => SendPipe.Writer;
+
+        ValueTask ITransportInterface.FlushAsync(int timeout, CancellationToken cancellation) => FlushAsync(timeout, cancellation);
+
+        void ITransportInterface.Flush(int timeout) => WaitForCompletion(FlushAsync(timeout, CancellationToken.None));
+
+        /*
+         * Files are sent in segments so the write timeout applies to the 
+         * progress of the transfer rather than the size of the entire file
+         */
+        private const int MaxFileSegmentSize = 4 * 1024 * 1024;
+
+        /// <summary>
+        /// Sends a region of a file after all data currently buffered 
+        /// in the send pipe has been written to the socket
+        /// </summary>
+        /// <param name="sock">The socket the send loop writes to, it is aborted if the send times out</param>
+        /// <param name="file">The handle of the file to send</param>
+        /// <param name="offset">The offset within the file to begin sending from</param>
+        /// <param name="count">The number of bytes to send</param>
+        /// <param name="cancellation">A token to cancel waiting for the operation</param>
+        /// <returns>A value task that completes when the file region has been sent</returns>
+        internal async ValueTask SendFileAsync<TIO>(TIO sock, SafeFileHandle file, long offset, long count, CancellationToken cancellation)
+            where TIO : ISocketIo
+        {
+            int timeout = NetworkStream.WriteTimeout;
+
+            //Data written directly to the send buffer must be published so it is sent ahead of the file
+            await FlushAsync(timeout, cancellation).ConfigureAwait(false);
+
+            while (count > 0)
+            {
+                int segment = (int)Math.Min(count, MaxFileSegmentSize);
+
+                FileSendRequest request = new(file, offset, segment);
+
+                Debug.Assert(_fileSend == null, "A file send was requested while another file send was pending");
+
+                Interlocked.Exchange(ref _fileSend, request);
+
+                //The send loop may have already exited, so the request will never be picked up
+                if (Volatile.Read(ref _sendComplete))
+                {
+                    request.TrySetException(new OperationCanceledException("The connection was closed before the file could be sent"));
+                }
+
+                //Wake the send loop, it will send the segment once all buffered data has been sent
+                SendPipe.Reader.CancelPendingRead();
+
+                try
+                {
+                    await (timeout < 1
+                        ? request.Task.WaitAsync(cancellation)
+                        : request.Task.WaitAsync(TimeSpan.FromMilliseconds(timeout), cancellation)
+                    ).ConfigureAwait(false);
+                }
+                catch (Exception ex) when (ex is TimeoutException or OperationCanceledException && !request.Task.IsCompleted)
+                {
+                    /*
+                     * The kernel may still be reading from the file handle, so the socket 
+                     * is closed to abort the send, and the request must complete before 
+                     * the caller is allowed to release the handle
+                     */
+                    sock.Abort();
+
+                    await request.Task.ConfigureAwait(ConfigureAwaitOptions.SuppressThrowing);
+
+                    throw new OperationCanceledException("The write operation was canceled by the underlying PipeWriter", ex);
+                }
+
+                offset += segment;
+                count -= segment;
+            }
+        }
+
         private static void CopyAndPublishDataOnSendPipe<TWriter>(ReadOnlySpan<byte> src, int bufferSize, TWriter writer)
             where TWriter: IBufferWriter<byte>
         {
@@ -451,8 +609,11 @@ namespace VNLib.Net.Transport.Tcp
         void ITransportInterface.Send(ReadOnlySpan<byte> data, int timeout)
         {
             //Call async send and wait for completion
-            ValueTask result = SendAsync(data, timeout, CancellationToken.None);
+            WaitForCompletion(SendAsync(data, timeout, CancellationToken.None));
+        }
 
+        private static void WaitForCompletion(ValueTask result)
+        {
             //If the task is completed, then it was sync, so get the result
             if (result.IsCompleted)
             {
@@ -555,6 +716,14 @@ namespace VNLib.Net.Transport.Tcp
             }
         }
 
+        private sealed class FileSendRequest(SafeFileHandle file, long offset, int count)
+            : TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously)
+        {
+            public readonly SafeFileHandle File = file;
+            public readonly long Offset = offset;
+            public readonly int Count = count;
+        }
+
         private interface INetTimer
         {
             void Start();
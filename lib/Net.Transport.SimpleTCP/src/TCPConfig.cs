@@ -70,7 +70,9 @@ namespace VNLib.Net.Transport.Tcp
         /// </summary>
         public readonly int BackLog { get; init; }
         /// <summary>
-        /// The <see cref="MemoryPool{T}"/> to allocate transport buffers from
+        /// The <see cref="MemoryPool{T}"/> to allocate transport buffers from. Buffered 
+        /// send data is only submitted to the socket in a single gather send when the 
+        /// pool is array backed, such as <see cref="MemoryPool{T}.Shared"/>.
         /// </summary>
         public readonly MemoryPool<byte> BufferPool { get; init; }
         /// <summary>
@@ -0,0 +1,189 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Buffers;
+using System.IO.Pipelines;
+using System.Net.Sockets;
+using System.Security.Cryptography;
+
+using Microsoft.Win32.SafeHandles;
+
+using VNLib.Utils.Memory;
+using VNLib.Utils.Extensions;
+
+namespace VNLib.Net.Transport.Tcp.Tests
+{
+    [TestClass()]
+    public class SocketPipeLineWorkerTests
+    {
+        [TestMethod()]
+        public async Task GatherSendWithArrayPoolTest()
+        {
+            PipeOptions options = new(
+                MemoryPool<byte>.Shared,
+                minimumSegmentSize: 4096,
+                useSynchronizationContext: false
+            );
+
+            RecordingSocket socket = await SendThroughWorkerAsync(options, out byte[] data);
+
+            Assert.IsTrue(socket.GatherSends > 0, "Buffered segments were not submitted with a gather send");
+            Assert.AreEqual(0, socket.SingleSends);
+            Assert.IsTrue(data.AsSpan().SequenceEqual(socket.Received.ToArray()));
+        }
+
+        [TestMethod()]
+        public async Task UnmanagedPoolFallsBackToSingleSendsTest()
+        {
+            //The default transport pool is backed by the unmanaged heap, which cannot be gathered
+            PipeOptions options = new(
+                MemoryUtil.Shared.ToPool<byte>(),
+                minimumSegmentSize: 4096,
+                useSynchronizationContext: false
+            );
+
+            RecordingSocket socket = await SendThroughWorkerAsync(options, out byte[] data);
+
+            Assert.AreEqual(0, socket.GatherSends);
+            Assert.IsTrue(socket.SingleSends > 0);
+            Assert.IsTrue(data.AsSpan().SequenceEqual(socket.Received.ToArray()));
+        }
+
+        [TestMethod()]
+        public async Task ZeroByteSendExitsTest()
+        {
+            foreach (MemoryPool<byte> pool in new[] { MemoryPool<byte>.Shared, MemoryUtil.Shared.ToPool<byte>() })
+            {
+                SocketPipeLineWorker worker = new(new PipeOptions(pool, minimumSegmentSize: 4096, useSynchronizationContext: false));
+                RecordingSocket socket = new() { Closed = true };
+
+                Task sendTask = worker.SendDoWorkAsync(socket, 8192);
+
+                //Publish multiple segments without waiting for the socket, it never accepts any data
+                byte[] data = RandomNumberGenerator.GetBytes(32 * 1024);
+                _ = ((ITransportInterface)worker).SendAsync(data, Timeout.Infinite, CancellationToken.None).AsTask();
+
+                //The send loop must treat the closed socket as an exit instead of retrying forever
+                await sendTask.WaitAsync(TimeSpan.FromSeconds(5));
+
+                Assert.AreEqual(0, socket.Received.Length);
+            }
+        }
+
+        private static Task<RecordingSocket> SendThroughWorkerAsync(PipeOptions options, out byte[] data)
+        {
+            //Data is published in socket buffer sized blocks, so it spans multiple pipe segments
+            data = RandomNumberGenerator.GetBytes(32 * 1024);
+            return SendThroughWorkerAsync(options, data);
+        }
+
+        private static async Task<RecordingSocket> SendThroughWorkerAsync(PipeOptions options, byte[] data)
+        {
+            SocketPipeLineWorker worker = new(options);
+            RecordingSocket socket = new();
+
+            Task sendTask = worker.SendDoWorkAsync(socket, 8192);
+
+            await ((ITransportInterface)worker).SendAsync(data, Timeout.Infinite, CancellationToken.None);
+            await worker.ShutDownClientPipeAsync();
+            await sendTask;
+
+            return socket;
+        }
+
+        [TestMethod()]
+        public async Task FileSendTimeoutAbortsSocketTest()
+        {
+            PipeOptions options = new(useSynchronizationContext: false);
+
+            SocketPipeLineWorker worker = new(options);
+            RecordingSocket socket = new();
+
+            Task sendTask = worker.SendDoWorkAsync(socket, 8192);
+
+            worker.NetworkStream.WriteTimeout = 100;
+
+            string path = Path.GetTempFileName();
+
+            try
+            {
+                using (SafeFileHandle file = File.OpenHandle(path))
+                {
+                    //The socket never completes the file send, so the timeout must abort it
+                    await Assert.ThrowsExceptionAsync<OperationCanceledException>(
+                        () => worker.SendFileAsync(socket, file, 0, 1024, CancellationToken.None).AsTask()
+                    );
+
+                    Assert.IsTrue(socket.Aborted);
+
+                    //The handle must no longer be in use once the send returns
+                    Assert.IsTrue(socket.PendingFileSend.Task.IsCompleted);
+                }
+
+                await worker.ShutDownClientPipeAsync();
+                await sendTask;
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+
+        private sealed class RecordingSocket : ISocketIo
+        {
+            public readonly MemoryStream Received = new();
+
+            public int GatherSends;
+
+            public int SingleSends;
+
+            public bool Aborted;
+
+            //A closed socket accepts no data
+            public bool Closed;
+
+            public readonly TaskCompletionSource<int> PendingFileSend = new();
+
+            public ValueTask<int> SendAsync(ReadOnlyMemory<byte> buffer, SocketFlags socketFlags)
+            {
+                SingleSends++;
+
+                if (Closed)
+                {
+                    return ValueTask.FromResult(0);
+                }
+
+                Received.Write(buffer.Span);
+                return ValueTask.FromResult(buffer.Length);
+            }
+
+            public ValueTask<int> SendAsync(IList<ArraySegment<byte>> buffers, SocketFlags socketFlags)
+            {
+                GatherSends++;
+
+                if (Closed)
+                {
+                    return ValueTask.FromResult(0);
+                }
+
+                int written = 0;
+                foreach (ArraySegment<byte> segment in buffers)
+                {
+                    Received.Write(segment);
+                    written += segment.Count;
+                }
+
+                return ValueTask.FromResult(written);
+            }
+
+            public ValueTask<int> ReceiveAsync(Memory<byte> buffer, SocketFlags socketFlags) => ValueTask.FromResult(0);
+
+            public ValueTask<int> SendFileAsync(SafeFileHandle file, long offset, int count) => new(PendingFileSend.Task);
+
+            public void Abort()
+            {
+                Aborted = true;
+                PendingFileSend.TrySetException(new SocketException((int)SocketError.OperationAborted));
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using System.Net;
+using System.Buffers;
+using System.Net.Sockets;
+using System.Security.Cryptography;
+
+using Microsoft.Win32.SafeHandles;
+
+using VNLib.Utils.Logging;
+
+namespace VNLib.Net.Transport.Tcp.Tests
+{
+    [TestClass()]
+    public class TcpServerFileSendTests
+    {
+        [TestMethod()]
+        public async Task SendFileKeepsHandleOpenTest()
+        {
+            byte[] head = "file follows\r\n"u8.ToArray();
+            byte[] fileData = RandomNumberGenerator.GetBytes(256 * 1024);
+
+            string path = Path.GetTempFileName();
+            await File.WriteAllBytesAsync(path, fileData);
+
+            using CancellationTokenSource cts = new(TimeSpan.FromSeconds(30));
+            IPEndPoint? endpoint = null;
+
+            TcpServer server = new(new TCPConfig
+            {
+                LocalEndPoint = new(IPAddress.Loopback, 0),
+                Log = new NullLog(),
+                AcceptThreads = 1,
+                MaxRecvBufferData = 8192,
+                BackLog = 10,
+                BufferPool = MemoryPool<byte>.Shared,
+                OnSocketCreated = sock => endpoint = (IPEndPoint)sock.LocalEndPoint!
+            });
+
+            Task listening = server.Start(cts.Token);
+
+            try
+            {
+                using TcpClient client = new();
+                await client.ConnectAsync(endpoint!);
+
+                ITcpConnectionDescriptor connection = await server.AcceptConnectionAsync(cts.Token);
+
+                //Packet sends require a handle opened for async io
+                using (SafeFileHandle file = File.OpenHandle(path, options: FileOptions.Asynchronous))
+                {
+                    await using (Stream stream = connection.GetStream())
+                    {
+                        //Data buffered on the stream must be sent ahead of the file
+                        await stream.WriteAsync(head);
+
+                        //Send the region in two parts using the same handle
+                        await connection.SendFileAsync(file, 0, 1000, cts.Token);
+                        await connection.SendFileAsync(file, 1000, fileData.Length - 1000, cts.Token);
+                    }
+
+                    //The transport must not close or leak ownership of the caller's handle
+                    Assert.IsFalse(file.IsClosed);
+                    Assert.AreEqual(1, RandomAccess.Read(file, new byte[1], 0));
+                }
+
+                byte[] expected = [.. head, .. fileData];
+                byte[] received = new byte[expected.Length];
+
+                await client.GetStream().ReadExactlyAsync(received, cts.Token);
+
+                CollectionAssert.AreEqual(expected, received);
+
+                await server.CloseConnectionAsync(connection, false);
+            }
+            finally
+            {
+                cts.Cancel();
+                await listening.ConfigureAwait(ConfigureAwaitOptions.SuppressThrowing);
+                File.Delete(path);
+            }
+        }
+
+        private sealed class NullLog : ILogProvider
+        {
+            public void Flush() { }
+
+            public object GetLogProvider() => this;
+
+            public bool IsEnabled(LogLevel level) => false;
+
+            public void Write(LogLevel level, string value) { }
+
+            public void Write(LogLevel level, Exception exception, string value = "") { }
+
+            public void Write(LogLevel level, string value, params object?[] args) { }
+
+            public void Write(LogLevel level, string value, params ValueType[] args) { }
+        }
+    }
+}
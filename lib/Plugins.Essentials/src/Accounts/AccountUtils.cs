@@ -212,6 +212,44 @@ namespace VNLib.Plugins.Essentials.Accounts
             return provider.Hash(password.ToReadOnlySpan());
         }
 
+        /// <summary>
+        /// Verifies a password against its previously encoded hash without blocking
+        /// the calling thread on the hashing operation.
+        /// </summary>
+        /// <param name="provider"></param>
+        /// <param name="passHash">Previously hashed password</param>
+        /// <param name="password">Raw password to compare against</param>
+        /// <param name="cancellation">A token that cancels the operation if it has not started yet</param>
+        /// <returns>A value task that resolves true if bytes derrived from password match the hash, false otherwise</returns>
+        /// <exception cref="NotSupportedException"></exception>
+        /// <remarks>The private strings must not be disposed until the operation completes</remarks>
+        public static ValueTask<bool> VerifyAsync(this IPasswordHashingProvider provider, PrivateString passHash, PrivateString password, CancellationToken cancellation = default)
+        {
+            ArgumentNullException.ThrowIfNull(provider);
+            ArgumentNullException.ThrowIfNull(passHash);
+            ArgumentNullException.ThrowIfNull(password);
+
+            //Casting PrivateStrings to strings will reference the base string directly
+            return provider.VerifyAsync(((string)passHash!).AsMemory(), ((string)password!).AsMemory(), cancellation);
+        }
+
+        /// <summary>
+        /// Hashes a specified password without blocking the calling thread on the hashing operation.
+        /// </summary>
+        /// <param name="provider"></param>
+        /// <param name="password">Password to be hashed</param>
+        /// <param name="cancellation">A token that cancels the operation if it has not started yet</param>
+        /// <exception cref="NotSupportedException"></exception>
+        /// <returns>A value task that resolves a <see cref="PrivateString"/> of the hashed and encoded password</returns>
+        /// <remarks>The private string must not be disposed until the operation completes</remarks>
+        public static ValueTask<PrivateString> HashAsync(this IPasswordHashingProvider provider, PrivateString password, CancellationToken cancellation = default)
+        {
+            ArgumentNullException.ThrowIfNull(provider);
+            ArgumentNullException.ThrowIfNull(password);
+
+            return provider.HashAsync(((string)password!).AsMemory(), cancellation);
+        }
+
         #endregion
 
 
@@ -23,6 +23,8 @@
 */
 
 using System;
+using System.Threading;
+using System.Threading.Tasks;
 
 using VNLib.Utils;
 using VNLib.Utils.Memory;
@@ -76,5 +78,36 @@ namespace VNLib.Plugins.Essentials.Accounts
         /// <returns>The number of bytes written to the hash buffer, or 0/false if the hashing operation failed</returns>
         /// <exception cref="NotSupportedException"></exception>
         ERRNO Hash(ReadOnlySpan<byte> password, Span<byte> hashOutput);
+
+        /// <summary>
+        /// Verifies a password against its previously encoded hash without blocking 
+        /// the calling thread on the hashing operation. 
+        /// </summary>
+        /// <param name="passHash">Previously hashed password</param>
+        /// <param name="password">Raw password to compare against</param>
+        /// <param name="cancellation">A token that cancels the operation if it has not started yet</param>
+        /// <returns>A value task that resolves true if bytes derrived from password match the hash, false otherwise</returns>
+        /// <remarks>
+        /// The buffers must not be modified until the operation completes. The default 
+        /// implementation verifies synchronously on the calling thread.
+        /// </remarks>
+        /// <exception cref="NotSupportedException"></exception>
+        ValueTask<bool> VerifyAsync(ReadOnlyMemory<char> passHash, ReadOnlyMemory<char> password, CancellationToken cancellation = default) 
+            => ValueTask.FromResult(Verify(passHash.Span, password.Span));
+
+        /// <summary>
+        /// Calculates the cryptographic hash of the specified character encoded password 
+        /// without blocking the calling thread on the hashing operation.
+        /// </summary>
+        /// <param name="password">The character encoded password to encrypt</param>
+        /// <param name="cancellation">A token that cancels the operation if it has not started yet</param>
+        /// <returns>A value task that resolves a <see cref="PrivateString"/> containing the new password hash.</returns>
+        /// <remarks>
+        /// The buffer must not be modified until the operation completes. The default 
+        /// implementation hashes synchronously on the calling thread.
+        /// </remarks>
+        /// <exception cref="NotSupportedException"></exception>
+        ValueTask<PrivateString> HashAsync(ReadOnlyMemory<char> password, CancellationToken cancellation = default)
+            => ValueTask.FromResult(Hash(password.Span));
     }
 }
\ No newline at end of file
@@ -23,6 +23,8 @@
 */
 
 using System;
+using System.Threading;
+using System.Threading.Tasks;
 using System.Security.Cryptography;
 
 using VNLib.Hashing;
@@ -52,13 +54,15 @@ namespace VNLib.Plugins.Essentials.Accounts
         private readonly ISecretProvider _secret;
         private readonly IArgon2Library _argon2;
         private readonly Argon2ConfigParams _config;
+        private readonly PasswordHashingScheduler? _scheduler;
         
-        private PasswordHashing(IArgon2Library library, ISecretProvider secret, in Argon2ConfigParams setup)
+        private PasswordHashing(IArgon2Library library, ISecretProvider secret, in Argon2ConfigParams setup, PasswordHashingScheduler? scheduler)
         {
             //Store getter
             _secret = secret ?? throw new ArgumentNullException(nameof(secret));
             _argon2 = library ?? throw new ArgumentNullException(nameof(library));
             _config = setup;
+            _scheduler = scheduler;
         }
 
         /// <summary>
@@ -69,7 +73,24 @@ namespace VNLib.Plugins.Essentials.Accounts
         /// <param name="setup">The configuration setup arguments</param>
         /// <returns>The instance of the library to use</returns>
         public static PasswordHashing Create(IArgon2Library library, ISecretProvider secret, in Argon2ConfigParams setup) 
-            => new (library, secret, in setup);
+            => new (library, secret, in setup, null);
+
+        /// <summary>
+        /// Creates a new <see cref="PasswordHashing"/> instance using the specified library
+        /// that runs <see cref="HashAsync"/> and <see cref="VerifyAsync"/> operations on 
+        /// the specified scheduler.
+        /// </summary>
+        /// <param name="library">The library instance to use</param>
+        /// <param name="secret">The password secret provider</param>
+        /// <param name="setup">The configuration setup arguments</param>
+        /// <param name="scheduler">The scheduler that runs asynchronous hashing operations</param>
+        /// <returns>The instance of the library to use</returns>
+        /// <exception cref="ArgumentNullException"></exception>
+        public static PasswordHashing Create(IArgon2Library library, ISecretProvider secret, in Argon2ConfigParams setup, PasswordHashingScheduler scheduler)
+        {
+            ArgumentNullException.ThrowIfNull(scheduler);
+            return new(library, secret, in setup, scheduler);
+        }
 
         /// <summary>
         /// Creates a new <see cref="PasswordHashing"/> instance using the default 
@@ -82,6 +103,41 @@ namespace VNLib.Plugins.Essentials.Accounts
         public static PasswordHashing Create(ISecretProvider secret, in Argon2ConfigParams setup) 
             => Create(VnArgon2.GetOrLoadSharedLib(), secret, in setup);
 
+        /// <summary>
+        /// Calibrates Argon2 cost parameters for the current host using the specified
+        /// library, see <see cref="VnArgon2.Calibrate2id(IArgon2Library, Argon2CalibrationOptions)"/>.
+        /// The salt and hash length are copied from the base configuration.
+        /// </summary>
+        /// <param name="library">The library that will be used to hash passwords</param>
+        /// <param name="options">The latency target and search bounds</param>
+        /// <param name="baseConfig">The configuration to copy non-cost parameters from</param>
+        /// <returns>The calibrated configuration parameters</returns>
+        /// <exception cref="VnArgon2Exception"></exception>
+        /// <exception cref="ArgumentException"></exception>
+        public static Argon2ConfigParams Calibrate(IArgon2Library library, Argon2CalibrationOptions options, in Argon2ConfigParams baseConfig)
+        {
+            Argon2CalibrationResult result = library.Calibrate2id(options);
+
+            return baseConfig with
+            {
+                TimeCost = result.TimeCost,
+                MemoryCost = result.MemoryCost,
+                Parallelism = result.Parallelism
+            };
+        }
+
+        /// <summary>
+        /// Calibrates Argon2 cost parameters for the current host using the default
+        /// <see cref="VnArgon2"/> library and the default salt and hash lengths.
+        /// </summary>
+        /// <param name="options">The latency target and search bounds</param>
+        /// <returns>The calibrated configuration parameters</returns>
+        /// <exception cref="VnArgon2Exception"></exception>
+        /// <exception cref="ArgumentException"></exception>
+        /// <exception cref="DllNotFoundException"></exception>
+        public static Argon2ConfigParams Calibrate(Argon2CalibrationOptions options)
+            => Calibrate(VnArgon2.GetOrLoadSharedLib(), options, new Argon2ConfigParams());
+
         private Argon2CostParams GetCostParams()
         {
             return new Argon2CostParams
@@ -137,6 +193,51 @@ namespace VNLib.Plugins.Essentials.Accounts
             }
         }
 
+        ///<inheritdoc/>
+        ///<exception cref="VnArgon2Exception"></exception>
+        ///<exception cref="VnArgon2PasswordFormatException"></exception>
+        ///<exception cref="PasswordHashingQueueFullException"></exception>
+        ///<exception cref="ObjectDisposedException"></exception>
+        ///<remarks>
+        /// When created with a <see cref="PasswordHashingScheduler"/> the hash runs on one of
+        /// its workers, otherwise it runs synchronously on the calling thread
+        /// </remarks>
+        public ValueTask<bool> VerifyAsync(ReadOnlyMemory<char> passHash, ReadOnlyMemory<char> password, CancellationToken cancellation = default)
+        {
+            if (_scheduler == null)
+            {
+                return ValueTask.FromResult(Verify(passHash.Span, password.Span));
+            }
+
+            return _scheduler.ScheduleAsync(
+                static s => s.self.Verify(s.passHash.Span, s.password.Span), 
+                (self: this, passHash, password), 
+                cancellation
+            );
+        }
+
+        ///<inheritdoc/>
+        ///<exception cref="VnArgon2Exception"></exception>
+        ///<exception cref="PasswordHashingQueueFullException"></exception>
+        ///<exception cref="ObjectDisposedException"></exception>
+        ///<remarks>
+        /// When created with a <see cref="PasswordHashingScheduler"/> the hash runs on one of
+        /// its workers, otherwise it runs synchronously on the calling thread
+        /// </remarks>
+        public ValueTask<PrivateString> HashAsync(ReadOnlyMemory<char> password, CancellationToken cancellation = default)
+        {
+            if (_scheduler == null)
+            {
+                return ValueTask.FromResult(Hash(password.Span));
+            }
+
+            return _scheduler.ScheduleAsync(
+                static s => s.self.Hash(s.password.Span), 
+                (self: this, password), 
+                cancellation
+            );
+        }
+
         /// <summary>
         /// Verifies a password against its hash. Partially exposes the Argon2 api.
         /// </summary>
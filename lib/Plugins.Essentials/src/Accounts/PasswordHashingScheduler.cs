@@ -0,0 +1,267 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Plugins.Essentials
+* File: PasswordHashingScheduler.cs 
+*
+* PasswordHashingScheduler.cs is part of VNLib.Plugins.Essentials which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Plugins.Essentials is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Plugins.Essentials is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Threading;
+using System.Diagnostics;
+using System.Threading.Tasks;
+using System.Collections.Concurrent;
+
+namespace VNLib.Plugins.Essentials.Accounts
+{
+    /// <summary>
+    /// Runs password hashing operations on a fixed number of dedicated worker threads 
+    /// behind a bounded queue. Memory-hard hashing never runs on thread pool threads, so 
+    /// a burst of logins cannot starve the rest of the server, and operations beyond the 
+    /// queue depth are rejected immediately instead of piling up.
+    /// </summary>
+    public sealed class PasswordHashingScheduler : IDisposable
+    {
+        private readonly BlockingCollection<WorkItem> _queue;
+        private readonly Thread[] _workers;
+        private volatile bool _disposed;
+        private int _runningWorkers;
+
+        /// <summary>
+        /// The number of worker threads hashing concurrently
+        /// </summary>
+        public int WorkerCount => _workers.Length;
+
+        /// <summary>
+        /// The maximum number of operations that may wait for a worker before new 
+        /// operations are rejected
+        /// </summary>
+        public int MaxQueueDepth { get; }
+
+        /// <summary>
+        /// The number of operations currently waiting for a worker
+        /// </summary>
+        public int QueueDepth => _disposed ? 0 : _queue.Count;
+
+        /// <summary>
+        /// Creates a new scheduler and starts its worker threads
+        /// </summary>
+        /// <param name="workerCount">The maximum number of hashes to run concurrently</param>
+        /// <param name="maxQueueDepth">The maximum number of operations that may wait for a worker</param>
+        /// <param name="memoryBudgetBytes">The total work area memory all concurrent hashes may use</param>
+        /// <param name="memoryCostKb">The Argon2 memory cost (in KiB) of a single hash</param>
+        /// <remarks>
+        /// The worker count is reduced so <paramref name="workerCount"/> hashes of 
+        /// <paramref name="memoryCostKb"/> fit in the memory budget, at least one worker 
+        /// is always started.
+        /// </remarks>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public PasswordHashingScheduler(int workerCount, int maxQueueDepth, long memoryBudgetBytes, uint memoryCostKb)
+        {
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(workerCount);
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(maxQueueDepth);
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(memoryBudgetBytes);
+            ArgumentOutOfRangeException.ThrowIfZero(memoryCostKb);
+
+            //Never run more hashes than the memory budget can hold at once
+            long memoryWorkers = memoryBudgetBytes / ((long)memoryCostKb * 1024);
+            workerCount = (int)Math.Clamp(memoryWorkers, 1, workerCount);
+
+            MaxQueueDepth = maxQueueDepth;
+            _queue = new(new ConcurrentQueue<WorkItem>(), maxQueueDepth);
+            _workers = new Thread[workerCount];
+            _runningWorkers = workerCount;
+
+            for (int i = 0; i < workerCount; i++)
+            {
+                _workers[i] = new Thread(WorkerLoop)
+                {
+                    IsBackground = true,
+                    Name = $"Password hashing worker {i}"
+                };
+
+                _workers[i].Start();
+            }
+        }
+
+        /// <summary>
+        /// Creates a new scheduler sized for the specified Argon2 configuration
+        /// </summary>
+        /// <param name="config">The Argon2 configuration the scheduled operations will hash with</param>
+        /// <param name="memoryBudgetBytes">The total work area memory all concurrent hashes may use</param>
+        /// <param name="maxQueueDepth">The maximum number of operations that may wait for a worker</param>
+        /// <returns>The new scheduler</returns>
+        /// <exception cref="ArgumentOutOfRangeException"></exception>
+        public static PasswordHashingScheduler Create(in Argon2ConfigParams config, long memoryBudgetBytes, int maxQueueDepth)
+        {
+            //Hashes with multiple lanes use multiple threads, so fewer hashes can run at once without oversubscribing
+            int workers = Math.Max(1, Environment.ProcessorCount / (int)Math.Max(1, config.Parallelism));
+            return new(workers, maxQueueDepth, memoryBudgetBytes, config.MemoryCost);
+        }
+
+        /// <summary>
+        /// Queues an operation to run on a hashing worker thread
+        /// </summary>
+        /// <typeparam name="TState">The type of the state passed to the operation</typeparam>
+        /// <typeparam name="TResult">The result type of the operation</typeparam>
+        /// <param name="operation">The operation to run</param>
+        /// <param name="state">The state to pass to the operation</param>
+        /// <param name="cancellation">A token that cancels the operation if it has not started yet</param>
+        /// <returns>A value task that completes with the result of the operation</returns>
+        /// <exception cref="ObjectDisposedException"></exception>
+        /// <exception cref="PasswordHashingQueueFullException"></exception>
+        public ValueTask<TResult> ScheduleAsync<TState, TResult>(Func<TState, TResult> operation, TState state, CancellationToken cancellation = default)
+        {
+            ArgumentNullException.ThrowIfNull(operation);
+            ObjectDisposedException.ThrowIf(_disposed, this);
+
+            if (cancellation.IsCancellationRequested)
+            {
+                return ValueTask.FromCanceled<TResult>(cancellation);
+            }
+
+            WorkItem<TState, TResult> item = new(operation, state, cancellation);
+
+            bool added;
+            try
+            {
+                //Never block the caller, a full queue rejects the operation immediately
+                added = _queue.TryAdd(item);
+            }
+            catch (Exception ex) when (ex is InvalidOperationException or ObjectDisposedException)
+            {
+                //Adding was completed by a concurrent dispose, or the last worker already released the queue
+                item.Discard();
+                throw new ObjectDisposedException(nameof(PasswordHashingScheduler));
+            }
+
+            if (!added)
+            {
+                item.Discard();
+                throw new PasswordHashingQueueFullException("The password hashing queue is full, try again later");
+            }
+
+            return new ValueTask<TResult>(item.Task);
+        }
+
+        private void WorkerLoop()
+        {
+            foreach (WorkItem item in _queue.GetConsumingEnumerable())
+            {
+                if (_disposed)
+                {
+                    item.Abort(new ObjectDisposedException(nameof(PasswordHashingScheduler)));
+                    continue;
+                }
+
+                item.Execute();
+            }
+
+            //The last worker to exit releases the queue once it has been drained
+            if (Interlocked.Decrement(ref _runningWorkers) == 0)
+            {
+                _queue.Dispose();
+            }
+        }
+
+        /// <summary>
+        /// Stops accepting new operations and fails all queued operations that have not 
+        /// started with an <see cref="ObjectDisposedException"/>. Operations already 
+        /// running are allowed to complete, the queue is released when the workers exit.
+        /// </summary>
+        public void Dispose()
+        {
+            if (_disposed)
+            {
+                return;
+            }
+
+            _disposed = true;
+            _queue.CompleteAdding();
+        }
+
+        private abstract class WorkItem
+        {
+            public abstract void Execute();
+
+            public abstract void Abort(Exception reason);
+        }
+
+        private sealed class WorkItem<TState, TResult> : WorkItem
+        {
+            /*
+             * Continuations must never run inline on the hashing worker, or 
+             * request processing would steal time from the hashing threads
+             */
+            private readonly TaskCompletionSource<TResult> _completion = new(TaskCreationOptions.RunContinuationsAsynchronously);
+            private readonly Func<TState, TResult> _operation;
+            private readonly TState _state;
+            private readonly CancellationToken _cancellation;
+            private readonly CancellationTokenRegistration _registration;
+
+            public WorkItem(Func<TState, TResult> operation, TState state, CancellationToken cancellation)
+            {
+                _operation = operation;
+                _state = state;
+                _cancellation = cancellation;
+
+                //Release the caller as soon as it gives up, the worker will skip the item when it is dequeued
+                _registration = cancellation.UnsafeRegister(
+                    static (s, token) => ((TaskCompletionSource<TResult>)s!).TrySetCanceled(token), 
+                    _completion
+                );
+            }
+
+            public Task<TResult> Task => _completion.Task;
+
+            /// <summary>
+            /// Releases the cancellation registration of an item that was never queued
+            /// </summary>
+            public void Discard() => _registration.Dispose();
+
+            public override void Execute()
+            {
+                _registration.Dispose();
+
+                if (_cancellation.IsCancellationRequested)
+                {
+                    _completion.TrySetCanceled(_cancellation);
+                    return;
+                }
+
+                try
+                {
+                    _completion.TrySetResult(_operation(_state));
+                }
+                catch (Exception ex)
+                {
+                    _completion.TrySetException(ex);
+                }
+            }
+
+            public override void Abort(Exception reason)
+            {
+                Debug.Assert(reason != null);
+
+                _registration.Dispose();
+                _completion.TrySetException(reason);
+            }
+        }
+    }
+}
@@ -46,9 +46,12 @@ namespace VNLib.Plugins.Essentials.Content
      *  per-request performance but a slight reduction in processor usage across
      *  profiling sessions. This class also makes use of the new IHttpStreamResponse
      *  interface.
+     *  
+     *  As a file region response, the transport may send the file directly from
+     *  the handle (sendfile) when the response is not compressed or encrypted.
      */
 
-    internal sealed class DirectFileStream(SafeFileHandle fileHandle) : VnDisposeable, IHttpStreamResponse
+    internal sealed class DirectFileStream(SafeFileHandle fileHandle) : VnDisposeable, IHttpFileRegionResponse
     {
         private long _position;
 
@@ -62,6 +65,12 @@ namespace VNLib.Plugins.Essentials.Content
         /// </summary>
         public readonly long Length = RandomAccess.GetLength(fileHandle);
 
+        ///<inheritdoc/>
+        public SafeFileHandle FileHandle => fileHandle;
+
+        ///<inheritdoc/>
+        public long FileOffset => _position;
+
         ///<inheritdoc/>
         public async ValueTask<int> ReadAsync(Memory<byte> buffer)
         {
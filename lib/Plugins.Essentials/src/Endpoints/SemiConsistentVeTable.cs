@@ -26,10 +26,10 @@ using System;
 using System.Linq;
 using System.Threading;
 using System.Threading.Tasks;
-using System.Collections.Frozen;
 using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
 
+using VNLib.Utils;
 using VNLib.Net.Http;
 
 namespace VNLib.Plugins.Essentials.Endpoints
@@ -59,11 +59,10 @@ namespace VNLib.Plugins.Essentials.Endpoints
 
         /// <summary>
         /// A "lookup table" that represents virtual endpoints to be processed when an
-        /// incomming connection matches its path parameter
+        /// incomming connection matches its path parameter. The table may be searched
+        /// with the request path span so no string is allocated per request.
         /// </summary>
-        private FrozenDictionary<string, IVirtualEndpoint<HttpEntity>> VirtualEndpoints =
-            new Dictionary<string, IVirtualEndpoint<HttpEntity>>(StringComparer.OrdinalIgnoreCase)
-            .ToFrozenDictionary();
+        private SpanKeyedTable<IVirtualEndpoint<HttpEntity>> VirtualEndpoints = SpanKeyedTable<IVirtualEndpoint<HttpEntity>>.Empty;
 
         private bool _isEmpty = true;
 
@@ -121,7 +120,7 @@ namespace VNLib.Plugins.Essentials.Endpoints
                 _isEmpty = newTable.Count == 0;
 
                 //Create the new table and store the entire table
-                _ = Interlocked.Exchange(ref VirtualEndpoints, newTable.ToFrozenDictionary(StringComparer.OrdinalIgnoreCase));
+                _ = Interlocked.Exchange(ref VirtualEndpoints, new(newTable, StringComparison.OrdinalIgnoreCase));
             }
         }
 
@@ -164,7 +163,7 @@ namespace VNLib.Plugins.Essentials.Endpoints
                 _isEmpty = newTable.Count == 0;
 
                 //Store the new table
-                _ = Interlocked.Exchange(ref VirtualEndpoints, newTable.ToFrozenDictionary(StringComparer.OrdinalIgnoreCase));
+                _ = Interlocked.Exchange(ref VirtualEndpoints, new(newTable, StringComparison.OrdinalIgnoreCase));
             }
         }
 
@@ -172,6 +171,10 @@ namespace VNLib.Plugins.Essentials.Endpoints
         public bool TryGetEndpoint(string path, [NotNullWhen(true)] out IVirtualEndpoint<HttpEntity>? endpoint)
             => VirtualEndpoints.TryGetValue(path, out endpoint);
 
+        ///<inheritdoc/>
+        public bool TryGetEndpoint(ReadOnlySpan<char> path, [NotNullWhen(true)] out IVirtualEndpoint<HttpEntity>? endpoint)
+            => VirtualEndpoints.TryGetValue(path, out endpoint);
+
 
         /* 
          * Wrapper class for converting IHttpEvent endpoints to 
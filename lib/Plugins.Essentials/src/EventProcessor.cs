@@ -27,6 +27,7 @@ using System.IO;
 using System.Net;
 using System.Threading;
 using System.Net.Sockets;
+using System.Diagnostics;
 using System.Threading.Tasks;
 using System.Collections.Immutable;
 using System.Runtime.CompilerServices;
@@ -61,6 +62,12 @@ namespace VNLib.Plugins.Essentials
         /// </summary>
         public static EventProcessor? Current => _currentProcessor.Value;
 
+        /// <summary>
+        /// The name of the <see cref="ActivitySource"/> that traces the session, middleware, 
+        /// endpoint and file processing spans of requests the server is tracing
+        /// </summary>
+        public const string ActivitySourceName = "VNLib.Plugins.Essentials";
+
         /// <summary>
         /// <para>
         /// Called when the server intends to process a file and requires translation from a 
@@ -174,6 +181,9 @@ namespace VNLib.Plugins.Essentials
             //event cancellation token
             HttpEntity entity = new(httpEvent, this);
 
+            //Processing spans are only recorded for requests the server is tracing
+            entity.RequestActivity = EventProcessorTracing.GetRequestActivity();
+
             //Set ambient processor context
             _currentProcessor.Value = this;           
 
@@ -183,7 +193,10 @@ namespace VNLib.Plugins.Essentials
                 if (sessions != null)
                 {
                     //Get the session
-                    entity.EventSessionHandle = await sessions.GetSessionAsync(httpEvent, entity.EventCancellation);
+                    using (EventProcessorTracing.StartChild(entity.RequestActivity, "session load"))
+                    {
+                        entity.EventSessionHandle = await sessions.GetSessionAsync(httpEvent, entity.EventCancellation);
+                    }
 
                     //If the processor had an error recovering the session, return the result to the processor
                     if (entity.EventSessionHandle.EntityStatus != FileProcessArgs.Continue)
@@ -214,10 +227,17 @@ namespace VNLib.Plugins.Essentials
                     if (!config.EndpointTable.IsEmpty)
                     {
                         //See if the virtual file is servicable
-                        if (config.EndpointTable.TryGetEndpoint(entity.Server.Path, out IVirtualEndpoint<HttpEntity>? vf))
+                        if (config.EndpointTable.TryGetEndpoint(entity.Server.PathSpan, out IVirtualEndpoint<HttpEntity>? vf))
                         {
-                            //Invoke the page handler process method
-                            VfReturnType rt = await vf.Process(entity);
+                            VfReturnType rt;
+
+                            using (Activity? span = EventProcessorTracing.StartChild(entity.RequestActivity, "endpoint"))
+                            {
+                                span?.SetTag("vnlib.endpoint.path", vf.Path);
+
+                                //Invoke the page handler process method
+                                rt = await vf.Process(entity);
+                            }
 
                             //Process a virtual file
                             GetArgsFromVirtualReturn(entity, rt, out entity.EventArgs);
@@ -238,7 +258,10 @@ namespace VNLib.Plugins.Essentials
                     else
                     {
                         //Finally route the connection as a file
-                        entity.EventArgs = await RouteFileAsync(router, entity);
+                        using (EventProcessorTracing.StartChild(entity.RequestActivity, "route file"))
+                        {
+                            entity.EventArgs = await RouteFileAsync(router, entity);
+                        }
                     }
 
                 RespondAndExit:
@@ -255,7 +278,10 @@ namespace VNLib.Plugins.Essentials
                     try
                     {
                         //Release the session
-                        await entity.EventSessionHandle.ReleaseAsync(httpEvent);
+                        using (EventProcessorTracing.StartChild(entity.RequestActivity, "session release"))
+                        {
+                            await entity.EventSessionHandle.ReleaseAsync(httpEvent);
+                        }
                     }
                     catch (Exception ex)
                     {
@@ -266,7 +292,10 @@ namespace VNLib.Plugins.Essentials
             ProcessRoutine:
 
                 //Finally process the file
-                ProcessRoutine(httpEvent, in entity.EventArgs);
+                using (EventProcessorTracing.StartChild(entity.RequestActivity, "file lookup"))
+                {
+                    ProcessRoutine(httpEvent, in entity.EventArgs);
+                }
             }
             catch (ContentTypeUnacceptableException)
             {
@@ -0,0 +1,66 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Plugins.Essentials
+* File: EventProcessorTracing.cs 
+*
+* EventProcessorTracing.cs is part of VNLib.Plugins.Essentials which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Plugins.Essentials is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU Affero General Public License as 
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* VNLib.Plugins.Essentials is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+using System.Diagnostics;
+
+using VNLib.Net.Http;
+
+namespace VNLib.Plugins.Essentials
+{
+    /*
+     * Processing spans are only started as children of the activity the 
+     * server started for a sampled request. An unrelated ambient activity 
+     * started by the host or application code does not enable them, and 
+     * untraced requests only pay for the HasListeners check.
+     */
+    internal static class EventProcessorTracing
+    {
+        public static readonly ActivitySource Source = new(EventProcessor.ActivitySourceName);
+
+        /// <summary>
+        /// Gets the server's activity for the current request if processing spans
+        /// should be recorded for it
+        /// </summary>
+        /// <returns>The request activity, or null if the request is not traced</returns>
+        public static Activity? GetRequestActivity()
+        {
+            if (!Source.HasListeners())
+            {
+                return null;
+            }
+
+            Activity? current = Activity.Current;
+            return current?.Source.Name == HttpServer.ActivitySourceName ? current : null;
+        }
+
+        /// <summary>
+        /// Starts a child activity of a traced request
+        /// </summary>
+        /// <param name="request">The request activity, null if the request is not traced</param>
+        /// <param name="name">The name of the child activity</param>
+        /// <returns>The started activity, or null if the request is not traced</returns>
+        public static Activity? StartChild(Activity? request, string name) 
+            => request != null ? Source.StartActivity(name, ActivityKind.Internal, request.Context) : null;
+    }
+}
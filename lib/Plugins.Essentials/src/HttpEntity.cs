@@ -103,6 +103,7 @@ namespace VNLib.Plugins.Essentials
         private SessionInfo _session;
         internal FileProcessArgs EventArgs;
         internal SessionHandle EventSessionHandle;
+        internal Activity? RequestActivity;
 
         /// <summary>
         /// Internal call to attach a new session to the entity from the 
@@ -70,5 +70,15 @@ namespace VNLib.Plugins.Essentials
         /// <param name="endpoint"></param>
         /// <returns></returns>
         bool TryGetEndpoint(string path, [NotNullWhen(true)] out IVirtualEndpoint<HttpEntity>? endpoint);
+
+        /// <summary>
+        /// Attempts to get the endpoint associated with the specified path without
+        /// requiring the path to be allocated as a string
+        /// </summary>
+        /// <param name="path">The connection path to recover the endpoint from</param>
+        /// <param name="endpoint"></param>
+        /// <returns></returns>
+        bool TryGetEndpoint(ReadOnlySpan<char> path, [NotNullWhen(true)] out IVirtualEndpoint<HttpEntity>? endpoint)
+            => TryGetEndpoint(path.ToString(), out endpoint);
     }
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 * along with this program.  If not, see https://www.gnu.org/licenses/.
 */
 
+using System.Diagnostics;
 using System.Threading.Tasks;
 using System.Collections.Generic;
 
@@ -47,7 +48,12 @@ namespace VNLib.Plugins.Essentials.Middleware
             //Loop through nodes
             while (mwNode != null)
             {
-                entity.EventArgs = await mwNode.ValueRef.ProcessAsync(entity);
+                using (Activity? span = EventProcessorTracing.StartChild(entity.RequestActivity, "middleware"))
+                {
+                    span?.SetTag("vnlib.middleware", mwNode.ValueRef.GetType().Name);
+
+                    entity.EventArgs = await mwNode.ValueRef.ProcessAsync(entity);
+                }
 
                 switch (entity.EventArgs.Routine)
                 {
@@ -0,0 +1,203 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+using VNLib.Plugins.Essentials.Accounts;
+
+namespace VNLib.Plugins.Essentials.Tests
+{
+    [TestClass()]
+    public class PasswordHashingSchedulerTests
+    {
+        static readonly TimeSpan Timeout = TimeSpan.FromSeconds(10);
+
+        [TestMethod()]
+        public async Task RunsOperationTest()
+        {
+            using PasswordHashingScheduler scheduler = CreateScheduler(2, 4);
+
+            Assert.AreEqual(42, await scheduler.ScheduleAsync(static s => s * 2, 21));
+        }
+
+        [TestMethod()]
+        public async Task OperationExceptionTest()
+        {
+            using PasswordHashingScheduler scheduler = CreateScheduler(1, 4);
+
+            ValueTask<int> result = scheduler.ScheduleAsync<int, int>(static _ => throw new InvalidDataException(), 0);
+
+            await Assert.ThrowsExceptionAsync<InvalidDataException>(() => result.AsTask());
+        }
+
+        [TestMethod()]
+        public async Task QueueFullRejectionTest()
+        {
+            using PasswordHashingScheduler scheduler = CreateScheduler(1, 1);
+            using BlockingOperation blocker = new();
+
+            //Occupy the only worker, then fill the queue
+            ValueTask<int> running = scheduler.ScheduleAsync(blocker.Run, 1);
+            blocker.WaitStarted();
+
+            ValueTask<int> queued = scheduler.ScheduleAsync(static s => s, 2);
+
+            Assert.AreEqual(1, scheduler.QueueDepth);
+            Assert.ThrowsException<PasswordHashingQueueFullException>(() => scheduler.ScheduleAsync(static s => s, 3));
+
+            blocker.Release();
+
+            Assert.AreEqual(1, await running.AsTask().WaitAsync(Timeout));
+            Assert.AreEqual(2, await queued.AsTask().WaitAsync(Timeout));
+
+            //Capacity is available again once the queue drains
+            Assert.AreEqual(4, await scheduler.ScheduleAsync(static s => s, 4).AsTask().WaitAsync(Timeout));
+        }
+
+        [TestMethod()]
+        public async Task CanceledBeforeScheduleTest()
+        {
+            using PasswordHashingScheduler scheduler = CreateScheduler(1, 4);
+
+            bool ran = false;
+
+            ValueTask<int> result = scheduler.ScheduleAsync(_ => { ran = true; return 0; }, 0, new CancellationToken(true));
+
+            Assert.IsTrue(result.IsCanceled);
+            await Assert.ThrowsExceptionAsync<TaskCanceledException>(() => result.AsTask());
+            Assert.AreEqual(0, scheduler.QueueDepth);
+            Assert.IsFalse(ran);
+        }
+
+        [TestMethod()]
+        public async Task CanceledWhileQueuedTest()
+        {
+            using PasswordHashingScheduler scheduler = CreateScheduler(1, 4);
+            using BlockingOperation blocker = new();
+            using CancellationTokenSource cts = new();
+
+            ValueTask<int> running = scheduler.ScheduleAsync(blocker.Run, 1);
+            blocker.WaitStarted();
+
+            int ran = 0;
+            ValueTask<int> queued = scheduler.ScheduleAsync(_ => Interlocked.Increment(ref ran), 0, cts.Token);
+
+            //The caller is released as soon as it cancels, without waiting for a worker
+            cts.Cancel();
+            await Assert.ThrowsExceptionAsync<TaskCanceledException>(() => queued.AsTask().WaitAsync(Timeout));
+
+            blocker.Release();
+            await running.AsTask().WaitAsync(Timeout);
+
+            //The worker skips the canceled item when it is dequeued
+            await scheduler.ScheduleAsync(static s => s, 0).AsTask().WaitAsync(Timeout);
+            Assert.AreEqual(0, Volatile.Read(ref ran));
+        }
+
+        [TestMethod()]
+        public async Task DisposeFailsQueuedOperationsTest()
+        {
+            PasswordHashingScheduler scheduler = CreateScheduler(1, 4);
+            using BlockingOperation blocker = new();
+
+            ValueTask<int> running = scheduler.ScheduleAsync(blocker.Run, 1);
+            blocker.WaitStarted();
+
+            ValueTask<int> queued1 = scheduler.ScheduleAsync(static s => s, 2);
+            ValueTask<int> queued2 = scheduler.ScheduleAsync(static s => s, 3);
+
+            scheduler.Dispose();
+
+            Assert.ThrowsException<ObjectDisposedException>(() => scheduler.ScheduleAsync(static s => s, 4));
+
+            blocker.Release();
+
+            //The running operation completes, queued operations that never started fail
+            Assert.AreEqual(1, await running.AsTask().WaitAsync(Timeout));
+            await Assert.ThrowsExceptionAsync<ObjectDisposedException>(() => queued1.AsTask().WaitAsync(Timeout));
+            await Assert.ThrowsExceptionAsync<ObjectDisposedException>(() => queued2.AsTask().WaitAsync(Timeout));
+
+            //Disposing again is harmless
+            scheduler.Dispose();
+        }
+
+        [TestMethod()]
+        public void ScheduleRacingDisposeTest()
+        {
+            for (int i = 0; i < 200; i++)
+            {
+                PasswordHashingScheduler scheduler = CreateScheduler(2, 8);
+
+                Task producer = Task.Run(() =>
+                {
+                    while (true)
+                    {
+                        try
+                        {
+                            _ = scheduler.ScheduleAsync(static s => s, 0);
+                        }
+                        catch (PasswordHashingQueueFullException)
+                        { }
+                        catch (ObjectDisposedException)
+                        {
+                            //The only failure a concurrent dispose may cause
+                            return;
+                        }
+                    }
+                });
+
+                scheduler.Dispose();
+
+                Assert.IsTrue(producer.Wait(Timeout), "The producer did not observe the dispose");
+            }
+        }
+
+        [TestMethod()]
+        public async Task ContinuationsNotOnWorkerTest()
+        {
+            using PasswordHashingScheduler scheduler = CreateScheduler(1, 4);
+
+            int workerThread = await scheduler.ScheduleAsync(static _ => Environment.CurrentManagedThreadId, 0).ConfigureAwait(false);
+
+            //The completion must not resume the caller inline on the hashing worker
+            Assert.AreNotEqual(workerThread, Environment.CurrentManagedThreadId);
+            Assert.IsFalse(Thread.CurrentThread.Name?.StartsWith("Password hashing worker") ?? false);
+        }
+
+        [TestMethod()]
+        public void MemoryBudgetLimitsWorkersTest()
+        {
+            //Three 64 MiB hashes fit in a 200 MiB budget
+            using PasswordHashingScheduler scheduler = new(8, 4, 200L * 1024 * 1024, 64 * 1024);
+            Assert.AreEqual(3, scheduler.WorkerCount);
+
+            //At least one worker always runs
+            using PasswordHashingScheduler small = new(8, 4, 1024, 64 * 1024);
+            Assert.AreEqual(1, small.WorkerCount);
+        }
+
+        private static PasswordHashingScheduler CreateScheduler(int workers, int queueDepth) 
+            => new(workers, queueDepth, long.MaxValue, 1);
+
+        private sealed class BlockingOperation : IDisposable
+        {
+            private readonly ManualResetEventSlim _started = new();
+            private readonly ManualResetEventSlim _release = new();
+
+            public int Run(int state)
+            {
+                _started.Set();
+                _release.Wait(Timeout);
+                return state;
+            }
+
+            public void WaitStarted() => Assert.IsTrue(_started.Wait(Timeout), "The operation did not start");
+
+            public void Release() => _release.Set();
+
+            public void Dispose()
+            {
+                _release.Set();
+                _started.Dispose();
+                _release.Dispose();
+            }
+        }
+    }
+}
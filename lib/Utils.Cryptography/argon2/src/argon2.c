@@ -23,6 +23,10 @@
 #include "encoding.h"
 #include "core.h"
 
+#ifdef ARGON2_DISPATCH
+#include "dispatch.h"
+#endif
+
 const char *argon2_type2string(argon2_type type, int uppercase) {
     switch (type) {
         case Argon2_d:
@@ -50,6 +54,11 @@ int argon2_ctx(argon2_context *context, argon2_type type) {
         return ARGON2_INCORRECT_TYPE;
     }
 
+#ifdef ARGON2_DISPATCH
+    /* Select the fill kernel for this cpu, only the first call does any work */
+    argon2_dispatch_init();
+#endif
+
     /* 2. Align memory size */
     /* Minimum memory_blocks = 8L blocks, where L is the number of lanes */
     memory_blocks = context->m_cost;
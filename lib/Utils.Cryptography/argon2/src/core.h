@@ -217,6 +217,15 @@ void finalize(const argon2_context *context, argon2_instance_t *instance);
 void fill_segment(const argon2_instance_t *instance,
                   argon2_position_t position);
 
+/*
+ * The fill kernels in opt.c and ref.c define ARGON2_FILL_SEGMENT. Runtime
+ * dispatch builds compile them once per instruction set under a different
+ * name and fill_segment() is provided by dispatch.c instead
+ */
+#ifndef ARGON2_FILL_SEGMENT
+#define ARGON2_FILL_SEGMENT fill_segment
+#endif
+
 /*
  * Function that fills the entire memory t_cost times based on the first two
  * blocks in each lane
@@ -0,0 +1,173 @@
+/*
+ * Argon2 reference source code package - reference C implementations
+ *
+ * Copyright 2015
+ * Daniel Dinu, Dmitry Khovratovich, Jean-Philippe Aumasson, and Samuel Neves
+ *
+ * You may use this work under the terms of a Creative Commons CC0 1.0
+ * License/Waiver or the Apache Public License 2.0, at your option. The terms of
+ * these licenses can be found at:
+ *
+ * - CC0 1.0 Universal : https://creativecommons.org/publicdomain/zero/1.0
+ * - Apache 2.0        : https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * You should have received a copy of both of these licenses along with this
+ * software. If not, they may be obtained at the above URLs.
+ */
+
+/*
+ * Runtime selection of the memory fill kernel. opt.c is compiled once for
+ * every supported instruction set (see src/dispatch/) so a single portable
+ * build can use the widest BlaMka implementation the host cpu supports.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "argon2.h"
+#include "dispatch.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__GNUC__) || defined(__clang__)
+#include <cpuid.h>
+#endif
+
+/* XCR0 state components that must be enabled by the os */
+#define XCR0_SSE_AVX 0x06U
+#define XCR0_AVX512 0xE0U
+
+/* Ordered from the fastest to the slowest, ref must always be last */
+static const argon2_fill_impl_t dispatch_table[] = {
+    {"avx512f", ARGON2_CPU_AVX512F, fill_segment_avx512f},
+    {"avx2", ARGON2_CPU_AVX2, fill_segment_avx2},
+    {"ssse3", ARGON2_CPU_SSSE3, fill_segment_ssse3},
+    {"sse2", ARGON2_CPU_SSE2, fill_segment_sse2},
+    {"ref", 0, fill_segment_ref},
+};
+
+#define DISPATCH_TABLE_SIZE (sizeof(dispatch_table) / sizeof(dispatch_table[0]))
+
+/*
+ * Defaults to the reference kernel so fill_segment() is always valid. The
+ * selection is idempotent, so racing first calls store the same pointer.
+ */
+static const argon2_fill_impl_t *selected_impl =
+    &dispatch_table[DISPATCH_TABLE_SIZE - 1];
+static int dispatch_initialized = 0;
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, (int)leaf, (int)subleaf);
+    regs[0] = (uint32_t)info[0];
+    regs[1] = (uint32_t)info[1];
+    regs[2] = (uint32_t)info[2];
+    regs[3] = (uint32_t)info[3];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static uint64_t read_xcr0(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    /* xgetbv opcode, avoids requiring -mxsave for the intrinsic */
+    __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0"
+                         : "=a"(eax), "=d"(edx)
+                         : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+uint32_t argon2_cpu_features(void) {
+    uint32_t regs[4];
+    uint32_t max_leaf, features = 0;
+    uint64_t xcr0 = 0;
+
+    cpuid(0, 0, regs);
+    max_leaf = regs[0];
+
+    if (max_leaf < 1) {
+        return 0;
+    }
+
+    cpuid(1, 0, regs);
+
+    if (regs[3] & (1U << 26)) {
+        features |= ARGON2_CPU_SSE2;
+    }
+    if (regs[2] & (1U << 9)) {
+        features |= ARGON2_CPU_SSSE3;
+    }
+
+    /* The wide registers are only usable when the os saves them (OSXSAVE) */
+    if ((regs[2] & (1U << 27)) && (regs[2] & (1U << 28))) {
+        xcr0 = read_xcr0();
+    }
+
+    if (max_leaf < 7 || (xcr0 & XCR0_SSE_AVX) != XCR0_SSE_AVX) {
+        return features;
+    }
+
+    cpuid(7, 0, regs);
+
+    if (regs[1] & (1U << 5)) {
+        features |= ARGON2_CPU_AVX2;
+    }
+    if ((regs[1] & (1U << 16)) && (xcr0 & XCR0_AVX512) == XCR0_AVX512) {
+        features |= ARGON2_CPU_AVX512F;
+    }
+
+    return features;
+}
+
+void argon2_dispatch_init(void) {
+    uint32_t features;
+    size_t i;
+
+    if (dispatch_initialized) {
+        return;
+    }
+
+    features = argon2_cpu_features();
+
+    for (i = 0; i < DISPATCH_TABLE_SIZE; i++) {
+        if ((dispatch_table[i].required_features & features) ==
+            dispatch_table[i].required_features) {
+            selected_impl = &dispatch_table[i];
+            break;
+        }
+    }
+
+    dispatch_initialized = 1;
+}
+
+const argon2_fill_impl_t *argon2_get_impls(size_t *count) {
+    *count = DISPATCH_TABLE_SIZE;
+    return dispatch_table;
+}
+
+const argon2_fill_impl_t *argon2_current_impl(void) {
+    return selected_impl;
+}
+
+int argon2_set_impl(const argon2_fill_impl_t *impl) {
+    uint32_t features = argon2_cpu_features();
+
+    if (impl == NULL ||
+        (impl->required_features & features) != impl->required_features) {
+        return ARGON2_INCORRECT_PARAMETER;
+    }
+
+    selected_impl = impl;
+    dispatch_initialized = 1;
+    return ARGON2_OK;
+}
+
+void fill_segment(const argon2_instance_t *instance,
+                  argon2_position_t position) {
+    selected_impl->fill_segment(instance, position);
+}
@@ -0,0 +1,86 @@
+/*
+ * Argon2 reference source code package - reference C implementations
+ *
+ * Copyright 2015
+ * Daniel Dinu, Dmitry Khovratovich, Jean-Philippe Aumasson, and Samuel Neves
+ *
+ * You may use this work under the terms of a Creative Commons CC0 1.0
+ * License/Waiver or the Apache Public License 2.0, at your option. The terms of
+ * these licenses can be found at:
+ *
+ * - CC0 1.0 Universal : https://creativecommons.org/publicdomain/zero/1.0
+ * - Apache 2.0        : https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * You should have received a copy of both of these licenses along with this
+ * software. If not, they may be obtained at the above URLs.
+ */
+
+#ifndef ARGON2_DISPATCH_H
+#define ARGON2_DISPATCH_H
+
+#include "core.h"
+
+/* cpu features required by a fill kernel */
+#define ARGON2_CPU_SSE2 0x01U
+#define ARGON2_CPU_SSSE3 0x02U
+#define ARGON2_CPU_AVX2 0x04U
+#define ARGON2_CPU_AVX512F 0x08U
+
+typedef void (*argon2_fill_segment_fn)(const argon2_instance_t *instance,
+                                       argon2_position_t position);
+
+/*
+ * An entry in the dispatch table, a fill kernel compiled for a specific
+ * instruction set
+ */
+typedef struct Argon2_fill_impl_t {
+    const char *name;
+    uint32_t required_features;
+    argon2_fill_segment_fn fill_segment;
+} argon2_fill_impl_t;
+
+/* Fill kernels, each is opt.c or ref.c compiled with different target flags */
+void fill_segment_ref(const argon2_instance_t *instance,
+                      argon2_position_t position);
+void fill_segment_sse2(const argon2_instance_t *instance,
+                       argon2_position_t position);
+void fill_segment_ssse3(const argon2_instance_t *instance,
+                        argon2_position_t position);
+void fill_segment_avx2(const argon2_instance_t *instance,
+                       argon2_position_t position);
+void fill_segment_avx512f(const argon2_instance_t *instance,
+                          argon2_position_t position);
+
+/*
+ * Detects the features of the current cpu and selects the fastest supported
+ * fill kernel. Only the first call does any work, it is called by argon2_ctx
+ */
+void argon2_dispatch_init(void);
+
+/*
+ * Gets the feature flags (ARGON2_CPU_*) the current cpu and operating system
+ * support
+ */
+uint32_t argon2_cpu_features(void);
+
+/*
+ * Gets the dispatch table, ordered from the fastest to the slowest kernel.
+ * The last entry is always the reference kernel
+ * @param count Receives the number of entries in the table
+ */
+const argon2_fill_impl_t *argon2_get_impls(size_t *count);
+
+/*
+ * Gets the kernel that is currently used by fill_segment()
+ */
+const argon2_fill_impl_t *argon2_current_impl(void);
+
+/*
+ * Forces a kernel from the dispatch table, intended for testing
+ * @param impl The table entry to use
+ * @return ARGON2_OK if the kernel is supported on this cpu,
+ * ARGON2_INCORRECT_PARAMETER otherwise
+ */
+int argon2_set_impl(const argon2_fill_impl_t *impl);
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * Argon2 reference source code package - reference C implementations
+ *
+ * Copyright 2015
+ * Daniel Dinu, Dmitry Khovratovich, Jean-Philippe Aumasson, and Samuel Neves
+ *
+ * You may use this work under the terms of a Creative Commons CC0 1.0
+ * License/Waiver or the Apache Public License 2.0, at your option. The terms of
+ * these licenses can be found at:
+ *
+ * - CC0 1.0 Universal : https://creativecommons.org/publicdomain/zero/1.0
+ * - Apache 2.0        : https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * You should have received a copy of both of these licenses along with this
+ * software. If not, they may be obtained at the above URLs.
+ */
+
+/*
+ * Known answer test for the runtime dispatch build. Every fill kernel the
+ * cpu supports must produce the same tags as the reference kernel (ref.c),
+ * and the selected kernel must reproduce the RFC 9106 test vectors.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "argon2.h"
+#include "dispatch.h"
+
+#define OUT_LEN 32
+
+typedef struct test_params_t {
+    uint32_t t_cost;
+    uint32_t m_cost;
+    uint32_t lanes;
+    uint32_t threads;
+} test_params_t;
+
+static const test_params_t test_params[] = {
+    {1, 8, 1, 1},
+    {3, 32, 4, 4},
+    {2, 256, 1, 1},
+    {2, 1024, 4, 2},
+    {1, 4096, 8, 8},
+};
+
+#define N_PARAMS (sizeof(test_params) / sizeof(test_params[0]))
+
+static const argon2_type test_types[] = {Argon2_d, Argon2_i, Argon2_id};
+static const uint32_t test_versions[] = {ARGON2_VERSION_10, ARGON2_VERSION_13};
+
+/* RFC 9106 section 5 test vectors, version 0x13 */
+static const uint8_t rfc_tags[3][OUT_LEN] = {
+    {0x51, 0x2b, 0x39, 0x1b, 0x6f, 0x11, 0x62, 0x97, 0x53, 0x71, 0xd3,
+     0x09, 0x19, 0x73, 0x42, 0x94, 0xf8, 0x68, 0xe3, 0xbe, 0x39, 0x84,
+     0xf3, 0xc1, 0xa1, 0x3a, 0x4d, 0xb9, 0xfa, 0xbe, 0x4a, 0xcb},
+    {0xc8, 0x14, 0xd9, 0xd1, 0xdc, 0x7f, 0x37, 0xaa, 0x13, 0xf0, 0xd7,
+     0x7f, 0x24, 0x94, 0xbd, 0xa1, 0xc8, 0xde, 0x6b, 0x01, 0x6d, 0xd3,
+     0x88, 0xd2, 0x99, 0x52, 0xa4, 0xc4, 0x67, 0x2b, 0x6c, 0xe8},
+    {0x0d, 0x64, 0x0d, 0xf5, 0x8d, 0x78, 0x76, 0x6c, 0x08, 0xc0, 0x37,
+     0xa3, 0x4a, 0x8b, 0x53, 0xc9, 0xd0, 0x1e, 0xf0, 0x45, 0x2d, 0x75,
+     0xb6, 0x5e, 0xb5, 0x25, 0x20, 0xe9, 0x6b, 0x01, 0xe6, 0x59},
+};
+
+static int compute(const test_params_t *params, argon2_type type,
+                   uint32_t version, uint8_t out[OUT_LEN]) {
+    uint8_t pwd[32], salt[16], secret[8], ad[12];
+    argon2_context context;
+
+    memset(pwd, 0x01, sizeof(pwd));
+    memset(salt, 0x02, sizeof(salt));
+    memset(secret, 0x03, sizeof(secret));
+    memset(ad, 0x04, sizeof(ad));
+    memset(&context, 0, sizeof(context));
+
+    context.out = out;
+    context.outlen = OUT_LEN;
+    context.pwd = pwd;
+    context.pwdlen = sizeof(pwd);
+    context.salt = salt;
+    context.saltlen = sizeof(salt);
+    context.secret = secret;
+    context.secretlen = sizeof(secret);
+    context.ad = ad;
+    context.adlen = sizeof(ad);
+    context.t_cost = params->t_cost;
+    context.m_cost = params->m_cost;
+    context.lanes = params->lanes;
+    context.threads = params->threads;
+    context.version = version;
+    context.flags = ARGON2_DEFAULT_FLAGS;
+
+    return argon2_ctx(&context, type);
+}
+
+static int check_rfc_vectors(void) {
+    uint8_t out[OUT_LEN];
+    size_t i;
+    int failures = 0;
+
+    for (i = 0; i < 3; i++) {
+        if (compute(&test_params[1], test_types[i], ARGON2_VERSION_13, out) !=
+                ARGON2_OK ||
+            memcmp(out, rfc_tags[i], OUT_LEN) != 0) {
+            printf("RFC 9106 %s vector: FAIL\n",
+                   argon2_type2string(test_types[i], 0));
+            failures++;
+        }
+    }
+
+    return failures;
+}
+
+int main(void) {
+    uint8_t expected[N_PARAMS][3][2][OUT_LEN];
+    uint8_t out[OUT_LEN];
+    const argon2_fill_impl_t *impls, *ref_impl;
+    size_t n_impls, i, p, t, v;
+    int failures = 0;
+
+    impls = argon2_get_impls(&n_impls);
+    ref_impl = &impls[n_impls - 1];
+
+    /* Collect the known answers from the reference kernel */
+    if (argon2_set_impl(ref_impl) != ARGON2_OK) {
+        printf("Failed to select the reference kernel\n");
+        return 1;
+    }
+
+    for (p = 0; p < N_PARAMS; p++) {
+        for (t = 0; t < 3; t++) {
+            for (v = 0; v < 2; v++) {
+                if (compute(&test_params[p], test_types[t], test_versions[v],
+                            expected[p][t][v]) != ARGON2_OK) {
+                    printf("Reference kernel failed to compute a hash\n");
+                    return 1;
+                }
+            }
+        }
+    }
+
+    failures += check_rfc_vectors();
+
+    for (i = 0; i < n_impls - 1; i++) {
+        int impl_failures = 0;
+
+        if (argon2_set_impl(&impls[i]) != ARGON2_OK) {
+            printf("%-8s SKIPPED, not supported by this cpu\n", impls[i].name);
+            continue;
+        }
+
+        for (p = 0; p < N_PARAMS; p++) {
+            for (t = 0; t < 3; t++) {
+                for (v = 0; v < 2; v++) {
+                    if (compute(&test_params[p], test_types[t],
+                                test_versions[v], out) != ARGON2_OK ||
+                        memcmp(out, expected[p][t][v], OUT_LEN) != 0) {
+                        impl_failures++;
+                    }
+                }
+            }
+        }
+
+        impl_failures += check_rfc_vectors();
+
+        printf("%-8s %s\n", impls[i].name, impl_failures ? "FAIL" : "OK");
+        failures += impl_failures;
+    }
+
+    if (failures) {
+        printf("%d known answer checks failed\n", failures);
+        return 1;
+    }
+
+    printf("All supported fill kernels match the reference kernel\n");
+    return 0;
+}
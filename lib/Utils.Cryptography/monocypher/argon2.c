@@ -18,13 +18,579 @@
 #include "argon2.h"
 #include <monocypher.h>
 
+#ifndef VNLIB_ARGON2_NO_THREADS
+	#ifdef _P_IS_WINDOWS
+		#define WIN32_LEAN_AND_MEAN
+		#include <Windows.h>
+	#else
+		#include <pthread.h>
+	#endif
+#endif
+
 #define ARGON2_WORK_AREA_MULTIPLIER 1024
+#define ARGON2_SYNC_POINTS 4
+#define ARGON2_BLOCK_WORDS 128
+
+/*
+* Upper bound on the number of threads a single hash may use, extra lanes
+* are distributed over the available threads
+*/
+#ifndef ARGON2_MAX_THREADS
+	#define ARGON2_MAX_THREADS 64
+#endif
 
 VNLIB_EXPORT uint32_t VNLIB_CC Argon2CalcWorkAreaSize(const argon2Ctx* context)
 {
 	return context->m_cost * ARGON2_WORK_AREA_MULTIPLIER;
 }
 
+#ifndef VNLIB_ARGON2_NO_THREADS
+
+/*
+* The following is a segment-parallel port of the Argon2 fill loop from the
+* vendored monocypher source (crypto_argon2). Monocypher computes lanes
+* sequentially because it does not support threads, but every segment in
+* the same slice only references blocks from previous slices (or its own
+* lane) so segments can be filled concurrently. Results are identical to
+* crypto_argon2 for the same parameters.
+*/
+
+typedef struct { uint64_t a[ARGON2_BLOCK_WORDS]; } blk;
+
+static void _store32_le(uint8_t out[4], uint32_t in)
+{
+	out[0] = (uint8_t)(in & 0xff);
+	out[1] = (uint8_t)((in >> 8) & 0xff);
+	out[2] = (uint8_t)((in >> 16) & 0xff);
+	out[3] = (uint8_t)((in >> 24) & 0xff);
+}
+
+static uint64_t _load64_le(const uint8_t s[8])
+{
+	return (uint64_t)s[0]
+		| ((uint64_t)s[1] << 8)
+		| ((uint64_t)s[2] << 16)
+		| ((uint64_t)s[3] << 24)
+		| ((uint64_t)s[4] << 32)
+		| ((uint64_t)s[5] << 40)
+		| ((uint64_t)s[6] << 48)
+		| ((uint64_t)s[7] << 56);
+}
+
+static void _store64_le(uint8_t out[8], uint64_t in)
+{
+	_store32_le(out, (uint32_t)in);
+	_store32_le(out + 4, (uint32_t)(in >> 32));
+}
+
+static uint64_t _rotr64(uint64_t x, uint64_t n) { return (x >> n) ^ (x << (64 - n)); }
+
+static void _copy_block(blk* o, const blk* in)
+{
+	uint32_t i;
+	for (i = 0; i < ARGON2_BLOCK_WORDS; i++) o->a[i] = in->a[i];
+}
+
+static void _xor_block(blk* o, const blk* in)
+{
+	uint32_t i;
+	for (i = 0; i < ARGON2_BLOCK_WORDS; i++) o->a[i] ^= in->a[i];
+}
+
+static void _zero_block(volatile uint64_t* b, uint64_t words)
+{
+	uint64_t i;
+	for (i = 0; i < words; i++) b[i] = 0;
+}
+
+static void _blake_update_32(crypto_blake2b_ctx* ctx, uint32_t input)
+{
+	uint8_t buf[4];
+	_store32_le(buf, input);
+	crypto_blake2b_update(ctx, buf, 4);
+}
+
+static void _blake_update_32_buf(crypto_blake2b_ctx* ctx, const uint8_t* buf, uint32_t size)
+{
+	_blake_update_32(ctx, size);
+	crypto_blake2b_update(ctx, buf, size);
+}
+
+/* H' variable length hash function from the spec */
+static void _extended_hash(uint8_t* digest, uint32_t digest_size, const uint8_t* input, uint32_t input_size)
+{
+	crypto_blake2b_ctx ctx;
+	uint32_t r, i, in, out;
+
+	crypto_blake2b_init(&ctx, digest_size < 64 ? digest_size : 64);
+	_blake_update_32(&ctx, digest_size);
+	crypto_blake2b_update(&ctx, input, input_size);
+	crypto_blake2b_final(&ctx, digest);
+
+	if (digest_size > 64)
+	{
+		r = (uint32_t)(((uint64_t)digest_size + 31) >> 5) - 2;
+		i = 1;
+		in = 0;
+		out = 32;
+
+		while (i < r)
+		{
+			/* Input and output overlap. This is intentional */
+			crypto_blake2b(digest + out, 64, digest + in, 64);
+			i += 1;
+			in += 32;
+			out += 32;
+		}
+
+		crypto_blake2b(digest + out, digest_size - (32 * r), digest + in, 64);
+	}
+}
+
+#define LSB(x) ((uint64_t)(uint32_t)x)
+#define G(a, b, c, d)	\
+	a += b + ((LSB(a) * LSB(b)) << 1);  d ^= a;  d = _rotr64(d, 32); \
+	c += d + ((LSB(c) * LSB(d)) << 1);  b ^= c;  b = _rotr64(b, 24); \
+	a += b + ((LSB(a) * LSB(b)) << 1);  d ^= a;  d = _rotr64(d, 16); \
+	c += d + ((LSB(c) * LSB(d)) << 1);  b ^= c;  b = _rotr64(b, 63)
+#define ROUND(v0,  v1,  v2,  v3,  v4,  v5,  v6,  v7,	\
+              v8,  v9, v10, v11, v12, v13, v14, v15)	\
+	G(v0, v4,  v8, v12);  G(v1, v5,  v9, v13); \
+	G(v2, v6, v10, v14);  G(v3, v7, v11, v15); \
+	G(v0, v5, v10, v15);  G(v1, v6, v11, v12); \
+	G(v2, v7,  v8, v13);  G(v3, v4,  v9, v14)
+
+/* Core of the compression function G. Computes Z from R in place. */
+static void _g_rounds(blk* b)
+{
+	int i;
+
+	/* column rounds */
+	for (i = 0; i < 128; i += 16)
+	{
+		ROUND(b->a[i   ], b->a[i+ 1], b->a[i+ 2], b->a[i+ 3],
+		      b->a[i+ 4], b->a[i+ 5], b->a[i+ 6], b->a[i+ 7],
+		      b->a[i+ 8], b->a[i+ 9], b->a[i+10], b->a[i+11],
+		      b->a[i+12], b->a[i+13], b->a[i+14], b->a[i+15]);
+	}
+
+	/* row rounds */
+	for (i = 0; i < 16; i += 2)
+	{
+		ROUND(b->a[i   ], b->a[i+ 1], b->a[i+ 16], b->a[i+ 17],
+		      b->a[i+32], b->a[i+33], b->a[i+ 48], b->a[i+ 49],
+		      b->a[i+64], b->a[i+65], b->a[i+ 80], b->a[i+ 81],
+		      b->a[i+96], b->a[i+97], b->a[i+112], b->a[i+113]);
+	}
+}
+
+#ifdef _P_IS_WINDOWS
+	typedef HANDLE _thread_t;
+	typedef CRITICAL_SECTION _mutex_t;
+	typedef CONDITION_VARIABLE _cond_t;
+	#define _THREAD_RETURN DWORD WINAPI
+	#define _mutex_init(m) (InitializeCriticalSection(m), 0)
+	#define _mutex_destroy(m) DeleteCriticalSection(m)
+	#define _mutex_lock(m) EnterCriticalSection(m)
+	#define _mutex_unlock(m) LeaveCriticalSection(m)
+	#define _cond_init(c) (InitializeConditionVariable(c), 0)
+	#define _cond_destroy(c)
+	#define _cond_wait(c, m) SleepConditionVariableCS(c, m, INFINITE)
+	#define _cond_broadcast(c) WakeAllConditionVariable(c)
+#else
+	typedef pthread_t _thread_t;
+	typedef pthread_mutex_t _mutex_t;
+	typedef pthread_cond_t _cond_t;
+	#define _THREAD_RETURN void*
+	#define _mutex_init(m) pthread_mutex_init(m, NULL)
+	#define _mutex_destroy(m) pthread_mutex_destroy(m)
+	#define _mutex_lock(m) pthread_mutex_lock(m)
+	#define _mutex_unlock(m) pthread_mutex_unlock(m)
+	#define _cond_init(c) pthread_cond_init(c, NULL)
+	#define _cond_destroy(c) pthread_cond_destroy(c)
+	#define _cond_wait(c, m) pthread_cond_wait(c, m)
+	#define _cond_broadcast(c) pthread_cond_broadcast(c)
+#endif
+
+typedef struct Argon2FillStateStruct {
+	blk* blocks;
+
+	uint32_t algorithm;
+	uint32_t nb_passes;
+	uint32_t nb_lanes;
+	uint32_t nb_blocks;
+	uint32_t segment_size;
+	uint32_t lane_size;
+	uint32_t nb_threads;
+
+	/* slice barrier */
+	_mutex_t lock;
+	_cond_t cond;
+	uint32_t waiting;
+	uint32_t generation;
+
+	/* startup gate, workers only start once every thread was created */
+	int32_t started;
+	int32_t aborted;
+} Argon2FillState;
+
+typedef struct Argon2WorkerStruct {
+	Argon2FillState* state;
+	uint32_t index;
+} Argon2Worker;
+
+static void _barrier_wait(Argon2FillState* state)
+{
+	uint32_t gen;
+
+	_mutex_lock(&state->lock);
+
+	gen = state->generation;
+
+	if (++state->waiting == state->nb_threads)
+	{
+		/* last thread to arrive releases everyone */
+		state->waiting = 0;
+		state->generation++;
+		_cond_broadcast(&state->cond);
+	}
+	else
+	{
+		while (gen == state->generation)
+		{
+			_cond_wait(&state->cond, &state->lock);
+		}
+	}
+
+	_mutex_unlock(&state->lock);
+}
+
+static void _fill_segment(const Argon2FillState* state, uint32_t pass, uint32_t slice, uint32_t segment)
+{
+	blk tmp, index_block;
+	uint32_t index_ctr, block, pass_offset, slice_offset, lane_offset;
+	uint32_t next_slice, window_start, nb_segments, lane, window_size, ref;
+	uint64_t index_seed, j1, x, y, z;
+	blk *segment_start, *current, *previous, *reference;
+	int constant_time;
+
+	/* Argon2i and Argon2id start with constant time indexing */
+	constant_time = state->algorithm != Argon2_d;
+
+	/* Argon2id switches back to non-constant time indexing after the first two slices of the first pass */
+	if (state->algorithm == Argon2_id && (pass > 0 || slice >= 2))
+	{
+		constant_time = 0;
+	}
+
+	/* On the first slice of the first pass, blocks 0 and 1 are already filled */
+	pass_offset = pass == 0 && slice == 0 ? 2 : 0;
+	slice_offset = slice * state->segment_size;
+	lane_offset = segment * state->lane_size;
+	segment_start = state->blocks + lane_offset + slice_offset;
+	index_ctr = 1;
+
+	for (block = pass_offset; block < state->segment_size; block++)
+	{
+		current = segment_start + block;
+		previous = block == 0 && slice_offset == 0
+			? segment_start + state->lane_size - 1
+			: segment_start + block - 1;
+
+		if (constant_time)
+		{
+			if (block == pass_offset || (block % 128) == 0)
+			{
+				/* Fill or refresh deterministic indices block */
+				_zero_block(index_block.a, ARGON2_BLOCK_WORDS);
+				index_block.a[0] = pass;
+				index_block.a[1] = segment;
+				index_block.a[2] = slice;
+				index_block.a[3] = state->nb_blocks;
+				index_block.a[4] = state->nb_passes;
+				index_block.a[5] = state->algorithm;
+				index_block.a[6] = index_ctr;
+				index_ctr++;
+
+				_copy_block(&tmp, &index_block);
+				_g_rounds(&index_block);
+				_xor_block(&index_block, &tmp);
+				_copy_block(&tmp, &index_block);
+				_g_rounds(&index_block);
+				_xor_block(&index_block, &tmp);
+			}
+
+			index_seed = index_block.a[block % 128];
+		}
+		else
+		{
+			index_seed = previous->a[0];
+		}
+
+		/* Establish the reference set */
+		next_slice = ((slice + 1) % ARGON2_SYNC_POINTS) * state->segment_size;
+		window_start = pass == 0 ? 0 : next_slice;
+		nb_segments = pass == 0 ? slice : 3;
+		lane = pass == 0 && slice == 0
+			? segment
+			: (uint32_t)((index_seed >> 32) % state->nb_lanes);
+		window_size = nb_segments * state->segment_size +
+			(lane == segment ? block - 1 :
+			 block == 0 ? (uint32_t)-1 : 0);
+
+		/* Find reference block */
+		j1 = index_seed & 0xffffffff;
+		x = (j1 * j1) >> 32;
+		y = (window_size * x) >> 32;
+		z = (window_size - 1) - y;
+		ref = (uint32_t)((window_start + z) % state->lane_size);
+		reference = state->blocks + (lane * state->lane_size + ref);
+
+		/* Shuffle the previous & reference block into the current block */
+		_copy_block(&tmp, previous);
+		_xor_block(&tmp, reference);
+
+		if (pass == 0)
+		{
+			_copy_block(current, &tmp);
+		}
+		else
+		{
+			_xor_block(current, &tmp);
+		}
+
+		_g_rounds(&tmp);
+		_xor_block(current, &tmp);
+	}
+
+	_zero_block(tmp.a, ARGON2_BLOCK_WORDS);
+	_zero_block(index_block.a, ARGON2_BLOCK_WORDS);
+}
+
+static void _fill_lanes(Argon2FillState* state, uint32_t threadIndex)
+{
+	uint32_t pass, slice, lane;
+
+	for (pass = 0; pass < state->nb_passes; pass++)
+	{
+		for (slice = 0; slice < ARGON2_SYNC_POINTS; slice++)
+		{
+			/* Lanes are distributed round-robin over the threads */
+			for (lane = threadIndex; lane < state->nb_lanes; lane += state->nb_threads)
+			{
+				_fill_segment(state, pass, slice, lane);
+			}
+
+			/* All segments must be complete before the next slice */
+			_barrier_wait(state);
+		}
+	}
+}
+
+static _THREAD_RETURN _worker_main(void* arg)
+{
+	Argon2Worker* worker;
+	Argon2FillState* state;
+	int32_t aborted;
+
+	worker = (Argon2Worker*)arg;
+	state = worker->state;
+
+	/* Wait for the creating thread to start or abort the job */
+	_mutex_lock(&state->lock);
+
+	while (!state->started && !state->aborted)
+	{
+		_cond_wait(&state->cond, &state->lock);
+	}
+
+	aborted = state->aborted;
+	_mutex_unlock(&state->lock);
+
+	if (!aborted)
+	{
+		_fill_lanes(state, worker->index);
+	}
+
+	return 0;
+}
+
+static int32_t _thread_create(_thread_t* thread, Argon2Worker* worker)
+{
+#ifdef _P_IS_WINDOWS
+	*thread = CreateThread(NULL, 0, _worker_main, worker, 0, NULL);
+	return *thread != NULL;
+#else
+	return pthread_create(thread, NULL, _worker_main, worker) == 0;
+#endif
+}
+
+static void _thread_join(_thread_t thread)
+{
+#ifdef _P_IS_WINDOWS
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+}
+
+/*
+* Threads are created for every hash and joined before it returns instead of
+* being kept in a pool. Creating a thread costs tens of microseconds while a
+* password hash takes tens of milliseconds, and this library has no init or
+* shutdown hooks that could own long lived threads. Hashes are also already
+* dispatched from the managed thread pool, so idle native workers would only
+* compete with it. Callers that hash at very high rates should use a single
+* lane, which never creates threads.
+*/
+static argon2_error_codes _argon2_parallel(
+	uint8_t* hash,
+	uint32_t hash_size,
+	void* work_area,
+	const crypto_argon2_config* config,
+	const crypto_argon2_inputs* inputs,
+	const crypto_argon2_extras* extras,
+	uint32_t nb_threads
+)
+{
+	Argon2FillState state;
+	Argon2Worker workers[ARGON2_MAX_THREADS];
+	_thread_t threads[ARGON2_MAX_THREADS];
+	uint8_t initial_hash[72];
+	uint8_t hash_area[1024];
+	crypto_blake2b_ctx ctx;
+	uint32_t l, i, created;
+	blk *last_block, *next_block;
+
+	state.blocks = (blk*)work_area;
+	state.algorithm = config->algorithm;
+	state.nb_passes = config->nb_passes;
+	state.nb_lanes = config->nb_lanes;
+	state.segment_size = config->nb_blocks / config->nb_lanes / ARGON2_SYNC_POINTS;
+	state.lane_size = state.segment_size * ARGON2_SYNC_POINTS;
+	state.nb_blocks = state.lane_size * config->nb_lanes;
+	state.nb_threads = nb_threads;
+	state.waiting = 0;
+	state.generation = 0;
+	state.started = 0;
+	state.aborted = 0;
+
+	/* Compute H0 and fill the first two blocks of each lane */
+	crypto_blake2b_init(&ctx, 64);
+	_blake_update_32(&ctx, config->nb_lanes);
+	_blake_update_32(&ctx, hash_size);
+	_blake_update_32(&ctx, config->nb_blocks);
+	_blake_update_32(&ctx, config->nb_passes);
+	_blake_update_32(&ctx, 0x13);
+	_blake_update_32(&ctx, config->algorithm);
+	_blake_update_32_buf(&ctx, inputs->pass, inputs->pass_size);
+	_blake_update_32_buf(&ctx, inputs->salt, inputs->salt_size);
+	_blake_update_32_buf(&ctx, extras->key, extras->key_size);
+	_blake_update_32_buf(&ctx, extras->ad, extras->ad_size);
+	crypto_blake2b_final(&ctx, initial_hash);
+
+	for (l = 0; l < config->nb_lanes; l++)
+	{
+		for (i = 0; i < 2; i++)
+		{
+			_store32_le(initial_hash + 64, i);
+			_store32_le(initial_hash + 68, l);
+			_extended_hash(hash_area, 1024, initial_hash, 72);
+
+			for (created = 0; created < ARGON2_BLOCK_WORDS; created++)
+			{
+				state.blocks[l * state.lane_size + i].a[created] = _load64_le(hash_area + (created * 8));
+			}
+		}
+	}
+
+	crypto_wipe(initial_hash, sizeof(initial_hash));
+	crypto_wipe(hash_area, sizeof(hash_area));
+
+	if (_mutex_init(&state.lock) != 0)
+	{
+		return ARGON2_THREAD_FAIL;
+	}
+
+	if (_cond_init(&state.cond) != 0)
+	{
+		_mutex_destroy(&state.lock);
+		return ARGON2_THREAD_FAIL;
+	}
+
+	/* The calling thread is worker 0, so only spawn the remaining threads */
+	for (created = 0; created < nb_threads - 1; created++)
+	{
+		workers[created].state = &state;
+		workers[created].index = created + 1;
+
+		if (!_thread_create(&threads[created], &workers[created]))
+		{
+			break;
+		}
+	}
+
+	_mutex_lock(&state.lock);
+
+	if (created == nb_threads - 1)
+	{
+		state.started = 1;
+	}
+	else
+	{
+		state.aborted = 1;
+	}
+
+	_cond_broadcast(&state.cond);
+	_mutex_unlock(&state.lock);
+
+	if (state.started)
+	{
+		_fill_lanes(&state, 0);
+	}
+
+	for (i = 0; i < created; i++)
+	{
+		_thread_join(threads[i]);
+	}
+
+	_cond_destroy(&state.cond);
+	_mutex_destroy(&state.lock);
+
+	if (state.aborted)
+	{
+		_zero_block((uint64_t*)work_area, (uint64_t)ARGON2_BLOCK_WORDS * state.nb_blocks);
+		return ARGON2_THREAD_FAIL;
+	}
+
+	/* XOR last blocks of each lane */
+	last_block = state.blocks + state.lane_size - 1;
+	for (l = 1; l < config->nb_lanes; l++)
+	{
+		next_block = last_block + state.lane_size;
+		_xor_block(next_block, last_block);
+		last_block = next_block;
+	}
+
+	/* Serialize last block */
+	for (i = 0; i < ARGON2_BLOCK_WORDS; i++)
+	{
+		_store64_le(hash_area + (i * 8), last_block->a[i]);
+	}
+
+	/* Wipe work area */
+	_zero_block((uint64_t*)work_area, (uint64_t)ARGON2_BLOCK_WORDS * state.nb_blocks);
+
+	/* Hash the very last block with H' into the output hash */
+	_extended_hash(hash, hash_size, hash_area, 1024);
+	crypto_wipe(hash_area, sizeof(hash_area));
+
+	return ARGON2_OK;
+}
+
+#endif /* !VNLIB_ARGON2_NO_THREADS */
+
 /*
 * The purpose of this function is to remap the Argon2 context/function call
 * interface to the Monocypher library version. Also performing some basic
@@ -36,6 +602,7 @@ VNLIB_EXPORT argon2_error_codes VNLIB_CC Argon2ComputeHash(const argon2Ctx* cont
 	crypto_argon2_config config;
 	crypto_argon2_inputs inputs;
 	crypto_argon2_extras extras;
+	uint32_t threads;
 
 	if (!context || !workArea)
 	{
@@ -43,9 +610,9 @@ VNLIB_EXPORT argon2_error_codes VNLIB_CC Argon2ComputeHash(const argon2Ctx* cont
 	}
 
 	config.algorithm = context->version;
-	config.nb_blocks = context->m_cost;	
+	config.nb_blocks = context->m_cost;
 	config.nb_passes = context->t_cost;
-	config.nb_lanes = context->threads;	
+	config.nb_lanes = context->lanes;
 
 	inputs.pass_size = context->pwdlen;
 	inputs.pass = context->pwd;
@@ -97,8 +664,41 @@ VNLIB_EXPORT argon2_error_codes VNLIB_CC Argon2ComputeHash(const argon2Ctx* cont
 		return ARGON2_OUTPUT_PTR_NULL;
 	}
 
+	if (config.nb_lanes < 1)
+	{
+		return ARGON2_LANES_TOO_FEW;
+	}
+
+	/* the memory cost must allow at least 2 blocks per segment */
+	if (config.nb_blocks < 8 * config.nb_lanes)
+	{
+		return ARGON2_MEMORY_TOO_LITTLE;
+	}
+
+	if (config.nb_passes < 1)
+	{
+		return ARGON2_TIME_TOO_SMALL;
+	}
+
+	/* threads beyond the number of lanes have no work to do */
+	threads = context->threads < config.nb_lanes ? context->threads : config.nb_lanes;
+
+#ifndef VNLIB_ARGON2_NO_THREADS
+
+	if (threads > ARGON2_MAX_THREADS)
+	{
+		threads = ARGON2_MAX_THREADS;
+	}
+
+	if (threads > 1)
+	{
+		return _argon2_parallel(context->out, context->outlen, workArea, &config, &inputs, &extras, threads);
+	}
+
+#endif
+
 	/* invoke lib function */
 	crypto_argon2(context->out, context->outlen, workArea, config, inputs, extras);
 
 	return ARGON2_OK;
-}
\ No newline at end of file
+}
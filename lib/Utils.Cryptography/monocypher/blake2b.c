@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <monocypher.h>
 #include "blake2b.h"
+#include "cpu.h"
 
 VNLIB_EXPORT uint32_t VNLIB_CC Blake2GetContextSize(void)
 {
@@ -88,3 +89,80 @@ VNLIB_EXPORT int32_t VNLIB_CC Blake2GetHashSize(void* context)
 	VALIDATE_PTR(ctx);
 	return (int32_t)ctx->hash_size;
 }
+
+VNLIB_EXPORT int32_t VNLIB_CC Blake2ComputeMany(
+	uint32_t count,
+	const void* const* messages,
+	const uint32_t* lengths,
+	void* const* outputs,
+	uint32_t hashlen,
+	const void* key,
+	uint32_t keylen
+)
+{
+	uint32_t i;
+
+	VALIDATE_PTR(messages);
+	VALIDATE_PTR(lengths);
+	VALIDATE_PTR(outputs);
+
+	if (hashlen == 0 || hashlen > MC_MAX_HASH_SIZE)
+	{
+		return ERR_HASH_LEN_INVALID;
+	}
+
+	if (keylen > MC_MAX_KEY_SIZE)
+	{
+		return ERR_KEY_LEN_INVALID;
+	}
+
+	if (keylen > 0 && !key)
+	{
+		return ERR_KEY_PTR_INVALID;
+	}
+
+	if (count > INT32_MAX)
+	{
+		return ERR_INVALID_PTR;
+	}
+
+	/* validate every message before writing any output */
+	for (i = 0; i < count; i++)
+	{
+		VALIDATE_PTR(outputs[i]);
+
+		if (lengths[i] > 0 && !messages[i])
+		{
+			return ERR_INVALID_PTR;
+		}
+	}
+
+	i = 0;
+
+#ifdef VNLIB_AVX2_KERNELS
+
+	if (_vnCpuHasAvx2())
+	{
+		for (; count - i >= 4; i += 4)
+		{
+			_blake2bHashX4(messages + i, lengths + i, outputs + i, hashlen, (const uint8_t*)key, keylen);
+		}
+	}
+
+#endif
+
+	/* remaining messages (or all of them without AVX2) are hashed one at a time */
+	for (; i < count; i++)
+	{
+		crypto_blake2b_keyed(
+			(uint8_t*)outputs[i],
+			hashlen,
+			(const uint8_t*)key,
+			keylen,
+			(const uint8_t*)messages[i],
+			lengths[i]
+		);
+	}
+
+	return (int32_t)count;
+}
@@ -41,4 +41,35 @@ VNLIB_EXPORT int32_t VNLIB_CC Blake2Final(void* context, void* hash, uint32_t ha
 
 VNLIB_EXPORT int32_t VNLIB_CC Blake2GetHashSize(void* context);
 
+/*
+* Computes the (optionally keyed) hash of many independent messages in a single
+* call. Every message is hashed with the same hash length and key, the hash of
+* message i is written to outputs[i]. Returns the number of messages hashed or
+* a negative error code if any argument is invalid, in which case no hashes
+* are written.
+*/
+VNLIB_EXPORT int32_t VNLIB_CC Blake2ComputeMany(
+	uint32_t count,
+	const void* const* messages,
+	const uint32_t* lengths,
+	void* const* outputs,
+	uint32_t hashlen,
+	const void* key,
+	uint32_t keylen
+);
+
+#ifdef VNLIB_AVX2_KERNELS
+
+/* Internal AVX2 kernel that hashes exactly 4 messages, arguments must already be validated */
+void _blake2bHashX4(
+	const void* const* messages,
+	const uint32_t* lengths,
+	void* const* outputs,
+	uint32_t hashlen,
+	const uint8_t* key,
+	uint32_t keylen
+);
+
+#endif
+
 #endif
@@ -0,0 +1,309 @@
+/*
+* Copyright (c) 2024 Vaughn Nugent
+*
+* vnlib_monocypher is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* vnlib_monocypher is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
+*/
+
+/*
+* 4-way BLAKE2b kernel. Each 256 bit register holds the same state word of
+* four independent messages so four hashes are computed with the
+* instructions of one. This file must be compiled with AVX2 enabled and must
+* only be called after the cpu has been checked for AVX2 support.
+*/
+
+#include <string.h>
+#include <immintrin.h>
+#include <monocypher.h>
+#include "blake2b.h"
+
+#define BLAKE2B_BLOCK_SIZE 128
+
+static const uint8_t zeroBlock[BLAKE2B_BLOCK_SIZE] = { 0 };
+
+static const uint64_t blake2b_iv[8] = {
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
+	0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+	0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+	0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static const uint8_t blake2b_sigma[12][16] = {
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+	{ 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+	{  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+	{  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+	{  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+	{ 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+	{ 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+	{  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+	{ 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 },
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+};
+
+#define ADD(a, b) _mm256_add_epi64(a, b)
+#define XOR(a, b) _mm256_xor_si256(a, b)
+
+#define ROTR32(x) _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1))
+#define ROTR24(x) _mm256_shuffle_epi8(x, rot24)
+#define ROTR16(x) _mm256_shuffle_epi8(x, rot16)
+#define ROTR63(x) _mm256_or_si256(_mm256_srli_epi64(x, 63), _mm256_add_epi64(x, x))
+
+#define G(r, i, a, b, c, d)										\
+	a = ADD(ADD(a, b), m[blake2b_sigma[r][2 * i]]);				\
+	d = ROTR32(XOR(d, a));										\
+	c = ADD(c, d);												\
+	b = ROTR24(XOR(b, c));										\
+	a = ADD(ADD(a, b), m[blake2b_sigma[r][2 * i + 1]]);			\
+	d = ROTR16(XOR(d, a));										\
+	c = ADD(c, d);												\
+	b = ROTR63(XOR(b, c))
+
+#define ROUND(r)								\
+	G(r, 0, v[0], v[4], v[8],  v[12]);			\
+	G(r, 1, v[1], v[5], v[9],  v[13]);			\
+	G(r, 2, v[2], v[6], v[10], v[14]);			\
+	G(r, 3, v[3], v[7], v[11], v[15]);			\
+	G(r, 4, v[0], v[5], v[10], v[15]);			\
+	G(r, 5, v[1], v[6], v[11], v[12]);			\
+	G(r, 6, v[2], v[7], v[8],  v[13]);			\
+	G(r, 7, v[3], v[4], v[9],  v[14])
+
+typedef struct blake2b_lane_struct {
+	const uint8_t* message;
+	uint64_t length;
+	uint64_t total;
+	uint64_t blocks;
+} blake2b_lane;
+
+static void _compressX4(__m256i h[8], const __m256i m[16], __m256i t, __m256i f, __m256i active)
+{
+	const __m256i rot24 = _mm256_setr_epi8(
+		3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+		3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10
+	);
+	const __m256i rot16 = _mm256_setr_epi8(
+		2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+		2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9
+	);
+
+	__m256i v[16];
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		v[i] = h[i];
+		v[i + 8] = _mm256_set1_epi64x((long long)blake2b_iv[i]);
+	}
+
+	/* counter high word is always 0, messages are limited to 32 bit lengths */
+	v[12] = XOR(v[12], t);
+	v[14] = XOR(v[14], f);
+
+	/* fully unrolled so the message schedule indexes are constants */
+	ROUND(0);
+	ROUND(1);
+	ROUND(2);
+	ROUND(3);
+	ROUND(4);
+	ROUND(5);
+	ROUND(6);
+	ROUND(7);
+	ROUND(8);
+	ROUND(9);
+	ROUND(10);
+	ROUND(11);
+
+	/* lanes that have already consumed their final block keep their state */
+	for (i = 0; i < 8; i++)
+	{
+		h[i] = _mm256_blendv_epi8(h[i], XOR(h[i], XOR(v[i], v[i + 8])), active);
+	}
+}
+
+/*
+* Gets the block'th 128 byte block of a lane, the key block (if any) comes
+* first. Full message blocks are read in place, the final partial block is
+* zero padded into the scratch buffer. Stores the byte counter for the block.
+*/
+static const uint8_t* _getBlock(
+	const blake2b_lane* lane,
+	uint64_t block,
+	const uint8_t* keyBlock,
+	uint8_t scratch[BLAKE2B_BLOCK_SIZE],
+	uint64_t* counter
+)
+{
+	uint64_t offset, remaining;
+
+	if (keyBlock != NULL)
+	{
+		if (block == 0)
+		{
+			*counter = lane->blocks == 1 ? lane->total : BLAKE2B_BLOCK_SIZE;
+			return keyBlock;
+		}
+
+		block--;
+	}
+
+	offset = block * BLAKE2B_BLOCK_SIZE;
+	remaining = lane->length - offset;
+
+	if (remaining >= BLAKE2B_BLOCK_SIZE)
+	{
+		*counter = (keyBlock != NULL ? BLAKE2B_BLOCK_SIZE : 0) + offset + BLAKE2B_BLOCK_SIZE;
+		return lane->message + offset;
+	}
+
+	memset(scratch, 0, BLAKE2B_BLOCK_SIZE);
+
+	if (remaining > 0)
+	{
+		memcpy(scratch, lane->message + offset, (size_t)remaining);
+	}
+
+	*counter = (keyBlock != NULL ? BLAKE2B_BLOCK_SIZE : 0) + lane->length;
+	return scratch;
+}
+
+/* transposes 4 blocks so register j holds message word j of all 4 lanes */
+static void _loadMessageX4(__m256i m[16], const uint8_t* const blocks[4])
+{
+	__m256i a, b, c, d, t0, t1, t2, t3;
+	int j;
+
+	for (j = 0; j < 16; j += 4)
+	{
+		a = _mm256_loadu_si256((const __m256i*)(blocks[0] + j * 8));
+		b = _mm256_loadu_si256((const __m256i*)(blocks[1] + j * 8));
+		c = _mm256_loadu_si256((const __m256i*)(blocks[2] + j * 8));
+		d = _mm256_loadu_si256((const __m256i*)(blocks[3] + j * 8));
+
+		t0 = _mm256_unpacklo_epi64(a, b);
+		t1 = _mm256_unpackhi_epi64(a, b);
+		t2 = _mm256_unpacklo_epi64(c, d);
+		t3 = _mm256_unpackhi_epi64(c, d);
+
+		m[j]     = _mm256_permute2x128_si256(t0, t2, 0x20);
+		m[j + 1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+		m[j + 2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+		m[j + 3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+	}
+}
+
+void _blake2bHashX4(
+	const void* const* messages,
+	const uint32_t* lengths,
+	void* const* outputs,
+	uint32_t hashlen,
+	const uint8_t* key,
+	uint32_t keylen
+)
+{
+	blake2b_lane lanes[4];
+	uint8_t scratch[4][BLAKE2B_BLOCK_SIZE];
+	const uint8_t* blocks[4];
+	uint64_t state[8][4];
+	uint64_t counters[4], finals[4], masks[4];
+	uint8_t keyBlock[BLAKE2B_BLOCK_SIZE];
+	uint8_t hash[MC_MAX_HASH_SIZE];
+	__m256i h[8], m[16];
+	uint64_t block, maxBlocks;
+	int i, j;
+
+	if (keylen > 0)
+	{
+		memset(keyBlock, 0, sizeof(keyBlock));
+		memcpy(keyBlock, key, keylen);
+	}
+
+	maxBlocks = 0;
+
+	for (i = 0; i < 4; i++)
+	{
+		lanes[i].message = (const uint8_t*)messages[i];
+		lanes[i].length = lengths[i];
+		lanes[i].total = lengths[i] + (keylen > 0 ? BLAKE2B_BLOCK_SIZE : 0);
+		lanes[i].blocks = lanes[i].total == 0 ? 1 : (lanes[i].total + BLAKE2B_BLOCK_SIZE - 1) / BLAKE2B_BLOCK_SIZE;
+
+		if (lanes[i].blocks > maxBlocks)
+		{
+			maxBlocks = lanes[i].blocks;
+		}
+	}
+
+	/* parameter block, only the digest and key length are non-zero */
+	for (j = 0; j < 8; j++)
+	{
+		h[j] = _mm256_set1_epi64x((long long)blake2b_iv[j]);
+	}
+
+	h[0] = XOR(h[0], _mm256_set1_epi64x((long long)(0x01010000ULL ^ ((uint64_t)keylen << 8) ^ hashlen)));
+
+	/*
+	* Lanes with fewer blocks sit idle (masked) until the longest message is
+	* done, callers get the most out of this with similarly sized messages
+	*/
+	for (block = 0; block < maxBlocks; block++)
+	{
+		for (i = 0; i < 4; i++)
+		{
+			if (block < lanes[i].blocks)
+			{
+				blocks[i] = _getBlock(&lanes[i], block, keylen > 0 ? keyBlock : NULL, scratch[i], &counters[i]);
+				finals[i] = block == lanes[i].blocks - 1 ? ~0ULL : 0;
+				masks[i] = ~0ULL;
+			}
+			else
+			{
+				/* idle lanes hash the zero block, the result is discarded */
+				blocks[i] = zeroBlock;
+				counters[i] = finals[i] = masks[i] = 0;
+			}
+		}
+
+		_loadMessageX4(m, blocks);
+
+		_compressX4(
+			h,
+			m,
+			_mm256_loadu_si256((const __m256i*)counters),
+			_mm256_loadu_si256((const __m256i*)finals),
+			_mm256_loadu_si256((const __m256i*)masks)
+		);
+	}
+
+	for (j = 0; j < 8; j++)
+	{
+		_mm256_storeu_si256((__m256i*)state[j], h[j]);
+	}
+
+	/* x86 is little endian so the state words can be copied out directly */
+	for (i = 0; i < 4; i++)
+	{
+		for (j = 0; j < 8; j++)
+		{
+			memcpy(hash + j * 8, &state[j][i], sizeof(uint64_t));
+		}
+
+		memcpy(outputs[i], hash, hashlen);
+	}
+
+	crypto_wipe(keyBlock, sizeof(keyBlock));
+	crypto_wipe(scratch, sizeof(scratch));
+	crypto_wipe(state, sizeof(state));
+	crypto_wipe(hash, sizeof(hash));
+}
@@ -0,0 +1,755 @@
+/*
+* Copyright (c) 2023 Vaughn Nugent
+*
+* vnlib_monocypher is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* vnlib_monocypher is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
+*/
+
+/*
+* BLAKE3 implementation following the reference implementation in the
+* BLAKE3 specification. Whole chunks are hashed 8 at a time with the AVX2
+* kernel when the cpu supports it, and the one-shot function hashes
+* independent subtrees of large inputs on multiple threads.
+*/
+
+#include <string.h>
+#include <monocypher.h>
+#include "blake3.h"
+#include "cpu.h"
+
+#ifndef VNLIB_ARGON2_NO_THREADS
+	#ifdef _P_IS_WINDOWS
+		#define WIN32_LEAN_AND_MEAN
+		#include <Windows.h>
+	#else
+		#include <pthread.h>
+	#endif
+#endif
+
+/*
+* Subtrees smaller than this are never split over threads, the cost of
+* creating a thread is larger than the time to hash them
+*/
+#ifndef BLAKE3_MIN_PARALLEL_LEN
+	#define BLAKE3_MIN_PARALLEL_LEN (128 * 1024)
+#endif
+
+#ifndef BLAKE3_MAX_THREADS
+	#define BLAKE3_MAX_THREADS 64
+#endif
+
+static const uint32_t blake3_iv[8] = {
+	0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+	0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+};
+
+/* message word permutation applied before every round */
+static const uint8_t blake3_schedule[7][16] = {
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+	{  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+	{ 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+	{ 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+	{  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+	{ 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+/*
+* The output of a node before it is known if it is the root, only the
+* chaining value is needed for non-root nodes
+*/
+typedef struct blake3_output_struct {
+	uint32_t cv[8];
+	uint8_t block[BLAKE3_BLOCK_LEN];
+	uint64_t counter;
+	uint8_t blockLen;
+	uint8_t flags;
+} blake3_output;
+
+static uint32_t _load32_le(const uint8_t s[4])
+{
+	return (uint32_t)s[0]
+		| ((uint32_t)s[1] << 8)
+		| ((uint32_t)s[2] << 16)
+		| ((uint32_t)s[3] << 24);
+}
+
+static void _store32_le(uint8_t out[4], uint32_t in)
+{
+	out[0] = (uint8_t)in;
+	out[1] = (uint8_t)(in >> 8);
+	out[2] = (uint8_t)(in >> 16);
+	out[3] = (uint8_t)(in >> 24);
+}
+
+static uint32_t _rotr32(uint32_t x, uint32_t n) { return (x >> n) | (x << (32 - n)); }
+
+#define G(a, b, c, d, x, y)				\
+	a = a + b + x;						\
+	d = _rotr32(d ^ a, 16);				\
+	c = c + d;							\
+	b = _rotr32(b ^ c, 12);				\
+	a = a + b + y;						\
+	d = _rotr32(d ^ a, 8);				\
+	c = c + d;							\
+	b = _rotr32(b ^ c, 7)
+
+static void _compress(
+	const uint32_t cv[8],
+	const uint8_t block[BLAKE3_BLOCK_LEN],
+	uint8_t blockLen,
+	uint64_t counter,
+	uint8_t flags,
+	uint32_t state[16]
+)
+{
+	uint32_t m[16];
+	const uint8_t* s;
+	int i;
+
+	for (i = 0; i < 16; i++)
+	{
+		m[i] = _load32_le(block + i * 4);
+	}
+
+	for (i = 0; i < 8; i++)
+	{
+		state[i] = cv[i];
+	}
+
+	state[8] = blake3_iv[0];
+	state[9] = blake3_iv[1];
+	state[10] = blake3_iv[2];
+	state[11] = blake3_iv[3];
+	state[12] = (uint32_t)counter;
+	state[13] = (uint32_t)(counter >> 32);
+	state[14] = blockLen;
+	state[15] = flags;
+
+	for (i = 0; i < 7; i++)
+	{
+		s = blake3_schedule[i];
+
+		G(state[0], state[4], state[8],  state[12], m[s[0]],  m[s[1]]);
+		G(state[1], state[5], state[9],  state[13], m[s[2]],  m[s[3]]);
+		G(state[2], state[6], state[10], state[14], m[s[4]],  m[s[5]]);
+		G(state[3], state[7], state[11], state[15], m[s[6]],  m[s[7]]);
+		G(state[0], state[5], state[10], state[15], m[s[8]],  m[s[9]]);
+		G(state[1], state[6], state[11], state[12], m[s[10]], m[s[11]]);
+		G(state[2], state[7], state[8],  state[13], m[s[12]], m[s[13]]);
+		G(state[3], state[4], state[9],  state[14], m[s[14]], m[s[15]]);
+	}
+}
+
+static void _compressInPlace(uint32_t cv[8], const uint8_t block[BLAKE3_BLOCK_LEN], uint8_t blockLen, uint64_t counter, uint8_t flags)
+{
+	uint32_t state[16];
+	int i;
+
+	_compress(cv, block, blockLen, counter, flags, state);
+
+	for (i = 0; i < 8; i++)
+	{
+		cv[i] = state[i] ^ state[i + 8];
+	}
+}
+
+static void _keyWords(const uint8_t* key, uint32_t words[8])
+{
+	int i;
+	for (i = 0; i < 8; i++)
+	{
+		words[i] = _load32_le(key + i * 4);
+	}
+}
+
+/* ---------------- chunk state ---------------- */
+
+static void _chunkInit(blake3_chunk_state* chunk, const uint32_t key[8], uint64_t counter, uint8_t flags)
+{
+	memcpy(chunk->cv, key, sizeof(chunk->cv));
+	memset(chunk->block, 0, sizeof(chunk->block));
+	chunk->chunkCounter = counter;
+	chunk->blockLen = 0;
+	chunk->blocksCompressed = 0;
+	chunk->flags = flags;
+}
+
+static size_t _chunkLen(const blake3_chunk_state* chunk)
+{
+	return (BLAKE3_BLOCK_LEN * (size_t)chunk->blocksCompressed) + chunk->blockLen;
+}
+
+static uint8_t _chunkStartFlag(const blake3_chunk_state* chunk)
+{
+	return chunk->blocksCompressed == 0 ? BLAKE3_CHUNK_START : 0;
+}
+
+static void _chunkUpdate(blake3_chunk_state* chunk, const uint8_t* input, size_t len)
+{
+	size_t take;
+
+	while (len > 0)
+	{
+		/* a full block is only compressed once more input arrives, it may be the last */
+		if (chunk->blockLen == BLAKE3_BLOCK_LEN)
+		{
+			_compressInPlace(
+				chunk->cv,
+				chunk->block,
+				BLAKE3_BLOCK_LEN,
+				chunk->chunkCounter,
+				chunk->flags | _chunkStartFlag(chunk)
+			);
+
+			chunk->blocksCompressed++;
+			chunk->blockLen = 0;
+			memset(chunk->block, 0, sizeof(chunk->block));
+		}
+
+		take = BLAKE3_BLOCK_LEN - chunk->blockLen;
+		take = take < len ? take : len;
+
+		memcpy(chunk->block + chunk->blockLen, input, take);
+		chunk->blockLen += (uint8_t)take;
+		input += take;
+		len -= take;
+	}
+}
+
+static void _chunkOutput(const blake3_chunk_state* chunk, blake3_output* out)
+{
+	memcpy(out->cv, chunk->cv, sizeof(out->cv));
+	memcpy(out->block, chunk->block, sizeof(out->block));
+	out->counter = chunk->chunkCounter;
+	out->blockLen = chunk->blockLen;
+	out->flags = chunk->flags | _chunkStartFlag(chunk) | BLAKE3_CHUNK_END;
+}
+
+/* ---------------- node outputs ---------------- */
+
+static void _parentOutput(const uint32_t left[8], const uint32_t right[8], const uint32_t key[8], uint8_t flags, blake3_output* out)
+{
+	int i;
+
+	memcpy(out->cv, key, sizeof(out->cv));
+
+	for (i = 0; i < 8; i++)
+	{
+		_store32_le(out->block + i * 4, left[i]);
+		_store32_le(out->block + 32 + i * 4, right[i]);
+	}
+
+	/* parent nodes always use counter 0 and a full block */
+	out->counter = 0;
+	out->blockLen = BLAKE3_BLOCK_LEN;
+	out->flags = flags | BLAKE3_PARENT;
+}
+
+static void _outputCv(const blake3_output* out, uint32_t cv[8])
+{
+	memcpy(cv, out->cv, sizeof(out->cv));
+	_compressInPlace(cv, out->block, out->blockLen, out->counter, out->flags);
+}
+
+static void _parentCv(const uint32_t left[8], const uint32_t right[8], const uint32_t key[8], uint8_t flags, uint32_t cv[8])
+{
+	blake3_output out;
+	_parentOutput(left, right, key, flags, &out);
+	_outputCv(&out, cv);
+}
+
+/* The root node is extended to any output length by incrementing the counter */
+static void _outputRootBytes(const blake3_output* out, uint8_t* hash, uint32_t hashlen)
+{
+	uint32_t state[16];
+	uint8_t block[BLAKE3_BLOCK_LEN];
+	uint64_t counter;
+	uint32_t take;
+	int i;
+
+	for (counter = 0; hashlen > 0; counter++)
+	{
+		_compress(out->cv, out->block, out->blockLen, counter, out->flags | BLAKE3_ROOT, state);
+
+		for (i = 0; i < 8; i++)
+		{
+			_store32_le(block + i * 4, state[i] ^ state[i + 8]);
+			_store32_le(block + 32 + i * 4, state[i + 8] ^ out->cv[i]);
+		}
+
+		take = hashlen < BLAKE3_BLOCK_LEN ? hashlen : BLAKE3_BLOCK_LEN;
+		memcpy(hash, block, take);
+
+		hash += take;
+		hashlen -= take;
+	}
+
+	crypto_wipe(state, sizeof(state));
+	crypto_wipe(block, sizeof(block));
+}
+
+/* ---------------- multi-chunk hashing ---------------- */
+
+/* Hashes count consecutive full chunks and writes the chaining value of each */
+static void _hashChunks(const uint8_t* input, size_t count, const uint32_t key[8], uint64_t counter, uint8_t flags, uint32_t (*cvs)[8])
+{
+	size_t i;
+	int block;
+
+#ifdef VNLIB_AVX2_KERNELS
+
+	if (_vnCpuHasAvx2())
+	{
+		for (; count >= BLAKE3_SIMD_DEGREE; count -= BLAKE3_SIMD_DEGREE)
+		{
+			_blake3HashChunksX8(input, key, counter, flags, cvs);
+
+			input += BLAKE3_SIMD_DEGREE * BLAKE3_CHUNK_LEN;
+			counter += BLAKE3_SIMD_DEGREE;
+			cvs += BLAKE3_SIMD_DEGREE;
+		}
+	}
+
+#endif
+
+	for (i = 0; i < count; i++)
+	{
+		memcpy(cvs[i], key, sizeof(cvs[i]));
+
+		for (block = 0; block < BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN; block++)
+		{
+			_compressInPlace(
+				cvs[i],
+				input + block * BLAKE3_BLOCK_LEN,
+				BLAKE3_BLOCK_LEN,
+				counter + i,
+				flags
+					| (block == 0 ? BLAKE3_CHUNK_START : 0)
+					| (block == (BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN) - 1 ? BLAKE3_CHUNK_END : 0)
+			);
+		}
+
+		input += BLAKE3_CHUNK_LEN;
+	}
+}
+
+/* ---------------- incremental hasher ---------------- */
+
+static void _hasherInit(blake3_hasher* hasher, const uint32_t key[8], uint8_t flags)
+{
+	memcpy(hasher->key, key, sizeof(hasher->key));
+	_chunkInit(&hasher->chunk, key, 0, flags);
+	hasher->cvStackLen = 0;
+	hasher->flags = flags;
+}
+
+/*
+* Pushes a completed chunk, merging completed subtrees first. The number of
+* completed subtrees is the number of trailing zero bits in the total chunks.
+*/
+static void _hasherAddChunkCv(blake3_hasher* hasher, uint32_t cv[8], uint64_t totalChunks)
+{
+	while ((totalChunks & 1) == 0)
+	{
+		hasher->cvStackLen--;
+		_parentCv(hasher->cvStack[hasher->cvStackLen], cv, hasher->key, hasher->flags, cv);
+		totalChunks >>= 1;
+	}
+
+	memcpy(hasher->cvStack[hasher->cvStackLen], cv, sizeof(hasher->cvStack[0]));
+	hasher->cvStackLen++;
+}
+
+static void _hasherUpdate(blake3_hasher* hasher, const uint8_t* input, size_t len)
+{
+	uint32_t cvs[BLAKE3_SIMD_DEGREE][8];
+	uint32_t cv[8];
+	blake3_output out;
+	uint64_t totalChunks;
+	size_t take, i;
+
+	while (len > 0)
+	{
+		/* the current chunk is only finalized once more input arrives, it may be the root */
+		if (_chunkLen(&hasher->chunk) == BLAKE3_CHUNK_LEN)
+		{
+			_chunkOutput(&hasher->chunk, &out);
+			_outputCv(&out, cv);
+
+			totalChunks = hasher->chunk.chunkCounter + 1;
+			_hasherAddChunkCv(hasher, cv, totalChunks);
+			_chunkInit(&hasher->chunk, hasher->key, totalChunks, hasher->flags);
+		}
+
+		/*
+		* Whole chunks at a chunk boundary are hashed with the multi-buffer
+		* kernel, as long as more input follows none of them can be the root
+		*/
+		while (_chunkLen(&hasher->chunk) == 0 && len > BLAKE3_SIMD_DEGREE * BLAKE3_CHUNK_LEN)
+		{
+			_hashChunks(input, BLAKE3_SIMD_DEGREE, hasher->key, hasher->chunk.chunkCounter, hasher->flags, cvs);
+
+			for (i = 0; i < BLAKE3_SIMD_DEGREE; i++)
+			{
+				_hasherAddChunkCv(hasher, cvs[i], hasher->chunk.chunkCounter + i + 1);
+			}
+
+			_chunkInit(&hasher->chunk, hasher->key, hasher->chunk.chunkCounter + BLAKE3_SIMD_DEGREE, hasher->flags);
+
+			input += BLAKE3_SIMD_DEGREE * BLAKE3_CHUNK_LEN;
+			len -= BLAKE3_SIMD_DEGREE * BLAKE3_CHUNK_LEN;
+		}
+
+		take = BLAKE3_CHUNK_LEN - _chunkLen(&hasher->chunk);
+		take = take < len ? take : len;
+
+		_chunkUpdate(&hasher->chunk, input, take);
+		input += take;
+		len -= take;
+	}
+}
+
+static void _hasherFinal(const blake3_hasher* hasher, uint8_t* hash, uint32_t hashlen)
+{
+	blake3_output out;
+	uint32_t cv[8];
+	int i;
+
+	_chunkOutput(&hasher->chunk, &out);
+
+	/* merge the remaining subtrees from the right, the last merge is the root */
+	for (i = (int)hasher->cvStackLen - 1; i >= 0; i--)
+	{
+		_outputCv(&out, cv);
+		_parentOutput(hasher->cvStack[i], cv, hasher->key, hasher->flags, &out);
+	}
+
+	_outputRootBytes(&out, hash, hashlen);
+}
+
+/* ---------------- parallel subtree hashing ---------------- */
+
+#ifndef VNLIB_ARGON2_NO_THREADS
+
+#ifdef _P_IS_WINDOWS
+	typedef HANDLE _thread_t;
+	#define _THREAD_RETURN DWORD WINAPI
+#else
+	typedef pthread_t _thread_t;
+	#define _THREAD_RETURN void*
+#endif
+
+#endif /* !VNLIB_ARGON2_NO_THREADS */
+
+typedef struct blake3_subtree_struct {
+	const uint8_t* input;
+	size_t len;
+	uint64_t counter;
+	const uint32_t* key;
+	uint8_t flags;
+	uint32_t threads;
+	uint32_t cv[8];
+} blake3_subtree;
+
+/*
+* The left subtree holds the largest power of 2 number of whole chunks
+* that leaves at least one byte for the right subtree
+*/
+static size_t _leftLen(size_t len)
+{
+	size_t fullChunks, chunks;
+
+	fullChunks = (len - 1) / BLAKE3_CHUNK_LEN;
+
+	for (chunks = 1; chunks * 2 <= fullChunks; chunks *= 2);
+
+	return chunks * BLAKE3_CHUNK_LEN;
+}
+
+/*
+* Subtrees of at most BLAKE3_SIMD_DEGREE chunks are hashed in one pass,
+* then the chaining values are merged pairwise which produces the same
+* tree shape as the left subtree rule
+*/
+static void _smallSubtreeCv(blake3_subtree* tree)
+{
+	uint32_t cvs[BLAKE3_SIMD_DEGREE][8];
+	blake3_chunk_state chunk;
+	blake3_output out;
+	size_t count, i;
+
+	count = tree->len / BLAKE3_CHUNK_LEN;
+
+	_hashChunks(tree->input, count, tree->key, tree->counter, tree->flags, cvs);
+
+	if (tree->len > count * BLAKE3_CHUNK_LEN)
+	{
+		_chunkInit(&chunk, tree->key, tree->counter + count, tree->flags);
+		_chunkUpdate(&chunk, tree->input + count * BLAKE3_CHUNK_LEN, tree->len - count * BLAKE3_CHUNK_LEN);
+		_chunkOutput(&chunk, &out);
+		_outputCv(&out, cvs[count]);
+		count++;
+	}
+
+	while (count > 1)
+	{
+		for (i = 0; i + 1 < count; i += 2)
+		{
+			_parentCv(cvs[i], cvs[i + 1], tree->key, tree->flags, cvs[i / 2]);
+		}
+
+		if (count & 1)
+		{
+			memcpy(cvs[count / 2], cvs[count - 1], sizeof(cvs[0]));
+		}
+
+		count = (count + 1) / 2;
+	}
+
+	memcpy(tree->cv, cvs[0], sizeof(tree->cv));
+}
+
+static void _subtreeCv(blake3_subtree* tree);
+
+#ifndef VNLIB_ARGON2_NO_THREADS
+
+static _THREAD_RETURN _subtreeWorker(void* arg)
+{
+	_subtreeCv((blake3_subtree*)arg);
+	return 0;
+}
+
+static int _threadCreate(_thread_t* thread, blake3_subtree* tree)
+{
+#ifdef _P_IS_WINDOWS
+	*thread = CreateThread(NULL, 0, _subtreeWorker, tree, 0, NULL);
+	return *thread != NULL;
+#else
+	return pthread_create(thread, NULL, _subtreeWorker, tree) == 0;
+#endif
+}
+
+static void _threadJoin(_thread_t thread)
+{
+#ifdef _P_IS_WINDOWS
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+}
+
+#endif /* !VNLIB_ARGON2_NO_THREADS */
+
+/*
+* Computes the chaining values of both children of the tree, the left child
+* is hashed on a new thread when the tree is large enough and there are
+* threads left to use
+*/
+static void _childCvs(const blake3_subtree* tree, blake3_subtree* left, blake3_subtree* right)
+{
+	size_t leftLen;
+
+	leftLen = _leftLen(tree->len);
+
+	*left = *tree;
+	left->len = leftLen;
+
+	*right = *tree;
+	right->input += leftLen;
+	right->len -= leftLen;
+	right->counter += leftLen / BLAKE3_CHUNK_LEN;
+
+#ifndef VNLIB_ARGON2_NO_THREADS
+
+	if (tree->threads > 1 && tree->len >= BLAKE3_MIN_PARALLEL_LEN)
+	{
+		_thread_t thread;
+
+		left->threads = tree->threads / 2;
+		right->threads = tree->threads - left->threads;
+
+		if (_threadCreate(&thread, left))
+		{
+			_subtreeCv(right);
+			_threadJoin(thread);
+			return;
+		}
+	}
+
+#endif
+
+	/* hash serially if threads are exhausted or could not be created */
+	left->threads = right->threads = 1;
+
+	_subtreeCv(left);
+	_subtreeCv(right);
+}
+
+static void _subtreeCv(blake3_subtree* tree)
+{
+	blake3_subtree left, right;
+
+	if (tree->len <= BLAKE3_SIMD_DEGREE * BLAKE3_CHUNK_LEN)
+	{
+		_smallSubtreeCv(tree);
+		return;
+	}
+
+	_childCvs(tree, &left, &right);
+	_parentCv(left.cv, right.cv, tree->key, tree->flags, tree->cv);
+}
+
+/* ---------------- exports ---------------- */
+
+static int32_t _loadKey(const void* key, uint32_t keylen, uint32_t words[8], uint8_t* flags)
+{
+	if (keylen == 0)
+	{
+		memcpy(words, blake3_iv, sizeof(blake3_iv));
+		*flags = 0;
+		return BLAKE3_RESULT_SUCCESS;
+	}
+
+	if (keylen != BLAKE3_KEY_SIZE)
+	{
+		return ERR_BLAKE3_KEY_LEN_INVALID;
+	}
+
+	VALIDATE_PTR(key);
+
+	_keyWords((const uint8_t*)key, words);
+	*flags = BLAKE3_KEYED_HASH;
+	return BLAKE3_RESULT_SUCCESS;
+}
+
+VNLIB_EXPORT uint32_t VNLIB_CC Blake3GetContextSize(void)
+{
+	return sizeof(blake3_hasher);
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC Blake3Init(void* context, const void* key, uint32_t keylen)
+{
+	uint32_t keyWords[8];
+	uint8_t flags;
+	int32_t result;
+
+	VALIDATE_PTR(context);
+
+	if ((result = _loadKey(key, keylen, keyWords, &flags)) != BLAKE3_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	_hasherInit((blake3_hasher*)context, keyWords, flags);
+
+	crypto_wipe(keyWords, sizeof(keyWords));
+	return BLAKE3_RESULT_SUCCESS;
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC Blake3Update(void* context, const void* data, uint32_t datalen)
+{
+	VALIDATE_PTR(context);
+
+	if (datalen > 0)
+	{
+		VALIDATE_PTR(data);
+		_hasherUpdate((blake3_hasher*)context, (const uint8_t*)data, datalen);
+	}
+
+	return BLAKE3_RESULT_SUCCESS;
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC Blake3Final(const void* context, void* hash, uint32_t hashlen)
+{
+	VALIDATE_PTR(context);
+	VALIDATE_PTR(hash);
+
+	if (hashlen == 0)
+	{
+		return ERR_BLAKE3_HASH_LEN_INVALID;
+	}
+
+	_hasherFinal((const blake3_hasher*)context, (uint8_t*)hash, hashlen);
+	return BLAKE3_RESULT_SUCCESS;
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC Blake3HashParallel(
+	const void* data,
+	uint64_t datalen,
+	const void* key,
+	uint32_t keylen,
+	void* hash,
+	uint32_t hashlen,
+	uint32_t threads
+)
+{
+	blake3_subtree tree, left, right;
+	blake3_chunk_state chunk;
+	blake3_output out;
+	uint32_t keyWords[8];
+	uint8_t flags;
+	int32_t result;
+
+	VALIDATE_PTR(hash);
+
+	if (datalen > 0)
+	{
+		VALIDATE_PTR(data);
+	}
+
+	/* the whole input must be addressable */
+	if ((uint64_t)(size_t)datalen != datalen)
+	{
+		return ERR_INVALID_PTR;
+	}
+
+	if (hashlen == 0)
+	{
+		return ERR_BLAKE3_HASH_LEN_INVALID;
+	}
+
+	if ((result = _loadKey(key, keylen, keyWords, &flags)) != BLAKE3_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	if (datalen <= BLAKE3_CHUNK_LEN)
+	{
+		/* a single chunk is the root */
+		_chunkInit(&chunk, keyWords, 0, flags);
+		_chunkUpdate(&chunk, (const uint8_t*)data, (size_t)datalen);
+		_chunkOutput(&chunk, &out);
+		crypto_wipe(&chunk, sizeof(chunk));
+	}
+	else
+	{
+		tree.input = (const uint8_t*)data;
+		tree.len = (size_t)datalen;
+		tree.counter = 0;
+		tree.key = keyWords;
+		tree.flags = flags;
+		tree.threads = threads == 0 ? 1 : (threads > BLAKE3_MAX_THREADS ? BLAKE3_MAX_THREADS : threads);
+
+		/* the root is the parent of the two top level subtrees */
+		_childCvs(&tree, &left, &right);
+		_parentOutput(left.cv, right.cv, keyWords, flags, &out);
+	}
+
+	_outputRootBytes(&out, (uint8_t*)hash, hashlen);
+
+	crypto_wipe(keyWords, sizeof(keyWords));
+	crypto_wipe(&out, sizeof(out));
+	return BLAKE3_RESULT_SUCCESS;
+}
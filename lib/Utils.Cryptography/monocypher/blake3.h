@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2024 Vaughn Nugent
+*
+* vnlib_monocypher is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* vnlib_monocypher is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+#ifndef VN_MONOCYPHER_BLAKE3_H
+#define VN_MONOCYPHER_BLAKE3_H
+
+#include <stdint.h>
+#include "util.h"
+
+#define BLAKE3_KEY_SIZE 32
+#define BLAKE3_DEFAULT_HASH_SIZE 32
+#define BLAKE3_BLOCK_LEN 64
+#define BLAKE3_CHUNK_LEN 1024
+
+/* Deep enough for 2^54 chunks, more than any 64 bit input length */
+#define BLAKE3_MAX_DEPTH 54
+
+#define ERR_BLAKE3_HASH_LEN_INVALID -16
+#define ERR_BLAKE3_KEY_LEN_INVALID -17
+
+#define BLAKE3_RESULT_SUCCESS 0
+
+/* Number of chunks the multi-buffer kernel hashes at once */
+#define BLAKE3_SIMD_DEGREE 8
+
+/* Domain flags */
+#define BLAKE3_CHUNK_START 1
+#define BLAKE3_CHUNK_END 2
+#define BLAKE3_PARENT 4
+#define BLAKE3_ROOT 8
+#define BLAKE3_KEYED_HASH 16
+
+typedef struct blake3_chunk_state_struct {
+	uint32_t cv[8];
+	uint64_t chunkCounter;
+	uint8_t block[BLAKE3_BLOCK_LEN];
+	uint8_t blockLen;
+	uint8_t blocksCompressed;
+	uint8_t flags;
+} blake3_chunk_state;
+
+typedef struct blake3_hasher_struct {
+	uint32_t key[8];
+	blake3_chunk_state chunk;
+	uint32_t cvStack[BLAKE3_MAX_DEPTH][8];
+	uint8_t cvStackLen;
+	uint8_t flags;
+} blake3_hasher;
+
+VNLIB_EXPORT uint32_t VNLIB_CC Blake3GetContextSize(void);
+
+/*
+* Initializes a hasher context, when a key is specified it must be exactly
+* BLAKE3_KEY_SIZE bytes and the hasher computes a keyed hash (MAC)
+*/
+VNLIB_EXPORT int32_t VNLIB_CC Blake3Init(void* context, const void* key, uint32_t keylen);
+
+VNLIB_EXPORT int32_t VNLIB_CC Blake3Update(void* context, const void* data, uint32_t datalen);
+
+/*
+* Writes hashlen bytes of output, blake3 is an XOF so any non-zero length
+* is allowed. The context is not modified and may continue to be updated.
+*/
+VNLIB_EXPORT int32_t VNLIB_CC Blake3Final(const void* context, void* hash, uint32_t hashlen);
+
+/*
+* One-shot hash of an entire (possibly very large) buffer such as a memory
+* mapped file. Independent subtrees of the input are hashed on up to
+* threads native threads.
+*/
+VNLIB_EXPORT int32_t VNLIB_CC Blake3HashParallel(
+	const void* data,
+	uint64_t datalen,
+	const void* key,
+	uint32_t keylen,
+	void* hash,
+	uint32_t hashlen,
+	uint32_t threads
+);
+
+#ifdef VNLIB_AVX2_KERNELS
+
+/*
+* Internal AVX2 kernel, hashes BLAKE3_SIMD_DEGREE consecutive full chunks
+* starting at the chunk counter and writes the chaining value of each
+*/
+void _blake3HashChunksX8(const uint8_t* input, const uint32_t key[8], uint64_t counter, uint8_t flags, uint32_t cvs[BLAKE3_SIMD_DEGREE][8]);
+
+#endif
+
+#endif
@@ -0,0 +1,194 @@
+/*
+* Copyright (c) 2023 Vaughn Nugent
+*
+* vnlib_monocypher is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* vnlib_monocypher is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
+*/
+
+/*
+* 8-way BLAKE3 chunk kernel. Each 256 bit register holds the same state word
+* of 8 consecutive chunks, so 8 chunks are compressed with the instructions of
+* one. This file must be compiled with AVX2 enabled and must only be called
+* after the cpu has been checked for AVX2 support.
+*/
+
+#include <string.h>
+#include <immintrin.h>
+#include <monocypher.h>
+#include "blake3.h"
+
+static const uint32_t blake3_iv[4] = {
+	0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL
+};
+
+static const uint8_t blake3_schedule[7][16] = {
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+	{  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+	{ 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+	{ 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+	{  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+	{ 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+#define ADD(a, b) _mm256_add_epi32(a, b)
+#define XOR(a, b) _mm256_xor_si256(a, b)
+
+#define ROTR16(x) _mm256_shuffle_epi8(x, rot16)
+#define ROTR8(x) _mm256_shuffle_epi8(x, rot8)
+#define ROTR12(x) _mm256_or_si256(_mm256_srli_epi32(x, 12), _mm256_slli_epi32(x, 20))
+#define ROTR7(x) _mm256_or_si256(_mm256_srli_epi32(x, 7), _mm256_slli_epi32(x, 25))
+
+#define G(r, i, a, b, c, d)									\
+	a = ADD(ADD(a, b), m[blake3_schedule[r][2 * i]]);		\
+	d = ROTR16(XOR(d, a));									\
+	c = ADD(c, d);											\
+	b = ROTR12(XOR(b, c));									\
+	a = ADD(ADD(a, b), m[blake3_schedule[r][2 * i + 1]]);	\
+	d = ROTR8(XOR(d, a));									\
+	c = ADD(c, d);											\
+	b = ROTR7(XOR(b, c))
+
+#define ROUND(r)								\
+	G(r, 0, v[0], v[4], v[8],  v[12]);			\
+	G(r, 1, v[1], v[5], v[9],  v[13]);			\
+	G(r, 2, v[2], v[6], v[10], v[14]);			\
+	G(r, 3, v[3], v[7], v[11], v[15]);			\
+	G(r, 4, v[0], v[5], v[10], v[15]);			\
+	G(r, 5, v[1], v[6], v[11], v[12]);			\
+	G(r, 6, v[2], v[7], v[8],  v[13]);			\
+	G(r, 7, v[3], v[4], v[9],  v[14])
+
+/* transposes an 8x8 matrix of 32 bit words held in 8 registers */
+static void _transpose(__m256i x[8])
+{
+	__m256i ab0145, ab2367, cd0145, cd2367, ef0145, ef2367, gh0145, gh2367;
+	__m256i abcd04, abcd15, abcd26, abcd37, efgh04, efgh15, efgh26, efgh37;
+
+	ab0145 = _mm256_unpacklo_epi32(x[0], x[1]);
+	ab2367 = _mm256_unpackhi_epi32(x[0], x[1]);
+	cd0145 = _mm256_unpacklo_epi32(x[2], x[3]);
+	cd2367 = _mm256_unpackhi_epi32(x[2], x[3]);
+	ef0145 = _mm256_unpacklo_epi32(x[4], x[5]);
+	ef2367 = _mm256_unpackhi_epi32(x[4], x[5]);
+	gh0145 = _mm256_unpacklo_epi32(x[6], x[7]);
+	gh2367 = _mm256_unpackhi_epi32(x[6], x[7]);
+
+	abcd04 = _mm256_unpacklo_epi64(ab0145, cd0145);
+	abcd15 = _mm256_unpackhi_epi64(ab0145, cd0145);
+	abcd26 = _mm256_unpacklo_epi64(ab2367, cd2367);
+	abcd37 = _mm256_unpackhi_epi64(ab2367, cd2367);
+	efgh04 = _mm256_unpacklo_epi64(ef0145, gh0145);
+	efgh15 = _mm256_unpackhi_epi64(ef0145, gh0145);
+	efgh26 = _mm256_unpacklo_epi64(ef2367, gh2367);
+	efgh37 = _mm256_unpackhi_epi64(ef2367, gh2367);
+
+	x[0] = _mm256_permute2x128_si256(abcd04, efgh04, 0x20);
+	x[1] = _mm256_permute2x128_si256(abcd15, efgh15, 0x20);
+	x[2] = _mm256_permute2x128_si256(abcd26, efgh26, 0x20);
+	x[3] = _mm256_permute2x128_si256(abcd37, efgh37, 0x20);
+	x[4] = _mm256_permute2x128_si256(abcd04, efgh04, 0x31);
+	x[5] = _mm256_permute2x128_si256(abcd15, efgh15, 0x31);
+	x[6] = _mm256_permute2x128_si256(abcd26, efgh26, 0x31);
+	x[7] = _mm256_permute2x128_si256(abcd37, efgh37, 0x31);
+}
+
+/* loads the block'th block of 8 consecutive chunks, register j holds word j of every chunk */
+static void _loadMessage(const uint8_t* input, size_t block, __m256i m[16])
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		m[i] = _mm256_loadu_si256((const __m256i*)(input + (i * BLAKE3_CHUNK_LEN) + (block * BLAKE3_BLOCK_LEN)));
+		m[i + 8] = _mm256_loadu_si256((const __m256i*)(input + (i * BLAKE3_CHUNK_LEN) + (block * BLAKE3_BLOCK_LEN) + 32));
+	}
+
+	_transpose(m);
+	_transpose(m + 8);
+}
+
+void _blake3HashChunksX8(const uint8_t* input, const uint32_t key[8], uint64_t counter, uint8_t flags, uint32_t cvs[BLAKE3_SIMD_DEGREE][8])
+{
+	const __m256i rot16 = _mm256_setr_epi8(
+		2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+		2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13
+	);
+	const __m256i rot8 = _mm256_setr_epi8(
+		1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+		1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12
+	);
+
+	__m256i h[8], v[16], m[16], counterLo, counterHi;
+	uint32_t lo[8], hi[8];
+	size_t block;
+	uint8_t blockFlags;
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		h[i] = _mm256_set1_epi32((int)key[i]);
+		lo[i] = (uint32_t)(counter + i);
+		hi[i] = (uint32_t)((counter + i) >> 32);
+	}
+
+	counterLo = _mm256_loadu_si256((const __m256i*)lo);
+	counterHi = _mm256_loadu_si256((const __m256i*)hi);
+
+	for (block = 0; block < BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN; block++)
+	{
+		blockFlags = flags;
+		blockFlags |= block == 0 ? BLAKE3_CHUNK_START : 0;
+		blockFlags |= block == (BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN) - 1 ? BLAKE3_CHUNK_END : 0;
+
+		_loadMessage(input, block, m);
+
+		for (i = 0; i < 8; i++)
+		{
+			v[i] = h[i];
+		}
+
+		v[8] = _mm256_set1_epi32((int)blake3_iv[0]);
+		v[9] = _mm256_set1_epi32((int)blake3_iv[1]);
+		v[10] = _mm256_set1_epi32((int)blake3_iv[2]);
+		v[11] = _mm256_set1_epi32((int)blake3_iv[3]);
+		v[12] = counterLo;
+		v[13] = counterHi;
+		v[14] = _mm256_set1_epi32(BLAKE3_BLOCK_LEN);
+		v[15] = _mm256_set1_epi32(blockFlags);
+
+		ROUND(0);
+		ROUND(1);
+		ROUND(2);
+		ROUND(3);
+		ROUND(4);
+		ROUND(5);
+		ROUND(6);
+
+		for (i = 0; i < 8; i++)
+		{
+			h[i] = XOR(v[i], v[i + 8]);
+		}
+	}
+
+	/* transpose back so register i holds the chaining value of chunk i */
+	_transpose(h);
+
+	for (i = 0; i < 8; i++)
+	{
+		_mm256_storeu_si256((__m256i*)cvs[i], h[i]);
+	}
+
+	crypto_wipe(m, sizeof(m));
+	crypto_wipe(v, sizeof(v));
+}
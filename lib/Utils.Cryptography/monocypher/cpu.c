@@ -0,0 +1,95 @@
+/*
+* Copyright (c) 2024 Vaughn Nugent
+*
+* vnlib_monocypher is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* vnlib_monocypher is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "cpu.h"
+
+#ifdef VNLIB_AVX2_KERNELS
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#else
+	#include <cpuid.h>
+#endif
+
+/*
+* AVX2 support is checked once, racing threads will compute the same
+* value so no synchronization is needed
+*/
+static int _avx2Supported = -1;
+
+int _vnCpuHasAvx2(void)
+{
+	uint32_t regs[4];
+	uint64_t xcr0;
+
+	if (_avx2Supported >= 0)
+	{
+		return _avx2Supported;
+	}
+
+	_avx2Supported = FALSE;
+
+#if defined(_MSC_VER)
+	__cpuidex((int*)regs, 0, 0);
+#else
+	__cpuid_count(0, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+	if (regs[0] < 7)
+	{
+		return _avx2Supported;
+	}
+
+#if defined(_MSC_VER)
+	__cpuidex((int*)regs, 1, 0);
+#else
+	__cpuid_count(1, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+	/* the ymm registers must be enabled and saved by the os (OSXSAVE + AVX) */
+	if ((regs[2] & (1U << 27)) == 0 || (regs[2] & (1U << 28)) == 0)
+	{
+		return _avx2Supported;
+	}
+
+#if defined(_MSC_VER)
+	xcr0 = _xgetbv(0);
+	__cpuidex((int*)regs, 7, 0);
+#else
+	{
+		uint32_t eax, edx;
+		/* xgetbv opcode, avoids requiring -mxsave for the intrinsic */
+		__asm__ __volatile__(".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+		xcr0 = ((uint64_t)edx << 32) | eax;
+	}
+	__cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+	if ((xcr0 & 0x06) == 0x06 && (regs[1] & (1U << 5)))
+	{
+		_avx2Supported = TRUE;
+	}
+
+	return _avx2Supported;
+}
+
+#else
+
+/* ISO C does not allow an empty translation unit */
+typedef int _vnCpuUnused;
+
+#endif /* VNLIB_AVX2_KERNELS */
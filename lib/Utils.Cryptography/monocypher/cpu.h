@@ -0,0 +1,35 @@
+/*
+* Copyright (c) 2024 Vaughn Nugent
+*
+* vnlib_monocypher is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* vnlib_monocypher is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+#ifndef VN_MONOCYPHER_CPU_H
+#define VN_MONOCYPHER_CPU_H
+
+#include <stdint.h>
+#include "util.h"
+
+#ifdef VNLIB_AVX2_KERNELS
+
+/*
+* Returns TRUE if the cpu supports AVX2 and the os saves the ymm registers.
+* The result is computed once and cached.
+*/
+int _vnCpuHasAvx2(void);
+
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+/*
+* Copyright (c) 2024 Vaughn Nugent
+*
+* vnlib_monocypher is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* vnlib_monocypher is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include <string.h>
+#include <monocypher.h>
+#include <monocypher-ed25519.h>
+#include "curve25519.h"
+
+/* Text buffers may only be null if the size is 0 */
+#define VALIDATE_BUFFER(ptr, size) if (size > 0 && !ptr) return ERR_INVALID_PTR
+
+VNLIB_EXPORT int32_t VNLIB_CC Ed25519KeyPair(
+	uint8_t secretKey[ED25519_SECRET_KEY_SIZE],
+	uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE],
+	const uint8_t seed[ED25519_SEED_SIZE]
+)
+{
+	uint8_t seedCopy[ED25519_SEED_SIZE];
+
+	VALIDATE_PTR(secretKey);
+	VALIDATE_PTR(publicKey);
+	VALIDATE_PTR(seed);
+
+	/* monocypher wipes the seed, so work on a copy to leave the caller's buffer alone */
+	memcpy(seedCopy, seed, sizeof(seedCopy));
+
+	crypto_ed25519_key_pair(secretKey, publicKey, seedCopy);
+
+	crypto_wipe(seedCopy, sizeof(seedCopy));
+
+	return CURVE25519_RESULT_SUCCESS;
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC Ed25519Sign(
+	uint8_t signature[ED25519_SIGNATURE_SIZE],
+	const uint8_t secretKey[ED25519_SECRET_KEY_SIZE],
+	const uint8_t* message,
+	uint32_t messageSize
+)
+{
+	VALIDATE_PTR(signature);
+	VALIDATE_PTR(secretKey);
+	VALIDATE_BUFFER(message, messageSize);
+
+	crypto_ed25519_sign(signature, secretKey, message, messageSize);
+
+	return CURVE25519_RESULT_SUCCESS;
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC Ed25519Verify(
+	const uint8_t signature[ED25519_SIGNATURE_SIZE],
+	const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE],
+	const uint8_t* message,
+	uint32_t messageSize
+)
+{
+	VALIDATE_PTR(signature);
+	VALIDATE_PTR(publicKey);
+	VALIDATE_BUFFER(message, messageSize);
+
+	return crypto_ed25519_check(signature, publicKey, message, messageSize) == 0
+		? CURVE25519_RESULT_SUCCESS
+		: ERR_SIGNATURE_INVALID;
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC X25519PublicKey(
+	uint8_t publicKey[X25519_KEY_SIZE],
+	const uint8_t secretKey[X25519_KEY_SIZE]
+)
+{
+	VALIDATE_PTR(publicKey);
+	VALIDATE_PTR(secretKey);
+
+	crypto_x25519_public_key(publicKey, secretKey);
+
+	return CURVE25519_RESULT_SUCCESS;
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC X25519SharedSecret(
+	uint8_t sharedSecret[X25519_SHARED_SECRET_SIZE],
+	const uint8_t secretKey[X25519_KEY_SIZE],
+	const uint8_t theirPublicKey[X25519_KEY_SIZE]
+)
+{
+	static const uint8_t zero[X25519_SHARED_SECRET_SIZE] = { 0 };
+
+	VALIDATE_PTR(sharedSecret);
+	VALIDATE_PTR(secretKey);
+	VALIDATE_PTR(theirPublicKey);
+
+	crypto_x25519(sharedSecret, secretKey, theirPublicKey);
+
+	/*
+	* A low order public key forces an all zero secret regardless of our
+	* key, reject it so a peer cannot force a known shared secret
+	*/
+	if (crypto_verify32(sharedSecret, zero) == 0)
+	{
+		crypto_wipe(sharedSecret, X25519_SHARED_SECRET_SIZE);
+		return ERR_X25519_WEAK_KEY;
+	}
+
+	return CURVE25519_RESULT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+/*
+* Copyright (c) 2024 Vaughn Nugent
+*
+* vnlib_monocypher is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* vnlib_monocypher is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+#ifndef VN_MONOCYPHER_CURVE25519_H
+#define VN_MONOCYPHER_CURVE25519_H
+
+#include <stdint.h>
+#include "util.h"
+
+#define ED25519_SEED_SIZE 32
+#define ED25519_SECRET_KEY_SIZE 64
+#define ED25519_PUBLIC_KEY_SIZE 32
+#define ED25519_SIGNATURE_SIZE 64
+
+#define X25519_KEY_SIZE 32
+#define X25519_SHARED_SECRET_SIZE 32
+
+#define CURVE25519_RESULT_SUCCESS 0
+
+#define ERR_SIGNATURE_INVALID -48
+#define ERR_X25519_WEAK_KEY -49
+
+/*
+* Ed25519 signatures (EdDSA with SHA-512, RFC 8032) are the standard
+* algorithm used by JWS "EdDSA" with the "Ed25519" curve (RFC 8037).
+* The secret key is the 32 byte seed followed by the public key.
+*/
+
+VNLIB_EXPORT int32_t VNLIB_CC Ed25519KeyPair(
+	uint8_t secretKey[ED25519_SECRET_KEY_SIZE],
+	uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE],
+	const uint8_t seed[ED25519_SEED_SIZE]
+);
+
+VNLIB_EXPORT int32_t VNLIB_CC Ed25519Sign(
+	uint8_t signature[ED25519_SIGNATURE_SIZE],
+	const uint8_t secretKey[ED25519_SECRET_KEY_SIZE],
+	const uint8_t* message,
+	uint32_t messageSize
+);
+
+VNLIB_EXPORT int32_t VNLIB_CC Ed25519Verify(
+	const uint8_t signature[ED25519_SIGNATURE_SIZE],
+	const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE],
+	const uint8_t* message,
+	uint32_t messageSize
+);
+
+/*
+* X25519 key exchange. The raw shared secret is not uniformly random and
+* must be passed through a KDF before it is used as a key.
+*/
+
+VNLIB_EXPORT int32_t VNLIB_CC X25519PublicKey(
+	uint8_t publicKey[X25519_KEY_SIZE],
+	const uint8_t secretKey[X25519_KEY_SIZE]
+);
+
+VNLIB_EXPORT int32_t VNLIB_CC X25519SharedSecret(
+	uint8_t sharedSecret[X25519_SHARED_SECRET_SIZE],
+	const uint8_t secretKey[X25519_KEY_SIZE],
+	const uint8_t theirPublicKey[X25519_KEY_SIZE]
+);
+
+#endif
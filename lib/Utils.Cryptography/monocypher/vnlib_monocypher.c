@@ -1,5 +1,5 @@
 /*
-* Copyright (c) 2023 Vaughn Nugent
+* Copyright (c) 2024 Vaughn Nugent
 *
 * vnlib_monocypher is free software: you can redistribute it and/or modify
 * it under the terms of the GNU General Public License as published
@@ -15,105 +15,259 @@
 * along with vnlib_monocypher. If not, see http://www.gnu.org/licenses/.
 */
 
-
-#if 0
 #include <monocypher.h>
 #include "vnlib_monocypher.h"
 
-#define AEAD_MAX_NONCE_SIZE 24
-#define AEAD_MAX_KEY_SIZE 32
-
-#define AEAD_RESULT_SUCCESS 0
-
+/*
+* The stream wraps the monocypher XChaCha20-Poly1305 authenticated
+* stream. Monocypher ratchets the internal key after every message, so
+* messages must be decrypted in the same order they were encrypted. The
+* message counter is kept so that callers can detect desync and so we
+* refuse to wrap around after 2^64 messages.
+*/
 typedef struct ChaChaStreamStruct {
-	uint8_t nonceCounter[8];
-	uint8_t secretKey[32];
-	uint8_t mac[16];
+	crypto_aead_ctx ctx;
+	uint64_t messageCounter;
 } ChaChaStream;
 
-static int32_t _incrementNonce(ChaChaStream* stream)
+/*
+* Increments the message counter for the stream. If the counter
+* would overflow, FALSE is returned and the stream must be
+* re-initialized with a new key/nonce pair
+*/
+static int32_t _incrementCounter(ChaChaStream* stream)
 {
-	/*
-	* The once will be incremented by 1 for each call to lock/unlock
-	* if the nonce will overflow, then return 0 to indicate an error
-	*/
-
-	VALIDATE_PTR(stream);
-
-	/* increment the nonce */
-
-	uint64_t* nonce;
-	uint64_t value;
-
-	nonce = (uint64_t*)stream->nonceCounter;
-	value = *nonce;
-
-	/* increment the nonce */
-	if(++value == 0)
+	if (stream->messageCounter == UINT64_MAX)
 	{
-		/* nonce overflow */
 		return FALSE;
 	}
 
-	/* assign the value back */
-	*nonce = value;
+	stream->messageCounter++;
 	return TRUE;
 }
 
-uint32_t AeadStreamStructSize(void)
+/*
+* Text buffers may only be null if the text size is 0, monocypher
+* accepts null pointers for empty buffers
+*/
+#define VALIDATE_BUFFER(ptr, size) if (size > 0 && !ptr) return ERR_INVALID_PTR
+
+VNLIB_EXPORT uint32_t VNLIB_CC AeadStreamStructSize(void)
 {
 	return sizeof(ChaChaStream);
 }
 
-int32_t AeadUpdateKey(ChaChaStream* stream, const uint8_t key[32])
+VNLIB_EXPORT int32_t VNLIB_CC AeadInitStream(void* stream, const uint8_t key[AEAD_KEY_SIZE], const uint8_t nonce[AEAD_NONCE_SIZE])
 {
-	VALIDATE_PTR(stream);
+	ChaChaStream* chStream;
+	chStream = (ChaChaStream*)stream;
+
+	VALIDATE_PTR(chStream);
 	VALIDATE_PTR(key);
+	VALIDATE_PTR(nonce);
 
-	/* copy the key to the structure key */
-	_memmove(stream->secretKey, key, 32);
-	return TRUE;
+	/* clear stream before using */
+	crypto_wipe(chStream, sizeof(ChaChaStream));
+
+	/* derive the sub-key from the key and extended nonce */
+	crypto_aead_init_x(&chStream->ctx, key, nonce);
+
+	return AEAD_RESULT_SUCCESS;
 }
 
-int32_t AeadUpdateMac(ChaChaStream* stream, const uint8_t mac[16])
+VNLIB_EXPORT int32_t VNLIB_CC AeadEncrypt(
+	void* stream,
+	const uint8_t* ad,
+	uint32_t adSize,
+	const uint8_t* plainText,
+	uint8_t* cipherText,
+	uint32_t textSize,
+	uint8_t mac[AEAD_MAC_SIZE]
+)
 {
-	VALIDATE_PTR(stream);
+	ChaChaStream* chStream;
+	chStream = (ChaChaStream*)stream;
+
+	VALIDATE_PTR(chStream);
 	VALIDATE_PTR(mac);
+	VALIDATE_BUFFER(ad, adSize);
+	VALIDATE_BUFFER(plainText, textSize);
+	VALIDATE_BUFFER(cipherText, textSize);
 
-	/* copy the mac to the structure mac */
-	_memmove(stream->mac, mac, 16);
-	return TRUE;
+	if (!_incrementCounter(chStream))
+	{
+		return ERR_AEAD_NONCE_EXHAUSTED;
+	}
+
+	crypto_aead_write(&chStream->ctx, cipherText, mac, ad, adSize, plainText, textSize);
+
+	return AEAD_RESULT_SUCCESS;
 }
 
-int32_t AeadInitStream(ChaChaStream* stream, const uint8_t key[32], const uint8_t startingNonce[8], const uint8_t mac[16])
+VNLIB_EXPORT int32_t VNLIB_CC AeadDecrypt(
+	void* stream,
+	const uint8_t* ad,
+	uint32_t adSize,
+	const uint8_t* cipherText,
+	uint8_t* plainText,
+	uint32_t textSize,
+	const uint8_t mac[AEAD_MAC_SIZE]
+)
+{
+	ChaChaStream* chStream;
+	chStream = (ChaChaStream*)stream;
+
+	VALIDATE_PTR(chStream);
+	VALIDATE_PTR(mac);
+	VALIDATE_BUFFER(ad, adSize);
+	VALIDATE_BUFFER(plainText, textSize);
+	VALIDATE_BUFFER(cipherText, textSize);
+
+	if (chStream->messageCounter == UINT64_MAX)
+	{
+		return ERR_AEAD_NONCE_EXHAUSTED;
+	}
+
+	/*
+	* The stream key is only ratcheted when the mac is valid, so the
+	* counter must only be incremented on success too
+	*/
+	if (crypto_aead_read(&chStream->ctx, plainText, mac, ad, adSize, cipherText, textSize) != 0)
+	{
+		return ERR_AEAD_MAC_MISMATCH;
+	}
+
+	_incrementCounter(chStream);
+
+	return AEAD_RESULT_SUCCESS;
+}
+
+VNLIB_EXPORT uint64_t VNLIB_CC AeadStreamGetCounter(const void* stream)
+{
+	const ChaChaStream* chStream;
+	chStream = (const ChaChaStream*)stream;
+
+	return chStream ? chStream->messageCounter : 0;
+}
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadLock(
+	const uint8_t key[AEAD_KEY_SIZE],
+	const uint8_t nonce[AEAD_NONCE_SIZE],
+	const uint8_t* ad,
+	uint32_t adSize,
+	const uint8_t* plainText,
+	uint8_t* cipherText,
+	uint32_t textSize,
+	uint8_t mac[AEAD_MAC_SIZE]
+)
 {
-	VALIDATE_PTR(stream);
 	VALIDATE_PTR(key);
-	VALIDATE_PTR(startingNonce);
+	VALIDATE_PTR(nonce);
 	VALIDATE_PTR(mac);
+	VALIDATE_BUFFER(ad, adSize);
+	VALIDATE_BUFFER(plainText, textSize);
+	VALIDATE_BUFFER(cipherText, textSize);
 
-	/* clear stream before using */
-	crypto_wipe(stream, sizeof(ChaChaStream));
+	crypto_aead_lock(cipherText, mac, key, nonce, ad, adSize, plainText, textSize);
 
-	/* copy the key to the structure key */
-	_memmove(stream->secretKey, key, 32);
+	return AEAD_RESULT_SUCCESS;
+}
 
-	/* copy the nonce to the structure nonce */
-	_memmove(stream->nonceCounter, startingNonce, 8);
+VNLIB_EXPORT int32_t VNLIB_CC AeadUnlock(
+	const uint8_t key[AEAD_KEY_SIZE],
+	const uint8_t nonce[AEAD_NONCE_SIZE],
+	const uint8_t* ad,
+	uint32_t adSize,
+	const uint8_t* cipherText,
+	uint8_t* plainText,
+	uint32_t textSize,
+	const uint8_t mac[AEAD_MAC_SIZE]
+)
+{
+	VALIDATE_PTR(key);
+	VALIDATE_PTR(nonce);
+	VALIDATE_PTR(mac);
+	VALIDATE_BUFFER(ad, adSize);
+	VALIDATE_BUFFER(plainText, textSize);
+	VALIDATE_BUFFER(cipherText, textSize);
 
-	/* copy the mac to the structure mac */
-	_memmove(stream->mac, mac, 16);
-	return TRUE;
+	if (crypto_aead_unlock(plainText, mac, key, nonce, ad, adSize, cipherText, textSize) != 0)
+	{
+		return ERR_AEAD_MAC_MISMATCH;
+	}
+
+	return AEAD_RESULT_SUCCESS;
 }
 
-int32_t AeadEncrypt(ChaChaStream* stream, const uint8_t* plainText, uint32_t plainTextSize, uint8_t* cipherText, uint8_t* tag)
+/*
+* The batch functions process an array of independent messages that share
+* a single key so many small messages (cookies, cache entries) can be
+* processed with a single call into the library. Every message gets its
+* own result code, the return value is the number of messages that were
+* successfully processed, or a negative error code if the arguments were
+* invalid.
+*/
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadLockBatch(const uint8_t key[AEAD_KEY_SIZE], AeadBatchMessage* messages, uint32_t count)
 {
-	VALIDATE_PTR(stream);
-	VALIDATE_PTR(plainText);
-	VALIDATE_PTR(cipherText);
-	VALIDATE_PTR(tag);
+	uint32_t i;
+	int32_t processed;
+
+	VALIDATE_PTR(key);
+	VALIDATE_PTR(messages);
+
+	processed = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		messages[i].result = AeadLock(
+			key,
+			messages[i].nonce,
+			messages[i].ad,
+			messages[i].adSize,
+			messages[i].input,
+			messages[i].output,
+			messages[i].textSize,
+			messages[i].mac
+		);
+
+		if (messages[i].result == AEAD_RESULT_SUCCESS)
+		{
+			processed++;
+		}
+	}
+
+	return processed;
 }
 
-#else 
-typedef int something_to_stop_compiler_err_while_in_dev;
-#endif
\ No newline at end of file
+VNLIB_EXPORT int32_t VNLIB_CC AeadUnlockBatch(const uint8_t key[AEAD_KEY_SIZE], AeadBatchMessage* messages, uint32_t count)
+{
+	uint32_t i;
+	int32_t processed;
+
+	VALIDATE_PTR(key);
+	VALIDATE_PTR(messages);
+
+	processed = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		messages[i].result = AeadUnlock(
+			key,
+			messages[i].nonce,
+			messages[i].ad,
+			messages[i].adSize,
+			messages[i].input,
+			messages[i].output,
+			messages[i].textSize,
+			messages[i].mac
+		);
+
+		if (messages[i].result == AEAD_RESULT_SUCCESS)
+		{
+			processed++;
+		}
+	}
+
+	return processed;
+}
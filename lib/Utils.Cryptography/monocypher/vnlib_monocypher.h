@@ -19,6 +19,91 @@
 #ifndef VNLIB_MONOCYPHER_H
 #define VNLIB_MONOCYPHER_H
 
+#include <stdint.h>
 #include "util.h"
 
-#endif
\ No newline at end of file
+#define AEAD_NONCE_SIZE 24
+#define AEAD_KEY_SIZE 32
+#define AEAD_MAC_SIZE 16
+
+#define AEAD_RESULT_SUCCESS 0
+
+#define ERR_AEAD_MAC_MISMATCH -32
+#define ERR_AEAD_NONCE_EXHAUSTED -33
+
+/*
+* A single message descriptor for the batch encryption/decryption
+* functions. Every message has its own nonce and mac but shares the
+* same secret key. The result field is written by the library and
+* holds the per-message result code.
+*/
+typedef struct AeadBatchMessageStruct {
+	const uint8_t* nonce;		/* 24 byte nonce for this message */
+	const uint8_t* ad;			/* optional associated data */
+	const uint8_t* input;		/* plain text when locking, cipher text when unlocking */
+	uint8_t* output;			/* cipher text when locking, plain text when unlocking */
+	uint8_t* mac;				/* 16 byte mac buffer */
+	uint32_t adSize;
+	uint32_t textSize;
+	int32_t result;				/* per-message result code */
+} AeadBatchMessage;
+
+/* Streaming interface */
+
+VNLIB_EXPORT uint32_t VNLIB_CC AeadStreamStructSize(void);
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadInitStream(void* stream, const uint8_t key[AEAD_KEY_SIZE], const uint8_t nonce[AEAD_NONCE_SIZE]);
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadEncrypt(
+	void* stream,
+	const uint8_t* ad,
+	uint32_t adSize,
+	const uint8_t* plainText,
+	uint8_t* cipherText,
+	uint32_t textSize,
+	uint8_t mac[AEAD_MAC_SIZE]
+);
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadDecrypt(
+	void* stream,
+	const uint8_t* ad,
+	uint32_t adSize,
+	const uint8_t* cipherText,
+	uint8_t* plainText,
+	uint32_t textSize,
+	const uint8_t mac[AEAD_MAC_SIZE]
+);
+
+VNLIB_EXPORT uint64_t VNLIB_CC AeadStreamGetCounter(const void* stream);
+
+/* One-shot interface */
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadLock(
+	const uint8_t key[AEAD_KEY_SIZE],
+	const uint8_t nonce[AEAD_NONCE_SIZE],
+	const uint8_t* ad,
+	uint32_t adSize,
+	const uint8_t* plainText,
+	uint8_t* cipherText,
+	uint32_t textSize,
+	uint8_t mac[AEAD_MAC_SIZE]
+);
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadUnlock(
+	const uint8_t key[AEAD_KEY_SIZE],
+	const uint8_t nonce[AEAD_NONCE_SIZE],
+	const uint8_t* ad,
+	uint32_t adSize,
+	const uint8_t* cipherText,
+	uint8_t* plainText,
+	uint32_t textSize,
+	const uint8_t mac[AEAD_MAC_SIZE]
+);
+
+/* Batch interface */
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadLockBatch(const uint8_t key[AEAD_KEY_SIZE], AeadBatchMessage* messages, uint32_t count);
+
+VNLIB_EXPORT int32_t VNLIB_CC AeadUnlockBatch(const uint8_t key[AEAD_KEY_SIZE], AeadBatchMessage* messages, uint32_t count);
+
+#endif
@@ -0,0 +1,166 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.Utils
+* File: SpanKeyedTable.cs 
+*
+* SpanKeyedTable.cs is part of VNLib.Utils which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.Utils is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.Utils is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.Utils. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Linq;
+using System.Numerics;
+using System.Collections;
+using System.Collections.Generic;
+using System.Diagnostics.CodeAnalysis;
+
+namespace VNLib.Utils
+{
+    /// <summary>
+    /// An immutable string keyed lookup table that may be searched with a 
+    /// character span, so callers that only hold a slice of a larger buffer 
+    /// do not need to allocate a string for every lookup
+    /// </summary>
+    /// <typeparam name="TValue">The value type stored in the table</typeparam>
+    public sealed class SpanKeyedTable<TValue> : IReadOnlyCollection<KeyValuePair<string, TValue>>
+    {
+        private readonly int[] _buckets;
+        private readonly Entry[] _entries;
+        private readonly int _mask;
+
+        /// <summary>
+        /// The comparison used to hash and match keys
+        /// </summary>
+        public StringComparison Comparison { get; }
+
+        ///<inheritdoc/>
+        public int Count => _entries.Length;
+
+        /// <summary>
+        /// Gets an empty table that uses the ordinal ignore case comparison
+        /// </summary>
+        public static SpanKeyedTable<TValue> Empty { get; } = new([], StringComparison.OrdinalIgnoreCase);
+
+        /// <summary>
+        /// Creates a new table from the key value pairs
+        /// </summary>
+        /// <param name="items">The items to store in the table, keys must be unique by the comparison</param>
+        /// <param name="comparison">The comparison used to match keys, must be ordinal or ordinal ignore case</param>
+        /// <exception cref="ArgumentException"></exception>
+        /// <exception cref="ArgumentNullException"></exception>
+        public SpanKeyedTable(IEnumerable<KeyValuePair<string, TValue>> items, StringComparison comparison)
+        {
+            ArgumentNullException.ThrowIfNull(items);
+
+            if (comparison != StringComparison.Ordinal && comparison != StringComparison.OrdinalIgnoreCase)
+            {
+                throw new ArgumentException("Only ordinal comparisons are supported", nameof(comparison));
+            }
+
+            Comparison = comparison;
+
+            KeyValuePair<string, TValue>[] all = items.ToArray();
+
+            //Keep the load factor at or below 0.5 so chains stay short
+            int bucketCount = (int)BitOperations.RoundUpToPowerOf2((uint)Math.Max(all.Length * 2, 4));
+
+            _buckets = new int[bucketCount];
+            _entries = new Entry[all.Length];
+            _mask = bucketCount - 1;
+
+            for (int i = 0; i < all.Length; i++)
+            {
+                ArgumentNullException.ThrowIfNull(all[i].Key, nameof(items));
+
+                if (FindEntry(all[i].Key) >= 0)
+                {
+                    throw new ArgumentException($"The key {all[i].Key} was added more than once", nameof(items));
+                }
+
+                int hash = string.GetHashCode(all[i].Key, comparison);
+                ref int bucket = ref _buckets[hash & _mask];
+
+                //Buckets store the entry index + 1 so 0 is the end of a chain
+                _entries[i] = new(hash, all[i].Key, all[i].Value, bucket - 1);
+                bucket = i + 1;
+            }
+        }
+
+        /// <summary>
+        /// Gets the value associated with the key 
+        /// </summary>
+        /// <param name="key">The key to find</param>
+        /// <param name="value">The value stored with the key if found</param>
+        /// <returns>True if the key was found, false otherwise</returns>
+        public bool TryGetValue(ReadOnlySpan<char> key, [MaybeNullWhen(false)] out TValue value)
+        {
+            int index = FindEntry(key);
+
+            if (index < 0)
+            {
+                value = default;
+                return false;
+            }
+
+            value = _entries[index].Value;
+            return true;
+        }
+
+        /// <summary>
+        /// Gets the value associated with the key, or the default value if 
+        /// the key is not found
+        /// </summary>
+        /// <param name="key">The key to find</param>
+        /// <param name="defaultValue">The value to return if the key is not found</param>
+        /// <returns>The value stored with the key, or the default value</returns>
+        public TValue? GetValueOrDefault(ReadOnlySpan<char> key, TValue? defaultValue = default)
+            => TryGetValue(key, out TValue? value) ? value : defaultValue;
+
+        /// <summary>
+        /// Determines if the table contains the key
+        /// </summary>
+        /// <param name="key">The key to find</param>
+        /// <returns>True if the key was found, false otherwise</returns>
+        public bool ContainsKey(ReadOnlySpan<char> key) => FindEntry(key) >= 0;
+
+        private int FindEntry(ReadOnlySpan<char> key)
+        {
+            int hash = string.GetHashCode(key, Comparison);
+
+            for (int i = _buckets[hash & _mask] - 1; i >= 0; i = _entries[i].Next)
+            {
+                ref readonly Entry entry = ref _entries[i];
+
+                if (entry.Hash == hash && key.Equals(entry.Key, Comparison))
+                {
+                    return i;
+                }
+            }
+
+            return -1;
+        }
+
+        ///<inheritdoc/>
+        public IEnumerator<KeyValuePair<string, TValue>> GetEnumerator()
+            => _entries.Select(static e => new KeyValuePair<string, TValue>(e.Key, e.Value)).GetEnumerator();
+
+        IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+
+        private readonly record struct Entry(int Hash, string Key, TValue Value, int Next);
+    }
+}
@@ -0,0 +1,95 @@
+﻿/*
+* Copyright (c) 2024 Vaughn Nugent
+* 
+* Library: VNLib
+* Package: VNLib.UtilsTests
+* File: SpanKeyedTableTests.cs 
+*
+* SpanKeyedTableTests.cs is part of VNLib.UtilsTests which is part of the larger 
+* VNLib collection of libraries and utilities.
+*
+* VNLib.UtilsTests is free software: you can redistribute it and/or modify 
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 2 of the License,
+* or (at your option) any later version.
+*
+* VNLib.UtilsTests is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License 
+* along with VNLib.UtilsTests. If not, see http://www.gnu.org/licenses/.
+*/
+
+using System;
+using System.Linq;
+using System.Collections.Generic;
+
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace VNLib.Utils.Tests
+{
+    [TestClass()]
+    public class SpanKeyedTableTests
+    {
+        [TestMethod()]
+        public void LookupTest()
+        {
+            KeyValuePair<string, int>[] items = Enumerable.Range(0, 200)
+                .Select(static i => new KeyValuePair<string, int>($"/api/Endpoint{i}", i))
+                .ToArray();
+
+            SpanKeyedTable<int> table = new(items, StringComparison.OrdinalIgnoreCase);
+
+            Assert.AreEqual(items.Length, table.Count);
+
+            foreach (KeyValuePair<string, int> kv in items)
+            {
+                //Lookup from a slice of a larger buffer with different casing
+                string buffer = $"GET {kv.Key.ToUpperInvariant()} HTTP/1.1";
+                ReadOnlySpan<char> key = buffer.AsSpan(4, kv.Key.Length);
+
+                Assert.IsTrue(table.TryGetValue(key, out int value));
+                Assert.AreEqual(kv.Value, value);
+            }
+
+            Assert.IsFalse(table.TryGetValue("/api/Endpoint200", out _));
+            Assert.IsFalse(table.ContainsKey("/api/Endpoint"));
+            Assert.IsFalse(table.ContainsKey(ReadOnlySpan<char>.Empty));
+            Assert.AreEqual(-1, table.GetValueOrDefault("/missing", -1));
+
+            //Enumeration must return every item
+            Assert.IsTrue(items.OrderBy(static k => k.Value).SequenceEqual(table.OrderBy(static k => k.Value)));
+        }
+
+        [TestMethod()]
+        public void OrdinalTest()
+        {
+            SpanKeyedTable<string> table = new(
+                [new("Host", "a"), new("host", "b")],
+                StringComparison.Ordinal
+            );
+
+            Assert.AreEqual("a", table.GetValueOrDefault("Host"));
+            Assert.AreEqual("b", table.GetValueOrDefault("host"));
+            Assert.IsNull(table.GetValueOrDefault("HOST"));
+
+            Assert.AreEqual(0, SpanKeyedTable<string>.Empty.Count);
+            Assert.IsFalse(SpanKeyedTable<string>.Empty.ContainsKey("Host"));
+        }
+
+        [TestMethod()]
+        public void ArgumentsTest()
+        {
+            //Duplicate keys by the comparison must be rejected
+            Assert.ThrowsException<ArgumentException>(() => new SpanKeyedTable<int>(
+                [new("/a", 1), new("/A", 2)],
+                StringComparison.OrdinalIgnoreCase
+            ));
+
+            Assert.ThrowsException<ArgumentException>(() => new SpanKeyedTable<int>([], StringComparison.CurrentCulture));
+            Assert.ThrowsException<ArgumentNullException>(() => new SpanKeyedTable<int>(null!, StringComparison.Ordinal));
+        }
+    }
+}